@@ -20,8 +20,12 @@
 #ifndef BENCHMARK_H
 #define BENCHMARK_H
 
+#include <inttypes.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #define MICROSECONDS_PER_SECOND 1E6
 #define NANOSECONDS_PER_SECOND 1E9
@@ -67,18 +71,195 @@
 
 #endif
 
-#define BEGIN_BENCHMARKS() int main(int argc, char *argv[]) {
-#define BENCHMARK(NAME, ITERATIONS, BODY)                                   \
-    do {                                                                    \
-        const int iterations = ITERATIONS;                                  \
-        const char *name = #NAME;                                           \
-        START_TIMER;                                                        \
-        for (int i = 0; i < iterations; i++) {                              \
-            BODY;                                                           \
-        }                                                                   \
-        END_TIMER(duration);                                                \
-        printf("\t-- %s: %Lf microseconds per iteration (%d iterations)\n", \
-               name, (duration / iterations), iterations);                  \
+/** Number of timed batches per run, the samples of the statistics. */
+#define BENCHMARK_BATCHES 100
+
+/**
+ * Settings of the benchmarks, from the command line (and the environment):
+ *
+ * - `--json` (or `H3_BENCHMARK_JSON=1`): print one JSON object per benchmark
+ *   (JSON Lines) instead of the human-readable report;
+ * - `--runs=N`: number of timed runs of every benchmark (5 by default);
+ * - `--warmup=N`: number of untimed iterations before the runs (a tenth of
+ *   the iterations of a run by default).
+ */
+typedef struct {
+    const char *program;
+    int json;
+    int runs;
+    int warmup;
+} BenchmarkConfig;
+
+static BenchmarkConfig benchmarkConfig = {"", 0, 5, -1};
+
+/** Parses the settings of the benchmarks. */
+static void benchmarkInit(int argc, char *argv[]) {
+    const char *program = argc > 0 ? argv[0] : "";
+    for (const char *c = program; *c; c++) {
+        if (*c == '/' || *c == '\\') {
+            program = c + 1;
+        }
+    }
+    benchmarkConfig.program = program;
+
+    const char *json = getenv("H3_BENCHMARK_JSON");
+    benchmarkConfig.json = json != NULL && strcmp(json, "0") != 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            benchmarkConfig.json = 1;
+        } else if (strncmp(argv[i], "--runs=", 7) == 0) {
+            int runs = atoi(argv[i] + 7);
+            benchmarkConfig.runs = runs > 0 ? runs : 1;
+        } else if (strncmp(argv[i], "--warmup=", 9) == 0) {
+            int warmup = atoi(argv[i] + 9);
+            benchmarkConfig.warmup = warmup >= 0 ? warmup : 0;
+        }
+    }
+}
+
+/** Returns a monotonic timestamp, in microseconds. */
+static long double benchmarkNow(void) {
+#ifdef _WIN32
+    LARGE_INTEGER now;
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return ((long double)now.QuadPart) / freq.QuadPart *
+           MICROSECONDS_PER_SECOND;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec * NANOSECONDS_PER_SECOND + now.tv_nsec) /
+           NANOSECONDS_PER_MICROSECOND;
+#endif
+}
+
+/**
+ * Keeps the compiler from optimizing away the computation of a value (or of
+ * the memory it points to).
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define DO_NOT_OPTIMIZE(value) __asm__ volatile("" : : "g"(value) : "memory")
+#else
+static volatile const void *benchmarkSink;
+#define DO_NOT_OPTIMIZE(value) (benchmarkSink = (const void *)&(value))
+#endif
+
+static int benchmarkCompare(const void *a, const void *b) {
+    const long double x = *(const long double *)a;
+    const long double y = *(const long double *)b;
+    return (x > y) - (x < y);
+}
+
+/** Returns the given percentile of sorted samples (nearest rank). */
+static long double benchmarkPercentile(const long double *samples, int count,
+                                       double percentile) {
+    int rank = (int)ceil(percentile / 100 * count);
+    return samples[rank > 0 ? rank - 1 : 0];
+}
+
+/**
+ * Reports the statistics of a benchmark, from its samples (durations of an
+ * iteration, in microseconds). The samples are sorted in place.
+ *
+ * The throughput is reported as well when an iteration processes a known
+ * number of elements (non-zero `elements`).
+ */
+static void benchmarkReport(const char *name, int iterations, int64_t elements,
+                            long double *samples, int count) {
+    qsort(samples, count, sizeof(long double), benchmarkCompare);
+    long double total = 0;
+    for (int i = 0; i < count; i++) {
+        total += samples[i];
+    }
+    const long double mean = total / count;
+    const long double median = benchmarkPercentile(samples, count, 50);
+    const long double p99 = benchmarkPercentile(samples, count, 99);
+    const long double throughput =
+        median > 0 ? elements / median * MICROSECONDS_PER_SECOND : 0;
+
+    if (benchmarkConfig.json) {
+        printf(
+            "{\"program\": \"%s\", \"name\": \"%s\", \"iterations\": %d, "
+            "\"runs\": %d, \"samples\": %d, \"min_us\": %Lf, "
+            "\"median_us\": %Lf, \"p99_us\": %Lf, \"max_us\": %Lf, "
+            "\"mean_us\": %Lf",
+            benchmarkConfig.program, name, iterations, benchmarkConfig.runs,
+            count, samples[0], median, p99, samples[count - 1], mean);
+        if (elements > 0) {
+            printf(", \"elements\": %" PRId64 ", \"elements_per_second\": %Lf",
+                   elements, throughput);
+        }
+        printf("}\n");
+    } else if (elements > 0) {
+        printf(
+            "\t-- %s: %Lf microseconds per iteration, %.3Lf Melements/s "
+            "(%" PRId64 " elements, %d iterations x %d runs; min %Lf, "
+            "p99 %Lf)\n",
+            name, median, throughput / 1E6, elements, iterations,
+            benchmarkConfig.runs, samples[0], p99);
+    } else {
+        printf(
+            "\t-- %s: %Lf microseconds per iteration (%d iterations x %d "
+            "runs; min %Lf, p99 %Lf, mean %Lf)\n",
+            name, median, iterations, benchmarkConfig.runs, samples[0], p99,
+            mean);
+    }
+    fflush(stdout);
+}
+
+#define BEGIN_BENCHMARKS()               \
+    int main(int argc, char *argv[]) {   \
+        benchmarkInit(argc, argv);
+/**
+ * Runs BODY ITERATIONS times per run, after some warmup iterations, and
+ * reports the median, min and p99 duration of an iteration.
+ *
+ * Every run is timed by batches (of ITERATIONS / BENCHMARK_BATCHES
+ * iterations), each batch giving a sample, so that the percentiles reflect
+ * the variations within and between runs. `i` is the index of the iteration
+ * within the run.
+ */
+#define BENCHMARK(NAME, ITERATIONS, BODY) \
+    BENCHMARK_RUN(#NAME, ITERATIONS, 0, BODY)
+
+/**
+ * Same as BENCHMARK, with a name computed at runtime and a number of elements
+ * processed by every iteration, to report the throughput as well.
+ */
+#define BENCHMARK_RUN(NAME, ITERATIONS, ELEMENTS, BODY)                       \
+    do {                                                                      \
+        const int runIterations = ITERATIONS;                                 \
+        const char *runName = NAME;                                           \
+        const int warmup = benchmarkConfig.warmup >= 0                        \
+                               ? benchmarkConfig.warmup                       \
+                               : runIterations / 10;                          \
+        for (int i = 0; i < warmup; i++) {                                    \
+            BODY;                                                             \
+        }                                                                     \
+        const int batches =                                                   \
+            runIterations < BENCHMARK_BATCHES ? runIterations                 \
+                                              : BENCHMARK_BATCHES;            \
+        long double *samples =                                                \
+            malloc(sizeof(long double) * batches * benchmarkConfig.runs);     \
+        int sampleCount = 0;                                                  \
+        for (int run = 0; run < benchmarkConfig.runs; run++) {                \
+            int i = 0;                                                        \
+            for (int batch = 0; batch < batches; batch++) {                   \
+                const int batchEnd =                                          \
+                    (int)((long long)runIterations * (batch + 1) / batches);  \
+                const int batchSize = batchEnd - i;                           \
+                const long double batchStart = benchmarkNow();                \
+                for (; i < batchEnd; i++) {                                   \
+                    BODY;                                                     \
+                }                                                             \
+                samples[sampleCount++] =                                      \
+                    (benchmarkNow() - batchStart) / batchSize;                \
+            }                                                                 \
+        }                                                                     \
+        benchmarkReport(runName, runIterations, ELEMENTS, samples,            \
+                        sampleCount);                                         \
+        free(samples);                                                        \
     } while (0)
 #define END_BENCHMARKS() }
 
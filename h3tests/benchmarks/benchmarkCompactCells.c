@@ -0,0 +1,93 @@
+/*
+ * Copyright 2026 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "benchmark.h"
+#include "h3api.h"
+
+// Fixtures
+H3Index hex = 0x85283473fffffff;
+H3Index baseCell = 0x8001fffffffffff;
+H3Index pentagon = 0x8009fffffffffff;
+
+BEGIN_BENCHMARKS();
+
+// Every child of a cell: compacts to the cell itself.
+int64_t fullSize;
+if (cellToChildrenSize(hex, 10, &fullSize)) {
+    printf("Failed\n");
+    return 1;
+}
+H3Index *full = calloc(fullSize, sizeof(H3Index));
+H3Index *compacted = calloc(fullSize, sizeof(H3Index));
+cellToChildren(hex, 10, full);
+
+// Every child but some: compacts to cells of every resolution.
+H3Index *partial = calloc(fullSize, sizeof(H3Index));
+int64_t partialSize = 0;
+for (int64_t i = 0; i < fullSize; i++) {
+    if (i % 50 != 0) {
+        partial[partialSize++] = full[i];
+    }
+}
+
+// Pentagon children.
+int64_t pentagonSize;
+if (cellToChildrenSize(pentagon, 5, &pentagonSize)) {
+    printf("Failed\n");
+    return 1;
+}
+H3Index *pentagonChildren = calloc(pentagonSize, sizeof(H3Index));
+cellToChildren(pentagon, 5, pentagonChildren);
+
+BENCHMARK(compactCellsFull, 100,
+          { compactCells(full, compacted, fullSize); });
+BENCHMARK(compactCellsPartial, 100,
+          { compactCells(partial, compacted, partialSize); });
+BENCHMARK(compactCellsPentagon, 100,
+          { compactCells(pentagonChildren, compacted, pentagonSize); });
+
+// Uncompaction of the mixed-resolution compacted set.
+memset(compacted, 0, fullSize * sizeof(H3Index));
+compactCells(partial, compacted, partialSize);
+int64_t numCompacted = 0;
+for (int64_t i = 0; i < partialSize; i++) {
+    if (compacted[i] != H3_NULL) {
+        compacted[numCompacted++] = compacted[i];
+    }
+}
+
+// Large fan-out: a single cell to all of its descendants.
+int64_t fanOutSize;
+if (uncompactCellsSize(&baseCell, 1, 6, &fanOutSize)) {
+    printf("Failed\n");
+    return 1;
+}
+H3Index *out = calloc(fanOutSize, sizeof(H3Index));
+
+BENCHMARK(uncompactCellsMixed, 100, {
+    uncompactCells(compacted, numCompacted, out, fanOutSize, 10);
+});
+BENCHMARK(uncompactCellsFanOut, 10,
+          { uncompactCells(&baseCell, 1, out, fanOutSize, 6); });
+BENCHMARK(uncompactCellsPentagonFanOut, 10,
+          { uncompactCells(&pentagon, 1, out, fanOutSize, 6); });
+
+free(out);
+free(pentagonChildren);
+free(partial);
+free(compacted);
+free(full);
+
+END_BENCHMARKS();
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2026 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/* Replays the data sets of the test suite (cell centers of every resolution,
+ * around base cells and at random) as throughput workloads, one benchmark per
+ * function and resolution.
+ *
+ * The data sets are read from H3_TESTS_DATA_DIR, set by the build.
+ */
+#include "benchmark.h"
+#include "h3api.h"
+
+#ifndef H3_TESTS_DATA_DIR
+#define H3_TESTS_DATA_DIR "../tests/data"
+#endif
+
+#define MAX_RES 15
+/** Number of elements processed by every run (at least one iteration). */
+#define ELEMENTS_PER_RUN 1000000
+
+/** Cells (and their centers) of a resolution. */
+typedef struct {
+    H3Index *cells;
+    LatLng *centers;
+    int64_t count;
+    int64_t capacity;
+} Corpus;
+
+static Corpus corpus[MAX_RES + 1];
+
+/** Adds a cell and its center to the corpus of its resolution. */
+static void corpusAdd(H3Index cell, LatLng center) {
+    Corpus *c = &corpus[getResolution(cell)];
+    if (c->count == c->capacity) {
+        c->capacity = c->capacity ? c->capacity * 2 : 1024;
+        c->cells = realloc(c->cells, c->capacity * sizeof(H3Index));
+        c->centers = realloc(c->centers, c->capacity * sizeof(LatLng));
+    }
+    c->cells[c->count] = cell;
+    c->centers[c->count] = center;
+    c->count++;
+}
+
+/**
+ * Loads a "H3Index lat lng" file (lat/lng in degrees), if it exists.
+ */
+static void corpusLoad(const char *name) {
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s", H3_TESTS_DATA_DIR, name);
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        H3Index cell;
+        double lat, lng;
+        if (sscanf(line, "%" SCNx64 " %lf %lf", &cell, &lat, &lng) == 3 &&
+            isValidCell(cell)) {
+            corpusAdd(cell, (LatLng){degsToRads(lat), degsToRads(lng)});
+        }
+    }
+    fclose(file);
+}
+
+static int compareCells(const void *a, const void *b) {
+    const H3Index x = *(const H3Index *)a;
+    const H3Index y = *(const H3Index *)b;
+    return (x > y) - (x < y);
+}
+
+/** Returns the number of iterations of a run, for a batch size. */
+static int iterationsFor(int64_t elements) {
+    int64_t iterations = ELEMENTS_PER_RUN / elements;
+    return iterations > 1 ? (int)iterations : 1;
+}
+
+BEGIN_BENCHMARKS();
+
+char fileName[64];
+for (int res = 0; res <= MAX_RES; res++) {
+    snprintf(fileName, sizeof(fileName), "res%02dic.txt", res);
+    corpusLoad(fileName);
+    snprintf(fileName, sizeof(fileName), "rand%02dcenters.txt", res);
+    corpusLoad(fileName);
+    for (int baseCell = 0; baseCell < 122; baseCell++) {
+        snprintf(fileName, sizeof(fileName), "bc%02dr%02dcenters.txt",
+                 baseCell, res);
+        corpusLoad(fileName);
+    }
+}
+
+char benchmarkName[64];
+for (int res = 0; res <= MAX_RES; res++) {
+    Corpus *c = &corpus[res];
+    if (c->count == 0) {
+        continue;
+    }
+    const int64_t count = c->count;
+    const int iterations = iterationsFor(count);
+    H3Index *out = calloc(count, sizeof(H3Index));
+    CellBoundary boundary;
+
+    snprintf(benchmarkName, sizeof(benchmarkName), "latLngToCell/r%02d", res);
+    BENCHMARK_RUN(benchmarkName, iterations, count, {
+        for (int64_t j = 0; j < count; j++) {
+            latLngToCell(&c->centers[j], res, &out[j]);
+        }
+    });
+
+    snprintf(benchmarkName, sizeof(benchmarkName), "cellToBoundary/r%02d",
+             res);
+    BENCHMARK_RUN(benchmarkName, iterations, count, {
+        for (int64_t j = 0; j < count; j++) {
+            cellToBoundary(c->cells[j], &boundary);
+        }
+    });
+
+    // Compaction round trip: the (deduplicated) cells to their children, then
+    // back to the cells.
+    if (res < MAX_RES) {
+        qsort(c->cells, count, sizeof(H3Index), compareCells);
+        int64_t unique = 0;
+        for (int64_t j = 0; j < count; j++) {
+            if (unique == 0 || c->cells[unique - 1] != c->cells[j]) {
+                c->cells[unique++] = c->cells[j];
+            }
+        }
+        int64_t numChildren;
+        uncompactCellsSize(c->cells, unique, res + 1, &numChildren);
+        H3Index *children = calloc(numChildren, sizeof(H3Index));
+        H3Index *compacted = calloc(numChildren, sizeof(H3Index));
+
+        snprintf(benchmarkName, sizeof(benchmarkName),
+                 "compactRoundTrip/r%02d", res);
+        const int roundTrips = iterationsFor(numChildren);
+        BENCHMARK_RUN(benchmarkName, roundTrips, numChildren, {
+            uncompactCells(c->cells, unique, children, numChildren, res + 1);
+            compactCells(children, compacted, numChildren);
+        });
+
+        free(compacted);
+        free(children);
+    }
+
+    free(out);
+}
+
+for (int res = 0; res <= MAX_RES; res++) {
+    free(corpus[res].centers);
+    free(corpus[res].cells);
+}
+
+END_BENCHMARKS();
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2026 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/* Batch kernels on the baseline instruction set against the widest one
+ * supported: a dispatch that doesn't vectorize shows no difference. */
+#include "benchmark.h"
+#include "h3api.h"
+
+#define NUM_CELLS 1000000
+
+BEGIN_BENCHMARKS();
+
+// Resolution 15 descendants of a cell, every 7th one corrupted.
+H3Index *cells = calloc(NUM_CELLS, sizeof(H3Index));
+H3Index *parents = calloc(NUM_CELLS, sizeof(H3Index));
+uint8_t *valid = calloc(NUM_CELLS, sizeof(uint8_t));
+uint64_t state = 0x9e3779b97f4a7c15;
+for (int64_t i = 0; i < NUM_CELLS; i++) {
+    state = state * 6364136223846793005 + 1442695040888963407;
+    cellToCenterChild(0x85283473fffffff, 15, &cells[i]);
+    // Random digits for the resolutions 6 to 15.
+    for (int res = 6; res <= 15; res++) {
+        uint64_t digit = (state >> (3 * (res - 6))) % 7;
+        cells[i] |= digit << (3 * (15 - res));
+    }
+    if (i % 7 == 0) {
+        cells[i] ^= (H3Index)1 << (state >> 58);
+    }
+}
+
+const uint32_t features[] = {0, UINT32_MAX};
+const char *areValidNames[] = {"areValidCells (baseline)",
+                               "areValidCells (dispatched)"};
+const char *toParentsNames[] = {"cellsToParents (baseline)",
+                                "cellsToParents (dispatched)"};
+for (int f = 0; f < 2; f++) {
+    h3SetCpuFeatures(features[f]);
+    BENCHMARK_RUN(areValidNames[f], 10, NUM_CELLS,
+                  { areValidCells(cells, NUM_CELLS, valid); });
+    BENCHMARK_RUN(toParentsNames[f], 10, NUM_CELLS,
+                  { cellsToParents(cells, NUM_CELLS, 9, parents); });
+}
+h3SetCpuFeatures(UINT32_MAX);
+
+free(valid);
+free(parents);
+free(cells);
+
+END_BENCHMARKS();
@@ -15,7 +15,6 @@
  */
 #include "benchmark.h"
 #include "h3api.h"
-#include "latLng.h"
 
 // Fixtures (arbitrary res 9 hexagon)
 H3Index edges[6] = {0};
@@ -14,7 +14,6 @@
  * limitations under the License.
  */
 #include "benchmark.h"
-#include "h3Index.h"
 #include "h3api.h"
 
 // Fixtures
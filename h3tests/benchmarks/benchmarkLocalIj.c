@@ -0,0 +1,67 @@
+/*
+ * Copyright 2026 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "benchmark.h"
+#include "h3api.h"
+
+// Fixtures
+H3Index hex = 0x89283080ddbffff;
+H3Index pentagon = 0x89080000003ffff;
+
+BEGIN_BENCHMARKS();
+
+int64_t diskSize;
+if (maxGridDiskSize(10, &diskSize)) {
+    printf("Failed\n");
+    return 1;
+}
+H3Index *disk = calloc(diskSize, sizeof(H3Index));
+H3Index *pentagonDisk = calloc(diskSize, sizeof(H3Index));
+gridDisk(hex, 10, disk);
+gridDisk(pentagon, 10, pentagonDisk);
+
+// A neighbor and the last cell of the disk, 10 cells away.
+H3Index near = disk[1];
+H3Index far = disk[diskSize - 1];
+// Cells around the pentagon, some of them across its deleted subsequence.
+H3Index pentagonNear = pentagonDisk[1];
+H3Index pentagonFar = H3_NULL;
+for (int64_t i = diskSize - 1; i >= 0 && pentagonFar == H3_NULL; i--) {
+    pentagonFar = pentagonDisk[i];
+}
+
+CoordIJ ij;
+H3Index h;
+
+BENCHMARK(cellToLocalIjNear, 100000, { cellToLocalIj(hex, near, 0, &ij); });
+BENCHMARK(cellToLocalIjFar, 100000, { cellToLocalIj(hex, far, 0, &ij); });
+BENCHMARK(cellToLocalIjPentagonNear, 100000,
+          { cellToLocalIj(pentagon, pentagonNear, 0, &ij); });
+BENCHMARK(cellToLocalIjPentagonFar, 100000,
+          { cellToLocalIj(pentagon, pentagonFar, 0, &ij); });
+
+CoordIJ farIj;
+cellToLocalIj(hex, far, 0, &farIj);
+CoordIJ pentagonFarIj;
+cellToLocalIj(pentagon, pentagonFar, 0, &pentagonFarIj);
+
+BENCHMARK(localIjToCellFar, 100000, { localIjToCell(hex, &farIj, 0, &h); });
+BENCHMARK(localIjToCellPentagonFar, 100000,
+          { localIjToCell(pentagon, &pentagonFarIj, 0, &h); });
+
+free(pentagonDisk);
+free(disk);
+
+END_BENCHMARKS();
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2026 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "benchmark.h"
+#include "h3api.h"
+
+// Fixtures
+H3Index hex = 0x89283080ddbffff;
+H3Index pentagon = 0x89080000003ffff;
+H3Index coarse = 0x8029fffffffffff;
+LatLng sf = {0.659966917655, -2.1364398519396};
+LatLng paris = {0.852471681746, 0.0409445989144};
+
+BEGIN_BENCHMARKS();
+
+double out;
+
+BENCHMARK(cellAreaRads2, 100000, { cellAreaRads2(hex, &out); });
+BENCHMARK(cellAreaKm2, 100000, { cellAreaKm2(hex, &out); });
+BENCHMARK(cellAreaM2, 100000, { cellAreaM2(hex, &out); });
+BENCHMARK(cellAreaRads2Pentagon, 100000, { cellAreaRads2(pentagon, &out); });
+BENCHMARK(cellAreaRads2Res0, 100000, { cellAreaRads2(coarse, &out); });
+
+BENCHMARK(greatCircleDistanceRads, 100000, {
+    out = greatCircleDistanceRads(&sf, &paris);
+    DO_NOT_OPTIMIZE(out);
+});
+BENCHMARK(greatCircleDistanceKm, 100000, {
+    out = greatCircleDistanceKm(&sf, &paris);
+    DO_NOT_OPTIMIZE(out);
+});
+BENCHMARK(greatCircleDistanceM, 100000, {
+    out = greatCircleDistanceM(&sf, &paris);
+    DO_NOT_OPTIMIZE(out);
+});
+
+END_BENCHMARKS();
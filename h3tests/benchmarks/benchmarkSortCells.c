@@ -0,0 +1,64 @@
+/*
+ * Copyright 2026 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/* Sorting of index arrays: h3SortCells against qsort. */
+#include "benchmark.h"
+#include "h3api.h"
+
+#define NUM_CELLS 1000000
+
+static int compareIndexes(const void *a, const void *b) {
+    const H3Index x = *(const H3Index *)a;
+    const H3Index y = *(const H3Index *)b;
+    return (x > y) - (x < y);
+}
+
+BEGIN_BENCHMARKS();
+
+// Resolution 9 cells around San Francisco, in the order of their coordinates.
+LatLng *coords = calloc(NUM_CELLS, sizeof(LatLng));
+uint64_t state = 0x9e3779b97f4a7c15;
+for (int64_t i = 0; i < NUM_CELLS; i++) {
+    state = state * 6364136223846793005 + 1442695040888963407;
+    coords[i].lat = 0.657 + (double)(state >> 11) / 9007199254740992.0 * 0.005;
+    state = state * 6364136223846793005 + 1442695040888963407;
+    coords[i].lng = -2.139 + (double)(state >> 11) / 9007199254740992.0 * 0.005;
+}
+H3Index *cells = calloc(NUM_CELLS, sizeof(H3Index));
+H3Index *sorted = calloc(NUM_CELLS, sizeof(H3Index));
+latLngsToCells(coords, NUM_CELLS, 9, cells, NULL);
+
+BENCHMARK_RUN("qsort", 10, NUM_CELLS, {
+    memcpy(sorted, cells, NUM_CELLS * sizeof(H3Index));
+    qsort(sorted, NUM_CELLS, sizeof(H3Index), compareIndexes);
+});
+BENCHMARK_RUN("h3SortCells", 10, NUM_CELLS, {
+    memcpy(sorted, cells, NUM_CELLS * sizeof(H3Index));
+    h3SortCells(sorted, NUM_CELLS);
+});
+BENCHMARK_RUN("h3SortCellsParallel", 10, NUM_CELLS, {
+    memcpy(sorted, cells, NUM_CELLS * sizeof(H3Index));
+    h3SortCellsParallel(sorted, NUM_CELLS);
+});
+BENCHMARK_RUN("h3SortCellsByLocality", 10, NUM_CELLS, {
+    memcpy(sorted, cells, NUM_CELLS * sizeof(H3Index));
+    h3SortCellsByLocality(sorted, NUM_CELLS);
+});
+
+free(sorted);
+free(cells);
+free(coords);
+
+END_BENCHMARKS();
@@ -0,0 +1,37 @@
+/*
+ * Copyright 2026 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "benchmark.h"
+#include "h3api.h"
+
+// Fixtures
+H3Index hex = 0x89283080ddbffff;
+H3Index coarse = 0x8029fffffffffff;
+const char *hexString = "89283080ddbffff";
+const char *upperString = "89283080DDBFFFF";
+
+BEGIN_BENCHMARKS();
+
+char buffer[17];
+H3Index h;
+
+BENCHMARK(h3ToString, 100000, { h3ToString(hex, buffer, sizeof(buffer)); });
+BENCHMARK(h3ToStringRes0, 100000,
+          { h3ToString(coarse, buffer, sizeof(buffer)); });
+
+BENCHMARK(stringToH3, 100000, { stringToH3(hexString, &h); });
+BENCHMARK(stringToH3Upper, 100000, { stringToH3(upperString, &h); });
+
+END_BENCHMARKS();
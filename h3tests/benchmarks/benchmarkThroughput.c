@@ -0,0 +1,256 @@
+/*
+ * Copyright 2026 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/* Throughput (elements per second) of the batch functions, for batch
+ * sizes from 1k elements and thread counts from 1.
+ *
+ * The parallel functions (gridDisksParallel, polygonToCellsParallel,
+ * uncompactCellsParallel, cellsToLinkedMultiPolygonParallel) run on the
+ * library thread pool, sized with h3SetThreadPool. The serial batch functions
+ * (latLngsToCells, cellsToParents) are sharded over as many caller threads,
+ * as a service would do. compactCells needs the whole set, so it only runs on
+ * the calling thread.
+ *
+ * The largest batch size (1M elements by default, up to 100M) and thread
+ * count (the number of CPUs by default, up to 64) are set with the
+ * `H3_BENCHMARK_MAX_ELEMENTS` and `H3_BENCHMARK_MAX_THREADS` environment
+ * variables.
+ */
+#include <pthread.h>
+#include <unistd.h>
+
+#include "benchmark.h"
+#include "h3api.h"
+
+#define MAX_ELEMENTS 100000000
+#define MAX_THREADS 64
+/** Number of elements processed by every run (at least one iteration). */
+#define ELEMENTS_PER_RUN 2000000
+
+static const int64_t batchSizes[] = {1000,    10000,    100000,
+                                     1000000, 10000000, 100000000};
+static const int threadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+
+// Fixtures
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static const H3Index sfCell = 0x85283473fffffff;
+
+/** Returns the value of a positive integer environment variable. */
+static int64_t envLimit(const char *name, int64_t fallback, int64_t max) {
+    const char *value = getenv(name);
+    int64_t limit = value != NULL ? atoll(value) : fallback;
+    if (limit <= 0) {
+        limit = fallback;
+    }
+    return limit < max ? limit : max;
+}
+
+/** Returns the number of iterations of a run, for a batch size. */
+static int iterationsFor(int64_t elements) {
+    int64_t iterations = ELEMENTS_PER_RUN / elements;
+    return iterations > 1 ? (int)iterations : 1;
+}
+
+/** Deterministic pseudo-random coordinates, around San Francisco. */
+static void randomCoords(LatLng *coords, int64_t count) {
+    uint64_t state = 0x9e3779b97f4a7c15;
+    for (int64_t i = 0; i < count; i++) {
+        state = state * 6364136223846793005 + 1442695040888963407;
+        double u = (double)(state >> 11) / 9007199254740992.0;
+        state = state * 6364136223846793005 + 1442695040888963407;
+        double v = (double)(state >> 11) / 9007199254740992.0;
+        coords[i].lat = 0.657 + u * 0.005;
+        coords[i].lng = -2.139 + v * 0.005;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/** A share of a serial batch, processed by a caller thread. */
+typedef struct {
+    const void *in;
+    void *out;
+    int64_t count;
+} Shard;
+
+typedef void *(*ShardFn)(void *);
+
+static void *latLngsToCellsShard(void *arg) {
+    Shard *shard = arg;
+    latLngsToCells(shard->in, shard->count, 9, shard->out, NULL);
+    return NULL;
+}
+
+static void *cellsToParentsShard(void *arg) {
+    Shard *shard = arg;
+    cellsToParents(shard->in, shard->count, 5, shard->out);
+    return NULL;
+}
+
+/** Runs a serial batch function over `threads` caller threads. */
+static void runSharded(ShardFn fn, const void *in, size_t inSize, void *out,
+                       size_t outSize, int64_t count, int threads) {
+    pthread_t handles[MAX_THREADS];
+    Shard shards[MAX_THREADS];
+    for (int t = 0; t < threads; t++) {
+        int64_t start = count * t / threads;
+        int64_t end = count * (t + 1) / threads;
+        shards[t].in = (const char *)in + start * inSize;
+        shards[t].out = (char *)out + start * outSize;
+        shards[t].count = end - start;
+        if (t > 0) {
+            pthread_create(&handles[t], NULL, fn, &shards[t]);
+        }
+    }
+    fn(&shards[0]);
+    for (int t = 1; t < threads; t++) {
+        pthread_join(handles[t], NULL);
+    }
+}
+
+BEGIN_BENCHMARKS();
+
+const int64_t maxElements =
+    envLimit("H3_BENCHMARK_MAX_ELEMENTS", 1000000, MAX_ELEMENTS);
+const int64_t maxThreads = envLimit("H3_BENCHMARK_MAX_THREADS",
+                                    sysconf(_SC_NPROCESSORS_ONLN), MAX_THREADS);
+char benchmarkName[128];
+
+LatLng *coords = calloc(maxElements, sizeof(LatLng));
+H3Index *cells = calloc(maxElements, sizeof(H3Index));
+H3Index *out = calloc(maxElements, sizeof(H3Index));
+randomCoords(coords, maxElements);
+latLngsToCells(coords, maxElements, 9, cells, NULL);
+
+for (size_t s = 0; s < sizeof(batchSizes) / sizeof(batchSizes[0]); s++) {
+    const int64_t size = batchSizes[s];
+    if (size > maxElements) {
+        break;
+    }
+    const int iterations = iterationsFor(size);
+    for (size_t t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]);
+         t++) {
+        const int threads = threadCounts[t];
+        if (threads > maxThreads) {
+            break;
+        }
+
+        snprintf(benchmarkName, sizeof(benchmarkName),
+                 "latLngsToCells/%" PRId64 "/%d", size, threads);
+        BENCHMARK_RUN(benchmarkName, iterations, size, {
+            runSharded(latLngsToCellsShard, coords, sizeof(LatLng), out,
+                       sizeof(H3Index), size, threads);
+        });
+
+        snprintf(benchmarkName, sizeof(benchmarkName),
+                 "cellsToParents/%" PRId64 "/%d", size, threads);
+        BENCHMARK_RUN(benchmarkName, iterations, size, {
+            runSharded(cellsToParentsShard, cells, sizeof(H3Index), out,
+                       sizeof(H3Index), size, threads);
+        });
+
+        // Each origin yields 19 cells.
+        const int64_t origins = size / 19 > 0 ? size / 19 : 1;
+        h3SetThreadPool(threads);
+        snprintf(benchmarkName, sizeof(benchmarkName),
+                 "gridDisksParallel/%" PRId64 "/%d", origins * 19, threads);
+        BENCHMARK_RUN(benchmarkName, iterations, origins * 19,
+                      { gridDisksParallel(cells, origins, 2, out); });
+    }
+}
+
+// Polygon filling, compaction and outlining: the batch sizes follow the
+// resolution.
+GeoPolygon sfPolygon = {.geoloop = {.numVerts = 6, .verts = sfVerts}};
+for (int res = 9; res <= 15; res += 2) {
+    int64_t maxSize;
+    maxPolygonToCellsSize(&sfPolygon, res, 0, &maxSize);
+    int64_t childrenSize;
+    cellToChildrenSize(sfCell, res - 3, &childrenSize);
+    if (maxSize > maxElements || childrenSize * 343 > maxElements) {
+        break;
+    }
+    H3Index *fill = calloc(maxSize, sizeof(H3Index));
+    H3Index *parents = calloc(childrenSize, sizeof(H3Index));
+    H3Index *children = calloc(childrenSize * 343, sizeof(H3Index));
+    H3Index *compacted = calloc(childrenSize * 343, sizeof(H3Index));
+    polygonToCells(&sfPolygon, res, 0, fill);
+    int64_t fillSize = 0;
+    for (int64_t i = 0; i < maxSize; i++) {
+        if (fill[i] != H3_NULL) {
+            fill[fillSize++] = fill[i];
+        }
+    }
+    cellToChildren(sfCell, res - 3, parents);
+    uncompactCells(parents, childrenSize, children, childrenSize * 343, res);
+    const int64_t numChildren = childrenSize * 343;
+    const int iterations = iterationsFor(numChildren);
+
+    snprintf(benchmarkName, sizeof(benchmarkName), "compactCells/%" PRId64,
+             numChildren);
+    BENCHMARK_RUN(benchmarkName, iterations, numChildren,
+                  { compactCells(children, compacted, numChildren); });
+
+    for (size_t t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]);
+         t++) {
+        const int threads = threadCounts[t];
+        if (threads > maxThreads) {
+            break;
+        }
+        h3SetThreadPool(threads);
+
+        snprintf(benchmarkName, sizeof(benchmarkName),
+                 "polygonToCellsParallel/%" PRId64 "/%d", fillSize, threads);
+        BENCHMARK_RUN(benchmarkName, iterationsFor(fillSize), fillSize, {
+            memset(out, 0, maxSize * sizeof(H3Index));
+            polygonToCellsParallel(&sfPolygon, res, 0, out);
+        });
+
+        snprintf(benchmarkName, sizeof(benchmarkName),
+                 "uncompactCellsParallel/%" PRId64 "/%d", numChildren,
+                 threads);
+        BENCHMARK_RUN(benchmarkName, iterations, numChildren, {
+            uncompactCellsParallel(parents, childrenSize, out, numChildren,
+                                   res);
+        });
+
+        if (fillSize <= INT32_MAX) {
+            snprintf(benchmarkName, sizeof(benchmarkName),
+                     "cellsToLinkedMultiPolygonParallel/%" PRId64 "/%d",
+                     fillSize, threads);
+            BENCHMARK_RUN(benchmarkName, iterationsFor(fillSize), fillSize, {
+                LinkedGeoPolygon polygon;
+                cellsToLinkedMultiPolygonParallel(fill, (int)fillSize,
+                                                  &polygon);
+                destroyLinkedMultiPolygon(&polygon);
+            });
+        }
+    }
+
+    free(compacted);
+    free(children);
+    free(parents);
+    free(fill);
+}
+
+h3SetThreadPool(0);
+free(out);
+free(cells);
+free(coords);
+
+END_BENCHMARKS();
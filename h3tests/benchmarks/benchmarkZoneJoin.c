@@ -0,0 +1,108 @@
+/*
+ * Copyright 2026 Uber Technologies, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+/* Spatial join of random points to zones, with the zone index against the
+ * polygon fill and cell lookup loop it replaces. The zones are the outlines
+ * of resolution 6 cells around San Francisco. */
+#include "benchmark.h"
+#include "h3api.h"
+
+#define NUM_POINTS 1000000
+#define NUM_ZONES 19
+
+static int compareIndexes(const void *a, const void *b) {
+    const H3Index x = *(const H3Index *)a;
+    const H3Index y = *(const H3Index *)b;
+    return (x > y) - (x < y);
+}
+
+BEGIN_BENCHMARKS();
+
+H3Index zoneCells[NUM_ZONES];
+gridDisk(0x86283470fffffff, 2, zoneCells);
+CellBoundary boundaries[NUM_ZONES];
+GeoPolygon zones[NUM_ZONES];
+int64_t ids[NUM_ZONES];
+for (int i = 0; i < NUM_ZONES; i++) {
+    cellToBoundary(zoneCells[i], &boundaries[i]);
+    zones[i].geoloop.numVerts = boundaries[i].numVerts;
+    zones[i].geoloop.verts = boundaries[i].verts;
+    zones[i].numHoles = 0;
+    zones[i].holes = NULL;
+    ids[i] = i;
+}
+
+LatLng center;
+cellToLatLng(0x86283470fffffff, &center);
+LatLng *points = calloc(NUM_POINTS, sizeof(LatLng));
+uint64_t state = 0x9e3779b97f4a7c15;
+for (int64_t i = 0; i < NUM_POINTS; i++) {
+    state = state * 6364136223846793005 + 1442695040888963407;
+    points[i].lat =
+        center.lat - 0.004 + (double)(state >> 11) / 9007199254740992.0 * 0.008;
+    state = state * 6364136223846793005 + 1442695040888963407;
+    points[i].lng =
+        center.lng - 0.004 + (double)(state >> 11) / 9007199254740992.0 * 0.008;
+}
+int64_t *out = calloc(NUM_POINTS, sizeof(int64_t));
+int64_t *offsets = calloc(NUM_POINTS + 1, sizeof(int64_t));
+
+BENCHMARK_RUN("createZoneIndex", 10, NUM_ZONES, {
+    H3ZoneIndex *index;
+    createZoneIndex(zones, ids, NUM_ZONES, 10, &index);
+    destroyZoneIndex(index);
+});
+
+H3ZoneIndex *index;
+createZoneIndex(zones, ids, NUM_ZONES, 10, &index);
+BENCHMARK_RUN("latLngsToZoneIds", 10, NUM_POINTS, {
+    latLngsToZoneIds(index, points, NUM_POINTS, out, NUM_POINTS, offsets);
+});
+BENCHMARK_RUN("latLngsToZoneIdsParallel", 10, NUM_POINTS, {
+    latLngsToZoneIdsParallel(index, points, NUM_POINTS, out, NUM_POINTS,
+                             offsets);
+});
+destroyZoneIndex(index);
+
+// Reference: a sorted (cell, zone) table of the polygon fills at resolution
+// 10, and a binary search per point (the approximate join of cells).
+int64_t tableSize = 0;
+H3Index *table = NULL;
+for (int i = 0; i < NUM_ZONES; i++) {
+    int64_t size;
+    maxPolygonToCellsSize(&zones[i], 10, 0, &size);
+    table = realloc(table, (tableSize + size) * sizeof(H3Index));
+    memset(table + tableSize, 0, size * sizeof(H3Index));
+    polygonToCells(&zones[i], 10, 0, table + tableSize);
+    tableSize += size;
+}
+qsort(table, tableSize, sizeof(H3Index), compareIndexes);
+BENCHMARK_RUN("latLngToCellLookup", 10, NUM_POINTS, {
+    int64_t found = 0;
+    for (int64_t i = 0; i < NUM_POINTS; i++) {
+        H3Index cell;
+        latLngToCell(&points[i], 10, &cell);
+        found += bsearch(&cell, table, tableSize, sizeof(H3Index),
+                         compareIndexes) != NULL;
+    }
+    DO_NOT_OPTIMIZE(found);
+});
+
+free(table);
+free(offsets);
+free(out);
+free(points);
+
+END_BENCHMARKS();
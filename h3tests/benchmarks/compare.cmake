@@ -0,0 +1,118 @@
+# Runs a benchmark built against h3oh3o and against the reference library, and
+# prints the median durations of every benchmarked function side by side.
+#
+# Usage:
+#   cmake -DH3OH3O=<benchmark> -DH3=<benchmark> [-DTOLERANCE=<percent>]
+#         [-DARGS=<benchmark arguments>] -P compare.cmake
+#
+# With TOLERANCE, the script fails when a function is more than TOLERANCE
+# percent slower with h3oh3o.
+
+cmake_minimum_required(VERSION 3.20)
+
+if(NOT H3OH3O OR NOT H3)
+    message(FATAL_ERROR "H3OH3O and H3 must name the benchmarks to compare")
+endif()
+separate_arguments(ARGS)
+
+# Runs a benchmark and stores the median durations (in nanoseconds) of its
+# functions in `<prefix>_<name>`, and the names of the functions in
+# `<prefix>_names`.
+function(run_benchmark PROGRAM PREFIX)
+    execute_process(
+        COMMAND ${PROGRAM} --json ${ARGS}
+        OUTPUT_VARIABLE output
+        RESULT_VARIABLE result
+    )
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "${PROGRAM} failed: ${result}")
+    endif()
+
+    set(names)
+    string(REPLACE "\n" ";" lines "${output}")
+    foreach(line IN LISTS lines)
+        if(NOT line MATCHES "^{")
+            continue()
+        endif()
+        string(JSON name GET "${line}" name)
+        string(JSON median GET "${line}" median_us)
+        # Microseconds to nanoseconds, without floating-point arithmetic.
+        string(REGEX MATCH "^([0-9]+)\\.?([0-9]*)" _ "${median}")
+        string(SUBSTRING "${CMAKE_MATCH_2}000" 0 3 fraction)
+        math(EXPR nanos "${CMAKE_MATCH_1} * 1000 + 1${fraction} - 1000")
+        set(${PREFIX}_${name} ${nanos} PARENT_SCOPE)
+        list(APPEND names ${name})
+    endforeach()
+    set(${PREFIX}_names ${names} PARENT_SCOPE)
+endfunction()
+
+# Formats a number of thousandths (e.g. nanoseconds as microseconds).
+function(format_thousandths VALUE OUT)
+    math(EXPR whole "${VALUE} / 1000")
+    math(EXPR fraction "${VALUE} % 1000 + 1000")
+    string(SUBSTRING "${fraction}" 1 3 fraction)
+    set(${OUT} "${whole}.${fraction}" PARENT_SCOPE)
+endfunction()
+
+# Left-pads (or right-pads, with a negative width) a string to a width.
+function(pad VALUE WIDTH OUT)
+    set(padded "${VALUE}")
+    string(LENGTH "${padded}" length)
+    if(WIDTH LESS 0)
+        math(EXPR WIDTH "-${WIDTH}")
+        while(length LESS WIDTH)
+            string(APPEND padded " ")
+            math(EXPR length "${length} + 1")
+        endwhile()
+    else()
+        while(length LESS WIDTH)
+            string(PREPEND padded " ")
+            math(EXPR length "${length} + 1")
+        endwhile()
+    endif()
+    set(${OUT} "${padded}" PARENT_SCOPE)
+endfunction()
+
+run_benchmark(${H3OH3O} h3oh3o)
+run_benchmark(${H3} h3)
+
+get_filename_component(title ${H3OH3O} NAME_WE)
+pad("function" -40 header)
+pad("h3 (us)" 14 h3_header)
+pad("h3oh3o (us)" 14 h3oh3o_header)
+pad("ratio" 9 ratio_header)
+message("${title}\n${header}${h3_header}${h3oh3o_header}${ratio_header}")
+
+set(regressions)
+foreach(name IN LISTS h3oh3o_names)
+    if(NOT DEFINED h3_${name})
+        continue()
+    endif()
+    set(reference ${h3_${name}})
+    set(value ${h3oh3o_${name}})
+    if(reference EQUAL 0)
+        set(reference 1)
+    endif()
+    math(EXPR ratio "${value} * 1000 / ${reference}")
+
+    format_thousandths(${reference} reference_text)
+    format_thousandths(${value} value_text)
+    format_thousandths(${ratio} ratio_text)
+    pad("${name}" -40 name_text)
+    pad("${reference_text}" 14 reference_text)
+    pad("${value_text}" 14 value_text)
+    pad("${ratio_text}x" 9 ratio_text)
+    message("${name_text}${reference_text}${value_text}${ratio_text}")
+
+    if(DEFINED TOLERANCE AND NOT TOLERANCE STREQUAL "")
+        math(EXPR limit "1000 + ${TOLERANCE} * 10")
+        if(ratio GREATER limit)
+            list(APPEND regressions ${name})
+        endif()
+    endif()
+endforeach()
+
+if(regressions)
+    message(FATAL_ERROR
+        "more than ${TOLERANCE}% slower than h3: ${regressions}")
+endif()
@@ -182,3 +182,12 @@ int64_t countNonNullIndexes(H3Index *indexes, int64_t numCells) {
     }
     return nonNullIndexes;
 }
+
+/**
+ * qsort/bsearch comparator ordering H3 indexes numerically.
+ */
+int compareCells(const void *a, const void *b) {
+    const H3Index x = *(const H3Index *)a;
+    const H3Index y = *(const H3Index *)b;
+    return (x > y) - (x < y);
+}
@@ -55,4 +55,6 @@ void iterateAllDirectedEdgesAtRes(int res, void (*callback)(H3Index));
 
 int64_t countNonNullIndexes(H3Index *indexes, int64_t numCells);
 
+int compareCells(const void *a, const void *b);
+
 #endif
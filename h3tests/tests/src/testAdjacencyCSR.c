@@ -0,0 +1,87 @@
+/** @file testAdjacencyCSR.c
+ * @brief Tests the CSR neighbor graph of a cell set
+ *
+ * usage: `testAdjacencyCSR`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/** Checks the graph of a set against areNeighborCells. */
+static void assertGraph(const H3Index *cells, int64_t count, int parallel) {
+    int64_t *offsets = calloc(count + 1, sizeof(int64_t));
+    int64_t *neighbors = calloc(6 * count, sizeof(int64_t));
+    if (parallel) {
+        t_assertSuccess(
+            cellsToAdjacencyCSRParallel(cells, count, offsets, neighbors));
+    } else {
+        t_assertSuccess(cellsToAdjacencyCSR(cells, count, offsets, neighbors));
+    }
+
+    t_assert(offsets[0] == 0, "first row");
+    for (int64_t i = 0; i < count; i++) {
+        int64_t expected = 0;
+        for (int64_t j = 0; j < count; j++) {
+            int isNeighbor;
+            t_assertSuccess(areNeighborCells(cells[i], cells[j], &isNeighbor));
+            expected += isNeighbor;
+        }
+        t_assert(offsets[i + 1] - offsets[i] == expected,
+                 "every neighbor in the set");
+        for (int64_t k = offsets[i]; k < offsets[i + 1]; k++) {
+            int isNeighbor;
+            t_assertSuccess(
+                areNeighborCells(cells[i], cells[neighbors[k]], &isNeighbor));
+            t_assert(isNeighbor, "neighbor");
+        }
+    }
+    free(neighbors);
+    free(offsets);
+}
+
+SUITE(adjacencyCSR) {
+    TEST(disk) {
+        H3Index disk[37];
+        t_assertSuccess(gridDisk(0x8928308280fffff, 3, disk));
+        assertGraph(disk, 37, 0);
+        assertGraph(disk, 37, 1);
+
+        // The center has its 6 neighbors, the outer ring fewer.
+        int64_t offsets[38];
+        int64_t neighbors[6 * 37];
+        t_assertSuccess(cellsToAdjacencyCSR(disk, 37, offsets, neighbors));
+        t_assert(offsets[1] == 6, "center has 6 neighbors");
+        t_assert(offsets[37] < 6 * 37, "outer cells have fewer neighbors");
+    }
+
+    TEST(pentagon) {
+        H3Index disk[19];
+        t_assertSuccess(gridDisk(0x821c07fffffffff, 2, disk));
+        int64_t count = 0;
+        for (int i = 0; i < 19; i++) {
+            if (disk[i] != H3_NULL) {
+                disk[count++] = disk[i];
+            }
+        }
+        assertGraph(disk, count, 0);
+        assertGraph(disk, count, 1);
+    }
+
+    TEST(errors) {
+        H3Index cells[] = {0x8928308280fffff, 0x8928308280fffff};
+        int64_t offsets[3];
+        int64_t neighbors[12];
+        t_assert(cellsToAdjacencyCSR(cells, 2, offsets, neighbors) ==
+                     E_DUPLICATE_INPUT,
+                 "duplicate cell");
+        cells[1] = 0x1234;
+        t_assert(cellsToAdjacencyCSR(cells, 2, offsets, neighbors) ==
+                     E_CELL_INVALID,
+                 "invalid cell");
+        t_assertSuccess(cellsToAdjacencyCSR(cells, 0, offsets, neighbors));
+        t_assert(offsets[0] == 0, "empty graph");
+    }
+}
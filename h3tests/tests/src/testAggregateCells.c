@@ -0,0 +1,109 @@
+/** @file testAggregateCells.c
+ * @brief Tests the roll-up of cell values to coarser resolutions
+ *
+ * usage: `testAggregateCells`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static const H3Index parent = 0x85283473fffffff;
+
+SUITE(aggregateCells) {
+    TEST(pyramid) {
+        // Every resolution 7 descendant of the parent, valued 1 to 49.
+        H3Index cells[49];
+        double values[49];
+        t_assertSuccess(cellToChildren(parent, 7, cells));
+        qsort(cells, 49, sizeof(H3Index), compareCells);
+        for (int i = 0; i < 49; i++) {
+            values[i] = i + 1;
+        }
+
+        H3Index outCells[49 * 3];
+        double outValues[49 * 3];
+        int64_t offsets[4];
+        t_assertSuccess(aggregateCellsToParents(cells, values, 49, 7, 5,
+                                                REDUCER_SUM, outCells,
+                                                outValues, 49 * 3, offsets));
+        t_assert(offsets[0] == 0 && offsets[1] == 1 && offsets[2] == 8 &&
+                     offsets[3] == 57,
+                 "level sizes");
+        t_assert(outCells[0] == parent && outValues[0] == 49 * 50 / 2,
+                 "sum at the coarsest resolution");
+        for (int i = 0; i < 7; i++) {
+            H3Index child = outCells[1 + i];
+            H3Index childParent;
+            t_assertSuccess(cellToParent(child, 5, &childParent));
+            t_assert(childParent == parent, "child of the parent");
+            // The 7 children of a resolution 6 cell are contiguous.
+            double expected = 0;
+            for (int j = 7 * i; j < 7 * i + 7; j++) {
+                expected += values[j];
+            }
+            t_assert(outValues[1 + i] == expected, "sum of the children");
+        }
+        t_assert(memcmp(outCells + 8, cells, sizeof(cells)) == 0,
+                 "finest level");
+
+        t_assertSuccess(aggregateCellsToParents(cells, values, 49, 7, 6,
+                                                REDUCER_MAX, outCells,
+                                                outValues, 49 * 2, offsets));
+        t_assert(offsets[1] == 7 && outValues[0] == 7 && outValues[6] == 49,
+                 "max");
+        t_assertSuccess(aggregateCellsToParents(cells, values, 49, 7, 6,
+                                                REDUCER_MIN, outCells,
+                                                outValues, 49 * 2, offsets));
+        t_assert(outValues[0] == 1 && outValues[6] == 43, "min");
+    }
+
+    TEST(duplicates) {
+        H3Index cells[] = {0x872834700ffffff, 0x872834700ffffff,
+                           0x872834701ffffff};
+        H3Index outCells[6];
+        double outValues[6];
+        int64_t offsets[3];
+        t_assertSuccess(aggregateCellsToParents(cells, NULL, 3, 7, 6,
+                                                REDUCER_COUNT, outCells,
+                                                outValues, 6, offsets));
+        t_assert(offsets[1] == 1 && offsets[2] == 3, "duplicates merged");
+        t_assert(outValues[0] == 3 && outValues[1] == 2 && outValues[2] == 1,
+                 "counts");
+    }
+
+    TEST(errors) {
+        H3Index cells[] = {0x872834701ffffff, 0x872834700ffffff};
+        double values[] = {1, 2};
+        H3Index outCells[4];
+        double outValues[4];
+        int64_t offsets[3];
+        t_assert(aggregateCellsToParents(cells, values, 2, 7, 6, REDUCER_SUM,
+                                         outCells, outValues, 4,
+                                         offsets) == E_FAILED,
+                 "unsorted cells");
+        t_assert(aggregateCellsToParents(cells, values, 1, 8, 6, REDUCER_SUM,
+                                         outCells, outValues, 4,
+                                         offsets) == E_RES_MISMATCH,
+                 "resolution mismatch");
+        t_assert(aggregateCellsToParents(cells, values, 1, 7, 8, REDUCER_SUM,
+                                         outCells, outValues, 4,
+                                         offsets) == E_RES_MISMATCH,
+                 "coarsest resolution finer");
+        t_assert(aggregateCellsToParents(cells, values, 1, 7, 6, 42, outCells,
+                                         outValues, 4,
+                                         offsets) == E_OPTION_INVALID,
+                 "unknown reducer");
+        t_assert(aggregateCellsToParents(cells, values, 1, 7, 6, REDUCER_SUM,
+                                         outCells, outValues, 1,
+                                         offsets) == E_MEMORY_BOUNDS,
+                 "output too small");
+        t_assertSuccess(aggregateCellsToParents(cells, values, 0, 7, 6,
+                                                REDUCER_SUM, outCells,
+                                                outValues, 0, offsets));
+        t_assert(offsets[0] == 0 && offsets[2] == 0, "empty levels");
+    }
+}
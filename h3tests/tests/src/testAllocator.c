@@ -0,0 +1,87 @@
+/** @file testAllocator.c
+ * @brief Tests the allocator hooks
+ *
+ * usage: `testAllocator`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/** Number of blocks allocated and released through the hooks. */
+typedef struct {
+    int64_t allocs;
+    int64_t frees;
+} Counters;
+
+static Counters counters = {0, 0};
+
+static void *countingMalloc(size_t size, void *context) {
+    ((Counters *)context)->allocs++;
+    return malloc(size);
+}
+
+static void *countingCalloc(size_t count, size_t size, void *context) {
+    ((Counters *)context)->allocs++;
+    return calloc(count, size);
+}
+
+static void *countingRealloc(void *ptr, size_t size, void *context) {
+    (void)context;
+    return realloc(ptr, size);
+}
+
+static void countingFree(void *ptr, void *context) {
+    ((Counters *)context)->frees++;
+    free(ptr);
+}
+
+static void setCountingAllocator(void) {
+    t_assertSuccess(h3SetAllocator(countingMalloc, countingCalloc,
+                                   countingRealloc, countingFree, &counters));
+}
+
+SUITE(allocator) {
+    TEST(hooksUsed) {
+        H3Index disk[61];
+        t_assertSuccess(gridDisk(0x89283470c27ffff, 4, disk));
+
+        setCountingAllocator();
+        LinkedGeoPolygon polygon;
+        t_assertSuccess(cellsToLinkedMultiPolygon(disk, 61, &polygon));
+        destroyLinkedMultiPolygon(&polygon);
+
+        H3Index compacted[61];
+        t_assertSuccess(compactCells(disk, compacted, 61));
+        t_assertSuccess(h3SetAllocator(NULL, NULL, NULL, NULL, NULL));
+
+        t_assert(counters.allocs > 0, "hooks used to allocate");
+        t_assert(counters.frees > 0, "hooks used to release");
+    }
+
+    TEST(hooksChanged) {
+        H3Index disk[7];
+        t_assertSuccess(gridDisk(0x89283470c27ffff, 1, disk));
+
+        setCountingAllocator();
+        LinkedGeoPolygon polygon;
+        t_assertSuccess(cellsToLinkedMultiPolygon(disk, 7, &polygon));
+        t_assertSuccess(h3SetAllocator(NULL, NULL, NULL, NULL, NULL));
+
+        // Blocks go back to the hooks they were allocated with.
+        int64_t frees = counters.frees;
+        destroyLinkedMultiPolygon(&polygon);
+        t_assert(counters.frees > frees, "released through the hooks");
+    }
+
+    TEST(partialHooks) {
+        t_assert(h3SetAllocator(countingMalloc, NULL, countingRealloc,
+                                countingFree, &counters) == E_OPTION_INVALID,
+                 "missing hook rejected");
+        t_assert(h3SetAllocator(NULL, NULL, NULL, countingFree, NULL) ==
+                     E_OPTION_INVALID,
+                 "lone hook rejected");
+    }
+}
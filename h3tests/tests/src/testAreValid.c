@@ -0,0 +1,104 @@
+/** @file testAreValid.c
+ * @brief Tests the batch validators (`areValidCells`,
+ * `areValidDirectedEdges` and `areValidVertexes`)
+ *
+ * usage: `testAreValid`
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "constants.h"
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define SAMPLES 200
+// Per sample: the index itself and a copy with each of its 64 bits flipped.
+#define VARIANTS 65
+
+/** Fills `out` with the samples and every one-bit variation of them. */
+static void mutate(const H3Index *samples, int numSamples, H3Index *out) {
+    for (int i = 0; i < numSamples; i++) {
+        out[i * VARIANTS] = samples[i];
+        for (int bit = 0; bit < 64; bit++) {
+            out[i * VARIANTS + bit + 1] = samples[i] ^ ((H3Index)1 << bit);
+        }
+    }
+}
+
+SUITE(areValid) {
+    // Random cells at every resolution, plus every pentagon.
+    H3Index cells[SAMPLES];
+    for (int i = 0; i < SAMPLES; i++) {
+        LatLng coord;
+        randomGeo(&coord);
+        t_assertSuccess(latLngToCell(&coord, i % (MAX_H3_RES + 1), &cells[i]));
+    }
+    for (int res = 0; res <= MAX_H3_RES; res++) {
+        t_assertSuccess(getPentagons(res, &cells[res * 12 % SAMPLES]));
+    }
+
+    TEST(cells) {
+        H3Index *indexes = calloc(SAMPLES * VARIANTS, sizeof(H3Index));
+        uint8_t *mask = calloc(SAMPLES * VARIANTS, sizeof(uint8_t));
+        mutate(cells, SAMPLES, indexes);
+
+        t_assertSuccess(areValidCells(indexes, SAMPLES * VARIANTS, mask));
+        for (int i = 0; i < SAMPLES * VARIANTS; i++) {
+            t_assert(mask[i] == isValidCell(indexes[i]),
+                     "same result as isValidCell");
+        }
+
+        free(mask);
+        free(indexes);
+    }
+
+    TEST(directedEdges) {
+        H3Index edges[SAMPLES];
+        for (int i = 0; i < SAMPLES; i++) {
+            H3Index cellEdges[6] = {0};
+            t_assertSuccess(originToDirectedEdges(cells[i], cellEdges));
+            edges[i] = cellEdges[i % 5];
+        }
+        H3Index *indexes = calloc(SAMPLES * VARIANTS, sizeof(H3Index));
+        uint8_t *mask = calloc(SAMPLES * VARIANTS, sizeof(uint8_t));
+        mutate(edges, SAMPLES, indexes);
+
+        t_assertSuccess(
+            areValidDirectedEdges(indexes, SAMPLES * VARIANTS, mask));
+        for (int i = 0; i < SAMPLES * VARIANTS; i++) {
+            t_assert(mask[i] == isValidDirectedEdge(indexes[i]),
+                     "same result as isValidDirectedEdge");
+        }
+
+        free(mask);
+        free(indexes);
+    }
+
+    TEST(vertexes) {
+        H3Index vertexes[SAMPLES];
+        for (int i = 0; i < SAMPLES; i++) {
+            t_assertSuccess(cellToVertex(cells[i], i % 5, &vertexes[i]));
+        }
+        H3Index *indexes = calloc(SAMPLES * VARIANTS, sizeof(H3Index));
+        uint8_t *mask = calloc(SAMPLES * VARIANTS, sizeof(uint8_t));
+        mutate(vertexes, SAMPLES, indexes);
+
+        t_assertSuccess(areValidVertexes(indexes, SAMPLES * VARIANTS, mask));
+        for (int i = 0; i < SAMPLES * VARIANTS; i++) {
+            t_assert(mask[i] == isValidVertex(indexes[i]),
+                     "same result as isValidVertex");
+        }
+
+        free(mask);
+        free(indexes);
+    }
+
+    TEST(invalidCount) {
+        uint8_t mask;
+        t_assert(areValidCells(cells, -1, &mask) == E_DOMAIN,
+                 "negative count rejected");
+        t_assertSuccess(areValidCells(NULL, 0, NULL));
+    }
+}
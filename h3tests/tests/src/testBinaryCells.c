@@ -0,0 +1,112 @@
+/** @file testBinaryCells.c
+ * @brief Tests the binary serialization of cell sets
+ *
+ * usage: `testBinaryCells`
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/** Returns the compacted disk of radius k around the origin (packed). */
+static H3Index *compactedDisk(H3Index origin, int k, int64_t *numCells) {
+    int64_t size;
+    t_assertSuccess(maxGridDiskSize(k, &size));
+    H3Index *cells = calloc(size, sizeof(H3Index));
+    t_assertSuccess(gridDisk(origin, k, cells));
+    int64_t count = 0;
+    for (int64_t i = 0; i < size; i++) {
+        if (cells[i] != H3_NULL) {
+            cells[count++] = cells[i];
+        }
+    }
+    H3Index *compacted = calloc(count, sizeof(H3Index));
+    t_assertSuccess(compactCells(cells, compacted, count));
+    free(cells);
+
+    // Keep the trailing H3_NULL: they must be skipped by the serialization.
+    *numCells = count;
+    return compacted;
+}
+
+SUITE(binaryCells) {
+    TEST(roundTrip) {
+        int64_t numCells;
+        H3Index *cells = compactedDisk(0x890dab6220bffff, 30, &numCells);
+        int64_t numCompacted = countNonNullIndexes(cells, numCells);
+
+        size_t written;
+        t_assert(cellsToBinary(cells, numCells, NULL, 0, &written) ==
+                     E_MEMORY_BOUNDS,
+                 "size query");
+        uint8_t *data = malloc(written);
+        t_assertSuccess(cellsToBinary(cells, numCells, data, written, &written));
+        t_assert(written < numCompacted * sizeof(H3Index) / 2,
+                 "smaller than the raw indexes");
+
+        int64_t size;
+        t_assertSuccess(binaryToCellsSize(data, written, &size));
+        t_assert(size == numCompacted, "null indexes skipped");
+
+        H3Index *decoded = calloc(size, sizeof(H3Index));
+        t_assert(binaryToCells(data, written, decoded, size - 1) ==
+                     E_MEMORY_BOUNDS,
+                 "output too small");
+        t_assertSuccess(binaryToCells(data, written, decoded, size));
+
+        qsort(cells, numCells, sizeof(H3Index), compareCells);
+        qsort(decoded, size, sizeof(H3Index), compareCells);
+        t_assert(memcmp(cells + (numCells - numCompacted), decoded,
+                        size * sizeof(H3Index)) == 0,
+                 "same cells");
+
+        free(decoded);
+        free(data);
+        free(cells);
+    }
+
+    TEST(empty) {
+        uint8_t data[16];
+        size_t written;
+        t_assertSuccess(cellsToBinary(NULL, 0, data, sizeof(data), &written));
+        int64_t size;
+        t_assertSuccess(binaryToCellsSize(data, written, &size));
+        t_assert(size == 0, "no cell");
+        t_assertSuccess(binaryToCells(data, written, NULL, 0));
+    }
+
+    TEST(invalidCells) {
+        H3Index cells[] = {0x85283473fffffff, 0x1234567890abcdef};
+        uint8_t data[64];
+        size_t written;
+        t_assert(cellsToBinary(cells, 2, data, sizeof(data), &written) ==
+                     E_CELL_INVALID,
+                 "invalid cell rejected");
+        t_assert(cellsToBinary(cells, -1, data, sizeof(data), &written) ==
+                     E_DOMAIN,
+                 "negative count rejected");
+    }
+
+    TEST(corrupted) {
+        H3Index cells[] = {0x85283473fffffff, 0x8f2830828052d25};
+        uint8_t data[64];
+        size_t written;
+        H3Index out[2];
+        int64_t size;
+        t_assertSuccess(cellsToBinary(cells, 2, data, sizeof(data), &written));
+
+        t_assert(binaryToCells(data, written - 1, out, 2) == E_FAILED,
+                 "truncated payload");
+        t_assert(binaryToCellsSize(data, 3, &size) == E_FAILED,
+                 "truncated header");
+        t_assert(binaryToCells(data, written, out, 2) == E_SUCCESS,
+                 "valid payload");
+        data[0] ^= 0xff;
+        t_assert(binaryToCellsSize(data, written, &size) == E_FAILED,
+                 "bad magic number");
+    }
+}
@@ -0,0 +1,102 @@
+/** @file testCancellation.c
+ * @brief Tests the cancellable versions of the long-running functions
+ *
+ * usage: `testCancellation`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "linkedGeo.h"
+#include "test.h"
+#include "utility.h"
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static GeoLoop sfGeoLoop = {.numVerts = 6, .verts = sfVerts};
+
+/** Spends some time, well over a microsecond. */
+static void spin(void) {
+    const LatLng point = {0.659966917655, -2.1364398519396};
+    for (int i = 0; i < 10000; i++) {
+        H3Index cell;
+        t_assertSuccess(latLngToCell(&point, 15, &cell));
+    }
+}
+
+SUITE(cancellation) {
+    GeoPolygon sfGeoPolygon = {.geoloop = sfGeoLoop, .numHoles = 0};
+
+    TEST(polygonToCells) {
+        int64_t size;
+        t_assertSuccess(maxPolygonToCellsSize(&sfGeoPolygon, 9, 0, &size));
+        H3Index *expected = calloc(size, sizeof(H3Index));
+        H3Index *actual = calloc(size, sizeof(H3Index));
+        t_assertSuccess(polygonToCells(&sfGeoPolygon, 9, 0, expected));
+
+        H3CancelToken *token;
+        t_assertSuccess(createCancelToken(0, &token));
+        int64_t count;
+        t_assertSuccess(
+            polygonToCellsCancellable(&sfGeoPolygon, 9, 0, token, actual,
+                                      &count));
+        t_assert(count > 0 && count <= size, "cells written");
+        t_assert(memcmp(expected, actual, size * sizeof(H3Index)) == 0,
+                 "same cells as polygonToCells");
+        t_assertSuccess(polygonToCellsCancellable(&sfGeoPolygon, 9, 0, NULL,
+                                                  actual, &count));
+
+        triggerCancelToken(token);
+        t_assert(polygonToCellsCancellable(&sfGeoPolygon, 9, 0, token, actual,
+                                           &count) == E_CANCELLED,
+                 "cancelled");
+        t_assert(count == 0, "cancelled before the first cell");
+        destroyCancelToken(token);
+
+        t_assertSuccess(createCancelToken(1, &token));
+        spin();
+        t_assert(polygonToCellsCancellable(&sfGeoPolygon, 9, 0, token, actual,
+                                           &count) == E_CANCELLED,
+                 "out of time");
+        destroyCancelToken(token);
+
+        free(actual);
+        free(expected);
+    }
+
+    TEST(cellsToLinkedMultiPolygon) {
+        H3Index cells[19];
+        t_assertSuccess(gridDisk(0x8928308280fffff, 2, cells));
+        LinkedGeoPolygon polygon;
+        t_assertSuccess(
+            cellsToLinkedMultiPolygonCancellable(cells, 19, NULL, &polygon));
+        t_assert(countLinkedPolygons(&polygon) == 1, "one polygon");
+        t_assert(countLinkedLoops(&polygon) == 1, "no hole");
+        destroyLinkedMultiPolygon(&polygon);
+
+        H3CancelToken *token;
+        t_assertSuccess(createCancelToken(0, &token));
+        triggerCancelToken(token);
+        t_assert(cellsToLinkedMultiPolygonCancellable(cells, 19, token,
+                                                      &polygon) == E_CANCELLED,
+                 "cancelled");
+        destroyCancelToken(token);
+    }
+
+    TEST(createCancelToken) {
+        H3CancelToken *token;
+        t_assert(createCancelToken(-1, &token) == E_DOMAIN, "negative budget");
+        t_assertSuccess(createCancelToken(INT64_MAX, &token));
+        int64_t count;
+        H3Index cells[1];
+        GeoPolygon empty = {.geoloop = {.numVerts = 0}};
+        t_assertSuccess(
+            polygonToCellsCancellable(&empty, 9, 0, token, cells, &count));
+        t_assert(count == 0, "nothing written");
+        destroyCancelToken(token);
+        destroyCancelToken(NULL);
+    }
+}
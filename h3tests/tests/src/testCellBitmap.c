@@ -0,0 +1,131 @@
+/** @file testCellBitmap.c
+ * @brief Tests the dense cell sets at a single resolution
+ *
+ * usage: `testCellBitmap`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/** Checks that a set holds exactly `expected` (sorted, without duplicates). */
+static void assertSetCells(const H3CellBitmap *set, const H3Index *expected,
+                           int64_t count) {
+    int64_t size;
+    t_assertSuccess(cellBitmapSize(set, &size));
+    t_assert(size == count, "expected size");
+    H3Index *cells = calloc(count + 1, sizeof(H3Index));
+    t_assertSuccess(cellBitmapToCells(set, cells, count));
+    for (int64_t i = 0; i < count; i++) {
+        t_assert(cells[i] == expected[i], "expected cell");
+        int contained;
+        t_assertSuccess(cellBitmapContains(set, cells[i], &contained));
+        t_assert(contained, "cell contained");
+    }
+    free(cells);
+}
+
+SUITE(cellBitmap) {
+    TEST(denseAndSparse) {
+        // A filled res 2 cell (bitmap), and a disk around one of its
+        // children (array).
+        const H3Index parent = 0x822837fffffffff;
+        int64_t count;
+        t_assertSuccess(cellToChildrenSize(parent, 7, &count));
+        H3Index *children = calloc(count, sizeof(H3Index));
+        t_assertSuccess(cellToChildren(parent, 7, children));
+        H3Index *disk = calloc(19, sizeof(H3Index));
+        t_assertSuccess(gridDisk(children[count / 2], 2, disk));
+        qsort(disk, 19, sizeof(H3Index), compareCells);
+
+        H3CellBitmap *dense;
+        H3CellBitmap *sparse;
+        t_assertSuccess(createCellBitmap(children, count, 7, &dense));
+        t_assertSuccess(createCellBitmap(disk, 19, 7, &sparse));
+        assertSetCells(dense, children, count);
+        assertSetCells(sparse, disk, 19);
+
+        int contained;
+        t_assertSuccess(cellBitmapContains(dense, parent, &contained));
+        t_assert(!contained, "other resolutions aren't members");
+        H3Index outside;
+        t_assertSuccess(cellToCenterChild(0x8209a7fffffffff, 7, &outside));
+        t_assertSuccess(cellBitmapContains(dense, outside, &contained));
+        t_assert(!contained, "cell outside of the set");
+        t_assert(cellBitmapContains(dense, 0, &contained) == E_CELL_INVALID,
+                 "invalid cell");
+
+        H3CellBitmap *both;
+        t_assertSuccess(cellBitmapIntersection(dense, sparse, &both));
+        assertSetCells(both, disk, 19);
+        destroyCellBitmap(both);
+        t_assertSuccess(cellBitmapUnion(dense, sparse, &both));
+        assertSetCells(both, children, count);
+        destroyCellBitmap(both);
+
+        H3Index *cells = calloc(count, sizeof(H3Index));
+        t_assert(cellBitmapToCells(dense, cells, count - 1) == E_MEMORY_BOUNDS,
+                 "output too small");
+        free(cells);
+
+        destroyCellBitmap(sparse);
+        destroyCellBitmap(dense);
+        free(disk);
+        free(children);
+    }
+
+    TEST(pentagon) {
+        // Children of a pentagon, split in two halves, with duplicates.
+        int64_t count;
+        t_assertSuccess(cellToChildrenSize(0x8009fffffffffff, 6, &count));
+        H3Index *children = calloc(count, sizeof(H3Index));
+        t_assertSuccess(cellToChildren(0x8009fffffffffff, 6, children));
+        const int64_t half = count / 2;
+        H3CellBitmap *low;
+        H3CellBitmap *high;
+        t_assertSuccess(createCellBitmap(children, half + 1, 6, &low));
+        t_assertSuccess(
+            createCellBitmap(children + half, count - half, 6, &high));
+
+        H3CellBitmap *both;
+        t_assertSuccess(cellBitmapIntersection(low, high, &both));
+        assertSetCells(both, children + half, 1);
+        destroyCellBitmap(both);
+        t_assertSuccess(cellBitmapUnion(low, high, &both));
+        assertSetCells(both, children, count);
+        destroyCellBitmap(both);
+
+        destroyCellBitmap(high);
+        destroyCellBitmap(low);
+        free(children);
+    }
+
+    TEST(errors) {
+        const H3Index cells[] = {0x872830828ffffff, H3_NULL, 0x862830827ffffff};
+        H3CellBitmap *set;
+        t_assert(createCellBitmap(cells, 3, 7, &set) == E_RES_MISMATCH,
+                 "mixed resolutions");
+        t_assert(createCellBitmap(cells, 3, 16, &set) == E_RES_DOMAIN,
+                 "invalid resolution");
+        const H3Index invalid[] = {0x872830828ffffff, 1};
+        t_assert(createCellBitmap(invalid, 2, 7, &set) == E_CELL_INVALID,
+                 "invalid cell");
+
+        H3CellBitmap *other;
+        t_assertSuccess(createCellBitmap(cells, 2, 7, &set));
+        t_assertSuccess(createCellBitmap(cells + 2, 1, 6, &other));
+        int64_t size;
+        t_assertSuccess(cellBitmapSize(set, &size));
+        t_assert(size == 1, "null entries are ignored");
+        H3CellBitmap *both;
+        t_assert(cellBitmapUnion(set, other, &both) == E_RES_MISMATCH,
+                 "union of different resolutions");
+        t_assert(cellBitmapIntersection(set, other, &both) == E_RES_MISMATCH,
+                 "intersection of different resolutions");
+        destroyCellBitmap(other);
+        destroyCellBitmap(set);
+        destroyCellBitmap(NULL);
+    }
+}
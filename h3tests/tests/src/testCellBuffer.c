@@ -0,0 +1,68 @@
+/** @file testCellBuffer.c
+ * @brief Tests the cell buffers of `createCellBuffer`, and the huge pages
+ * of the library-owned buffers
+ *
+ * usage: `testCellBuffer`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+SUITE(cellBuffer) {
+    H3Index parent = 0x85283473fffffff;
+
+    TEST(small) {
+        H3CellBuffer *buffer;
+        t_assertSuccess(createCellBuffer(7, &buffer));
+        H3Index *cells = cellBufferCells(buffer);
+        for (int i = 0; i < 7; i++) {
+            t_assert(cells[i] == H3_NULL, "zeroed");
+        }
+        t_assertSuccess(cellToChildren(0x8928308280fffff, 10, cells));
+        t_assert(cells[6] != H3_NULL, "writable");
+        destroyCellBuffer(buffer);
+    }
+
+    TEST(large) {
+        // 8 MiB, backed by an anonymous mapping.
+        int64_t size = 1 << 20;
+        H3CellBuffer *buffer;
+        t_assertSuccess(createCellBuffer(size, &buffer));
+        H3Index *cells = cellBufferCells(buffer);
+        t_assert(cells[0] == H3_NULL && cells[size - 1] == H3_NULL,
+                 "zeroed");
+
+        int64_t numChildren;
+        t_assertSuccess(cellToChildrenSize(parent, 12, &numChildren));
+        t_assert(numChildren <= size, "buffer large enough");
+        t_assertSuccess(uncompactCellsParallel(&parent, 1, cells, size, 12));
+        for (int64_t i = 0; i < numChildren; i++) {
+            H3Index cellParent;
+            t_assertSuccess(cellToParent(cells[i], 5, &cellParent));
+            t_assert(cellParent == parent, "children written");
+        }
+        t_assert(cells[numChildren] == H3_NULL, "rest untouched");
+        destroyCellBuffer(buffer);
+    }
+
+    TEST(hugePagesCellSet) {
+        h3SetHugePages(1);
+        H3Index children[7];
+        t_assertSuccess(cellToChildren(0x8928308280fffff, 10, children));
+        H3CellSet *set;
+        t_assertSuccess(createCellSet(children, 7, &set));
+        t_assert(cellSetContains(set, children[3]), "contained");
+        t_assert(!cellSetContains(set, 0x8928308280fffff), "not contained");
+        destroyCellSet(set);
+        h3SetHugePages(0);
+    }
+
+    TEST(invalid) {
+        H3CellBuffer *buffer;
+        t_assert(createCellBuffer(-1, &buffer) == E_DOMAIN, "negative size");
+        destroyCellBuffer(NULL);
+    }
+}
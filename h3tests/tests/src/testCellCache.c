@@ -0,0 +1,101 @@
+/** @file testCellCache.c
+ * @brief Tests the per-thread boundary and center caches
+ * (`h3SetCacheCapacity`)
+ *
+ * usage: `testCellCache`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static const H3Index cells[] = {0x89283470c27ffff, 0x8928308280fffff,
+                                0x830800fffffffff};
+
+SUITE(cellCache) {
+    TEST(sameResults) {
+        CellBoundary expected[ARRAY_SIZE(cells)];
+        LatLng expectedCenters[ARRAY_SIZE(cells)];
+        for (size_t i = 0; i < ARRAY_SIZE(cells); i++) {
+            t_assertSuccess(cellToBoundary(cells[i], &expected[i]));
+            t_assertSuccess(cellToLatLng(cells[i], &expectedCenters[i]));
+        }
+
+        t_assertSuccess(h3SetCacheCapacity(2));
+        for (int pass = 0; pass < 3; pass++) {
+            for (size_t i = 0; i < ARRAY_SIZE(cells); i++) {
+                CellBoundary boundary;
+                LatLng center;
+                t_assertSuccess(cellToBoundary(cells[i], &boundary));
+                t_assertSuccess(cellToLatLng(cells[i], &center));
+                t_assert(boundary.numVerts == expected[i].numVerts &&
+                             memcmp(boundary.verts, expected[i].verts,
+                                    boundary.numVerts * sizeof(LatLng)) == 0,
+                         "same boundary");
+                t_assert(center.lat == expectedCenters[i].lat &&
+                             center.lng == expectedCenters[i].lng,
+                         "same center");
+            }
+        }
+        t_assertSuccess(h3SetCacheCapacity(0));
+    }
+
+    TEST(counters) {
+        t_assertSuccess(h3SetCacheCapacity(16));
+        h3ResetCacheStats();
+
+        CellBoundary boundary;
+        for (int i = 0; i < 3; i++) {
+            t_assertSuccess(cellToBoundary(cells[0], &boundary));
+        }
+        int64_t hits, misses;
+        t_assertSuccess(h3GetCacheStats(&hits, &misses));
+        t_assert(hits == 2 && misses == 1, "one miss, then hits");
+
+        t_assert(cellToBoundary(0x1, &boundary) == E_CELL_INVALID,
+                 "invalid cell still rejected");
+        t_assert(cellToBoundary(0x1, &boundary) == E_CELL_INVALID,
+                 "errors aren't cached");
+        t_assertSuccess(h3GetCacheStats(&hits, &misses));
+        t_assert(hits == 2 && misses == 3, "invalid cells are misses");
+
+        // Disabled caches count nothing.
+        t_assertSuccess(h3SetCacheCapacity(0));
+        h3ResetCacheStats();
+        t_assertSuccess(cellToBoundary(cells[0], &boundary));
+        t_assertSuccess(h3GetCacheStats(&hits, &misses));
+        t_assert(hits == 0 && misses == 0, "disabled cache");
+    }
+
+    TEST(emptiedWhenSet) {
+        CellBoundary boundary;
+        int64_t hits, misses;
+        t_assertSuccess(h3SetCacheCapacity(16));
+        t_assertSuccess(cellToBoundary(cells[0], &boundary));
+
+        // Disabled then enabled again with the same capacity.
+        t_assertSuccess(h3SetCacheCapacity(0));
+        t_assertSuccess(cellToBoundary(cells[0], &boundary));
+        t_assertSuccess(h3SetCacheCapacity(16));
+        h3ResetCacheStats();
+        t_assertSuccess(cellToBoundary(cells[0], &boundary));
+        t_assertSuccess(h3GetCacheStats(&hits, &misses));
+        t_assert(hits == 0 && misses == 1, "entries dropped when disabled");
+
+        // Set again to the same capacity, without lookup in between.
+        t_assertSuccess(h3SetCacheCapacity(16));
+        h3ResetCacheStats();
+        t_assertSuccess(cellToBoundary(cells[0], &boundary));
+        t_assertSuccess(h3GetCacheStats(&hits, &misses));
+        t_assert(hits == 0 && misses == 1, "entries dropped when set");
+        t_assertSuccess(h3SetCacheCapacity(0));
+    }
+
+    TEST(invalidCapacity) {
+        t_assert(h3SetCacheCapacity(-1) == E_DOMAIN,
+                 "negative capacity rejected");
+    }
+}
@@ -0,0 +1,106 @@
+/** @file testCellPairs.c
+ * @brief Tests the pair batches `areNeighborCellPairs` and
+ * `cellPairsToDirectedEdges`
+ *
+ * usage: `testCellPairs`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define NUM_CELLS 19
+
+SUITE(cellPairs) {
+    // A disk around a pentagon: a trajectory through it has neighbors,
+    // non-neighbors and repeated cells.
+    H3Index cells[NUM_CELLS];
+    t_assertSuccess(gridDisk(0x821c07fffffffff, 2, cells));
+    int64_t numCells = 0;
+    for (int i = 0; i < NUM_CELLS; i++) {
+        if (cells[i] != H3_NULL) {
+            cells[numCells++] = cells[i];
+        }
+    }
+    cells[numCells - 1] = cells[numCells - 2];
+    const int64_t numPairs = numCells - 1;
+
+    TEST(matchesSingleCalls) {
+        uint8_t neighbors[NUM_CELLS];
+        H3Index edges[NUM_CELLS];
+        t_assertSuccess(
+            areNeighborCellPairs(cells, cells + 1, numPairs, neighbors, NULL));
+        t_assertSuccess(
+            cellPairsToDirectedEdges(cells, cells + 1, numPairs, edges, NULL));
+        int numNeighbors = 0;
+        for (int64_t i = 0; i < numPairs; i++) {
+            int expected;
+            t_assertSuccess(
+                areNeighborCells(cells[i], cells[i + 1], &expected));
+            t_assert(neighbors[i] == expected, "same neighbor flag");
+            H3Index edge = H3_NULL;
+            if (expected) {
+                t_assertSuccess(
+                    cellsToDirectedEdge(cells[i], cells[i + 1], &edge));
+            }
+            t_assert(edges[i] == edge, "same edge");
+            numNeighbors += expected;
+        }
+        t_assert(numNeighbors > 0, "some neighbors");
+        t_assert(numNeighbors < numPairs, "some non-neighbors");
+        t_assert(edges[numPairs - 1] == H3_NULL, "no edge to itself");
+    }
+
+    TEST(invalidCells) {
+        H3Index origins[] = {cells[0], 0, cells[1]};
+        H3Index destinations[] = {cells[1], cells[0], 0x7fffffffffffffff};
+        uint8_t neighbors[3];
+        H3Index edges[3];
+        H3Error errs[3];
+        t_assert(areNeighborCellPairs(origins, destinations, 3, neighbors,
+                                      NULL) == E_CELL_INVALID,
+                 "invalid cells reported");
+        t_assert(cellPairsToDirectedEdges(origins, destinations, 3, edges,
+                                          errs) == E_CELL_INVALID,
+                 "invalid cells reported");
+        t_assert(errs[0] == E_SUCCESS && errs[1] == E_CELL_INVALID &&
+                     errs[2] == E_CELL_INVALID,
+                 "errors reported per pair");
+        t_assert(neighbors[0] == 1 && neighbors[1] == 0 && neighbors[2] == 0,
+                 "batch carried on");
+        H3Index edge;
+        t_assertSuccess(cellsToDirectedEdge(cells[0], cells[1], &edge));
+        t_assert(edges[0] == edge && edges[1] == H3_NULL &&
+                     edges[2] == H3_NULL,
+                 "batch carried on");
+
+        t_assertSuccess(areNeighborCellPairs(NULL, NULL, 0, NULL, NULL));
+        t_assert(cellPairsToDirectedEdges(origins, destinations, -1, edges,
+                                          NULL) == E_DOMAIN,
+                 "negative size");
+    }
+
+    TEST(resolutionMismatch) {
+        // A trajectory going through a coarser cell.
+        H3Index trajectory[4] = {cells[0], cells[1], H3_NULL, cells[2]};
+        t_assertSuccess(cellToParent(cells[1], 1, &trajectory[2]));
+        uint8_t neighbors[3];
+        H3Index edges[3];
+        H3Error errs[3];
+        t_assert(areNeighborCellPairs(trajectory, trajectory + 1, 3, neighbors,
+                                      errs) == E_RES_MISMATCH,
+                 "mismatch returned");
+        t_assert(errs[0] == E_SUCCESS && errs[1] == E_RES_MISMATCH &&
+                     errs[2] == E_RES_MISMATCH,
+                 "mismatch reported per pair");
+        t_assert(neighbors[1] == 0 && neighbors[2] == 0,
+                 "mismatched pairs aren't neighbors");
+        t_assert(cellPairsToDirectedEdges(trajectory, trajectory + 1, 3, edges,
+                                          NULL) == E_RES_MISMATCH,
+                 "mismatch returned without errs");
+        t_assert(edges[1] == H3_NULL && edges[2] == H3_NULL,
+                 "mismatched pairs have no edge");
+    }
+}
@@ -0,0 +1,90 @@
+/** @file testCellSet.c
+ * @brief Tests the `H3CellSet` containment queries
+ *
+ * usage: `testCellSet`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+SUITE(cellSet) {
+    H3Index parent = 0x85283473fffffff;
+    H3Index outside = 0x8528347bfffffff;
+
+    TEST(ancestorContainsDescendants) {
+        H3Index cells[] = {parent, H3_NULL};
+        H3CellSet *set;
+        t_assertSuccess(createCellSet(cells, ARRAY_SIZE(cells), &set));
+
+        int contained;
+        t_assertSuccess(cellSetContains(set, parent, &contained));
+        t_assert(contained == 1, "cell itself is contained");
+
+        H3Index children[343];
+        t_assertSuccess(cellToChildren(parent, 8, children));
+        for (int i = 0; i < 343; i++) {
+            t_assertSuccess(cellSetContains(set, children[i], &contained));
+            t_assert(contained == 1, "descendant is contained");
+        }
+
+        H3Index coarser;
+        t_assertSuccess(cellToParent(parent, 4, &coarser));
+        t_assertSuccess(cellSetContains(set, coarser, &contained));
+        t_assert(contained == 0, "ancestor isn't contained");
+
+        t_assertSuccess(cellSetContains(set, outside, &contained));
+        t_assert(contained == 0, "sibling isn't contained");
+
+        t_assert(cellSetContains(set, 0, &contained) == E_CELL_INVALID,
+                 "invalid cell rejected");
+        destroyCellSet(set);
+    }
+
+    TEST(compactedAndUncompacted) {
+        H3Index children[49];
+        t_assertSuccess(cellToChildren(outside, 7, children));
+        // Nested cells are absorbed by their ancestor.
+        H3Index cells[51];
+        for (int i = 0; i < 49; i++) {
+            cells[i] = children[i];
+        }
+        cells[49] = parent;
+        cells[50] = 0x872834700ffffff;
+        H3CellSet *set;
+        t_assertSuccess(createCellSet(cells, ARRAY_SIZE(cells), &set));
+
+        H3Index queries[] = {children[0], children[48], outside, parent,
+                             0x8a2834700007fff, 0x89283400003ffff,
+                             0x89283478a73ffff};
+        uint8_t expected[] = {1, 1, 0, 1, 1, 0, 1};
+        uint8_t found[ARRAY_SIZE(queries)];
+        t_assertSuccess(
+            cellSetContainsCells(set, queries, ARRAY_SIZE(queries), found));
+        for (size_t i = 0; i < ARRAY_SIZE(queries); i++) {
+            int contained;
+            t_assertSuccess(cellSetContains(set, queries[i], &contained));
+            t_assert(found[i] == expected[i], "expected containment");
+            t_assert(found[i] == contained, "same as scalar lookup");
+        }
+        destroyCellSet(set);
+    }
+
+    TEST(invalidInputs) {
+        H3Index cells[] = {parent, 0x1};
+        H3CellSet *set;
+        t_assert(createCellSet(cells, ARRAY_SIZE(cells), &set) ==
+                     E_CELL_INVALID,
+                 "invalid cell rejected");
+
+        t_assertSuccess(createCellSet(cells, 0, &set));
+        uint8_t found[2];
+        t_assert(cellSetContainsCells(set, cells, 2, found) == E_CELL_INVALID,
+                 "invalid query reported");
+        t_assert(found[0] == 0 && found[1] == 0, "empty set contains nothing");
+        destroyCellSet(set);
+        destroyCellSet(NULL);
+    }
+}
@@ -0,0 +1,138 @@
+/** @file testCellStream.c
+ * @brief Tests the streaming of cells through `H3CellWriter` and
+ * `H3CellReader`
+ *
+ * usage: `testCellStream`
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static const char *path = "testCellStream.bin";
+
+/** Reads the whole stream, by small chunks. */
+static int64_t readAll(H3CellReader *reader, H3Index *out) {
+    int64_t count = 0;
+    int64_t written;
+    do {
+        t_assertSuccess(cellReaderNext(reader, out + count, 7, &written));
+        count += written;
+    } while (written != 0);
+    return count;
+}
+
+SUITE(cellStream) {
+    TEST(roundTrip) {
+        // Children of two cells on different base cells, written by chunks.
+        H3Index parents[] = {0x85283473fffffff, 0x850dab63fffffff};
+        H3Index children[2 * 2401];
+        for (int i = 0; i < 2; i++) {
+            t_assertSuccess(cellToChildren(parents[i], 9, children + i * 2401));
+        }
+        const int64_t numCells = ARRAY_SIZE(children);
+
+        H3CellWriter *writer;
+        t_assertSuccess(createCellWriter(path, 1000, &writer));
+        for (int64_t i = 0; i < numCells; i += 333) {
+            const int64_t count = numCells - i < 333 ? numCells - i : 333;
+            t_assertSuccess(cellWriterWrite(writer, children + i, count));
+        }
+        t_assertSuccess(closeCellWriter(writer));
+
+        H3CellReader *reader;
+        t_assertSuccess(openCellReader(path, &reader));
+        H3Index *cells = calloc(numCells, sizeof(H3Index));
+        t_assert(readAll(reader, cells) == numCells, "every cell read");
+
+        qsort(children, numCells, sizeof(H3Index), compareCells);
+        qsort(cells, numCells, sizeof(H3Index), compareCells);
+        t_assert(memcmp(children, cells, sizeof(children)) == 0,
+                 "same cells");
+
+        // Restricted to the base cell of the second parent.
+        t_assertSuccess(
+            cellReaderRewind(reader, getBaseCellNumber(parents[1])));
+        t_assert(readAll(reader, cells) == 2401, "one base cell read");
+        for (int i = 0; i < 2401; i++) {
+            t_assert(getBaseCellNumber(cells[i]) ==
+                         getBaseCellNumber(parents[1]),
+                     "only that base cell");
+        }
+        t_assert(cellReaderRewind(reader, 122) == E_DOMAIN,
+                 "invalid base cell");
+
+        t_assertSuccess(cellReaderRewind(reader, -1));
+        t_assert(readAll(reader, cells) == numCells, "every cell read again");
+
+        free(cells);
+        destroyCellReader(reader);
+        remove(path);
+    }
+
+    TEST(nullAndInvalidCells) {
+        H3CellWriter *writer;
+        t_assertSuccess(createCellWriter(path, 0, &writer));
+        H3Index cells[] = {0x85283473fffffff, H3_NULL, 0x1234567890abcdef};
+        t_assertSuccess(cellWriterWrite(writer, cells, 2));
+        t_assert(cellWriterWrite(writer, cells, 3) == E_CELL_INVALID,
+                 "invalid cell rejected");
+        H3CellWriter *other;
+        t_assert(createCellWriter(path, -1, &other) == E_DOMAIN,
+                 "negative block size rejected");
+        t_assert(createCellWriter(path, INT64_MAX, &other) == E_DOMAIN,
+                 "huge block size rejected");
+        t_assertSuccess(closeCellWriter(writer));
+
+        H3CellReader *reader;
+        t_assertSuccess(openCellReader(path, &reader));
+        H3Index out[4];
+        t_assert(readAll(reader, out) == 1, "null skipped");
+        t_assert(out[0] == cells[0], "cell read");
+        destroyCellReader(reader);
+        remove(path);
+    }
+
+    TEST(invalidFiles) {
+        H3CellReader *reader;
+        t_assert(openCellReader("missing.bin", &reader) == E_FAILED,
+                 "missing file");
+
+        FILE *file = fopen(path, "wb");
+        fputs("not a stream", file);
+        fclose(file);
+        t_assert(openCellReader(path, &reader) == E_FAILED,
+                 "not a stream file");
+        remove(path);
+    }
+
+    TEST(corruptedBlocks) {
+        H3CellReader *reader;
+        H3Index out[4];
+        int64_t written;
+
+        // A block header announcing 4 GiB, followed by a few bytes.
+        FILE *file = fopen(path, "wb");
+        fwrite("H3S\x01\xff\xff\xff\xff\x00\x79" "abc", 1, 13, file);
+        fclose(file);
+        t_assertSuccess(openCellReader(path, &reader));
+        t_assert(cellReaderNext(reader, out, 4, &written) == E_FAILED,
+                 "oversized block rejected");
+        destroyCellReader(reader);
+
+        // A plausible size, but the file ends before the payload.
+        file = fopen(path, "wb");
+        fwrite("H3S\x01\x00\x01\x00\x00\x00\x79" "abc", 1, 13, file);
+        fclose(file);
+        t_assertSuccess(openCellReader(path, &reader));
+        t_assert(cellReaderNext(reader, out, 4, &written) == E_FAILED,
+                 "truncated block rejected");
+        destroyCellReader(reader);
+        remove(path);
+    }
+}
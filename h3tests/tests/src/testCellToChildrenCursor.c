@@ -0,0 +1,74 @@
+/** @file testCellToChildrenCursor.c
+ * @brief Tests the chunked `cellToChildrenInit`/`cellToChildrenNext` API
+ *
+ * usage: `testCellToChildrenCursor`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define CHUNK_SIZE 7
+
+static void assertMatchesCellToChildren(H3Index cell, int childRes) {
+    int64_t size;
+    t_assertSuccess(cellToChildrenSize(cell, childRes, &size));
+    H3Index *expected = calloc(size, sizeof(H3Index));
+    t_assertSuccess(cellToChildren(cell, childRes, expected));
+
+    H3ChildrenCursor *cursor;
+    t_assertSuccess(cellToChildrenInit(cell, childRes, &cursor));
+    H3Index chunk[CHUNK_SIZE];
+    int64_t written;
+    int64_t total = 0;
+    do {
+        t_assertSuccess(cellToChildrenNext(cursor, chunk, CHUNK_SIZE, &written));
+        t_assert(written <= CHUNK_SIZE, "chunk size is respected");
+        for (int64_t i = 0; i < written; i++) {
+            t_assert(expected[total + i] == chunk[i],
+                     "same children, in the same order");
+        }
+        total += written;
+    } while (written != 0);
+    t_assert(total == size, "same number of children");
+
+    destroyChildrenCursor(cursor);
+    free(expected);
+}
+
+SUITE(cellToChildrenCursor) {
+    H3Index hexagon = 0x88283080ddfffff;
+    H3Index pentagon = 0x830800fffffffff;
+
+    TEST(matchesCellToChildren) {
+        for (int res = 8; res <= 11; res++) {
+            assertMatchesCellToChildren(hexagon, res);
+        }
+    }
+
+    TEST(pentagon) {
+        for (int res = 3; res <= 6; res++) {
+            assertMatchesCellToChildren(pentagon, res);
+        }
+    }
+
+    TEST(zeroCapacity) {
+        H3ChildrenCursor *cursor;
+        t_assertSuccess(cellToChildrenInit(hexagon, 9, &cursor));
+        int64_t written = -1;
+        t_assertSuccess(cellToChildrenNext(cursor, NULL, 0, &written));
+        t_assert(written == 0, "nothing written without capacity");
+        destroyChildrenCursor(cursor);
+    }
+
+    TEST(invalidInputs) {
+        H3ChildrenCursor *cursor;
+        t_assert(cellToChildrenInit(hexagon, 16, &cursor) == E_RES_DOMAIN,
+                 "invalid resolution rejected");
+        t_assert(cellToChildrenInit(0, 9, &cursor) == E_CELL_INVALID,
+                 "invalid cell rejected");
+        destroyChildrenCursor(NULL);
+    }
+}
@@ -0,0 +1,64 @@
+/** @file testCellsArea.c
+ * @brief Tests the batch `cellsAreaKm2`, `cellsAreaM2` and `cellsAreaRads2`
+ *
+ * usage: `testCellsArea`
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+// More than one chunk of cells.
+#define NUM_CELLS 600
+#define EPSILON 1e-9
+
+static int closeEnough(double actual, double expected) {
+    return fabs(actual - expected) <= EPSILON * fabs(expected);
+}
+
+SUITE(cellsArea) {
+    H3Index *cells = calloc(NUM_CELLS, sizeof(H3Index));
+    for (int i = 0; i < NUM_CELLS; i++) {
+        LatLng coord;
+        randomGeo(&coord);
+        t_assertSuccess(latLngToCell(&coord, i % 16, &cells[i]));
+    }
+    // Some pentagons.
+    t_assertSuccess(getPentagons(5, cells));
+
+    TEST(matchesCellArea) {
+        double *km2 = calloc(NUM_CELLS, sizeof(double));
+        double *m2 = calloc(NUM_CELLS, sizeof(double));
+        double *rads2 = calloc(NUM_CELLS, sizeof(double));
+        t_assertSuccess(cellsAreaKm2(cells, NUM_CELLS, km2));
+        t_assertSuccess(cellsAreaM2(cells, NUM_CELLS, m2));
+        t_assertSuccess(cellsAreaRads2(cells, NUM_CELLS, rads2));
+        for (int i = 0; i < NUM_CELLS; i++) {
+            double expected;
+            t_assertSuccess(cellAreaKm2(cells[i], &expected));
+            t_assert(closeEnough(km2[i], expected), "same area in km2");
+            t_assertSuccess(cellAreaM2(cells[i], &expected));
+            t_assert(closeEnough(m2[i], expected), "same area in m2");
+            t_assertSuccess(cellAreaRads2(cells[i], &expected));
+            t_assert(closeEnough(rads2[i], expected), "same area in rads2");
+        }
+        free(rads2);
+        free(m2);
+        free(km2);
+    }
+
+    TEST(invalidCells) {
+        H3Index invalid[] = {cells[0], 0x1, cells[1]};
+        double areas[ARRAY_SIZE(invalid)];
+        t_assert(cellsAreaM2(invalid, ARRAY_SIZE(invalid), areas) ==
+                     E_CELL_INVALID,
+                 "invalid cell reported");
+        t_assert(isnan(areas[1]), "invalid cell has no area");
+        t_assert(!isnan(areas[0]) && !isnan(areas[2]), "batch continues");
+    }
+
+    free(cells);
+}
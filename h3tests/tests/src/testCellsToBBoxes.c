@@ -0,0 +1,151 @@
+/** @file testCellsToBBoxes.c
+ * @brief Tests the bounding boxes of cells and cell sets
+ *
+ * usage: `testCellsToBBoxes`
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/** Tests if a box contains a point. */
+static bool bboxContainsPoint(const BBox *bbox, const LatLng *point) {
+    if (point->lat > bbox->north || point->lat < bbox->south) {
+        return false;
+    }
+    if (bbox->east < bbox->west) {
+        return point->lng >= bbox->west || point->lng <= bbox->east;
+    }
+    return point->lng >= bbox->west && point->lng <= bbox->east;
+}
+
+/** Checks that a box contains the center and vertices of a cell. */
+static void assertContainsCell(const BBox *bbox, H3Index cell) {
+    LatLng center;
+    CellBoundary boundary;
+    t_assertSuccess(cellToLatLng(cell, &center));
+    t_assertSuccess(cellToBoundary(cell, &boundary));
+    t_assert(bboxContainsPoint(bbox, &center), "center in the box");
+    for (int i = 0; i < boundary.numVerts; i++) {
+        t_assert(bboxContainsPoint(bbox, &boundary.verts[i]),
+                 "vertex in the box");
+    }
+}
+
+SUITE(cellsToBBoxes) {
+    TEST(res0) {
+        H3Index cells[122];
+        BBox boxes[122];
+        t_assertSuccess(getRes0Cells(cells));
+        t_assertSuccess(cellsToBBoxes(cells, 122, boxes));
+        int transmeridian = 0;
+        int polar = 0;
+        for (int i = 0; i < 122; i++) {
+            assertContainsCell(&boxes[i], cells[i]);
+            transmeridian += boxes[i].east < boxes[i].west;
+            polar += boxes[i].north == M_PI_2 || boxes[i].south == -M_PI_2;
+        }
+        t_assert(transmeridian > 0, "cells crossing the antimeridian");
+        t_assert(polar == 2, "a cell per pole");
+    }
+
+    TEST(finer) {
+        const H3Index cells[] = {0x85283473fffffff, 0x8f2830828052d25,
+                                 0x8009fffffffffff, 0x8a3ea6d6d5affff};
+        BBox boxes[4];
+        t_assertSuccess(cellsToBBoxes(cells, 4, boxes));
+        for (int i = 0; i < 4; i++) {
+            assertContainsCell(&boxes[i], cells[i]);
+            t_assert(boxes[i].north > boxes[i].south, "non-empty latitudes");
+        }
+    }
+
+    TEST(invalid) {
+        const H3Index cells[] = {0x85283473fffffff, 0, 0x85283473fffffff};
+        BBox boxes[3];
+        t_assert(cellsToBBoxes(cells, 3, boxes) == E_CELL_INVALID,
+                 "invalid cell reported");
+        t_assert(isnan(boxes[1].north), "invalid box");
+        t_assert(boxes[2].north == boxes[0].north, "batch carries on");
+
+        BBox bbox;
+        const H3Index invalid[] = {0x85283473fffffff, 1};
+        t_assert(cellsToBBox(invalid, 2, &bbox) == E_CELL_INVALID,
+                 "invalid cell in a set");
+        t_assertSuccess(cellsToBBoxes(NULL, 0, NULL));
+    }
+
+    TEST(set) {
+        // A compacted disk: its box holds the box of every cell.
+        H3Index disk[19];
+        H3Index compacted[19] = {0};
+        t_assertSuccess(gridDisk(0x85283473fffffff, 2, disk));
+        t_assertSuccess(compactCells(disk, compacted, 19));
+        BBox bbox;
+        t_assertSuccess(cellsToBBox(compacted, 19, &bbox));
+        for (int i = 0; i < 19; i++) {
+            assertContainsCell(&bbox, disk[i]);
+        }
+
+        BBox single;
+        t_assertSuccess(cellsToBBox(&disk[0], 1, &single));
+        BBox expected;
+        t_assertSuccess(cellsToBBoxes(&disk[0], 1, &expected));
+        t_assert(single.north == expected.north &&
+                     single.south == expected.south &&
+                     single.east == expected.east &&
+                     single.west == expected.west,
+                 "box of a single cell");
+    }
+
+    TEST(setAcrossAntimeridian) {
+        // Two cells on both sides of the antimeridian.
+        const LatLng west = {0.1, M_PI - 0.01};
+        const LatLng east = {0.1, -M_PI + 0.01};
+        H3Index cells[2];
+        t_assertSuccess(latLngToCell(&west, 5, &cells[0]));
+        t_assertSuccess(latLngToCell(&east, 5, &cells[1]));
+        BBox bbox;
+        t_assertSuccess(cellsToBBox(cells, 2, &bbox));
+        t_assert(bbox.east < bbox.west, "box crossing the antimeridian");
+        t_assert(bbox.west - bbox.east > M_PI, "narrow box");
+        assertContainsCell(&bbox, cells[0]);
+        assertContainsCell(&bbox, cells[1]);
+
+        bbox.north = 42;
+        t_assertSuccess(cellsToBBox(NULL, 0, &bbox));
+        t_assert(bbox.north == 42, "empty set leaves the box untouched");
+    }
+
+    TEST(setAcrossAntimeridianMixedResolutions) {
+        // A coarse cell crossing the antimeridian, next to a finer cell in
+        // the part of the coarse cell east of the antimeridian.
+        H3Index res0[122];
+        BBox boxes[122];
+        t_assertSuccess(getRes0Cells(res0));
+        t_assertSuccess(cellsToBBoxes(res0, 122, boxes));
+        int found = 0;
+        for (int i = 0; i < 122; i++) {
+            BBox *coarse = &boxes[i];
+            if (coarse->east >= coarse->west || coarse->north == M_PI_2 ||
+                coarse->south == -M_PI_2) {
+                continue;
+            }
+            found++;
+            const LatLng point = {(coarse->north + coarse->south) / 2,
+                                  (coarse->east - M_PI) / 2};
+            H3Index cells[2] = {res0[i]};
+            t_assertSuccess(latLngToCell(&point, 3, &cells[1]));
+
+            BBox bbox;
+            t_assertSuccess(cellsToBBox(cells, 2, &bbox));
+            t_assert(bbox.east < bbox.west, "box crossing the antimeridian");
+            assertContainsCell(&bbox, cells[0]);
+            assertContainsCell(&bbox, cells[1]);
+        }
+        t_assert(found > 0, "cells crossing the antimeridian");
+    }
+}
@@ -0,0 +1,69 @@
+/** @file testCellsToBoundaries.c
+ * @brief Tests the packed, batch version of `cellToBoundary`
+ *
+ * usage: `testCellsToBoundaries`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+
+static void assertMatchesCellToBoundary(H3Index parent, int childRes) {
+    int64_t numCells;
+    t_assertSuccess(cellToChildrenSize(parent, childRes, &numCells));
+    H3Index *cells = calloc(numCells, sizeof(H3Index));
+    t_assertSuccess(cellToChildren(parent, childRes, cells));
+
+    int64_t maxVerts = numCells * MAX_CELL_BNDRY_VERTS;
+    LatLng *verts = calloc(maxVerts, sizeof(LatLng));
+    int64_t *offsets = calloc(numCells + 1, sizeof(int64_t));
+    t_assertSuccess(
+        cellsToBoundaries(cells, numCells, verts, maxVerts, offsets));
+
+    t_assert(offsets[0] == 0, "offsets start at 0");
+    for (int64_t i = 0; i < numCells; i++) {
+        CellBoundary expected;
+        t_assertSuccess(cellToBoundary(cells[i], &expected));
+        t_assert(offsets[i + 1] - offsets[i] == expected.numVerts,
+                 "same number of vertices");
+        for (int v = 0; v < expected.numVerts; v++) {
+            LatLng vertex = verts[offsets[i] + v];
+            t_assert(vertex.lat == expected.verts[v].lat &&
+                         vertex.lng == expected.verts[v].lng,
+                     "same vertex");
+        }
+    }
+
+    free(offsets);
+    free(verts);
+    free(cells);
+}
+
+SUITE(cellsToBoundaries) {
+    TEST(hexagon) { assertMatchesCellToBoundary(0x85283473fffffff, 8); }
+
+    TEST(pentagon) { assertMatchesCellToBoundary(0x8009fffffffffff, 3); }
+
+    TEST(bufferTooSmall) {
+        H3Index cells[2] = {0x85283473fffffff, 0x85283447fffffff};
+        LatLng verts[6];
+        int64_t offsets[3];
+        t_assert(cellsToBoundaries(cells, 2, verts, 6, offsets) ==
+                     E_MEMORY_BOUNDS,
+                 "vertex buffer bound is checked");
+    }
+
+    TEST(invalidCell) {
+        H3Index cells[3] = {0x85283473fffffff, 0x7fffffffffffffff,
+                            0x85283447fffffff};
+        LatLng verts[3 * MAX_CELL_BNDRY_VERTS];
+        int64_t offsets[4];
+        t_assert(cellsToBoundaries(cells, 3, verts, 3 * MAX_CELL_BNDRY_VERTS,
+                                   offsets) == E_CELL_INVALID,
+                 "invalid cell reported");
+        t_assert(offsets[2] == offsets[1], "invalid cell has no vertex");
+        t_assert(offsets[3] - offsets[2] == 6,
+                 "batch continues after an invalid cell");
+    }
+}
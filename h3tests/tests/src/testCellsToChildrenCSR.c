@@ -0,0 +1,85 @@
+/** @file testCellsToChildrenCSR.c
+ * @brief Tests that `cellsToChildrenCSR` matches `cellToChildren` for every
+ * parent
+ *
+ * usage: `testCellsToChildrenCSR`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+SUITE(cellsToChildrenCSR) {
+    // Mixed resolutions, and a pentagon.
+    H3Index parents[] = {0x85283473fffffff, 0x8928308280fffff,
+                         0x872830828ffffff, 0x820807fffffffff,
+                         0x8928308280fffff};
+    int64_t numParents = sizeof(parents) / sizeof(parents[0]);
+    int childRes = 9;
+
+    TEST(matchesCellToChildren) {
+        int64_t total;
+        t_assertSuccess(
+            cellsToChildrenSize(parents, numParents, childRes, &total));
+        H3Index *children = calloc(total, sizeof(H3Index));
+        int64_t offsets[6];
+        t_assertSuccess(cellsToChildrenCSR(parents, numParents, childRes,
+                                           children, total, offsets));
+        t_assert(offsets[0] == 0, "first offset");
+        t_assert(offsets[numParents] == total, "last offset");
+
+        for (int64_t i = 0; i < numParents; i++) {
+            int64_t size;
+            t_assertSuccess(cellToChildrenSize(parents[i], childRes, &size));
+            t_assert(offsets[i + 1] - offsets[i] == size, "children count");
+            H3Index *expected = calloc(size, sizeof(H3Index));
+            t_assertSuccess(cellToChildren(parents[i], childRes, expected));
+            for (int64_t j = 0; j < size; j++) {
+                t_assert(children[offsets[i] + j] == expected[j],
+                         "same child, in the same order");
+            }
+            free(expected);
+        }
+        free(children);
+    }
+
+    TEST(tooSmall) {
+        H3Index child;
+        int64_t offsets[6];
+        int64_t total;
+        t_assert(cellsToChildrenCSR(parents, numParents, childRes, &child, 1,
+                                    offsets) == E_MEMORY_BOUNDS,
+                 "children buffer too small");
+        t_assertSuccess(
+            cellsToChildrenSize(parents, numParents, childRes, &total));
+        t_assert(offsets[numParents] == total, "required size returned");
+    }
+
+    TEST(empty) {
+        int64_t offsets[1] = {-1};
+        int64_t total;
+        t_assertSuccess(
+            cellsToChildrenCSR(NULL, 0, childRes, NULL, 0, offsets));
+        t_assert(offsets[0] == 0, "offset set");
+        t_assertSuccess(cellsToChildrenSize(NULL, 0, childRes, &total));
+        t_assert(total == 0, "no children");
+    }
+
+    TEST(invalid) {
+        H3Index child;
+        int64_t offsets[6];
+        int64_t total;
+        t_assert(cellsToChildrenCSR(parents, numParents, 5, &child, 1,
+                                    offsets) == E_RES_DOMAIN,
+                 "parent finer than the children");
+        t_assert(cellsToChildrenSize(parents, numParents, 16, &total) ==
+                     E_RES_DOMAIN,
+                 "invalid resolution");
+        H3Index invalid[] = {0x7fffffffffffffff};
+        t_assert(cellsToChildrenCSR(invalid, 1, childRes, &child, 1,
+                                    offsets) == E_CELL_INVALID,
+                 "invalid parent");
+    }
+}
@@ -0,0 +1,117 @@
+/** @file testCellsToFlatMultiPolygon.c
+ * @brief Tests the contiguous `cellsToFlatMultiPolygon` output
+ *
+ * usage: `testCellsToFlatMultiPolygon`
+ */
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/**
+ * Checks that the flat multipolygon holds the same polygons, rings and
+ * vertices (in the same order) than the linked one.
+ */
+static void assertSameAsLinked(const H3Index *set, int numHexes) {
+    LinkedGeoPolygon linked;
+    t_assertSuccess(cellsToLinkedMultiPolygon(set, numHexes, &linked));
+    FlatMultiPolygon flat;
+    t_assertSuccess(cellsToFlatMultiPolygon(set, numHexes, &flat));
+
+    t_assert(flat.polygonOffsets[0] == 0, "polygons start at the first ring");
+    t_assert(flat.ringOffsets[0] == 0, "rings start at the first vertex");
+    int64_t polygonIdx = 0;
+    for (LinkedGeoPolygon *polygon = &linked; polygon != NULL;
+         polygon = polygon->next, polygonIdx++) {
+        int64_t ringIdx = flat.polygonOffsets[polygonIdx];
+        for (LinkedGeoLoop *loop = polygon->first; loop != NULL;
+             loop = loop->next, ringIdx++) {
+            int64_t vertIdx = flat.ringOffsets[ringIdx];
+            for (LinkedLatLng *coord = loop->first; coord != NULL;
+                 coord = coord->next, vertIdx++) {
+                t_assert(flat.verts[vertIdx].lat == coord->vertex.lat &&
+                             flat.verts[vertIdx].lng == coord->vertex.lng,
+                         "same vertex");
+            }
+            t_assert(vertIdx == flat.ringOffsets[ringIdx + 1],
+                     "same number of vertices");
+        }
+        t_assert(ringIdx == flat.polygonOffsets[polygonIdx + 1],
+                 "same number of rings");
+    }
+    t_assert(polygonIdx == flat.numPolygons, "same number of polygons");
+    t_assert(flat.ringOffsets[flat.numRings] == flat.numVerts,
+             "rings cover every vertex");
+    t_assert(flat.polygonOffsets[flat.numPolygons] == flat.numRings,
+             "polygons cover every ring");
+
+    destroyFlatMultiPolygon(&flat);
+    destroyLinkedMultiPolygon(&linked);
+}
+
+SUITE(cellsToFlatMultiPolygon) {
+    TEST(empty) {
+        FlatMultiPolygon polygon;
+        t_assertSuccess(cellsToFlatMultiPolygon(NULL, 0, &polygon));
+        t_assert(polygon.numPolygons == 0, "no polygon");
+        t_assert(polygon.numRings == 0, "no ring");
+        t_assert(polygon.numVerts == 0, "no vertex");
+        destroyFlatMultiPolygon(&polygon);
+    }
+
+    TEST(singleHex) {
+        H3Index set[] = {0x890dab6220bffff};
+        FlatMultiPolygon polygon;
+        t_assertSuccess(
+            cellsToFlatMultiPolygon(set, ARRAY_SIZE(set), &polygon));
+        t_assert(polygon.numPolygons == 1, "1 polygon");
+        t_assert(polygon.numRings == 1, "1 ring");
+        t_assert(polygon.numVerts == 6, "6 vertices");
+        destroyFlatMultiPolygon(&polygon);
+        t_assert(polygon.verts == NULL && polygon.ringOffsets == NULL &&
+                     polygon.polygonOffsets == NULL,
+                 "arrays reset");
+        t_assert(polygon.numVerts == 0 && polygon.numRings == 0 &&
+                     polygon.numPolygons == 0,
+                 "counts reset");
+        // Destroying it again is a no-op.
+        destroyFlatMultiPolygon(&polygon);
+
+        assertSameAsLinked(set, ARRAY_SIZE(set));
+    }
+
+    TEST(invalid) {
+        H3Index set[] = {0xfffffffffffffff};
+        FlatMultiPolygon polygon;
+        t_assert(cellsToFlatMultiPolygon(set, ARRAY_SIZE(set), &polygon) ==
+                     E_CELL_INVALID,
+                 "Invalid set fails");
+    }
+
+    TEST(hole) {
+        H3Index set[] = {0x892830828c7ffff, 0x892830828d7ffff,
+                         0x8928308289bffff, 0x89283082813ffff,
+                         0x8928308288fffff, 0x89283082883ffff};
+        FlatMultiPolygon polygon;
+        t_assertSuccess(
+            cellsToFlatMultiPolygon(set, ARRAY_SIZE(set), &polygon));
+        t_assert(polygon.numPolygons == 1, "1 polygon");
+        t_assert(polygon.numRings == 2, "outer loop and hole");
+        destroyFlatMultiPolygon(&polygon);
+
+        assertSameAsLinked(set, ARRAY_SIZE(set));
+    }
+
+    TEST(nestedDonut) {
+        H3Index set[] = {
+            0x89283082813ffff, 0x8928308281bffff, 0x8928308280bffff,
+            0x8928308280fffff, 0x89283082807ffff, 0x89283082817ffff,
+            0x8928308289bffff, 0x892830828d7ffff, 0x892830828c3ffff,
+            0x892830828cbffff, 0x89283082853ffff, 0x89283082843ffff,
+            0x8928308284fffff, 0x8928308287bffff, 0x89283082863ffff,
+            0x89283082867ffff, 0x8928308282bffff, 0x89283082823ffff,
+            0x89283082837ffff, 0x892830828afffff, 0x892830828a3ffff,
+            0x892830828b3ffff, 0x89283082887ffff, 0x89283082883ffff};
+        assertSameAsLinked(set, ARRAY_SIZE(set));
+    }
+}
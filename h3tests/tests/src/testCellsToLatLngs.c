@@ -0,0 +1,46 @@
+/** @file testCellsToLatLngs.c
+ * @brief Tests the batch, structure-of-arrays version of `cellToLatLng`
+ *
+ * usage: `testCellsToLatLngs`
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+
+SUITE(cellsToLatLngs) {
+    H3Index parent = 0x85283473fffffff;
+    int64_t numCells;
+    t_assertSuccess(cellToChildrenSize(parent, 9, &numCells));
+    H3Index *cells = calloc(numCells, sizeof(H3Index));
+    t_assertSuccess(cellToChildren(parent, 9, cells));
+
+    TEST(matchesCellToLatLng) {
+        double *lat = calloc(numCells, sizeof(double));
+        double *lng = calloc(numCells, sizeof(double));
+        t_assertSuccess(cellsToLatLngs(cells, numCells, lat, lng));
+        for (int64_t i = 0; i < numCells; i++) {
+            LatLng expected;
+            t_assertSuccess(cellToLatLng(cells[i], &expected));
+            t_assert(lat[i] == expected.lat, "same latitude");
+            t_assert(lng[i] == expected.lng, "same longitude");
+        }
+        free(lat);
+        free(lng);
+    }
+
+    TEST(invalidCell) {
+        H3Index batch[3] = {cells[0], 0x7fffffffffffffff, cells[1]};
+        double lat[3];
+        double lng[3];
+        t_assert(cellsToLatLngs(batch, 3, lat, lng) == E_CELL_INVALID,
+                 "invalid cell reported");
+        t_assert(isnan(lat[1]) && isnan(lng[1]), "invalid cell is NaN");
+        t_assert(!isnan(lat[2]) && !isnan(lng[2]),
+                 "batch continues after an invalid cell");
+    }
+
+    free(cells);
+}
@@ -0,0 +1,152 @@
+/** @file testCellsToLinkedMultiPolygonParallel.c
+ * @brief Tests that `cellsToLinkedMultiPolygonParallel` describes the same
+ * outline as `cellsToLinkedMultiPolygon`
+ *
+ * usage: `testCellsToLinkedMultiPolygonParallel`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "linkedGeo.h"
+#include "test.h"
+#include "utility.h"
+
+/** Counts the coordinates of every loop of every polygon. */
+static int countAllCoords(LinkedGeoPolygon *polygon) {
+    int count = 0;
+    for (; polygon != NULL; polygon = polygon->next) {
+        for (LinkedGeoLoop *loop = polygon->first; loop != NULL;
+             loop = loop->next) {
+            count += countLinkedCoords(loop);
+        }
+    }
+    return count;
+}
+
+/** Counts the loops of every polygon. */
+static int countAllLoops(LinkedGeoPolygon *polygon) {
+    int count = 0;
+    for (; polygon != NULL; polygon = polygon->next) {
+        count += countLinkedLoops(polygon);
+    }
+    return count;
+}
+
+static void assertSameOutline(const H3Index *cells, int numCells) {
+    LinkedGeoPolygon expected, actual;
+    t_assertSuccess(cellsToLinkedMultiPolygon(cells, numCells, &expected));
+    t_assertSuccess(
+        cellsToLinkedMultiPolygonParallel(cells, numCells, &actual));
+
+    t_assert(countLinkedPolygons(&expected) == countLinkedPolygons(&actual),
+             "same number of polygons");
+    t_assert(countAllLoops(&expected) == countAllLoops(&actual),
+             "same number of loops");
+    t_assert(countAllCoords(&expected) == countAllCoords(&actual),
+             "same number of coordinates");
+
+    destroyLinkedMultiPolygon(&actual);
+    destroyLinkedMultiPolygon(&expected);
+}
+
+/** Returns the (packed) disk of radius k around the origin. */
+static H3Index *disk(H3Index origin, int k, int *numCells) {
+    int64_t size;
+    t_assertSuccess(maxGridDiskSize(k, &size));
+    H3Index *cells = calloc(size, sizeof(H3Index));
+    t_assertSuccess(gridDisk(origin, k, cells));
+    int count = 0;
+    for (int64_t i = 0; i < size; i++) {
+        if (cells[i] != H3_NULL) {
+            cells[count++] = cells[i];
+        }
+    }
+    *numCells = count;
+    return cells;
+}
+
+SUITE(cellsToLinkedMultiPolygonParallel) {
+    TEST(empty) {
+        LinkedGeoPolygon polygon;
+        t_assertSuccess(cellsToLinkedMultiPolygonParallel(NULL, 0, &polygon));
+        t_assert(countLinkedLoops(&polygon) == 0, "no loop");
+        destroyLinkedMultiPolygon(&polygon);
+    }
+
+    TEST(singleHex) {
+        H3Index set[] = {0x890dab6220bffff};
+        LinkedGeoPolygon polygon;
+        t_assertSuccess(cellsToLinkedMultiPolygonParallel(set, 1, &polygon));
+        t_assert(countLinkedPolygons(&polygon) == 1, "1 polygon");
+        t_assert(countLinkedLoops(&polygon) == 1, "1 loop");
+        t_assert(countLinkedCoords(polygon.first) == 6, "6 coords");
+        destroyLinkedMultiPolygon(&polygon);
+    }
+
+    TEST(disk) {
+        int numCells;
+        H3Index *cells = disk(0x8928308280fffff, 20, &numCells);
+        assertSameOutline(cells, numCells);
+        free(cells);
+    }
+
+    TEST(hole) {
+        // A disk without its center: one polygon with one hole.
+        int numCells;
+        H3Index *cells = disk(0x8928308280fffff, 3, &numCells);
+        LinkedGeoPolygon polygon;
+        t_assertSuccess(
+            cellsToLinkedMultiPolygonParallel(cells + 1, numCells - 1,
+                                              &polygon));
+        t_assert(countLinkedPolygons(&polygon) == 1, "1 polygon");
+        t_assert(countLinkedLoops(&polygon) == 2, "outer loop and hole");
+        t_assert(countLinkedCoords(polygon.first->next) == 6,
+                 "hole is the center cell");
+        destroyLinkedMultiPolygon(&polygon);
+
+        assertSameOutline(cells + 1, numCells - 1);
+        free(cells);
+    }
+
+    TEST(disjoint) {
+        H3Index set[] = {0x8928308291bffff, 0x89283082943ffff};
+        LinkedGeoPolygon polygon;
+        t_assertSuccess(cellsToLinkedMultiPolygonParallel(set, 2, &polygon));
+        t_assert(countLinkedPolygons(&polygon) == 2, "2 polygons");
+        destroyLinkedMultiPolygon(&polygon);
+    }
+
+    TEST(pentagon) {
+        // Class III resolution: edges crossing icosahedron edges get
+        // distortion vertexes.
+        int numCells;
+        H3Index *cells = disk(0x81083ffffffffff, 2, &numCells);
+        assertSameOutline(cells, numCells);
+        free(cells);
+    }
+
+    TEST(duplicates) {
+        H3Index set[] = {0x8928308291bffff, 0x89283082957ffff,
+                         0x8928308291bffff};
+        LinkedGeoPolygon polygon;
+        t_assertSuccess(cellsToLinkedMultiPolygonParallel(set, 3, &polygon));
+        t_assert(countLinkedLoops(&polygon) == 1, "1 loop");
+        t_assert(countLinkedCoords(polygon.first) == 10,
+                 "all coords except 2 shared");
+        destroyLinkedMultiPolygon(&polygon);
+    }
+
+    TEST(invalid) {
+        H3Index invalid[] = {0xfffffffffffffff};
+        LinkedGeoPolygon polygon;
+        t_assert(cellsToLinkedMultiPolygonParallel(invalid, 1, &polygon) ==
+                     E_CELL_INVALID,
+                 "invalid set fails");
+
+        H3Index mixed[] = {0x8928308280fffff, 0x8828308281fffff};
+        t_assert(cellsToLinkedMultiPolygonParallel(mixed, 2, &polygon) ==
+                     E_RES_MISMATCH,
+                 "mixed resolutions fail");
+    }
+}
@@ -0,0 +1,78 @@
+/** @file testCellsToLocalIj.c
+ * @brief Tests the batch `cellsToLocalIj` and `localIjsToCells`
+ *
+ * usage: `testCellsToLocalIj`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+SUITE(cellsToLocalIj) {
+    H3Index origin = 0x8928308280fffff;
+    int64_t size;
+    t_assertSuccess(maxGridDiskSize(4, &size));
+    H3Index *cells = calloc(size, sizeof(H3Index));
+    t_assertSuccess(gridDisk(origin, 4, cells));
+
+    TEST(matchesCellToLocalIj) {
+        CoordIJ *coords = calloc(size, sizeof(CoordIJ));
+        t_assertSuccess(cellsToLocalIj(origin, cells, size, 0, coords, NULL));
+        for (int64_t i = 0; i < size; i++) {
+            CoordIJ expected;
+            t_assertSuccess(cellToLocalIj(origin, cells[i], 0, &expected));
+            t_assert(coords[i].i == expected.i && coords[i].j == expected.j,
+                     "same coordinates");
+        }
+        free(coords);
+    }
+
+    TEST(roundtrip) {
+        CoordIJ *coords = calloc(size, sizeof(CoordIJ));
+        H3Index *back = calloc(size, sizeof(H3Index));
+        H3Error *errs = calloc(size, sizeof(H3Error));
+        t_assertSuccess(cellsToLocalIj(origin, cells, size, 0, coords, errs));
+        t_assertSuccess(localIjsToCells(origin, coords, size, 0, back, errs));
+        for (int64_t i = 0; i < size; i++) {
+            t_assertSuccess(errs[i]);
+            t_assert(back[i] == cells[i], "roundtrip");
+        }
+        free(errs);
+        free(back);
+        free(coords);
+    }
+
+    TEST(failures) {
+        H3Index badCells[] = {origin, 0};
+        CoordIJ coords[2];
+        H3Error errs[2];
+        t_assert(cellsToLocalIj(origin, badCells, 2, 0, coords, errs) ==
+                     E_CELL_INVALID,
+                 "first error is returned");
+        t_assertSuccess(errs[0]);
+        t_assert(errs[1] == E_CELL_INVALID, "invalid index reported");
+
+        CoordIJ farCoords[] = {{0, 0}, {1000000, 1000000}};
+        H3Index out[2];
+        t_assert(localIjsToCells(origin, farCoords, 2, 0, out, errs) !=
+                     E_SUCCESS,
+                 "unreachable coordinates reported");
+        t_assert(out[1] == H3_NULL, "unreachable coordinates have no cell");
+    }
+
+    TEST(invalidInputs) {
+        CoordIJ coord;
+        t_assert(cellsToLocalIj(origin, cells, 1, 1, &coord, NULL) == E_DOMAIN,
+                 "invalid mode rejected");
+        t_assert(cellsToLocalIj(0, cells, 1, 0, &coord, NULL) ==
+                     E_CELL_INVALID,
+                 "invalid origin rejected");
+        H3Index out;
+        t_assert(localIjsToCells(origin, &coord, 1, 1, &out, NULL) == E_DOMAIN,
+                 "invalid mode rejected");
+    }
+
+    free(cells);
+}
@@ -0,0 +1,72 @@
+/** @file testCellsToParents.c
+ * @brief Tests the batch `cellsToParents` and `cellsToCenterChildren`
+ *
+ * usage: `testCellsToParents`
+ */
+
+#include <stdlib.h>
+
+#include "constants.h"
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define NUM_CELLS 100
+#define RES 9
+
+SUITE(cellsToParents) {
+    H3Index cells[NUM_CELLS];
+    for (int i = 0; i < NUM_CELLS; i++) {
+        LatLng coord;
+        randomGeo(&coord);
+        t_assertSuccess(latLngToCell(&coord, RES, &cells[i]));
+    }
+    t_assertSuccess(getPentagons(RES, cells));
+
+    TEST(matchesCellToParent) {
+        H3Index parents[NUM_CELLS];
+        for (int res = 0; res <= RES; res++) {
+            t_assertSuccess(cellsToParents(cells, NUM_CELLS, res, parents));
+            for (int i = 0; i < NUM_CELLS; i++) {
+                H3Index expected;
+                t_assertSuccess(cellToParent(cells[i], res, &expected));
+                t_assert(parents[i] == expected, "same parent");
+            }
+        }
+    }
+
+    TEST(matchesCellToCenterChild) {
+        H3Index children[NUM_CELLS];
+        for (int res = RES; res <= MAX_H3_RES; res++) {
+            t_assertSuccess(
+                cellsToCenterChildren(cells, NUM_CELLS, res, children));
+            for (int i = 0; i < NUM_CELLS; i++) {
+                H3Index expected;
+                t_assertSuccess(cellToCenterChild(cells[i], res, &expected));
+                t_assert(children[i] == expected, "same center child");
+            }
+        }
+    }
+
+    TEST(failures) {
+        H3Index set[] = {cells[0], 0};
+        H3Index out[2];
+        t_assert(cellsToParents(set, 2, 5, out) == E_CELL_INVALID,
+                 "invalid cell reported");
+        t_assert(out[1] == H3_NULL, "invalid cell has no parent");
+        t_assert(out[0] != H3_NULL, "next cells are processed");
+
+        t_assert(cellsToParents(cells, 1, RES + 1, out) == E_RES_MISMATCH,
+                 "finer parent rejected");
+        t_assert(out[0] == H3_NULL, "finer parent is H3_NULL");
+        t_assert(cellsToCenterChildren(cells, 1, RES - 1, out) ==
+                     E_RES_DOMAIN,
+                 "coarser child rejected");
+        t_assert(out[0] == H3_NULL, "coarser child is H3_NULL");
+
+        t_assert(cellsToParents(cells, 1, 16, out) == E_RES_DOMAIN,
+                 "invalid resolution rejected");
+        t_assert(cellsToCenterChildren(cells, 1, -1, out) == E_RES_DOMAIN,
+                 "invalid resolution rejected");
+    }
+}
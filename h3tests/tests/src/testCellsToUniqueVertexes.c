@@ -0,0 +1,87 @@
+/** @file testCellsToUniqueVertexes.c
+ * @brief Tests the deduplicated `cellsToUniqueVertexes`
+ *
+ * usage: `testCellsToUniqueVertexes`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/** Returns the number of unique vertexes, the reference way. */
+static int64_t sortedUniqueVertexes(const H3Index *cells, int64_t numCells,
+                                    H3Index *out) {
+    int64_t count = 0;
+    for (int64_t i = 0; i < numCells; i++) {
+        H3Index vertexes[6] = {0};
+        t_assertSuccess(cellToVertexes(cells[i], vertexes));
+        for (int j = 0; j < 6; j++) {
+            if (vertexes[j] != H3_NULL) {
+                out[count++] = vertexes[j];
+            }
+        }
+    }
+    qsort(out, count, sizeof(H3Index), compareCells);
+    int64_t unique = 0;
+    for (int64_t i = 0; i < count; i++) {
+        if (unique == 0 || out[unique - 1] != out[i]) {
+            out[unique++] = out[i];
+        }
+    }
+    return unique;
+}
+
+static void assertMatchesReference(const H3Index *cells, int64_t numCells) {
+    H3Index *expected = calloc(6 * numCells, sizeof(H3Index));
+    H3Index *vertexes = calloc(6 * numCells, sizeof(H3Index));
+    int64_t expectedCount = sortedUniqueVertexes(cells, numCells, expected);
+
+    int64_t count;
+    t_assertSuccess(cellsToUniqueVertexes(cells, numCells, vertexes, &count));
+    t_assert(count == expectedCount, "same number of vertexes");
+    qsort(vertexes, count, sizeof(H3Index), compareCells);
+    t_assert(memcmp(vertexes, expected, count * sizeof(H3Index)) == 0,
+             "same vertexes");
+
+    free(vertexes);
+    free(expected);
+}
+
+SUITE(cellsToUniqueVertexes) {
+    TEST(disk) {
+        H3Index disk[91];
+        t_assertSuccess(gridDisk(0x89283082837ffff, 5, disk));
+        assertMatchesReference(disk, ARRAY_SIZE(disk));
+        // A partial disk, with owners outside of the set.
+        assertMatchesReference(disk, 40);
+    }
+
+    TEST(pentagon) {
+        H3Index disk[19];
+        int64_t count;
+        t_assertSuccess(gridDiskCompact(0x830800fffffffff, 2, disk, &count));
+        assertMatchesReference(disk, count);
+    }
+
+    TEST(duplicates) {
+        H3Index cells[] = {0x89283082837ffff, 0x89283082837ffff};
+        H3Index vertexes[12];
+        int64_t count;
+        t_assertSuccess(cellsToUniqueVertexes(cells, 2, vertexes, &count));
+        t_assert(count == 6, "duplicated cell is ignored");
+    }
+
+    TEST(invalidInputs) {
+        H3Index cells[] = {0x89283082837ffff, 0x1};
+        H3Index vertexes[12];
+        int64_t count;
+        t_assert(cellsToUniqueVertexes(cells, 2, vertexes, &count) ==
+                     E_CELL_INVALID,
+                 "invalid cell rejected");
+        t_assertSuccess(cellsToUniqueVertexes(cells, 0, vertexes, &count));
+        t_assert(count == 0, "no cell, no vertex");
+    }
+}
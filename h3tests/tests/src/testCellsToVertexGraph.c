@@ -0,0 +1,111 @@
+/** @file testCellsToVertexGraph.c
+ * @brief Tests the vertex graph of cell sets, `cellsToVertexGraph`, and the
+ * batch `vertexesToLatLngs`
+ *
+ * usage: `testCellsToVertexGraph`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/** Returns the number of rings of a vertex graph, checking their chaining. */
+static int countRings(const H3Index *from, const H3Index *to,
+                      int64_t numEdges) {
+    int rings = 0;
+    int64_t start = 0;
+    for (int64_t i = 0; i < numEdges; i++) {
+        if (to[i] == from[start]) {
+            rings++;
+            start = i + 1;
+        } else {
+            t_assert(i + 1 < numEdges && to[i] == from[i + 1],
+                     "edges are chained");
+        }
+    }
+    t_assert(start == numEdges, "last ring is closed");
+    return rings;
+}
+
+SUITE(cellsToVertexGraph) {
+    TEST(empty) {
+        int64_t numEdges = -1;
+        t_assertSuccess(cellsToVertexGraph(NULL, 0, NULL, NULL, &numEdges));
+        t_assert(numEdges == 0, "no edge");
+    }
+
+    TEST(singleCell) {
+        H3Index cell = 0x890dab6220bffff;
+        H3Index from[6], to[6], vertexes[6];
+        int64_t numEdges;
+        t_assertSuccess(cellsToVertexGraph(&cell, 1, from, to, &numEdges));
+        t_assert(numEdges == 6, "every edge of the cell");
+        t_assert(countRings(from, to, numEdges) == 1, "one ring");
+
+        t_assertSuccess(cellToVertexes(cell, vertexes));
+        for (int i = 0; i < 6; i++) {
+            int found = 0;
+            for (int j = 0; j < 6; j++) {
+                found += from[i] == vertexes[j];
+            }
+            t_assert(found == 1, "edges start at the vertexes of the cell");
+        }
+    }
+
+    TEST(sharedEdges) {
+        // Disk with a duplicate: the inner edges cancel out.
+        H3Index cells[8];
+        t_assertSuccess(gridDisk(0x8928308280fffff, 1, cells));
+        cells[7] = cells[3];
+        H3Index from[6 * 8], to[6 * 8];
+        int64_t numEdges;
+        t_assertSuccess(cellsToVertexGraph(cells, 8, from, to, &numEdges));
+        t_assert(numEdges == 18, "outer edges of the disk");
+        t_assert(countRings(from, to, numEdges) == 1, "one ring");
+
+        // Without its center, the disk has a hole.
+        t_assertSuccess(cellsToVertexGraph(cells + 1, 6, from, to, &numEdges));
+        t_assert(numEdges == 24, "outer and inner edges");
+        t_assert(countRings(from, to, numEdges) == 2, "outer ring and hole");
+    }
+
+    TEST(pentagon) {
+        H3Index cell = 0x8009fffffffffff;
+        H3Index from[6], to[6];
+        int64_t numEdges;
+        t_assertSuccess(cellsToVertexGraph(&cell, 1, from, to, &numEdges));
+        t_assert(numEdges == 5, "every edge of the pentagon");
+        t_assert(countRings(from, to, numEdges) == 1, "one ring");
+    }
+
+    TEST(invalid) {
+        H3Index cells[2] = {0x890dab6220bffff, 0x7fffffffffffffff};
+        H3Index from[12], to[12];
+        int64_t numEdges;
+        t_assert(cellsToVertexGraph(cells, 2, from, to, &numEdges) ==
+                     E_CELL_INVALID,
+                 "invalid cell");
+        cells[1] = 0x85283473fffffff;
+        t_assert(cellsToVertexGraph(cells, 2, from, to, &numEdges) ==
+                     E_RES_MISMATCH,
+                 "mixed resolutions");
+    }
+
+    TEST(vertexesToLatLngs) {
+        H3Index vertexes[7];
+        t_assertSuccess(cellToVertexes(0x890dab6220bffff, vertexes));
+        vertexes[6] = 0x890dab6220bffff;
+        LatLng coords[7];
+        t_assert(vertexesToLatLngs(vertexes, 7, coords) == E_VERTEX_INVALID,
+                 "invalid vertex reported");
+        for (int i = 0; i < 6; i++) {
+            LatLng expected;
+            t_assertSuccess(vertexToLatLng(vertexes[i], &expected));
+            t_assert(coords[i].lat == expected.lat &&
+                         coords[i].lng == expected.lng,
+                     "same coordinates");
+        }
+    }
+}
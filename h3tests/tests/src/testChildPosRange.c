@@ -0,0 +1,92 @@
+/** @file testChildPosRange.c
+ * @brief Tests the batch `childPosRangeToCells` and `cellsToChildPos`
+ *
+ * usage: `testChildPosRange`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static void assertMatchesChildPosToCell(H3Index parent, int childRes) {
+    int64_t size;
+    t_assertSuccess(cellToChildrenSize(parent, childRes, &size));
+    H3Index *children = calloc(size, sizeof(H3Index));
+    int64_t *positions = calloc(size, sizeof(int64_t));
+
+    t_assertSuccess(childPosRangeToCells(parent, childRes, 0, size, children));
+    for (int64_t i = 0; i < size; i++) {
+        H3Index expected;
+        t_assertSuccess(childPosToCell(i, parent, childRes, &expected));
+        t_assert(children[i] == expected, "same child");
+    }
+
+    int parentRes = getResolution(parent);
+    t_assertSuccess(cellsToChildPos(children, size, parentRes, positions));
+    for (int64_t i = 0; i < size; i++) {
+        t_assert(positions[i] == i, "same position");
+    }
+
+    // Ranges starting in the middle of the children.
+    int64_t start = size / 3;
+    int64_t count = size - start;
+    t_assertSuccess(
+        childPosRangeToCells(parent, childRes, start, count, children));
+    for (int64_t i = 0; i < count; i++) {
+        H3Index expected;
+        t_assertSuccess(childPosToCell(start + i, parent, childRes, &expected));
+        t_assert(children[i] == expected, "same child in sub-range");
+    }
+
+    free(positions);
+    free(children);
+}
+
+SUITE(childPosRange) {
+    H3Index hexagon = 0x88283080ddfffff;
+    H3Index pentagon = 0x830800fffffffff;
+
+    TEST(hexagon) {
+        for (int res = 8; res <= 11; res++) {
+            assertMatchesChildPosToCell(hexagon, res);
+        }
+    }
+
+    TEST(pentagon) {
+        for (int res = 3; res <= 6; res++) {
+            assertMatchesChildPosToCell(pentagon, res);
+        }
+    }
+
+    TEST(invalidRange) {
+        H3Index out[2];
+        int64_t size;
+        t_assertSuccess(cellToChildrenSize(hexagon, 9, &size));
+        t_assert(childPosRangeToCells(hexagon, 9, size - 1, 2, out) == E_DOMAIN,
+                 "range past the last child rejected");
+        t_assert(childPosRangeToCells(hexagon, 9, -1, 1, out) == E_DOMAIN,
+                 "negative start rejected");
+        t_assert(childPosRangeToCells(hexagon, 7, 0, 1, out) == E_RES_MISMATCH,
+                 "coarser resolution rejected");
+        t_assert(childPosRangeToCells(0, 9, 0, 1, out) == E_CELL_INVALID,
+                 "invalid cell rejected");
+        t_assertSuccess(childPosRangeToCells(hexagon, 9, size, 0, out));
+    }
+
+    TEST(invalidCells) {
+        H3Index cells[] = {hexagon, 0, 0x85283473fffffff};
+        int64_t positions[ARRAY_SIZE(cells)];
+        t_assert(cellsToChildPos(cells, ARRAY_SIZE(cells), 5, positions) ==
+                     E_CELL_INVALID,
+                 "invalid cell reported");
+        t_assert(positions[1] == -1, "invalid cell has no position");
+        t_assert(positions[0] != -1 && positions[2] == 0, "batch continues");
+
+        H3Index coarse[] = {0x85283473fffffff};
+        t_assert(cellsToChildPos(coarse, 1, 8, positions) == E_RES_MISMATCH,
+                 "coarser cell reported");
+        t_assert(positions[0] == -1, "coarser cell has no position");
+    }
+}
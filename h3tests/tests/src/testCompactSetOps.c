@@ -0,0 +1,152 @@
+/** @file testCompactSetOps.c
+ * @brief Tests the union, intersection and difference of compacted sets
+ *
+ * usage: `testCompactSetOps`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static const H3Index parent = 0x85283473fffffff;
+static const H3Index pentagon = 0x8009fffffffffff;
+
+/** Returns the (sorted) cells of a compacted set at resolution 7. */
+static H3Index *uncompacted(const H3Index *cells, int64_t count,
+                            int64_t *size) {
+    t_assertSuccess(uncompactCellsSize(cells, count, 7, size));
+    H3Index *out = calloc(*size ? *size : 1, sizeof(H3Index));
+    t_assertSuccess(uncompactCells(cells, count, out, *size, 7));
+    qsort(out, *size, sizeof(H3Index), compareCells);
+    return out;
+}
+
+/** Checks that a compacted set covers the same cells as an uncompacted one. */
+static void assertCovers(const H3Index *cells, int64_t count,
+                         const H3Index *expected, int64_t expectedSize) {
+    int64_t size;
+    H3Index *actual = uncompacted(cells, count, &size);
+    t_assert(size == expectedSize, "same number of cells");
+    t_assert(memcmp(actual, expected, size * sizeof(H3Index)) == 0,
+             "same cells");
+    free(actual);
+
+    // Recompacting the cells doesn't merge anything.
+    H3Index *children = uncompacted(cells, count, &size);
+    H3Index *recompacted = calloc(size, sizeof(H3Index));
+    t_assertSuccess(compactCells(children, recompacted, size));
+    int64_t recompactedCount = 0;
+    for (int64_t i = 0; i < size; i++) {
+        recompactedCount += recompacted[i] != H3_NULL;
+    }
+    t_assert(recompactedCount == count, "compacted output");
+    free(recompacted);
+    free(children);
+}
+
+SUITE(compactSetOps) {
+    TEST(union) {
+        // Children of the parent split between both sets, with overlaps.
+        H3Index children[7];
+        t_assertSuccess(cellToChildren(parent, 6, children));
+        H3Index a[] = {children[0], children[1], children[2], children[3],
+                       H3_NULL};
+        H3Index b[] = {children[3], children[4], children[5], children[6]};
+        H3Index out[9];
+        int64_t count;
+        t_assertSuccess(compactCellsUnion(a, 5, b, 4, out, 9, &count));
+        t_assert(count == 1 && out[0] == parent, "siblings merged");
+
+        H3Index grandchild;
+        t_assertSuccess(cellToCenterChild(children[6], 7, &grandchild));
+        H3Index c[] = {grandchild, pentagon};
+        t_assertSuccess(compactCellsUnion(a, 5, c, 2, out, 9, &count));
+        t_assert(count == 6, "disjoint cells kept");
+        t_assert(compactCellsUnion(a, 5, c, 2, out, 5, &count) ==
+                     E_MEMORY_BOUNDS,
+                 "output too small");
+    }
+
+    TEST(intersection) {
+        H3Index children[7];
+        t_assertSuccess(cellToChildren(parent, 6, children));
+        H3Index grandchildren[7];
+        t_assertSuccess(cellToChildren(children[2], 7, grandchildren));
+        H3Index a[] = {parent};
+        H3Index b[] = {grandchildren[1], children[5], pentagon};
+        H3Index out[3];
+        int64_t count;
+        t_assertSuccess(compactCellsIntersection(a, 1, b, 3, out, 3, &count));
+        t_assert(count == 2 && out[0] == grandchildren[1] &&
+                     out[1] == children[5],
+                 "covered cells");
+
+        t_assertSuccess(compactCellsIntersection(b, 3, a, 1, out, 3, &count));
+        t_assert(count == 2, "commutative");
+        H3Index none[] = {pentagon};
+        t_assertSuccess(
+            compactCellsIntersection(a, 1, none, 1, out, 3, &count));
+        t_assert(count == 0, "disjoint sets");
+    }
+
+    TEST(difference) {
+        H3Index children[7];
+        t_assertSuccess(cellToChildren(parent, 6, children));
+        H3Index grandchildren[7];
+        t_assertSuccess(cellToChildren(children[2], 7, grandchildren));
+        H3Index a[] = {parent, pentagon};
+        H3Index b[] = {grandchildren[1], children[5]};
+        H3Index out[100];
+        int64_t count;
+        t_assertSuccess(compactCellsDifference(a, 2, b, 2, out, 100, &count));
+        // 5 children, 6 grandchildren and the pentagon.
+        t_assert(count == 12, "split cell");
+        t_assert(out[0] == pentagon, "hierarchical order");
+
+        int64_t parentSize;
+        H3Index *expected = uncompacted(a, 1, &parentSize);
+        int64_t holeSize;
+        H3Index *holes = uncompacted(b, 2, &holeSize);
+        int64_t expectedSize = 0;
+        for (int64_t i = 0; i < parentSize; i++) {
+            if (!bsearch(&expected[i], holes, holeSize, sizeof(H3Index),
+                         compareCells)) {
+                expected[expectedSize++] = expected[i];
+            }
+        }
+        assertCovers(out + 1, count - 1, expected, expectedSize);
+        free(holes);
+        free(expected);
+
+        // Pentagon children, around the deleted subsequence.
+        H3Index pentagonChildren[6];
+        t_assertSuccess(cellToChildren(pentagon, 1, pentagonChildren));
+        H3Index p[] = {pentagon};
+        H3Index hole[] = {pentagonChildren[0]};
+        t_assertSuccess(
+            compactCellsDifference(p, 1, hole, 1, out, 100, &count));
+        t_assert(count == 5, "other pentagon children");
+        t_assertSuccess(
+            compactCellsDifference(hole, 1, p, 1, out, 100, &count));
+        t_assert(count == 0, "fully covered");
+    }
+
+    TEST(errors) {
+        H3Index a[] = {parent};
+        H3Index invalid[] = {0x1234};
+        H3Index out[1];
+        int64_t count;
+        t_assert(compactCellsUnion(a, 1, invalid, 1, out, 1, &count) ==
+                     E_CELL_INVALID,
+                 "invalid cell");
+        t_assert(compactCellsDifference(a, -1, a, 1, out, 1, &count) ==
+                     E_DOMAIN,
+                 "negative size");
+        t_assertSuccess(
+            compactCellsIntersection(NULL, 0, a, 1, out, 1, &count));
+        t_assert(count == 0, "empty set");
+    }
+}
@@ -0,0 +1,108 @@
+/** @file testCompactSortedCells.c
+ * @brief Tests the `compactSortedCells` and `compactCellsInPlace` variants
+ *
+ * usage: `testCompactSortedCells`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static const H3Index sunnyvale = 0x89283470c27ffff;
+
+/** Sorts the set, moving H3_NULL at the end. */
+static void sortCells(H3Index *cells, int64_t size) {
+    for (int64_t i = 0; i < size; i++) {
+        if (cells[i] == H3_NULL) {
+            cells[i] = UINT64_MAX;
+        }
+    }
+    qsort(cells, size, sizeof(H3Index), compareCells);
+    for (int64_t i = 0; i < size; i++) {
+        if (cells[i] == UINT64_MAX) {
+            cells[i] = H3_NULL;
+        }
+    }
+}
+
+SUITE(compactSortedCells) {
+    int k = 9;
+    int64_t hexCount;
+    t_assertSuccess(maxGridDiskSize(k, &hexCount));
+    H3Index *disk = calloc(hexCount, sizeof(H3Index));
+    t_assertSuccess(gridDisk(sunnyvale, k, disk));
+
+    // Reference result, sorted.
+    H3Index *expected = calloc(hexCount, sizeof(H3Index));
+    t_assertSuccess(compactCells(disk, expected, hexCount));
+    sortCells(expected, hexCount);
+    int64_t expectedCount = countNonNullIndexes(expected, hexCount);
+
+    TEST(sorted) {
+        H3Index *sorted = calloc(hexCount, sizeof(H3Index));
+        memcpy(sorted, disk, hexCount * sizeof(H3Index));
+        sortCells(sorted, hexCount);
+
+        H3Index *compacted = calloc(hexCount, sizeof(H3Index));
+        t_assertSuccess(compactSortedCells(sorted, compacted, hexCount));
+        for (int64_t i = 0; i < hexCount; i++) {
+            t_assert(compacted[i] == expected[i], "same compacted set");
+        }
+
+        free(compacted);
+        free(sorted);
+    }
+
+    TEST(unsorted) {
+        H3Index *compacted = calloc(hexCount, sizeof(H3Index));
+        t_assert(
+            compactSortedCells(disk, compacted, hexCount) == E_FAILED,
+            "unsorted input rejected");
+        free(compacted);
+    }
+
+    TEST(inPlace) {
+        H3Index *cells = calloc(hexCount, sizeof(H3Index));
+        memcpy(cells, disk, hexCount * sizeof(H3Index));
+
+        int64_t count;
+        t_assertSuccess(compactCellsInPlace(cells, hexCount, &count));
+        t_assert(count == expectedCount, "got expected compacted count");
+        for (int64_t i = 0; i < hexCount; i++) {
+            t_assert(cells[i] == expected[i], "same compacted set");
+        }
+
+        free(cells);
+    }
+
+    TEST(inPlaceDuplicate) {
+        H3Index cells[] = {sunnyvale, sunnyvale};
+        int64_t count;
+        t_assert(compactCellsInPlace(cells, ARRAY_SIZE(cells), &count) ==
+                     E_DUPLICATE_INPUT,
+                 "duplicates rejected");
+    }
+
+    TEST(inPlaceResMismatch) {
+        H3Index parent;
+        t_assertSuccess(cellToParent(sunnyvale, 8, &parent));
+        H3Index cells[] = {sunnyvale, parent};
+        int64_t count;
+        t_assert(compactCellsInPlace(cells, ARRAY_SIZE(cells), &count) ==
+                     E_RES_MISMATCH,
+                 "mixed resolutions rejected");
+    }
+
+    TEST(empty) {
+        int64_t count = -1;
+        t_assertSuccess(compactCellsInPlace(NULL, 0, &count));
+        t_assert(count == 0, "empty set");
+        t_assertSuccess(compactSortedCells(NULL, NULL, 0));
+    }
+
+    free(expected);
+    free(disk);
+}
@@ -0,0 +1,143 @@
+/** @file testCompactedCellsToLinkedMultiPolygon.c
+ * @brief Tests that `compactedCellsToLinkedMultiPolygon` describes the same
+ * outline as `cellsToLinkedMultiPolygon` on the uncompacted set
+ *
+ * usage: `testCompactedCellsToLinkedMultiPolygon`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "linkedGeo.h"
+#include "test.h"
+#include "utility.h"
+
+/** Counts the coordinates of every loop of every polygon. */
+static int countAllCoords(LinkedGeoPolygon *polygon) {
+    int count = 0;
+    for (; polygon != NULL; polygon = polygon->next) {
+        for (LinkedGeoLoop *loop = polygon->first; loop != NULL;
+             loop = loop->next) {
+            count += countLinkedCoords(loop);
+        }
+    }
+    return count;
+}
+
+/** Counts the loops of every polygon. */
+static int countAllLoops(LinkedGeoPolygon *polygon) {
+    int count = 0;
+    for (; polygon != NULL; polygon = polygon->next) {
+        count += countLinkedLoops(polygon);
+    }
+    return count;
+}
+
+/** Returns the (packed) disk of radius k around the origin. */
+static H3Index *disk(H3Index origin, int k, int64_t *numCells) {
+    int64_t size;
+    t_assertSuccess(maxGridDiskSize(k, &size));
+    H3Index *cells = calloc(size, sizeof(H3Index));
+    t_assertSuccess(gridDisk(origin, k, cells));
+    int64_t count = 0;
+    for (int64_t i = 0; i < size; i++) {
+        if (cells[i] != H3_NULL) {
+            cells[count++] = cells[i];
+        }
+    }
+    *numCells = count;
+    return cells;
+}
+
+/** Compacts the cells and checks the outline against the uncompacted one. */
+static void assertSameOutline(const H3Index *cells, int64_t numCells) {
+    H3Index *compacted = calloc(numCells, sizeof(H3Index));
+    t_assertSuccess(compactCells(cells, compacted, numCells));
+    int64_t numCompacted = 0;
+    for (int64_t i = 0; i < numCells; i++) {
+        if (compacted[i] != H3_NULL) {
+            compacted[numCompacted++] = compacted[i];
+        }
+    }
+
+    LinkedGeoPolygon expected, actual;
+    t_assertSuccess(cellsToLinkedMultiPolygon(cells, numCells, &expected));
+    t_assertSuccess(
+        compactedCellsToLinkedMultiPolygon(compacted, numCompacted, &actual));
+
+    t_assert(countLinkedPolygons(&expected) == countLinkedPolygons(&actual),
+             "same number of polygons");
+    t_assert(countAllLoops(&expected) == countAllLoops(&actual),
+             "same number of loops");
+    t_assert(countAllCoords(&expected) == countAllCoords(&actual),
+             "same number of coordinates");
+
+    destroyLinkedMultiPolygon(&actual);
+    destroyLinkedMultiPolygon(&expected);
+    free(compacted);
+}
+
+SUITE(compactedCellsToLinkedMultiPolygon) {
+    TEST(empty) {
+        LinkedGeoPolygon polygon;
+        t_assertSuccess(compactedCellsToLinkedMultiPolygon(NULL, 0, &polygon));
+        t_assert(countLinkedLoops(&polygon) == 0, "no loop");
+        destroyLinkedMultiPolygon(&polygon);
+    }
+
+    TEST(negativeCount) {
+        H3Index set[] = {0x890dab6220bffff};
+        LinkedGeoPolygon polygon;
+        t_assert(compactedCellsToLinkedMultiPolygon(set, -1, &polygon) ==
+                     E_DOMAIN,
+                 "negative count rejected");
+    }
+
+    TEST(singleCoarseCell) {
+        H3Index cell = 0x850dab63fffffff;
+        int64_t numChildren;
+        t_assertSuccess(cellToChildrenSize(cell, 8, &numChildren));
+        H3Index *children = calloc(numChildren, sizeof(H3Index));
+        t_assertSuccess(cellToChildren(cell, 8, children));
+
+        assertSameOutline(children, numChildren);
+
+        free(children);
+    }
+
+    TEST(disk) {
+        int64_t numCells;
+        H3Index *cells = disk(0x890dab6220bffff, 20, &numCells);
+
+        assertSameOutline(cells, numCells);
+
+        free(cells);
+    }
+
+    TEST(diskWithHole) {
+        int64_t numCells;
+        H3Index *cells = disk(0x890dab6220bffff, 20, &numCells);
+        // The origin comes first: drop it to open a hole.
+        assertSameOutline(cells + 1, numCells - 1);
+
+        free(cells);
+    }
+
+    TEST(overlappingCells) {
+        // A cell along with one of its children yields the cell outline.
+        H3Index set[] = {0x850dab63fffffff, 0x860dab61fffffff,
+                         0x850dab63fffffff};
+        LinkedGeoPolygon expected, actual;
+        t_assertSuccess(
+            compactedCellsToLinkedMultiPolygon(set, 1, &expected));
+        t_assertSuccess(compactedCellsToLinkedMultiPolygon(set, 3, &actual));
+
+        t_assert(countAllLoops(&expected) == countAllLoops(&actual),
+                 "same number of loops");
+        t_assert(countAllCoords(&expected) == countAllCoords(&actual),
+                 "same number of coordinates");
+
+        destroyLinkedMultiPolygon(&actual);
+        destroyLinkedMultiPolygon(&expected);
+    }
+}
@@ -0,0 +1,133 @@
+/** @file testCompactor.c
+ * @brief Tests the streaming compactor, `createCompactor`, `compactorPush`
+ * and `compactorFinish`
+ *
+ * usage: `testCompactor`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/**
+ * Checks that streaming a sorted set by chunks of `chunkSize` cells gives the
+ * output of compactSortedCells.
+ */
+static void assertSameCompaction(H3Index *cells, int64_t numCells, int res,
+                                 int64_t chunkSize) {
+    H3Index *expected = calloc(numCells, sizeof(H3Index));
+    t_assertSuccess(compactSortedCells(cells, expected, numCells));
+    int64_t numExpected = 0;
+    while (numExpected < numCells && expected[numExpected] != H3_NULL) {
+        numExpected++;
+    }
+
+    H3Compactor *compactor;
+    t_assertSuccess(createCompactor(res, &compactor));
+    H3Index *compacted =
+        calloc(numCells + H3_COMPACTOR_MAX_PENDING, sizeof(H3Index));
+    H3Index *out =
+        calloc(chunkSize + H3_COMPACTOR_MAX_PENDING, sizeof(H3Index));
+    int64_t count = 0, numOut;
+    for (int64_t i = 0; i < numCells; i += chunkSize) {
+        int64_t size = numCells - i < chunkSize ? numCells - i : chunkSize;
+        t_assertSuccess(compactorPush(compactor, cells + i, size, out,
+                                      size + H3_COMPACTOR_MAX_PENDING,
+                                      &numOut));
+        memcpy(compacted + count, out, numOut * sizeof(H3Index));
+        count += numOut;
+    }
+    t_assertSuccess(compactorFinish(compactor, out, &numOut));
+    t_assert(numOut <= H3_COMPACTOR_MAX_PENDING, "bounded pending cells");
+    memcpy(compacted + count, out, numOut * sizeof(H3Index));
+    count += numOut;
+    destroyCompactor(compactor);
+
+    t_assert(count == numExpected, "same number of compacted cells");
+    t_assert(memcmp(compacted, expected, count * sizeof(H3Index)) == 0,
+             "same compacted cells, in the same order");
+    free(out);
+    free(compacted);
+    free(expected);
+}
+
+/** Returns the sorted children of a cell, minus every `holeEvery`-th one. */
+static H3Index *sortedChildren(H3Index parent, int res, int64_t holeEvery,
+                               int64_t *numCells) {
+    int64_t size;
+    t_assertSuccess(cellToChildrenSize(parent, res, &size));
+    H3Index *cells = calloc(size, sizeof(H3Index));
+    t_assertSuccess(cellToChildren(parent, res, cells));
+    int64_t count = 0;
+    for (int64_t i = 0; i < size; i++) {
+        if (holeEvery == 0 || i % holeEvery != holeEvery - 1) {
+            cells[count++] = cells[i];
+        }
+    }
+    qsort(cells, count, sizeof(H3Index), compareCells);
+    *numCells = count;
+    return cells;
+}
+
+SUITE(compactor) {
+    TEST(matchesCompactSortedCells) {
+        const H3Index parents[] = {0x85283473fffffff, 0x8009fffffffffff};
+        const int resolutions[] = {8, 4};
+        const int64_t holes[] = {0, 5, 50, 343};
+        const int64_t chunkSizes[] = {1, 7, 1000, 1000000};
+        for (int p = 0; p < 2; p++) {
+            for (int h = 0; h < 4; h++) {
+                int64_t numCells;
+                H3Index *cells = sortedChildren(parents[p], resolutions[p],
+                                                holes[h], &numCells);
+                for (int c = 0; c < 4; c++) {
+                    assertSameCompaction(cells, numCells, resolutions[p],
+                                         chunkSizes[c]);
+                }
+                free(cells);
+            }
+        }
+    }
+
+    TEST(invalidInput) {
+        H3Compactor *compactor;
+        t_assert(createCompactor(16, &compactor) == E_RES_DOMAIN,
+                 "invalid resolution");
+        t_assertSuccess(createCompactor(9, &compactor));
+
+        int64_t numCells;
+        H3Index *cells = sortedChildren(0x85283473fffffff, 9, 0, &numCells);
+        H3Index out[H3_COMPACTOR_MAX_PENDING + 2];
+        int64_t numOut;
+        t_assert(compactorPush(compactor, cells, 2, out,
+                               H3_COMPACTOR_MAX_PENDING + 1,
+                               &numOut) == E_MEMORY_BOUNDS,
+                 "output bound is checked");
+        t_assertSuccess(compactorPush(compactor, cells + 1, 2, out,
+                                      H3_COMPACTOR_MAX_PENDING + 2, &numOut));
+        t_assert(compactorPush(compactor, cells, 1, out,
+                               H3_COMPACTOR_MAX_PENDING + 1,
+                               &numOut) == E_FAILED,
+                 "not sorted across chunks");
+        t_assert(compactorPush(compactor, cells + 2, 1, out,
+                               H3_COMPACTOR_MAX_PENDING + 1,
+                               &numOut) == E_DUPLICATE_INPUT,
+                 "duplicate across chunks");
+        H3Index coarse = 0x85283473fffffff;
+        t_assert(compactorPush(compactor, &coarse, 1, out,
+                               H3_COMPACTOR_MAX_PENDING + 1,
+                               &numOut) == E_RES_MISMATCH,
+                 "resolution mismatch");
+
+        // The compactor is left untouched by the errors.
+        t_assertSuccess(compactorFinish(compactor, out, &numOut));
+        t_assert(numOut == 2 && out[0] == cells[1] && out[1] == cells[2],
+                 "pushed cells only");
+        destroyCompactor(compactor);
+        destroyCompactor(NULL);
+        free(cells);
+    }
+}
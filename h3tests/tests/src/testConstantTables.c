@@ -0,0 +1,84 @@
+/** @file testConstantTables.c
+ * @brief Tests the constant tables (`H3_RES0_CELLS`, `H3_PENTAGONS`,
+ * `H3_NUM_CELLS`), `getResolutionStats` and `isPentagonNeighbor`
+ *
+ * usage: `testConstantTables`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+SUITE(constantTables) {
+    TEST(res0Cells) {
+        t_assert(H3_RES0_CELL_COUNT == res0CellCount(), "same count");
+        H3Index cells[H3_RES0_CELL_COUNT];
+        t_assertSuccess(getRes0Cells(cells));
+        for (int i = 0; i < H3_RES0_CELL_COUNT; i++) {
+            t_assert(H3_RES0_CELLS[i] == cells[i], "same base cell");
+        }
+    }
+
+    TEST(pentagons) {
+        t_assert(H3_PENTAGON_COUNT == pentagonCount(), "same count");
+        for (int res = 0; res < H3_RES_COUNT; res++) {
+            H3Index pentagons[H3_PENTAGON_COUNT];
+            t_assertSuccess(getPentagons(res, pentagons));
+            for (int i = 0; i < H3_PENTAGON_COUNT; i++) {
+                t_assert(H3_PENTAGONS[res][i] == pentagons[i],
+                         "same pentagon");
+            }
+        }
+    }
+
+    TEST(resolutionStats) {
+        H3ResolutionStats stats;
+        t_assertSuccess(getResolutionStats(&stats));
+        for (int res = 0; res < H3_RES_COUNT; res++) {
+            int64_t numCells;
+            double value;
+            t_assertSuccess(getNumCells(res, &numCells));
+            t_assert(H3_NUM_CELLS[res] == numCells, "same cell count");
+            t_assertSuccess(getHexagonAreaAvgKm2(res, &value));
+            t_assert(stats.hexagonAreaAvgKm2[res] == value, "same area");
+            t_assertSuccess(getHexagonAreaAvgM2(res, &value));
+            t_assert(stats.hexagonAreaAvgM2[res] == value, "same area");
+            t_assertSuccess(getHexagonEdgeLengthAvgKm(res, &value));
+            t_assert(stats.hexagonEdgeLengthAvgKm[res] == value,
+                     "same edge length");
+            t_assertSuccess(getHexagonEdgeLengthAvgM(res, &value));
+            t_assert(stats.hexagonEdgeLengthAvgM[res] == value,
+                     "same edge length");
+        }
+    }
+
+    TEST(isPentagonNeighbor) {
+        // From resolution 5, pentagons are far apart from each other.
+        for (int res = 5; res < H3_RES_COUNT; res += 5) {
+            for (int i = 0; i < H3_PENTAGON_COUNT; i++) {
+                // The pentagon, its neighbors and the second ring.
+                H3Index disk[19] = {0};
+                int distances[19];
+                t_assertSuccess(
+                    gridDiskDistances(H3_PENTAGONS[res][i], 2, disk,
+                                      distances));
+                for (int j = 0; j < 19; j++) {
+                    if (disk[j] == H3_NULL) {
+                        continue;
+                    }
+                    int out;
+                    t_assertSuccess(isPentagonNeighbor(disk[j], &out));
+                    t_assert(out == (distances[j] == 1), "neighbor flag");
+                }
+            }
+        }
+
+        int out;
+        t_assertSuccess(isPentagonNeighbor(0x8928308280fffff, &out));
+        t_assert(out == 0, "far from any pentagon");
+        t_assert(isPentagonNeighbor(0, &out) == E_CELL_INVALID,
+                 "invalid cell");
+    }
+}
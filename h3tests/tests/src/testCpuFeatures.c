@@ -0,0 +1,83 @@
+/** @file testCpuFeatures.c
+ * @brief Tests that the batch kernels give the same results whatever the
+ * instruction set they are dispatched to
+ *
+ * usage: `testCpuFeatures`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define NUM_CELLS 1000
+
+static const uint32_t featureSets[] = {0, H3_CPU_AVX2,
+                                       H3_CPU_AVX2 | H3_CPU_AVX512};
+
+/** Valid cells of every resolution, mixed with corrupted ones. */
+static void makeCells(H3Index *cells) {
+    H3Index center = 0x8f2830828052d25;
+    uint64_t state = 42;
+    for (int i = 0; i < NUM_CELLS; i++) {
+        t_assertSuccess(cellToParent(center, i % 16, &cells[i]));
+        state = state * 6364136223846793005 + 1442695040888963407;
+        if (i % 7 == 0) {
+            cells[i] ^= (H3Index)1 << (state >> 58);
+        }
+    }
+}
+
+SUITE(cpuFeatures) {
+    H3Index cells[NUM_CELLS];
+    makeCells(cells);
+
+    TEST(getCpuFeatures) {
+        h3SetCpuFeatures(0);
+        t_assert(h3GetCpuFeatures() == 0, "baseline only");
+        h3SetCpuFeatures(UINT32_MAX);
+        t_assert((h3GetCpuFeatures() & ~(H3_CPU_AVX2 | H3_CPU_AVX512)) == 0,
+                 "known features");
+    }
+
+    TEST(areValidCells) {
+        uint8_t expected[NUM_CELLS], actual[NUM_CELLS];
+        for (int i = 0; i < NUM_CELLS; i++) {
+            expected[i] = (uint8_t)isValidCell(cells[i]);
+        }
+        for (size_t f = 0; f < sizeof(featureSets) / sizeof(featureSets[0]);
+             f++) {
+            h3SetCpuFeatures(featureSets[f]);
+            memset(actual, 0xff, sizeof(actual));
+            t_assertSuccess(areValidCells(cells, NUM_CELLS, actual));
+            t_assert(memcmp(expected, actual, sizeof(actual)) == 0,
+                     "same validity");
+        }
+        h3SetCpuFeatures(UINT32_MAX);
+    }
+
+    TEST(cellsToParents) {
+        H3Index expected[NUM_CELLS], actual[NUM_CELLS];
+        h3SetCpuFeatures(0);
+        H3Error expectedErr = cellsToParents(cells, NUM_CELLS, 5, expected);
+        for (size_t f = 1; f < sizeof(featureSets) / sizeof(featureSets[0]);
+             f++) {
+            h3SetCpuFeatures(featureSets[f]);
+            t_assert(cellsToParents(cells, NUM_CELLS, 5, actual) == expectedErr,
+                     "same error");
+            t_assert(memcmp(expected, actual, sizeof(actual)) == 0,
+                     "same parents");
+        }
+        h3SetCpuFeatures(UINT32_MAX);
+
+        for (int i = 0; i < NUM_CELLS; i++) {
+            H3Index parent = H3_NULL;
+            if (cellToParent(cells[i], 5, &parent) != E_SUCCESS) {
+                parent = H3_NULL;
+            }
+            t_assert(parent == expected[i], "same as cellToParent");
+        }
+    }
+}
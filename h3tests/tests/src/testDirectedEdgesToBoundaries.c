@@ -0,0 +1,95 @@
+/** @file testDirectedEdgesToBoundaries.c
+ * @brief Tests the packed, batch version of `directedEdgeToBoundary`
+ *
+ * usage: `testDirectedEdgesToBoundaries`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+
+/** Checks the packed boundaries of every edge of a cell's children. */
+static void assertMatchesDirectedEdgeToBoundary(H3Index parent,
+                                                int childRes) {
+    int64_t numCells;
+    t_assertSuccess(cellToChildrenSize(parent, childRes, &numCells));
+    H3Index *cells = calloc(numCells, sizeof(H3Index));
+    t_assertSuccess(cellToChildren(parent, childRes, cells));
+
+    // Pentagons have a H3_NULL edge, which is skipped.
+    int64_t numEdges = 6 * numCells;
+    H3Index *edges = calloc(numEdges, sizeof(H3Index));
+    originsToDirectedEdges(cells, numCells, edges);
+    int64_t count = 0;
+    for (int64_t i = 0; i < numEdges; i++) {
+        if (edges[i] != H3_NULL) {
+            edges[count++] = edges[i];
+        }
+    }
+    numEdges = count;
+
+    int64_t maxVerts = 3 * numEdges;
+    LatLng *verts = calloc(maxVerts, sizeof(LatLng));
+    int64_t *offsets = calloc(numEdges + 1, sizeof(int64_t));
+    t_assertSuccess(
+        directedEdgesToBoundaries(edges, numEdges, verts, maxVerts, offsets));
+
+    t_assert(offsets[0] == 0, "offsets start at 0");
+    for (int64_t i = 0; i < numEdges; i++) {
+        CellBoundary expected;
+        t_assertSuccess(directedEdgeToBoundary(edges[i], &expected));
+        t_assert(offsets[i + 1] - offsets[i] == expected.numVerts,
+                 "same number of vertices");
+        for (int v = 0; v < expected.numVerts; v++) {
+            LatLng vertex = verts[offsets[i] + v];
+            t_assert(vertex.lat == expected.verts[v].lat &&
+                         vertex.lng == expected.verts[v].lng,
+                     "same vertex");
+        }
+    }
+
+    free(offsets);
+    free(verts);
+    free(edges);
+    free(cells);
+}
+
+SUITE(directedEdgesToBoundaries) {
+    TEST(hexagon) {
+        assertMatchesDirectedEdgeToBoundary(0x85283473fffffff, 8);
+    }
+
+    TEST(pentagon) {
+        // Class II and class III resolutions (distortion vertices).
+        assertMatchesDirectedEdgeToBoundary(0x8009fffffffffff, 2);
+        assertMatchesDirectedEdgeToBoundary(0x8009fffffffffff, 3);
+    }
+
+    TEST(bufferTooSmall) {
+        H3Index edges[6];
+        t_assertSuccess(originToDirectedEdges(0x85283473fffffff, edges));
+        LatLng verts[3];
+        int64_t offsets[3];
+        t_assert(directedEdgesToBoundaries(edges, 2, verts, 3, offsets) ==
+                     E_MEMORY_BOUNDS,
+                 "vertex buffer bound is checked");
+    }
+
+    TEST(invalidEdge) {
+        H3Index edges[3];
+        t_assertSuccess(
+            cellsToDirectedEdge(0x85283473fffffff, 0x85283447fffffff,
+                                &edges[0]));
+        edges[1] = 0x85283473fffffff;
+        edges[2] = edges[0];
+        LatLng verts[9];
+        int64_t offsets[4];
+        t_assert(directedEdgesToBoundaries(edges, 3, verts, 9, offsets) ==
+                     E_DIR_EDGE_INVALID,
+                 "invalid edge reported");
+        t_assert(offsets[2] == offsets[1], "invalid edge has no vertex");
+        t_assert(offsets[3] - offsets[2] == offsets[1],
+                 "batch continues after an invalid edge");
+    }
+}
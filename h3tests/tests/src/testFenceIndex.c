@@ -0,0 +1,91 @@
+/** @file testFenceIndex.c
+ * @brief Tests the `H3FenceIndex` point-in-coverage lookups
+ *
+ * usage: `testFenceIndex`
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+SUITE(fenceIndex) {
+    // Fence 10: a res 5 cell, fence 20: one of its res 7 descendants (plus an
+    // unrelated cell), fence 30: a disjoint res 5 cell.
+    H3Index coarse = 0x85283473fffffff;
+    H3Index fine = 0x872834700ffffff;
+    H3Index other = 0x8528347bfffffff;
+    H3Index cells[] = {coarse, H3_NULL, fine, 0x8001fffffffffff, other};
+    int64_t fenceOffsets[] = {0, 2, 4, 5};
+    int64_t ids[] = {10, 20, 30};
+
+    TEST(lookups) {
+        H3FenceIndex *index;
+        t_assertSuccess(createFenceIndex(cells, fenceOffsets, ids, 3, &index));
+
+        LatLng points[4];
+        t_assertSuccess(cellToLatLng(fine, &points[0]));
+        t_assertSuccess(cellToLatLng(0x872834701ffffff, &points[1]));
+        t_assertSuccess(cellToLatLng(other, &points[2]));
+        points[3].lat = 0.0;
+        points[3].lng = 0.0;
+
+        int64_t out[8];
+        int64_t offsets[5];
+        t_assertSuccess(latLngsToFenceIds(index, points, 4, out, 8, offsets));
+        t_assert(offsets[1] == 2 && out[0] == 10 && out[1] == 20,
+                 "point in nested fences");
+        t_assert(offsets[2] == 3 && out[2] == 10, "point in coarse fence");
+        t_assert(offsets[3] == 4 && out[3] == 30, "point in disjoint fence");
+        t_assert(offsets[4] == 4, "point outside every fence");
+
+        t_assert(
+            latLngsToFenceIds(index, points, 4, out, 3, offsets) ==
+                E_MEMORY_BOUNDS,
+            "output too small");
+        t_assert(offsets[4] == 4, "required size is reported");
+
+        destroyFenceIndex(index);
+    }
+
+    TEST(invalidPoint) {
+        H3FenceIndex *index;
+        t_assertSuccess(createFenceIndex(cells, fenceOffsets, ids, 3, &index));
+
+        LatLng points[2];
+        points[0].lat = NAN;
+        points[0].lng = 0.0;
+        t_assertSuccess(cellToLatLng(other, &points[1]));
+        int64_t out[2];
+        int64_t offsets[3];
+        t_assert(latLngsToFenceIds(index, points, 2, out, 2, offsets) ==
+                     E_LATLNG_DOMAIN,
+                 "invalid point reported");
+        t_assert(offsets[1] == 0, "invalid point in no fence");
+        t_assert(offsets[2] == 1 && out[0] == 30, "batch continues");
+
+        destroyFenceIndex(index);
+    }
+
+    TEST(invalidInputs) {
+        H3FenceIndex *index;
+        H3Index invalid[] = {0x1};
+        int64_t one[] = {0, 1};
+        t_assert(createFenceIndex(invalid, one, ids, 1, &index) ==
+                     E_CELL_INVALID,
+                 "invalid cell rejected");
+        int64_t unsorted[] = {2, 1};
+        t_assert(createFenceIndex(cells, unsorted, ids, 1, &index) == E_DOMAIN,
+                 "unsorted offsets rejected");
+
+        t_assertSuccess(createFenceIndex(NULL, NULL, NULL, 0, &index));
+        LatLng point = {0.0, 0.0};
+        int64_t offsets[2];
+        t_assertSuccess(latLngsToFenceIds(index, &point, 1, NULL, 0, offsets));
+        t_assert(offsets[1] == 0, "empty index contains nothing");
+        destroyFenceIndex(index);
+        destroyFenceIndex(NULL);
+    }
+}
@@ -0,0 +1,166 @@
+/** @file testForEach.c
+ * @brief Tests the functions handing their cells over to a visitor
+ *
+ * usage: `testForEach`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static GeoLoop sfGeoLoop = {.numVerts = 6, .verts = sfVerts};
+
+/** Cells collected by the visitor. */
+typedef struct {
+    H3Index *cells;
+    int64_t count;
+    int64_t calls;
+    /** Number of calls after which the visit is stopped (0 for never). */
+    int64_t stopAfter;
+} Collected;
+
+static int collect(const H3Index *cells, int64_t count, void *context) {
+    Collected *collected = context;
+    t_assert(count > 0 && count <= H3_VISIT_BATCH_SIZE, "bounded batch");
+    memcpy(collected->cells + collected->count, cells,
+           count * sizeof(H3Index));
+    collected->count += count;
+    collected->calls++;
+    return collected->stopAfter != 0 &&
+           collected->calls == collected->stopAfter;
+}
+
+/**
+ * Checks that the visited cells are the non-null cells of `expected`, in any
+ * order.
+ */
+static void assertSameCells(H3Index *expected, int64_t size,
+                            Collected *collected) {
+    int64_t count = 0;
+    for (int64_t i = 0; i < size; i++) {
+        if (expected[i] != H3_NULL) {
+            expected[count++] = expected[i];
+        }
+    }
+    t_assert(collected->count == count, "same number of cells");
+    qsort(expected, count, sizeof(H3Index), compareCells);
+    qsort(collected->cells, count, sizeof(H3Index), compareCells);
+    t_assert(memcmp(expected, collected->cells, count * sizeof(H3Index)) == 0,
+             "same cells");
+}
+
+/** Checks gridDiskForEach against gridDisk. */
+static void assertSameDisk(H3Index origin, int k) {
+    int64_t size;
+    t_assertSuccess(maxGridDiskSize(k, &size));
+    H3Index *expected = calloc(size, sizeof(H3Index));
+    Collected collected = {.cells = calloc(size, sizeof(H3Index))};
+    t_assertSuccess(gridDisk(origin, k, expected));
+    t_assertSuccess(gridDiskForEach(origin, k, collect, &collected));
+    assertSameCells(expected, size, &collected);
+    free(collected.cells);
+    free(expected);
+}
+
+SUITE(forEach) {
+    TEST(gridDisk) {
+        assertSameDisk(0x8928308280fffff, 0);
+        assertSameDisk(0x8928308280fffff, 2);
+        assertSameDisk(0x8928308280fffff, 20);
+        assertSameDisk(0x821c07fffffffff, 1);
+
+        // Pentagon 10 cells away: the fallback happens after some batches
+        // were handed over.
+        H3Index disk[331];
+        int distances[331];
+        t_assertSuccess(
+            gridDiskDistances(0x821c07fffffffff, 10, disk, distances));
+        H3Index origin = H3_NULL;
+        for (int i = 0; i < 331 && origin == H3_NULL; i++) {
+            if (distances[i] == 10) {
+                origin = disk[i];
+            }
+        }
+        assertSameDisk(origin, 12);
+
+        Collected collected = {.cells = calloc(1000, sizeof(H3Index))};
+        t_assert(gridDiskForEach(0x8928308280fffff, -1, collect, &collected) ==
+                     E_DOMAIN,
+                 "negative k");
+        t_assert(gridDiskForEach(0, 1, collect, &collected) == E_CELL_INVALID,
+                 "invalid origin");
+        t_assert(gridDiskForEach(0x8928308280fffff, 1, NULL, NULL) == E_FAILED,
+                 "visitor required");
+        t_assert(collected.calls == 0, "nothing visited");
+        free(collected.cells);
+    }
+
+    TEST(cellToChildren) {
+        const H3Index parents[] = {0x88283080ddfffff, 0x8009fffffffffff};
+        for (int p = 0; p < 2; p++) {
+            int64_t size;
+            t_assertSuccess(cellToChildrenSize(parents[p], 4, &size));
+            H3Index *expected = calloc(size, sizeof(H3Index));
+            Collected collected = {.cells = calloc(size, sizeof(H3Index))};
+            t_assertSuccess(cellToChildren(parents[p], 4, expected));
+            t_assertSuccess(
+                cellToChildrenForEach(parents[p], 4, collect, &collected));
+            assertSameCells(expected, size, &collected);
+            free(collected.cells);
+            free(expected);
+        }
+
+        H3Index child;
+        Collected collected = {.cells = &child};
+        t_assertSuccess(
+            cellToChildrenForEach(0x88283080ddfffff, 7, collect, &collected));
+        t_assert(collected.calls == 0, "no child at a coarser resolution");
+        t_assert(cellToChildrenForEach(0x88283080ddfffff, 16, collect,
+                                       &collected) == E_RES_DOMAIN,
+                 "invalid resolution");
+    }
+
+    TEST(polygonToCells) {
+        GeoPolygon sfGeoPolygon = {.geoloop = sfGeoLoop, .numHoles = 0};
+        int64_t size;
+        t_assertSuccess(maxPolygonToCellsSize(&sfGeoPolygon, 9, 0, &size));
+        H3Index *expected = calloc(size, sizeof(H3Index));
+        Collected collected = {.cells = calloc(size, sizeof(H3Index))};
+        t_assertSuccess(polygonToCells(&sfGeoPolygon, 9, 0, expected));
+        t_assertSuccess(
+            polygonToCellsForEach(&sfGeoPolygon, 9, 0, collect, &collected));
+        t_assert(collected.calls > 1, "several batches");
+        assertSameCells(expected, size, &collected);
+
+        t_assert(polygonToCellsForEach(NULL, 9, 0, collect, &collected) ==
+                     E_FAILED,
+                 "polygon required");
+        free(collected.cells);
+        free(expected);
+    }
+
+    TEST(stop) {
+        GeoPolygon sfGeoPolygon = {.geoloop = sfGeoLoop, .numHoles = 0};
+        int64_t size;
+        t_assertSuccess(maxPolygonToCellsSize(&sfGeoPolygon, 9, 0, &size));
+        Collected collected = {.cells = calloc(size, sizeof(H3Index)),
+                               .stopAfter = 1};
+        t_assertSuccess(
+            polygonToCellsForEach(&sfGeoPolygon, 9, 0, collect, &collected));
+        t_assert(collected.calls == 1, "stopped after the first batch");
+        t_assert(collected.count == H3_VISIT_BATCH_SIZE, "one full batch");
+
+        collected.count = collected.calls = 0;
+        t_assertSuccess(
+            gridDiskForEach(0x8928308280fffff, 20, collect, &collected));
+        t_assert(collected.calls == 1, "stopped after the first batch");
+        free(collected.cells);
+    }
+}
@@ -0,0 +1,57 @@
+/** @file testGetIcosahedronFaceMasks.c
+ * @brief Tests the batch, bit mask version of `getIcosahedronFaces`
+ *
+ * usage: `testGetIcosahedronFaceMasks`
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+
+/** Returns the faces of a cell as a bit mask, from getIcosahedronFaces. */
+static uint32_t expectedMask(H3Index cell) {
+    int count;
+    t_assertSuccess(maxFaceCount(cell, &count));
+    int *faces = calloc(count, sizeof(int));
+    t_assertSuccess(getIcosahedronFaces(cell, faces));
+    uint32_t mask = 0;
+    for (int i = 0; i < count; i++) {
+        if (faces[i] >= 0) {
+            mask |= 1u << faces[i];
+        }
+    }
+    free(faces);
+    return mask;
+}
+
+SUITE(getIcosahedronFaceMasks) {
+    TEST(matchesGetIcosahedronFaces) {
+        // Every base cell (including the pentagons, on 5 faces) and some
+        // children.
+        H3Index cells[122 + 7];
+        t_assertSuccess(getRes0Cells(cells));
+        t_assertSuccess(cellToChildren(0x85283473fffffff, 6, cells + 122));
+        uint32_t masks[122 + 7];
+        t_assertSuccess(getIcosahedronFaceMasks(cells, 122 + 7, masks));
+        for (int i = 0; i < 122 + 7; i++) {
+            t_assert(masks[i] == expectedMask(cells[i]), "same faces");
+            t_assert(masks[i] != 0 && masks[i] < (1u << 20), "valid mask");
+        }
+    }
+
+    TEST(invalid) {
+        H3Index cells[3] = {0x85283473fffffff, 0x7fffffffffffffff,
+                            0x85283473fffffff};
+        uint32_t masks[3];
+        t_assert(getIcosahedronFaceMasks(cells, 3, masks) == E_CELL_INVALID,
+                 "invalid cell reported");
+        t_assert(masks[1] == 0, "no face for an invalid cell");
+        t_assert(masks[0] == expectedMask(cells[0]) && masks[2] == masks[0],
+                 "batch carried on");
+        t_assertSuccess(getIcosahedronFaceMasks(NULL, 0, NULL));
+        t_assert(getIcosahedronFaceMasks(cells, -1, masks) == E_DOMAIN,
+                 "negative size");
+    }
+}
@@ -0,0 +1,104 @@
+/** @file testGetResolutionCells.c
+ * @brief Tests the whole-resolution enumeration `getResolutionCells` and its
+ * partitions, `getResolutionPartitionStart`
+ *
+ * usage: `testGetResolutionCells`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/** Returns every cell of a resolution, from the children of the base cells. */
+static H3Index *expectedCells(int res, int64_t *numCells) {
+    t_assertSuccess(getNumCells(res, numCells));
+    H3Index *cells = calloc(*numCells, sizeof(H3Index));
+    H3Index baseCells[122];
+    t_assertSuccess(getRes0Cells(baseCells));
+    int64_t count = 0;
+    for (int i = 0; i < 122; i++) {
+        int64_t size;
+        t_assertSuccess(cellToChildrenSize(baseCells[i], res, &size));
+        t_assertSuccess(cellToChildren(baseCells[i], res, cells + count));
+        count += size;
+    }
+    t_assert(count == *numCells, "every cell");
+    return cells;
+}
+
+SUITE(getResolutionCells) {
+    TEST(wholeResolution) {
+        for (int res = 0; res <= 2; res++) {
+            int64_t numCells;
+            H3Index *expected = expectedCells(res, &numCells);
+            H3Index *cells = calloc(numCells, sizeof(H3Index));
+            t_assertSuccess(getResolutionCells(res, 0, numCells, cells));
+            t_assert(memcmp(cells, expected, numCells * sizeof(H3Index)) == 0,
+                     "same cells, in order");
+            free(cells);
+            free(expected);
+        }
+    }
+
+    TEST(partitions) {
+        const int res = 3;
+        const int64_t numPartitions = 7;
+        int64_t numCells;
+        H3Index *expected = expectedCells(res, &numCells);
+        H3Index *cells = calloc(numCells, sizeof(H3Index));
+
+        int64_t end;
+        t_assertSuccess(getResolutionPartitionStart(res, numPartitions,
+                                                    numPartitions, &end));
+        t_assert(end == numCells, "last partition ends at the cell count");
+        for (int64_t i = 0; i < numPartitions; i++) {
+            int64_t start, next;
+            t_assertSuccess(
+                getResolutionPartitionStart(res, i, numPartitions, &start));
+            t_assertSuccess(getResolutionPartitionStart(res, i + 1,
+                                                        numPartitions, &next));
+            int64_t size = next - start;
+            t_assert(size == numCells / numPartitions ||
+                         size == numCells / numPartitions + 1,
+                     "equal-size partitions");
+            t_assertSuccess(
+                getResolutionCells(res, start, size, cells + start));
+        }
+        t_assert(memcmp(cells, expected, numCells * sizeof(H3Index)) == 0,
+                 "partitions cover the resolution, in order");
+
+        // Slice across base cells, starting in a pentagon (base cell 4).
+        int64_t baseCellSize;
+        t_assertSuccess(
+            cellToChildrenSize(0x8009fffffffffff, res, &baseCellSize));
+        const int64_t start = 4 * 343 + baseCellSize - 2;
+        t_assertSuccess(getResolutionCells(res, start, 5, cells));
+        t_assert(memcmp(cells, expected + start, 5 * sizeof(H3Index)) == 0,
+                 "same slice");
+
+        free(cells);
+        free(expected);
+    }
+
+    TEST(outOfRange) {
+        int64_t numCells;
+        t_assertSuccess(getNumCells(1, &numCells));
+        H3Index cells[2];
+        t_assertSuccess(getResolutionCells(1, numCells, 0, cells));
+        t_assert(getResolutionCells(1, numCells - 1, 2, cells) == E_DOMAIN,
+                 "past the last cell");
+        t_assert(getResolutionCells(1, -1, 1, cells) == E_DOMAIN,
+                 "negative start");
+        t_assert(getResolutionCells(16, 0, 1, cells) == E_RES_DOMAIN,
+                 "invalid resolution");
+
+        int64_t start;
+        t_assert(getResolutionPartitionStart(1, 3, 2, &start) == E_DOMAIN,
+                 "partition out of range");
+        t_assert(getResolutionPartitionStart(1, 0, 0, &start) == E_DOMAIN,
+                 "no partition");
+    }
+}
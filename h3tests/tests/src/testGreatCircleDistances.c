@@ -0,0 +1,104 @@
+/** @file testGreatCircleDistances.c
+ * @brief Tests the batch `greatCircleDistances*` and
+ * `greatCircleDistanceMatrix*`
+ *
+ * usage: `testGreatCircleDistances`
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define NUM_ORIGINS 7
+#define NUM_POINTS 50
+#define EPSILON 1e-9
+
+static int closeEnough(double actual, double expected) {
+    return fabs(actual - expected) <= EPSILON * fmax(fabs(expected), 1.0);
+}
+
+SUITE(greatCircleDistances) {
+    LatLng origins[NUM_ORIGINS];
+    double originLats[NUM_ORIGINS], originLngs[NUM_ORIGINS];
+    for (int i = 0; i < NUM_ORIGINS; i++) {
+        randomGeo(&origins[i]);
+        originLats[i] = origins[i].lat;
+        originLngs[i] = origins[i].lng;
+    }
+    LatLng points[NUM_POINTS];
+    double lats[NUM_POINTS], lngs[NUM_POINTS];
+    for (int i = 0; i < NUM_POINTS; i++) {
+        randomGeo(&points[i]);
+        lats[i] = points[i].lat;
+        lngs[i] = points[i].lng;
+    }
+
+    TEST(oneToMany) {
+        double km[NUM_POINTS], m[NUM_POINTS], rads[NUM_POINTS];
+        t_assertSuccess(
+            greatCircleDistancesKm(&origins[0], lats, lngs, NUM_POINTS, km));
+        t_assertSuccess(
+            greatCircleDistancesM(&origins[0], lats, lngs, NUM_POINTS, m));
+        t_assertSuccess(
+            greatCircleDistancesRads(&origins[0], lats, lngs, NUM_POINTS, rads));
+        for (int i = 0; i < NUM_POINTS; i++) {
+            t_assert(closeEnough(km[i], greatCircleDistanceKm(&origins[0],
+                                                              &points[i])),
+                     "same distance in km");
+            t_assert(
+                closeEnough(m[i], greatCircleDistanceM(&origins[0], &points[i])),
+                "same distance in m");
+            t_assert(closeEnough(rads[i], greatCircleDistanceRads(&origins[0],
+                                                                  &points[i])),
+                     "same distance in rads");
+        }
+    }
+
+    TEST(matrix) {
+        double m[NUM_ORIGINS * NUM_POINTS];
+        t_assertSuccess(greatCircleDistanceMatrixM(originLats, originLngs,
+                                                   NUM_ORIGINS, lats, lngs,
+                                                   NUM_POINTS, m));
+        for (int i = 0; i < NUM_ORIGINS; i++) {
+            for (int j = 0; j < NUM_POINTS; j++) {
+                t_assert(closeEnough(m[i * NUM_POINTS + j],
+                                     greatCircleDistanceM(&origins[i],
+                                                          &points[j])),
+                         "same distance");
+            }
+        }
+
+        double km[NUM_ORIGINS * NUM_POINTS];
+        double rads[NUM_ORIGINS * NUM_POINTS];
+        t_assertSuccess(greatCircleDistanceMatrixKm(originLats, originLngs,
+                                                    NUM_ORIGINS, lats, lngs,
+                                                    NUM_POINTS, km));
+        t_assertSuccess(greatCircleDistanceMatrixRads(originLats, originLngs,
+                                                      NUM_ORIGINS, lats, lngs,
+                                                      NUM_POINTS, rads));
+        t_assert(closeEnough(km[3], m[3] / 1000.0), "km matches m");
+        t_assert(closeEnough(rads[3], greatCircleDistanceRads(&origins[0],
+                                                              &points[3])),
+                 "same distance in rads");
+    }
+
+    TEST(invalidCoordinates) {
+        double badLats[] = {0.5, NAN, 0.1};
+        double badLngs[] = {0.5, 0.2, INFINITY};
+        double out[3];
+        t_assert(greatCircleDistancesM(&origins[0], badLats, badLngs, 3, out) ==
+                     E_LATLNG_DOMAIN,
+                 "invalid coordinates reported");
+        t_assert(!isnan(out[0]), "batch continues");
+        t_assert(isnan(out[1]) && isnan(out[2]), "invalid points have NaN");
+
+        LatLng badOrigin = {NAN, 0.0};
+        t_assert(greatCircleDistancesM(&badOrigin, lats, lngs, 3, out) ==
+                     E_LATLNG_DOMAIN,
+                 "invalid origin reported");
+        t_assert(isnan(out[0]), "invalid origin has NaN");
+    }
+}
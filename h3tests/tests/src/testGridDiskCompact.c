@@ -0,0 +1,70 @@
+/** @file testGridDiskCompact.c
+ * @brief Tests the dense `gridDiskCompact` output
+ *
+ * usage: `testGridDiskCompact`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/** Checks that gridDiskCompact returns the same cells than gridDisk. */
+static void assertSameAsGridDisk(H3Index origin, int k) {
+    int64_t size;
+    t_assertSuccess(maxGridDiskSize(k, &size));
+    H3Index *expected = calloc(size, sizeof(H3Index));
+    t_assertSuccess(gridDisk(origin, k, expected));
+    // Moves the H3_NULL holes at the beginning.
+    qsort(expected, size, sizeof(H3Index), compareCells);
+    int64_t holes = size - countNonNullIndexes(expected, size);
+
+    H3Index *cells = calloc(size, sizeof(H3Index));
+    int64_t count;
+    t_assertSuccess(gridDiskCompact(origin, k, cells, &count));
+    t_assert(count == size - holes, "same number of cells");
+    t_assert(countNonNullIndexes(cells, count) == count, "no hole");
+    qsort(cells, count, sizeof(H3Index), compareCells);
+    for (int64_t i = 0; i < count; i++) {
+        t_assert(cells[i] == expected[holes + i], "same cells");
+    }
+
+    free(cells);
+    free(expected);
+}
+
+SUITE(gridDiskCompact) {
+    TEST(hexagon) {
+        for (int k = 0; k < 6; k++) {
+            assertSameAsGridDisk(0x8928308280fffff, k);
+        }
+    }
+
+    TEST(nearPentagons) {
+        H3Index pentagons[12];
+        t_assertSuccess(getPentagons(5, pentagons));
+        for (int i = 0; i < 12; i++) {
+            // The origin itself, then a cell a few rings away.
+            assertSameAsGridDisk(pentagons[i], 4);
+
+            H3Index ring[18] = {0};
+            t_assertSuccess(gridDisk(pentagons[i], 2, ring));
+            for (int j = 0; j < 18; j++) {
+                if (ring[j] != H3_NULL) {
+                    assertSameAsGridDisk(ring[j], 5);
+                }
+            }
+        }
+    }
+
+    TEST(invalidInputs) {
+        H3Index out[7];
+        int64_t count;
+        t_assert(gridDiskCompact(0x8928308280fffff, -1, out, &count) ==
+                     E_DOMAIN,
+                 "negative k rejected");
+        t_assert(gridDiskCompact(0, 1, out, &count) == E_CELL_INVALID,
+                 "invalid origin rejected");
+    }
+}
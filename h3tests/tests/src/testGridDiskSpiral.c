@@ -0,0 +1,103 @@
+/** @file testGridDiskSpiral.c
+ * @brief Tests the streaming spiral over a disk, `gridDiskSpiralInit` and
+ * `gridDiskSpiralNext`
+ *
+ * usage: `testGridDiskSpiral`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/**
+ * Checks that the spiral, drained by chunks of `capacity` cells, gives the
+ * cells of gridDiskDistances by increasing distance.
+ */
+static void assertSameDisk(H3Index origin, int k, int64_t capacity) {
+    int64_t size;
+    t_assertSuccess(maxGridDiskSize(k, &size));
+    H3Index *expected = calloc(size, sizeof(H3Index));
+    int *expectedDistances = calloc(size, sizeof(int));
+    t_assertSuccess(gridDiskDistances(origin, k, expected, expectedDistances));
+
+    H3SpiralCursor *cursor;
+    t_assertSuccess(gridDiskSpiralInit(origin, k, &cursor));
+    H3Index *cells = calloc(size, sizeof(H3Index));
+    int *distances = calloc(size, sizeof(int));
+    int64_t count = 0, written;
+    do {
+        int64_t chunk = capacity < size - count ? capacity : size - count;
+        t_assertSuccess(gridDiskSpiralNext(cursor, cells + count,
+                                           distances + count, chunk,
+                                           &written));
+        t_assert(written <= chunk, "bounded chunk");
+        count += written;
+    } while (written != 0 && count < size);
+    t_assertSuccess(gridDiskSpiralNext(cursor, cells, NULL, 1, &written));
+    t_assert(written == 0, "spiral exhausted");
+    destroySpiralCursor(cursor);
+
+    int64_t numExpected = 0;
+    for (int64_t i = 0; i < size; i++) {
+        numExpected += expected[i] != H3_NULL;
+    }
+    t_assert(count == numExpected, "same number of cells");
+    for (int64_t i = 0; i < count; i++) {
+        t_assert(i == 0 || distances[i] >= distances[i - 1],
+                 "increasing distances");
+        int found = 0;
+        for (int64_t j = 0; j < size && !found; j++) {
+            found = expected[j] == cells[i] &&
+                    expectedDistances[j] == distances[i];
+        }
+        t_assert(found, "same cell, at the same distance");
+    }
+
+    free(distances);
+    free(cells);
+    free(expectedDistances);
+    free(expected);
+}
+
+SUITE(gridDiskSpiral) {
+    TEST(hexagon) {
+        assertSameDisk(0x8928308280fffff, 0, 1);
+        assertSameDisk(0x8928308280fffff, 6, 7);
+        assertSameDisk(0x8928308280fffff, 6, 1000);
+    }
+
+    TEST(pentagon) {
+        // The origin, then a cell whose spiral reaches a pentagon.
+        assertSameDisk(0x821c07fffffffff, 3, 5);
+        H3Index ring[12];
+        t_assertSuccess(gridRing(0x821c07fffffffff, 2, ring));
+        assertSameDisk(ring[0], 5, 13);
+    }
+
+    TEST(earlyStop) {
+        H3SpiralCursor *cursor;
+        t_assertSuccess(gridDiskSpiralInit(0x8928308280fffff, 1000, &cursor));
+        H3Index cells[16];
+        int distances[16];
+        int64_t written;
+        t_assertSuccess(
+            gridDiskSpiralNext(cursor, cells, distances, 16, &written));
+        t_assert(written == 16, "full chunk");
+        t_assert(cells[0] == 0x8928308280fffff && distances[0] == 0,
+                 "origin first");
+        t_assert(distances[7] == 2 && distances[15] == 2, "second ring");
+        destroySpiralCursor(cursor);
+    }
+
+    TEST(invalid) {
+        H3SpiralCursor *cursor;
+        t_assert(gridDiskSpiralInit(0, 1, &cursor) == E_CELL_INVALID,
+                 "invalid origin");
+        t_assert(gridDiskSpiralInit(0x8928308280fffff, -1, &cursor) ==
+                     E_DOMAIN,
+                 "negative k");
+        destroySpiralCursor(NULL);
+    }
+}
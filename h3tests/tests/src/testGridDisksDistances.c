@@ -0,0 +1,91 @@
+/** @file testGridDisksDistances.c
+ * @brief Tests that `gridDisksDistances` matches `gridDiskDistances` for
+ * every origin
+ *
+ * usage: `testGridDisksDistances`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define NUM_ORIGINS 20
+#define K 2
+
+/** Asserts that the disk of an origin matches gridDiskDistances. */
+static void assertSameDisk(H3Index origin, const H3Index *cells,
+                           const int *dists, int64_t stride) {
+    H3Index *expected = calloc(stride, sizeof(H3Index));
+    int *expectedDists = calloc(stride, sizeof(int));
+    t_assertSuccess(gridDiskDistances(origin, K, expected, expectedDists));
+
+    int64_t count = 0;
+    for (int64_t i = 0; i < stride; i++) {
+        if (expected[i] == H3_NULL) {
+            continue;
+        }
+        count++;
+        bool found = false;
+        for (int64_t j = 0; j < stride; j++) {
+            if (cells[j] == expected[i]) {
+                t_assert(dists[j] == expectedDists[i], "same distance");
+                found = true;
+            }
+        }
+        t_assert(found, "cell found");
+    }
+    t_assert(countNonNullIndexes((H3Index *)cells, stride) == count,
+             "same number of cells");
+    for (int64_t j = count; j < stride; j++) {
+        t_assert(cells[j] == H3_NULL && dists[j] == 0, "padding at the end");
+    }
+
+    free(expectedDists);
+    free(expected);
+}
+
+SUITE(gridDisksDistances) {
+    int64_t stride;
+    t_assertSuccess(maxGridDiskSize(K, &stride));
+
+    // A disk of origins, far from any pentagon, and a pentagon.
+    H3Index origins[NUM_ORIGINS] = {0};
+    H3Index disk[37] = {0};
+    t_assertSuccess(gridDisk(0x8928308280fffff, 3, disk));
+    for (int i = 0; i < NUM_ORIGINS - 1; i++) {
+        origins[i] = disk[i];
+    }
+    H3Index pentagons[12];
+    t_assertSuccess(getPentagons(9, pentagons));
+    origins[NUM_ORIGINS - 1] = pentagons[0];
+
+    TEST(matchesGridDiskDistances) {
+        H3Index *cells = calloc(NUM_ORIGINS * stride, sizeof(H3Index));
+        int *dists = calloc(NUM_ORIGINS * stride, sizeof(int));
+        t_assertSuccess(
+            gridDisksDistances(origins, NUM_ORIGINS, K, cells, dists));
+        for (int i = 0; i < NUM_ORIGINS; i++) {
+            assertSameDisk(origins[i], &cells[i * stride], &dists[i * stride],
+                           stride);
+        }
+        free(dists);
+        free(cells);
+    }
+
+    TEST(invalidInputs) {
+        H3Index out[7];
+        int dists[7];
+        t_assert(gridDisksDistances(origins, 1, -1, out, dists) == E_DOMAIN,
+                 "negative k rejected");
+        t_assert(gridDisksDistances(origins, INT64_MAX / 2, 1, out, dists) ==
+                     E_DOMAIN,
+                 "output size overflow rejected");
+        H3Index invalid = 0;
+        t_assert(gridDisksDistances(&invalid, 1, 1, out, dists) ==
+                     E_CELL_INVALID,
+                 "invalid origin rejected");
+        t_assertSuccess(gridDisksDistances(NULL, 0, 1, NULL, NULL));
+    }
+}
@@ -0,0 +1,73 @@
+/** @file testGridDisksParallel.c
+ * @brief Tests the multi-threaded `gridDisksParallel`
+ *
+ * usage: `testGridDisksParallel`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define NUM_ORIGINS 100
+#define K 3
+
+SUITE(gridDisksParallel) {
+    int64_t stride;
+    t_assertSuccess(maxGridDiskSize(K, &stride));
+
+    // A disk of origins, far from any pentagon.
+    H3Index *origins = calloc(NUM_ORIGINS, sizeof(H3Index));
+    H3Index disk[127] = {0};
+    t_assertSuccess(gridDisk(0x8928308280fffff, 6, disk));
+    for (int i = 0; i < NUM_ORIGINS; i++) {
+        origins[i] = disk[i];
+    }
+
+    TEST(matchesGridDisksUnsafe) {
+        H3Index *expected = calloc(NUM_ORIGINS * stride, sizeof(H3Index));
+        H3Index *cells = calloc(NUM_ORIGINS * stride, sizeof(H3Index));
+        t_assertSuccess(gridDisksUnsafe(origins, NUM_ORIGINS, K, expected));
+        t_assertSuccess(gridDisksParallel(origins, NUM_ORIGINS, K, cells));
+        for (int64_t i = 0; i < NUM_ORIGINS * stride; i++) {
+            t_assert(cells[i] == expected[i], "same cells, in the same order");
+        }
+        free(cells);
+        free(expected);
+    }
+
+    TEST(pentagonFallback) {
+        H3Index set[2] = {origins[0]};
+        t_assertSuccess(getPentagons(9, &set[1]));
+        H3Index *cells = calloc(2 * stride, sizeof(H3Index));
+        t_assertSuccess(gridDisksParallel(set, 2, K, cells));
+
+        for (int i = 0; i < 2; i++) {
+            H3Index *expected = calloc(stride, sizeof(H3Index));
+            t_assertSuccess(gridDisk(set[i], K, expected));
+            t_assert(cells[i * stride] == set[i], "origin comes first");
+            qsort(expected, stride, sizeof(H3Index), compareCells);
+            qsort(&cells[i * stride], stride, sizeof(H3Index), compareCells);
+            for (int64_t j = 0; j < stride; j++) {
+                t_assert(cells[i * stride + j] == expected[j], "same cells");
+            }
+            free(expected);
+        }
+        free(cells);
+    }
+
+    TEST(invalidInputs) {
+        H3Index out[7];
+        t_assert(gridDisksParallel(origins, 1, -1, out) == E_DOMAIN,
+                 "negative k rejected");
+        t_assert(gridDisksParallel(origins, INT64_MAX / 2, 1, out) == E_DOMAIN,
+                 "output size overflow rejected");
+        H3Index invalid = 0;
+        t_assert(gridDisksParallel(&invalid, 1, 1, out) == E_CELL_INVALID,
+                 "invalid origin rejected");
+        t_assertSuccess(gridDisksParallel(NULL, 0, 1, NULL));
+    }
+
+    free(origins);
+}
@@ -0,0 +1,93 @@
+/** @file testGridDisksUnion.c
+ * @brief Tests the deduplicated `gridDisksUnion`
+ *
+ * usage: `testGridDisksUnion`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define K 2
+
+/** Sorts the set and removes duplicates (and H3_NULL), returns its size. */
+static int64_t sortUnique(H3Index *cells, int64_t size) {
+    qsort(cells, size, sizeof(H3Index), compareCells);
+    int64_t count = 0;
+    for (int64_t i = 0; i < size; i++) {
+        if (cells[i] != H3_NULL && (count == 0 || cells[count - 1] != cells[i])) {
+            cells[count++] = cells[i];
+        }
+    }
+    return count;
+}
+
+SUITE(gridDisksUnion) {
+    // A line of origins, with a duplicate.
+    H3Index origins[] = {0x8928308280fffff, 0x8928308280bffff,
+                         0x89283082807ffff, 0x8928308280fffff};
+    int64_t numOrigins = ARRAY_SIZE(origins);
+    int64_t stride;
+    t_assertSuccess(maxGridDiskSize(K, &stride));
+
+    TEST(matchesGridDisks) {
+        H3Index *expected = calloc(numOrigins * stride, sizeof(H3Index));
+        t_assertSuccess(gridDisksUnsafe(origins, numOrigins, K, expected));
+        int64_t expectedCount = sortUnique(expected, numOrigins * stride);
+
+        H3Index *cells = calloc(numOrigins * stride, sizeof(H3Index));
+        int64_t count;
+        t_assertSuccess(gridDisksUnion(origins, numOrigins, K, cells,
+                                       numOrigins * stride, &count));
+        t_assert(count == expectedCount, "same number of cells");
+        t_assert(sortUnique(cells, count) == count, "no duplicate");
+        for (int64_t i = 0; i < count; i++) {
+            t_assert(cells[i] == expected[i], "same cells");
+        }
+
+        free(cells);
+        free(expected);
+    }
+
+    TEST(pentagon) {
+        H3Index pentagon;
+        t_assertSuccess(getPentagons(7, &pentagon));
+        H3Index expected[19] = {0};
+        t_assertSuccess(gridDisk(pentagon, K, expected));
+        int64_t expectedCount = sortUnique(expected, 19);
+
+        H3Index cells[19];
+        int64_t count;
+        t_assertSuccess(gridDisksUnion(&pentagon, 1, K, cells, 19, &count));
+        t_assert(count == expectedCount, "same number of cells");
+        sortUnique(cells, count);
+        for (int64_t i = 0; i < count; i++) {
+            t_assert(cells[i] == expected[i], "same cells");
+        }
+    }
+
+    TEST(outputTooSmall) {
+        H3Index cells[7];
+        int64_t count;
+        t_assert(gridDisksUnion(origins, numOrigins, K, cells,
+                                ARRAY_SIZE(cells), &count) == E_MEMORY_BOUNDS,
+                 "output bound is honored");
+        t_assert(count > 7, "required size is reported");
+    }
+
+    TEST(invalidInputs) {
+        H3Index cells[7];
+        int64_t count;
+        t_assert(gridDisksUnion(origins, numOrigins, -1, cells, 7, &count) ==
+                     E_DOMAIN,
+                 "negative k rejected");
+        H3Index invalid = 0;
+        t_assert(gridDisksUnion(&invalid, 1, 1, cells, 7, &count) ==
+                     E_CELL_INVALID,
+                 "invalid origin rejected");
+        t_assertSuccess(gridDisksUnion(NULL, 0, 1, NULL, 0, &count));
+        t_assert(count == 0, "empty union");
+    }
+}
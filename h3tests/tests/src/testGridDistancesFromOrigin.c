@@ -0,0 +1,74 @@
+/** @file testGridDistancesFromOrigin.c
+ * @brief Tests the one-to-many `gridDistancesFromOrigin`
+ *
+ * usage: `testGridDistancesFromOrigin`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+SUITE(gridDistancesFromOrigin) {
+    H3Index origin = 0x8928308280fffff;
+
+    TEST(matchesGridDistance) {
+        int64_t size;
+        t_assertSuccess(maxGridDiskSize(8, &size));
+        H3Index *targets = calloc(size, sizeof(H3Index));
+        t_assertSuccess(gridDisk(origin, 8, targets));
+
+        int64_t *distances = calloc(size, sizeof(int64_t));
+        H3Error *errs = calloc(size, sizeof(H3Error));
+        t_assertSuccess(
+            gridDistancesFromOrigin(origin, targets, size, distances, errs));
+        for (int64_t i = 0; i < size; i++) {
+            int64_t expected;
+            t_assertSuccess(gridDistance(origin, targets[i], &expected));
+            t_assertSuccess(errs[i]);
+            t_assert(distances[i] == expected, "same distance");
+        }
+
+        // Without the error array.
+        t_assertSuccess(
+            gridDistancesFromOrigin(origin, targets, size, distances, NULL));
+        t_assert(distances[0] == 0, "origin is at distance 0");
+
+        free(errs);
+        free(distances);
+        free(targets);
+    }
+
+    TEST(unreachableTargets) {
+        H3Index parent;
+        t_assertSuccess(cellToParent(origin, 8, &parent));
+        H3Index targets[] = {0, parent, origin};
+        int64_t distances[3];
+        H3Error errs[3];
+        t_assert(gridDistancesFromOrigin(origin, targets, 3, distances,
+                                         errs) == E_CELL_INVALID,
+                 "first error returned");
+        t_assert(errs[0] == E_CELL_INVALID, "invalid target reported");
+        t_assert(distances[0] == -1, "invalid target has no distance");
+        t_assert(errs[1] != E_SUCCESS, "other resolution reported");
+        t_assert(distances[1] == -1, "other resolution has no distance");
+        t_assertSuccess(errs[2]);
+        t_assert(distances[2] == 0, "next targets are processed");
+
+        t_assert(gridDistancesFromOrigin(origin, targets + 1, 2, distances,
+                                         NULL) != E_SUCCESS,
+                 "error returned without the error array");
+        t_assert(distances[1] == 0, "batch finished without the error array");
+    }
+
+    TEST(invalidOrigin) {
+        int64_t distance;
+        t_assert(gridDistancesFromOrigin(0, &origin, 1, &distance, NULL) ==
+                     E_CELL_INVALID,
+                 "invalid origin rejected");
+        t_assert(gridDistancesFromOrigin(origin, &origin, -1, &distance,
+                                         NULL) == E_DOMAIN,
+                 "negative count rejected");
+    }
+}
@@ -0,0 +1,89 @@
+/** @file testGridPathsCells.c
+ * @brief Tests the batch `gridPathsCells` and `gridPathsCellsParallel`
+ *
+ * usage: `testGridPathsCells`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define NUM_PAIRS 50
+
+typedef H3Error (*GridPathsFn)(const H3Index *, const H3Index *, int64_t,
+                               H3Index *, int64_t, int64_t *);
+
+/** Checks that every path matches the one from gridPathCells. */
+static void assertSameAsGridPathCells(GridPathsFn fn, const H3Index *starts,
+                                      const H3Index *ends) {
+    int64_t total = 0;
+    for (int i = 0; i < NUM_PAIRS; i++) {
+        int64_t size;
+        t_assertSuccess(gridPathCellsSize(starts[i], ends[i], &size));
+        total += size;
+    }
+
+    H3Index *cells = calloc(total, sizeof(H3Index));
+    int64_t offsets[NUM_PAIRS + 1];
+    t_assertSuccess(fn(starts, ends, NUM_PAIRS, cells, total, offsets));
+    t_assert(offsets[0] == 0, "first path at the beginning");
+    t_assert(offsets[NUM_PAIRS] == total, "every cell is accounted for");
+
+    for (int i = 0; i < NUM_PAIRS; i++) {
+        int64_t size = offsets[i + 1] - offsets[i];
+        H3Index *expected = calloc(size, sizeof(H3Index));
+        t_assertSuccess(gridPathCells(starts[i], ends[i], expected));
+        for (int64_t j = 0; j < size; j++) {
+            t_assert(cells[offsets[i] + j] == expected[j], "same path");
+        }
+        free(expected);
+    }
+    free(cells);
+}
+
+SUITE(gridPathsCells) {
+    // Paths from the center of a disk to every other cell of it.
+    H3Index disk[91] = {0};
+    t_assertSuccess(gridDisk(0x8928308280fffff, 5, disk));
+    H3Index starts[NUM_PAIRS];
+    H3Index ends[NUM_PAIRS];
+    for (int i = 0; i < NUM_PAIRS; i++) {
+        starts[i] = disk[i % 7];
+        ends[i] = disk[90 - i];
+    }
+
+    TEST(serial) { assertSameAsGridPathCells(gridPathsCells, starts, ends); }
+
+    TEST(parallel) {
+        assertSameAsGridPathCells(gridPathsCellsParallel, starts, ends);
+    }
+
+    TEST(outputTooSmall) {
+        H3Index cells[1];
+        int64_t offsets[NUM_PAIRS + 1];
+        t_assert(gridPathsCells(starts, ends, NUM_PAIRS, cells, 1, offsets) ==
+                     E_MEMORY_BOUNDS,
+                 "output bound is honored");
+        t_assert(offsets[NUM_PAIRS] > 1, "required size is reported");
+    }
+
+    TEST(invalidPair) {
+        H3Index badStarts[] = {starts[0], 0, starts[2]};
+        H3Index badEnds[] = {ends[0], ends[1], ends[2]};
+        H3Index cells[100];
+        int64_t offsets[4];
+        t_assert(gridPathsCells(badStarts, badEnds, 3, cells, 100, offsets) ==
+                     E_CELL_INVALID,
+                 "invalid pair reported");
+        t_assert(offsets[2] == offsets[1], "invalid pair has an empty path");
+        t_assert(offsets[3] > offsets[2], "next pairs are processed");
+    }
+
+    TEST(empty) {
+        int64_t offsets[1] = {-1};
+        t_assertSuccess(gridPathsCells(NULL, NULL, 0, NULL, 0, offsets));
+        t_assert(offsets[0] == 0, "empty batch");
+    }
+}
@@ -0,0 +1,87 @@
+/** @file testGridRing.c
+ * @brief Tests the safe `gridRing`
+ *
+ * usage: `testGridRing`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/** Checks that gridRing returns the cells of gridDiskDistances at k. */
+static void assertSameAsDiskDistances(H3Index origin, int k) {
+    int64_t diskSize;
+    t_assertSuccess(maxGridDiskSize(k, &diskSize));
+    H3Index *disk = calloc(diskSize, sizeof(H3Index));
+    int *distances = calloc(diskSize, sizeof(int));
+    t_assertSuccess(gridDiskDistances(origin, k, disk, distances));
+
+    int64_t size;
+    t_assertSuccess(maxGridRingSize(k, &size));
+    H3Index *expected = calloc(size, sizeof(H3Index));
+    int64_t expectedCount = 0;
+    for (int64_t i = 0; i < diskSize; i++) {
+        if (disk[i] != H3_NULL && distances[i] == k) {
+            expected[expectedCount++] = disk[i];
+        }
+    }
+    qsort(expected, size, sizeof(H3Index), compareCells);
+
+    H3Index *ring = calloc(size, sizeof(H3Index));
+    t_assertSuccess(gridRing(origin, k, ring));
+    qsort(ring, size, sizeof(H3Index), compareCells);
+    for (int64_t i = 0; i < size; i++) {
+        t_assert(ring[i] == expected[i], "same cells");
+    }
+
+    free(ring);
+    free(expected);
+    free(distances);
+    free(disk);
+}
+
+SUITE(gridRing) {
+    TEST(maxGridRingSize) {
+        int64_t size;
+        t_assertSuccess(maxGridRingSize(0, &size));
+        t_assert(size == 1, "k=0 is the origin");
+        t_assertSuccess(maxGridRingSize(3, &size));
+        t_assert(size == 18, "6 * k cells");
+        t_assert(maxGridRingSize(-1, &size) == E_DOMAIN,
+                 "negative k rejected");
+    }
+
+    TEST(hexagon) {
+        for (int k = 0; k < 5; k++) {
+            assertSameAsDiskDistances(0x8928308280fffff, k);
+        }
+    }
+
+    TEST(pentagons) {
+        H3Index pentagons[12];
+        t_assertSuccess(getPentagons(6, pentagons));
+        for (int i = 0; i < 12; i++) {
+            for (int k = 0; k < 5; k++) {
+                assertSameAsDiskDistances(pentagons[i], k);
+            }
+        }
+    }
+
+    TEST(nearPentagon) {
+        H3Index pentagon;
+        t_assertSuccess(getPentagons(6, &pentagon));
+        H3Index ring[6] = {0};
+        t_assertSuccess(gridRing(pentagon, 1, ring));
+        assertSameAsDiskDistances(ring[0], 3);
+    }
+
+    TEST(invalidInputs) {
+        H3Index out[6];
+        t_assert(gridRing(0x8928308280fffff, -1, out) == E_DOMAIN,
+                 "negative k rejected");
+        t_assert(gridRing(0, 1, out) == E_CELL_INVALID,
+                 "invalid origin rejected");
+    }
+}
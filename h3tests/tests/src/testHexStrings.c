@@ -0,0 +1,135 @@
+/** @file testHexStrings.c
+ * @brief Tests the batch conversions between indexes and strings
+ *
+ * usage: `testHexStrings`
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static const H3Index cells[] = {0x85283473fffffff, 0x8029fffffffffff,
+                                0x8f2830828052d25};
+static const int numCells = sizeof(cells) / sizeof(cells[0]);
+
+/* A directed edge, which needs 16 digits. */
+static const H3Index edge = 0x13f2834782b9c2ab;
+
+SUITE(hexStrings) {
+    TEST(fixedWidthRoundTrip) {
+        for (size_t width = 15; width <= 16; width++) {
+            char buf[3 * 16];
+            H3Index out[3];
+            t_assertSuccess(h3sToStrings(cells, numCells, width, buf));
+            t_assertSuccess(stringsToH3(buf, numCells, width, 1, out));
+            for (int i = 0; i < numCells; i++) {
+                t_assert(out[i] == cells[i], "round trip");
+            }
+        }
+    }
+
+    TEST(fixedWidthMatchesH3ToString) {
+        char buf[3 * 15];
+        t_assertSuccess(h3sToStrings(cells, numCells, 15, buf));
+        for (int i = 0; i < numCells; i++) {
+            char expected[17];
+            t_assertSuccess(h3ToString(cells[i], expected, sizeof(expected)));
+            t_assert(strncmp(buf + 15 * i, expected, 15) == 0,
+                     "same digits as h3ToString");
+        }
+    }
+
+    TEST(fixedWidthInvalid) {
+        char buf[16];
+        t_assert(h3sToStrings(cells, 1, 14, buf) == E_DOMAIN,
+                 "width too small");
+        t_assert(h3sToStrings(cells, -1, 15, buf) == E_DOMAIN,
+                 "negative count");
+        t_assert(h3sToStrings(cells, INT64_MAX, 16, buf) == E_DOMAIN,
+                 "output size overflows");
+        t_assert(h3sToStrings(&edge, 1, 15, buf) == E_MEMORY_BOUNDS,
+                 "edge doesn't fit in 15 digits");
+        t_assert(strncmp(buf, "000000000000000", 15) == 0,
+                 "zeros written instead");
+        t_assertSuccess(h3sToStrings(&edge, 1, 16, buf));
+        t_assert(strncmp(buf, "13f2834782b9c2ab", 16) == 0,
+                 "edge fits in 16 digits");
+    }
+
+    TEST(parseFixedWidth) {
+        const char strings[] = "85283473FFFFFFF\0"
+                               "85283473fffffff\0"
+                               "085283473fffffff"
+                               "85283473fffffffg"
+                               "13f2834782b9c2ab";
+        H3Index out[5];
+        t_assertSuccess(stringsToH3(strings, 3, 16, 1, out));
+        for (int i = 0; i < 3; i++) {
+            t_assert(out[i] == 0x85283473fffffff, "parsed");
+        }
+        t_assert(stringsToH3(strings, 5, 16, 1, out) == E_FAILED,
+                 "invalid digit");
+        t_assert(out[3] == H3_NULL, "invalid string is null");
+        t_assert(out[4] == edge, "following strings still parsed");
+        t_assert(stringsToH3(strings, 1, 0, 1, out) == E_DOMAIN,
+                 "zero width");
+        t_assert(stringsToH3(strings, 2, SIZE_MAX, 1, out) == E_DOMAIN,
+                 "input size overflows");
+    }
+
+    TEST(validation) {
+        const char strings[] = "1234567890abcdef";
+        H3Index out;
+        t_assert(stringsToH3(strings, 1, 16, 1, &out) == E_FAILED,
+                 "not an index");
+        t_assert(out == H3_NULL, "invalid index is null");
+        t_assertSuccess(stringsToH3(strings, 1, 16, 0, &out));
+        t_assert(out == 0x1234567890abcdef, "parsed without validation");
+    }
+
+    TEST(lengthPrefixedRoundTrip) {
+        const H3Index indexes[] = {0x85283473fffffff, edge, 0};
+        uint8_t buf[3 * 17];
+        size_t written;
+        t_assertSuccess(
+            h3sToLengthPrefixedStrings(indexes, 3, buf, sizeof(buf), &written));
+        t_assert(written == 16 + 17 + 2, "minimal digits");
+        t_assert(buf[0] == 15 && memcmp(buf + 1, "85283473fffffff", 15) == 0,
+                 "length then digits");
+
+        H3Index out[3];
+        t_assertSuccess(lengthPrefixedStringsToH3(buf, written, 3, 0, out));
+        for (int i = 0; i < 3; i++) {
+            t_assert(out[i] == indexes[i], "round trip");
+        }
+        t_assert(lengthPrefixedStringsToH3(buf, written, 3, 1, out) ==
+                     E_FAILED,
+                 "zero is not a valid index");
+        t_assert(out[1] == edge && out[2] == H3_NULL, "only zero rejected");
+    }
+
+    TEST(lengthPrefixedBounds) {
+        uint8_t buf[17];
+        size_t written;
+        t_assert(h3sToLengthPrefixedStrings(cells, numCells, buf, sizeof(buf),
+                                            &written) == E_MEMORY_BOUNDS,
+                 "buffer too small");
+        t_assert(written == 3 * 16, "required size reported");
+
+        t_assertSuccess(
+            h3sToLengthPrefixedStrings(cells, 1, buf, sizeof(buf), &written));
+        H3Index out[2];
+        t_assert(lengthPrefixedStringsToH3(buf, written - 1, 1, 1, out) ==
+                     E_MEMORY_BOUNDS,
+                 "truncated string");
+        t_assert(lengthPrefixedStringsToH3(buf, written, 2, 1, out) ==
+                     E_MEMORY_BOUNDS,
+                 "missing string");
+        t_assert(out[0] == cells[0] && out[1] == H3_NULL,
+                 "missing index is null");
+    }
+}
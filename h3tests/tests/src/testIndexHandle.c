@@ -0,0 +1,75 @@
+/** @file testIndexHandle.c
+ * @brief Tests the atomically swappable shared indexes
+ *
+ * usage: `testIndexHandle`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static const H3Index first = 0x85283473fffffff;
+static const H3Index second = 0x8528342bfffffff;
+
+/** Tests if the index pinned by a guard holds a cell. */
+static int guardContains(H3IndexGuard guard, H3Index cell) {
+    int contained;
+    t_assertSuccess(cellSetContains(guard.index, cell, &contained));
+    return contained;
+}
+
+SUITE(indexHandle) {
+    TEST(swap) {
+        H3CellSet *set;
+        t_assertSuccess(createCellSet(&first, 1, &set));
+        H3IndexHandle *handle;
+        t_assertSuccess(createIndexHandle(INDEX_CELL_SET, set, &handle));
+
+        H3IndexGuard guard;
+        t_assertSuccess(h3IndexAcquire(handle, &guard));
+        t_assert(guard.index == set, "current version");
+        t_assert(guardContains(guard, first), "first version");
+        H3IndexGuard nested;
+        t_assertSuccess(h3IndexAcquire(handle, &nested));
+        t_assert(nested.index == set, "same version");
+        t_assertSuccess(h3IndexRelease(handle, nested));
+        t_assertSuccess(h3IndexRelease(handle, guard));
+
+        // The swap frees the first version: no guard may be held.
+        t_assertSuccess(createCellSet(&second, 1, &set));
+        t_assertSuccess(h3IndexSwap(handle, set));
+        t_assertSuccess(h3IndexAcquire(handle, &guard));
+        t_assert(guard.index == set, "new version");
+        t_assert(!guardContains(guard, first), "first version replaced");
+        t_assert(guardContains(guard, second), "second version");
+        t_assertSuccess(h3IndexRelease(handle, guard));
+
+        t_assert(h3IndexSwap(handle, NULL) == E_FAILED, "NULL version");
+        guard.slot = 1000;
+        t_assert(h3IndexRelease(handle, guard) == E_FAILED, "unknown slot");
+        destroyIndexHandle(handle);
+        destroyIndexHandle(NULL);
+    }
+
+    TEST(kinds) {
+        H3CellBitmap *bitmap;
+        t_assertSuccess(createCellBitmap(&first, 1, 5, &bitmap));
+        H3IndexHandle *handle;
+        t_assert(createIndexHandle(3, bitmap, &handle) == E_OPTION_INVALID,
+                 "unknown kind");
+        t_assert(createIndexHandle(INDEX_CELL_BITMAP, NULL, &handle) ==
+                     E_FAILED,
+                 "NULL index");
+        t_assertSuccess(createIndexHandle(INDEX_CELL_BITMAP, bitmap, &handle));
+
+        H3IndexGuard guard;
+        t_assertSuccess(h3IndexAcquire(handle, &guard));
+        int contained;
+        t_assertSuccess(cellBitmapContains(guard.index, first, &contained));
+        t_assert(contained, "cell of the bitmap");
+        t_assertSuccess(h3IndexRelease(handle, guard));
+        destroyIndexHandle(handle);
+    }
+}
@@ -0,0 +1,89 @@
+/** @file testIndexHandleConcurrent.c
+ * @brief Tests the swappable shared indexes under concurrent readers
+ *
+ * usage: `testIndexHandleConcurrent`
+ */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define NUM_READERS 4
+#define NUM_SWAPS 2000
+
+static const H3Index first = 0x85283473fffffff;
+static const H3Index second = 0x8528342bfffffff;
+
+typedef struct {
+    H3IndexHandle *handle;
+    atomic_int *done;
+    /** Number of queries run. */
+    int64_t queries;
+    /** Number of queries that saw an inconsistent version. */
+    int64_t failures;
+} Reader;
+
+/** Queries the current version until the writer is done: every version holds
+ * exactly one of the two cells. */
+static void *readLoop(void *arg) {
+    Reader *reader = arg;
+    while (!atomic_load(reader->done)) {
+        H3IndexGuard guard;
+        if (h3IndexAcquire(reader->handle, &guard) != E_SUCCESS) {
+            reader->failures++;
+            continue;
+        }
+        int hasFirst, hasSecond;
+        if (cellSetContains(guard.index, first, &hasFirst) != E_SUCCESS ||
+            cellSetContains(guard.index, second, &hasSecond) != E_SUCCESS ||
+            hasFirst == hasSecond) {
+            reader->failures++;
+        }
+        if (h3IndexRelease(reader->handle, guard) != E_SUCCESS) {
+            reader->failures++;
+        }
+        reader->queries++;
+    }
+    return NULL;
+}
+
+SUITE(indexHandleConcurrent) {
+    TEST(swapUnderReaders) {
+        H3CellSet *set;
+        t_assertSuccess(createCellSet(&first, 1, &set));
+        H3IndexHandle *handle;
+        t_assertSuccess(createIndexHandle(INDEX_CELL_SET, set, &handle));
+
+        atomic_int done = 0;
+        Reader readers[NUM_READERS];
+        pthread_t threads[NUM_READERS];
+        for (int i = 0; i < NUM_READERS; i++) {
+            readers[i] = (Reader){.handle = handle, .done = &done};
+            t_assert(pthread_create(&threads[i], NULL, readLoop,
+                                    &readers[i]) == 0,
+                     "reader started");
+        }
+
+        // Every swap frees the previous version once its readers are gone.
+        for (int i = 0; i < NUM_SWAPS; i++) {
+            t_assertSuccess(
+                createCellSet(i % 2 == 0 ? &second : &first, 1, &set));
+            t_assertSuccess(h3IndexSwap(handle, set));
+        }
+        atomic_store(&done, 1);
+
+        int64_t queries = 0;
+        for (int i = 0; i < NUM_READERS; i++) {
+            t_assert(pthread_join(threads[i], NULL) == 0, "reader joined");
+            t_assert(readers[i].failures == 0, "consistent versions");
+            queries += readers[i].queries;
+        }
+        t_assert(queries > 0, "readers ran");
+
+        destroyIndexHandle(handle);
+    }
+}
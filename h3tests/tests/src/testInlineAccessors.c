@@ -0,0 +1,57 @@
+/** @file testInlineAccessors.c
+ * @brief Tests the inline versions of the bit-field accessors against the
+ * library functions
+ *
+ * usage: `testInlineAccessors`
+ */
+
+#define H3OH3O_INLINE
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/** Checks every inline accessor against the library function. */
+static void assertSameAccessors(H3Index h) {
+    // The parentheses around the name suppress the macro expansion.
+    t_assert(getResolution(h) == (getResolution)(h), "same resolution");
+    t_assert(getBaseCellNumber(h) == (getBaseCellNumber)(h), "same base cell");
+    t_assert(isResClassIII(h) == (isResClassIII)(h), "same class");
+    for (int parentRes = -1; parentRes <= 16; parentRes++) {
+        H3Index expected = H3_NULL, actual = H3_NULL;
+        H3Error expectedErr = (cellToParent)(h, parentRes, &expected);
+        H3Error actualErr = cellToParent(h, parentRes, &actual);
+        t_assert(expectedErr == actualErr, "same error");
+        t_assert(expected == actual, "same parent");
+    }
+}
+
+SUITE(inlineAccessors) {
+    TEST(res0Cells) {
+        H3Index cells[122];
+        t_assertSuccess(getRes0Cells(cells));
+        for (int i = 0; i < 122; i++) {
+            assertSameAccessors(cells[i]);
+        }
+    }
+
+    TEST(everyResolution) {
+        // Hexagon and pentagon.
+        const H3Index cells[] = {0x8f2830828052d25, 0x8f0800000000000};
+        for (int i = 0; i < 2; i++) {
+            for (int res = 0; res <= 15; res++) {
+                H3Index parent;
+                t_assertSuccess((cellToParent)(cells[i], res, &parent));
+                assertSameAccessors(parent);
+            }
+        }
+    }
+
+    TEST(invalidCell) {
+        H3Index parent;
+        t_assert(cellToParent(0x1f2830828052d25, 5, &parent) == E_CELL_INVALID,
+                 "not a cell");
+    }
+}
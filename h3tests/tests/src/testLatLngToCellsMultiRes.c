@@ -0,0 +1,97 @@
+/** @file testLatLngToCellsMultiRes.c
+ * @brief Tests the encoding of coordinates at several resolutions at once
+ *
+ * usage: `testLatLngToCellsMultiRes`
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define NUM_COORDS 100
+
+/** Resolutions 5, 7, 9, 11 and 13. */
+static const uint32_t mask = 0x2aa0;
+static const int resolutions[] = {5, 7, 9, 11, 13};
+
+SUITE(latLngToCellsMultiRes) {
+    LatLng coords[NUM_COORDS];
+    for (int i = 0; i < NUM_COORDS; i++) {
+        randomGeo(&coords[i]);
+    }
+
+    TEST(ancestorsOfFinest) {
+        // The coarser cells are the ancestors of the finest one, which may
+        // differ from latLngToCell near the cell edges.
+        for (int i = 0; i < NUM_COORDS; i++) {
+            H3Index cells[5];
+            t_assertSuccess(latLngToCellsMultiRes(&coords[i], mask, cells));
+            H3Index finest;
+            t_assertSuccess(latLngToCell(&coords[i], 13, &finest));
+            t_assert(cells[4] == finest, "finest cell as latLngToCell");
+            for (int r = 0; r < 5; r++) {
+                H3Index expected;
+                t_assertSuccess(
+                    cellToParent(finest, resolutions[r], &expected));
+                t_assert(cells[r] == expected, "ancestor of the finest cell");
+            }
+        }
+
+        H3Index cells[16];
+        t_assertSuccess(latLngToCellsMultiRes(&coords[0], 0xffff, cells));
+        for (int res = 0; res < 16; res++) {
+            H3Index expected;
+            t_assertSuccess(cellToParent(cells[15], res, &expected));
+            t_assert(cells[res] == expected, "every resolution");
+        }
+    }
+
+    TEST(batch) {
+        H3Index cells[NUM_COORDS * 5];
+        H3Error errs[NUM_COORDS];
+        LatLng invalid = coords[1];
+        coords[1].lat = NAN;
+        t_assert(latLngsToCellsMultiRes(coords, NUM_COORDS, mask, cells,
+                                        errs) == E_LATLNG_DOMAIN,
+                 "first error returned");
+        for (int i = 0; i < NUM_COORDS; i++) {
+            H3Index expected[5];
+            if (i == 1) {
+                t_assert(errs[i] == E_LATLNG_DOMAIN, "invalid coordinate");
+                for (int r = 0; r < 5; r++) {
+                    t_assert(cells[5 * i + r] == H3_NULL, "no cell");
+                }
+                continue;
+            }
+            t_assert(errs[i] == E_SUCCESS, "no error reported");
+            t_assertSuccess(latLngToCellsMultiRes(&coords[i], mask, expected));
+            for (int r = 0; r < 5; r++) {
+                t_assert(cells[5 * i + r] == expected[r], "same cells");
+            }
+        }
+        t_assert(latLngsToCellsMultiRes(coords, NUM_COORDS, mask, cells,
+                                        NULL) == E_LATLNG_DOMAIN,
+                 "first error returned without errs");
+        coords[1] = invalid;
+        t_assertSuccess(
+            latLngsToCellsMultiRes(coords, NUM_COORDS, mask, cells, NULL));
+    }
+
+    TEST(errors) {
+        H3Index cells[1];
+        t_assert(latLngToCellsMultiRes(&coords[0], 1 << 16, cells) ==
+                     E_RES_DOMAIN,
+                 "resolution beyond finest rejected");
+        t_assert(latLngsToCellsMultiRes(coords, 1, 1 << 16, cells, NULL) ==
+                     E_RES_DOMAIN,
+                 "resolution beyond finest rejected");
+        LatLng invalid = {NAN, 0};
+        t_assert(latLngToCellsMultiRes(&invalid, 1, cells) == E_LATLNG_DOMAIN,
+                 "invalid coordinate");
+        t_assertSuccess(latLngToCellsMultiRes(&coords[0], 0, NULL));
+        t_assertSuccess(latLngsToCellsMultiRes(NULL, 0, mask, NULL, NULL));
+    }
+}
@@ -0,0 +1,128 @@
+/** @file testLatLngsToCells.c
+ * @brief Tests the batch versions of `latLngToCell`
+ *
+ * usage: `testLatLngsToCells`
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "constants.h"
+#include "h3api.h"
+#include "latLng.h"
+#include "test.h"
+#include "utility.h"
+
+#define NUM_COORDS 1000
+
+SUITE(latLngsToCells) {
+    LatLng coords[NUM_COORDS];
+    for (int i = 0; i < NUM_COORDS; i++) {
+        randomGeo(&coords[i]);
+    }
+
+    TEST(matchesLatLngToCell) {
+        H3Index cells[NUM_COORDS];
+        H3Error errs[NUM_COORDS];
+        for (int res = 0; res <= MAX_H3_RES; res++) {
+            t_assertSuccess(
+                latLngsToCells(coords, NUM_COORDS, res, cells, errs));
+            for (int i = 0; i < NUM_COORDS; i++) {
+                H3Index expected;
+                t_assertSuccess(latLngToCell(&coords[i], res, &expected));
+                t_assert(errs[i] == E_SUCCESS, "no error reported");
+                t_assert(cells[i] == expected, "same cell as latLngToCell");
+            }
+        }
+    }
+
+    TEST(singlePrecisionDegrees) {
+        float lats[NUM_COORDS];
+        float lngs[NUM_COORDS];
+        for (int i = 0; i < NUM_COORDS; i++) {
+            lats[i] = (float)radsToDegs(coords[i].lat);
+            lngs[i] = (float)radsToDegs(coords[i].lng);
+        }
+        H3Index cells[NUM_COORDS];
+        for (int res = 0; res <= MAX_H3_RES; res++) {
+            t_assertSuccess(latLngsToCellsDegreesF32(lats, lngs, NUM_COORDS,
+                                                     res, cells, NULL));
+            for (int i = 0; i < NUM_COORDS; i++) {
+                LatLng widened = {degsToRads(lats[i]), degsToRads(lngs[i])};
+                H3Index expected;
+                t_assertSuccess(latLngToCell(&widened, res, &expected));
+                t_assert(cells[i] == expected, "same cell as latLngToCell");
+            }
+        }
+
+        lats[1] = NAN;
+        H3Error errs[3];
+        t_assert(latLngsToCellsDegreesF32(lats, lngs, 3, 5, cells, errs) ==
+                     E_LATLNG_DOMAIN,
+                 "first error returned");
+        t_assert(errs[1] == E_LATLNG_DOMAIN && cells[1] == H3_NULL,
+                 "invalid coordinate reported");
+        t_assert(errs[2] == E_SUCCESS && cells[2] != H3_NULL,
+                 "batch continues after an invalid coordinate");
+    }
+
+    TEST(microdegrees) {
+        int32_t lats[NUM_COORDS];
+        int32_t lngs[NUM_COORDS];
+        for (int i = 0; i < NUM_COORDS; i++) {
+            lats[i] = (int32_t)(radsToDegs(coords[i].lat) * 1e6);
+            lngs[i] = (int32_t)(radsToDegs(coords[i].lng) * 1e6);
+        }
+        H3Index cells[NUM_COORDS];
+        for (int res = 0; res <= MAX_H3_RES; res++) {
+            t_assertSuccess(latLngsToCellsMicrodegrees(lats, lngs, NUM_COORDS,
+                                                       res, cells, NULL));
+            for (int i = 0; i < NUM_COORDS; i++) {
+                LatLng converted = {degsToRads(lats[i] * 1e-6),
+                                    degsToRads(lngs[i] * 1e-6)};
+                H3Index expected;
+                t_assertSuccess(latLngToCell(&converted, res, &expected));
+                t_assert(cells[i] == expected, "same cell as latLngToCell");
+            }
+        }
+        t_assert(latLngsToCellsMicrodegrees(lats, lngs, 1, 16, cells, NULL) ==
+                     E_RES_DOMAIN,
+                 "invalid resolution rejected");
+    }
+
+    TEST(invalidCoordinate) {
+        LatLng batch[3] = {coords[0], {NAN, 0}, coords[1]};
+        H3Index cells[3];
+        H3Error errs[3];
+        t_assert(latLngsToCells(batch, 3, 5, cells, errs) == E_LATLNG_DOMAIN,
+                 "first error returned");
+        t_assert(errs[0] == E_SUCCESS && cells[0] != H3_NULL,
+                 "valid coordinate encoded");
+        t_assert(errs[1] == E_LATLNG_DOMAIN && cells[1] == H3_NULL,
+                 "invalid coordinate reported");
+        t_assert(errs[2] == E_SUCCESS && cells[2] != H3_NULL,
+                 "batch continues after an invalid coordinate");
+
+        t_assert(latLngsToCells(batch, 3, 5, cells, NULL) == E_LATLNG_DOMAIN,
+                 "first error returned without errs");
+        t_assert(cells[1] == H3_NULL, "invalid coordinate without errs");
+        t_assert(cells[2] != H3_NULL, "batch finished without errs");
+    }
+
+    TEST(invalidResolution) {
+        H3Index cells[1];
+        t_assert(latLngsToCells(coords, 1, -1, cells, NULL) == E_RES_DOMAIN,
+                 "negative resolution rejected");
+        t_assert(latLngsToCells(coords, 1, MAX_H3_RES + 1, cells, NULL) ==
+                     E_RES_DOMAIN,
+                 "resolution beyond finest rejected");
+    }
+
+    TEST(empty) {
+        t_assertSuccess(latLngsToCells(NULL, 0, 5, NULL, NULL));
+        t_assertSuccess(
+            latLngsToCellsDegreesF32(NULL, NULL, 0, 5, NULL, NULL));
+        t_assertSuccess(
+            latLngsToCellsMicrodegrees(NULL, NULL, 0, 5, NULL, NULL));
+    }
+}
@@ -0,0 +1,88 @@
+/** @file testLocalIjRaster.c
+ * @brief Tests the dense local IJ rasters of `cellsToLocalIjRaster` and
+ * `localIjRasterToCells`
+ *
+ * usage: `testLocalIjRaster`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define NO_DATA -1.0
+
+SUITE(localIjRaster) {
+    H3Index origin = 0x8928308280fffff;
+    H3Index cells[19] = {0};
+    t_assertSuccess(gridDisk(origin, 2, cells));
+    double values[19];
+    for (int i = 0; i < 19; i++) {
+        values[i] = i;
+    }
+
+    TEST(roundTrip) {
+        LocalIjExtent extent;
+        double raster[64];
+        t_assertSuccess(cellsToLocalIjRaster(origin, cells, values, 19, 0,
+                                             NO_DATA, raster, 64, &extent));
+        t_assert(extent.width == 5 && extent.height == 5, "disk extent");
+        int64_t size = extent.width * extent.height;
+
+        H3Index *pixels = calloc(size, sizeof(H3Index));
+        t_assertSuccess(localIjRasterToCells(origin, &extent, 0, pixels));
+        int64_t numValues = 0;
+        for (int64_t p = 0; p < size; p++) {
+            if (raster[p] == NO_DATA) {
+                continue;
+            }
+            numValues++;
+            t_assert(pixels[p] == cells[(int)raster[p]],
+                     "value of the cell of the pixel");
+        }
+        t_assert(numValues == 19, "every cell placed");
+
+        for (int i = 0; i < 19; i++) {
+            CoordIJ ij;
+            t_assertSuccess(cellToLocalIj(origin, cells[i], 0, &ij));
+            int64_t p = (int64_t)(ij.j - extent.jMin) * extent.width +
+                        (ij.i - extent.iMin);
+            t_assert(raster[p] == values[i], "pixel of the cell");
+        }
+        free(pixels);
+    }
+
+    TEST(tooSmall) {
+        LocalIjExtent extent;
+        double raster[4];
+        t_assert(cellsToLocalIjRaster(origin, cells, values, 19, 0, NO_DATA,
+                                      raster, 4,
+                                      &extent) == E_MEMORY_BOUNDS,
+                 "raster too small");
+        t_assert(extent.width * extent.height == 25, "required size returned");
+    }
+
+    TEST(empty) {
+        LocalIjExtent extent;
+        t_assertSuccess(cellsToLocalIjRaster(origin, NULL, NULL, 0, 0, NO_DATA,
+                                             NULL, 0, &extent));
+        t_assert(extent.width == 0 && extent.height == 0, "empty extent");
+        t_assertSuccess(localIjRasterToCells(origin, &extent, 0, NULL));
+    }
+
+    TEST(invalid) {
+        LocalIjExtent extent;
+        double raster[64];
+        H3Index withInvalid[2] = {origin, 0x7fffffffffffffff};
+        t_assert(cellsToLocalIjRaster(origin, withInvalid, values, 2, 0,
+                                      NO_DATA, raster, 64,
+                                      &extent) == E_CELL_INVALID,
+                 "invalid cell reported");
+        t_assert(extent.width == 1 && extent.height == 1, "valid cell kept");
+        t_assert(raster[0] == values[0], "valid cell placed");
+        t_assert(cellsToLocalIjRaster(origin, cells, values, 19, 1, NO_DATA,
+                                      raster, 64, &extent) == E_DOMAIN,
+                 "invalid mode");
+    }
+}
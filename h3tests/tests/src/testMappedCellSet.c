@@ -0,0 +1,97 @@
+/** @file testMappedCellSet.c
+ * @brief Tests that a `H3CellSet` saved with `writeCellSetFile` and mapped
+ * with `openMappedCellSet` behaves like the original set
+ *
+ * usage: `testMappedCellSet`
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static const char *path = "testMappedCellSet.bin";
+
+SUITE(mappedCellSet) {
+    TEST(sameAnswers) {
+        // A compacted disk, along with a few cells on other base cells.
+        int64_t size;
+        t_assertSuccess(maxGridDiskSize(10, &size));
+        H3Index *disk = calloc(size, sizeof(H3Index));
+        t_assertSuccess(gridDisk(0x890dab6220bffff, 10, disk));
+        H3Index *cells = calloc(size + 2, sizeof(H3Index));
+        t_assertSuccess(compactCells(disk, cells, size));
+        cells[size] = 0x85283473fffffff;
+        cells[size + 1] = 0x8029fffffffffff;
+
+        H3CellSet *set;
+        t_assertSuccess(createCellSet(cells, size + 2, &set));
+        t_assertSuccess(writeCellSetFile(set, path));
+        H3CellSet *mapped;
+        t_assertSuccess(openMappedCellSet(path, &mapped));
+
+        // Query the disk cells, their neighbors and every base cell.
+        int64_t numQueries;
+        t_assertSuccess(maxGridDiskSize(12, &numQueries));
+        H3Index *queries = calloc(numQueries + 122, sizeof(H3Index));
+        t_assertSuccess(gridDisk(0x890dab6220bffff, 12, queries));
+        t_assertSuccess(getRes0Cells(queries + numQueries));
+        numQueries += 122;
+
+        uint8_t *expected = calloc(numQueries, 1);
+        uint8_t *actual = calloc(numQueries, 1);
+        t_assertSuccess(
+            cellSetContainsCells(set, queries, numQueries, expected));
+        t_assertSuccess(
+            cellSetContainsCells(mapped, queries, numQueries, actual));
+        int64_t contained = 0;
+        for (int64_t i = 0; i < numQueries; i++) {
+            t_assert(expected[i] == actual[i], "same answer");
+            contained += actual[i];
+        }
+        t_assert(contained > 0 && contained < numQueries, "mixed answers");
+
+        // A mapped set can be saved again.
+        t_assertSuccess(writeCellSetFile(mapped, path));
+
+        free(actual);
+        free(expected);
+        free(queries);
+        destroyCellSet(mapped);
+        destroyCellSet(set);
+        free(cells);
+        free(disk);
+        remove(path);
+    }
+
+    TEST(emptySet) {
+        H3CellSet *set;
+        t_assertSuccess(createCellSet(NULL, 0, &set));
+        t_assertSuccess(writeCellSetFile(set, path));
+        H3CellSet *mapped;
+        t_assertSuccess(openMappedCellSet(path, &mapped));
+        int contained;
+        t_assertSuccess(
+            cellSetContains(mapped, 0x85283473fffffff, &contained));
+        t_assert(contained == 0, "nothing is contained");
+        destroyCellSet(mapped);
+        destroyCellSet(set);
+        remove(path);
+    }
+
+    TEST(invalidFiles) {
+        H3CellSet *mapped;
+        t_assert(openMappedCellSet("missing.bin", &mapped) == E_FAILED,
+                 "missing file");
+
+        FILE *file = fopen(path, "wb");
+        fputs("not a cell set", file);
+        fclose(file);
+        t_assert(openMappedCellSet(path, &mapped) == E_FAILED,
+                 "not a cell set file");
+        remove(path);
+    }
+}
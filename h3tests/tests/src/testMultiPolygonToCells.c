@@ -0,0 +1,99 @@
+/** @file testMultiPolygonToCells.c
+ * @brief Tests that `multiPolygonToCells` matches the union of the
+ * `polygonToCells` of its polygons
+ *
+ * usage: `testMultiPolygonToCells`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static GeoLoop sfGeoLoop = {.numVerts = 6, .verts = sfVerts};
+
+// Overlaps the eastern part of the SF polygon.
+static LatLng eastVerts[] = {{0.6600, -2.1365},
+                             {0.6600, -2.1350},
+                             {0.6580, -2.1350},
+                             {0.6580, -2.1365}};
+static GeoLoop eastGeoLoop = {.numVerts = 4, .verts = eastVerts};
+
+// Far away from the others.
+static LatLng islandVerts[] = {
+    {0.6600, -2.1300}, {0.6600, -2.1290}, {0.6590, -2.1290}};
+static GeoLoop islandGeoLoop = {.numVerts = 3, .verts = islandVerts};
+
+SUITE(multiPolygonToCells) {
+    GeoPolygon polygons[] = {{.geoloop = sfGeoLoop, .numHoles = 0},
+                             {.geoloop = eastGeoLoop, .numHoles = 0},
+                             {.geoloop = islandGeoLoop, .numHoles = 0},
+                             {.geoloop = {.numVerts = 0}, .numHoles = 0}};
+    GeoMultiPolygon multiPolygon = {.numPolygons = 4, .polygons = polygons};
+
+    TEST(unionOfPolygons) {
+        int64_t size;
+        t_assertSuccess(
+            maxMultiPolygonToCellsSize(&multiPolygon, 9, 0, &size));
+
+        // Reference: every polygon filled on its own, then deduplicated.
+        H3Index *expected = calloc(size, sizeof(H3Index));
+        int64_t offset = 0;
+        for (int i = 0; i < multiPolygon.numPolygons; i++) {
+            int64_t polygonSize;
+            t_assertSuccess(
+                maxPolygonToCellsSize(&polygons[i], 9, 0, &polygonSize));
+            t_assertSuccess(
+                polygonToCells(&polygons[i], 9, 0, expected + offset));
+            offset += polygonSize;
+        }
+        t_assert(offset == size, "size is the sum of the polygon sizes");
+        qsort(expected, size, sizeof(H3Index), compareCells);
+        int64_t count = 0;
+        for (int64_t i = 0; i < size; i++) {
+            if (expected[i] != H3_NULL &&
+                (count == 0 || expected[count - 1] != expected[i])) {
+                expected[count++] = expected[i];
+            }
+        }
+
+        H3Index *actual = calloc(size, sizeof(H3Index));
+        t_assertSuccess(multiPolygonToCells(&multiPolygon, 9, 0, actual));
+        t_assert(countNonNullIndexes(actual, size) == count,
+                 "shared cells written once");
+        for (int64_t i = 0; i < count; i++) {
+            t_assert(expected[i] == actual[i], "same sorted cells");
+        }
+
+        free(actual);
+        free(expected);
+    }
+
+    TEST(empty) {
+        GeoMultiPolygon empty = {.numPolygons = 0, .polygons = NULL};
+        int64_t size = -1;
+        t_assertSuccess(maxMultiPolygonToCellsSize(&empty, 9, 0, &size));
+        t_assert(size == 0, "no polygon, no cell");
+        t_assertSuccess(multiPolygonToCells(&empty, 9, 0, NULL));
+    }
+
+    TEST(invalidArgs) {
+        int64_t size;
+        t_assert(maxMultiPolygonToCellsSize(&multiPolygon, 16, 0, &size) ==
+                     E_RES_DOMAIN,
+                 "invalid resolution rejected");
+        t_assert(maxMultiPolygonToCellsSize(&multiPolygon, 9, 42, &size) ==
+                     E_OPTION_INVALID,
+                 "unsupported flags rejected");
+
+        H3Index out[1];
+        t_assert(multiPolygonToCells(&multiPolygon, 16, 0, out) ==
+                     E_RES_DOMAIN,
+                 "invalid resolution rejected");
+    }
+}
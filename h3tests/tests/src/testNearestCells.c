@@ -0,0 +1,119 @@
+/** @file testNearestCells.c
+ * @brief Tests the k-nearest cells search (`latLngToNearestCells`)
+ *
+ * usage: `testNearestCells`
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define RES 9
+#define K_RING 30
+#define STEP 37
+
+typedef struct {
+    double distance;
+    H3Index cell;
+} Candidate;
+
+static int cmpCandidate(const void *a, const void *b) {
+    const Candidate *x = a;
+    const Candidate *y = b;
+    if (x->distance != y->distance) {
+        return (x->distance > y->distance) - (x->distance < y->distance);
+    }
+    return (x->cell > y->cell) - (x->cell < y->cell);
+}
+
+SUITE(nearestCells) {
+    LatLng point = {0.659966917655, -2.1364398519396};
+    H3Index origin;
+    t_assertSuccess(latLngToCell(&point, RES, &origin));
+    int64_t diskSize;
+    t_assertSuccess(maxGridDiskSize(K_RING, &diskSize));
+    H3Index *disk = calloc(diskSize, sizeof(H3Index));
+    t_assertSuccess(gridDisk(origin, K_RING, disk));
+
+    // Sparse occupied cells, all within the disk.
+    int64_t numOccupied = 0;
+    H3Index *occupied = calloc(diskSize / STEP + 1, sizeof(H3Index));
+    Candidate *candidates = calloc(diskSize / STEP + 1, sizeof(Candidate));
+    for (int64_t i = STEP; i < diskSize; i += STEP) {
+        LatLng center;
+        t_assertSuccess(cellToLatLng(disk[i], &center));
+        occupied[numOccupied] = disk[i];
+        candidates[numOccupied].cell = disk[i];
+        candidates[numOccupied].distance =
+            greatCircleDistanceRads(&point, &center);
+        numOccupied++;
+    }
+    qsort(candidates, numOccupied, sizeof(Candidate), cmpCandidate);
+
+    TEST(matchesBruteForce) {
+        H3CellSet *set;
+        t_assertSuccess(createCellSet(occupied, numOccupied, &set));
+        H3Index out[5];
+        double distances[5];
+        int64_t count;
+        t_assertSuccess(latLngToNearestCells(&point, RES, set, 5, K_RING, out,
+                                             distances, &count));
+        t_assert(count == 5, "found k cells");
+        for (int i = 0; i < count; i++) {
+            t_assert(out[i] == candidates[i].cell, "same nearest cells");
+            t_assert(fabs(distances[i] - candidates[i].distance) < 1e-12,
+                     "same distances");
+        }
+        destroyCellSet(set);
+    }
+
+    TEST(withoutSet) {
+        LatLng center;
+        t_assertSuccess(cellToLatLng(origin, &center));
+        H3Index out[7];
+        int64_t count;
+        t_assertSuccess(
+            latLngToNearestCells(&center, RES, NULL, 7, K_RING, out, NULL, &count));
+        t_assert(count == 7, "found k cells");
+        t_assert(out[0] == origin, "the containing cell is the nearest");
+        for (int i = 1; i < count; i++) {
+            int64_t distance;
+            t_assertSuccess(gridDistance(origin, out[i], &distance));
+            t_assert(distance == 1, "then come the neighbors");
+        }
+    }
+
+    TEST(notEnoughCandidates) {
+        H3CellSet *set;
+        t_assertSuccess(createCellSet(occupied, numOccupied, &set));
+        H3Index out[5];
+        int64_t count;
+        // Nothing is occupied in the first rings.
+        t_assertSuccess(
+            latLngToNearestCells(&point, RES, set, 5, 0, out, NULL, &count));
+        t_assert(count <= 1, "search bounded by maxRing");
+        destroyCellSet(set);
+    }
+
+    TEST(invalidInputs) {
+        H3Index out[1];
+        int64_t count;
+        t_assert(latLngToNearestCells(&point, 16, NULL, 1, 1, out, NULL,
+                                      &count) == E_RES_DOMAIN,
+                 "invalid resolution rejected");
+        t_assert(latLngToNearestCells(&point, RES, NULL, -1, 1, out, NULL,
+                                      &count) == E_DOMAIN,
+                 "negative k rejected");
+        LatLng invalid = {NAN, 0.0};
+        t_assert(latLngToNearestCells(&invalid, RES, NULL, 1, 1, out, NULL,
+                                      &count) == E_LATLNG_DOMAIN,
+                 "invalid point rejected");
+    }
+
+    free(candidates);
+    free(occupied);
+    free(disk);
+}
@@ -0,0 +1,91 @@
+/** @file testOriginsToDirectedEdges.c
+ * @brief Tests the batch `originsToDirectedEdges` and `edgesLength*`
+ *
+ * usage: `testOriginsToDirectedEdges`
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define NUM_CELLS 50
+
+SUITE(originsToDirectedEdges) {
+    H3Index cells[NUM_CELLS];
+    for (int i = 0; i < NUM_CELLS; i++) {
+        LatLng coord;
+        randomGeo(&coord);
+        t_assertSuccess(latLngToCell(&coord, 7, &cells[i]));
+    }
+    // Some pentagons.
+    t_assertSuccess(getPentagons(7, cells));
+
+    TEST(matchesOriginToDirectedEdges) {
+        H3Index edges[6 * NUM_CELLS];
+        t_assertSuccess(originsToDirectedEdges(cells, NUM_CELLS, edges));
+        for (int i = 0; i < NUM_CELLS; i++) {
+            H3Index expected[6] = {0};
+            t_assertSuccess(originToDirectedEdges(cells[i], expected));
+            int expectedCount = isPentagon(cells[i]) ? 5 : 6;
+            t_assert(countNonNullIndexes(&edges[6 * i], 6) == expectedCount,
+                     "expected number of edges");
+            for (int j = 0; j < expectedCount; j++) {
+                int found = 0;
+                for (int k = 0; k < 6; k++) {
+                    found |= edges[6 * i + k] == expected[j];
+                }
+                t_assert(found, "same edges");
+            }
+            if (isPentagon(cells[i])) {
+                t_assert(edges[6 * i] == H3_NULL, "no K axis edge");
+            }
+        }
+    }
+
+    TEST(matchesEdgeLength) {
+        H3Index edges[6 * NUM_CELLS];
+        double km[6 * NUM_CELLS];
+        double m[6 * NUM_CELLS];
+        double rads[6 * NUM_CELLS];
+        t_assertSuccess(originsToDirectedEdges(cells, NUM_CELLS, edges));
+        // Skip the missing edges of the pentagons.
+        int count = 0;
+        for (int i = 0; i < 6 * NUM_CELLS; i++) {
+            if (edges[i] != H3_NULL) {
+                edges[count++] = edges[i];
+            }
+        }
+        t_assertSuccess(edgesLengthKm(edges, count, km));
+        t_assertSuccess(edgesLengthM(edges, count, m));
+        t_assertSuccess(edgesLengthRads(edges, count, rads));
+        for (int i = 0; i < count; i++) {
+            double expected;
+            t_assertSuccess(edgeLengthKm(edges[i], &expected));
+            t_assert(km[i] == expected, "same length in km");
+            t_assertSuccess(edgeLengthM(edges[i], &expected));
+            t_assert(m[i] == expected, "same length in m");
+            t_assertSuccess(edgeLengthRads(edges[i], &expected));
+            t_assert(rads[i] == expected, "same length in rads");
+        }
+    }
+
+    TEST(invalidInputs) {
+        H3Index invalid[] = {cells[0], 0x1};
+        H3Index edges[12];
+        t_assert(originsToDirectedEdges(invalid, 2, edges) == E_CELL_INVALID,
+                 "invalid cell reported");
+        t_assert(countNonNullIndexes(&edges[6], 6) == 0,
+                 "invalid cell has no edge");
+        t_assert(countNonNullIndexes(edges, 6) >= 5, "batch continues");
+
+        double lengths[2];
+        H3Index invalidEdges[] = {edges[1], cells[0]};
+        t_assert(edgesLengthM(invalidEdges, 2, lengths) == E_DIR_EDGE_INVALID,
+                 "invalid edge reported");
+        t_assert(isnan(lengths[1]), "invalid edge has no length");
+        t_assert(!isnan(lengths[0]), "batch continues");
+    }
+}
@@ -0,0 +1,260 @@
+/** @file testOutline.c
+ * @brief Tests the incremental outline API
+ *
+ * usage: `testOutline`
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "linkedGeo.h"
+#include "test.h"
+#include "utility.h"
+
+static const H3Index origin = 0x8928308280fffff;
+
+/** Returns the (packed) disk of radius k around a cell. */
+static H3Index *diskAround(H3Index center, int k, int *numCells) {
+    int64_t size;
+    t_assertSuccess(maxGridDiskSize(k, &size));
+    H3Index *cells = calloc(size, sizeof(H3Index));
+    t_assertSuccess(gridDisk(center, k, cells));
+    int count = 0;
+    for (int64_t i = 0; i < size; i++) {
+        if (cells[i] != H3_NULL) {
+            cells[count++] = cells[i];
+        }
+    }
+    *numCells = count;
+    return cells;
+}
+
+/** Returns the (packed) disk of radius k around the origin. */
+static H3Index *disk(int k, int *numCells) {
+    return diskAround(origin, k, numCells);
+}
+
+/** Checks the number of loops and coordinates of the outline. */
+static void assertOutline(const H3Outline *outline, int numLoops,
+                          int numCoords) {
+    LinkedGeoPolygon polygon;
+    t_assertSuccess(outlineToLinkedMultiPolygon(outline, &polygon));
+    int loops = 0, coords = 0;
+    if (polygon.first != NULL) {
+        for (LinkedGeoPolygon *p = &polygon; p != NULL; p = p->next) {
+            loops += countLinkedLoops(p);
+            for (LinkedGeoLoop *loop = p->first; loop != NULL;
+                 loop = loop->next) {
+                coords += countLinkedCoords(loop);
+            }
+        }
+    }
+    t_assert(loops == numLoops, "expected number of loops");
+    t_assert(coords == numCoords, "expected number of coordinates");
+    destroyLinkedMultiPolygon(&polygon);
+}
+
+/** Orders coordinates by latitude, then longitude. */
+static int compareLatLngs(const void *a, const void *b) {
+    const LatLng *x = a, *y = b;
+    if (x->lat != y->lat) {
+        return x->lat < y->lat ? -1 : 1;
+    }
+    if (x->lng != y->lng) {
+        return x->lng < y->lng ? -1 : 1;
+    }
+    return 0;
+}
+
+/** Collects the coordinates of a multipolygon, sorted. */
+static LatLng *sortedCoords(LinkedGeoPolygon *polygon, int *numCoords) {
+    int count = 0;
+    for (LinkedGeoPolygon *p = polygon; p != NULL; p = p->next) {
+        for (LinkedGeoLoop *loop = p->first; loop != NULL; loop = loop->next) {
+            count += countLinkedCoords(loop);
+        }
+    }
+    LatLng *coords = calloc(count + 1, sizeof(LatLng));
+    int i = 0;
+    for (LinkedGeoPolygon *p = polygon; p != NULL; p = p->next) {
+        for (LinkedGeoLoop *loop = p->first; loop != NULL; loop = loop->next) {
+            for (LinkedLatLng *ll = loop->first; ll != NULL; ll = ll->next) {
+                coords[i++] = ll->vertex;
+            }
+        }
+    }
+    qsort(coords, count, sizeof(LatLng), compareLatLngs);
+    *numCoords = count;
+    return coords;
+}
+
+/** Checks that the outline describes the same polygons as
+ * cellsToLinkedMultiPolygon on the cells of the set. */
+static void assertSameAsSet(const H3Outline *outline, const H3Index *pool,
+                            const bool *inSet, int poolSize) {
+    H3Index *cells = calloc(poolSize, sizeof(H3Index));
+    int numCells = 0;
+    for (int i = 0; i < poolSize; i++) {
+        if (inSet[i]) {
+            cells[numCells++] = pool[i];
+        }
+    }
+    LinkedGeoPolygon expected, actual;
+    t_assertSuccess(cellsToLinkedMultiPolygon(cells, numCells, &expected));
+    t_assertSuccess(outlineToLinkedMultiPolygon(outline, &actual));
+
+    int expectedLoops = 0, actualLoops = 0;
+    if (expected.first != NULL) {
+        for (LinkedGeoPolygon *p = &expected; p != NULL; p = p->next) {
+            expectedLoops += countLinkedLoops(p);
+        }
+    }
+    if (actual.first != NULL) {
+        for (LinkedGeoPolygon *p = &actual; p != NULL; p = p->next) {
+            actualLoops += countLinkedLoops(p);
+        }
+    }
+    t_assert(expectedLoops == actualLoops, "same number of loops");
+
+    int numExpected, numActual;
+    LatLng *expectedCoords = sortedCoords(&expected, &numExpected);
+    LatLng *actualCoords = sortedCoords(&actual, &numActual);
+    t_assert(numExpected == numActual, "same number of coordinates");
+    for (int i = 0; i < numExpected && i < numActual; i++) {
+        t_assert(geoAlmostEqual(&expectedCoords[i], &actualCoords[i]),
+                 "same coordinates");
+    }
+
+    free(actualCoords);
+    free(expectedCoords);
+    destroyLinkedMultiPolygon(&actual);
+    destroyLinkedMultiPolygon(&expected);
+    free(cells);
+}
+
+/** Adds and removes random batches of cells of the disk of radius 4 around
+ * a cell, checking the outline against the one of the resulting set. */
+static void assertRandomUpdates(H3Index center, unsigned int seed) {
+    int poolSize;
+    H3Index *pool = diskAround(center, 4, &poolSize);
+    bool *inSet = calloc(poolSize, sizeof(bool));
+    H3Index *batch = calloc(poolSize, sizeof(H3Index));
+    srand(seed);
+
+    // Start from the first cells of the disk.
+    int numStart = poolSize / 3;
+    for (int i = 0; i < numStart; i++) {
+        inSet[i] = true;
+    }
+    H3Outline *outline;
+    t_assertSuccess(createOutline(pool, numStart, &outline));
+
+    for (int step = 0; step < 200; step++) {
+        bool add = rand() % 2 == 0;
+        int size = 1 + rand() % 6;
+        for (int i = 0; i < size; i++) {
+            int j = rand() % poolSize;
+            batch[i] = pool[j];
+            inSet[j] = add;
+        }
+        if (add) {
+            t_assertSuccess(outlineAddCells(outline, batch, size));
+        } else {
+            t_assertSuccess(outlineRemoveCells(outline, batch, size));
+        }
+        assertSameAsSet(outline, pool, inSet, poolSize);
+    }
+
+    destroyOutline(outline);
+    free(batch);
+    free(inSet);
+    free(pool);
+}
+
+SUITE(outline) {
+    TEST(grow) {
+        int numCells;
+        H3Index *cells = disk(2, &numCells);
+        H3Outline *outline;
+        t_assertSuccess(createOutline(cells, numCells, &outline));
+        // A disk of radius k has 6 * (2k + 1) outer vertexes.
+        assertOutline(outline, 1, 30);
+
+        int numBigger;
+        H3Index *bigger = disk(3, &numBigger);
+        // Cells already present are ignored.
+        t_assertSuccess(outlineAddCells(outline, bigger, numBigger));
+        assertOutline(outline, 1, 42);
+
+        free(bigger);
+        free(cells);
+        destroyOutline(outline);
+    }
+
+    TEST(holes) {
+        int numCells;
+        H3Index *cells = disk(3, &numCells);
+        H3Outline *outline;
+        t_assertSuccess(createOutline(cells, numCells, &outline));
+
+        // The center is the first cell of the disk.
+        t_assertSuccess(outlineRemoveCells(outline, cells, 1));
+        assertOutline(outline, 2, 42 + 6);
+        t_assertSuccess(outlineAddCells(outline, cells, 1));
+        assertOutline(outline, 1, 42);
+
+        free(cells);
+        destroyOutline(outline);
+    }
+
+    TEST(empty) {
+        H3Outline *outline;
+        t_assertSuccess(createOutline(NULL, 0, &outline));
+        assertOutline(outline, 0, 0);
+
+        H3Index cell = origin;
+        t_assertSuccess(outlineAddCells(outline, &cell, 1));
+        assertOutline(outline, 1, 6);
+        t_assertSuccess(outlineRemoveCells(outline, &cell, 1));
+        assertOutline(outline, 0, 0);
+        // Not in the set anymore.
+        t_assertSuccess(outlineRemoveCells(outline, &cell, 1));
+        assertOutline(outline, 0, 0);
+
+        destroyOutline(outline);
+    }
+
+    TEST(randomUpdates) {
+        for (unsigned int seed = 1; seed <= 5; seed++) {
+            assertRandomUpdates(origin, seed);
+        }
+    }
+
+    TEST(randomUpdatesPentagon) {
+        for (unsigned int seed = 1; seed <= 5; seed++) {
+            assertRandomUpdates(0x85080003fffffff, seed);
+        }
+    }
+
+    TEST(invalidArgs) {
+        H3Index cell = origin;
+        H3Outline *outline;
+        t_assertSuccess(createOutline(&cell, 1, &outline));
+
+        H3Index parent = 0x8828308281fffff;
+        t_assert(outlineAddCells(outline, &parent, 1) == E_RES_MISMATCH,
+                 "mixed resolutions rejected");
+        H3Index invalid = 0xfffffffffffffff;
+        t_assert(outlineAddCells(outline, &invalid, 1) == E_CELL_INVALID,
+                 "invalid cell rejected");
+        t_assert(outlineRemoveCells(outline, &invalid, 1) == E_CELL_INVALID,
+                 "invalid cell rejected");
+        t_assert(outlineAddCells(outline, &cell, -1) == E_DOMAIN,
+                 "negative count rejected");
+        assertOutline(outline, 1, 6);
+
+        destroyOutline(outline);
+        destroyOutline(NULL);
+    }
+}
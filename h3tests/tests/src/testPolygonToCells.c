@@ -412,19 +412,19 @@ SUITE(polygonToCells) {
 
     TEST(invalidFlags) {
         int64_t numHexagons;
-        for (uint32_t flags = 1; flags <= 32; flags++) {
+        for (uint32_t flags = 3; flags <= 32; flags++) {
             t_assert(
                 maxPolygonToCellsSize(
                     &sfGeoPolygon, 9, flags, &numHexagons) == E_OPTION_INVALID,
-                "Flags other than 0 are invalid for maxPolygonToCellsSize");
+                "Unknown flags are invalid for maxPolygonToCellsSize");
         }
         t_assertSuccess(maxPolygonToCellsSize(&sfGeoPolygon, 9, 0,
                                               &numHexagons));
         H3Index *hexagons = calloc(numHexagons, sizeof(H3Index));
-        for (uint32_t flags = 1; flags <= 32; flags++) {
+        for (uint32_t flags = 3; flags <= 32; flags++) {
             t_assert(polygonToCells(&sfGeoPolygon, 9, flags,
                                                hexagons) == E_OPTION_INVALID,
-                     "Flags other than 0 are invalid for polygonToCells");
+                     "Unknown flags are invalid for polygonToCells");
         }
         free(hexagons);
     }
@@ -0,0 +1,142 @@
+/** @file testPolygonToCellsCached.c
+ * @brief Tests that the cached polygon fills match `polygonToCells`
+ *
+ * usage: `testPolygonToCellsCached`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static GeoLoop sfGeoLoop = {.numVerts = 6, .verts = sfVerts};
+
+static LatLng holeVerts[] = {{0.6595072188743, -2.1371053983433},
+                             {0.6591482046471, -2.1373141048153},
+                             {0.6592295020837, -2.1365222838402}};
+static GeoLoop holeGeoLoop = {.numVerts = 3, .verts = holeVerts};
+
+static void assertSameFill(H3PolygonCache *cache, const GeoPolygon *polygon,
+                           int res) {
+    int64_t size;
+    t_assertSuccess(maxPolygonToCellsSize(polygon, res, 0, &size));
+    H3Index *expected = calloc(size, sizeof(H3Index));
+    t_assertSuccess(polygonToCells(polygon, res, 0, expected));
+    int64_t expectedCount = countNonNullIndexes(expected, size);
+    qsort(expected, size, sizeof(H3Index), compareCells);
+
+    H3Index *actual = calloc(size, sizeof(H3Index));
+    int64_t count;
+    t_assertSuccess(
+        polygonToCellsCached(cache, polygon, res, 0, actual, size, &count));
+    t_assert(count == expectedCount, "same number of cells");
+    qsort(actual, size, sizeof(H3Index), compareCells);
+    for (int64_t i = 0; i < size; i++) {
+        t_assert(expected[i] == actual[i], "same cells");
+    }
+
+    free(actual);
+    free(expected);
+}
+
+SUITE(polygonToCellsCached) {
+    GeoPolygon sfGeoPolygon = {.geoloop = sfGeoLoop, .numHoles = 0};
+    GeoPolygon holeGeoPolygon = {
+        .geoloop = sfGeoLoop, .numHoles = 1, .holes = &holeGeoLoop};
+
+    TEST(missThenHit) {
+        H3PolygonCache *cache;
+        t_assertSuccess(createPolygonCache(1 << 20, &cache));
+        assertSameFill(cache, &sfGeoPolygon, 9);
+        assertSameFill(cache, &sfGeoPolygon, 9);
+
+        int64_t hits, misses, bytes;
+        t_assertSuccess(polygonCacheStats(cache, &hits, &misses, &bytes));
+        t_assert(hits == 1, "second fill served from the cache");
+        t_assert(misses == 1, "first fill computed");
+        t_assert(bytes > 0, "fill cached");
+        destroyPolygonCache(cache);
+    }
+
+    TEST(keys) {
+        H3PolygonCache *cache;
+        t_assertSuccess(createPolygonCache(1 << 20, &cache));
+        assertSameFill(cache, &sfGeoPolygon, 9);
+        assertSameFill(cache, &sfGeoPolygon, 8);
+        assertSameFill(cache, &holeGeoPolygon, 9);
+
+        int64_t hits, misses, bytes;
+        t_assertSuccess(polygonCacheStats(cache, &hits, &misses, &bytes));
+        t_assert(hits == 0, "resolutions and holes are part of the key");
+        t_assert(misses == 3, "every fill computed");
+        destroyPolygonCache(cache);
+    }
+
+    TEST(compacted) {
+        H3PolygonCache *cache;
+        t_assertSuccess(createPolygonCache(1 << 20, &cache));
+        int64_t size;
+        t_assertSuccess(maxPolygonToCellsSize(&sfGeoPolygon, 9, 0, &size));
+        H3Index *expected = calloc(size, sizeof(H3Index));
+        H3Index *actual = calloc(size, sizeof(H3Index));
+        int64_t expectedCount, count;
+        t_assertSuccess(polygonToCompactCells(&sfGeoPolygon, 9, 0, expected,
+                                              size, &expectedCount));
+        for (int i = 0; i < 2; i++) {
+            t_assertSuccess(polygonToCompactCellsCached(
+                cache, &sfGeoPolygon, 9, 0, actual, size, &count));
+            t_assert(count == expectedCount, "same number of cells");
+        }
+        qsort(expected, expectedCount, sizeof(H3Index), compareCells);
+        qsort(actual, count, sizeof(H3Index), compareCells);
+        for (int64_t i = 0; i < count; i++) {
+            t_assert(expected[i] == actual[i], "same cells");
+        }
+        free(actual);
+        free(expected);
+        destroyPolygonCache(cache);
+    }
+
+    TEST(eviction) {
+        H3PolygonCache *cache;
+        t_assertSuccess(createPolygonCache(0, &cache));
+        assertSameFill(cache, &sfGeoPolygon, 9);
+        assertSameFill(cache, &sfGeoPolygon, 9);
+
+        int64_t hits, misses, bytes;
+        t_assertSuccess(polygonCacheStats(cache, &hits, &misses, &bytes));
+        t_assert(hits == 0, "nothing fits in the cache");
+        t_assert(bytes == 0, "nothing cached");
+        destroyPolygonCache(cache);
+    }
+
+    TEST(tooSmall) {
+        H3PolygonCache *cache;
+        t_assertSuccess(createPolygonCache(1 << 20, &cache));
+        H3Index cell;
+        int64_t count;
+        t_assert(polygonToCellsCached(cache, &sfGeoPolygon, 9, 0, &cell, 1,
+                                      &count) == E_MEMORY_BOUNDS,
+                 "output too small");
+        t_assert(count > 1, "required size returned");
+        destroyPolygonCache(cache);
+    }
+
+    TEST(invalid) {
+        H3PolygonCache *cache;
+        t_assertSuccess(createPolygonCache(1 << 20, &cache));
+        H3Index cell;
+        int64_t count;
+        t_assert(polygonToCellsCached(cache, &sfGeoPolygon, 16, 0, &cell, 1,
+                                      &count) == E_RES_DOMAIN,
+                 "invalid resolution");
+        destroyPolygonCache(cache);
+        t_assert(createPolygonCache(-1, &cache) == E_DOMAIN,
+                 "negative memory cap");
+    }
+}
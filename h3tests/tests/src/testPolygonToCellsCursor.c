@@ -0,0 +1,73 @@
+/** @file testPolygonToCellsCursor.c
+ * @brief Tests the chunked `polygonToCellsInit`/`polygonToCellsNext` API
+ *
+ * usage: `testPolygonToCellsCursor`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define CHUNK_SIZE 7
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static GeoLoop sfGeoLoop = {.numVerts = 6, .verts = sfVerts};
+
+SUITE(polygonToCellsCursor) {
+    GeoPolygon sfGeoPolygon = {.geoloop = sfGeoLoop, .numHoles = 0};
+
+    TEST(matchesPolygonToCells) {
+        int64_t size;
+        t_assertSuccess(maxPolygonToCellsSize(&sfGeoPolygon, 9, 0, &size));
+        H3Index *expected = calloc(size, sizeof(H3Index));
+        t_assertSuccess(polygonToCells(&sfGeoPolygon, 9, 0, expected));
+        int64_t expectedCount = countNonNullIndexes(expected, size);
+
+        H3PolygonCursor *cursor;
+        t_assertSuccess(polygonToCellsInit(&sfGeoPolygon, 9, 0, &cursor));
+        H3Index chunk[CHUNK_SIZE];
+        int64_t written;
+        int64_t total = 0;
+        do {
+            t_assertSuccess(
+                polygonToCellsNext(cursor, chunk, CHUNK_SIZE, &written));
+            t_assert(written <= CHUNK_SIZE, "chunk size is respected");
+            for (int64_t i = 0; i < written; i++) {
+                t_assert(expected[total + i] == chunk[i],
+                         "same cells, in the same order");
+            }
+            total += written;
+        } while (written != 0);
+        t_assert(total == expectedCount, "same number of cells");
+
+        destroyPolygonCursor(cursor);
+        free(expected);
+    }
+
+    TEST(emptyPolygon) {
+        GeoPolygon empty = {.geoloop = {.numVerts = 0}, .numHoles = 0};
+        H3PolygonCursor *cursor;
+        t_assertSuccess(polygonToCellsInit(&empty, 9, 0, &cursor));
+        H3Index chunk[CHUNK_SIZE];
+        int64_t written = -1;
+        t_assertSuccess(polygonToCellsNext(cursor, chunk, CHUNK_SIZE, &written));
+        t_assert(written == 0, "empty polygon contains no cell");
+        destroyPolygonCursor(cursor);
+    }
+
+    TEST(invalidInputs) {
+        H3PolygonCursor *cursor;
+        t_assert(polygonToCellsInit(&sfGeoPolygon, -1, 0, &cursor) ==
+                     E_RES_DOMAIN,
+                 "invalid resolution rejected");
+        t_assert(polygonToCellsInit(&sfGeoPolygon, 9, 42, &cursor) ==
+                     E_OPTION_INVALID,
+                 "invalid flags rejected");
+        destroyPolygonCursor(NULL);
+    }
+}
@@ -0,0 +1,124 @@
+/** @file testPolygonToCellsFlags.c
+ * @brief Tests the containment modes of the polygon filling functions
+ *
+ * usage: `testPolygonToCellsFlags`
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static GeoLoop sfGeoLoop = {.numVerts = 6, .verts = sfVerts};
+
+/** Fills the polygon, returning the sorted cells (nulls first). */
+static H3Index *fill(const GeoPolygon *polygon, int res, uint32_t flags,
+                     int64_t *size) {
+    t_assertSuccess(maxPolygonToCellsSize(polygon, res, flags, size));
+    H3Index *cells = calloc(*size, sizeof(H3Index));
+    t_assertSuccess(polygonToCells(polygon, res, flags, cells));
+    qsort(cells, *size, sizeof(H3Index), compareCells);
+    return cells;
+}
+
+/** Tests that every cell of `inner` is also in `outer`. */
+static bool isSubset(const H3Index *inner, int64_t innerSize,
+                     const H3Index *outer, int64_t outerSize) {
+    int64_t j = 0;
+    for (int64_t i = 0; i < innerSize; i++) {
+        if (inner[i] == H3_NULL) {
+            continue;
+        }
+        while (j < outerSize && outer[j] < inner[i]) {
+            j++;
+        }
+        if (j == outerSize || outer[j] != inner[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SUITE(polygonToCellsFlags) {
+    GeoPolygon sfGeoPolygon = {.geoloop = sfGeoLoop, .numHoles = 0};
+
+    TEST(modesAreNested) {
+        int64_t fullSize, centerSize, overlapSize;
+        H3Index *full = fill(&sfGeoPolygon, 9, CONTAINMENT_FULL, &fullSize);
+        H3Index *center =
+            fill(&sfGeoPolygon, 9, CONTAINMENT_CENTER, &centerSize);
+        H3Index *overlap =
+            fill(&sfGeoPolygon, 9, CONTAINMENT_OVERLAPPING, &overlapSize);
+
+        int64_t fullCount = countNonNullIndexes(full, fullSize);
+        int64_t centerCount = countNonNullIndexes(center, centerSize);
+        int64_t overlapCount = countNonNullIndexes(overlap, overlapSize);
+        t_assert(centerCount == 1253, "centroid mode is the default");
+        t_assert(0 < fullCount && fullCount < centerCount,
+                 "fewer cells fully contained");
+        t_assert(centerCount < overlapCount, "more cells overlapping");
+        t_assert(isSubset(full, fullSize, center, centerSize),
+                 "full cells are centroid cells");
+        t_assert(isSubset(center, centerSize, overlap, overlapSize),
+                 "centroid cells are overlapping cells");
+
+        free(overlap);
+        free(center);
+        free(full);
+    }
+
+    TEST(prepared) {
+        H3PreparedPolygon *prepared;
+        t_assertSuccess(preparePolygon(&sfGeoPolygon, &prepared));
+
+        int64_t expectedSize, size;
+        H3Index *expected = fill(&sfGeoPolygon, 9, CONTAINMENT_OVERLAPPING,
+                                 &expectedSize);
+        t_assertSuccess(maxPreparedPolygonToCellsSize(
+            prepared, 9, CONTAINMENT_OVERLAPPING, &size));
+        t_assert(size == expectedSize, "same size estimate");
+        H3Index *actual = calloc(size, sizeof(H3Index));
+        t_assertSuccess(preparedPolygonToCells(prepared, 9,
+                                               CONTAINMENT_OVERLAPPING, actual));
+        qsort(actual, size, sizeof(H3Index), compareCells);
+        for (int64_t i = 0; i < size; i++) {
+            t_assert(expected[i] == actual[i], "same cells");
+        }
+
+        free(actual);
+        free(expected);
+        destroyPreparedPolygon(prepared);
+    }
+
+    TEST(parallel) {
+        int64_t expectedSize;
+        H3Index *expected =
+            fill(&sfGeoPolygon, 9, CONTAINMENT_FULL, &expectedSize);
+        H3Index *actual = calloc(expectedSize, sizeof(H3Index));
+        t_assertSuccess(polygonToCellsParallel(&sfGeoPolygon, 9,
+                                               CONTAINMENT_FULL, actual));
+        qsort(actual, expectedSize, sizeof(H3Index), compareCells);
+        for (int64_t i = 0; i < expectedSize; i++) {
+            t_assert(expected[i] == actual[i], "same cells");
+        }
+
+        free(actual);
+        free(expected);
+    }
+
+    TEST(invalidFlags) {
+        int64_t size;
+        t_assert(maxPolygonToCellsSize(&sfGeoPolygon, 9, 3, &size) ==
+                     E_OPTION_INVALID,
+                 "bounding box overlap not supported");
+        t_assert(maxPolygonToCellsSize(&sfGeoPolygon, 9, 4, &size) ==
+                     E_OPTION_INVALID,
+                 "unknown mode rejected");
+    }
+}
@@ -0,0 +1,130 @@
+/** @file testPolygonToCellsParallel.c
+ * @brief Tests that `polygonToCellsParallel` matches `polygonToCells`
+ *
+ * usage: `testPolygonToCellsParallel`
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static GeoLoop sfGeoLoop = {.numVerts = 6, .verts = sfVerts};
+
+static LatLng holeVerts[] = {{0.6595072188743, -2.1371053983433},
+                             {0.6591482046471, -2.1373141048153},
+                             {0.6592295020837, -2.1365222838402}};
+static GeoLoop holeGeoLoop = {.numVerts = 3, .verts = holeVerts};
+
+// A box crossing the antimeridian.
+static LatLng transmeridianVerts[] = {
+    {0.2, 3.0}, {0.2, -3.0}, {0.4, -3.0}, {0.4, 3.0}};
+static GeoLoop transmeridianGeoLoop = {.numVerts = 4,
+                                       .verts = transmeridianVerts};
+
+// A box covering a large part of a hemisphere.
+static LatLng largeVerts[] = {
+    {-0.6, -1.0}, {-0.6, 1.0}, {0.6, 1.0}, {0.6, -1.0}};
+static GeoLoop largeGeoLoop = {.numVerts = 4, .verts = largeVerts};
+
+/** Fills `verts` with a random quadrilateral around a random center. */
+static void randomQuad(LatLng *verts) {
+    LatLng center;
+    do {
+        randomGeo(&center);
+    } while (fabs(center.lat) > 1.3);
+    for (int i = 0; i < 4; i++) {
+        double angle = M_PI / 2 * (i + (double)rand() / RAND_MAX);
+        double distance = 0.05 + 0.1 * rand() / RAND_MAX;
+        verts[i].lat = center.lat + distance * sin(angle);
+        verts[i].lng = center.lng + distance * cos(angle);
+        if (verts[i].lng > M_PI) {
+            verts[i].lng -= 2 * M_PI;
+        }
+    }
+}
+
+static void assertSameFill(const GeoPolygon *polygon, int res) {
+    int64_t size;
+    t_assertSuccess(maxPolygonToCellsSize(polygon, res, 0, &size));
+    H3Index *expected = calloc(size, sizeof(H3Index));
+    H3Index *actual = calloc(size, sizeof(H3Index));
+    t_assertSuccess(polygonToCells(polygon, res, 0, expected));
+    t_assertSuccess(polygonToCellsParallel(polygon, res, 0, actual));
+
+    t_assert(countNonNullIndexes(expected, size) ==
+                 countNonNullIndexes(actual, size),
+             "same number of cells");
+    qsort(expected, size, sizeof(H3Index), compareCells);
+    qsort(actual, size, sizeof(H3Index), compareCells);
+    for (int64_t i = 0; i < size; i++) {
+        t_assert(expected[i] == actual[i], "same cells");
+    }
+
+    free(actual);
+    free(expected);
+}
+
+SUITE(polygonToCellsParallel) {
+    GeoPolygon sfGeoPolygon = {.geoloop = sfGeoLoop, .numHoles = 0};
+    GeoPolygon holeGeoPolygon = {
+        .geoloop = sfGeoLoop, .numHoles = 1, .holes = &holeGeoLoop};
+
+    TEST(coarse) { assertSameFill(&sfGeoPolygon, 2); }
+
+    TEST(fine) {
+        for (int res = 7; res <= 10; res++) {
+            assertSameFill(&sfGeoPolygon, res);
+        }
+    }
+
+    TEST(hole) { assertSameFill(&holeGeoPolygon, 9); }
+
+    TEST(random) {
+        LatLng verts[4];
+        GeoPolygon polygon = {.geoloop = {.numVerts = 4, .verts = verts},
+                              .numHoles = 0};
+        for (int i = 0; i < 20; i++) {
+            randomQuad(verts);
+            assertSameFill(&polygon, 4 + i % 3);
+        }
+    }
+
+    TEST(transmeridian) {
+        GeoPolygon polygon = {.geoloop = transmeridianGeoLoop, .numHoles = 0};
+        assertSameFill(&polygon, 5);
+    }
+
+    TEST(pentagon) {
+        H3Index pentagons[12];
+        t_assertSuccess(getPentagons(0, pentagons));
+        LatLng center;
+        t_assertSuccess(cellToLatLng(pentagons[0], &center));
+        LatLng verts[] = {{center.lat - 0.2, center.lng - 0.2},
+                          {center.lat - 0.2, center.lng + 0.2},
+                          {center.lat + 0.2, center.lng + 0.2},
+                          {center.lat + 0.2, center.lng - 0.2}};
+        GeoPolygon polygon = {.geoloop = {.numVerts = 4, .verts = verts},
+                              .numHoles = 0};
+        assertSameFill(&polygon, 4);
+    }
+
+    TEST(large) {
+        GeoPolygon polygon = {.geoloop = largeGeoLoop, .numHoles = 0};
+        assertSameFill(&polygon, 3);
+        assertSameFill(&polygon, 4);
+    }
+
+    TEST(invalidFlags) {
+        H3Index out[1];
+        t_assert(polygonToCellsParallel(&sfGeoPolygon, 9, 42, out) ==
+                     E_OPTION_INVALID,
+                 "unsupported flags rejected");
+    }
+}
@@ -0,0 +1,199 @@
+/** @file testPolygonToCellsRandom.c
+ * @brief Tests that the fills refining the cells crossed by the polygon
+ * boundary (`polygonToCompactCells`, `polygonToCellsParallel`,
+ * `maxPolygonToCellsSizeTight` and the zone index) match the sequential
+ * `polygonToCells` on random polygons
+ *
+ * usage: `testPolygonToCellsRandom`
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+#define MAX_VERTS 12
+
+static double randomUnit(void) { return (double)rand() / RAND_MAX; }
+
+/** Brings a longitude back in [-pi, pi]. */
+static double wrapLng(double lng) {
+    if (lng > M_PI) {
+        return lng - 2 * M_PI;
+    }
+    if (lng < -M_PI) {
+        return lng + 2 * M_PI;
+    }
+    return lng;
+}
+
+/** Fills `verts` with a random star-shaped loop around `center`. */
+static int randomLoop(LatLng center, double radius, LatLng *verts) {
+    int numVerts = 3 + rand() % (MAX_VERTS - 2);
+    // Keep the loop round-ish on the sphere, up to high latitudes.
+    double lngScale = 1 / fmax(cos(center.lat), 0.2);
+    for (int i = 0; i < numVerts; i++) {
+        double angle = 2 * M_PI * (i + 0.8 * randomUnit()) / numVerts;
+        double distance = radius * (0.3 + 0.7 * randomUnit());
+        verts[i].lat = center.lat + distance * sin(angle);
+        verts[i].lng = wrapLng(center.lng + distance * lngScale * cos(angle));
+    }
+    return numVerts;
+}
+
+/** Returns the non-null cells of `cells`, packed and sorted. */
+static int64_t packCells(H3Index *cells, int64_t size) {
+    int64_t count = 0;
+    for (int64_t i = 0; i < size; i++) {
+        if (cells[i] != H3_NULL) {
+            cells[count++] = cells[i];
+        }
+    }
+    qsort(cells, count, sizeof(H3Index), compareCells);
+    return count;
+}
+
+static void assertSameCells(const H3Index *expected, int64_t expectedCount,
+                            H3Index *actual, int64_t size) {
+    t_assert(packCells(actual, size) == expectedCount, "same number of cells");
+    for (int64_t i = 0; i < expectedCount; i++) {
+        t_assert(expected[i] == actual[i], "same cells");
+    }
+}
+
+static void assertMatchesSequential(const GeoPolygon *polygon, int res) {
+    int64_t size;
+    t_assertSuccess(maxPolygonToCellsSize(polygon, res, 0, &size));
+    H3Index *expected = calloc(size, sizeof(H3Index));
+    t_assertSuccess(polygonToCells(polygon, res, 0, expected));
+    int64_t count = packCells(expected, size);
+
+    H3Index *actual = calloc(size, sizeof(H3Index));
+    t_assertSuccess(polygonToCellsParallel(polygon, res, 0, actual));
+    assertSameCells(expected, count, actual, size);
+
+    int64_t compactCount;
+    H3Index *compact = calloc(size, sizeof(H3Index));
+    t_assertSuccess(
+        polygonToCompactCells(polygon, res, 0, compact, size, &compactCount));
+    int64_t uncompactSize;
+    t_assertSuccess(
+        uncompactCellsSize(compact, compactCount, res, &uncompactSize));
+    t_assert(uncompactSize == count, "compact fill has the same cells");
+    for (int64_t i = 0; i < size; i++) {
+        actual[i] = H3_NULL;
+    }
+    t_assertSuccess(
+        uncompactCells(compact, compactCount, actual, uncompactSize, res));
+    assertSameCells(expected, count, actual, size);
+
+    int64_t tight;
+    t_assertSuccess(maxPolygonToCellsSizeTight(polygon, res, 0, &tight));
+    t_assert(tight >= count, "tight size is an upper bound");
+
+    // The centers of the cells covering the polygon join the zone exactly
+    // when they are in the centroid fill.
+    int64_t coverSize;
+    t_assertSuccess(maxPolygonToCellsSize(polygon, res,
+                                          CONTAINMENT_OVERLAPPING, &coverSize));
+    H3Index *cover = calloc(coverSize, sizeof(H3Index));
+    t_assertSuccess(
+        polygonToCells(polygon, res, CONTAINMENT_OVERLAPPING, cover));
+    int64_t numPoints = packCells(cover, coverSize);
+    LatLng *points = calloc(numPoints, sizeof(LatLng));
+    for (int64_t i = 0; i < numPoints; i++) {
+        t_assertSuccess(cellToLatLng(cover[i], &points[i]));
+    }
+    int64_t id = 1;
+    H3ZoneIndex *index;
+    t_assertSuccess(createZoneIndex(polygon, &id, 1, res, &index));
+    int64_t *ids = calloc(numPoints, sizeof(int64_t));
+    int64_t *offsets = calloc(numPoints + 1, sizeof(int64_t));
+    t_assertSuccess(
+        latLngsToZoneIds(index, points, numPoints, ids, numPoints, offsets));
+    for (int64_t i = 0; i < numPoints; i++) {
+        int inside = bsearch(&cover[i], expected, count, sizeof(H3Index),
+                             compareCells) != NULL;
+        t_assert(offsets[i + 1] - offsets[i] == inside,
+                 "point joined to the zone iff its cell is filled");
+    }
+    destroyZoneIndex(index);
+
+    free(offsets);
+    free(ids);
+    free(points);
+    free(cover);
+    free(compact);
+    free(actual);
+    free(expected);
+}
+
+/** Checks random polygons of the given size around random centers whose
+ * latitude is in [minLat, maxLat]. */
+static void assertRandomPolygons(unsigned int seed, double minLat,
+                                 double maxLat, double radius, int res) {
+    srand(seed);
+    LatLng verts[MAX_VERTS];
+    for (int i = 0; i < 10; i++) {
+        LatLng center = {minLat + (maxLat - minLat) * randomUnit(),
+                         M_PI * (2 * randomUnit() - 1)};
+        if (rand() % 2 == 0) {
+            center.lat = -center.lat;
+        }
+        GeoPolygon polygon = {
+            .geoloop = {.numVerts = randomLoop(center, radius, verts),
+                        .verts = verts},
+            .numHoles = 0};
+        assertMatchesSequential(&polygon, res);
+    }
+}
+
+SUITE(polygonToCellsRandom) {
+    TEST(random) {
+        assertRandomPolygons(1, 0, 1.2, 0.5, 2);
+        assertRandomPolygons(2, 0, 1.2, 0.25, 3);
+        assertRandomPolygons(3, 0, 1.2, 0.1, 4);
+        assertRandomPolygons(4, 0, 1.2, 0.04, 5);
+    }
+
+    TEST(highLatitude) {
+        assertRandomPolygons(5, 1.2, 1.45, 0.1, 3);
+        assertRandomPolygons(6, 1.3, 1.45, 0.1, 4);
+    }
+
+    TEST(pentagons) {
+        H3Index pentagons[12];
+        t_assertSuccess(getPentagons(1, pentagons));
+        srand(7);
+        LatLng verts[MAX_VERTS];
+        for (int i = 0; i < 12; i++) {
+            LatLng center;
+            t_assertSuccess(cellToLatLng(pentagons[i], &center));
+            GeoPolygon polygon = {
+                .geoloop = {.numVerts = randomLoop(center, 0.15, verts),
+                            .verts = verts},
+                .numHoles = 0};
+            assertMatchesSequential(&polygon, 4);
+        }
+    }
+
+    TEST(withHole) {
+        srand(8);
+        LatLng verts[MAX_VERTS];
+        LatLng holeVerts[MAX_VERTS];
+        for (int i = 0; i < 10; i++) {
+            LatLng center = {1.2 * (2 * randomUnit() - 1),
+                             M_PI * (2 * randomUnit() - 1)};
+            GeoLoop hole = {.numVerts = randomLoop(center, 0.02, holeVerts),
+                            .verts = holeVerts};
+            GeoPolygon polygon = {
+                .geoloop = {.numVerts = randomLoop(center, 0.1, verts),
+                            .verts = verts},
+                .numHoles = 1,
+                .holes = &hole};
+            assertMatchesSequential(&polygon, 4);
+        }
+    }
+}
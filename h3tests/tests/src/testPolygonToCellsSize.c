@@ -0,0 +1,98 @@
+/** @file testPolygonToCellsSize.c
+ * @brief Tests the tight and exact fill size estimations
+ *
+ * usage: `testPolygonToCellsSize`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static GeoLoop sfGeoLoop = {.numVerts = 6, .verts = sfVerts};
+
+// A thin diagonal strip, the worst case of a bounding box estimation.
+static LatLng stripVerts[] = {{0.6580, -2.1390},
+                              {0.6581, -2.1390},
+                              {0.6601, -2.1350},
+                              {0.6600, -2.1350}};
+static GeoLoop stripGeoLoop = {.numVerts = 4, .verts = stripVerts};
+
+static void assertSizes(const GeoPolygon *polygon, int res, uint32_t flags) {
+    int64_t max, tight, exact;
+    t_assertSuccess(maxPolygonToCellsSize(polygon, res, flags, &max));
+    t_assertSuccess(maxPolygonToCellsSizeTight(polygon, res, flags, &tight));
+    t_assertSuccess(polygonToCellsExactSize(polygon, res, flags, &exact));
+    t_assert(exact <= tight, "tight size is an upper bound");
+    t_assert(tight <= max, "tight size is tighter");
+
+    // The exact size is enough to hold the fill.
+    H3Index *cells = calloc(exact, sizeof(H3Index));
+    t_assertSuccess(polygonToCells(polygon, res, flags, cells));
+    t_assert(countNonNullIndexes(cells, exact) == exact, "exact size");
+    free(cells);
+
+    // So is the tight size.
+    cells = calloc(tight, sizeof(H3Index));
+    t_assertSuccess(polygonToCells(polygon, res, flags, cells));
+    t_assert(countNonNullIndexes(cells, tight) == exact, "tight size");
+    free(cells);
+}
+
+SUITE(polygonToCellsSize) {
+    GeoPolygon sfGeoPolygon = {.geoloop = sfGeoLoop, .numHoles = 0};
+    GeoPolygon stripGeoPolygon = {.geoloop = stripGeoLoop, .numHoles = 0};
+
+    TEST(center) {
+        for (int res = 0; res <= 10; res++) {
+            assertSizes(&sfGeoPolygon, res, CONTAINMENT_CENTER);
+            assertSizes(&stripGeoPolygon, res, CONTAINMENT_CENTER);
+        }
+    }
+
+    TEST(otherModes) {
+        assertSizes(&sfGeoPolygon, 9, CONTAINMENT_FULL);
+        assertSizes(&sfGeoPolygon, 9, CONTAINMENT_OVERLAPPING);
+    }
+
+    TEST(knownSize) {
+        int64_t exact;
+        t_assertSuccess(polygonToCellsExactSize(&sfGeoPolygon, 9, 0, &exact));
+        t_assert(exact == 1253, "got expected polygonToCells size");
+    }
+
+    TEST(thinPolygon) {
+        int64_t max, tight;
+        t_assertSuccess(maxPolygonToCellsSize(&stripGeoPolygon, 10, 0, &max));
+        t_assertSuccess(
+            maxPolygonToCellsSizeTight(&stripGeoPolygon, 10, 0, &tight));
+        t_assert(tight * 4 < max, "much tighter than the bounding box");
+    }
+
+    TEST(empty) {
+        GeoPolygon emptyGeoPolygon = {.geoloop = {.numVerts = 0},
+                                      .numHoles = 0};
+        int64_t size = -1;
+        t_assertSuccess(
+            maxPolygonToCellsSizeTight(&emptyGeoPolygon, 9, 0, &size));
+        t_assert(size == 0, "empty polygon has no cell");
+        size = -1;
+        t_assertSuccess(polygonToCellsExactSize(&emptyGeoPolygon, 9, 0, &size));
+        t_assert(size == 0, "empty polygon has no cell");
+    }
+
+    TEST(invalidArgs) {
+        int64_t size;
+        t_assert(maxPolygonToCellsSizeTight(&sfGeoPolygon, 16, 0, &size) ==
+                     E_RES_DOMAIN,
+                 "invalid resolution rejected");
+        t_assert(polygonToCellsExactSize(&sfGeoPolygon, 9, 42, &size) ==
+                     E_OPTION_INVALID,
+                 "unsupported flags rejected");
+    }
+}
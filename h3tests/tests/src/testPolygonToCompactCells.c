@@ -0,0 +1,135 @@
+/** @file testPolygonToCompactCells.c
+ * @brief Tests that `polygonToCompactCells` matches the compaction of
+ * `polygonToCells`
+ *
+ * usage: `testPolygonToCompactCells`
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static GeoLoop sfGeoLoop = {.numVerts = 6, .verts = sfVerts};
+
+static LatLng holeVerts[] = {{0.6595072188743, -2.1371053983433},
+                             {0.6591482046471, -2.1373141048153},
+                             {0.6592295020837, -2.1365222838402}};
+static GeoLoop holeGeoLoop = {.numVerts = 3, .verts = holeVerts};
+
+static LatLng transMeridianVerts[] = {{0.01, -M_PI + 0.01},
+                                      {0.01, M_PI - 0.01},
+                                      {-0.01, M_PI - 0.01},
+                                      {-0.01, -M_PI + 0.01}};
+static GeoLoop transMeridianGeoLoop = {.numVerts = 4,
+                                       .verts = transMeridianVerts};
+
+static void assertSameCompactFill(const GeoPolygon *polygon, int res,
+                                  uint32_t flags) {
+    int64_t size;
+    t_assertSuccess(maxPolygonToCellsSize(polygon, res, flags, &size));
+    H3Index *cells = calloc(size, sizeof(H3Index));
+    t_assertSuccess(polygonToCells(polygon, res, flags, cells));
+    // Pack the cells, compactCells doesn't accept H3_NULL.
+    int64_t numCells = 0;
+    for (int64_t i = 0; i < size; i++) {
+        if (cells[i] != H3_NULL) {
+            cells[numCells++] = cells[i];
+        }
+    }
+    H3Index *expected = calloc(size, sizeof(H3Index));
+    t_assertSuccess(compactCells(cells, expected, numCells));
+    int64_t expectedCount = countNonNullIndexes(expected, size);
+    qsort(expected, size, sizeof(H3Index), compareCells);
+
+    H3Index *actual = calloc(size, sizeof(H3Index));
+    int64_t count;
+    t_assertSuccess(
+        polygonToCompactCells(polygon, res, flags, actual, size, &count));
+    t_assert(count == expectedCount, "same number of cells");
+    qsort(actual, size, sizeof(H3Index), compareCells);
+    for (int64_t i = 0; i < size; i++) {
+        t_assert(expected[i] == actual[i], "same cells");
+    }
+
+    free(actual);
+    free(expected);
+    free(cells);
+}
+
+SUITE(polygonToCompactCells) {
+    GeoPolygon sfGeoPolygon = {.geoloop = sfGeoLoop, .numHoles = 0};
+    GeoPolygon holeGeoPolygon = {
+        .geoloop = sfGeoLoop, .numHoles = 1, .holes = &holeGeoLoop};
+    GeoPolygon transMeridianGeoPolygon = {.geoloop = transMeridianGeoLoop,
+                                          .numHoles = 0};
+
+    TEST(coarse) { assertSameCompactFill(&sfGeoPolygon, 2, 0); }
+
+    TEST(fine) {
+        for (int res = 7; res <= 11; res++) {
+            assertSameCompactFill(&sfGeoPolygon, res, CONTAINMENT_CENTER);
+        }
+    }
+
+    TEST(hole) { assertSameCompactFill(&holeGeoPolygon, 10, 0); }
+
+    TEST(transmeridian) {
+        assertSameCompactFill(&transMeridianGeoPolygon, 7, 0);
+    }
+
+    TEST(otherModes) {
+        assertSameCompactFill(&sfGeoPolygon, 10, CONTAINMENT_FULL);
+        assertSameCompactFill(&sfGeoPolygon, 10, CONTAINMENT_OVERLAPPING);
+    }
+
+    TEST(compacted) {
+        int64_t size, count;
+        t_assertSuccess(maxPolygonToCellsSize(&sfGeoPolygon, 11, 0, &size));
+        H3Index *out = calloc(size, sizeof(H3Index));
+        t_assertSuccess(
+            polygonToCompactCells(&sfGeoPolygon, 11, 0, out, size, &count));
+        t_assert(count * 10 < size, "interior cells are compacted");
+        free(out);
+    }
+
+    TEST(memoryBounds) {
+        int64_t count, expected;
+        H3Index out[1];
+        t_assert(polygonToCompactCells(&sfGeoPolygon, 9, 0, out, 1, &count) ==
+                     E_MEMORY_BOUNDS,
+                 "output too small");
+        t_assert(count > 1, "required size reported");
+        H3Index *cells = calloc(count, sizeof(H3Index));
+        t_assertSuccess(polygonToCompactCells(&sfGeoPolygon, 9, 0, cells,
+                                              count, &expected));
+        t_assert(count == expected, "required size is exact");
+        free(cells);
+    }
+
+    TEST(empty) {
+        GeoPolygon emptyGeoPolygon = {.geoloop = {.numVerts = 0},
+                                      .numHoles = 0};
+        int64_t count = -1;
+        t_assertSuccess(
+            polygonToCompactCells(&emptyGeoPolygon, 9, 0, NULL, 0, &count));
+        t_assert(count == 0, "empty polygon has no cell");
+    }
+
+    TEST(invalidArgs) {
+        int64_t count;
+        H3Index out[1];
+        t_assert(polygonToCompactCells(&sfGeoPolygon, 16, 0, out, 1, &count) ==
+                     E_RES_DOMAIN,
+                 "invalid resolution rejected");
+        t_assert(polygonToCompactCells(&sfGeoPolygon, 9, 42, out, 1, &count) ==
+                     E_OPTION_INVALID,
+                 "unsupported flags rejected");
+    }
+}
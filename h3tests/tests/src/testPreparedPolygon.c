@@ -0,0 +1,93 @@
+/** @file testPreparedPolygon.c
+ * @brief Tests the `preparePolygon`/`preparedPolygonToCells` API
+ *
+ * usage: `testPreparedPolygon`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static GeoLoop sfGeoLoop = {.numVerts = 6, .verts = sfVerts};
+
+static LatLng holeVerts[] = {{0.6595072188743, -2.1371053983433},
+                             {0.6591482046471, -2.1373141048153},
+                             {0.6592295020837, -2.1365222838402}};
+static GeoLoop holeGeoLoop = {.numVerts = 3, .verts = holeVerts};
+
+static void assertSameFill(const GeoPolygon *geoPolygon,
+                           const H3PreparedPolygon *prepared, int res) {
+    int64_t expectedSize;
+    t_assertSuccess(maxPolygonToCellsSize(geoPolygon, res, 0, &expectedSize));
+    int64_t size;
+    t_assertSuccess(maxPreparedPolygonToCellsSize(prepared, res, 0, &size));
+    t_assert(size == expectedSize, "same size estimate");
+
+    H3Index *expected = calloc(size, sizeof(H3Index));
+    H3Index *cells = calloc(size, sizeof(H3Index));
+    t_assertSuccess(polygonToCells(geoPolygon, res, 0, expected));
+    t_assertSuccess(preparedPolygonToCells(prepared, res, 0, cells));
+    for (int64_t i = 0; i < size; i++) {
+        t_assert(expected[i] == cells[i], "same cells, in the same order");
+    }
+    free(cells);
+    free(expected);
+}
+
+SUITE(preparedPolygon) {
+    GeoPolygon sfGeoPolygon = {.geoloop = sfGeoLoop, .numHoles = 0};
+    GeoPolygon holeGeoPolygon = {
+        .geoloop = sfGeoLoop, .numHoles = 1, .holes = &holeGeoLoop};
+
+    TEST(matchesPolygonToCells) {
+        H3PreparedPolygon *prepared;
+        t_assertSuccess(preparePolygon(&sfGeoPolygon, &prepared));
+        // The same prepared polygon is reusable at any resolution.
+        for (int res = 0; res <= 10; res++) {
+            assertSameFill(&sfGeoPolygon, prepared, res);
+        }
+        destroyPreparedPolygon(prepared);
+    }
+
+    TEST(matchesPolygonToCellsWithHole) {
+        H3PreparedPolygon *prepared;
+        t_assertSuccess(preparePolygon(&holeGeoPolygon, &prepared));
+        assertSameFill(&holeGeoPolygon, prepared, 9);
+        assertSameFill(&holeGeoPolygon, prepared, 10);
+        destroyPreparedPolygon(prepared);
+    }
+
+    TEST(emptyPolygon) {
+        GeoPolygon empty = {.geoloop = {.numVerts = 0}, .numHoles = 0};
+        H3PreparedPolygon *prepared;
+        t_assertSuccess(preparePolygon(&empty, &prepared));
+        int64_t size = -1;
+        t_assertSuccess(maxPreparedPolygonToCellsSize(prepared, 9, 0, &size));
+        t_assert(size == 0, "empty polygon contains no cell");
+        destroyPreparedPolygon(prepared);
+    }
+
+    TEST(invalidInputs) {
+        H3PreparedPolygon *prepared;
+        t_assertSuccess(preparePolygon(&sfGeoPolygon, &prepared));
+        int64_t size;
+        t_assert(maxPreparedPolygonToCellsSize(prepared, -1, 0, &size) ==
+                     E_RES_DOMAIN,
+                 "invalid resolution rejected");
+        t_assert(maxPreparedPolygonToCellsSize(prepared, 9, 42, &size) ==
+                     E_OPTION_INVALID,
+                 "invalid flags rejected");
+        H3Index cell;
+        t_assert(preparedPolygonToCells(prepared, 16, 0, &cell) ==
+                     E_RES_DOMAIN,
+                 "invalid resolution rejected");
+        destroyPreparedPolygon(prepared);
+        destroyPreparedPolygon(NULL);
+    }
+}
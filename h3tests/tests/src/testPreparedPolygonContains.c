@@ -0,0 +1,110 @@
+/** @file testPreparedPolygonContains.c
+ * @brief Tests the `preparedPolygonContains` batch point-in-polygon test
+ *
+ * usage: `testPreparedPolygonContains`
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static GeoLoop sfGeoLoop = {.numVerts = 6, .verts = sfVerts};
+
+static LatLng holeVerts[] = {{0.6595072188743, -2.1371053983433},
+                             {0.6591482046471, -2.1373141048153},
+                             {0.6592295020837, -2.1365222838402}};
+static GeoLoop holeGeoLoop = {.numVerts = 3, .verts = holeVerts};
+
+SUITE(preparedPolygonContains) {
+    GeoPolygon holeGeoPolygon = {
+        .geoloop = sfGeoLoop, .numHoles = 1, .holes = &holeGeoLoop};
+
+    TEST(points) {
+        H3PreparedPolygon *prepared;
+        t_assertSuccess(preparePolygon(&holeGeoPolygon, &prepared));
+
+        LatLng points[] = {
+            {0.6590, -2.1378},           // Inside.
+            {0.6593, -2.1370},           // In the hole.
+            {0.6620, -2.1370},           // North of the polygon.
+            {0.6590, -2.1300},           // East of the polygon.
+            {-0.6590, 2.1378},           // Antipode.
+            {0.6586, -2.1360},           // Inside.
+        };
+        uint8_t mask[6];
+        t_assertSuccess(preparedPolygonContains(prepared, points, 6, mask));
+        t_assert(mask[0] == 1, "inside");
+        t_assert(mask[1] == 0, "in the hole");
+        t_assert(mask[2] == 0, "north");
+        t_assert(mask[3] == 0, "east");
+        t_assert(mask[4] == 0, "antipode");
+        t_assert(mask[5] == 1, "inside");
+
+        destroyPreparedPolygon(prepared);
+    }
+
+    TEST(matchesFill) {
+        H3PreparedPolygon *prepared;
+        t_assertSuccess(preparePolygon(&holeGeoPolygon, &prepared));
+
+        // Cells are filled by centroid: every center is inside.
+        int64_t size;
+        t_assertSuccess(
+            maxPreparedPolygonToCellsSize(prepared, 9, 0, &size));
+        H3Index *cells = calloc(size, sizeof(H3Index));
+        t_assertSuccess(preparedPolygonToCells(prepared, 9, 0, cells));
+        int64_t count = countNonNullIndexes(cells, size);
+        LatLng *centers = calloc(count, sizeof(LatLng));
+        for (int64_t i = 0; i < count; i++) {
+            t_assertSuccess(cellToLatLng(cells[i], &centers[i]));
+        }
+        uint8_t *mask = calloc(count, sizeof(uint8_t));
+        t_assertSuccess(
+            preparedPolygonContains(prepared, centers, count, mask));
+        for (int64_t i = 0; i < count; i++) {
+            t_assert(mask[i] == 1, "cell center inside");
+        }
+
+        free(mask);
+        free(centers);
+        free(cells);
+        destroyPreparedPolygon(prepared);
+    }
+
+    TEST(invalidPoint) {
+        H3PreparedPolygon *prepared;
+        t_assertSuccess(preparePolygon(&holeGeoPolygon, &prepared));
+
+        LatLng points[] = {{NAN, -2.1378}, {0.6590, -2.1378}};
+        uint8_t mask[2] = {42, 42};
+        t_assert(preparedPolygonContains(prepared, points, 2, mask) ==
+                     E_LATLNG_DOMAIN,
+                 "invalid point reported");
+        t_assert(mask[0] == 0, "invalid point is outside");
+        t_assert(mask[1] == 1, "valid point still tested");
+
+        destroyPreparedPolygon(prepared);
+    }
+
+    TEST(emptyPolygon) {
+        GeoPolygon emptyGeoPolygon = {.geoloop = {.numVerts = 0},
+                                      .numHoles = 0};
+        H3PreparedPolygon *prepared;
+        t_assertSuccess(preparePolygon(&emptyGeoPolygon, &prepared));
+
+        LatLng point = {0.6590, -2.1378};
+        uint8_t mask = 42;
+        t_assertSuccess(preparedPolygonContains(prepared, &point, 1, &mask));
+        t_assert(mask == 0, "empty polygon contains nothing");
+
+        destroyPreparedPolygon(prepared);
+    }
+}
@@ -0,0 +1,126 @@
+/** @file testSortCells.c
+ * @brief Tests the sorting of index arrays
+ *
+ * usage: `testSortCells`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/**
+ * Returns a shuffled set of cells: the children, down to 6 resolutions
+ * finer (enough for the parallel sort to split the work), of a cell and of a
+ * pentagon, and the cells in between.
+ */
+static H3Index *shuffledCells(int64_t *count) {
+    const H3Index parents[] = {0x85283473fffffff, 0x8509fffffffffff};
+    int64_t total = 0;
+    for (int p = 0; p < 2; p++) {
+        for (int res = 5; res <= 11; res++) {
+            int64_t size;
+            t_assertSuccess(cellToChildrenSize(parents[p], res, &size));
+            total += size;
+        }
+    }
+    H3Index *cells = calloc(total, sizeof(H3Index));
+    int64_t offset = 0;
+    for (int p = 0; p < 2; p++) {
+        for (int res = 5; res <= 11; res++) {
+            int64_t size;
+            t_assertSuccess(cellToChildrenSize(parents[p], res, &size));
+            t_assertSuccess(cellToChildren(parents[p], res, cells + offset));
+            offset += size;
+        }
+    }
+    // cellToChildren skips the deleted subsequence of the pentagon.
+    int64_t numCells = 0;
+    for (int64_t i = 0; i < total; i++) {
+        if (cells[i] != H3_NULL) {
+            cells[numCells++] = cells[i];
+        }
+    }
+
+    uint64_t state = 0x9e3779b97f4a7c15;
+    for (int64_t i = numCells - 1; i > 0; i--) {
+        state = state * 6364136223846793005 + 1442695040888963407;
+        int64_t j = (int64_t)((state >> 33) % (uint64_t)(i + 1));
+        H3Index cell = cells[i];
+        cells[i] = cells[j];
+        cells[j] = cell;
+    }
+    *count = numCells;
+    return cells;
+}
+
+SUITE(sortCells) {
+    TEST(ascending) {
+        int64_t count;
+        H3Index *cells = shuffledCells(&count);
+        H3Index *expected = calloc(count, sizeof(H3Index));
+        memcpy(expected, cells, count * sizeof(H3Index));
+        qsort(expected, count, sizeof(H3Index), compareCells);
+
+        H3Index *sorted = calloc(count, sizeof(H3Index));
+        memcpy(sorted, cells, count * sizeof(H3Index));
+        t_assertSuccess(h3SortCells(sorted, count));
+        t_assert(memcmp(sorted, expected, count * sizeof(H3Index)) == 0,
+                 "same order as qsort");
+
+        memcpy(sorted, cells, count * sizeof(H3Index));
+        t_assertSuccess(h3SortCellsParallel(sorted, count));
+        t_assert(memcmp(sorted, expected, count * sizeof(H3Index)) == 0,
+                 "same order as qsort in parallel");
+
+        // Small arrays, and arbitrary 64-bit values.
+        H3Index values[] = {UINT64_MAX, 0, 0x8928308280fffff, 1, 0};
+        t_assertSuccess(h3SortCells(values, 5));
+        t_assert(values[0] == 0 && values[1] == 0 && values[2] == 1 &&
+                     values[3] == 0x8928308280fffff && values[4] == UINT64_MAX,
+                 "sorted values");
+
+        free(sorted);
+        free(expected);
+        free(cells);
+    }
+
+    TEST(locality) {
+        int64_t count;
+        H3Index *cells = shuffledCells(&count);
+        t_assertSuccess(h3SortCellsByLocality(cells, count));
+
+        for (int64_t i = 1; i < count; i++) {
+            const H3Index previous = cells[i - 1];
+            const H3Index cell = cells[i];
+            const int res = getResolution(cell);
+            // Every cell is directly followed by its first child.
+            if (res > getResolution(previous)) {
+                H3Index parent;
+                t_assertSuccess(cellToParent(cell, res - 1, &parent));
+                t_assert(parent == previous, "child follows its parent");
+            }
+        }
+        // Both parents lead their descendants.
+        t_assert(getResolution(cells[0]) == 5, "parent first");
+        int parents = 0;
+        for (int64_t i = 0; i < count; i++) {
+            parents += getResolution(cells[i]) == 5;
+        }
+        t_assert(parents == 2, "both parents kept");
+        free(cells);
+    }
+
+    TEST(errors) {
+        H3Index cells[] = {0x85283473fffffff, 0x1234};
+        t_assert(h3SortCellsByLocality(cells, 2) == E_CELL_INVALID,
+                 "invalid cell");
+        t_assert(cells[0] == 0x85283473fffffff && cells[1] == 0x1234,
+                 "array untouched");
+        t_assert(h3SortCells(cells, -1) == E_DOMAIN, "negative size");
+        t_assertSuccess(h3SortCells(NULL, 0));
+        t_assertSuccess(h3SortCellsByLocality(NULL, 0));
+    }
+}
@@ -0,0 +1,87 @@
+/** @file testSortedOutput.c
+ * @brief Tests the sorted variants `polygonToCellsSorted` and
+ * `uncompactCellsSorted`
+ *
+ * usage: `testSortedOutput`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static GeoLoop sfGeoLoop = {.numVerts = 6, .verts = sfVerts};
+
+/** Asserts that `actual` is the sorted set of the non-null `expected`. */
+static void assertSortedSet(H3Index *expected, int64_t size,
+                            const H3Index *actual, int64_t count) {
+    qsort(expected, size, sizeof(H3Index), compareCells);
+    int64_t numExpected = 0;
+    for (int64_t i = 0; i < size; i++) {
+        if (expected[i] != H3_NULL &&
+            (numExpected == 0 || expected[i] != expected[numExpected - 1])) {
+            expected[numExpected++] = expected[i];
+        }
+    }
+    t_assert(count == numExpected, "same number of cells");
+    for (int64_t i = 0; i < count; i++) {
+        t_assert(actual[i] == expected[i], "same cells, in ascending order");
+    }
+}
+
+SUITE(sortedOutput) {
+    GeoPolygon sfGeoPolygon = {.geoloop = sfGeoLoop, .numHoles = 0};
+
+    TEST(polygonToCellsSorted) {
+        int64_t size;
+        t_assertSuccess(maxPolygonToCellsSize(&sfGeoPolygon, 9, 0, &size));
+        H3Index *expected = calloc(size, sizeof(H3Index));
+        H3Index *actual = calloc(size, sizeof(H3Index));
+        t_assertSuccess(polygonToCells(&sfGeoPolygon, 9, 0, expected));
+        int64_t count;
+        t_assertSuccess(
+            polygonToCellsSorted(&sfGeoPolygon, 9, 0, actual, &count));
+        assertSortedSet(expected, size, actual, count);
+        free(actual);
+        free(expected);
+    }
+
+    TEST(uncompactCellsSorted) {
+        // Mixed resolutions, unsorted, with a cell overlapping its parent.
+        H3Index compacted[] = {0x8928308280fffff, 0x872830828ffffff,
+                               0x85283473fffffff, 0x8928308280fffff};
+        int64_t numCompacted = sizeof(compacted) / sizeof(compacted[0]);
+        int64_t size;
+        t_assertSuccess(uncompactCellsSize(compacted, numCompacted, 9, &size));
+        H3Index *expected = calloc(size, sizeof(H3Index));
+        H3Index *actual = calloc(size, sizeof(H3Index));
+        t_assertSuccess(
+            uncompactCells(compacted, numCompacted, expected, size, 9));
+        int64_t count;
+        t_assertSuccess(uncompactCellsSorted(compacted, numCompacted, actual,
+                                             size, 9, &count));
+        assertSortedSet(expected, size, actual, count);
+        t_assert(count < size, "duplicates removed");
+        free(actual);
+        free(expected);
+    }
+
+    TEST(uncompactCellsSortedErrors) {
+        H3Index compacted[] = {0x8928308280fffff};
+        H3Index out[7];
+        int64_t count;
+        t_assert(uncompactCellsSorted(compacted, 1, out, 6, 10, &count) ==
+                     E_MEMORY_BOUNDS,
+                 "output too small");
+        t_assert(uncompactCellsSorted(compacted, 1, out, 7, 8, &count) ==
+                     E_RES_MISMATCH,
+                 "cell finer than the resolution");
+        t_assertSuccess(uncompactCellsSorted(NULL, 0, NULL, 0, 9, &count));
+        t_assert(count == 0, "no cells");
+    }
+}
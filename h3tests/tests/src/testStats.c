@@ -0,0 +1,253 @@
+/** @file testStats.c
+ * @brief Tests the call statistics of the entry points
+ *
+ * usage: `testStats`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/** Returns the statistics of the named function. */
+static H3FunctionStats functionStats(const H3Stats *stats, const char *name) {
+    for (int i = 0; i < stats->numFunctions; i++) {
+        if (strcmp(stats->functions[i].name, name) == 0) {
+            return stats->functions[i];
+        }
+    }
+    t_assert(false, "instrumented function");
+    return stats->functions[0];
+}
+
+/** Returns the path counters of the named function. */
+static H3PathStats pathStats(const H3Stats *stats, const char *name) {
+    for (int i = 0; i < stats->numPaths; i++) {
+        if (strcmp(stats->paths[i].name, name) == 0) {
+            return stats->paths[i];
+        }
+    }
+    t_assert(false, "traversal reporting its paths");
+    return stats->paths[0];
+}
+
+/** Returns the sum of the latency histogram of the function. */
+static int64_t histogramTotal(const H3FunctionStats *stats) {
+    int64_t total = 0;
+    for (int i = 0; i < H3_STATS_BUCKETS; i++) {
+        total += stats->latencies[i];
+    }
+    return total;
+}
+
+/** Visitor counting the visited cells into `context`. */
+static int countCells(const H3Index *cells, int64_t count, void *context) {
+    (void)cells;
+    *(int64_t *)context += count;
+    return 0;
+}
+
+SUITE(stats) {
+    LatLng sf = {0.659966917655, -2.1364398519396};
+
+    TEST(disabledByDefault) {
+        H3Index cell;
+        t_assertSuccess(latLngToCell(&sf, 9, &cell));
+
+        H3Stats stats;
+        t_assertSuccess(h3GetStats(&stats));
+        t_assert(stats.numFunctions == H3_STATS_FUNCTIONS,
+                 "every function listed");
+        t_assert(functionStats(&stats, "latLngToCell").calls == 0,
+                 "nothing recorded");
+    }
+
+    TEST(record) {
+        h3SetStatsEnabled(1);
+        H3Index cell;
+        for (int i = 0; i < 10; i++) {
+            t_assertSuccess(latLngToCell(&sf, 9, &cell));
+        }
+        H3Index disk[7], compacted[7];
+        t_assertSuccess(gridDisk(cell, 1, disk));
+        t_assertSuccess(compactCells(disk, compacted, 7));
+        h3SetStatsEnabled(0);
+
+        H3Stats stats;
+        t_assertSuccess(h3GetStats(&stats));
+        H3FunctionStats toCell = functionStats(&stats, "latLngToCell");
+        t_assert(toCell.calls == 10, "calls recorded");
+        t_assert(toCell.elements == 10, "elements recorded");
+        t_assert(histogramTotal(&toCell) == 10, "latencies recorded");
+        t_assert(toCell.totalNanos >= 0, "total time recorded");
+        H3FunctionStats compact = functionStats(&stats, "compactCells");
+        t_assert(compact.calls == 1, "compactCells recorded");
+        t_assert(compact.elements == 7, "compactCells elements recorded");
+
+        // Disabled again: nothing recorded.
+        t_assertSuccess(latLngToCell(&sf, 9, &cell));
+        t_assertSuccess(h3GetStats(&stats));
+        t_assert(functionStats(&stats, "latLngToCell").calls == 10,
+                 "recording disabled");
+
+        h3ResetStats();
+        t_assertSuccess(h3GetStats(&stats));
+        for (int i = 0; i < stats.numFunctions; i++) {
+            t_assert(stats.functions[i].calls == 0, "calls reset");
+            t_assert(histogramTotal(&stats.functions[i]) == 0,
+                     "latencies reset");
+        }
+    }
+
+    TEST(batchVariants) {
+        float lats[2] = {37.8f, 37.7f};
+        float lngs[2] = {-122.4f, -122.5f};
+        int32_t microLats[2] = {37800000, 37700000};
+        int32_t microLngs[2] = {-122400000, -122500000};
+        LatLng coords[2] = {sf, sf};
+        H3Index cells[4];
+
+        h3ResetStats();
+        h3SetStatsEnabled(1);
+        t_assertSuccess(
+            latLngsToCellsDegreesF32(lats, lngs, 2, 9, cells, NULL));
+        t_assertSuccess(latLngsToCellsMicrodegrees(microLats, microLngs, 2, 9,
+                                                   cells, NULL));
+        t_assertSuccess(latLngsToCellsMultiRes(coords, 2, 0x30, cells, NULL));
+        int64_t visited = 0;
+        t_assertSuccess(gridDiskForEach(cells[0], 1, countCells, &visited));
+        h3SetStatsEnabled(0);
+
+        H3Stats stats;
+        t_assertSuccess(h3GetStats(&stats));
+        H3FunctionStats degrees =
+            functionStats(&stats, "latLngsToCellsDegreesF32");
+        t_assert(degrees.elements == 2, "float batch recorded");
+        H3FunctionStats micro =
+            functionStats(&stats, "latLngsToCellsMicrodegrees");
+        t_assert(micro.elements == 2, "microdegree batch recorded");
+        H3FunctionStats multiRes =
+            functionStats(&stats, "latLngsToCellsMultiRes");
+        t_assert(multiRes.elements == 2, "multi-resolution batch recorded");
+        t_assert(functionStats(&stats, "gridDiskForEach").calls == 1,
+                 "visited disk recorded");
+        t_assert(visited == 7, "disk visited");
+        h3ResetStats();
+    }
+
+    TEST(childrenVariants) {
+        H3Index parents[2];
+        t_assertSuccess(latLngToCell(&sf, 8, &parents[0]));
+        t_assertSuccess(latLngToCell(&sf, 7, &parents[1]));
+        H3Index children[56];
+        int64_t offsets[3];
+
+        h3ResetStats();
+        h3SetStatsEnabled(1);
+        t_assertSuccess(
+            cellsToChildrenCSR(parents, 2, 9, children, 56, offsets));
+        h3SetStatsEnabled(0);
+
+        H3Stats stats;
+        t_assertSuccess(h3GetStats(&stats));
+        H3FunctionStats csr = functionStats(&stats, "cellsToChildrenCSR");
+        t_assert(csr.calls == 1 && csr.elements == 2, "CSR batch recorded");
+        t_assert(functionStats(&stats, "cellToChildren").calls == 0,
+                 "not recorded as the scalar function");
+        h3ResetStats();
+    }
+
+    TEST(visitorVariants) {
+        H3Index cell;
+        t_assertSuccess(latLngToCell(&sf, 8, &cell));
+        LatLng verts[] = {{0.6595, -2.1365}, {0.6596, -2.1365},
+                          {0.6596, -2.1364}, {0.6595, -2.1364}};
+        GeoPolygon polygon = {.geoloop = {.numVerts = 4, .verts = verts},
+                              .numHoles = 0};
+
+        h3ResetStats();
+        h3SetStatsEnabled(1);
+        int64_t visited = 0;
+        t_assertSuccess(cellToChildrenForEach(cell, 9, countCells, &visited));
+        t_assert(visited == 7, "children visited");
+        t_assertSuccess(
+            polygonToCellsForEach(&polygon, 9, 0, countCells, &visited));
+        h3SetStatsEnabled(0);
+
+        H3Stats stats;
+        t_assertSuccess(h3GetStats(&stats));
+        t_assert(functionStats(&stats, "cellToChildrenForEach").calls == 1,
+                 "visited children recorded");
+        t_assert(functionStats(&stats, "polygonToCellsForEach").calls == 1,
+                 "visited fill recorded");
+        t_assert(functionStats(&stats, "cellToChildren").calls == 0,
+                 "not recorded as cellToChildren");
+        t_assert(functionStats(&stats, "polygonToCells").calls == 0,
+                 "not recorded as polygonToCells");
+        h3ResetStats();
+    }
+
+    TEST(fillVariants) {
+        LatLng verts[] = {{0.6595, -2.1365}, {0.6596, -2.1365},
+                          {0.6596, -2.1364}, {0.6595, -2.1364}};
+        GeoPolygon polygon = {.geoloop = {.numVerts = 4, .verts = verts},
+                              .numHoles = 0};
+        int64_t size;
+        t_assertSuccess(maxPolygonToCellsSize(&polygon, 10, 0, &size));
+        H3Index *cells = calloc(size, sizeof(H3Index));
+
+        h3ResetStats();
+        h3SetStatsEnabled(1);
+        int64_t count;
+        t_assertSuccess(polygonToCellsSorted(&polygon, 10, 0, cells, &count));
+        H3Workspace *workspace;
+        t_assertSuccess(createWorkspace(&workspace));
+        t_assertSuccess(polygonToCellsWs(workspace, &polygon, 10, 0, cells));
+        destroyWorkspace(workspace);
+        h3SetStatsEnabled(0);
+
+        H3Stats stats;
+        t_assertSuccess(h3GetStats(&stats));
+        H3FunctionStats sorted = functionStats(&stats, "polygonToCellsSorted");
+        t_assert(sorted.calls == 1 && sorted.elements == 4,
+                 "sorted fill recorded");
+        H3FunctionStats ws = functionStats(&stats, "polygonToCellsWs");
+        t_assert(ws.calls == 1 && ws.elements == 4, "workspace fill recorded");
+        t_assert(functionStats(&stats, "polygonToCells").calls == 0,
+                 "not recorded as polygonToCells");
+        free(cells);
+        h3ResetStats();
+    }
+
+    TEST(gridPaths) {
+        const H3Index pentagon = 0x8009fffffffffff;
+        H3Index hexagon;
+        t_assertSuccess(latLngToCell(&sf, 9, &hexagon));
+        H3Index disk[19];
+
+        h3ResetStats();
+        h3SetStatsEnabled(1);
+        t_assertSuccess(gridDisk(hexagon, 2, disk));
+        t_assertSuccess(gridDisk(pentagon, 2, disk));
+        t_assert(gridDiskUnsafe(pentagon, 2, disk) == E_PENTAGON,
+                 "pentagon rejected");
+        h3SetStatsEnabled(0);
+
+        H3Stats stats;
+        t_assertSuccess(h3GetStats(&stats));
+        t_assert(stats.numPaths == H3_STATS_PATHS, "every traversal listed");
+        H3PathStats disks = pathStats(&stats, "gridDisk");
+        t_assert(disks.fastPath == 1, "fast path recorded");
+        t_assert(disks.fallbacks == 1, "fallback recorded");
+        H3PathStats unsafeDisks = pathStats(&stats, "gridDiskUnsafe");
+        t_assert(unsafeDisks.fastPath == 0, "no fast path");
+        t_assert(unsafeDisks.pentagonErrors == 1, "pentagon error recorded");
+
+        h3ResetStats();
+        t_assertSuccess(h3GetStats(&stats));
+        t_assert(pathStats(&stats, "gridDisk").fallbacks == 0,
+                 "paths reset");
+    }
+}
@@ -0,0 +1,71 @@
+/** @file testThreadPool.c
+ * @brief Tests the thread pool and executor configuration of the parallel
+ * functions
+ *
+ * usage: `testThreadPool`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static int executorCalls = 0;
+
+/** Minimal executor, running the tasks one after the other. */
+static void serialExecutor(H3Task task, void *arg, int64_t count,
+                           void *context) {
+    int *calls = context;
+    (*calls)++;
+    for (int64_t i = 0; i < count; i++) {
+        task(arg);
+    }
+}
+
+/** Checks uncompactCellsParallel against uncompactCells. */
+static void assertSameChildren(void) {
+    H3Index disk[61];
+    t_assertSuccess(gridDisk(0x89283470c27ffff, 4, disk));
+
+    int64_t size;
+    t_assertSuccess(uncompactCellsSize(disk, 61, 12, &size));
+    H3Index *expected = calloc(size, sizeof(H3Index));
+    H3Index *actual = calloc(size, sizeof(H3Index));
+    t_assertSuccess(uncompactCells(disk, 61, expected, size, 12));
+    t_assertSuccess(uncompactCellsParallel(disk, 61, actual, size, 12));
+    t_assert(memcmp(expected, actual, size * sizeof(H3Index)) == 0,
+             "same children");
+    free(actual);
+    free(expected);
+}
+
+SUITE(threadPool) {
+    TEST(poolSizes) {
+        const int sizes[] = {1, 2, 4, 0};
+        for (int i = 0; i < 4; i++) {
+            t_assertSuccess(h3SetThreadPool(sizes[i]));
+            assertSameChildren();
+        }
+        t_assert(h3SetThreadPool(-1) == E_DOMAIN, "negative size rejected");
+    }
+
+    TEST(executor) {
+        t_assertSuccess(h3SetThreadPool(4));
+        h3SetExecutor(serialExecutor, &executorCalls);
+        assertSameChildren();
+        t_assert(executorCalls > 0, "executor used");
+
+        // The serial mode never calls the executor.
+        t_assertSuccess(h3SetThreadPool(1));
+        executorCalls = 0;
+        assertSameChildren();
+        t_assert(executorCalls == 0, "executor not used in serial mode");
+
+        h3SetExecutor(NULL, NULL);
+        t_assertSuccess(h3SetThreadPool(0));
+        assertSameChildren();
+        t_assert(executorCalls == 0, "executor reset");
+    }
+}
@@ -0,0 +1,51 @@
+/** @file testTrustedInput.c
+ * @brief Tests the trusted input mode (`h3SetTrustedInput`)
+ *
+ * usage: `testTrustedInput`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static const H3Index sunnyvale = 0x89283470c27ffff;
+
+SUITE(trustedInput) {
+    int k = 5;
+    int64_t hexCount;
+    t_assertSuccess(maxGridDiskSize(k, &hexCount));
+    H3Index *disk = calloc(hexCount, sizeof(H3Index));
+    t_assertSuccess(gridDisk(sunnyvale, k, disk));
+
+    TEST(sameResult) {
+        H3Index *expected = calloc(hexCount, sizeof(H3Index));
+        t_assertSuccess(compactCells(disk, expected, hexCount));
+
+        H3Index *compacted = calloc(hexCount, sizeof(H3Index));
+        h3SetTrustedInput(1);
+        t_assertSuccess(compactCells(disk, compacted, hexCount));
+        h3SetTrustedInput(0);
+
+        for (int64_t i = 0; i < hexCount; i++) {
+            t_assert(compacted[i] == expected[i], "same compacted set");
+        }
+        free(compacted);
+        free(expected);
+    }
+
+    TEST(validatedByDefault) {
+        H3Index set[] = {sunnyvale, 0xfffffffffffffff};
+        H3Index out[ARRAY_SIZE(set)];
+        t_assert(compactCells(set, out, ARRAY_SIZE(set)) == E_CELL_INVALID,
+                 "invalid index rejected");
+
+        h3SetTrustedInput(1);
+        h3SetTrustedInput(0);
+        t_assert(compactCells(set, out, ARRAY_SIZE(set)) == E_CELL_INVALID,
+                 "validation is back once the mode is disabled");
+    }
+
+    free(disk);
+}
@@ -0,0 +1,72 @@
+/** @file testUncompactCellsParallel.c
+ * @brief Tests the multi-threaded `uncompactCellsParallel`
+ *
+ * usage: `testUncompactCellsParallel`
+ */
+
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static const H3Index sunnyvale = 0x89283470c27ffff;
+
+SUITE(uncompactCellsParallel) {
+    int k = 9;
+    int64_t hexCount;
+    t_assertSuccess(maxGridDiskSize(k, &hexCount));
+    H3Index *disk = calloc(hexCount, sizeof(H3Index));
+    t_assertSuccess(gridDisk(sunnyvale, k, disk));
+    H3Index *compacted = calloc(hexCount, sizeof(H3Index));
+    t_assertSuccess(compactCells(disk, compacted, hexCount));
+    int64_t compactedCount = countNonNullIndexes(compacted, hexCount);
+
+    TEST(matchesUncompactCells) {
+        for (int res = 9; res <= 11; res++) {
+            int64_t size;
+            t_assertSuccess(
+                uncompactCellsSize(compacted, compactedCount, res, &size));
+
+            H3Index *expected = calloc(size, sizeof(H3Index));
+            H3Index *cells = calloc(size, sizeof(H3Index));
+            t_assertSuccess(uncompactCells(compacted, compactedCount,
+                                           expected, size, res));
+            t_assertSuccess(uncompactCellsParallel(compacted, compactedCount,
+                                                   cells, size, res));
+            for (int64_t i = 0; i < size; i++) {
+                t_assert(cells[i] == expected[i],
+                         "same cells, in the same order");
+            }
+            free(cells);
+            free(expected);
+        }
+    }
+
+    TEST(outputTooSmall) {
+        int64_t size;
+        t_assertSuccess(uncompactCellsSize(compacted, compactedCount, 9, &size));
+        H3Index *cells = calloc(size, sizeof(H3Index));
+        t_assert(uncompactCellsParallel(compacted, compactedCount, cells,
+                                        size - 1, 9) == E_MEMORY_BOUNDS,
+                 "output bound is honored");
+        free(cells);
+    }
+
+    TEST(resolutionTooCoarse) {
+        H3Index out;
+        t_assert(uncompactCellsParallel(&sunnyvale, 1, &out, 1, 8) ==
+                     E_RES_MISMATCH,
+                 "cannot uncompact to a coarser resolution");
+        t_assert(uncompactCellsParallel(&sunnyvale, 1, &out, 1, 16) ==
+                     E_RES_DOMAIN,
+                 "invalid resolution rejected");
+    }
+
+    TEST(empty) {
+        t_assertSuccess(uncompactCellsParallel(NULL, 0, NULL, 0, 9));
+    }
+
+    free(compacted);
+    free(disk);
+}
@@ -0,0 +1,120 @@
+/** @file testWorkspace.c
+ * @brief Tests the functions reusing the buffers of a workspace
+ *
+ * usage: `testWorkspace`
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+static GeoLoop sfGeoLoop = {.numVerts = 6, .verts = sfVerts};
+
+static LatLng holeVerts[] = {{0.6595072188743, -2.1371053983433},
+                             {0.6591482046471, -2.1373141048153},
+                             {0.6592295020837, -2.1365222838402}};
+static GeoLoop holeGeoLoop = {.numVerts = 3, .verts = holeVerts};
+
+static int64_t allocs = 0;
+
+/** Checks that both sets hold the same cells, in any order. */
+static void assertSameSet(H3Index *expected, H3Index *actual, int64_t size) {
+    qsort(expected, size, sizeof(H3Index), compareCells);
+    qsort(actual, size, sizeof(H3Index), compareCells);
+    t_assert(memcmp(expected, actual, size * sizeof(H3Index)) == 0,
+             "same compacted set");
+}
+
+static void *countingMalloc(size_t size, void *context) {
+    (void)context;
+    allocs++;
+    return malloc(size);
+}
+
+static void *countingCalloc(size_t count, size_t size, void *context) {
+    (void)context;
+    allocs++;
+    return calloc(count, size);
+}
+
+static void *countingRealloc(void *ptr, size_t size, void *context) {
+    (void)context;
+    allocs++;
+    return realloc(ptr, size);
+}
+
+static void countingFree(void *ptr, void *context) {
+    (void)context;
+    free(ptr);
+}
+
+/** Checks polygonToCellsWs against polygonToCells. */
+static void assertSameFill(H3Workspace *workspace, const GeoPolygon *polygon,
+                           int res) {
+    int64_t size, sizeWs;
+    t_assertSuccess(maxPolygonToCellsSize(polygon, res, 0, &size));
+    t_assertSuccess(
+        maxPolygonToCellsSizeWs(workspace, polygon, res, 0, &sizeWs));
+    t_assert(size == sizeWs, "same size estimation");
+
+    H3Index *expected = calloc(size, sizeof(H3Index));
+    H3Index *actual = calloc(size, sizeof(H3Index));
+    t_assertSuccess(polygonToCells(polygon, res, 0, expected));
+    t_assertSuccess(polygonToCellsWs(workspace, polygon, res, 0, actual));
+    t_assert(memcmp(expected, actual, size * sizeof(H3Index)) == 0,
+             "same cells");
+    free(actual);
+    free(expected);
+}
+
+SUITE(workspace) {
+    GeoPolygon sfGeoPolygon = {.geoloop = sfGeoLoop, .numHoles = 0};
+    GeoPolygon holeGeoPolygon = {
+        .geoloop = sfGeoLoop, .numHoles = 1, .holes = &holeGeoLoop};
+
+    TEST(polygonToCells) {
+        H3Workspace *workspace;
+        t_assertSuccess(createWorkspace(&workspace));
+        // Alternate the shapes, so that the buffers get resized.
+        for (int i = 0; i < 3; i++) {
+            assertSameFill(workspace, &holeGeoPolygon, 9);
+            assertSameFill(workspace, &sfGeoPolygon, 8);
+        }
+        destroyWorkspace(workspace);
+    }
+
+    TEST(compactCells) {
+        H3Index disk[61], expected[61], actual[61];
+        t_assertSuccess(gridDisk(0x89283470c27ffff, 4, disk));
+        H3Index children[7];
+        t_assertSuccess(cellToChildren(0x8828347441fffff, 9, children));
+
+        H3Workspace *workspace;
+        t_assertSuccess(createWorkspace(&workspace));
+        memset(expected, 0, sizeof(expected));
+        t_assertSuccess(compactCells(disk, expected, 61));
+        t_assertSuccess(compactCellsWs(workspace, disk, actual, 61));
+        assertSameSet(expected, actual, 61);
+
+        // Warmed up, the workspace needs no allocation anymore.
+        t_assertSuccess(h3SetAllocator(countingMalloc, countingCalloc,
+                                       countingRealloc, countingFree, NULL));
+        t_assertSuccess(compactCellsWs(workspace, children, actual, 7));
+        t_assertSuccess(compactCellsWs(workspace, disk, actual, 61));
+        t_assertSuccess(h3SetAllocator(NULL, NULL, NULL, NULL, NULL));
+        t_assert(allocs == 0, "no allocation");
+        assertSameSet(expected, actual, 61);
+
+        t_assert(compactCellsWs(NULL, disk, actual, 61) == E_FAILED,
+                 "workspace required");
+        destroyWorkspace(workspace);
+        destroyWorkspace(NULL);
+    }
+}
@@ -0,0 +1,128 @@
+/** @file testZoneIndex.c
+ * @brief Tests the `H3ZoneIndex` spatial join of points to polygons
+ *
+ * usage: `testZoneIndex`
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "h3api.h"
+#include "test.h"
+#include "utility.h"
+
+/** Returns the non-null cells of a polygon fill, sorted. */
+static H3Index *fill(const GeoPolygon *polygon, int res, uint32_t flags,
+                     int64_t *count) {
+    int64_t size;
+    t_assertSuccess(maxPolygonToCellsSize(polygon, res, flags, &size));
+    H3Index *cells = calloc(size, sizeof(H3Index));
+    t_assertSuccess(polygonToCells(polygon, res, flags, cells));
+    *count = 0;
+    for (int64_t i = 0; i < size; i++) {
+        if (cells[i] != H3_NULL) {
+            cells[(*count)++] = cells[i];
+        }
+    }
+    qsort(cells, *count, sizeof(H3Index), compareCells);
+    return cells;
+}
+
+static LatLng sfVerts[] = {
+    {0.659966917655, -2.1364398519396},  {0.6595011102219, -2.1359434279405},
+    {0.6583348114025, -2.1354884206045}, {0.6581220034068, -2.1382437718946},
+    {0.6594479998527, -2.1384597563896}, {0.6599990002976, -2.1376771158464}};
+// A triangle away from San Francisco.
+static LatLng triangleVerts[] = {{0.5, 0.5}, {0.51, 0.5}, {0.5, 0.51}};
+
+SUITE(zoneIndex) {
+    // Zones 7 (twice, as two polygons), 9, and an empty one.
+    GeoPolygon zones[] = {
+        {.geoloop = {.numVerts = 6, .verts = sfVerts}},
+        {.geoloop = {.numVerts = 6, .verts = sfVerts}},
+        {.geoloop = {.numVerts = 3, .verts = triangleVerts}},
+        {.geoloop = {.numVerts = 0}}};
+    int64_t ids[] = {7, 7, 9, 11};
+
+    TEST(exactJoin) {
+        H3ZoneIndex *index;
+        t_assertSuccess(createZoneIndex(zones, ids, 4, 8, &index));
+
+        // The centers of the cells covering the polygon: the centers inside
+        // it are the ones of the center containment fill.
+        int64_t coverSize;
+        H3Index *cover =
+            fill(&zones[0], 10, CONTAINMENT_OVERLAPPING, &coverSize);
+        int64_t insideSize;
+        H3Index *inside = fill(&zones[0], 10, CONTAINMENT_CENTER, &insideSize);
+        LatLng *points = calloc(coverSize, sizeof(LatLng));
+        for (int64_t i = 0; i < coverSize; i++) {
+            t_assertSuccess(cellToLatLng(cover[i], &points[i]));
+        }
+
+        int64_t *out = calloc(coverSize, sizeof(int64_t));
+        int64_t *offsets = calloc(coverSize + 1, sizeof(int64_t));
+        int64_t *parallelOut = calloc(coverSize, sizeof(int64_t));
+        int64_t *parallelOffsets = calloc(coverSize + 1, sizeof(int64_t));
+        t_assertSuccess(latLngsToZoneIds(index, points, coverSize, out,
+                                         coverSize, offsets));
+        t_assertSuccess(latLngsToZoneIdsParallel(index, points, coverSize,
+                                                 parallelOut, coverSize,
+                                                 parallelOffsets));
+        int64_t joined = 0;
+        for (int64_t i = 0; i < coverSize; i++) {
+            const int64_t count = offsets[i + 1] - offsets[i];
+            const int expected =
+                bsearch(&cover[i], inside, insideSize, sizeof(H3Index),
+                        compareCells) != NULL;
+            t_assert(count == (expected ? 1 : 0), "exact containment");
+            t_assert(count == 0 || out[offsets[i]] == 7, "zone ID");
+            t_assert(parallelOffsets[i + 1] == offsets[i + 1],
+                     "same offsets in parallel");
+            joined += count;
+        }
+        t_assert(joined == insideSize, "every point inside joined");
+        for (int64_t i = 0; i < joined; i++) {
+            t_assert(parallelOut[i] == out[i], "same zones in parallel");
+        }
+
+        LatLng others[2] = {{0.503, 0.503}, {0.0, 0.0}};
+        t_assertSuccess(latLngsToZoneIds(index, others, 2, out, 2, offsets));
+        t_assert(offsets[1] == 1 && out[0] == 9, "point in the triangle");
+        t_assert(offsets[2] == 1, "point outside every zone");
+
+        free(parallelOffsets);
+        free(parallelOut);
+        free(offsets);
+        free(out);
+        free(points);
+        free(inside);
+        free(cover);
+        destroyZoneIndex(index);
+    }
+
+    TEST(errors) {
+        H3ZoneIndex *index;
+        t_assert(createZoneIndex(zones, ids, 4, 16, &index) == E_RES_DOMAIN,
+                 "invalid resolution");
+        t_assertSuccess(createZoneIndex(zones, ids, 4, 6, &index));
+
+        LatLng points[2] = {{NAN, 0.0}, {0.503, 0.503}};
+        int64_t out[1];
+        int64_t offsets[3];
+        t_assert(latLngsToZoneIds(index, points, 2, out, 1, offsets) ==
+                     E_LATLNG_DOMAIN,
+                 "invalid point");
+        t_assert(offsets[1] == 0 && offsets[2] == 1 && out[0] == 9,
+                 "other points joined");
+        t_assert(latLngsToZoneIds(index, points, 2, out, 0, offsets) ==
+                     E_MEMORY_BOUNDS,
+                 "output too small");
+        t_assert(offsets[2] == 1, "required size is reported");
+        t_assert(latLngsToZoneIds(NULL, points, 2, out, 1, offsets) == E_FAILED,
+                 "index required");
+
+        destroyZoneIndex(index);
+        destroyZoneIndex(NULL);
+    }
+}
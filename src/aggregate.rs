@@ -0,0 +1,221 @@
+//! Roll-ups of values attached to cells, up to coarser resolutions.
+//!
+//! The cells being sorted, the children of a parent are contiguous: every
+//! resolution only keeps the parent being aggregated, which is complete (and
+//! handed over to the next coarser resolution) as soon as a cell of another
+//! parent is read. No hashing, and a single pass over the input.
+
+use crate::{cell, convert, H3Error, H3ErrorCodes, H3Index};
+use std::ffi::c_int;
+
+/// Reducers of the aggregated values, passed as `reducer`.
+///
+/// cbindgen:rename-all=ScreamingSnakeCase
+#[repr(u32)]
+#[derive(Debug, Copy, Clone)]
+#[non_exhaustive]
+pub enum AggregateReducer {
+    /// Sum of the values.
+    ReducerSum = 0,
+    /// Minimum of the values.
+    ReducerMin = 1,
+    /// Maximum of the values.
+    ReducerMax = 2,
+    /// Number of input cells (the values are ignored).
+    ReducerCount = 3,
+}
+
+/// Bit mask of the resolution of an index.
+const RESOLUTION_MASK: u64 = 0xf << 52;
+
+/// aggregateCellsToParents rolls up the values attached to cells to every
+/// resolution from theirs up to `coarsestRes`, in a single pass.
+///
+/// The cells must be sorted in ascending order. A cell may appear several
+/// times: its values are aggregated as well.
+///
+/// The output holds one level per resolution, from `coarsestRes` to `res`:
+/// level `i` (at resolution `coarsestRes + i`) holds the cells at
+/// `outCells[outOffsets[i]]` up to `outCells[outOffsets[i + 1]]`, excluded, in
+/// ascending order, and their aggregated values at the same positions of
+/// `outValues`. Every level has at most `numCells` cells, so an output array of
+/// `numCells * (res - coarsestRes + 1)` elements is always large enough.
+///
+/// @param cells       The cells, all at resolution `res`, sorted
+/// @param values      The value of every cell (may be NULL with REDUCER_COUNT)
+/// @param numCells    The number of cells
+/// @param res         The resolution of the cells
+/// @param coarsestRes The coarsest resolution to aggregate to
+/// @param reducer     The reducer of the values (see AggregateReducer)
+/// @param outCells    The cells of every level (preallocated)
+/// @param outValues   The aggregated values of every level (preallocated)
+/// @param numOut      The size of the output arrays to bound check against
+/// @param outOffsets  The start of every level in the output arrays, followed
+///                    by the total number of cells (`res - coarsestRes + 2`
+///                    elements)
+/// @return E_CELL_INVALID if a cell is invalid, E_RES_MISMATCH if a cell isn't
+/// at `res` or `coarsestRes` is finer than `res`, E_FAILED if the cells aren't
+/// sorted, E_OPTION_INVALID if the reducer is unknown, E_MEMORY_BOUNDS if the
+/// output arrays are too small.
+///
+/// # Safety
+///
+/// `cells` and `values` (unless NULL) must points to arrays of at least
+/// `numCells` elements. `outCells` and `outValues` must points to arrays of at
+/// least `numOut` elements, `outOffsets` to an array of at least
+/// `res - coarsestRes + 2` elements.
+#[no_mangle]
+pub unsafe extern "C" fn aggregateCellsToParents(
+    cells: *const H3Index,
+    values: *const f64,
+    numCells: i64,
+    res: c_int,
+    coarsestRes: c_int,
+    reducer: u32,
+    outCells: *mut H3Index,
+    outValues: *mut f64,
+    numOut: i64,
+    outOffsets: *mut i64,
+) -> H3Error {
+    unsafe fn inner(
+        cells: *const H3Index,
+        values: *const f64,
+        numCells: i64,
+        res: c_int,
+        coarsestRes: c_int,
+        reducer: u32,
+    ) -> Result<Vec<Level>, H3Error> {
+        let res = u8::from(convert::h3res_to_resolution(res)?);
+        let coarsest = u8::from(convert::h3res_to_resolution(coarsestRes)?);
+        if coarsest > res {
+            return Err(H3ErrorCodes::EResMismatch.into());
+        }
+        let (reduce, count): (fn(f64, f64) -> f64, _) = match reducer {
+            0 => (|a, b| a + b, false),
+            1 => (f64::min, false),
+            2 => (f64::max, false),
+            3 => (|a, b| a + b, true),
+            _ => return Err(H3ErrorCodes::EOptionInvalid.into()),
+        };
+        let len =
+            usize::try_from(numCells).map_err(|_| H3ErrorCodes::EDomain)?;
+        if !count && values.is_null() && len != 0 {
+            return Err(H3ErrorCodes::EFailed.into());
+        }
+
+        let mut levels = (coarsest..=res).map(|_| Level::default()).collect();
+        if len == 0 {
+            return Ok(levels);
+        }
+        let cells = std::slice::from_raw_parts(cells, len);
+        let values = (!count).then(|| std::slice::from_raw_parts(values, len));
+        let mut prev = None;
+        for (i, &cell) in cells.iter().enumerate() {
+            if !cell::is_valid_cell_bits(cell) {
+                return Err(H3ErrorCodes::ECellInvalid.into());
+            }
+            if (cell & RESOLUTION_MASK) >> 52 != u64::from(res) {
+                return Err(H3ErrorCodes::EResMismatch.into());
+            }
+            if prev.is_some_and(|prev| prev > cell) {
+                return Err(H3ErrorCodes::EFailed.into());
+            }
+            prev = Some(cell);
+            let value = values.map_or(1., |values| values[i]);
+            add(&mut levels, cell, value, reduce);
+        }
+        finish(&mut levels, reduce);
+        Ok(levels)
+    }
+
+    let levels = match inner(cells, values, numCells, res, coarsestRes, reducer)
+    {
+        Ok(levels) => levels,
+        Err(err) => return err,
+    };
+    if levels.iter().map(|level| level.cells.len()).sum::<usize>()
+        > usize::try_from(numOut).unwrap_or_default()
+    {
+        return H3ErrorCodes::EMemoryBounds.into();
+    }
+
+    let offsets = std::slice::from_raw_parts_mut(outOffsets, levels.len() + 1);
+    let mut offset = 0;
+    // Levels are built from the finest, and written from the coarsest.
+    for (i, level) in levels.iter().rev().enumerate() {
+        offsets[i] = i64::try_from(offset).expect("output too large");
+        let count = level.cells.len();
+        if count != 0 {
+            std::slice::from_raw_parts_mut(outCells.add(offset), count)
+                .copy_from_slice(&level.cells);
+            std::slice::from_raw_parts_mut(outValues.add(offset), count)
+                .copy_from_slice(&level.values);
+        }
+        offset += count;
+    }
+    offsets[levels.len()] = i64::try_from(offset).expect("output too large");
+    H3ErrorCodes::ESuccess.into()
+}
+
+// -----------------------------------------------------------------------------
+
+/// Aggregates of a resolution.
+#[derive(Default)]
+struct Level {
+    /// Complete aggregates, in ascending order.
+    cells: Vec<u64>,
+    /// Values of the complete aggregates.
+    values: Vec<f64>,
+    /// Aggregate being built, and its value so far.
+    current: Option<(u64, f64)>,
+}
+
+/// Adds a value to the aggregate of `cell`, at the finest of `levels`.
+///
+/// When `cell` starts a new aggregate, the previous one is complete and is
+/// added to the next coarser level, recursively.
+fn add(
+    levels: &mut [Level],
+    cell: u64,
+    value: f64,
+    reduce: fn(f64, f64) -> f64,
+) {
+    let Some((level, coarser)) = levels.split_first_mut() else {
+        return;
+    };
+    match level.current {
+        Some((current, aggregate)) if current == cell => {
+            level.current = Some((cell, reduce(aggregate, value)));
+        }
+        previous => {
+            level.current = Some((cell, value));
+            if let Some((done, aggregate)) = previous {
+                level.cells.push(done);
+                level.values.push(aggregate);
+                if !coarser.is_empty() {
+                    add(coarser, parent(done), aggregate, reduce);
+                }
+            }
+        }
+    }
+}
+
+/// Completes the aggregates being built, from the finest level.
+fn finish(levels: &mut [Level], reduce: fn(f64, f64) -> f64) {
+    for i in 0..levels.len() {
+        let (level, coarser) = levels[i..].split_first_mut().expect("level");
+        if let Some((cell, aggregate)) = level.current.take() {
+            level.cells.push(cell);
+            level.values.push(aggregate);
+            if !coarser.is_empty() {
+                add(coarser, parent(cell), aggregate, reduce);
+            }
+        }
+    }
+}
+
+/// Returns the parent of a cell, one resolution coarser.
+const fn parent(cell: u64) -> u64 {
+    let res = (cell & RESOLUTION_MASK) >> 52;
+    (cell & !RESOLUTION_MASK) | ((res - 1) << 52) | (0b111 << (3 * (15 - res)))
+}
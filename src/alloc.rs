@@ -0,0 +1,257 @@
+//! Global allocator of the library, routing every allocation (the crate's and
+//! its dependencies') to the allocator hooks set with `h3SetAllocator`.
+//!
+//! Every block starts with a small header recording the hooks it was
+//! allocated with (or none, for the system allocator), so that blocks are
+//! always released through the allocator they come from, even when the hooks
+//! change in-between.
+
+use crate::{H3Error, H3ErrorCodes};
+use std::{
+    alloc::{GlobalAlloc, Layout, System},
+    ffi::c_void,
+    mem::MaybeUninit,
+    ptr,
+    sync::atomic::{AtomicPtr, Ordering},
+};
+
+/// Allocates `size` bytes, like `malloc`.
+pub type H3Malloc =
+    unsafe extern "C" fn(size: usize, context: *mut c_void) -> *mut c_void;
+
+/// Allocates `count * size` zeroed bytes, like `calloc`.
+pub type H3Calloc = unsafe extern "C" fn(
+    count: usize,
+    size: usize,
+    context: *mut c_void,
+) -> *mut c_void;
+
+/// Resizes a block to `size` bytes, like `realloc`.
+pub type H3Realloc = unsafe extern "C" fn(
+    ptr: *mut c_void,
+    size: usize,
+    context: *mut c_void,
+) -> *mut c_void;
+
+/// Releases a block, like `free`.
+pub type H3Free = unsafe extern "C" fn(ptr: *mut c_void, context: *mut c_void);
+
+/// Allocator hooks along with their context.
+struct Hooks {
+    malloc: H3Malloc,
+    calloc: H3Calloc,
+    realloc: H3Realloc,
+    free: H3Free,
+    context: *mut c_void,
+}
+
+/// Current hooks (null for the system allocator).
+///
+/// Hooks are never freed: blocks allocated with them may outlive them.
+static HOOKS: AtomicPtr<Hooks> = AtomicPtr::new(ptr::null_mut());
+
+/// Header stored right before every block.
+#[derive(Clone, Copy)]
+struct Header {
+    /// Start of the underlying allocation.
+    raw: *mut u8,
+    /// Hooks the block was allocated with (null for the system allocator).
+    hooks: *const Hooks,
+}
+
+/// Alignment of the underlying allocations.
+const RAW_ALIGN: usize = align_of::<Header>();
+
+/// Global allocator dispatching to the allocator hooks.
+pub struct Allocator;
+
+impl Allocator {
+    /// Returns the size of the underlying allocation of a block.
+    ///
+    /// It leaves room for the header and for aligning the block.
+    const fn raw_size(layout: Layout) -> Option<usize> {
+        layout
+            .size()
+            .checked_add(size_of::<Header>() + layout.align())
+    }
+
+    /// Returns the layout of the underlying allocation, for the system
+    /// allocator.
+    fn raw_layout(size: usize) -> Option<Layout> {
+        Layout::from_size_align(size, RAW_ALIGN).ok()
+    }
+
+    /// Allocates a block, zeroed or not.
+    unsafe fn allocate(layout: Layout, zeroed: bool) -> *mut u8 {
+        let hooks = HOOKS.load(Ordering::Acquire).cast_const();
+        let Some(size) = Self::raw_size(layout) else {
+            return ptr::null_mut();
+        };
+        let raw = match (hooks.as_ref(), Self::raw_layout(size)) {
+            (Some(hooks), _) if zeroed => {
+                (hooks.calloc)(1, size, hooks.context).cast::<u8>()
+            }
+            (Some(hooks), _) => (hooks.malloc)(size, hooks.context).cast(),
+            (None, Some(raw_layout)) if zeroed => {
+                System.alloc_zeroed(raw_layout)
+            }
+            (None, Some(raw_layout)) => System.alloc(raw_layout),
+            (None, None) => ptr::null_mut(),
+        };
+        if raw.is_null() {
+            return raw;
+        }
+        Self::place(Header { raw, hooks }, layout.align())
+    }
+
+    /// Returns the (aligned) block of an underlying allocation.
+    unsafe fn block(raw: *mut u8, align: usize) -> *mut u8 {
+        let start = raw.add(size_of::<Header>());
+        start.add(start.align_offset(align.max(RAW_ALIGN)))
+    }
+
+    /// Returns the block of an underlying allocation, after writing its
+    /// header.
+    unsafe fn place(header: Header, align: usize) -> *mut u8 {
+        let block = Self::block(header.raw, align);
+        ptr::copy_nonoverlapping(
+            ptr::from_ref(&header).cast::<u8>(),
+            block.sub(size_of::<Header>()),
+            size_of::<Header>(),
+        );
+        block
+    }
+
+    /// Reads the header of a block.
+    const unsafe fn header(block: *mut u8) -> Header {
+        let mut header = MaybeUninit::<Header>::uninit();
+        ptr::copy_nonoverlapping(
+            block.sub(size_of::<Header>()),
+            header.as_mut_ptr().cast::<u8>(),
+            size_of::<Header>(),
+        );
+        header.assume_init()
+    }
+}
+
+// SAFETY: blocks are aligned and sized according to their layout, and always
+// released by the allocator they come from.
+unsafe impl GlobalAlloc for Allocator {
+    unsafe fn alloc(&self, layout: Layout) -> *mut u8 {
+        Self::allocate(layout, false)
+    }
+
+    unsafe fn alloc_zeroed(&self, layout: Layout) -> *mut u8 {
+        Self::allocate(layout, true)
+    }
+
+    unsafe fn dealloc(&self, block: *mut u8, layout: Layout) {
+        let header = Self::header(block);
+        if let Some(hooks) = header.hooks.as_ref() {
+            (hooks.free)(header.raw.cast(), hooks.context);
+        } else {
+            // The layout was valid when the block was allocated.
+            let raw_layout = Self::raw_size(layout)
+                .and_then(Self::raw_layout)
+                .unwrap_or(layout);
+            System.dealloc(header.raw, raw_layout);
+        }
+    }
+
+    unsafe fn realloc(
+        &self,
+        block: *mut u8,
+        layout: Layout,
+        new_size: usize,
+    ) -> *mut u8 {
+        let header = Self::header(block);
+        let offset = block.offset_from(header.raw);
+        let (Some(old_size), Ok(new_layout)) = (
+            Self::raw_size(layout),
+            Layout::from_size_align(new_size, layout.align()),
+        ) else {
+            return ptr::null_mut();
+        };
+        let Some(size) = Self::raw_size(new_layout) else {
+            return ptr::null_mut();
+        };
+        // Resized blocks stay with the allocator they come from.
+        let raw = match (header.hooks.as_ref(), Self::raw_layout(old_size)) {
+            (Some(hooks), _) => {
+                (hooks.realloc)(header.raw.cast(), size, hooks.context).cast()
+            }
+            (None, Some(raw_layout)) => {
+                System.realloc(header.raw, raw_layout, size)
+            }
+            (None, None) => ptr::null_mut(),
+        };
+        if raw.is_null() {
+            return raw;
+        }
+
+        // The underlying allocation may have moved to an address with
+        // another alignment: move the content along (before writing the
+        // header, which may overlap it) if so.
+        let new_block = Self::block(raw, layout.align());
+        let moved = raw.offset(offset);
+        if moved != new_block {
+            ptr::copy(moved, new_block, layout.size().min(new_size));
+        }
+        Self::place(
+            Header {
+                raw,
+                hooks: header.hooks,
+            },
+            layout.align(),
+        )
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/// h3SetAllocator routes every memory allocation of the library to the
+/// provided functions, including the memory handed over to the caller (e.g.
+/// by cellsToLinkedMultiPolygon) and the internal temporaries.
+///
+/// Blocks are always released through the functions they were allocated
+/// with, so the hooks can be changed at any time. Passing NULL for every
+/// function restores the system allocator.
+///
+/// @param malloc  Allocates a block, like `malloc`
+/// @param calloc  Allocates a zeroed block, like `calloc`
+/// @param realloc Resizes a block, like `realloc`
+/// @param free    Releases a block, like `free`
+/// @param context Pointer given back to every call of the functions
+/// @return E_OPTION_INVALID if only some functions are NULL, E_SUCCESS
+///         otherwise.
+///
+/// # Safety
+///
+/// The functions must be callable from any thread, and behave like their
+/// standard counterparts: in particular, blocks must be aligned for any
+/// fundamental type.
+#[no_mangle]
+pub unsafe extern "C" fn h3SetAllocator(
+    malloc: Option<H3Malloc>,
+    calloc: Option<H3Calloc>,
+    realloc: Option<H3Realloc>,
+    free: Option<H3Free>,
+    context: *mut c_void,
+) -> H3Error {
+    let hooks = match (malloc, calloc, realloc, free) {
+        (Some(malloc), Some(calloc), Some(realloc), Some(free)) => {
+            Box::into_raw(Box::new(Hooks {
+                malloc,
+                calloc,
+                realloc,
+                free,
+                context,
+            }))
+        }
+        (None, None, None, None) => ptr::null_mut(),
+        _ => return H3ErrorCodes::EOptionInvalid.into(),
+    };
+    // Previous hooks are leaked on purpose: blocks may still refer to them.
+    HOOKS.store(hooks, Ordering::Release);
+    H3ErrorCodes::ESuccess.into()
+}
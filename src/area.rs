@@ -0,0 +1,116 @@
+//! Batch computation of cell areas.
+//!
+//! The areas are computed like `CellIndex::area_rads2` (sum of the spherical
+//! triangles between the center and every edge of the cell), but the work is
+//! split in passes over flat arrays: the trigonometric part runs in tight
+//! loops, and the great-circle arcs shared by two triangles are only measured
+//! once.
+
+use crate::{latlng, H3Index};
+use h3o::CellIndex;
+
+/// Number of cells processed per pass, so that the buffers stay in cache.
+const CHUNK_SIZE: usize = 256;
+
+/// Great-circle arcs to measure, stored as a structure of arrays.
+#[derive(Default)]
+struct Arcs {
+    lat1: Vec<f64>,
+    lng1: Vec<f64>,
+    lat2: Vec<f64>,
+    lng2: Vec<f64>,
+}
+
+impl Arcs {
+    fn push(&mut self, start: h3o::LatLng, end: h3o::LatLng) {
+        self.lat1.push(start.lat_radians());
+        self.lng1.push(start.lng_radians());
+        self.lat2.push(end.lat_radians());
+        self.lng2.push(end.lng_radians());
+    }
+
+    fn clear(&mut self) {
+        self.lat1.clear();
+        self.lng1.clear();
+        self.lat2.clear();
+        self.lng2.clear();
+    }
+
+    /// Computes the length (in radians) of every arc.
+    fn lengths(&self, out: &mut Vec<f64>) {
+        out.clear();
+        let starts = self.lat1.iter().copied().zip(self.lng1.iter().copied());
+        let ends = self.lat2.iter().copied().zip(self.lng2.iter().copied());
+        out.extend(starts.zip(ends).map(|((lat1, lng1), (lat2, lng2))| {
+            latlng::haversine(lat1, lng1, lat1.cos(), lat2, lng2)
+        }));
+    }
+}
+
+/// Computes the area of a spherical triangle from the length of its edges,
+/// using l'Huilier's theorem.
+fn triangle_area(ab: f64, bc: f64, ca: f64) -> f64 {
+    let s = (ab + bc + ca) / 2.;
+    let t = (s / 2.).tan()
+        * ((s - ab) / 2.).tan()
+        * ((s - bc) / 2.).tan()
+        * ((s - ca) / 2.).tan();
+    4. * t.sqrt().atan()
+}
+
+/// Computes the area (in radians²) of every cell into `out`.
+///
+/// Areas of invalid indexes are set to NaN, and false is returned if there was
+/// any.
+pub fn cells_area_rads2(cells: &[H3Index], out: &mut [f64]) -> bool {
+    let mut valid = true;
+    let mut arcs = Arcs::default();
+    let mut lengths = Vec::new();
+    let mut counts = Vec::with_capacity(CHUNK_SIZE);
+
+    for (cells, out) in cells.chunks(CHUNK_SIZE).zip(out.chunks_mut(CHUNK_SIZE))
+    {
+        // First pass: gather the arcs from the center to every vertex and
+        // between consecutive vertices, interleaved.
+        arcs.clear();
+        counts.clear();
+        for &cell in cells {
+            let Ok(index) = CellIndex::try_from(cell) else {
+                counts.push(None);
+                valid = false;
+                continue;
+            };
+            let center = h3o::LatLng::from(index);
+            let boundary = index.boundary();
+            for (i, &vertex) in boundary.iter().enumerate() {
+                let next = boundary[(i + 1) % boundary.len()];
+                arcs.push(center, vertex);
+                arcs.push(vertex, next);
+            }
+            counts.push(Some(boundary.len()));
+        }
+
+        // Second pass: the trigonometry, over flat arrays.
+        arcs.lengths(&mut lengths);
+
+        // Third pass: sum the triangles, each sharing its radial arcs with
+        // its neighbors.
+        let mut offset = 0;
+        for (area, count) in out.iter_mut().zip(counts.iter().copied()) {
+            let Some(count) = count else {
+                *area = f64::NAN;
+                continue;
+            };
+            let arcs = &lengths[offset..offset + 2 * count];
+            *area = (0..count)
+                .map(|i| {
+                    let next = (i + 1) % count;
+                    triangle_area(arcs[2 * i + 1], arcs[2 * next], arcs[2 * i])
+                })
+                .sum();
+            offset += 2 * count;
+        }
+    }
+
+    valid
+}
@@ -0,0 +1,327 @@
+//! Latitude/longitude bounding boxes of cells and cell sets.
+//!
+//! Boxes are folded from the boundary vertices of the cells, with the latitude of the edges bulging past their vertices (edges are great
+//! circle arcs) and the cells containing a pole accounted for, so that a box
+//! always contains its cell: they can be used as prefilters of range queries.
+
+use crate::{cell, H3Error, H3ErrorCodes, H3Index, H3_NULL};
+use h3o::{CellIndex, Resolution};
+use std::{
+    f64::consts::{FRAC_PI_2, PI, TAU},
+    sync::OnceLock,
+};
+
+/// A latitude/longitude bounding box, in radians.
+///
+/// A box crossing the antimeridian has its east bound lower than its west
+/// bound.
+#[repr(C)]
+#[derive(Debug, Copy, Clone, PartialEq)]
+pub struct BBox {
+    /// North latitude.
+    pub north: f64,
+    /// South latitude.
+    pub south: f64,
+    /// East longitude.
+    pub east: f64,
+    /// West longitude.
+    pub west: f64,
+}
+
+impl BBox {
+    /// Box reported for invalid cells.
+    const INVALID: Self = Self {
+        north: f64::NAN,
+        south: f64::NAN,
+        east: f64::NAN,
+        west: f64::NAN,
+    };
+
+    /// Computes the box of a cell.
+    fn of_cell(cell: CellIndex) -> Self {
+        let boundary = cell.boundary();
+        let point = |i: usize| {
+            let ll = boundary[i % boundary.len()];
+            (ll.lat_radians(), ll.lng_radians())
+        };
+        let (mut north, mut south) = (-FRAC_PI_2, FRAC_PI_2);
+        for i in 0..boundary.len() {
+            let (high, low) = arc_latitudes(point(i), point(i + 1));
+            north = north.max(high);
+            south = south.min(low);
+        }
+
+        let [north_pole, south_pole] =
+            pole_cells()[usize::from(cell.resolution())];
+        if cell == north_pole {
+            return Self {
+                north: FRAC_PI_2,
+                south,
+                east: PI,
+                west: -PI,
+            };
+        }
+        if cell == south_pole {
+            return Self {
+                north,
+                south: -FRAC_PI_2,
+                east: PI,
+                west: -PI,
+            };
+        }
+
+        let (mut east, mut west) = (-PI, PI);
+        for ll in boundary.iter() {
+            east = east.max(ll.lng_radians());
+            west = west.min(ll.lng_radians());
+        }
+        if east - west > PI {
+            // No cell but the polar ones is that wide: the cell crosses the
+            // antimeridian, and the bounds are the closest to it.
+            (east, west) = (-PI, PI);
+            for lng in boundary.iter().map(|ll| ll.lng_radians()) {
+                if lng < 0. {
+                    east = east.max(lng);
+                } else {
+                    west = west.min(lng);
+                }
+            }
+        }
+        Self {
+            north,
+            south,
+            east,
+            west,
+        }
+    }
+
+    /// Returns the longitude span of the box, as an interval starting in
+    /// `[-PI, PI]`, possibly ending past PI.
+    fn longitudes(&self) -> (f64, f64) {
+        if self.east < self.west {
+            (self.west, self.east + TAU)
+        } else {
+            (self.west, self.east)
+        }
+    }
+
+    /// Computes the box of a set of boxes.
+    fn union(boxes: &[Self]) -> Option<Self> {
+        let north = boxes.iter().map(|b| b.north).reduce(f64::max)?;
+        let south = boxes.iter().map(|b| b.south).reduce(f64::min)?;
+
+        // The longitudes are bounded by the complement of the largest gap
+        // between the spans of the boxes, around the circle.
+        let mut spans = boxes.iter().map(Self::longitudes).collect::<Vec<_>>();
+        spans.sort_unstable_by(|a, b| a.0.total_cmp(&b.0));
+        let first = spans[0].0;
+        // The spans crossing the antimeridian also cover the start of the
+        // circle, up to their east bound: no gap can start before.
+        let mut reach = spans
+            .iter()
+            .map(|&(_, east)| east - TAU)
+            .fold(spans[0].1, f64::max);
+        let mut gap = (0., reach, first + TAU);
+        for &(west, east) in &spans[1..] {
+            if west > reach && west - reach > gap.0 {
+                gap = (west - reach, reach, west);
+            }
+            reach = reach.max(east);
+        }
+        // The gap wrapping around the circle is only known now.
+        let wrap = first + TAU - reach;
+        if wrap >= gap.0 {
+            gap = (wrap, reach, first + TAU);
+        }
+        let (east, west) = if gap.0 <= 0. {
+            (PI, -PI)
+        } else {
+            (wrap_longitude(gap.1), wrap_longitude(gap.2))
+        };
+        Some(Self {
+            north,
+            south,
+            east,
+            west,
+        })
+    }
+}
+
+/// Returns the highest and lowest latitudes of the great circle arc between
+/// two points.
+///
+/// Besides its endpoints, an arc may reach its extrema at the points of its
+/// great circle the closest to the poles, if they're on the arc.
+fn arc_latitudes(start: (f64, f64), end: (f64, f64)) -> (f64, f64) {
+    let (from, to) = (to_vector(start), to_vector(end));
+    let mut high = start.0.max(end.0);
+    let mut low = start.0.min(end.0);
+    let normal = cross(from, to);
+    let norm = dot(normal, normal).sqrt();
+    if norm == 0. {
+        return (high, low);
+    }
+    let axis = normal.map(|x| x / norm);
+    // Point of the great circle the closest to the north pole (the opposite
+    // one is the closest to the south pole).
+    let top = [
+        -axis[2] * axis[0],
+        -axis[2] * axis[1],
+        axis[2].mul_add(-axis[2], 1.),
+    ];
+    let length = dot(top, top).sqrt();
+    if length == 0. {
+        // The arc is on the equator.
+        return (high, low);
+    }
+    let top = top.map(|x| x / length);
+    let on_arc = |point: [f64; 3]| {
+        dot(cross(from, point), normal) >= 0.
+            && dot(cross(point, to), normal) >= 0.
+    };
+    if on_arc(top) {
+        high = high.max(top[2].asin());
+    }
+    if on_arc(top.map(|x| -x)) {
+        low = low.min((-top[2]).asin());
+    }
+    (high, low)
+}
+
+/// Returns the unit vector of a latitude/longitude pair.
+fn to_vector((lat, lng): (f64, f64)) -> [f64; 3] {
+    [lat.cos() * lng.cos(), lat.cos() * lng.sin(), lat.sin()]
+}
+
+/// Cross product.
+fn cross(a: [f64; 3], b: [f64; 3]) -> [f64; 3] {
+    [
+        a[1].mul_add(b[2], -a[2] * b[1]),
+        a[2].mul_add(b[0], -a[0] * b[2]),
+        a[0].mul_add(b[1], -a[1] * b[0]),
+    ]
+}
+
+/// Dot product.
+fn dot(a: [f64; 3], b: [f64; 3]) -> f64 {
+    a[0].mul_add(b[0], a[1].mul_add(b[1], a[2] * b[2]))
+}
+
+/// Maps a longitude in `[-PI, 3PI]` back to `[-PI, PI]`.
+fn wrap_longitude(lng: f64) -> f64 {
+    if lng > PI {
+        lng - TAU
+    } else {
+        lng
+    }
+}
+
+/// Returns the cells containing the north and south poles, at every
+/// resolution.
+fn pole_cells() -> &'static [[CellIndex; 2]; 16] {
+    static CELLS: OnceLock<[[CellIndex; 2]; 16]> = OnceLock::new();
+    CELLS.get_or_init(|| {
+        let north = h3o::LatLng::from_radians(FRAC_PI_2, 0.).expect("pole");
+        let south = h3o::LatLng::from_radians(-FRAC_PI_2, 0.).expect("pole");
+        std::array::from_fn(|res| {
+            let res = Resolution::try_from(u8::try_from(res).expect("res"))
+                .expect("valid resolution");
+            [north.to_cell(res), south.to_cell(res)]
+        })
+    })
+}
+
+// -----------------------------------------------------------------------------
+
+/// cellsToBBoxes computes the bounding box of every cell of an array.
+///
+/// The boxes are computed from the boundary of the cells (as cellToBoundary),
+/// and contain their cells entirely: the edges are great circle arcs, which may bulge past the latitude of their
+/// vertices, and the cells containing a pole span every longitude.
+///
+/// An invalid cell doesn't stop the batch: its box is set to NaN and an error
+/// is returned once every cell has been processed.
+///
+/// @param cells    The cells
+/// @param numCells The number of cells
+/// @param out      The bounding box of every cell
+/// @return E_CELL_INVALID if any cell is invalid, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `cells` and `out` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToBBoxes(
+    cells: *const H3Index,
+    numCells: i64,
+    out: *mut BBox,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let cells = std::slice::from_raw_parts(cells, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    let mut valid = true;
+    for (bbox, &index) in out.iter_mut().zip(cells) {
+        *bbox = if cell::is_valid_cell_bits(index) {
+            BBox::of_cell(CellIndex::try_from(index).expect("valid cell"))
+        } else {
+            valid = false;
+            BBox::INVALID
+        };
+    }
+    if valid {
+        H3ErrorCodes::ESuccess.into()
+    } else {
+        H3ErrorCodes::ECellInvalid.into()
+    }
+}
+
+/// cellsToBBox computes the bounding box of a set of cells, at any resolution.
+///
+/// The cost is one box per cell, so the box of a region is cheaper to get from
+/// its compacted set (see compactCells). The box is the smallest holding the
+/// boxes of the cells (see cellsToBBoxes): its longitudes span the circle but
+/// the largest gap between the cells, so it may cross the antimeridian.
+/// H3_NULL entries are ignored.
+///
+/// @param cells    The cells of the set
+/// @param numCells The number of cells
+/// @param out      The bounding box of the set (untouched if the set is
+///                 empty)
+/// @return E_CELL_INVALID if any cell is invalid, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToBBox(
+    cells: *const H3Index,
+    numCells: i64,
+    out: Option<&mut BBox>,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let cells = if len == 0 {
+        &[]
+    } else {
+        std::slice::from_raw_parts(cells, len)
+    };
+
+    let mut boxes = Vec::with_capacity(len);
+    for &index in cells.iter().filter(|&&index| index != H3_NULL) {
+        let Ok(cell) = CellIndex::try_from(index) else {
+            return H3ErrorCodes::ECellInvalid.into();
+        };
+        boxes.push(BBox::of_cell(cell));
+    }
+    if let Some(bbox) = BBox::union(&boxes) {
+        *out.expect("null pointer") = bbox;
+    }
+    H3ErrorCodes::ESuccess.into()
+}
@@ -0,0 +1,339 @@
+//! Compact binary serialization of cell sets.
+//!
+//! Cells are grouped by resolution and, within a group, only the base cell and
+//! the digits up to the group resolution are kept (the mode, the resolution
+//! and the unused digits are implied). Those keys are sorted and
+//! delta-encoded as LEB128 varints, so that cells sharing their base cell and
+//! high digits only cost a byte or two each.
+//!
+//! Layout:
+//! - magic number `H3C` followed by the format version (4 bytes);
+//! - number of groups (1 byte);
+//! - for every group: its resolution (1 byte) and number of cells (varint);
+//! - for every group, in the same order: the deltas between its consecutive
+//!   keys (varints, the first one being relative to zero).
+
+use crate::{delegate_inner, H3Error, H3ErrorCodes, H3Index, H3_NULL};
+use h3o::{CellIndex, Resolution};
+
+/// Magic number and format version.
+const MAGIC: &[u8; 4] = b"H3C\x01";
+
+/// Number of resolutions, hence the max number of groups.
+const RESOLUTION_COUNT: usize = 16;
+
+/// Bits of a cell index outside of its key: cell mode and resolution.
+const CELL_MODE: u64 = 1 << 59;
+
+/// Returns the bit offset of the digits below the resolution.
+fn unused_digits_offset(resolution: Resolution) -> u32 {
+    3 * (15 - u32::from(u8::from(resolution)))
+}
+
+/// Returns the key of the cell: base cell and digits, without the unused
+/// digits.
+fn key(cell: CellIndex) -> u64 {
+    let resolution = cell.resolution();
+    let offset = unused_digits_offset(resolution);
+    let width = 7 + 3 * u32::from(u8::from(resolution));
+    (u64::from(cell) >> offset) & ((1 << width) - 1)
+}
+
+/// Rebuilds the cell from its key and resolution.
+fn cell(resolution: Resolution, key: u64) -> Result<CellIndex, H3Error> {
+    let offset = unused_digits_offset(resolution);
+    if key.leading_zeros() < offset + 12 {
+        return Err(H3ErrorCodes::EFailed.into());
+    }
+    let index = CELL_MODE
+        | (u64::from(u8::from(resolution)) << 52)
+        | (key << offset)
+        | ((1 << offset) - 1);
+    CellIndex::try_from(index).map_err(|_| H3ErrorCodes::EFailed.into())
+}
+
+/// Resolution and number of cells of a group.
+type Group = (Resolution, usize);
+
+/// Appends the LEB128 encoding of the value.
+fn write_varint(out: &mut Vec<u8>, mut value: u64) {
+    while value >= 0x80 {
+        out.push(u8::try_from(value & 0x7f).expect("7-bit") | 0x80);
+        value >>= 7;
+    }
+    out.push(u8::try_from(value).expect("7-bit"));
+}
+
+/// Reads a LEB128-encoded value, advancing the input.
+fn read_varint(bytes: &mut &[u8]) -> Result<u64, H3Error> {
+    let mut value = 0_u64;
+    for shift in (0..64).step_by(7) {
+        let (&byte, tail) = bytes
+            .split_first()
+            .ok_or_else(|| H3Error::from(H3ErrorCodes::EFailed))?;
+        *bytes = tail;
+        let bits = u64::from(byte & 0x7f);
+        if bits.leading_zeros() < shift {
+            break;
+        }
+        value |= bits << shift;
+        if byte & 0x80 == 0 {
+            return Ok(value);
+        }
+    }
+    // Overlong or overflowing encoding.
+    Err(H3ErrorCodes::EFailed.into())
+}
+
+/// Serializes the cells (in any order, possibly at mixed resolutions).
+pub fn encode(cells: impl IntoIterator<Item = CellIndex>) -> Vec<u8> {
+    let mut groups: [Vec<u64>; RESOLUTION_COUNT] =
+        std::array::from_fn(|_| Vec::new());
+    for cell in cells {
+        groups[usize::from(cell.resolution())].push(key(cell));
+    }
+    let groups = Resolution::range(Resolution::Zero, Resolution::Fifteen)
+        .zip(groups)
+        .filter(|group| !group.1.is_empty())
+        .collect::<Vec<_>>();
+
+    let mut out = Vec::with_capacity(
+        MAGIC.len()
+            + 1
+            + groups.iter().map(|group| group.1.len() * 2).sum::<usize>(),
+    );
+    out.extend_from_slice(MAGIC);
+    out.push(u8::try_from(groups.len()).expect("at most 16 groups"));
+    for &(resolution, ref keys) in &groups {
+        out.push(u8::from(resolution));
+        write_varint(
+            &mut out,
+            u64::try_from(keys.len()).expect("too many cells"),
+        );
+    }
+    for (_, mut keys) in groups {
+        keys.sort_unstable();
+        let mut previous = 0;
+        for key in keys {
+            write_varint(&mut out, key - previous);
+            previous = key;
+        }
+    }
+
+    out
+}
+
+/// Parses the header, returning the groups (resolution and number of cells)
+/// and the payload.
+pub fn decode_header(bytes: &[u8]) -> Result<(Vec<Group>, &[u8]), H3Error> {
+    let mut bytes = bytes
+        .strip_prefix(MAGIC)
+        .ok_or_else(|| H3Error::from(H3ErrorCodes::EFailed))?;
+    let (&count, tail) = bytes
+        .split_first()
+        .ok_or_else(|| H3Error::from(H3ErrorCodes::EFailed))?;
+    bytes = tail;
+    if usize::from(count) > RESOLUTION_COUNT {
+        return Err(H3ErrorCodes::EFailed.into());
+    }
+
+    let mut groups = Vec::with_capacity(usize::from(count));
+    for _ in 0..count {
+        let (&resolution, tail) = bytes
+            .split_first()
+            .ok_or_else(|| H3Error::from(H3ErrorCodes::EFailed))?;
+        bytes = tail;
+        let resolution = Resolution::try_from(resolution)
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        let size = usize::try_from(read_varint(&mut bytes)?)
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        groups.push((resolution, size));
+    }
+
+    Ok((groups, bytes))
+}
+
+/// Returns the number of serialized cells, without decoding them.
+pub fn cell_count(bytes: &[u8]) -> Result<usize, H3Error> {
+    let (groups, payload) = decode_header(bytes)?;
+    total_count(&groups, payload)
+}
+
+/// Returns the number of cells of the groups.
+///
+/// Every cell takes at least a byte, which bounds the count by the payload
+/// size (and guards against corrupted counts).
+fn total_count(groups: &[Group], payload: &[u8]) -> Result<usize, H3Error> {
+    groups
+        .iter()
+        .try_fold(0_usize, |acc, &(_, size)| acc.checked_add(size))
+        .filter(|&count| count <= payload.len())
+        .ok_or_else(|| H3ErrorCodes::EFailed.into())
+}
+
+/// Deserializes the cells into `out`, sorted by resolution then by index.
+///
+/// Returns the number of cells.
+pub fn decode(bytes: &[u8], out: &mut [H3Index]) -> Result<usize, H3Error> {
+    let (groups, mut payload) = decode_header(bytes)?;
+    let count = total_count(&groups, payload)?;
+    if count > out.len() {
+        return Err(H3ErrorCodes::EMemoryBounds.into());
+    }
+
+    let mut out = out.iter_mut();
+    for (resolution, size) in groups {
+        let mut key = 0_u64;
+        for dst in out.by_ref().take(size) {
+            key = key
+                .checked_add(read_varint(&mut payload)?)
+                .ok_or_else(|| H3Error::from(H3ErrorCodes::EFailed))?;
+            *dst = cell(resolution, key)?.into();
+        }
+    }
+    if !payload.is_empty() {
+        return Err(H3ErrorCodes::EFailed.into());
+    }
+
+    Ok(count)
+}
+
+/// cellsToBinary serializes a set of cells into a compact binary format.
+///
+/// Cells can be at mixed resolutions (e.g. `compactCells` output), and
+/// H3_NULL entries are skipped. The order of the cells is not preserved:
+/// they are decoded sorted by resolution then by index.
+///
+/// If the buffer is too small, nothing is written and E_MEMORY_BOUNDS is
+/// returned, but `written` is still set to the required size.
+///
+/// @param cells Cells to serialize
+/// @param numCells Number of cells
+/// @param out Output buffer
+/// @param size Size of the output buffer, in bytes
+/// @param written Number of bytes written
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements, and
+/// `out` to a buffer of at least `size` bytes.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToBinary(
+    cells: *const H3Index,
+    numCells: i64,
+    out: *mut u8,
+    size: usize,
+    written: Option<&mut usize>,
+) -> H3Error {
+    unsafe fn inner(
+        cells: *const H3Index,
+        numCells: i64,
+    ) -> Result<Vec<u8>, H3Error> {
+        let len =
+            usize::try_from(numCells).map_err(|_| H3ErrorCodes::EDomain)?;
+        let indexes = if len == 0 {
+            &[]
+        } else {
+            std::slice::from_raw_parts(cells, len)
+        };
+        let cells = indexes
+            .iter()
+            .filter(|&&index| index != H3_NULL)
+            .map(|&index| CellIndex::try_from(index))
+            .collect::<Result<Vec<_>, _>>()?;
+        Ok(encode(cells))
+    }
+
+    let written = written.expect("null pointer");
+    *written = 0;
+    match inner(cells, numCells) {
+        Ok(bytes) => {
+            *written = bytes.len();
+            if bytes.len() > size {
+                return H3ErrorCodes::EMemoryBounds.into();
+            }
+            std::ptr::copy_nonoverlapping(bytes.as_ptr(), out, bytes.len());
+            H3ErrorCodes::ESuccess.into()
+        }
+        Err(err) => err,
+    }
+}
+
+/// binaryToCellsSize returns the number of cells serialized by
+/// `cellsToBinary`, without decoding them.
+///
+/// @param data Serialized cells
+/// @param size Size of the serialized data, in bytes
+/// @param out Number of cells
+/// @return E_FAILED if the data is not a valid serialized set.
+///
+/// # Safety
+///
+/// `data` must points to a buffer of at least `size` bytes.
+#[no_mangle]
+pub unsafe extern "C" fn binaryToCellsSize(
+    data: *const u8,
+    size: usize,
+    out: Option<&mut i64>,
+) -> H3Error {
+    unsafe fn inner(data: *const u8, size: usize) -> Result<i64, H3Error> {
+        let bytes = if size == 0 {
+            &[]
+        } else {
+            std::slice::from_raw_parts(data, size)
+        };
+        i64::try_from(cell_count(bytes)?)
+            .map_err(|_| H3ErrorCodes::EFailed.into())
+    }
+
+    delegate_inner!(inner(data, size), out)
+}
+
+/// binaryToCells deserializes a set of cells serialized by `cellsToBinary`.
+///
+/// Cells are written sorted by resolution then by index.
+///
+/// @param data Serialized cells
+/// @param size Size of the serialized data, in bytes
+/// @param out Output cells
+/// @param maxCells Size of the output array, at least what
+///                 `binaryToCellsSize` returns
+/// @return E_MEMORY_BOUNDS if the output array is too small, E_FAILED if the
+///         data is not a valid serialized set.
+///
+/// # Safety
+///
+/// `data` must points to a buffer of at least `size` bytes, and `out` to an
+/// array of at least `maxCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn binaryToCells(
+    data: *const u8,
+    size: usize,
+    out: *mut H3Index,
+    maxCells: i64,
+) -> H3Error {
+    unsafe fn inner(
+        data: *const u8,
+        size: usize,
+        out: *mut H3Index,
+        maxCells: i64,
+    ) -> Result<(), H3Error> {
+        let len =
+            usize::try_from(maxCells).map_err(|_| H3ErrorCodes::EDomain)?;
+        let bytes = if size == 0 {
+            &[]
+        } else {
+            std::slice::from_raw_parts(data, size)
+        };
+        let out = if len == 0 {
+            &mut []
+        } else {
+            std::slice::from_raw_parts_mut(out, len)
+        };
+        decode(bytes, out).map(|_| ())
+    }
+
+    inner(data, size, out, maxCells)
+        .err()
+        .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
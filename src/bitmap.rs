@@ -0,0 +1,561 @@
+//! Dense cell sets, for coverages of a region at a single resolution.
+//!
+//! The cells are grouped in blocks by their ancestor a few resolutions
+//! coarser, and every block stores the child positions (see cellToChildPos)
+//! of its cells, as in a roaring bitmap: sparse blocks hold a sorted array of
+//! positions, dense ones a bitmap with a bit per child. Blocks switch from one
+//! representation to the other at the size where the bitmap gets smaller than
+//! the array, so a set never takes more than 2 bytes per cell, and much less
+//! for a filled region.
+
+use crate::{convert, delegate_inner, H3Error, H3ErrorCodes, H3Index, H3_NULL};
+use h3o::{CellIndex, Resolution};
+use std::{cmp::Ordering, collections::HashMap, ffi::c_int};
+
+/// Number of resolutions between a block and its cells, so that a position
+/// fits in 16 bits (7^5 = 16807 children).
+const BLOCK_DEPTH: u8 = 5;
+
+/// A set of cells at a single resolution, stored as a presence bitmap (or
+/// array) per block of cells.
+pub struct H3CellBitmap {
+    /// Resolution of the cells.
+    resolution: Resolution,
+    /// Resolution of the blocks.
+    block_resolution: Resolution,
+    /// Non-empty blocks, in ascending order.
+    blocks: Vec<(CellIndex, Container)>,
+    /// Position of every block in `blocks`.
+    lookup: HashMap<CellIndex, usize>,
+}
+
+impl H3CellBitmap {
+    /// Builds a set from its cell, all at `resolution` (H3_NULL entries are
+    /// ignored).
+    fn new(cells: &[H3Index], resolution: Resolution) -> Result<Self, H3Error> {
+        let block_resolution = block_resolution(resolution);
+        let mut entries = Vec::with_capacity(cells.len());
+        for &index in cells.iter().filter(|&&index| index != H3_NULL) {
+            let cell = CellIndex::try_from(index)
+                .map_err(|_| H3ErrorCodes::ECellInvalid)?;
+            if cell.resolution() != resolution {
+                return Err(H3ErrorCodes::EResMismatch.into());
+            }
+            let block = cell.parent(block_resolution).expect("coarser block");
+            entries.push((block, position(cell, block_resolution)));
+        }
+        entries.sort_unstable();
+        entries.dedup();
+
+        let mut blocks = Vec::new();
+        let mut start = 0;
+        while start < entries.len() {
+            let block = entries[start].0;
+            let end = start
+                + entries[start..].partition_point(|entry| entry.0 == block);
+            let positions = entries[start..end]
+                .iter()
+                .map(|&(_, position)| position)
+                .collect();
+            let container =
+                Container::from_array(positions, block_size(block, resolution));
+            blocks.push((block, container));
+            start = end;
+        }
+        Ok(Self::from_blocks(resolution, blocks))
+    }
+
+    /// Builds a set from its non-empty blocks, in ascending order.
+    fn from_blocks(
+        resolution: Resolution,
+        blocks: Vec<(CellIndex, Container)>,
+    ) -> Self {
+        let lookup = blocks
+            .iter()
+            .enumerate()
+            .map(|(i, &(block, _))| (block, i))
+            .collect();
+        Self {
+            resolution,
+            block_resolution: block_resolution(resolution),
+            blocks,
+            lookup,
+        }
+    }
+
+    /// Tests if a cell is in the set.
+    fn contains(&self, cell: CellIndex) -> bool {
+        if cell.resolution() != self.resolution {
+            return false;
+        }
+        let block = cell.parent(self.block_resolution).expect("coarser block");
+        self.lookup.get(&block).is_some_and(|&i| {
+            self.blocks[i]
+                .1
+                .contains(position(cell, self.block_resolution))
+        })
+    }
+
+    /// Returns the number of cells of the set.
+    fn len(&self) -> usize {
+        self.blocks.iter().map(|block| block.1.len()).sum()
+    }
+
+    /// Calls `f` on every cell of the set, in ascending order.
+    fn for_each(&self, mut f: impl FnMut(CellIndex)) {
+        for &(block, ref container) in &self.blocks {
+            container.for_each(|position| {
+                f(block
+                    .child_at(u64::from(position), self.resolution)
+                    .expect("child position"));
+            });
+        }
+    }
+
+    /// Merges two sets at the same resolution, block by block: `combine` is
+    /// called on the blocks found in both, `keep_single` tells if the blocks
+    /// found in only one set are kept.
+    fn merge(
+        &self,
+        other: &Self,
+        keep_single: bool,
+        combine: impl Fn(&Container, &Container, usize) -> Option<Container>,
+    ) -> Self {
+        let mut blocks = Vec::new();
+        let (mut left, mut right) = (self.blocks.iter(), other.blocks.iter());
+        let (mut a, mut b) = (left.next(), right.next());
+        loop {
+            match (a, b) {
+                (Some(&(x, ref first)), Some(&(y, ref second))) => {
+                    match x.cmp(&y) {
+                        Ordering::Less => {
+                            if keep_single {
+                                blocks.push((x, first.clone()));
+                            }
+                            a = left.next();
+                        }
+                        Ordering::Greater => {
+                            if keep_single {
+                                blocks.push((y, second.clone()));
+                            }
+                            b = right.next();
+                        }
+                        Ordering::Equal => {
+                            let size = block_size(x, self.resolution);
+                            if let Some(container) =
+                                combine(first, second, size)
+                            {
+                                blocks.push((x, container));
+                            }
+                            a = left.next();
+                            b = right.next();
+                        }
+                    }
+                }
+                (Some(&(x, ref first)), None) => {
+                    if !keep_single {
+                        break;
+                    }
+                    blocks.push((x, first.clone()));
+                    a = left.next();
+                }
+                (None, Some(&(y, ref second))) => {
+                    if !keep_single {
+                        break;
+                    }
+                    blocks.push((y, second.clone()));
+                    b = right.next();
+                }
+                (None, None) => break,
+            }
+        }
+        Self::from_blocks(self.resolution, blocks)
+    }
+}
+
+/// Child positions of the cells of a block.
+#[derive(Clone)]
+enum Container {
+    /// Sorted positions, for sparse blocks.
+    Array(Vec<u16>),
+    /// A bit per child, for dense blocks.
+    Bitmap(Vec<u64>),
+}
+
+impl Container {
+    /// Builds a container from non-empty sorted positions, in the smallest
+    /// representation for a block of `size` children.
+    fn from_array(positions: Vec<u16>, size: usize) -> Self {
+        let words = size.div_ceil(64);
+        if positions.len() <= 4 * words {
+            return Self::Array(positions);
+        }
+        let mut bits = vec![0; words];
+        for position in positions {
+            let position = usize::from(position);
+            bits[position / 64] |= 1 << (position % 64);
+        }
+        Self::Bitmap(bits)
+    }
+
+    /// Builds a container from a bitmap, in the smallest representation.
+    /// Returns `None` if the bitmap is empty.
+    fn from_bitmap(bits: Vec<u64>) -> Option<Self> {
+        let len = bits.iter().map(|word| word.count_ones()).sum::<u32>();
+        if len == 0 {
+            return None;
+        }
+        if usize::try_from(len).expect("block size") > 4 * bits.len() {
+            return Some(Self::Bitmap(bits));
+        }
+        let mut positions = Vec::with_capacity(bits.len());
+        Self::Bitmap(bits).for_each(|position| positions.push(position));
+        Some(Self::Array(positions))
+    }
+
+    /// Tests if a position is set.
+    fn contains(&self, position: u16) -> bool {
+        match *self {
+            Self::Array(ref positions) => {
+                positions.binary_search(&position).is_ok()
+            }
+            Self::Bitmap(ref bits) => {
+                let position = usize::from(position);
+                bits[position / 64] & (1 << (position % 64)) != 0
+            }
+        }
+    }
+
+    /// Returns the number of positions set.
+    fn len(&self) -> usize {
+        match *self {
+            Self::Array(ref positions) => positions.len(),
+            Self::Bitmap(ref bits) => bits
+                .iter()
+                .map(|word| {
+                    usize::try_from(word.count_ones()).expect("word size")
+                })
+                .sum(),
+        }
+    }
+
+    /// Calls `f` on every position set, in ascending order.
+    fn for_each(&self, mut f: impl FnMut(u16)) {
+        match *self {
+            Self::Array(ref positions) => positions.iter().copied().for_each(f),
+            Self::Bitmap(ref bits) => {
+                for (i, &word) in bits.iter().enumerate() {
+                    let mut word = word;
+                    while word != 0 {
+                        let bit = usize::try_from(word.trailing_zeros())
+                            .expect("word size");
+                        f(u16::try_from(64 * i + bit).expect("block size"));
+                        word &= word - 1;
+                    }
+                }
+            }
+        }
+    }
+
+    /// Returns the bitmap of the positions, for a block of `size` children.
+    fn to_bitmap(&self, size: usize) -> Vec<u64> {
+        match *self {
+            Self::Array(ref positions) => {
+                let mut bits = vec![0; size.div_ceil(64)];
+                for &position in positions {
+                    let position = usize::from(position);
+                    bits[position / 64] |= 1 << (position % 64);
+                }
+                bits
+            }
+            Self::Bitmap(ref bits) => bits.clone(),
+        }
+    }
+
+    /// Returns the positions set in both containers, if any.
+    fn and(&self, other: &Self, size: usize) -> Option<Self> {
+        match (self.as_array(), other.as_array()) {
+            (Some(positions), _) => Self::filter(positions, other),
+            (None, Some(positions)) => Self::filter(positions, self),
+            (None, None) => Self::from_bitmap(
+                self.to_bitmap(size)
+                    .iter()
+                    .zip(other.to_bitmap(size))
+                    .map(|(a, b)| a & b)
+                    .collect(),
+            ),
+        }
+    }
+
+    /// Returns the positions of `positions` set in `container`, if any.
+    fn filter(positions: &[u16], container: &Self) -> Option<Self> {
+        let positions = positions
+            .iter()
+            .copied()
+            .filter(|&position| container.contains(position))
+            .collect::<Vec<_>>();
+        (!positions.is_empty()).then_some(Self::Array(positions))
+    }
+
+    /// Returns the sorted positions of an array container.
+    fn as_array(&self) -> Option<&[u16]> {
+        match *self {
+            Self::Array(ref positions) => Some(positions),
+            Self::Bitmap(_) => None,
+        }
+    }
+
+    /// Returns the positions set in either container.
+    fn or(&self, other: &Self, size: usize) -> Option<Self> {
+        if let (Some(a), Some(b)) = (self.as_array(), other.as_array()) {
+            let mut positions = Vec::with_capacity(a.len() + b.len());
+            let (mut i, mut j) = (0, 0);
+            while i < a.len() && j < b.len() {
+                match a[i].cmp(&b[j]) {
+                    Ordering::Less => {
+                        positions.push(a[i]);
+                        i += 1;
+                    }
+                    Ordering::Greater => {
+                        positions.push(b[j]);
+                        j += 1;
+                    }
+                    Ordering::Equal => {
+                        positions.push(a[i]);
+                        i += 1;
+                        j += 1;
+                    }
+                }
+            }
+            positions.extend_from_slice(&a[i..]);
+            positions.extend_from_slice(&b[j..]);
+            return Some(Self::from_array(positions, size));
+        }
+        let mut bits = self.to_bitmap(size);
+        for (word, other) in bits.iter_mut().zip(other.to_bitmap(size)) {
+            *word |= other;
+        }
+        Self::from_bitmap(bits)
+    }
+}
+
+/// Returns the resolution of the blocks of the cells at `resolution`.
+fn block_resolution(resolution: Resolution) -> Resolution {
+    Resolution::try_from(u8::from(resolution).saturating_sub(BLOCK_DEPTH))
+        .expect("valid resolution")
+}
+
+/// Returns the number of children of a block at `resolution`.
+fn block_size(block: CellIndex, resolution: Resolution) -> usize {
+    usize::try_from(block.children_count(resolution)).expect("block size")
+}
+
+/// Returns the position of a cell in its block at `block_resolution`.
+fn position(cell: CellIndex, block_resolution: Resolution) -> u16 {
+    u16::try_from(
+        cell.child_position(block_resolution)
+            .expect("coarser block"),
+    )
+    .expect("block size")
+}
+
+// -----------------------------------------------------------------------------
+
+/// createCellBitmap builds a dense set of cells at a single resolution, for
+/// O(1) membership tests, popcount-based counts and fast unions and
+/// intersections of regional coverages.
+///
+/// Duplicates are allowed, and H3_NULL entries are ignored.
+///
+/// It is the responsibility of the caller to call destroyCellBitmap on the
+/// set, or its memory will not be freed.
+///
+/// @param cells    The cells of the set
+/// @param numCells The number of cells
+/// @param res      The resolution of the cells
+/// @param out      The created set
+/// @return E_CELL_INVALID if any cell is invalid, E_RES_MISMATCH if a cell
+/// isn't at `res`, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn createCellBitmap(
+    cells: *const H3Index,
+    numCells: i64,
+    res: c_int,
+    out: Option<&mut *mut H3CellBitmap>,
+) -> H3Error {
+    unsafe fn inner(
+        cells: *const H3Index,
+        numCells: i64,
+        res: c_int,
+    ) -> Result<*mut H3CellBitmap, H3Error> {
+        let resolution = convert::h3res_to_resolution(res)?;
+        let len =
+            usize::try_from(numCells).map_err(|_| H3ErrorCodes::EDomain)?;
+        let cells = if len == 0 {
+            &[]
+        } else {
+            std::slice::from_raw_parts(cells, len)
+        };
+        let set = H3CellBitmap::new(cells, resolution)?;
+        Ok(Box::into_raw(Box::new(set)))
+    }
+
+    delegate_inner!(inner(cells, numCells, res), out)
+}
+
+/// cellBitmapContains tests if a cell is in the set.
+///
+/// Unlike cellSetContains, only the cells at the resolution of the set can be
+/// members: the descendants of a cell of the set aren't.
+///
+/// @param set  The set created by createCellBitmap
+/// @param cell The cell to look up, at any resolution
+/// @param out  Set to 1 if the cell is in the set, 0 otherwise
+/// @return E_CELL_INVALID if the cell is invalid, E_SUCCESS otherwise.
+#[no_mangle]
+pub extern "C" fn cellBitmapContains(
+    set: Option<&H3CellBitmap>,
+    cell: H3Index,
+    out: Option<&mut c_int>,
+) -> H3Error {
+    fn inner(set: &H3CellBitmap, cell: H3Index) -> Result<c_int, H3Error> {
+        let cell = CellIndex::try_from(cell)
+            .map_err(|_| H3ErrorCodes::ECellInvalid)?;
+        Ok(set.contains(cell).into())
+    }
+
+    delegate_inner!(inner(set.expect("null pointer"), cell), out)
+}
+
+/// cellBitmapSize returns the number of cells of the set.
+///
+/// @param set The set created by createCellBitmap
+/// @param out The number of cells
+#[no_mangle]
+pub extern "C" fn cellBitmapSize(
+    set: Option<&H3CellBitmap>,
+    out: Option<&mut i64>,
+) -> H3Error {
+    let set = set.expect("null pointer");
+    *out.expect("null pointer") =
+        i64::try_from(set.len()).expect("too many cells");
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// cellBitmapToCells writes the cells of the set, in ascending order.
+///
+/// @param set    The set created by createCellBitmap
+/// @param out    The cells of the set (preallocated, see cellBitmapSize)
+/// @param maxOut The size of `out`
+/// @return E_MEMORY_BOUNDS if `out` is too small, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `maxOut` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellBitmapToCells(
+    set: Option<&H3CellBitmap>,
+    out: *mut H3Index,
+    maxOut: i64,
+) -> H3Error {
+    let set = set.expect("null pointer");
+    let len = set.len();
+    if usize::try_from(maxOut).unwrap_or_default() < len {
+        return H3ErrorCodes::EMemoryBounds.into();
+    }
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let out = std::slice::from_raw_parts_mut(out, len);
+    let mut i = 0;
+    set.for_each(|cell| {
+        out[i] = cell.into();
+        i += 1;
+    });
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// cellBitmapUnion builds the set of the cells of either set.
+///
+/// It is the responsibility of the caller to call destroyCellBitmap on the
+/// set, or its memory will not be freed.
+///
+/// @param a   A set created by createCellBitmap
+/// @param b   Another set, at the same resolution
+/// @param out The union of the sets
+/// @return E_RES_MISMATCH if the sets aren't at the same resolution,
+/// E_SUCCESS otherwise.
+#[no_mangle]
+pub extern "C" fn cellBitmapUnion(
+    a: Option<&H3CellBitmap>,
+    b: Option<&H3CellBitmap>,
+    out: Option<&mut *mut H3CellBitmap>,
+) -> H3Error {
+    fn inner(
+        a: &H3CellBitmap,
+        b: &H3CellBitmap,
+    ) -> Result<*mut H3CellBitmap, H3Error> {
+        if a.resolution != b.resolution {
+            return Err(H3ErrorCodes::EResMismatch.into());
+        }
+        let set = a.merge(b, true, Container::or);
+        Ok(Box::into_raw(Box::new(set)))
+    }
+
+    delegate_inner!(
+        inner(a.expect("null pointer"), b.expect("null pointer")),
+        out
+    )
+}
+
+/// cellBitmapIntersection builds the set of the cells of both sets.
+///
+/// It is the responsibility of the caller to call destroyCellBitmap on the
+/// set, or its memory will not be freed.
+///
+/// @param a   A set created by createCellBitmap
+/// @param b   Another set, at the same resolution
+/// @param out The intersection of the sets
+/// @return E_RES_MISMATCH if the sets aren't at the same resolution,
+/// E_SUCCESS otherwise.
+#[no_mangle]
+pub extern "C" fn cellBitmapIntersection(
+    a: Option<&H3CellBitmap>,
+    b: Option<&H3CellBitmap>,
+    out: Option<&mut *mut H3CellBitmap>,
+) -> H3Error {
+    fn inner(
+        a: &H3CellBitmap,
+        b: &H3CellBitmap,
+    ) -> Result<*mut H3CellBitmap, H3Error> {
+        if a.resolution != b.resolution {
+            return Err(H3ErrorCodes::EResMismatch.into());
+        }
+        let set = a.merge(b, false, Container::and);
+        Ok(Box::into_raw(Box::new(set)))
+    }
+
+    delegate_inner!(
+        inner(a.expect("null pointer"), b.expect("null pointer")),
+        out
+    )
+}
+
+/// Free all allocated memory for a cell bitmap.
+///
+/// @param set The set to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`createCellBitmap`], [`cellBitmapUnion`] or
+/// [`cellBitmapIntersection`]
+#[no_mangle]
+pub unsafe extern "C" fn destroyCellBitmap(set: *mut H3CellBitmap) {
+    if !set.is_null() {
+        drop(Box::from_raw(set));
+    }
+}
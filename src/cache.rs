@@ -0,0 +1,232 @@
+//! Opt-in per-thread caches of the cell boundaries and centers.
+
+use crate::{config, CellBoundary, H3Error, H3ErrorCodes, H3Index, LatLng};
+use std::{
+    cell::RefCell,
+    collections::HashMap,
+    sync::atomic::{AtomicU64, Ordering},
+};
+
+/// Number of lookups after which a thread publishes its counters.
+const FLUSH_INTERVAL: u64 = 1024;
+
+/// Number of lookups served from the caches, over every thread.
+static HITS: AtomicU64 = AtomicU64::new(0);
+/// Number of lookups that had to compute the value, over every thread.
+static MISSES: AtomicU64 = AtomicU64::new(0);
+
+thread_local! {
+    static CACHE: RefCell<ThreadCache> = RefCell::new(ThreadCache::default());
+}
+
+/// Caches of a thread.
+///
+/// Counters are accumulated locally and only published every few lookups, so
+/// that threads never contend on them.
+#[derive(Default)]
+struct ThreadCache {
+    /// Generation of the cache settings the caches were filled with.
+    generation: u64,
+    boundaries: Clock<CellBoundary>,
+    centers: Clock<LatLng>,
+    hits: u64,
+    misses: u64,
+}
+
+impl ThreadCache {
+    /// Empties the caches if the capacity was set since they were filled.
+    fn sync(&mut self, generation: u64) {
+        if self.generation != generation {
+            self.boundaries = Clock::default();
+            self.centers = Clock::default();
+            self.generation = generation;
+        }
+    }
+
+    /// Counts a lookup.
+    fn record(&mut self, hit: bool) {
+        if hit {
+            self.hits += 1;
+        } else {
+            self.misses += 1;
+        }
+        if self.hits + self.misses >= FLUSH_INTERVAL {
+            self.flush();
+        }
+    }
+
+    /// Publishes the local counters.
+    fn flush(&mut self) {
+        HITS.fetch_add(self.hits, Ordering::Relaxed);
+        MISSES.fetch_add(self.misses, Ordering::Relaxed);
+        self.hits = 0;
+        self.misses = 0;
+    }
+}
+
+impl Drop for ThreadCache {
+    fn drop(&mut self) {
+        self.flush();
+    }
+}
+
+/// A cache entry.
+struct Entry<V> {
+    cell: H3Index,
+    value: V,
+    /// Whether the entry was used since the clock hand last passed by.
+    referenced: bool,
+}
+
+/// Bounded map evicting with the CLOCK algorithm, an approximation of LRU
+/// that doesn't reorder anything on hits.
+struct Clock<V> {
+    /// Slot of every cached cell in `entries`.
+    slots: HashMap<H3Index, usize>,
+    entries: Vec<Entry<V>>,
+    /// Next eviction candidate.
+    hand: usize,
+}
+
+impl<V> Default for Clock<V> {
+    fn default() -> Self {
+        Self {
+            slots: HashMap::new(),
+            entries: Vec::new(),
+            hand: 0,
+        }
+    }
+}
+
+impl<V: Copy> Clock<V> {
+    /// Returns the cached value of the cell, if any.
+    fn get(&mut self, cell: H3Index) -> Option<V> {
+        let &slot = self.slots.get(&cell)?;
+        let entry = &mut self.entries[slot];
+        entry.referenced = true;
+        Some(entry.value)
+    }
+
+    /// Caches the value of the cell, evicting an entry if the cache is full.
+    fn insert(&mut self, cell: H3Index, value: V, capacity: usize) {
+        let entry = Entry {
+            cell,
+            value,
+            referenced: false,
+        };
+        if self.entries.len() < capacity {
+            self.slots.insert(cell, self.entries.len());
+            self.entries.push(entry);
+            return;
+        }
+
+        // Give a second chance to the entries used since the last pass.
+        while self.entries[self.hand].referenced {
+            self.entries[self.hand].referenced = false;
+            self.hand = (self.hand + 1) % self.entries.len();
+        }
+        self.slots.remove(&self.entries[self.hand].cell);
+        self.slots.insert(cell, self.hand);
+        self.entries[self.hand] = entry;
+        self.hand = (self.hand + 1) % self.entries.len();
+    }
+}
+
+/// Returns the boundary of the cell, from the cache of the thread if enabled.
+pub fn boundary(
+    cell: H3Index,
+    compute: fn(H3Index) -> Result<CellBoundary, H3Error>,
+) -> Result<CellBoundary, H3Error> {
+    cached(cell, |cache| &mut cache.boundaries, compute)
+}
+
+/// Returns the center of the cell, from the cache of the thread if enabled.
+pub fn center(
+    cell: H3Index,
+    compute: fn(H3Index) -> Result<LatLng, H3Error>,
+) -> Result<LatLng, H3Error> {
+    cached(cell, |cache| &mut cache.centers, compute)
+}
+
+/// Looks the cell up in the selected cache, computing (and caching) its value
+/// on misses.
+///
+/// Errors are never cached.
+fn cached<V: Copy>(
+    cell: H3Index,
+    select: fn(&mut ThreadCache) -> &mut Clock<V>,
+    compute: fn(H3Index) -> Result<V, H3Error>,
+) -> Result<V, H3Error> {
+    let (capacity, generation) = config::cache_settings();
+    if capacity == 0 {
+        // Nothing to free if the caches were never enabled.
+        if generation != 0 {
+            CACHE
+                .try_with(|cache| cache.borrow_mut().sync(generation))
+                .unwrap_or(());
+        }
+        return compute(cell);
+    }
+
+    CACHE
+        .try_with(|cache| {
+            let mut cache = cache.borrow_mut();
+            cache.sync(generation);
+            let value = select(&mut cache).get(cell);
+            cache.record(value.is_some());
+            if let Some(value) = value {
+                return Ok(value);
+            }
+            let value = compute(cell)?;
+            select(&mut cache).insert(cell, value, capacity);
+            Ok(value)
+        })
+        // The cache is already gone when the thread is shutting down.
+        .unwrap_or_else(|_| compute(cell))
+}
+
+// -----------------------------------------------------------------------------
+
+/// h3GetCacheStats returns the number of hits and misses of the boundary and
+/// center caches (see h3SetCacheCapacity), over every thread.
+///
+/// Counters are published by every thread once in a while (and when it
+/// exits), so the most recent lookups of other threads may not be counted
+/// yet. Those of the calling thread always are.
+///
+/// @param hits   Number of lookups served from the caches
+/// @param misses Number of lookups that computed the value
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn h3GetCacheStats(
+    hits: Option<&mut i64>,
+    misses: Option<&mut i64>,
+) -> H3Error {
+    // The cache may already be gone if the thread is shutting down.
+    CACHE
+        .try_with(|cache| cache.borrow_mut().flush())
+        .unwrap_or(());
+    let load = |counter: &AtomicU64| {
+        i64::try_from(counter.load(Ordering::Relaxed)).unwrap_or(i64::MAX)
+    };
+    *hits.expect("null pointer") = load(&HITS);
+    *misses.expect("null pointer") = load(&MISSES);
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// h3ResetCacheStats resets the hit and miss counters of the caches.
+///
+/// Lookups of other threads that weren't published yet are still counted
+/// afterwards.
+#[no_mangle]
+pub extern "C" fn h3ResetCacheStats() {
+    CACHE
+        .try_with(|cache| {
+            let mut cache = cache.borrow_mut();
+            cache.hits = 0;
+            cache.misses = 0;
+        })
+        .unwrap_or(());
+    HITS.store(0, Ordering::Relaxed);
+    MISSES.store(0, Ordering::Relaxed);
+}
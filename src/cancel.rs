@@ -0,0 +1,139 @@
+//! Cancellation and time budgets of the long-running calls.
+//!
+//! A token is polled every few iterations of the loops of the cancellable
+//! functions (not at every one, to keep the clock reads off the hot paths),
+//! which then stop with E_CANCELLED.
+
+use crate::{delegate_inner, H3Error, H3ErrorCodes};
+use std::{
+    sync::atomic::{AtomicBool, Ordering},
+    time::{Duration, Instant},
+};
+
+/// Number of iterations between two polls of a token.
+const CHECK_INTERVAL: u32 = 256;
+
+/// A cancellation token, with an optional deadline.
+pub struct H3CancelToken {
+    /// Whether triggerCancelToken was called.
+    cancelled: AtomicBool,
+    /// Instant past which the calls using the token stop.
+    deadline: Option<Instant>,
+}
+
+impl H3CancelToken {
+    /// Tests if the calls using the token must stop.
+    fn is_cancelled(&self) -> bool {
+        self.cancelled.load(Ordering::Relaxed)
+            || self
+                .deadline
+                .is_some_and(|deadline| Instant::now() >= deadline)
+    }
+}
+
+/// Polls an optional token, every `CHECK_INTERVAL` steps of a loop.
+///
+/// A checkpoint counts the steps of a single thread: the workers of a parallel
+/// call use one each.
+pub struct Checkpoint<'a> {
+    /// The token to poll, if any.
+    token: Option<&'a H3CancelToken>,
+    /// Steps left before the next poll.
+    countdown: u32,
+}
+
+impl<'a> Checkpoint<'a> {
+    /// Creates a checkpoint, polling the token at the first step.
+    pub const fn new(token: Option<&'a H3CancelToken>) -> Self {
+        Self {
+            token,
+            countdown: 0,
+        }
+    }
+
+    /// Counts a step, failing with E_CANCELLED if the token was cancelled or
+    /// went past its deadline.
+    pub fn step(&mut self) -> Result<(), H3Error> {
+        let Some(token) = self.token else {
+            return Ok(());
+        };
+        if self.countdown != 0 {
+            self.countdown -= 1;
+            return Ok(());
+        }
+        self.countdown = CHECK_INTERVAL - 1;
+        if token.is_cancelled() {
+            return Err(H3ErrorCodes::ECancelled.into());
+        }
+        Ok(())
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/// createCancelToken creates a token stopping the cancellable calls (the
+/// `*Cancellable` functions) using it, when cancelled with triggerCancelToken or
+/// once its time budget is spent.
+///
+/// The budget starts at the creation of the token, and is shared by every call
+/// using it: a token typically covers a request. The calls poll the token
+/// every few iterations of their loops, so they return shortly after the
+/// deadline, not exactly on it.
+///
+/// It is the responsibility of the caller to call destroyCancelToken on the
+/// token, or its memory will not be freed.
+///
+/// @param budgetUs The time budget, in microseconds (0 for no deadline)
+/// @param out      The created token
+/// @return E_DOMAIN if the budget is negative, E_SUCCESS otherwise.
+#[no_mangle]
+pub extern "C" fn createCancelToken(
+    budgetUs: i64,
+    out: Option<&mut *mut H3CancelToken>,
+) -> H3Error {
+    fn inner(budgetUs: i64) -> Result<*mut H3CancelToken, H3Error> {
+        let budget =
+            u64::try_from(budgetUs).map_err(|_| H3ErrorCodes::EDomain)?;
+        let token = H3CancelToken {
+            cancelled: AtomicBool::new(false),
+            // A budget too large to be represented never expires.
+            deadline: (budget != 0)
+                .then(|| {
+                    Instant::now().checked_add(Duration::from_micros(budget))
+                })
+                .flatten(),
+        };
+        Ok(Box::into_raw(Box::new(token)))
+    }
+
+    delegate_inner!(inner(budgetUs), out)
+}
+
+/// triggerCancelToken cancels the calls using a token: the running ones stop
+/// shortly, and the next ones right away.
+///
+/// It can be called from any thread, while the token is used.
+///
+/// @param token The token created by createCancelToken
+#[no_mangle]
+pub extern "C" fn triggerCancelToken(token: Option<&H3CancelToken>) {
+    token
+        .expect("null pointer")
+        .cancelled
+        .store(true, Ordering::Relaxed);
+}
+
+/// Free all allocated memory for a cancellation token.
+///
+/// @param token The token to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`createCancelToken`], and no call may be
+/// using it anymore.
+#[no_mangle]
+pub unsafe extern "C" fn destroyCancelToken(token: *mut H3CancelToken) {
+    if !token.is_null() {
+        drop(Box::from_raw(token));
+    }
+}
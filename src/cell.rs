@@ -1,9 +1,12 @@
 use crate::{
-    convert, delegate_inner, CellBoundary, H3Error, H3ErrorCodes, H3Index,
-    LatLng,
+    area, cache, convert, cpu, delegate_inner,
+    latlng::EARTH_RADIUS_KM,
+    parallel, stats,
+    visit::{H3CellVisitor, Visit},
+    CellBoundary, H3Error, H3ErrorCodes, H3Index, LatLng, H3_NULL,
 };
-use h3o::CellIndex;
-use std::ffi::c_int;
+use h3o::{CellIndex, Resolution};
+use std::ffi::{c_int, c_void};
 
 /// Area of H3 cell in kilometers^2.
 #[no_mangle]
@@ -61,7 +64,107 @@ pub extern "C" fn cellToBoundary(
         Ok(index.boundary().into())
     }
 
-    delegate_inner!(inner(h3), gp)
+    let _scope = stats::Scope::new(stats::Function::CellToBoundary, 1);
+    delegate_inner!(cache::boundary(h3, inner), gp)
+}
+
+/// Determines the cell boundaries of an array of H3 indexes, packed into a
+/// single vertex buffer (no padding).
+///
+/// The vertices of `cells[i]` are stored in `verts[offsets[i]..offsets[i+1]]`,
+/// in ccw order. Invalid indexes get an empty vertex range.
+///
+/// `numCells * MAX_CELL_BNDRY_VERTS` is always enough to hold the vertices.
+///
+/// @param cells    The H3 indexes.
+/// @param numCells Number of indexes in `cells`.
+/// @param verts    Output vertex buffer.
+/// @param maxVerts Size of the vertex buffer, to bound check against.
+/// @param offsets  Output offsets, `numCells + 1` elements.
+/// @return E_SUCCESS on success, E_MEMORY_BOUNDS if the vertex buffer is too
+///         small or E_CELL_INVALID if at least one index was invalid.
+///
+/// # Safety
+///
+/// - `cells` must points to an array of at least `numCells` elements.
+/// - `verts` must points to an array of at least `maxVerts` elements.
+/// - `offsets` must points to an array of at least `numCells + 1` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToBoundaries(
+    cells: *const H3Index,
+    numCells: i64,
+    verts: *mut LatLng,
+    maxVerts: i64,
+    offsets: *mut i64,
+) -> H3Error {
+    let _scope =
+        stats::Scope::new(stats::Function::CellsToBoundaries, numCells);
+    write_boundaries(
+        cells,
+        numCells,
+        verts,
+        maxVerts,
+        offsets,
+        |cell| CellIndex::try_from(cell).ok().map(CellIndex::boundary),
+        H3ErrorCodes::ECellInvalid,
+    )
+}
+
+/// Shared implementation of the packed boundary batches (cells and directed
+/// edges): `boundary` returns the boundary of an index, `None` if it's
+/// invalid (it then gets an empty vertex range, and `invalid` is returned once
+/// every index has been processed).
+///
+/// # Safety
+///
+/// - `indexes` must points to an array of at least `numIndexes` elements.
+/// - `verts` must points to an array of at least `maxVerts` elements.
+/// - `offsets` must points to an array of at least `numIndexes + 1` elements.
+pub unsafe fn write_boundaries(
+    indexes: *const H3Index,
+    numIndexes: i64,
+    verts: *mut LatLng,
+    maxVerts: i64,
+    offsets: *mut i64,
+    boundary: impl Fn(H3Index) -> Option<h3o::Boundary>,
+    invalid: H3ErrorCodes,
+) -> H3Error {
+    let (Ok(len), Ok(capacity)) =
+        (usize::try_from(numIndexes), usize::try_from(maxVerts))
+    else {
+        return H3ErrorCodes::EDomain.into();
+    };
+
+    let offsets = std::slice::from_raw_parts_mut(offsets, len + 1);
+    offsets[0] = 0;
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    let indexes = std::slice::from_raw_parts(indexes, len);
+    let verts = std::slice::from_raw_parts_mut(verts, capacity);
+    let mut count = 0;
+    let mut valid = true;
+    for (i, &index) in indexes.iter().enumerate() {
+        if let Some(boundary) = boundary(index) {
+            let Some(dst) = verts.get_mut(count..count + boundary.len()) else {
+                return H3ErrorCodes::EMemoryBounds.into();
+            };
+            for (vertex, &ll) in dst.iter_mut().zip(boundary.iter()) {
+                *vertex = ll.into();
+            }
+            count += boundary.len();
+        } else {
+            valid = false;
+        }
+        offsets[i + 1] = i64::try_from(count).expect("offset overflow");
+    }
+
+    if valid {
+        H3ErrorCodes::ESuccess.into()
+    } else {
+        invalid.into()
+    }
 }
 
 /// cellToCenterChild produces the center child index for a given H3 index at
@@ -116,6 +219,7 @@ pub unsafe extern "C" fn cellToChildren(
         Ok((index.children_count(child_res), index.children(child_res)))
     }
 
+    let _scope = stats::Scope::new(stats::Function::CellToChildren, 1);
     match inner(h, childRes) {
         Ok((len, iter)) => {
             let len = usize::try_from(len).expect("overflow");
@@ -129,6 +233,285 @@ pub unsafe extern "C" fn cellToChildren(
     }
 }
 
+/// Computes the offsets of the children of every parent, in their
+/// concatenation (with the total as the last offset).
+fn children_offsets(
+    parents: &[CellIndex],
+    child_res: Resolution,
+) -> Result<Vec<u64>, H3Error> {
+    let mut offsets = Vec::with_capacity(parents.len() + 1);
+    let mut total = 0;
+    offsets.push(total);
+    for parent in parents {
+        if parent.resolution() > child_res {
+            return Err(H3ErrorCodes::EResDomain.into());
+        }
+        total += parent.children_count(child_res);
+        offsets.push(total);
+    }
+    Ok(offsets)
+}
+
+/// cellsToChildrenSize returns the number of children of a batch of parents,
+/// at the given resolution (i.e. the size of the output of
+/// cellsToChildrenCSR).
+///
+/// @param cells    The parents, at any resolution up to `childRes`
+/// @param numCells The number of parents
+/// @param childRes The child level to produce
+/// @param out      The number of children of every parent, summed
+/// @return E_RES_DOMAIN if a parent is finer than `childRes`, E_SUCCESS on
+/// success.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToChildrenSize(
+    cells: *const H3Index,
+    numCells: i64,
+    childRes: c_int,
+    out: Option<&mut i64>,
+) -> H3Error {
+    unsafe fn inner(
+        cells: *const H3Index,
+        numCells: i64,
+        childRes: c_int,
+    ) -> Result<i64, H3Error> {
+        let child_res = convert::h3res_to_resolution(childRes)?;
+        let len =
+            usize::try_from(numCells).map_err(|_| H3ErrorCodes::EDomain)?;
+        if len == 0 {
+            return Ok(0);
+        }
+        let parents = convert::h3ptr_to_h3oslice(cells, numCells)?;
+        let offsets = children_offsets(parents, child_res)?;
+        Ok(i64::try_from(offsets[len]).expect("too many children"))
+    }
+
+    delegate_inner!(inner(cells, numCells, childRes), out)
+}
+
+/// cellsToChildrenCSR expands a batch of parents to their children at the
+/// given resolution, keeping track of the parent of every child.
+///
+/// The children of `cells[i]` are stored in
+/// `children[offsets[i]..offsets[i + 1]]`, in the order of cellToChildren.
+/// Parents may have mixed resolutions, and are expanded on the thread pool
+/// once their offsets are known.
+///
+/// If `children` is too small, E_MEMORY_BOUNDS is returned but the offsets are
+/// still set, so that `offsets[numCells]` gives the required size (see also
+/// cellsToChildrenSize).
+///
+/// @param cells       The parents, at any resolution up to `childRes`
+/// @param numCells    The number of parents
+/// @param childRes    The child level to produce
+/// @param children    Output children
+/// @param maxChildren Size of the children buffer, to bound check against
+/// @param offsets     Output offsets, `numCells + 1` elements
+/// @return E_CELL_INVALID if a parent is invalid, E_RES_DOMAIN if a parent is
+/// finer than `childRes`, E_MEMORY_BOUNDS if the children buffer is too small,
+/// E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// - `cells` must points to an array of at least `numCells` elements.
+/// - `children` must points to an array of at least `maxChildren` elements.
+/// - `offsets` must points to an array of at least `numCells + 1` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToChildrenCSR(
+    cells: *const H3Index,
+    numCells: i64,
+    childRes: c_int,
+    children: *mut H3Index,
+    maxChildren: i64,
+    offsets: *mut i64,
+) -> H3Error {
+    unsafe fn inner(
+        cells: *const H3Index,
+        numCells: i64,
+        childRes: c_int,
+        children: *mut H3Index,
+        maxChildren: i64,
+        offsets: *mut i64,
+    ) -> Result<(), H3Error> {
+        let child_res = convert::h3res_to_resolution(childRes)?;
+        let (Ok(len), Ok(capacity)) =
+            (usize::try_from(numCells), u64::try_from(maxChildren))
+        else {
+            return Err(H3ErrorCodes::EDomain.into());
+        };
+        let out_offsets = std::slice::from_raw_parts_mut(offsets, len + 1);
+        out_offsets[0] = 0;
+        if len == 0 {
+            return Ok(());
+        }
+        let parents = convert::h3ptr_to_h3oslice(cells, numCells)?;
+
+        let offsets = children_offsets(parents, child_res)?;
+        for (dst, &offset) in out_offsets.iter_mut().zip(&offsets) {
+            *dst = i64::try_from(offset).expect("too many children");
+        }
+        let total = offsets[len];
+        if total > capacity {
+            return Err(H3ErrorCodes::EMemoryBounds.into());
+        }
+
+        let out = std::slice::from_raw_parts_mut(
+            children,
+            usize::try_from(total).expect("too many children"),
+        );
+        let tasks = parallel::split_by_output(parents, &offsets, out);
+        parallel::for_each(tasks, |(parents, out)| {
+            let children =
+                parents.iter().flat_map(|parent| parent.children(child_res));
+            for (dst, child) in out.iter_mut().zip(children) {
+                *dst = child.into();
+            }
+        });
+        Ok(())
+    }
+
+    let _scope =
+        stats::Scope::new(stats::Function::CellsToChildrenCsr, numCells);
+    inner(cells, numCells, childRes, children, maxChildren, offsets)
+        .err()
+        .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// Cursor over the children of a cell, to enumerate them by bounded chunks.
+pub struct H3ChildrenCursor {
+    /// Remaining children.
+    children: Box<dyn Iterator<Item = CellIndex>>,
+}
+
+/// cellToChildrenInit creates a cursor over the children of a cell, which can
+/// then be drained by chunks of bounded size with cellToChildrenNext.
+///
+/// This allows to enumerate the children without allocating a buffer of
+/// cellToChildrenSize elements.
+///
+/// It is the responsibility of the caller to call destroyChildrenCursor on the
+/// cursor, or its memory will not be freed.
+///
+/// @param h        H3Index to find the children of
+/// @param childRes int the child level to produce
+/// @param out      The created cursor
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn cellToChildrenInit(
+    h: H3Index,
+    childRes: c_int,
+    out: Option<&mut *mut H3ChildrenCursor>,
+) -> H3Error {
+    fn inner(
+        h: H3Index,
+        childRes: c_int,
+    ) -> Result<*mut H3ChildrenCursor, H3Error> {
+        let index = CellIndex::try_from(h)?;
+        let child_res = convert::h3res_to_resolution(childRes)?;
+
+        Ok(Box::into_raw(Box::new(H3ChildrenCursor {
+            children: Box::new(index.children(child_res)),
+        })))
+    }
+
+    delegate_inner!(inner(h, childRes), out)
+}
+
+/// cellToChildrenNext writes the next children of the cell into `out`.
+///
+/// Once every child has been produced, `written` is set to 0.
+///
+/// @param cursor   The cursor created by cellToChildrenInit
+/// @param out      The output buffer
+/// @param capacity The size of the output buffer
+/// @param written  The number of children written into `out`
+/// @return 0 (E_SUCCESS) on success.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `capacity` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellToChildrenNext(
+    cursor: Option<&mut H3ChildrenCursor>,
+    out: *mut H3Index,
+    capacity: i64,
+    written: Option<&mut i64>,
+) -> H3Error {
+    let Ok(capacity) = usize::try_from(capacity) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let mut count = 0;
+    if capacity != 0 {
+        let out = std::slice::from_raw_parts_mut(out, capacity);
+        let children = &mut cursor.expect("null pointer").children;
+        // `out` comes first to avoid consuming a child that wouldn't fit.
+        for (dst, child) in out.iter_mut().zip(children) {
+            *dst = child.into();
+            count += 1;
+        }
+    }
+    *written.expect("null pointer") = count;
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Free all allocated memory for a children cursor.
+///
+/// @param cursor The cursor to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`cellToChildrenInit`]
+#[no_mangle]
+pub unsafe extern "C" fn destroyChildrenCursor(cursor: *mut H3ChildrenCursor) {
+    if !cursor.is_null() {
+        drop(Box::from_raw(cursor));
+    }
+}
+
+/// cellToChildrenForEach visits the children of a cell.
+///
+/// Same as cellToChildren, except that the children are handed over to
+/// `visitor` by batches (of at most H3_VISIT_BATCH_SIZE cells) instead of
+/// being written into an output array of cellToChildrenSize elements.
+///
+/// @param h        H3Index to find the children of
+/// @param childRes int the child level to produce
+/// @param visitor  callback receiving the batches of children
+/// @param context  pointer passed to every call of `visitor`
+/// @return 0 (E_SUCCESS) on success, including when stopped by `visitor`.
+///
+/// # Safety
+///
+/// `visitor` must be callable with `context`.
+#[no_mangle]
+pub unsafe extern "C" fn cellToChildrenForEach(
+    h: H3Index,
+    childRes: c_int,
+    visitor: Option<H3CellVisitor>,
+    context: *mut c_void,
+) -> H3Error {
+    let _scope = stats::Scope::new(stats::Function::CellToChildrenForEach, 1);
+    let Some(visitor) = visitor else {
+        return H3ErrorCodes::EFailed.into();
+    };
+    let index = match CellIndex::try_from(h) {
+        Ok(index) => index,
+        Err(err) => return err.into(),
+    };
+    let child_res = match convert::h3res_to_resolution(childRes) {
+        Ok(res) => res,
+        Err(err) => return err.into(),
+    };
+
+    let mut visit = Visit::new(visitor, context);
+    visit.extend(index.children(child_res));
+    visit.finish();
+    H3ErrorCodes::ESuccess.into()
+}
+
 /// cellToChildrenSize returns the exact number of children for a cell at a
 /// given child resolution.
 ///
@@ -154,6 +537,105 @@ pub extern "C" fn cellToChildrenSize(
     delegate_inner!(inner(h, childRes), out)
 }
 
+/// Batch version of cellAreaKm2.
+///
+/// Areas of invalid indexes are set to NaN and the batch carries on.
+///
+/// @param cells    The H3 indexes.
+/// @param numCells Number of indexes in `cells`.
+/// @param out      Output areas, in kilometers^2.
+/// @return E_SUCCESS on success, E_CELL_INVALID if at least one index was
+///         invalid.
+///
+/// # Safety
+///
+/// `cells` and `out` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsAreaKm2(
+    cells: *const H3Index,
+    numCells: i64,
+    out: *mut f64,
+) -> H3Error {
+    cells_area(cells, numCells, out, EARTH_RADIUS_KM * EARTH_RADIUS_KM)
+}
+
+/// Batch version of cellAreaM2.
+///
+/// Areas of invalid indexes are set to NaN and the batch carries on.
+///
+/// @param cells    The H3 indexes.
+/// @param numCells Number of indexes in `cells`.
+/// @param out      Output areas, in meters^2.
+/// @return E_SUCCESS on success, E_CELL_INVALID if at least one index was
+///         invalid.
+///
+/// # Safety
+///
+/// `cells` and `out` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsAreaM2(
+    cells: *const H3Index,
+    numCells: i64,
+    out: *mut f64,
+) -> H3Error {
+    cells_area(
+        cells,
+        numCells,
+        out,
+        EARTH_RADIUS_KM * EARTH_RADIUS_KM * 1e6,
+    )
+}
+
+/// Batch version of cellAreaRads2.
+///
+/// Areas of invalid indexes are set to NaN and the batch carries on.
+///
+/// @param cells    The H3 indexes.
+/// @param numCells Number of indexes in `cells`.
+/// @param out      Output areas, in radians^2.
+/// @return E_SUCCESS on success, E_CELL_INVALID if at least one index was
+///         invalid.
+///
+/// # Safety
+///
+/// `cells` and `out` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsAreaRads2(
+    cells: *const H3Index,
+    numCells: i64,
+    out: *mut f64,
+) -> H3Error {
+    cells_area(cells, numCells, out, 1.)
+}
+
+/// Computes the area of every cell, scaled from radians^2 by `scale`.
+unsafe fn cells_area(
+    cells: *const H3Index,
+    numCells: i64,
+    out: *mut f64,
+    scale: f64,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let cells = std::slice::from_raw_parts(cells, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    let valid = area::cells_area_rads2(cells, out);
+    for area in out {
+        *area *= scale;
+    }
+
+    if valid {
+        H3ErrorCodes::ESuccess.into()
+    } else {
+        H3ErrorCodes::ECellInvalid.into()
+    }
+}
+
 /// Determines the spherical coordinates of the center point of an H3 index.
 ///
 /// @param h3 The H3 index.
@@ -164,7 +646,63 @@ pub extern "C" fn cellToLatLng(h3: H3Index, g: Option<&mut LatLng>) -> H3Error {
         Ok(h3o::LatLng::from(index).into())
     }
 
-    delegate_inner!(inner(h3), g)
+    let _scope = stats::Scope::new(stats::Function::CellToLatLng, 1);
+    delegate_inner!(cache::center(h3, inner), g)
+}
+
+/// Determines the spherical coordinates of the center point of an array of H3
+/// indexes, writing latitudes and longitudes into separate arrays.
+///
+/// Coordinates of invalid indexes are set to NaN and the batch carries on.
+///
+/// @param cells    The H3 indexes.
+/// @param numCells Number of indexes in `cells`.
+/// @param lat      Output latitudes, in radians.
+/// @param lng      Output longitudes, in radians.
+/// @return E_SUCCESS on success, E_CELL_INVALID if at least one index was
+///         invalid.
+///
+/// # Safety
+///
+/// `cells`, `lat` and `lng` must points to an array of at least `numCells`
+/// elements each.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToLatLngs(
+    cells: *const H3Index,
+    numCells: i64,
+    lat: *mut f64,
+    lng: *mut f64,
+) -> H3Error {
+    let _scope = stats::Scope::new(stats::Function::CellsToLatLngs, numCells);
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    let cells = std::slice::from_raw_parts(cells, len);
+    let lats = std::slice::from_raw_parts_mut(lat, len);
+    let lngs = std::slice::from_raw_parts_mut(lng, len);
+    let mut valid = true;
+    for ((lat, lng), &cell) in lats.iter_mut().zip(lngs).zip(cells) {
+        (*lat, *lng) = CellIndex::try_from(cell).map_or_else(
+            |_| {
+                valid = false;
+                (f64::NAN, f64::NAN)
+            },
+            |index| {
+                let ll = h3o::LatLng::from(index);
+                (ll.lat_radians(), ll.lng_radians())
+            },
+        );
+    }
+
+    if valid {
+        H3ErrorCodes::ESuccess.into()
+    } else {
+        H3ErrorCodes::ECellInvalid.into()
+    }
 }
 
 /// cellToParent produces the parent index for a given H3 index
@@ -187,9 +725,176 @@ pub extern "C" fn cellToParent(
             .ok_or(h3o::error::ResolutionMismatch)?)
     }
 
+    let _scope = stats::Scope::new(stats::Function::CellToParent, 1);
     delegate_inner!(inner(h, parentRes), parent)
 }
 
+/// Batch version of cellToParent.
+///
+/// The resolution is validated once for the whole batch, and the parents are
+/// computed with plain bit masking. An invalid cell (or a cell coarser than
+/// `parentRes`) doesn't stop the batch: its parent is set to H3_NULL and an
+/// error is returned once every cell has been processed.
+///
+/// @param cells     The H3 indexes.
+/// @param numCells  The number of indexes.
+/// @param parentRes The resolution to switch to (parent, grandparent, etc)
+/// @param out       The parent indexes, one per cell.
+/// @return E_CELL_INVALID if any cell is invalid, E_RES_MISMATCH if any cell is
+/// coarser than `parentRes`, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `cells` and `out` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToParents(
+    cells: *const H3Index,
+    numCells: i64,
+    parentRes: c_int,
+    out: *mut H3Index,
+) -> H3Error {
+    let res = match convert::h3res_to_resolution(parentRes) {
+        Ok(res) => u64::from(u8::from(res)),
+        Err(err) => return err.into(),
+    };
+    // Set the resolution, and the digits past it to 7 (unused).
+    let unused_digits = (1 << (3 * (15 - res))) - 1;
+    map_cell_bits(
+        cells,
+        numCells,
+        out,
+        H3_NULL,
+        H3ErrorCodes::EResMismatch,
+        |cell_res| cell_res >= res,
+        |cell| (cell & !RESOLUTION_MASK) | (res << 52) | unused_digits,
+    )
+}
+
+/// Batch version of cellToCenterChild.
+///
+/// The resolution is validated once for the whole batch, and the children are
+/// computed with plain bit masking. An invalid cell (or a cell finer than
+/// `childRes`) doesn't stop the batch: its center child is set to H3_NULL and
+/// an error is returned once every cell has been processed.
+///
+/// @param cells    The H3 indexes.
+/// @param numCells The number of indexes.
+/// @param childRes The resolution to switch to
+/// @param out      The center child indexes, one per cell.
+/// @return E_CELL_INVALID if any cell is invalid, E_RES_DOMAIN if any cell is
+/// finer than `childRes`, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `cells` and `out` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToCenterChildren(
+    cells: *const H3Index,
+    numCells: i64,
+    childRes: c_int,
+    out: *mut H3Index,
+) -> H3Error {
+    let res = match convert::h3res_to_resolution(childRes) {
+        Ok(res) => u64::from(u8::from(res)),
+        Err(err) => return err.into(),
+    };
+    // Digits past the child resolution are already set to 7 (unused).
+    let unused_digits = (1 << (3 * (15 - res))) - 1;
+    map_cell_bits(
+        cells,
+        numCells,
+        out,
+        H3_NULL,
+        H3ErrorCodes::EResDomain,
+        |cell_res| cell_res <= res,
+        |cell| {
+            // Set the digits between the two resolutions to 0 (center).
+            let cell_res = (cell & RESOLUTION_MASK) >> 52;
+            let cell_unused_digits = (1 << (3 * (15 - cell_res))) - 1;
+            let center_digits = cell_unused_digits & !unused_digits;
+            (cell & !RESOLUTION_MASK & !center_digits) | (res << 52)
+        },
+    )
+}
+
+/// Bit mask of the resolution of an index.
+const RESOLUTION_MASK: u64 = 0xf << 52;
+
+/// Applies a bitwise transformation on every cell of the array.
+///
+/// Cells whose resolution is rejected by `accept` are set to `null`, as
+/// invalid cells, and the `mismatch` error is returned once the whole array
+/// has been processed (unless there were invalid cells).
+unsafe fn map_cell_bits<T: Copy>(
+    cells: *const H3Index,
+    numCells: i64,
+    out: *mut T,
+    null: T,
+    mismatch: H3ErrorCodes,
+    accept: impl Fn(u64) -> bool,
+    transform: impl Fn(u64) -> T,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let cells = std::slice::from_raw_parts(cells, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    let (any_invalid, any_mismatch) = cpu::dispatch(MapCellBits {
+        cells,
+        out,
+        null,
+        accept,
+        transform,
+    });
+
+    if any_invalid {
+        H3ErrorCodes::ECellInvalid.into()
+    } else if any_mismatch {
+        mismatch.into()
+    } else {
+        H3ErrorCodes::ESuccess.into()
+    }
+}
+
+/// Kernel of `map_cell_bits`, returning whether there were invalid cells and
+/// rejected resolutions.
+struct MapCellBits<'a, T, A, F> {
+    cells: &'a [H3Index],
+    out: &'a mut [T],
+    null: T,
+    accept: A,
+    transform: F,
+}
+
+impl<T, A, F> cpu::Kernel for MapCellBits<'_, T, A, F>
+where
+    T: Copy,
+    A: Fn(u64) -> bool,
+    F: Fn(u64) -> T,
+{
+    type Output = (bool, bool);
+
+    #[allow(clippy::inline_always, reason = "compiled per instruction set")]
+    #[inline(always)]
+    fn run(self) -> (bool, bool) {
+        let (mut any_invalid, mut any_mismatch) = (false, false);
+        for (dst, &cell) in self.out.iter_mut().zip(self.cells) {
+            let valid = is_valid_cell_bits(cell);
+            let accepted = (self.accept)((cell & RESOLUTION_MASK) >> 52);
+            // Both are computed unconditionally, so the loop stays branch-free.
+            let value = (self.transform)(cell);
+            *dst = if valid && accepted { value } else { self.null };
+            any_invalid |= !valid;
+            any_mismatch |= !accepted;
+        }
+        (any_invalid, any_mismatch)
+    }
+}
+
 /// Returns the H3 base cell "number" of an H3 cell (hexagon or pentagon).
 ///
 /// @param h The H3 cell.
@@ -238,6 +943,55 @@ pub unsafe extern "C" fn getIcosahedronFaces(
     }
 }
 
+/// Batch version of getIcosahedronFaces, with the faces of every cell as a bit
+/// mask: bit `i` is set if the cell intersects the face `i` (0-19).
+///
+/// Masks of invalid indexes are set to 0 and the batch carries on.
+///
+/// @param cells    The H3 indexes.
+/// @param numCells Number of indexes in `cells`.
+/// @param out      Output face masks.
+/// @return E_SUCCESS on success, E_CELL_INVALID if at least one index was
+///         invalid.
+///
+/// # Safety
+///
+/// `cells` and `out` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn getIcosahedronFaceMasks(
+    cells: *const H3Index,
+    numCells: i64,
+    out: *mut u32,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let cells = std::slice::from_raw_parts(cells, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    let mut valid = true;
+    for (dst, &cell) in out.iter_mut().zip(cells) {
+        if let Ok(index) = CellIndex::try_from(cell) {
+            *dst = index
+                .icosahedron_faces()
+                .iter()
+                .fold(0, |mask, face| mask | (1 << u8::from(face)));
+        } else {
+            *dst = 0;
+            valid = false;
+        }
+    }
+
+    if valid {
+        H3ErrorCodes::ESuccess.into()
+    } else {
+        H3ErrorCodes::ECellInvalid.into()
+    }
+}
+
 /// Returns the H3 resolution of an H3 index.
 /// @param h The H3 index.
 /// @return The resolution of the H3 index argument.
@@ -267,6 +1021,216 @@ pub extern "C" fn isValidCell(h: H3Index) -> c_int {
     CellIndex::try_from(h).is_ok().into()
 }
 
+/// Batch version of isValidCell.
+///
+/// @param cells    The H3 indexes to validate.
+/// @param numCells The number of indexes.
+/// @param out      Set to 1 for every valid cell, 0 otherwise.
+///
+/// # Safety
+///
+/// `cells` and `out` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn areValidCells(
+    cells: *const H3Index,
+    numCells: i64,
+    out: *mut u8,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let cells = std::slice::from_raw_parts(cells, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    cpu::dispatch(AreValidCells { cells, out });
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Kernel of `areValidCells`.
+struct AreValidCells<'a> {
+    cells: &'a [H3Index],
+    out: &'a mut [u8],
+}
+
+impl cpu::Kernel for AreValidCells<'_> {
+    type Output = ();
+
+    #[allow(clippy::inline_always, reason = "compiled per instruction set")]
+    #[inline(always)]
+    fn run(self) {
+        for (dst, &cell) in self.out.iter_mut().zip(self.cells) {
+            *dst = is_valid_cell_bits(cell).into();
+        }
+    }
+}
+
+/// Number of cells validated between two checks of `all_valid_cells`.
+const VALIDATION_CHUNK_SIZE: usize = 256;
+
+/// Tests if every index is a valid cell, with the kernel of `areValidCells`.
+pub fn all_valid_cells(cells: &[H3Index]) -> bool {
+    cpu::dispatch(AllValidCells { cells })
+}
+
+/// Kernel of `all_valid_cells`.
+struct AllValidCells<'a> {
+    cells: &'a [H3Index],
+}
+
+impl cpu::Kernel for AllValidCells<'_> {
+    type Output = bool;
+
+    #[allow(clippy::inline_always, reason = "compiled per instruction set")]
+    #[inline(always)]
+    fn run(self) -> bool {
+        // Branch-free within a chunk, so that it's vectorized, and stopped at
+        // the first chunk holding an invalid cell.
+        self.cells.chunks(VALIDATION_CHUNK_SIZE).all(|chunk| {
+            chunk
+                .iter()
+                .fold(true, |valid, &cell| valid & is_valid_cell_bits(cell))
+        })
+    }
+}
+
+/// Bit mask of the base cells that are pentagons.
+const PENTAGON_BASE_CELLS: u128 = (1 << 4)
+    | (1 << 14)
+    | (1 << 24)
+    | (1 << 38)
+    | (1 << 49)
+    | (1 << 58)
+    | (1 << 63)
+    | (1 << 72)
+    | (1 << 83)
+    | (1 << 97)
+    | (1 << 107)
+    | (1 << 117);
+
+/// Bit mask selecting the lowest bit of every digit.
+const DIGITS_LOW_BITS: u64 = 0o111_111_111_111_111;
+
+/// Branchless version of `CellIndex::try_from(index).is_ok()`.
+///
+/// Every check relies on plain bitwise operations (no loop over the digits, no
+/// table lookup), so that loops over this function can be vectorized.
+#[allow(clippy::inline_always, reason = "inlined in the batch kernels")]
+#[inline(always)]
+pub const fn is_valid_cell_bits(index: u64) -> bool {
+    // High bit unset, cell mode and no reserved bit.
+    let header = index >> 56 == 0b0000_1000;
+    let resolution = (index >> 52) & 0xf;
+    let base_cell = (index >> 45) & 0x7f;
+    let unused_bits = 3 * (15 - resolution);
+    let unused_mask = (1 << unused_bits) - 1;
+    let digits = (index & ((1 << 45) - 1)) >> unused_bits;
+
+    // Unused digits are all set to 7, used one are never 7.
+    let unused = index & unused_mask == unused_mask;
+    let sevens = digits & (digits >> 1) & (digits >> 2) & DIGITS_LOW_BITS;
+    let used = sevens == 0;
+
+    // Pentagons cannot have a leading digit of 1 (deleted subsequence).
+    let pentagon = is_pentagonal_base_cell(base_cell);
+    let leading_group = (63 - (digits | 1).leading_zeros()) / 3;
+    let leading_digit = (digits >> (leading_group * 3)) & 0b111;
+    let deleted = pentagon && digits != 0 && leading_digit == 1;
+
+    header && base_cell < 122 && unused && used && !deleted
+}
+
+/// Branchless version of `CellIndex::is_pentagon`, for a valid cell index.
+pub const fn is_pentagon_bits(index: u64) -> bool {
+    let resolution = (index >> 52) & 0xf;
+    let base_cell = (index >> 45) & 0x7f;
+    let unused_bits = 3 * (15 - resolution);
+    let digits = (index & ((1 << 45) - 1)) >> unused_bits;
+
+    // Pentagons are the centers of the pentagonal base cells.
+    is_pentagonal_base_cell(base_cell) && digits == 0
+}
+
+/// Tests if the base cell is a pentagon (out of range base cells aren't).
+#[allow(clippy::inline_always, reason = "inlined in the batch kernels")]
+#[inline(always)]
+const fn is_pentagonal_base_cell(base_cell: u64) -> bool {
+    base_cell < 122 && (PENTAGON_BASE_CELLS >> base_cell) & 1 == 1
+}
+
+/// Returns the mask of the digits of the resolutions in `(coarse, fine]`.
+#[allow(clippy::inline_always, reason = "inlined in the batch kernels")]
+#[inline(always)]
+const fn digits_mask(coarse: u64, fine: u64) -> u64 {
+    ((1 << (3 * (15 - coarse))) - 1) & !((1 << (3 * (15 - fine))) - 1)
+}
+
+/// Returns the number of children of a pentagon, `resolutions` finer.
+#[allow(clippy::inline_always, reason = "inlined in the batch kernels")]
+#[inline(always)]
+const fn pentagon_children_count(resolutions: u32) -> u64 {
+    1 + 5 * (7_u64.pow(resolutions) - 1) / 6
+}
+
+/// Returns the position of the cell among the children of its ancestor at
+/// `parent_res`, for a valid cell index at least as fine as `parent_res`.
+///
+/// Other indexes yield an unspecified (but non-panicking) value.
+#[allow(clippy::inline_always, reason = "inlined in the batch kernels")]
+#[inline(always)]
+fn child_position_bits(index: u64, parent_res: u64) -> u64 {
+    let resolution = (index >> 52) & 0xf;
+    let base_cell = (index >> 45) & 0x7f;
+    // The center descendants of a pentagon are pentagons too.
+    let mut pentagon = is_pentagonal_base_cell(base_cell)
+        && index & digits_mask(0, parent_res) == 0;
+
+    let mut position = 0;
+    for res in (parent_res + 1)..=resolution {
+        let digit = (index >> (3 * (15 - res))) & 0b111;
+        let remaining = u32::try_from(resolution - res).expect("at most 15");
+        let hexagon_count = 7_u64.pow(remaining);
+        if !pentagon {
+            position += digit * hexagon_count;
+        } else if digit != 0 {
+            // Skip the center pentagon and the deleted subsequence (digit 1).
+            position += pentagon_children_count(remaining)
+                + hexagon_count * digit.saturating_sub(2);
+            pentagon = false;
+        }
+    }
+
+    position
+}
+
+/// Returns the child following `index` within the ordered children of its
+/// ancestor at `parent_res`.
+///
+/// `pentagon` tells whether that ancestor is a pentagon, in which case the
+/// deleted subsequence (leading digit of 1) is skipped.
+fn next_child_bits(index: u64, parent_res: u64, pentagon: bool) -> u64 {
+    let resolution = (index >> 52) & 0xf;
+    let mut index = index;
+    // Increment the finest digit, carrying over the coarser ones.
+    for res in ((parent_res + 1)..=resolution).rev() {
+        let offset = 3 * (15 - res);
+        let digit = (index >> offset) & 0b111;
+        if digit < 6 {
+            let leading = index & digits_mask(parent_res, res - 1) == 0;
+            let next = if pentagon && leading && digit == 0 {
+                2
+            } else {
+                digit + 1
+            };
+            return (index & !(0b111 << offset)) | (next << offset);
+        }
+        index &= !(0b111 << offset);
+    }
+    index
+}
+
 /// Returns the max number of possible icosahedron faces an H3 index
 /// may intersect.
 ///
@@ -332,3 +1296,234 @@ pub extern "C" fn childPosToCell(
 
     delegate_inner!(inner(childPos, parent, childRes), out)
 }
+
+/// Returns `count` consecutive children of a cell, starting at position
+/// `start` within the ordered list of all its children at `childRes`.
+///
+/// Only the first child is located from its position, the following ones are
+/// derived by incrementing its digits.
+///
+/// @param parent   The parent cell.
+/// @param childRes The resolution of the children.
+/// @param start    The position of the first child.
+/// @param count    The number of children to return.
+/// @param out      The children, in order.
+/// @return E_DOMAIN if the range isn't within the children of the cell.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `count` elements.
+#[no_mangle]
+pub unsafe extern "C" fn childPosRangeToCells(
+    parent: H3Index,
+    childRes: c_int,
+    start: i64,
+    count: i64,
+    out: *mut H3Index,
+) -> H3Error {
+    fn inner(
+        parent: H3Index,
+        childRes: c_int,
+        start: i64,
+        count: i64,
+    ) -> Result<Option<CellIndex>, H3Error> {
+        let index = CellIndex::try_from(parent)
+            .map_err(|_| H3ErrorCodes::ECellInvalid)?;
+        let child_res = convert::h3res_to_resolution(childRes)?;
+        if child_res < index.resolution() {
+            return Err(H3ErrorCodes::EResMismatch.into());
+        }
+        let start = u64::try_from(start).map_err(|_| H3ErrorCodes::EDomain)?;
+        let count = u64::try_from(count).map_err(|_| H3ErrorCodes::EDomain)?;
+        let end = start.checked_add(count).ok_or(H3ErrorCodes::EDomain)?;
+        if end > index.children_count(child_res) {
+            return Err(H3ErrorCodes::EDomain.into());
+        }
+        if count == 0 {
+            return Ok(None);
+        }
+        Ok(index.child_at(start, child_res))
+    }
+
+    let (first, len) = match inner(parent, childRes, start, count) {
+        Ok(Some(first)) => (first, count),
+        Ok(None) => return H3ErrorCodes::ESuccess.into(),
+        Err(err) => return err,
+    };
+    let len = usize::try_from(len).expect("checked against children count");
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    let parent_res = u64::from(u8::from(
+        CellIndex::try_from(parent)
+            .expect("valid cell")
+            .resolution(),
+    ));
+    let pentagon = is_pentagon_bits(parent);
+    let mut child = u64::from(first);
+    out[0] = child;
+    for dst in &mut out[1..] {
+        child = next_child_bits(child, parent_res, pentagon);
+        *dst = child;
+    }
+
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Returns `count` consecutive cells of the whole resolution `res`, starting
+/// at position `start` within the ordered list of all its cells.
+///
+/// The cells are ordered by base cell, then by position within their base
+/// cell (see childPosToCell), like the cells of getRes0Cells's children. Since
+/// a range only depends on its bounds, workers can enumerate disjoint slices of
+/// a resolution without any coordination: see getResolutionPartitionStart for
+/// equal-size slices, or use childPosRangeToCells on every base cell for
+/// slices partitioned by base cell.
+///
+/// Only the first cell of every base cell is located from its position, the
+/// following ones are derived by incrementing its digits.
+///
+/// @param res   The resolution of the cells.
+/// @param start The position of the first cell.
+/// @param count The number of cells to return.
+/// @param out   The cells, in order.
+/// @return E_DOMAIN if the range isn't within the cells of the resolution.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `count` elements.
+#[no_mangle]
+pub unsafe extern "C" fn getResolutionCells(
+    res: c_int,
+    start: i64,
+    count: i64,
+    out: *mut H3Index,
+) -> H3Error {
+    let resolution = match convert::h3res_to_resolution(res) {
+        Ok(resolution) => resolution,
+        Err(err) => return err.into(),
+    };
+    let (Ok(mut start), Ok(len)) =
+        (u64::try_from(start), usize::try_from(count))
+    else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    match start.checked_add(u64::try_from(len).expect("count fits")) {
+        Some(end) if end <= resolution.cell_count() => (),
+        _ => return H3ErrorCodes::EDomain.into(),
+    }
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let mut out = std::slice::from_raw_parts_mut(out, len);
+
+    for base_cell in CellIndex::base_cells() {
+        if out.is_empty() {
+            break;
+        }
+        let size = base_cell.children_count(resolution);
+        if start >= size {
+            start -= size;
+            continue;
+        }
+        let available = usize::try_from(size - start).unwrap_or(usize::MAX);
+        let (chunk, tail) = out.split_at_mut(out.len().min(available));
+        let pentagon = is_pentagon_bits(base_cell.into());
+        let mut cell = u64::from(
+            base_cell
+                .child_at(start, resolution)
+                .expect("position within base cell"),
+        );
+        chunk[0] = cell;
+        for dst in &mut chunk[1..] {
+            cell = next_child_bits(cell, 0, pentagon);
+            *dst = cell;
+        }
+        out = tail;
+        start = 0;
+    }
+
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Returns the position of the first cell of a partition of the cells of the
+/// resolution `res` into `numPartitions` slices of equal size (give or take
+/// one cell), for getResolutionCells.
+///
+/// The partition `i` covers the positions from the start of `i` to the start
+/// of `i + 1`, excluded: `partition` can be `numPartitions`, which gives the
+/// number of cells of the resolution.
+///
+/// @param res           The resolution of the cells.
+/// @param partition     The partition, between 0 and `numPartitions`.
+/// @param numPartitions The number of partitions.
+/// @param out           The position of the first cell of the partition.
+/// @return E_DOMAIN if the partition is out of range.
+#[no_mangle]
+pub extern "C" fn getResolutionPartitionStart(
+    res: c_int,
+    partition: i64,
+    numPartitions: i64,
+    out: Option<&mut i64>,
+) -> H3Error {
+    fn inner(
+        res: c_int,
+        partition: i64,
+        numPartitions: i64,
+    ) -> Result<i64, H3Error> {
+        let resolution = convert::h3res_to_resolution(res)?;
+        let partition =
+            u64::try_from(partition).map_err(|_| H3ErrorCodes::EDomain)?;
+        let partitions =
+            u64::try_from(numPartitions).map_err(|_| H3ErrorCodes::EDomain)?;
+        if partitions == 0 || partition > partitions {
+            return Err(H3ErrorCodes::EDomain.into());
+        }
+        let count = u128::from(resolution.cell_count());
+        let start = count * u128::from(partition) / u128::from(partitions);
+        Ok(i64::try_from(start).expect("position within cell count"))
+    }
+
+    delegate_inner!(inner(res, partition, numPartitions), out)
+}
+
+/// Batch version of cellToChildPos.
+///
+/// The resolution is validated once for the whole batch, and the positions
+/// are computed from the digits directly. An invalid cell (or a cell coarser
+/// than `parentRes`) doesn't stop the batch: its position is set to -1 and an
+/// error is returned once every cell has been processed.
+///
+/// @param cells     The H3 indexes.
+/// @param numCells  The number of indexes.
+/// @param parentRes The resolution of the parents.
+/// @param out       The positions of the cells within their parent.
+/// @return E_CELL_INVALID if any cell is invalid, E_RES_MISMATCH if any cell
+/// is coarser than `parentRes`, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `cells` and `out` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToChildPos(
+    cells: *const H3Index,
+    numCells: i64,
+    parentRes: c_int,
+    out: *mut i64,
+) -> H3Error {
+    let res = match convert::h3res_to_resolution(parentRes) {
+        Ok(res) => u64::from(u8::from(res)),
+        Err(err) => return err.into(),
+    };
+    map_cell_bits(
+        cells,
+        numCells,
+        out,
+        -1,
+        H3ErrorCodes::EResMismatch,
+        |cell_res| cell_res >= res,
+        |cell| {
+            i64::try_from(child_position_bits(cell, res))
+                .expect("less than 7^15 children")
+        },
+    )
+}
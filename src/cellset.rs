@@ -0,0 +1,452 @@
+//! Sorted cell sets, supporting hierarchical containment queries.
+//!
+//! Sets can be saved into files laid out for memory mapping, so that the
+//! processes opening the same file share it through the page cache and can
+//! query it right away, without any deserialization.
+//!
+//! File layout (every field is a little-endian 64-bit integer):
+//! - magic number and format version;
+//! - number of ranges;
+//! - directory: index of the first range of every base cell, followed by the
+//!   number of ranges;
+//! - first index of every range, in ascending order;
+//! - last index of every range.
+
+use crate::{
+    cell, delegate_inner,
+    pages::{self, Words},
+    H3Error, H3ErrorCodes, H3Index, H3_NULL,
+};
+use memmap2::Mmap;
+use std::{
+    ffi::{c_char, c_int, CStr},
+    fs::File,
+    io::{self, BufWriter, Write},
+    path::Path,
+};
+
+/// Bit mask of the resolution of an index.
+const RESOLUTION_MASK: u64 = 0xf << 52;
+
+/// Number of base cells.
+const BASE_CELL_COUNT: usize = 122;
+
+/// Magic number and format version of the cell set files.
+const FILE_MAGIC: &[u8; 8] = b"H3CSET\0\x01";
+
+/// Size, in bytes, of the file header (magic number and number of ranges) and
+/// directory.
+const FILE_PREAMBLE_SIZE: usize = 8 * (2 + DIRECTORY_SIZE);
+
+/// Number of entries of the directory.
+const DIRECTORY_SIZE: usize = BASE_CELL_COUNT + 1;
+
+/// A set of cells, at any resolution.
+///
+/// Every cell is stored as the range covering all of its descendants in the
+/// index space at resolution 15, so that a cell is contained as soon as it
+/// falls within a range, whatever its resolution. Ranges either nest or are
+/// disjoint: only the outermost ones are kept, sorted and non-overlapping.
+pub struct H3CellSet {
+    /// Backing storage of the ranges.
+    storage: Storage,
+    /// Index of the first range of every base cell, followed by the number of
+    /// ranges.
+    ///
+    /// Ranges never span several base cells, so lookups only have to search
+    /// the ranges of the base cell of the looked up cell.
+    directory: [usize; DIRECTORY_SIZE],
+}
+
+/// Storage of the ranges of a cell set.
+enum Storage {
+    /// Ranges built in memory.
+    Owned {
+        /// First index of every range, in ascending order.
+        starts: Words,
+        /// Last index of every range (inclusive).
+        ends: Words,
+    },
+    /// Ranges read from a memory-mapped file.
+    Mapped(Mmap),
+}
+
+impl H3CellSet {
+    /// Builds the set from a slice of valid cells (H3_NULL are ignored).
+    fn new(cells: &[H3Index]) -> Result<Self, H3Error> {
+        let mut ranges = Vec::with_capacity(cells.len());
+        for &cell in cells.iter().filter(|&&cell| cell != H3_NULL) {
+            if !cell::is_valid_cell_bits(cell) {
+                return Err(H3ErrorCodes::ECellInvalid.into());
+            }
+            ranges.push(Range::from(cell));
+        }
+        // Outer ranges come before the ones they contain.
+        ranges.sort_unstable_by(|a, b| {
+            a.start.cmp(&b.start).then(b.end.cmp(&a.end))
+        });
+
+        let mut starts = Vec::with_capacity(ranges.len());
+        let mut ends = Vec::with_capacity(ranges.len());
+        for range in ranges {
+            // Skip the ranges nested in the previous one.
+            if ends.last().is_some_and(|&end| range.start <= end) {
+                continue;
+            }
+            starts.push(range.start);
+            ends.push(range.end);
+        }
+        starts.shrink_to_fit();
+        ends.shrink_to_fit();
+
+        let directory = std::array::from_fn(|base_cell| {
+            starts.partition_point(|&start| self::base_cell(start) < base_cell)
+        });
+        Ok(Self {
+            storage: Storage::Owned {
+                starts: Words::from_vec(starts),
+                ends: Words::from_vec(ends),
+            },
+            directory,
+        })
+    }
+
+    /// Maps a file written by `write`.
+    ///
+    /// Only the header and the directory are read, ranges are loaded lazily
+    /// by the OS as they are looked up.
+    fn open(path: &Path) -> Result<Self, H3Error> {
+        // Ranges are used as-is, which requires a little-endian target.
+        if cfg!(target_endian = "big") {
+            return Err(H3ErrorCodes::EFailed.into());
+        }
+        let file = File::open(path).map_err(|_| H3ErrorCodes::EFailed)?;
+        // SAFETY: the file must not be modified while it's mapped, as
+        // documented by `openMappedCellSet`.
+        let map =
+            unsafe { Mmap::map(&file) }.map_err(|_| H3ErrorCodes::EFailed)?;
+
+        let (magic, preamble) = map
+            .get(..FILE_PREAMBLE_SIZE)
+            .ok_or(H3ErrorCodes::EFailed)?
+            .split_at(FILE_MAGIC.len());
+        if magic != FILE_MAGIC {
+            return Err(H3ErrorCodes::EFailed.into());
+        }
+        let mut words = preamble.chunks_exact(8).map(|bytes| {
+            let word = u64::from_le_bytes(bytes.try_into().expect("8 bytes"));
+            usize::try_from(word).map_err(|_| H3ErrorCodes::EFailed)
+        });
+        let count = words.next().ok_or(H3ErrorCodes::EFailed)??;
+        let mut directory = [0; DIRECTORY_SIZE];
+        for (entry, word) in directory.iter_mut().zip(words) {
+            *entry = word?;
+        }
+
+        // The directory must be consistent with the ranges, which must fill
+        // the rest of the (8-byte aligned) mapping.
+        let size = count
+            .checked_mul(16)
+            .and_then(|size| size.checked_add(FILE_PREAMBLE_SIZE));
+        if size != Some(map.len())
+            || map.as_ptr().align_offset(8) != 0
+            || directory[0] != 0
+            || directory[BASE_CELL_COUNT] != count
+            || directory.windows(2).any(|pair| pair[0] > pair[1])
+        {
+            return Err(H3ErrorCodes::EFailed.into());
+        }
+
+        pages::advise_file_mapping(&map);
+        Ok(Self {
+            storage: Storage::Mapped(map),
+            directory,
+        })
+    }
+
+    /// Saves the set into a file that can be mapped by `open`.
+    fn write(&self, path: &Path) -> io::Result<()> {
+        let mut writer = BufWriter::new(File::create(path)?);
+        writer.write_all(FILE_MAGIC)?;
+        let count = self.directory[BASE_CELL_COUNT];
+        let words = std::iter::once(u64::try_from(count).expect("count"))
+            .chain(
+                self.directory
+                    .iter()
+                    .map(|&index| u64::try_from(index).expect("index")),
+            )
+            .chain(self.starts().iter().copied())
+            .chain(self.ends().iter().copied());
+        for word in words {
+            writer.write_all(&word.to_le_bytes())?;
+        }
+        writer
+            .into_inner()
+            .map_err(io::IntoInnerError::into_error)?;
+        Ok(())
+    }
+
+    /// First index of every range, in ascending order.
+    fn starts(&self) -> &[u64] {
+        match self.storage {
+            Storage::Owned { ref starts, .. } => starts,
+            Storage::Mapped(ref map) => {
+                let count = self.directory[BASE_CELL_COUNT];
+                mapped_words(map, FILE_PREAMBLE_SIZE, count)
+            }
+        }
+    }
+
+    /// Last index of every range (inclusive).
+    fn ends(&self) -> &[u64] {
+        match self.storage {
+            Storage::Owned { ref ends, .. } => ends,
+            Storage::Mapped(ref map) => {
+                let count = self.directory[BASE_CELL_COUNT];
+                mapped_words(map, FILE_PREAMBLE_SIZE + 8 * count, count)
+            }
+        }
+    }
+
+    /// Tests if the set contains the (valid) cell or one of its ancestors.
+    #[must_use]
+    pub fn contains(&self, cell: H3Index) -> bool {
+        let range = Range::from(cell);
+        let base_cell = base_cell(range.start);
+        let (first, last) =
+            (self.directory[base_cell], self.directory[base_cell + 1]);
+        // Last range starting at or before the cell.
+        let id = self.starts()[first..last]
+            .partition_point(|&start| start <= range.start);
+        id.checked_sub(1)
+            .is_some_and(|id| range.end <= self.ends()[first + id])
+    }
+}
+
+/// Returns the base cell of an index.
+pub fn base_cell(index: u64) -> usize {
+    usize::try_from((index >> 45) & 0x7f).expect("7-bit base cell")
+}
+
+/// Returns `len` 64-bit words of the mapping, starting at byte `offset`.
+fn mapped_words(map: &Mmap, offset: usize, len: usize) -> &[u64] {
+    let bytes = &map[offset..offset + 8 * len];
+    // SAFETY: every bit pattern is a valid u64, and the mapping and offset
+    // alignments have been checked when opening the file.
+    let (head, words, _) = unsafe { bytes.align_to::<u64>() };
+    debug_assert!(head.is_empty(), "misaligned mapping");
+    words
+}
+
+/// The descendants of a cell, at resolution 15.
+pub struct Range {
+    /// First descendant.
+    pub start: u64,
+    /// Last descendant (inclusive).
+    pub end: u64,
+}
+
+impl From<H3Index> for Range {
+    fn from(value: H3Index) -> Self {
+        let resolution = (value & RESOLUTION_MASK) >> 52;
+        let unused_mask = (1 << (3 * (15 - resolution))) - 1;
+        // Resolution is set to 15 so that ranges are comparable across
+        // resolutions, unused digits span every descendant.
+        let start = (value & !RESOLUTION_MASK & !unused_mask) | (15 << 52);
+        Self {
+            start,
+            end: start | unused_mask,
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/// createCellSet builds a set of cells, compacted or not, supporting
+/// containment queries at any resolution.
+///
+/// A cell is contained in the set if the set holds that cell or one of its
+/// ancestors. H3_NULL entries are ignored.
+///
+/// It is the responsibility of the caller to call destroyCellSet on the set,
+/// or its memory will not be freed.
+///
+/// @param cells    The cells of the set, at any resolution
+/// @param numCells The number of cells
+/// @param out      The created set
+/// @return E_CELL_INVALID if any cell is invalid, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn createCellSet(
+    cells: *const H3Index,
+    numCells: i64,
+    out: Option<&mut *mut H3CellSet>,
+) -> H3Error {
+    unsafe fn inner(
+        cells: *const H3Index,
+        numCells: i64,
+    ) -> Result<*mut H3CellSet, H3Error> {
+        let len =
+            usize::try_from(numCells).map_err(|_| H3ErrorCodes::EDomain)?;
+        let cells = if len == 0 {
+            &[]
+        } else {
+            std::slice::from_raw_parts(cells, len)
+        };
+        let set = H3CellSet::new(cells)?;
+        Ok(Box::into_raw(Box::new(set)))
+    }
+
+    delegate_inner!(inner(cells, numCells), out)
+}
+
+/// cellSetContains tests if a cell, or one of its ancestors, is in the set.
+///
+/// @param set  The set created by createCellSet
+/// @param cell The cell to look up, at any resolution
+/// @param out  Set to 1 if the cell is covered by the set, 0 otherwise
+/// @return E_CELL_INVALID if the cell is invalid, E_SUCCESS otherwise.
+#[no_mangle]
+pub extern "C" fn cellSetContains(
+    set: Option<&H3CellSet>,
+    cell: H3Index,
+    out: Option<&mut c_int>,
+) -> H3Error {
+    fn inner(set: &H3CellSet, cell: H3Index) -> Result<c_int, H3Error> {
+        if !cell::is_valid_cell_bits(cell) {
+            return Err(H3ErrorCodes::ECellInvalid.into());
+        }
+        Ok(set.contains(cell).into())
+    }
+
+    delegate_inner!(inner(set.expect("null pointer"), cell), out)
+}
+
+/// Batch version of cellSetContains.
+///
+/// An invalid cell doesn't stop the batch: it's reported as not contained and
+/// an error is returned once every cell has been processed.
+///
+/// @param set      The set created by createCellSet
+/// @param cells    The cells to look up, at any resolution
+/// @param numCells The number of cells
+/// @param out      Set to 1 for every cell covered by the set, 0 otherwise
+/// @return E_CELL_INVALID if any cell is invalid, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `cells` and `out` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellSetContainsCells(
+    set: Option<&H3CellSet>,
+    cells: *const H3Index,
+    numCells: i64,
+    out: *mut u8,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let set = set.expect("null pointer");
+    let cells = std::slice::from_raw_parts(cells, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    let mut any_invalid = false;
+    for (dst, &cell) in out.iter_mut().zip(cells) {
+        let valid = cell::is_valid_cell_bits(cell);
+        *dst = (valid && set.contains(cell)).into();
+        any_invalid |= !valid;
+    }
+
+    if any_invalid {
+        H3ErrorCodes::ECellInvalid.into()
+    } else {
+        H3ErrorCodes::ESuccess.into()
+    }
+}
+
+/// openMappedCellSet opens a cell set saved by writeCellSetFile.
+///
+/// The file is mapped in memory rather than loaded: opening is immediate,
+/// lookups don't require any deserialization, and every process mapping the
+/// same file shares its content through the page cache.
+///
+/// It is the responsibility of the caller to call destroyCellSet on the set,
+/// or its memory will not be unmapped.
+///
+/// @param path The path of the file
+/// @param out  The opened set
+/// @return E_FAILED if the file can't be mapped or isn't a cell set file,
+///         E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `path` must point to a null-terminated string, and the file must not be
+/// modified while the set is open.
+#[no_mangle]
+pub unsafe extern "C" fn openMappedCellSet(
+    path: *const c_char,
+    out: Option<&mut *mut H3CellSet>,
+) -> H3Error {
+    unsafe fn inner(path: *const c_char) -> Result<*mut H3CellSet, H3Error> {
+        let path = CStr::from_ptr(path)
+            .to_str()
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        let set = H3CellSet::open(Path::new(path))?;
+        Ok(Box::into_raw(Box::new(set)))
+    }
+
+    delegate_inner!(inner(path), out)
+}
+
+/// writeCellSetFile saves a cell set into a file, laid out to be mapped by
+/// openMappedCellSet.
+///
+/// @param set  The set created by createCellSet (or openMappedCellSet)
+/// @param path The path of the file, overwritten if it exists
+/// @return E_FAILED if the file can't be written, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `path` must point to a null-terminated string.
+#[no_mangle]
+pub unsafe extern "C" fn writeCellSetFile(
+    set: Option<&H3CellSet>,
+    path: *const c_char,
+) -> H3Error {
+    unsafe fn inner(
+        set: &H3CellSet,
+        path: *const c_char,
+    ) -> Result<(), H3Error> {
+        let path = CStr::from_ptr(path)
+            .to_str()
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        set.write(Path::new(path))
+            .map_err(|_| H3ErrorCodes::EFailed.into())
+    }
+
+    inner(set.expect("null pointer"), path)
+        .err()
+        .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// Free all allocated memory for a cell set.
+///
+/// Mapped sets are unmapped.
+///
+/// @param set The set to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`createCellSet`] or [`openMappedCellSet`]
+#[no_mangle]
+pub unsafe extern "C" fn destroyCellSet(set: *mut H3CellSet) {
+    if !set.is_null() {
+        drop(Box::from_raw(set));
+    }
+}
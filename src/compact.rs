@@ -1,6 +1,9 @@
-use crate::{convert, delegate_inner, H3Error, H3ErrorCodes, H3Index};
+use crate::{
+    cell, cellset::Range, convert, delegate_inner, parallel, sort, stats,
+    H3Error, H3ErrorCodes, H3Index, H3Workspace, H3_NULL,
+};
 use h3o::CellIndex;
-use std::ffi::c_int;
+use std::{cmp::Ordering, ffi::c_int, ptr};
 
 /// compactCells takes a set of hexagons all at the same resolution and
 /// compresses them by pruning full child branches to the parent level. This is
@@ -33,6 +36,7 @@ pub unsafe extern "C" fn compactCells(
         Ok(CellIndex::compact(indexes.iter().copied())?)
     }
 
+    let _scope = stats::Scope::new(stats::Function::CompactCells, numHexes);
     if numHexes == 0 {
         return H3ErrorCodes::ESuccess.into();
     }
@@ -50,6 +54,424 @@ pub unsafe extern "C" fn compactCells(
     }
 }
 
+/// compactSortedCells is the same as compactCells, for a set of hexagons
+/// already sorted (in ascending order) and without duplicates.
+///
+/// This allows to skip the sorting and the deduplication performed by
+/// compactCells. The compacted set is sorted, and the unused tail of the
+/// output array is filled with H3_NULL.
+///
+/// @param h3Set        Set of hexagons, sorted and without duplicates
+/// @param compactedSet The output array of compressed hexagons (preallocated)
+/// @param numHexes     The size of the input and output arrays
+/// @return an error code on bad input data (E_FAILED if the set isn't sorted)
+///
+/// # Safety
+///
+/// `h3Set` and `compactedSet` must points to an array of at least `numHexes`
+/// elements.
+#[no_mangle]
+pub unsafe extern "C" fn compactSortedCells(
+    h3Set: *const H3Index,
+    compactedSet: *mut H3Index,
+    numHexes: i64,
+) -> H3Error {
+    unsafe fn inner(
+        h3Set: *const H3Index,
+        compactedSet: *mut H3Index,
+        numHexes: i64,
+    ) -> Result<(), H3Error> {
+        let len = usize::try_from(numHexes).expect("overflow");
+        // Work on a copy, validated and compacted in place.
+        ptr::copy_nonoverlapping(h3Set, compactedSet, len);
+        let cells = convert::h3ptr_to_h3oslice_mut(compactedSet, numHexes)?;
+
+        let count = compact_sorted(cells)?;
+        std::slice::from_raw_parts_mut(compactedSet, len)[count..]
+            .fill(H3_NULL);
+        Ok(())
+    }
+
+    if numHexes == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    inner(h3Set, compactedSet, numHexes)
+        .err()
+        .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// compactCellsInPlace is the same as compactCells, but the compacted set is
+/// written into the input array (no output array is needed).
+///
+/// The set is sorted in place first, unless it's already sorted. On success
+/// the first `out` elements hold the compacted set (sorted) and the tail of
+/// the array is filled with H3_NULL. On error, the content of the array is
+/// unspecified.
+///
+/// @param h3Set    Set of hexagons, overwritten by the compacted set
+/// @param numHexes The size of the array
+/// @param out      The number of compacted hexagons
+/// @return an error code on bad input data
+///
+/// # Safety
+///
+/// `h3Set` must points to an array of at least `numHexes` elements.
+#[no_mangle]
+pub unsafe extern "C" fn compactCellsInPlace(
+    h3Set: *mut H3Index,
+    numHexes: i64,
+    out: Option<&mut i64>,
+) -> H3Error {
+    unsafe fn inner(
+        h3Set: *mut H3Index,
+        numHexes: i64,
+    ) -> Result<i64, H3Error> {
+        let cells = convert::h3ptr_to_h3oslice_mut(h3Set, numHexes)?;
+        if !cells.windows(2).all(|pair| pair[0] <= pair[1]) {
+            cells.sort_unstable();
+        }
+
+        let count = compact_sorted(cells)?;
+        let len = usize::try_from(numHexes).expect("overflow");
+        std::slice::from_raw_parts_mut(h3Set, len)[count..].fill(H3_NULL);
+        Ok(i64::try_from(count).expect("compacted set too large"))
+    }
+
+    if numHexes == 0 {
+        *out.expect("null pointer") = 0;
+        return H3ErrorCodes::ESuccess.into();
+    }
+    delegate_inner!(inner(h3Set, numHexes), out)
+}
+
+/// compactCellsWs is the same as compactCells, but the set is sorted and
+/// compacted in the buffer of a workspace (instead of a new one every call).
+///
+/// The compacted set is sorted, and the unused tail of the output array is
+/// filled with H3_NULL.
+///
+/// @param workspace    Workspace created by createWorkspace
+/// @param h3Set        Set of hexagons
+/// @param compactedSet The output array of compressed hexagons (preallocated)
+/// @param numHexes     The size of the input and output arrays
+/// @return an error code on bad input data
+///
+/// # Safety
+///
+/// `h3Set` and `compactedSet` must points to an array of at least `numHexes`
+/// elements.
+#[no_mangle]
+pub unsafe extern "C" fn compactCellsWs(
+    workspace: Option<&mut H3Workspace>,
+    h3Set: *const H3Index,
+    compactedSet: *mut H3Index,
+    numHexes: i64,
+) -> H3Error {
+    unsafe fn inner(
+        workspace: &mut H3Workspace,
+        h3Set: *const H3Index,
+        compactedSet: *mut H3Index,
+        numHexes: i64,
+    ) -> Result<(), H3Error> {
+        let indexes = convert::h3ptr_to_h3oslice(h3Set, numHexes)?;
+        let cells = workspace.cells();
+        cells.extend_from_slice(indexes);
+        cells.sort_unstable();
+
+        let count = compact_sorted(cells)?;
+        let len = usize::try_from(numHexes).expect("overflow");
+        let out = std::slice::from_raw_parts_mut(compactedSet, len);
+        for (dst, &cell) in out.iter_mut().zip(&cells[..count]) {
+            *dst = cell.into();
+        }
+        out[count..].fill(H3_NULL);
+        Ok(())
+    }
+
+    let Some(workspace) = workspace else {
+        return H3ErrorCodes::EFailed.into();
+    };
+    if numHexes == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    inner(workspace, h3Set, compactedSet, numHexes)
+        .err()
+        .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// Max number of cells held by a compactor between two calls, i.e. the extra
+/// room of the output buffer of compactorPush (see compactorFinish).
+///
+/// Only the open sibling groups are held: at most one per resolution, with
+/// at most 6 cells (the 7th completes the group).
+pub const H3_COMPACTOR_MAX_PENDING: usize = 90;
+
+/// Streaming compaction of a sorted set of cells, fed by chunks.
+pub struct H3Compactor {
+    /// Resolution of the input cells.
+    resolution: h3o::Resolution,
+    /// Cells that may still be merged into their parent, in the order of the
+    /// compacted set.
+    pending: Vec<CellIndex>,
+    /// Last input cell.
+    last: Option<CellIndex>,
+}
+
+impl H3Compactor {
+    /// Checks that a chunk follows the cells pushed so far.
+    fn check(&self, cells: &[CellIndex]) -> Result<(), H3Error> {
+        let mut prev = self.last;
+        for &cell in cells {
+            if cell.resolution() != self.resolution {
+                return Err(H3ErrorCodes::EResMismatch.into());
+            }
+            match prev.map(|prev| prev.cmp(&cell)) {
+                Some(Ordering::Equal) => {
+                    return Err(H3ErrorCodes::EDuplicateInput.into());
+                }
+                Some(Ordering::Greater) => {
+                    return Err(H3ErrorCodes::EFailed.into());
+                }
+                Some(Ordering::Less) | None => (),
+            }
+            prev = Some(cell);
+        }
+        Ok(())
+    }
+
+    /// Adds a cell, moving the cells that can't be merged anymore to `out`.
+    fn push(&mut self, cell: CellIndex, out: &mut Vec<H3Index>) {
+        self.last = Some(cell);
+        self.pending.push(cell);
+        // Merge the complete sibling groups, recursively.
+        while let Some((parent, count)) = complete_parent(&self.pending) {
+            self.pending.truncate(self.pending.len() - count);
+            self.pending.push(parent);
+        }
+
+        // A group that doesn't contain the last cell is closed: it won't
+        // complete anymore, nor will the groups containing it, so every cell
+        // up to it is final.
+        let (&last, head) = self.pending.split_last().expect("last cell");
+        let closed = head.iter().rposition(|&cell| {
+            cell.resolution().pred().is_none_or(|parent_res| {
+                cell.parent(parent_res) != last.parent(parent_res)
+            })
+        });
+        if let Some(end) = closed {
+            out.extend(self.pending.drain(..=end).map(H3Index::from));
+        }
+    }
+}
+
+/// createCompactor creates a streaming compactor, which compacts a set of
+/// cells fed by chunks, as compactCells would.
+///
+/// The cells must be pushed in ascending order, without duplicates: since
+/// the children of a cell are contiguous, a sibling group is merged as soon
+/// as it's complete, and the compacted cells are handed over as soon as they
+/// can't be merged anymore. Only the open sibling groups are kept in memory,
+/// at most H3_COMPACTOR_MAX_PENDING cells, whatever the size of the set.
+///
+/// It is the responsibility of the caller to call destroyCompactor on the
+/// compactor, or its memory will not be freed.
+///
+/// @param res The resolution of the cells
+/// @param out The created compactor
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn createCompactor(
+    res: c_int,
+    out: Option<&mut *mut H3Compactor>,
+) -> H3Error {
+    fn inner(res: c_int) -> Result<*mut H3Compactor, H3Error> {
+        let resolution = convert::h3res_to_resolution(res)?;
+        Ok(Box::into_raw(Box::new(H3Compactor {
+            resolution,
+            pending: Vec::with_capacity(H3_COMPACTOR_MAX_PENDING + 1),
+            last: None,
+        })))
+    }
+
+    delegate_inner!(inner(res), out)
+}
+
+/// compactorPush adds a chunk of cells to a compactor, and writes the
+/// compacted cells that are final into `out`.
+///
+/// The output of the successive calls, followed by compactorFinish, is the
+/// compacted set given by compactSortedCells, in the same order.
+///
+/// @param compactor The compactor created by createCompactor
+/// @param cells     The cells, at the resolution of the compactor, greater
+///                  than every cell already pushed and sorted
+/// @param numCells  The number of cells
+/// @param out       The output array of compacted cells
+/// @param maxOut    The size of the output array, at least
+///                  `numCells + H3_COMPACTOR_MAX_PENDING`
+/// @param numOut    The number of compacted cells written
+/// @return E_CELL_INVALID if a cell is invalid, E_RES_MISMATCH if a cell isn't
+/// at the resolution of the compactor, E_DUPLICATE_INPUT if a cell was already
+/// pushed, E_FAILED if the cells aren't sorted, E_MEMORY_BOUNDS if the output
+/// array is too small. On error, the compactor is left untouched.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements, and `out`
+/// to an array of at least `maxOut` elements.
+#[no_mangle]
+pub unsafe extern "C" fn compactorPush(
+    compactor: Option<&mut H3Compactor>,
+    cells: *const H3Index,
+    numCells: i64,
+    out: *mut H3Index,
+    maxOut: i64,
+    numOut: Option<&mut i64>,
+) -> H3Error {
+    unsafe fn inner(
+        compactor: &mut H3Compactor,
+        cells: *const H3Index,
+        numCells: i64,
+        out: *mut H3Index,
+        maxOut: i64,
+    ) -> Result<i64, H3Error> {
+        let (Ok(len), Ok(capacity)) =
+            (usize::try_from(numCells), usize::try_from(maxOut))
+        else {
+            return Err(H3ErrorCodes::EDomain.into());
+        };
+        if capacity < len + H3_COMPACTOR_MAX_PENDING {
+            return Err(H3ErrorCodes::EMemoryBounds.into());
+        }
+        if len == 0 {
+            return Ok(0);
+        }
+        let cells = convert::h3ptr_to_h3oslice(cells, numCells)?;
+        compactor.check(cells)?;
+
+        let mut compacted = Vec::with_capacity(len + H3_COMPACTOR_MAX_PENDING);
+        for &cell in cells {
+            compactor.push(cell, &mut compacted);
+        }
+        std::slice::from_raw_parts_mut(out, compacted.len())
+            .copy_from_slice(&compacted);
+        Ok(i64::try_from(compacted.len()).expect("bounded by maxOut"))
+    }
+
+    let compactor = compactor.expect("null pointer");
+    delegate_inner!(inner(compactor, cells, numCells, out, maxOut), numOut)
+}
+
+/// compactorFinish writes the compacted cells still held by a compactor into
+/// `out`, and resets the compactor for a new set.
+///
+/// @param compactor The compactor created by createCompactor
+/// @param out       The output array of compacted cells, of size
+///                  H3_COMPACTOR_MAX_PENDING
+/// @param numOut    The number of compacted cells written
+/// @return 0 (E_SUCCESS) on success.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `H3_COMPACTOR_MAX_PENDING`
+/// elements.
+#[no_mangle]
+pub unsafe extern "C" fn compactorFinish(
+    compactor: Option<&mut H3Compactor>,
+    out: *mut H3Index,
+    numOut: Option<&mut i64>,
+) -> H3Error {
+    let compactor = compactor.expect("null pointer");
+    let count = compactor.pending.len();
+    if count != 0 {
+        let out = std::slice::from_raw_parts_mut(out, count);
+        for (dst, cell) in out.iter_mut().zip(compactor.pending.drain(..)) {
+            *dst = cell.into();
+        }
+    }
+    compactor.last = None;
+    *numOut.expect("null pointer") =
+        i64::try_from(count).expect("bounded pending cells");
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Free all allocated memory for a compactor.
+///
+/// @param compactor The compactor to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`createCompactor`]
+#[no_mangle]
+pub unsafe extern "C" fn destroyCompactor(compactor: *mut H3Compactor) {
+    if !compactor.is_null() {
+        drop(Box::from_raw(compactor));
+    }
+}
+
+/// Compacts a sorted set of cells in place, returning the number of compacted
+/// cells (stored at the beginning of the slice, in ascending order).
+///
+/// Since the children of a cell are contiguous in a sorted set, every complete
+/// group of siblings is replaced by its parent as soon as it's read. The
+/// output never overtakes the input, so it can be written in the same buffer.
+fn compact_sorted(cells: &mut [CellIndex]) -> Result<usize, H3Error> {
+    let Some(resolution) = cells.first().map(|cell| cell.resolution()) else {
+        return Ok(0);
+    };
+
+    let mut len = 0;
+    let mut prev = None;
+    for i in 0..cells.len() {
+        let cell = cells[i];
+        if cell.resolution() != resolution {
+            return Err(H3ErrorCodes::EResMismatch.into());
+        }
+        match prev.map(|prev: CellIndex| prev.cmp(&cell)) {
+            Some(Ordering::Equal) => {
+                return Err(H3ErrorCodes::EDuplicateInput.into());
+            }
+            Some(Ordering::Greater) => return Err(H3ErrorCodes::EFailed.into()),
+            Some(Ordering::Less) | None => (),
+        }
+        prev = Some(cell);
+
+        cells[len] = cell;
+        len += 1;
+        // Merge the complete sibling groups, recursively.
+        while let Some((parent, count)) = complete_parent(&cells[..len]) {
+            len -= count;
+            cells[len] = parent;
+            len += 1;
+        }
+    }
+
+    Ok(len)
+}
+
+/// Returns the parent of the last cell if the tail of the sorted set is made
+/// of all of its children, along with the number of children.
+fn complete_parent(cells: &[CellIndex]) -> Option<(CellIndex, usize)> {
+    let &last = cells.last()?;
+    let resolution = last.resolution();
+    let parent_res = resolution.pred()?;
+    let parent = last.parent(parent_res)?;
+    let count = usize::try_from(parent.children_count(resolution))
+        .expect("children count overflow");
+    let siblings = &cells[cells.len().checked_sub(count)?..];
+
+    // Cells are unique, so `count` children of the parent cover it entirely.
+    siblings
+        .iter()
+        .all(|cell| {
+            cell.resolution() == resolution
+                && cell.parent(parent_res) == Some(parent)
+        })
+        .then_some((parent, count))
+}
+
 /// uncompactCells takes a compressed set of cells and expands back to the
 /// original set of cells.
 ///
@@ -83,6 +505,8 @@ pub unsafe extern "C" fn uncompactCells(
         Ok(CellIndex::uncompact(indexes.iter().copied(), res))
     }
 
+    let _scope =
+        stats::Scope::new(stats::Function::UncompactCells, numCompacted);
     if numCompacted == 0 {
         return H3ErrorCodes::ESuccess.into();
     }
@@ -100,6 +524,151 @@ pub unsafe extern "C" fn uncompactCells(
     }
 }
 
+/// uncompactCellsSorted is the same as uncompactCells, except that the cells
+/// are written in ascending order (see h3SortCells), without duplicates, at
+/// the start of `outSet`.
+///
+/// A compacted set sorted in ascending order, at a single resolution, expands
+/// to sorted cells: they are only checked then. Other sets are sorted on the
+/// thread pool, and overlapping cells (e.g. a cell and its parent) only yield
+/// their children once.
+///
+/// @param   compactedSet Set of compacted cells
+/// @param   numCompacted The number of cells in the input compacted set
+/// @param   outSet       Output array for decompressed cells (preallocated)
+/// @param   numOut       The size of the output array to bound check against
+/// @param   res          The H3 resolution to decompress to
+/// @param   count        Number of cells written
+/// @return               An error code if output array is too small or any
+///                       cell is smaller than the output resolution.
+/// # Safety
+///
+/// `compactedSet` must points to an array of at least `numCompacted` elements.
+/// `outSet` must points to an array of at least `numOut` elements.
+#[no_mangle]
+pub unsafe extern "C" fn uncompactCellsSorted(
+    compactedSet: *const H3Index,
+    numCompacted: i64,
+    outSet: *mut H3Index,
+    numOut: i64,
+    res: c_int,
+    count: Option<&mut i64>,
+) -> H3Error {
+    unsafe fn inner(
+        compactedSet: *const H3Index,
+        numCompacted: i64,
+        outSet: *mut H3Index,
+        numOut: i64,
+        res: c_int,
+    ) -> Result<i64, H3Error> {
+        let res = convert::h3res_to_resolution(res)?;
+        if numCompacted == 0 {
+            return Ok(0);
+        }
+        let indexes = convert::h3ptr_to_h3oslice(compactedSet, numCompacted)?;
+        if indexes.iter().any(|index| index.resolution() > res) {
+            return Err(H3ErrorCodes::EResMismatch.into());
+        }
+
+        let total = CellIndex::uncompact_size(indexes.iter().copied(), res);
+        let capacity =
+            u64::try_from(numOut).map_err(|_| H3ErrorCodes::EMemoryBounds)?;
+        if total > capacity {
+            return Err(H3ErrorCodes::EMemoryBounds.into());
+        }
+        let len = usize::try_from(total).expect("output too large");
+        let out = std::slice::from_raw_parts_mut(outSet, len);
+        let children = CellIndex::uncompact(indexes.iter().copied(), res);
+        for (dst, cell_index) in out.iter_mut().zip(children) {
+            *dst = cell_index.into();
+        }
+        let len = sort::sort_dedup(out, true);
+        Ok(i64::try_from(len).expect("too many cells"))
+    }
+
+    let _scope =
+        stats::Scope::new(stats::Function::UncompactCells, numCompacted);
+    delegate_inner!(
+        inner(compactedSet, numCompacted, outSet, numOut, res),
+        count
+    )
+}
+
+/// uncompactCellsParallel is the same as uncompactCells, but the expansion is
+/// spread over every available worker.
+///
+/// The position of the children of every compacted cell is computed upfront,
+/// so that each worker writes its share of the output directly in place.
+///
+/// @param   compactSet  Set of compacted cells
+/// @param   numCompact  The number of cells in the input compacted set
+/// @param   outSet      Output array for decompressed cells (preallocated)
+/// @param   numOut      The size of the output array to bound check against
+/// @param   res         The H3 resolution to decompress to
+/// @return              An error code if output array is too small or any cell
+///                       is smaller than the output resolution.
+/// # Safety
+///
+/// `compactedSet` must points to an array of at least `numCompacted` elements.
+/// `outSet` must points to an array of at least `numOut` elements.
+#[no_mangle]
+pub unsafe extern "C" fn uncompactCellsParallel(
+    compactedSet: *const H3Index,
+    numCompacted: i64,
+    outSet: *mut H3Index,
+    numOut: i64,
+    res: c_int,
+) -> H3Error {
+    unsafe fn inner(
+        compactedSet: *const H3Index,
+        numCompacted: i64,
+        outSet: *mut H3Index,
+        numOut: i64,
+        res: c_int,
+    ) -> Result<(), H3Error> {
+        let res = convert::h3res_to_resolution(res)?;
+        let indexes = convert::h3ptr_to_h3oslice(compactedSet, numCompacted)?;
+
+        // Offsets of the children of each compacted cell in the output.
+        let mut offsets = Vec::with_capacity(indexes.len() + 1);
+        let mut total = 0;
+        offsets.push(total);
+        for index in indexes {
+            if index.resolution() > res {
+                return Err(H3ErrorCodes::EResMismatch.into());
+            }
+            total += index.children_count(res);
+            offsets.push(total);
+        }
+        let capacity =
+            u64::try_from(numOut).map_err(|_| H3ErrorCodes::EMemoryBounds)?;
+        if total > capacity {
+            return Err(H3ErrorCodes::EMemoryBounds.into());
+        }
+
+        // Split the input in ranges of (roughly) the same output size.
+        let len = usize::try_from(total).expect("output too large");
+        let out = std::slice::from_raw_parts_mut(outSet, len);
+        let tasks = parallel::split_by_output(indexes, &offsets, out);
+
+        parallel::for_each(tasks, |(indexes, out)| {
+            let children = CellIndex::uncompact(indexes.iter().copied(), res);
+            for (dst, cell_index) in out.iter_mut().zip(children) {
+                *dst = cell_index.into();
+            }
+        });
+        Ok(())
+    }
+
+    if numCompacted == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    inner(compactedSet, numCompacted, outSet, numOut, res)
+        .err()
+        .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
 /// uncompactCellsSize takes a compacted set of hexagons and provides
 /// the exact size of the uncompacted set of hexagons.
 ///
@@ -137,3 +706,295 @@ pub unsafe extern "C" fn uncompactCellsSize(
     }
     delegate_inner!(inner(compactedSet, numCompacted, res), out)
 }
+
+/// compactCellsUnion computes the union of two compacted sets of cells, at any
+/// resolution, without uncompacting them.
+///
+/// The inputs don't have to be sorted, H3_NULL entries are ignored, and so are
+/// the cells already covered by another cell of the same set. The output is
+/// compacted, in hierarchical order (see h3SortCellsByLocality), and holds at
+/// most `numA + numB` cells.
+///
+/// @param compactedA First set of cells
+/// @param numA       The number of cells of the first set
+/// @param compactedB Second set of cells
+/// @param numB       The number of cells of the second set
+/// @param outSet     Output array for the compacted union (preallocated)
+/// @param numOut     The size of the output array to bound check against
+/// @param out        The number of cells of the union
+/// @return E_CELL_INVALID if an input cell is invalid, E_MEMORY_BOUNDS if the
+/// output array is too small.
+///
+/// # Safety
+///
+/// `compactedA` and `compactedB` must points to arrays of at least `numA` and
+/// `numB` elements. `outSet` must points to an array of at least `numOut`
+/// elements.
+#[no_mangle]
+pub unsafe extern "C" fn compactCellsUnion(
+    compactedA: *const H3Index,
+    numA: i64,
+    compactedB: *const H3Index,
+    numB: i64,
+    outSet: *mut H3Index,
+    numOut: i64,
+    out: Option<&mut i64>,
+) -> H3Error {
+    fn union(a: &[u64], b: &[u64], out: &mut Vec<CellIndex>) {
+        let mut end = None;
+        let (mut i, mut j) = (0, 0);
+        while i < a.len() || j < b.len() {
+            let cell = if j == b.len()
+                || (i < a.len() && sort::locality_cmp(a[i], b[j]).is_le())
+            {
+                i += 1;
+                a[i - 1]
+            } else {
+                j += 1;
+                b[j - 1]
+            };
+            // Cells come before their descendants, which are skipped.
+            let range = Range::from(cell);
+            if end.is_some_and(|end| range.start <= end) {
+                continue;
+            }
+            end = Some(range.end);
+            push_compacted(out, cell);
+        }
+    }
+
+    delegate_inner!(
+        set_operation(
+            compactedA, numA, compactedB, numB, outSet, numOut, union
+        ),
+        out
+    )
+}
+
+/// compactCellsIntersection computes the intersection of two compacted sets of
+/// cells, at any resolution, without uncompacting them.
+///
+/// The inputs are handled as in compactCellsUnion. The output is compacted, in
+/// hierarchical order, and holds at most `numA + numB` cells.
+///
+/// @param compactedA First set of cells
+/// @param numA       The number of cells of the first set
+/// @param compactedB Second set of cells
+/// @param numB       The number of cells of the second set
+/// @param outSet     Output array for the compacted intersection (preallocated)
+/// @param numOut     The size of the output array to bound check against
+/// @param out        The number of cells of the intersection
+/// @return E_CELL_INVALID if an input cell is invalid, E_MEMORY_BOUNDS if the
+/// output array is too small.
+///
+/// # Safety
+///
+/// `compactedA` and `compactedB` must points to arrays of at least `numA` and
+/// `numB` elements. `outSet` must points to an array of at least `numOut`
+/// elements.
+#[no_mangle]
+pub unsafe extern "C" fn compactCellsIntersection(
+    compactedA: *const H3Index,
+    numA: i64,
+    compactedB: *const H3Index,
+    numB: i64,
+    outSet: *mut H3Index,
+    numOut: i64,
+    out: Option<&mut i64>,
+) -> H3Error {
+    fn intersection(a: &[u64], b: &[u64], out: &mut Vec<CellIndex>) {
+        let (mut i, mut j) = (0, 0);
+        while i < a.len() && j < b.len() {
+            let (range_a, range_b) = (Range::from(a[i]), Range::from(b[j]));
+            // Cells either are disjoint or one contains the other, in which
+            // case the smallest one is in the intersection.
+            if range_a.end < range_b.start {
+                i += 1;
+            } else if range_b.end < range_a.start {
+                j += 1;
+            } else if range_a.start <= range_b.start
+                && range_b.end <= range_a.end
+            {
+                push_compacted(out, b[j]);
+                j += 1;
+            } else {
+                push_compacted(out, a[i]);
+                i += 1;
+            }
+        }
+    }
+
+    delegate_inner!(
+        set_operation(
+            compactedA,
+            numA,
+            compactedB,
+            numB,
+            outSet,
+            numOut,
+            intersection
+        ),
+        out
+    )
+}
+
+/// compactCellsDifference computes the cells of a compacted set not covered by
+/// another one (A \ B), at any resolution, without uncompacting them.
+///
+/// The inputs are handled as in compactCellsUnion. The cells of A partially
+/// covered by B are split into the siblings of the covered descendants, so
+/// every cell of B within a cell of A adds up to 6 cells per resolution
+/// between them: the output holds at most `numA + 90 * numB` cells. The output
+/// is compacted, in hierarchical order.
+///
+/// @param compactedA Set of cells to subtract from
+/// @param numA       The number of cells of the first set
+/// @param compactedB Set of cells to subtract
+/// @param numB       The number of cells of the second set
+/// @param outSet     Output array for the compacted difference (preallocated)
+/// @param numOut     The size of the output array to bound check against
+/// @param out        The number of cells of the difference
+/// @return E_CELL_INVALID if an input cell is invalid, E_MEMORY_BOUNDS if the
+/// output array is too small.
+///
+/// # Safety
+///
+/// `compactedA` and `compactedB` must points to arrays of at least `numA` and
+/// `numB` elements. `outSet` must points to an array of at least `numOut`
+/// elements.
+#[no_mangle]
+pub unsafe extern "C" fn compactCellsDifference(
+    compactedA: *const H3Index,
+    numA: i64,
+    compactedB: *const H3Index,
+    numB: i64,
+    outSet: *mut H3Index,
+    numOut: i64,
+    out: Option<&mut i64>,
+) -> H3Error {
+    /// Pushes the descendants of `cell` not covered by `holes`, the cells
+    /// overlapping it (sorted).
+    fn subtract(cell: u64, holes: &[u64], out: &mut Vec<CellIndex>) {
+        let Some(&hole) = holes.first() else {
+            push_compacted(out, cell);
+            return;
+        };
+        let (range, hole) = (Range::from(cell), Range::from(hole));
+        if hole.start <= range.start && range.end <= hole.end {
+            return;
+        }
+
+        // The holes are strict descendants: split the cell into its children.
+        let resolution = (cell >> 52) & 0xf;
+        let shift = 3 * (14 - resolution);
+        let child_base = (cell & !(0xf << 52) & !(0b111 << shift))
+            | ((resolution + 1) << 52);
+        let mut holes = holes;
+        for digit in 0..7 {
+            let child = child_base | (digit << shift);
+            // Skips the deleted subsequence of the pentagons.
+            if !cell::is_valid_cell_bits(child) {
+                continue;
+            }
+            let end = Range::from(child).end;
+            let count =
+                holes.partition_point(|&hole| Range::from(hole).start <= end);
+            subtract(child, &holes[..count], out);
+            holes = &holes[count..];
+        }
+    }
+
+    fn difference(a: &[u64], b: &[u64], out: &mut Vec<CellIndex>) {
+        let mut j = 0;
+        for &cell in a {
+            let range = Range::from(cell);
+            j += b[j..]
+                .partition_point(|&hole| Range::from(hole).end < range.start);
+            let count = b[j..]
+                .partition_point(|&hole| Range::from(hole).start <= range.end);
+            subtract(cell, &b[j..j + count], out);
+            // Keep a hole covering the cell, as it may cover the next ones.
+            j += b[j..j + count]
+                .partition_point(|&hole| Range::from(hole).end <= range.end);
+        }
+    }
+
+    delegate_inner!(
+        set_operation(
+            compactedA, numA, compactedB, numB, outSet, numOut, difference
+        ),
+        out
+    )
+}
+
+/// Runs a set operation on two compacted sets in hierarchical order, and
+/// writes its (compacted) result.
+unsafe fn set_operation(
+    compactedA: *const H3Index,
+    numA: i64,
+    compactedB: *const H3Index,
+    numB: i64,
+    outSet: *mut H3Index,
+    numOut: i64,
+    operation: fn(&[u64], &[u64], &mut Vec<CellIndex>),
+) -> Result<i64, H3Error> {
+    let a = hierarchical_set(compactedA, numA)?;
+    let b = hierarchical_set(compactedB, numB)?;
+    let mut cells = Vec::with_capacity(a.len() + b.len());
+    operation(&a, &b, &mut cells);
+
+    let len = usize::try_from(numOut).map_err(|_| H3ErrorCodes::EDomain)?;
+    if cells.len() > len {
+        return Err(H3ErrorCodes::EMemoryBounds.into());
+    }
+    if !cells.is_empty() {
+        let out = std::slice::from_raw_parts_mut(outSet, cells.len());
+        for (dst, &cell) in out.iter_mut().zip(&cells) {
+            *dst = cell.into();
+        }
+    }
+    Ok(i64::try_from(cells.len()).expect("set too large"))
+}
+
+/// Returns the cells of a compacted set in hierarchical order, without the
+/// H3_NULL entries and the cells covered by another one.
+unsafe fn hierarchical_set(
+    cells: *const H3Index,
+    numCells: i64,
+) -> Result<Vec<u64>, H3Error> {
+    let len = usize::try_from(numCells).map_err(|_| H3ErrorCodes::EDomain)?;
+    if len == 0 {
+        return Ok(Vec::new());
+    }
+    let mut cells = std::slice::from_raw_parts(cells, len)
+        .iter()
+        .copied()
+        .filter(|&cell| cell != H3_NULL)
+        .collect::<Vec<_>>();
+    if !cells.iter().all(|&cell| cell::is_valid_cell_bits(cell)) {
+        return Err(H3ErrorCodes::ECellInvalid.into());
+    }
+
+    sort::sort_by_locality(&mut cells);
+    // Cells come before their descendants.
+    let mut end = None;
+    cells.retain(|&cell| {
+        let range = Range::from(cell);
+        if end.is_some_and(|end| range.start <= end) {
+            return false;
+        }
+        end = Some(range.end);
+        true
+    });
+    Ok(cells)
+}
+
+/// Appends a cell to a compacted set in hierarchical order, merging the
+/// complete sibling groups it ends.
+fn push_compacted(cells: &mut Vec<CellIndex>, cell: u64) {
+    cells.push(CellIndex::try_from(cell).expect("valid cell"));
+    while let Some((parent, count)) = complete_parent(cells) {
+        cells.truncate(cells.len() - count);
+        cells.push(parent);
+    }
+}
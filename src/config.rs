@@ -0,0 +1,240 @@
+//! Process-wide settings of the library.
+
+use crate::{H3Error, H3ErrorCodes};
+use std::{
+    ffi::{c_int, c_void},
+    sync::{
+        atomic::{AtomicBool, AtomicU32, AtomicU64, AtomicUsize, Ordering},
+        Mutex,
+    },
+};
+
+/// Whether the array inputs are trusted (i.e. not validated).
+static TRUSTED_INPUT: AtomicBool = AtomicBool::new(false);
+
+/// Number of entries of every per-thread cache (0 when disabled).
+static CACHE_CAPACITY: AtomicUsize = AtomicUsize::new(0);
+
+/// Number of times the cache capacity was set, for the per-thread caches to
+/// notice they must be emptied.
+static CACHE_GENERATION: AtomicU64 = AtomicU64::new(0);
+
+/// Number of workers of the parallel functions (0 for one per CPU).
+static THREAD_COUNT: AtomicUsize = AtomicUsize::new(0);
+
+/// Whether the entry points record their statistics.
+static STATS_ENABLED: AtomicBool = AtomicBool::new(false);
+
+/// Whether the large library-owned buffers ask for huge pages.
+static HUGE_PAGES: AtomicBool = AtomicBool::new(false);
+
+/// Instruction sets the kernels may be dispatched to (see `cpu`).
+static CPU_FEATURES: AtomicU32 = AtomicU32::new(u32::MAX);
+
+/// Executor provided by the user, if any.
+static EXECUTOR: Mutex<Option<Executor>> = Mutex::new(None);
+
+/// A task handed over to an executor: `task(arg)` runs one worker of a
+/// parallel job.
+pub type H3Task = unsafe extern "C" fn(arg: *mut c_void);
+
+/// An executor, running `count` times `task(arg)` concurrently.
+///
+/// `context` is the pointer given to h3SetExecutor. The executor must only
+/// return once every run of the task has completed.
+pub type H3Executor = unsafe extern "C" fn(
+    task: H3Task,
+    arg: *mut c_void,
+    count: i64,
+    context: *mut c_void,
+);
+
+/// An executor along with its context.
+#[derive(Clone, Copy)]
+pub struct Executor {
+    /// Function dispatching the tasks.
+    pub function: H3Executor,
+    /// User-provided context of the executor.
+    pub context: *mut c_void,
+}
+
+// SAFETY: the context is only handed back to the executor, which must be
+// callable from any thread (as documented by `h3SetExecutor`).
+unsafe impl Send for Executor {}
+
+/// h3SetTrustedInput enables (or disables) the trusted input mode.
+///
+/// In trusted mode, the array-based functions (compactCells, uncompactCells,
+/// uncompactCellsSize, cellsToLinkedMultiPolygon, gridDisksUnsafe, ...) skip
+/// the validation of every index before processing them.
+///
+/// The mode is disabled by default.
+///
+/// @param trusted Non-zero to enable the trusted mode, zero to disable it.
+///
+/// # Safety
+///
+/// Once enabled, every index given to those functions must be valid: the
+/// behavior is undefined otherwise.
+#[no_mangle]
+pub unsafe extern "C" fn h3SetTrustedInput(trusted: c_int) {
+    TRUSTED_INPUT.store(trusted != 0, Ordering::Relaxed);
+}
+
+/// Returns true if the array inputs don't need to be validated.
+pub fn trusted_input() -> bool {
+    TRUSTED_INPUT.load(Ordering::Relaxed)
+}
+
+/// h3SetCacheCapacity enables (or disables) the caching of the results of
+/// cellToBoundary and cellToLatLng.
+///
+/// Every thread gets its own caches (so that threads never contend on them),
+/// each holding up to `capacity` cells and evicting the least recently used
+/// ones (approximately).
+///
+/// Every call empties the caches, whatever the capacity (including 0): each
+/// thread drops its entries on its next lookup, so a thread that never looks a
+/// cell up again keeps its entries until it exits.
+///
+/// The caches are disabled by default.
+///
+/// @param capacity Number of cells per cache and per thread, 0 to disable the
+///                 caches.
+/// @return E_DOMAIN if the capacity is negative, E_SUCCESS otherwise.
+#[no_mangle]
+pub extern "C" fn h3SetCacheCapacity(capacity: i64) -> H3Error {
+    let Ok(capacity) = usize::try_from(capacity) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    CACHE_CAPACITY.store(capacity, Ordering::Relaxed);
+    // Published after the capacity, so that the new generation comes with it.
+    CACHE_GENERATION.fetch_add(1, Ordering::Release);
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Returns the capacity of the per-thread caches (0 when disabled) and the
+/// number of times it was set.
+pub fn cache_settings() -> (usize, u64) {
+    let generation = CACHE_GENERATION.load(Ordering::Acquire);
+    (CACHE_CAPACITY.load(Ordering::Relaxed), generation)
+}
+
+/// h3SetStatsEnabled enables (or disables) the recording of the call
+/// statistics of the main entry points (see h3GetStats).
+///
+/// Recording is disabled by default, in which case an instrumented function
+/// only pays for checking this flag.
+///
+/// @param enabled Non-zero to enable the recording, zero to disable it.
+#[no_mangle]
+pub extern "C" fn h3SetStatsEnabled(enabled: c_int) {
+    STATS_ENABLED.store(enabled != 0, Ordering::Relaxed);
+}
+
+/// Returns true if the entry points record their statistics.
+pub fn stats_enabled() -> bool {
+    STATS_ENABLED.load(Ordering::Relaxed)
+}
+
+/// h3SetHugePages enables (or disables) huge pages for the large buffers
+/// owned by the library: the ranges of the cell sets built by createCellSet,
+/// and the files mapped by openMappedCellSet.
+///
+/// Buffers of a few megabytes or more are then moved to anonymous mappings
+/// advised for transparent huge pages (files are advised directly), which
+/// cuts the TLB misses of the queries over large sets. This is a hint, only
+/// honored on Linux when transparent huge pages are available.
+///
+/// Huge pages are disabled by default. Only the sets created afterwards are
+/// affected.
+///
+/// @param enabled Non-zero to enable huge pages, zero to disable them.
+#[no_mangle]
+pub extern "C" fn h3SetHugePages(enabled: c_int) {
+    HUGE_PAGES.store(enabled != 0, Ordering::Relaxed);
+}
+
+/// Returns true if the large library-owned buffers ask for huge pages.
+pub fn huge_pages() -> bool {
+    HUGE_PAGES.load(Ordering::Relaxed)
+}
+
+/// h3SetCpuFeatures restricts the instruction sets the batch kernels
+/// (areValidCells, cellsToParents, ...) may use.
+///
+/// Those kernels are compiled for several instruction sets, and the best one
+/// supported by the CPU is selected at runtime (see h3GetCpuFeatures). This
+/// allows to limit the selection, e.g. to compare the versions.
+///
+/// Every instruction set is allowed by default.
+///
+/// @param features Allowed instruction sets (combination of H3_CPU_* flags), 0
+///                 for the baseline of the target only.
+#[no_mangle]
+pub extern "C" fn h3SetCpuFeatures(features: u32) {
+    CPU_FEATURES.store(features, Ordering::Relaxed);
+}
+
+/// Returns the instruction sets the kernels may be dispatched to.
+pub fn cpu_features() -> u32 {
+    CPU_FEATURES.load(Ordering::Relaxed)
+}
+
+/// h3SetThreadPool sets the number of threads used by the parallel functions
+/// (polygonToCellsParallel, uncompactCellsParallel, gridDisksParallel,
+/// cellsToLinkedMultiPolygonParallel, ...).
+///
+/// Unless an executor is set with h3SetExecutor, parallel jobs run on a
+/// library-owned pool of `numThreads - 1` threads, the calling thread taking
+/// part in every job. The pool is created on first use, and recreated when the
+/// number of threads changes.
+///
+/// With 1 thread, the library runs in serial mode: every function runs on the
+/// calling thread only, even when an executor is set.
+///
+/// @param numThreads Number of threads, 0 for one per CPU (the default).
+/// @return E_DOMAIN if the number of threads is negative, E_SUCCESS otherwise.
+#[no_mangle]
+pub extern "C" fn h3SetThreadPool(numThreads: c_int) -> H3Error {
+    let Ok(count) = usize::try_from(numThreads) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    THREAD_COUNT.store(count, Ordering::Relaxed);
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Returns the configured number of threads (0 for one per CPU).
+pub fn thread_count() -> usize {
+    THREAD_COUNT.load(Ordering::Relaxed)
+}
+
+/// h3SetExecutor dispatches the parallel jobs to an executor owned by the
+/// caller instead of the library-owned thread pool.
+///
+/// Every parallel job calls the executor once, asking it to run the same
+/// task `count` times concurrently (`count` being at most the number of
+/// threads set with h3SetThreadPool); the executor must only return once every
+/// run has completed. Runs pull chunks of work from a shared queue, so they
+/// don't have to start at the same time, or even run concurrently.
+///
+/// @param executor The executor, or NULL to use the library-owned pool again.
+/// @param context  Pointer given back to every call of the executor.
+///
+/// # Safety
+///
+/// The executor must be callable from any thread, and run every task it's
+/// given before returning.
+#[no_mangle]
+pub unsafe extern "C" fn h3SetExecutor(
+    executor: Option<H3Executor>,
+    context: *mut c_void,
+) {
+    *EXECUTOR.lock().expect("poisoned executor") =
+        executor.map(|function| Executor { function, context });
+}
+
+/// Returns the executor provided by the user, if any.
+pub fn executor() -> Option<Executor> {
+    *EXECUTOR.lock().expect("poisoned executor")
+}
@@ -1,5 +1,5 @@
-use crate::{H3Error, H3ErrorCodes, H3Index};
-use h3o::{CellIndex, Resolution};
+use crate::{cell, config, H3Error, H3ErrorCodes, H3Index};
+use h3o::{geom::ContainmentMode, CellIndex, Resolution};
 use std::ffi::c_int;
 
 pub fn h3res_to_resolution(res: c_int) -> Result<Resolution, H3ErrorCodes> {
@@ -7,8 +7,26 @@ pub fn h3res_to_resolution(res: c_int) -> Result<Resolution, H3ErrorCodes> {
     res.try_into().map_err(|_| H3ErrorCodes::EResDomain)
 }
 
+/// Converts polygon filling flags into a containment mode.
+///
+/// Only the `ContainmentMode` values are accepted, the bounding box overlap
+/// mode of H3 (3) isn't supported.
+pub const fn h3flags_to_containment_mode(
+    flags: u32,
+) -> Result<ContainmentMode, H3ErrorCodes> {
+    match flags {
+        0 => Ok(ContainmentMode::ContainsCentroid),
+        1 => Ok(ContainmentMode::ContainsBoundary),
+        2 => Ok(ContainmentMode::IntersectsBoundary),
+        _ => Err(H3ErrorCodes::EOptionInvalid),
+    }
+}
+
 /// Cast a C-array (ptr + len) of `H3Index` into a slice of `CellIndex`.
 ///
+/// Indexes are validated (with the vectorized kernel of `areValidCells`),
+/// unless the trusted input mode is enabled.
+///
 /// # Safety
 ///
 /// `ptr` must points to an array of at least `len` elements.
@@ -19,10 +37,8 @@ pub unsafe fn h3ptr_to_h3oslice<'a>(
     let len = usize::try_from(len).expect("H3Index array too large");
     let indexes = std::slice::from_raw_parts(ptr, len);
 
-    if !indexes
-        .iter()
-        .all(|&index| CellIndex::try_from(index).is_ok())
-    {
+    // Trusted inputs are known valid, no need to check them.
+    if !config::trusted_input() && !cell::all_valid_cells(indexes) {
         return Err(H3ErrorCodes::ECellInvalid.into());
     }
 
@@ -33,20 +49,21 @@ pub unsafe fn h3ptr_to_h3oslice<'a>(
 
 /// Cast a C-array (ptr + len) of `H3Index` into a slice of `CellIndex`.
 ///
+/// Indexes are validated (with the vectorized kernel of `areValidCells`),
+/// unless the trusted input mode is enabled.
+///
 /// # Safety
 ///
 /// `ptr` must points to an array of at least `len` elements.
 pub unsafe fn h3ptr_to_h3oslice_mut<'a>(
     ptr: *mut H3Index,
-    len: c_int,
+    len: i64,
 ) -> Result<&'a mut [CellIndex], H3Error> {
     let len = usize::try_from(len).expect("H3Index array too large");
     let indexes = std::slice::from_raw_parts_mut(ptr, len);
 
-    if !indexes
-        .iter()
-        .all(|&index| CellIndex::try_from(index).is_ok())
-    {
+    // Trusted inputs are known valid, no need to check them.
+    if !config::trusted_input() && !cell::all_valid_cells(indexes) {
         return Err(H3ErrorCodes::ECellInvalid.into());
     }
 
@@ -0,0 +1,107 @@
+//! Runtime CPU feature dispatch of the batch kernels.
+//!
+//! The library is built for the baseline of its target (SSE2 on x86-64), so
+//! the kernels written to be vectorized (branchless loops over the bits of the
+//! indexes) are compiled a second time for AVX2 and AVX-512, the widest
+//! instruction set supported by the CPU being selected once per batch.
+//!
+//! On aarch64, NEON is part of the baseline: the kernels are always vectorized
+//! with it, and there is nothing to dispatch.
+
+use crate::config;
+
+/// AVX2 (along with BMI1, BMI2, LZCNT and POPCNT), on x86-64.
+pub const H3_CPU_AVX2: u32 = 1;
+
+/// AVX-512 (F, CD, BW, DQ and VL), on x86-64.
+pub const H3_CPU_AVX512: u32 = 2;
+
+/// Returns the instruction sets supported by the CPU.
+fn detected() -> u32 {
+    #[cfg(target_arch = "x86_64")]
+    {
+        let mut features = 0;
+        if is_x86_feature_detected!("avx2")
+            && is_x86_feature_detected!("bmi1")
+            && is_x86_feature_detected!("bmi2")
+            && is_x86_feature_detected!("lzcnt")
+            && is_x86_feature_detected!("popcnt")
+        {
+            features |= H3_CPU_AVX2;
+        }
+        if features & H3_CPU_AVX2 != 0
+            && is_x86_feature_detected!("avx512f")
+            && is_x86_feature_detected!("avx512cd")
+            && is_x86_feature_detected!("avx512bw")
+            && is_x86_feature_detected!("avx512dq")
+            && is_x86_feature_detected!("avx512vl")
+        {
+            features |= H3_CPU_AVX512;
+        }
+        features
+    }
+    #[cfg(not(target_arch = "x86_64"))]
+    {
+        0
+    }
+}
+
+/// Returns the instruction sets used by the kernels.
+fn enabled() -> u32 {
+    detected() & config::cpu_features()
+}
+
+/// A batch kernel, compiled once per instruction set.
+///
+/// `run` must be `#[inline(always)]` (as well as the helpers it calls), so
+/// that it's compiled as part of the function enabling each instruction set
+/// instead of being called from it with the baseline code.
+pub trait Kernel {
+    /// Result of the kernel.
+    type Output;
+
+    /// Runs the kernel.
+    fn run(self) -> Self::Output;
+}
+
+/// Runs a kernel compiled for the widest instruction set enabled.
+pub fn dispatch<K: Kernel>(kernel: K) -> K::Output {
+    #[cfg(target_arch = "x86_64")]
+    {
+        let features = enabled();
+        if features & H3_CPU_AVX512 != 0 {
+            // SAFETY: the CPU supports AVX-512.
+            return unsafe { avx512(kernel) };
+        }
+        if features & H3_CPU_AVX2 != 0 {
+            // SAFETY: the CPU supports AVX2.
+            return unsafe { avx2(kernel) };
+        }
+    }
+    kernel.run()
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(enable = "avx2,bmi1,bmi2,lzcnt,popcnt")]
+unsafe fn avx2<K: Kernel>(kernel: K) -> K::Output {
+    kernel.run()
+}
+
+#[cfg(target_arch = "x86_64")]
+#[target_feature(
+    enable = "avx2,bmi1,bmi2,lzcnt,popcnt,avx512f,avx512cd,avx512bw,avx512dq,avx512vl"
+)]
+unsafe fn avx512<K: Kernel>(kernel: K) -> K::Output {
+    kernel.run()
+}
+
+// -----------------------------------------------------------------------------
+
+/// h3GetCpuFeatures returns the instruction sets used by the batch kernels:
+/// the ones supported by the CPU, and allowed by h3SetCpuFeatures.
+///
+/// @return A combination of H3_CPU_* flags (0 for the baseline of the target).
+#[no_mangle]
+pub extern "C" fn h3GetCpuFeatures() -> u32 {
+    enabled()
+}
@@ -1,4 +1,7 @@
-use crate::{delegate_inner, CellBoundary, H3Error, H3ErrorCodes, H3Index};
+use crate::{
+    cell, delegate_inner, CellBoundary, H3Error, H3ErrorCodes, H3Index, LatLng,
+    H3_NULL,
+};
 use h3o::{CellIndex, DirectedEdgeIndex};
 use std::ffi::c_int;
 
@@ -28,6 +31,149 @@ pub extern "C" fn areNeighborCells(
     delegate_inner!(inner(origin, destination), out)
 }
 
+/// Batch version of areNeighborCells, for many origin/destination pairs at
+/// once (e.g. the consecutive cells of a trajectory, as `cells` and
+/// `cells + 1`, in which case every cell is validated once).
+///
+/// A failing pair (invalid cell, or cells of different resolutions) doesn't
+/// stop the batch: it's reported as not neighbors, its error is reported at
+/// the same offset in `errs` and the first one is returned once every pair
+/// has been processed.
+///
+/// @param origins      The origin H3 indexes.
+/// @param destinations The destination H3 indexes.
+/// @param numPairs     The number of pairs.
+/// @param out          Set to 1 for every pair of neighbors, 0 otherwise.
+/// @param errs         NULL or the per-pair error codes.
+/// @return E_SUCCESS on success, the error of the first failing pair
+///         (E_CELL_INVALID or E_RES_MISMATCH) otherwise.
+///
+/// # Safety
+///
+/// `origins`, `destinations`, `out` and `errs` (if not NULL) must points to
+/// an array of at least `numPairs` elements.
+#[no_mangle]
+pub unsafe extern "C" fn areNeighborCellPairs(
+    origins: *const H3Index,
+    destinations: *const H3Index,
+    numPairs: i64,
+    out: *mut u8,
+    errs: *mut H3Error,
+) -> H3Error {
+    map_cell_pairs(origins, destinations, numPairs, out, errs, 0, |edge| {
+        u8::from(edge.is_some())
+    })
+}
+
+/// Batch version of cellsToDirectedEdge, for many origin/destination pairs at
+/// once (e.g. the consecutive cells of a trajectory, as `cells` and
+/// `cells + 1`, in which case every cell is validated once).
+///
+/// Pairs that aren't neighbors (including a cell paired with itself) get
+/// H3_NULL, which isn't an error. A failing pair (invalid cell, or cells of
+/// different resolutions) doesn't stop the batch either: its edge is set to
+/// H3_NULL, its error is reported at the same offset in `errs` and the first
+/// one is returned once every pair has been processed.
+///
+/// @param origins      The origin H3 indexes.
+/// @param destinations The destination H3 indexes.
+/// @param numPairs     The number of pairs.
+/// @param out          The directed edges, one per pair.
+/// @param errs         NULL or the per-pair error codes.
+/// @return E_SUCCESS on success, the error of the first failing pair
+///         (E_CELL_INVALID or E_RES_MISMATCH) otherwise.
+///
+/// # Safety
+///
+/// `origins`, `destinations`, `out` and `errs` (if not NULL) must points to
+/// an array of at least `numPairs` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellPairsToDirectedEdges(
+    origins: *const H3Index,
+    destinations: *const H3Index,
+    numPairs: i64,
+    out: *mut H3Index,
+    errs: *mut H3Error,
+) -> H3Error {
+    map_cell_pairs(
+        origins,
+        destinations,
+        numPairs,
+        out,
+        errs,
+        H3_NULL,
+        |edge| edge.map_or(H3_NULL, Into::into),
+    )
+}
+
+/// Shared implementation of the pair batches: maps the edge between every
+/// pair of valid cells (if any) to an output value, and failing pairs to
+/// `invalid`.
+unsafe fn map_cell_pairs<T: Copy>(
+    origins: *const H3Index,
+    destinations: *const H3Index,
+    numPairs: i64,
+    out: *mut T,
+    errs: *mut H3Error,
+    invalid: T,
+    f: impl Fn(Option<DirectedEdgeIndex>) -> T,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numPairs) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    // Trajectories pass their cells twice: every destination is the origin of
+    // the next pair, and is only validated once.
+    let trajectory = std::ptr::eq(destinations, origins.wrapping_add(1));
+    let origins = std::slice::from_raw_parts(origins, len);
+    let destinations = std::slice::from_raw_parts(destinations, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
+    let mut errs = (!errs.is_null())
+        .then(|| std::slice::from_raw_parts_mut(errs, len).iter_mut());
+
+    let mut first_err = None;
+    let mut previous = None;
+    for ((dst, &origin), &destination) in
+        out.iter_mut().zip(origins).zip(destinations)
+    {
+        let origin =
+            previous.unwrap_or_else(|| CellIndex::try_from(origin).ok());
+        let destination = CellIndex::try_from(destination).ok();
+        if trajectory {
+            previous = Some(destination);
+        }
+        let result: Result<T, H3Error> = match (origin, destination) {
+            (Some(origin), Some(destination))
+                if origin.resolution() != destination.resolution() =>
+            {
+                Err(H3ErrorCodes::EResMismatch.into())
+            }
+            (Some(origin), Some(destination)) => {
+                Ok(f(origin.edge(destination)))
+            }
+            _ => Err(H3ErrorCodes::ECellInvalid.into()),
+        };
+        let err = match result {
+            Ok(value) => {
+                *dst = value;
+                H3ErrorCodes::ESuccess.into()
+            }
+            Err(err) => {
+                *dst = invalid;
+                first_err.get_or_insert(err);
+                err
+            }
+        };
+        if let Some(slot) = errs.as_mut().and_then(Iterator::next) {
+            *slot = err;
+        }
+    }
+
+    first_err.unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
 /// Returns a directed edge H3 index based on the provided origin and
 /// destination
 ///
@@ -74,6 +220,52 @@ pub extern "C" fn directedEdgeToBoundary(
     delegate_inner!(inner(edge), gb)
 }
 
+/// Determines the boundaries of an array of directed edges, packed into a
+/// single vertex buffer (no padding).
+///
+/// The vertices of `edges[i]` are stored in `verts[offsets[i]..offsets[i+1]]`,
+/// in the order of directedEdgeToBoundary. Invalid indexes get an empty vertex
+/// range.
+///
+/// Edges have 2 or 3 vertices, so `3 * numEdges` is always enough to hold the
+/// vertices.
+///
+/// @param edges    The directed edge H3 indexes.
+/// @param numEdges Number of indexes in `edges`.
+/// @param verts    Output vertex buffer.
+/// @param maxVerts Size of the vertex buffer, to bound check against.
+/// @param offsets  Output offsets, `numEdges + 1` elements.
+/// @return E_SUCCESS on success, E_MEMORY_BOUNDS if the vertex buffer is too
+///         small or E_DIR_EDGE_INVALID if at least one index was invalid.
+///
+/// # Safety
+///
+/// - `edges` must points to an array of at least `numEdges` elements.
+/// - `verts` must points to an array of at least `maxVerts` elements.
+/// - `offsets` must points to an array of at least `numEdges + 1` elements.
+#[no_mangle]
+pub unsafe extern "C" fn directedEdgesToBoundaries(
+    edges: *const H3Index,
+    numEdges: i64,
+    verts: *mut LatLng,
+    maxVerts: i64,
+    offsets: *mut i64,
+) -> H3Error {
+    cell::write_boundaries(
+        edges,
+        numEdges,
+        verts,
+        maxVerts,
+        offsets,
+        |edge| {
+            DirectedEdgeIndex::try_from(edge)
+                .ok()
+                .map(DirectedEdgeIndex::boundary)
+        },
+        H3ErrorCodes::EDirEdgeInvalid,
+    )
+}
+
 /// Returns the origin, destination pair of hexagon IDs for the given edge ID
 ///
 /// @param edge The directed edge H3Index
@@ -106,6 +298,106 @@ pub unsafe extern "C" fn directedEdgeToCells(
     }
 }
 
+/// Batch version of edgeLengthKm.
+///
+/// Lengths of invalid indexes are set to NaN and the batch carries on.
+///
+/// @param edges    The H3 directed edges.
+/// @param numEdges Number of edges in `edges`.
+/// @param out      Output lengths, in kilometers.
+/// @return E_SUCCESS on success, E_DIR_EDGE_INVALID if at least one edge was
+///         invalid.
+///
+/// # Safety
+///
+/// `edges` and `out` must points to an array of at least `numEdges` elements.
+#[no_mangle]
+pub unsafe extern "C" fn edgesLengthKm(
+    edges: *const H3Index,
+    numEdges: i64,
+    out: *mut f64,
+) -> H3Error {
+    edges_length(edges, numEdges, out, DirectedEdgeIndex::length_km)
+}
+
+/// Batch version of edgeLengthM.
+///
+/// Lengths of invalid indexes are set to NaN and the batch carries on.
+///
+/// @param edges    The H3 directed edges.
+/// @param numEdges Number of edges in `edges`.
+/// @param out      Output lengths, in meters.
+/// @return E_SUCCESS on success, E_DIR_EDGE_INVALID if at least one edge was
+///         invalid.
+///
+/// # Safety
+///
+/// `edges` and `out` must points to an array of at least `numEdges` elements.
+#[no_mangle]
+pub unsafe extern "C" fn edgesLengthM(
+    edges: *const H3Index,
+    numEdges: i64,
+    out: *mut f64,
+) -> H3Error {
+    edges_length(edges, numEdges, out, DirectedEdgeIndex::length_m)
+}
+
+/// Batch version of edgeLengthRads.
+///
+/// Lengths of invalid indexes are set to NaN and the batch carries on.
+///
+/// @param edges    The H3 directed edges.
+/// @param numEdges Number of edges in `edges`.
+/// @param out      Output lengths, in radians.
+/// @return E_SUCCESS on success, E_DIR_EDGE_INVALID if at least one edge was
+///         invalid.
+///
+/// # Safety
+///
+/// `edges` and `out` must points to an array of at least `numEdges` elements.
+#[no_mangle]
+pub unsafe extern "C" fn edgesLengthRads(
+    edges: *const H3Index,
+    numEdges: i64,
+    out: *mut f64,
+) -> H3Error {
+    edges_length(edges, numEdges, out, DirectedEdgeIndex::length_rads)
+}
+
+/// Computes the length of every edge, using the given unit.
+unsafe fn edges_length(
+    edges: *const H3Index,
+    numEdges: i64,
+    out: *mut f64,
+    length: fn(DirectedEdgeIndex) -> f64,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numEdges) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let edges = std::slice::from_raw_parts(edges, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    let mut valid = true;
+    for (dst, &edge) in out.iter_mut().zip(edges) {
+        *dst = DirectedEdgeIndex::try_from(edge).map_or_else(
+            |_| {
+                valid = false;
+                f64::NAN
+            },
+            length,
+        );
+    }
+
+    if valid {
+        H3ErrorCodes::ESuccess.into()
+    } else {
+        H3ErrorCodes::EDirEdgeInvalid.into()
+    }
+}
+
 /// Length of a directed edge in kilometers.
 #[no_mangle]
 pub extern "C" fn edgeLengthKm(
@@ -194,6 +486,53 @@ pub extern "C" fn isValidDirectedEdge(edge: H3Index) -> c_int {
     DirectedEdgeIndex::try_from(edge).is_ok().into()
 }
 
+/// Batch version of isValidDirectedEdge.
+///
+/// @param edges    The H3 indexes to validate.
+/// @param numEdges The number of indexes.
+/// @param out      Set to 1 for every valid directed edge, 0 otherwise.
+///
+/// # Safety
+///
+/// `edges` and `out` must points to an array of at least `numEdges` elements.
+#[no_mangle]
+pub unsafe extern "C" fn areValidDirectedEdges(
+    edges: *const H3Index,
+    numEdges: i64,
+    out: *mut u8,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numEdges) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let edges = std::slice::from_raw_parts(edges, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    for (dst, &edge) in out.iter_mut().zip(edges) {
+        *dst = is_valid_edge_bits(edge).into();
+    }
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Branchless version of `DirectedEdgeIndex::try_from(index).is_ok()`.
+const fn is_valid_edge_bits(index: u64) -> bool {
+    // Directed edge mode (2) and a direction between 1 and 6.
+    let mode = (index >> 59) & 0xf == 2;
+    let direction = (index >> 56) & 0b111;
+    // The origin is the same index, in cell mode and without direction.
+    let origin = (index & !(0xff << 56)) | (1 << 59);
+
+    // Pentagons have no edge in the K axis (deleted subsequence).
+    let deleted = direction == 1 && cell::is_pentagon_bits(origin);
+
+    mode && direction != 0
+        && direction != 7
+        && cell::is_valid_cell_bits(origin)
+        && !deleted
+}
+
 /// Returns the 6 (or 5 for pentagons) edges associated with the H3Index.
 ///
 /// # Safety
@@ -224,3 +563,58 @@ pub unsafe extern "C" fn originToDirectedEdges(
         Err(err) => err,
     }
 }
+
+/// Batch version of originToDirectedEdges.
+///
+/// The edges of `cells[i]` are stored in `out[6 * i..6 * (i + 1)]`, ordered by
+/// direction. Pentagons have no edge in the K axis (the first slot), and
+/// invalid indexes have no edge at all: missing edges are set to H3_NULL and
+/// the batch carries on.
+///
+/// @param cells    The origin H3 indexes.
+/// @param numCells Number of indexes in `cells`.
+/// @param out      Output edges, 6 per cell.
+/// @return E_SUCCESS on success, E_CELL_INVALID if at least one index was
+///         invalid.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements, and `out`
+/// to an array of at least `6 * numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn originsToDirectedEdges(
+    cells: *const H3Index,
+    numCells: i64,
+    out: *mut H3Index,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let cells = std::slice::from_raw_parts(cells, len);
+    let out = std::slice::from_raw_parts_mut(out, 6 * len);
+
+    let mut valid = true;
+    for (edges, &cell) in out.chunks_exact_mut(6).zip(cells) {
+        let is_valid = cell::is_valid_cell_bits(cell);
+        let pentagon = cell::is_pentagon_bits(cell);
+        // Same index, in directed edge mode.
+        let origin = (cell & !(0xff << 56)) | (2 << 59);
+        for (direction, edge) in (1..=6).zip(edges) {
+            *edge = if is_valid && !(pentagon && direction == 1) {
+                origin | (direction << 56)
+            } else {
+                H3_NULL
+            };
+        }
+        valid &= is_valid;
+    }
+
+    if valid {
+        H3ErrorCodes::ESuccess.into()
+    } else {
+        H3ErrorCodes::ECellInvalid.into()
+    }
+}
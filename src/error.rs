@@ -140,4 +140,6 @@ pub enum H3ErrorCodes {
     EMemoryBounds = 14,
     // Mode or flags argument was not valid.
     EOptionInvalid = 15,
+    // The operation was cancelled, or ran out of time, before completion.
+    ECancelled = 16,
 }
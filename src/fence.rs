@@ -0,0 +1,220 @@
+//! Point-in-coverage lookups against many (compacted) cell sets.
+
+use crate::{delegate_inner, H3Error, H3ErrorCodes, H3Index, LatLng, H3_NULL};
+use h3o::{CellIndex, Resolution};
+use std::{collections::HashMap, ops::Range};
+
+/// An index of fences, each covered by a set of cells at any resolution.
+pub struct H3FenceIndex {
+    /// Range of `ids` holding the fences of every cell.
+    cells: HashMap<CellIndex, Range<usize>>,
+    /// IDs of the fences, grouped per cell.
+    ids: Vec<i64>,
+    /// Resolutions holding at least one cell, from the finest.
+    resolutions: Vec<Resolution>,
+}
+
+impl H3FenceIndex {
+    /// Builds the index from the `(cell, fence ID)` pairs.
+    fn new(mut pairs: Vec<(CellIndex, i64)>) -> Self {
+        pairs.sort_unstable();
+        pairs.dedup();
+
+        let mut cells = HashMap::<CellIndex, Range<usize>>::new();
+        let mut ids = Vec::with_capacity(pairs.len());
+        let mut resolutions = Vec::new();
+        for (i, (cell, id)) in pairs.into_iter().enumerate() {
+            // Pairs are sorted, so the fences of a cell are contiguous.
+            cells.entry(cell).or_insert(i..i).end += 1;
+            ids.push(id);
+            resolutions.push(cell.resolution());
+        }
+        resolutions.sort_unstable_by(|a, b| b.cmp(a));
+        resolutions.dedup();
+
+        Self {
+            cells,
+            ids,
+            resolutions,
+        }
+    }
+
+    /// Appends the IDs of the fences containing the point to `out`.
+    ///
+    /// The point is converted once, at the finest resolution of the index,
+    /// then its ancestors are looked up at every other resolution.
+    fn fences(&self, point: LatLng, out: &mut Vec<i64>) -> Result<(), H3Error> {
+        let ll = h3o::LatLng::try_from(point)?;
+        let Some(&finest) = self.resolutions.first() else {
+            return Ok(());
+        };
+        let cell = ll.to_cell(finest);
+        let start = out.len();
+        for &resolution in &self.resolutions {
+            let ancestor = cell.parent(resolution).expect("coarser resolution");
+            if let Some(range) = self.cells.get(&ancestor) {
+                out.extend_from_slice(&self.ids[range.clone()]);
+            }
+        }
+        // A fence may hold both a cell and its ancestor if not compacted.
+        out[start..].sort_unstable();
+        let mut len = start;
+        for i in start..out.len() {
+            if len == start || out[len - 1] != out[i] {
+                out[len] = out[i];
+                len += 1;
+            }
+        }
+        out.truncate(len);
+
+        Ok(())
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/// createFenceIndex builds an index of fences, to find the fences containing
+/// a batch of points with latLngsToFenceIds.
+///
+/// Every fence is covered by a set of cells (compacted or not, H3_NULL entries
+/// are ignored): the cells of the i-th fence are stored in
+/// `cells[offsets[i]..offsets[i + 1]]`, and its ID is `ids[i]`.
+///
+/// It is the responsibility of the caller to call destroyFenceIndex on the
+/// index, or its memory will not be freed.
+///
+/// @param cells     The cells of every fence, one after the other
+/// @param offsets   The offsets of the fences in `cells`, of size
+///                  `numFences + 1`
+/// @param ids       The IDs of the fences
+/// @param numFences The number of fences
+/// @param out       The created index
+/// @return E_CELL_INVALID if any cell is invalid, E_DOMAIN if the offsets
+/// aren't sorted, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// - `offsets` must points to an array of at least `numFences + 1` elements.
+/// - `ids` must points to an array of at least `numFences` elements.
+/// - `cells` must points to an array of at least `offsets[numFences]`
+///   elements.
+#[no_mangle]
+pub unsafe extern "C" fn createFenceIndex(
+    cells: *const H3Index,
+    offsets: *const i64,
+    ids: *const i64,
+    numFences: i64,
+    out: Option<&mut *mut H3FenceIndex>,
+) -> H3Error {
+    unsafe fn inner(
+        cells: *const H3Index,
+        offsets: *const i64,
+        ids: *const i64,
+        numFences: i64,
+    ) -> Result<*mut H3FenceIndex, H3Error> {
+        let len =
+            usize::try_from(numFences).map_err(|_| H3ErrorCodes::EDomain)?;
+        let mut pairs = Vec::new();
+        if len != 0 {
+            let offsets = std::slice::from_raw_parts(offsets, len + 1);
+            let ids = std::slice::from_raw_parts(ids, len);
+            for (bounds, &id) in offsets.windows(2).zip(ids) {
+                let start = usize::try_from(bounds[0])
+                    .map_err(|_| H3ErrorCodes::EDomain)?;
+                let end = usize::try_from(bounds[1])
+                    .map_err(|_| H3ErrorCodes::EDomain)?;
+                if end < start {
+                    return Err(H3ErrorCodes::EDomain.into());
+                }
+                let fence = std::slice::from_raw_parts(
+                    cells.wrapping_add(start),
+                    end - start,
+                );
+                for &cell in fence.iter().filter(|&&cell| cell != H3_NULL) {
+                    pairs.push((CellIndex::try_from(cell)?, id));
+                }
+            }
+        }
+        Ok(Box::into_raw(Box::new(H3FenceIndex::new(pairs))))
+    }
+
+    delegate_inner!(inner(cells, offsets, ids, numFences), out)
+}
+
+/// latLngsToFenceIds finds the fences containing every point of a batch.
+///
+/// The IDs of the fences containing the i-th point are stored, sorted and
+/// without duplicates, in `out[offsets[i]..offsets[i + 1]]`. Invalid points
+/// get an empty range, and the error of the first of them is returned once
+/// every point has been processed.
+///
+/// If `out` is too small, E_MEMORY_BOUNDS is returned but `offsets` is still
+/// filled, so that `offsets[numPoints]` gives the required size.
+///
+/// @param index     The index created by createFenceIndex
+/// @param points    The points to look up
+/// @param numPoints The number of points
+/// @param out       Output array
+/// @param maxOut    Size of the output array
+/// @param offsets   Output offsets, of size `numPoints + 1`
+/// @return 0 on success, or another value on failure.
+///
+/// # Safety
+///
+/// - `points` must points to an array of at least `numPoints` elements.
+/// - `out` must points to an array of at least `maxOut` elements.
+/// - `offsets` must points to an array of at least `numPoints + 1` elements.
+#[no_mangle]
+pub unsafe extern "C" fn latLngsToFenceIds(
+    index: Option<&H3FenceIndex>,
+    points: *const LatLng,
+    numPoints: i64,
+    out: *mut i64,
+    maxOut: i64,
+    offsets: *mut i64,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numPoints) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let Ok(capacity) = usize::try_from(maxOut) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let offsets = std::slice::from_raw_parts_mut(offsets, len + 1);
+    offsets[0] = 0;
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let index = index.expect("null pointer");
+    let points = std::slice::from_raw_parts(points, len);
+
+    let mut ids = Vec::new();
+    let mut error = None;
+    for (offset, &point) in offsets[1..].iter_mut().zip(points) {
+        if let Err(err) = index.fences(point, &mut ids) {
+            error = error.or(Some(err));
+        }
+        *offset = i64::try_from(ids.len()).expect("too many fences");
+    }
+    if ids.len() > capacity {
+        return H3ErrorCodes::EMemoryBounds.into();
+    }
+    if !ids.is_empty() {
+        std::slice::from_raw_parts_mut(out, ids.len()).copy_from_slice(&ids);
+    }
+
+    error.unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// Free all allocated memory for a fence index.
+///
+/// @param index The index to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`createFenceIndex`]
+#[no_mangle]
+pub unsafe extern "C" fn destroyFenceIndex(index: *mut H3FenceIndex) {
+    if !index.is_null() {
+        drop(Box::from_raw(index));
+    }
+}
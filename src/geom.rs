@@ -1,7 +1,24 @@
-use crate::{convert, delegate_inner, H3Error, H3ErrorCodes, H3Index, LatLng};
+use crate::{
+    cancel::Checkpoint,
+    convert, delegate_inner, outline, parallel,
+    polyfill::{self, H3PolygonCursor, H3PreparedPolygon},
+    sort, stats,
+    visit::{H3CellVisitor, Visit},
+    H3CancelToken, H3Error, H3ErrorCodes, H3Index, H3Workspace, LatLng,
+};
 use geo_types::{Coord, LineString, MultiPolygon, Polygon};
-use h3o::geom::{PolyfillConfig, Polygon as h3oPolygon, ToCells, ToGeo};
-use std::{ffi::c_int, ptr};
+use h3o::{
+    geom::{
+        ContainmentMode as h3oContainmentMode, PolyfillConfig,
+        Polygon as h3oPolygon, ToCells, ToGeo,
+    },
+    CellIndex,
+};
+use std::{
+    alloc::{self, Layout},
+    ffi::{c_int, c_void},
+    ptr,
+};
 
 /// Create a LinkedGeoPolygon describing the outline(s) of a set of  hexagons.
 /// Polygon outlines will follow GeoJSON MultiPolygon order: Each polygon will
@@ -36,104 +53,1026 @@ pub unsafe extern "C" fn cellsToLinkedMultiPolygon(
         let indexes = convert::h3ptr_to_h3oslice(h3Set, numHexes.into())?;
         Ok(indexes.iter().copied().to_geom(false)?.into())
     }
+
+    let _scope = stats::Scope::new(
+        stats::Function::CellsToLinkedMultiPolygon,
+        numHexes.into(),
+    );
     if numHexes == 0 {
-        *out.expect("null pointer") = LinkedGeoPolygon {
-            first: ptr::null_mut(),
-            last: ptr::null_mut(),
-            next: ptr::null_mut(),
+        *out.expect("null pointer") = LinkedGeoPolygon::empty();
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    match inner(h3Set, numHexes) {
+        Ok(polygon) => {
+            *out.expect("null pointer") = polygon;
+            H3ErrorCodes::ESuccess.into()
+        }
+        Err(err) => err,
+    }
+}
+
+/// cellsToLinkedMultiPolygonParallel is a multi-threaded version of
+/// cellsToLinkedMultiPolygon, meant for very large sets.
+///
+/// The outline edges (between a cell of the set and a cell outside of it) are
+/// extracted concurrently from chunks of the set, then stitched along the
+/// seams through their vertexes, which are shared exactly by neighboring
+/// cells. The result describes the same outline as the serial version, in an
+/// order that doesn't depend on the partitioning.
+///
+/// It is expected that all hexagons in the set have the same resolution,
+/// duplicates are ignored.
+///
+/// @param h3Set    Set of hexagons
+/// @param numHexes Number of hexagons in set
+/// @param out      Output polygon
+///
+/// # Safety
+///
+/// `h3Set` must points to an array of at least `numHexes` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToLinkedMultiPolygonParallel(
+    h3Set: *const H3Index,
+    numHexes: c_int,
+    out: Option<&mut LinkedGeoPolygon>,
+) -> H3Error {
+    unsafe fn inner(
+        h3Set: *const H3Index,
+        numHexes: c_int,
+    ) -> Result<LinkedGeoPolygon, H3Error> {
+        let indexes = convert::h3ptr_to_h3oslice(h3Set, numHexes.into())?;
+        Ok(outline::from_cells(indexes, None)?.to_linked_polygon())
+    }
+
+    let _scope = stats::Scope::new(
+        stats::Function::CellsToLinkedMultiPolygonParallel,
+        numHexes.into(),
+    );
+    if numHexes == 0 {
+        *out.expect("null pointer") = LinkedGeoPolygon::empty();
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    match inner(h3Set, numHexes) {
+        Ok(polygon) => {
+            *out.expect("null pointer") = polygon;
+            H3ErrorCodes::ESuccess.into()
+        }
+        Err(err) => err,
+    }
+}
+
+/// Cancellable version of cellsToLinkedMultiPolygonParallel: the extraction
+/// of the outline and the assembly of its rings stop shortly after `token` is
+/// cancelled or runs out of time.
+///
+/// A partial outline doesn't describe anything, so a cancelled call leaves
+/// `out` untouched.
+///
+/// @param h3Set    Set of hexagons
+/// @param numHexes Number of hexagons in set
+/// @param token    The cancellation token (NULL never cancels)
+/// @param out      Output polygon
+/// @return E_CANCELLED if cancelled, E_SUCCESS on success.
+///
+/// # Safety
+///
+/// `h3Set` must points to an array of at least `numHexes` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToLinkedMultiPolygonCancellable(
+    h3Set: *const H3Index,
+    numHexes: c_int,
+    token: Option<&H3CancelToken>,
+    out: Option<&mut LinkedGeoPolygon>,
+) -> H3Error {
+    unsafe fn inner(
+        h3Set: *const H3Index,
+        numHexes: c_int,
+        token: Option<&H3CancelToken>,
+    ) -> Result<LinkedGeoPolygon, H3Error> {
+        let indexes = convert::h3ptr_to_h3oslice(h3Set, numHexes.into())?;
+        outline::from_cells(indexes, token)?.to_linked_polygon_until(token)
+    }
+
+    let _scope = stats::Scope::new(
+        stats::Function::CellsToLinkedMultiPolygonCancellable,
+        numHexes.into(),
+    );
+    if numHexes == 0 {
+        *out.expect("null pointer") = LinkedGeoPolygon::empty();
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    match inner(h3Set, numHexes, token) {
+        Ok(polygon) => {
+            *out.expect("null pointer") = polygon;
+            H3ErrorCodes::ESuccess.into()
+        }
+        Err(err) => err,
+    }
+}
+
+/// compactedCellsToLinkedMultiPolygon creates a LinkedGeoPolygon describing
+/// the outline(s) of a compacted set of cells, i.e. the outline of the set
+/// uncompacted at its finest resolution.
+///
+/// The cells don't have to be uncompacted first: only the descendants close to
+/// the boundary of the set are considered, so the cost scales with the
+/// perimeter of the set rather than its uncompacted size.
+///
+/// Duplicated and overlapping cells are ignored.
+///
+/// @param cells    Set of cells, at any resolution
+/// @param numCells Number of cells in set
+/// @param out      Output polygon
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn compactedCellsToLinkedMultiPolygon(
+    cells: *const H3Index,
+    numCells: i64,
+    out: Option<&mut LinkedGeoPolygon>,
+) -> H3Error {
+    unsafe fn inner(
+        cells: *const H3Index,
+        numCells: i64,
+    ) -> Result<LinkedGeoPolygon, H3Error> {
+        if numCells < 0 {
+            return Err(H3ErrorCodes::EDomain.into());
+        }
+        if numCells == 0 {
+            return Ok(LinkedGeoPolygon::empty());
+        }
+        let indexes = convert::h3ptr_to_h3oslice(cells, numCells)?;
+        Ok(outline::from_compacted(indexes).to_linked_polygon())
+    }
+
+    match inner(cells, numCells) {
+        Ok(polygon) => {
+            *out.expect("null pointer") = polygon;
+            H3ErrorCodes::ESuccess.into()
+        }
+        Err(err) => err,
+    }
+}
+
+/// Free all allocated memory for a linked geo structure. The caller is
+/// responsible for freeing memory allocated to input polygon struct.
+///
+/// @param polygon Pointer to the first polygon in the structure
+///
+/// # Safety
+///
+/// The pointer must comes from [`cellsToLinkedMultiPolygon`]
+#[no_mangle]
+pub unsafe extern "C" fn destroyLinkedMultiPolygon(
+    polygon: Option<&mut LinkedGeoPolygon>,
+) {
+    if let Some(polygon) = polygon {
+        // Empty structures have no backing allocation.
+        if !polygon.first.is_null() {
+            LinkedArena::free(polygon.first);
+        }
+    }
+}
+
+/// Create a FlatMultiPolygon describing the outline(s) of a set of hexagons.
+///
+/// Same as cellsToLinkedMultiPolygon, but the output is stored in contiguous
+/// arrays (vertices, ring offsets and polygon offsets) instead of linked
+/// lists.
+///
+/// It is the responsibility of the caller to call destroyFlatMultiPolygon on
+/// the populated structure, or its memory will not be freed.
+///
+/// @param h3Set    Set of hexagons
+/// @param numHexes Number of hexagons in set
+/// @param out      Output polygon
+///
+/// # Safety
+///
+/// `h3Set` must points to an array of at least `numHexes` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToFlatMultiPolygon(
+    h3Set: *const H3Index,
+    numHexes: i64,
+    out: Option<&mut FlatMultiPolygon>,
+) -> H3Error {
+    unsafe fn inner(
+        h3Set: *const H3Index,
+        numHexes: i64,
+    ) -> Result<FlatMultiPolygon, H3Error> {
+        if numHexes == 0 {
+            return Ok(MultiPolygon::new(Vec::new()).into());
+        }
+        let indexes = convert::h3ptr_to_h3oslice(h3Set, numHexes)?;
+        Ok(indexes.iter().copied().to_geom(false)?.into())
+    }
+
+    delegate_inner!(inner(h3Set, numHexes), out)
+}
+
+/// Free all allocated memory for a flat multipolygon, and reset its arrays to
+/// NULL and its counts to 0 (destroying it again is a no-op).
+///
+/// @param polygon The multipolygon to free
+///
+/// # Safety
+///
+/// The multipolygon must comes from [`cellsToFlatMultiPolygon`]
+#[no_mangle]
+pub unsafe extern "C" fn destroyFlatMultiPolygon(
+    polygon: Option<&mut FlatMultiPolygon>,
+) {
+    if let Some(polygon) = polygon {
+        // SAFETY: arrays have been allocated as boxed slices of these lengths
+        // by `cellsToFlatMultiPolygon`, or already freed (and set to NULL).
+        unsafe fn free<T>(ptr: *mut T, len: i64) {
+            if ptr.is_null() {
+                return;
+            }
+            let len = usize::try_from(len).expect("valid length");
+            drop(Box::from_raw(ptr::slice_from_raw_parts_mut(ptr, len)));
+        }
+
+        free(polygon.verts, polygon.numVerts);
+        free(polygon.ringOffsets, polygon.numRings + 1);
+        free(polygon.polygonOffsets, polygon.numPolygons + 1);
+        *polygon = FlatMultiPolygon {
+            numVerts: 0,
+            verts: ptr::null_mut(),
+            numRings: 0,
+            ringOffsets: ptr::null_mut(),
+            numPolygons: 0,
+            polygonOffsets: ptr::null_mut(),
         };
+    }
+}
+
+/// Containment modes of the polygon filling functions, passed as `flags`.
+///
+/// cbindgen:rename-all=ScreamingSnakeCase
+#[repr(u32)]
+#[derive(Debug, Copy, Clone)]
+#[non_exhaustive]
+pub enum ContainmentMode {
+    /// Cell center is contained in the shape.
+    ContainmentCenter = 0,
+    /// Cell is fully contained in the shape.
+    ContainmentFull = 1,
+    /// Cell overlaps the shape at any point.
+    ContainmentOverlapping = 2,
+}
+
+/// maxPolygonToCellsSize returns the number of cells to allocate space for
+/// when performing a polygonToCells on the given GeoJSON-like data structure.
+///
+/// The size is the maximum of either the number of points in the geoloop or the
+/// number of cells in the bounding box of the geoloop.
+///
+/// @param geoPolygon A GeoJSON-like data structure indicating the poly to fill
+/// @param res Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param out number of cells to allocate for
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn maxPolygonToCellsSize(
+    geoPolygon: Option<&GeoPolygon>,
+    res: c_int,
+    flags: u32,
+    out: Option<&mut i64>,
+) -> H3Error {
+    fn inner(
+        geoPolygon: &GeoPolygon,
+        res: c_int,
+        flags: u32,
+    ) -> Result<i64, H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
+        // Empty polygon contains no cell.
+        if geoPolygon.geoloop.numVerts == 0 {
+            return Ok(0);
+        }
+
+        let resolution = convert::h3res_to_resolution(res)?;
+        let polygon = Polygon::try_from(*geoPolygon)?;
+        let polygon = h3oPolygon::from_radians(polygon)?;
+
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
+
+        Ok(polygon
+            .max_cells_count(config)
+            .try_into()
+            .expect("too many cells"))
+    }
+
+    geoPolygon.map_or_else(
+        || H3ErrorCodes::EFailed.into(),
+        |geoPolygon| delegate_inner!(inner(geoPolygon, res, flags), out),
+    )
+}
+
+/// polygonToCells takes a given GeoJSON-like data structure and preallocated,
+/// zeroed memory, and fills it with the hexagons that are contained by
+/// the GeoJSON-like data structure.
+///
+/// This implementation traces the GeoJSON geoloop(s) in cartesian space with
+/// hexagons, tests them and their neighbors to be contained by the geoloop(s),
+/// and then any newly found hexagons are used to test again until no new
+/// hexagons are found.
+///
+/// @param geoPolygon The geoloop and holes defining the relevant area
+/// @param res The Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param out The slab of zeroed memory to write to. Assumed to be big enough.
+/// @return E_MEMORY_BOUNDS if the cells don't fit in maxPolygonToCellsSize
+/// elements, E_SUCCESS on success.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `maxPolygonToCellsSize` elements
+/// (or the size given by `maxPolygonToCellsSizeTight` or
+/// `polygonToCellsExactSize`).
+#[no_mangle]
+pub unsafe extern "C" fn polygonToCells(
+    geoPolygon: Option<&GeoPolygon>,
+    res: c_int,
+    flags: u32,
+    out: *mut H3Index,
+) -> H3Error {
+    unsafe fn inner(
+        geoPolygon: &GeoPolygon,
+        res: c_int,
+        flags: u32,
+        out: *mut H3Index,
+    ) -> Result<(), H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
+        let resolution = convert::h3res_to_resolution(res)?;
+
+        // Empty polygon contains no cell.
+        if geoPolygon.geoloop.numVerts == 0 {
+            return Ok(());
+        }
+
+        let polygon = Polygon::try_from(*geoPolygon)?;
+        let polygon = h3oPolygon::from_radians(polygon)?;
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
+        let len = polygon.max_cells_count(config);
+        write_cells(out, len, polygon.to_cells(config))?;
+        Ok(())
+    }
+
+    let _scope = stats::Scope::new(
+        stats::Function::PolygonToCells,
+        geoPolygon.map_or(0, |polygon| polygon.geoloop.numVerts.into()),
+    );
+    geoPolygon.map_or_else(
+        || H3ErrorCodes::EFailed.into(),
+        |geoPolygon| {
+            inner(geoPolygon, res, flags, out)
+                .err()
+                .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+        },
+    )
+}
+
+/// Same as polygonToCells, except that the cells are written in ascending
+/// order (see h3SortCells), without duplicates, at the start of `out`.
+///
+/// The cells are sorted on the thread pool once the fill is complete, which
+/// saves the caller a sorting pass before merging with other sorted sets.
+///
+/// @param geoPolygon The geoloop and holes defining the relevant area
+/// @param res The Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param out The slab of memory to write to. Assumed to be big enough.
+/// @param numOut Number of cells written
+/// @return E_MEMORY_BOUNDS if the cells don't fit in maxPolygonToCellsSize
+/// elements, E_SUCCESS on success.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `maxPolygonToCellsSize` elements
+/// (or the size given by `maxPolygonToCellsSizeTight` or
+/// `polygonToCellsExactSize`).
+#[no_mangle]
+pub unsafe extern "C" fn polygonToCellsSorted(
+    geoPolygon: Option<&GeoPolygon>,
+    res: c_int,
+    flags: u32,
+    out: *mut H3Index,
+    numOut: Option<&mut i64>,
+) -> H3Error {
+    unsafe fn inner(
+        geoPolygon: &GeoPolygon,
+        res: c_int,
+        flags: u32,
+        out: *mut H3Index,
+    ) -> Result<i64, H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
+        let resolution = convert::h3res_to_resolution(res)?;
+
+        // Empty polygon contains no cell.
+        if geoPolygon.geoloop.numVerts == 0 {
+            return Ok(0);
+        }
+
+        let polygon = Polygon::try_from(*geoPolygon)?;
+        let polygon = h3oPolygon::from_radians(polygon)?;
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
+        let len = polygon.max_cells_count(config);
+        let count = write_cells(out, len, polygon.to_cells(config))?;
+        if count == 0 {
+            return Ok(0);
+        }
+        let cells = std::slice::from_raw_parts_mut(out, count);
+        let count = sort::sort_dedup(cells, true);
+        Ok(i64::try_from(count).expect("too many cells"))
+    }
+
+    let _scope = stats::Scope::new(
+        stats::Function::PolygonToCellsSorted,
+        geoPolygon.map_or(0, |polygon| polygon.geoloop.numVerts.into()),
+    );
+    geoPolygon.map_or_else(
+        || H3ErrorCodes::EFailed.into(),
+        |geoPolygon| {
+            delegate_inner!(inner(geoPolygon, res, flags, out), numOut)
+        },
+    )
+}
+
+/// Cancellable version of polygonToCells: the fill stops shortly after
+/// `token` is cancelled or runs out of time.
+///
+/// The cells found until then are kept in `out`: `numOut` is set to the
+/// number of cells written, whether the call completed or not.
+///
+/// @param geoPolygon The geoloop and holes defining the relevant area
+/// @param res The Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param token The cancellation token (NULL never cancels)
+/// @param out The slab of zeroed memory to write to. Assumed to be big enough.
+/// @param numOut Number of cells written
+/// @return E_CANCELLED if cancelled (with partial output), E_MEMORY_BOUNDS if
+/// the cells don't fit in maxPolygonToCellsSize elements, E_SUCCESS on
+/// success.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `maxPolygonToCellsSize` elements
+/// (or the size given by `maxPolygonToCellsSizeTight` or
+/// `polygonToCellsExactSize`).
+#[no_mangle]
+pub unsafe extern "C" fn polygonToCellsCancellable(
+    geoPolygon: Option<&GeoPolygon>,
+    res: c_int,
+    flags: u32,
+    token: Option<&H3CancelToken>,
+    out: *mut H3Index,
+    numOut: Option<&mut i64>,
+) -> H3Error {
+    unsafe fn inner(
+        geoPolygon: &GeoPolygon,
+        res: c_int,
+        flags: u32,
+        token: Option<&H3CancelToken>,
+        out: *mut H3Index,
+        count: &mut usize,
+    ) -> Result<(), H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
+        let resolution = convert::h3res_to_resolution(res)?;
+
+        // Empty polygon contains no cell.
+        if geoPolygon.geoloop.numVerts == 0 {
+            return Ok(());
+        }
+
+        let polygon = Polygon::try_from(*geoPolygon)?;
+        let polygon = h3oPolygon::from_radians(polygon)?;
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
+        let len = polygon.max_cells_count(config);
+        let mut checkpoint = Checkpoint::new(token);
+        checkpoint.step()?;
+        for cell_index in polygon.to_cells(config) {
+            if *count == len {
+                return Err(H3ErrorCodes::EMemoryBounds.into());
+            }
+            out.add(*count).write(cell_index.into());
+            *count += 1;
+            checkpoint.step()?;
+        }
+        Ok(())
+    }
+
+    let _scope = stats::Scope::new(
+        stats::Function::PolygonToCellsCancellable,
+        geoPolygon.map_or(0, |polygon| polygon.geoloop.numVerts.into()),
+    );
+    let Some(geoPolygon) = geoPolygon else {
+        return H3ErrorCodes::EFailed.into();
+    };
+    let mut count = 0;
+    let result = inner(geoPolygon, res, flags, token, out, &mut count);
+    *numOut.expect("null pointer") =
+        i64::try_from(count).expect("too many cells");
+    result
+        .err()
+        .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// polygonToCellsForEach visits the cells contained by a GeoJSON-like data
+/// structure.
+///
+/// Same as polygonToCells, except that the cells are handed over to `visitor`
+/// by batches (of at most H3_VISIT_BATCH_SIZE cells) instead of being written
+/// into an output array of maxPolygonToCellsSize elements.
+///
+/// @param geoPolygon The geoloop and holes defining the relevant area
+/// @param res The Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param visitor Callback receiving the batches of cells
+/// @param context Pointer passed to every call of `visitor`
+/// @return 0 (E_SUCCESS) on success, including when stopped by `visitor`.
+///
+/// # Safety
+///
+/// `visitor` must be callable with `context`.
+#[no_mangle]
+pub unsafe extern "C" fn polygonToCellsForEach(
+    geoPolygon: Option<&GeoPolygon>,
+    res: c_int,
+    flags: u32,
+    visitor: Option<H3CellVisitor>,
+    context: *mut c_void,
+) -> H3Error {
+    fn inner(
+        geoPolygon: &GeoPolygon,
+        res: c_int,
+        flags: u32,
+        visit: &mut Visit,
+    ) -> Result<(), H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
+        let resolution = convert::h3res_to_resolution(res)?;
+
+        // Empty polygon contains no cell.
+        if geoPolygon.geoloop.numVerts == 0 {
+            return Ok(());
+        }
+
+        let polygon = Polygon::try_from(*geoPolygon)?;
+        let polygon = h3oPolygon::from_radians(polygon)?;
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
+        visit.extend(polygon.to_cells(config));
+        Ok(())
+    }
+
+    let _scope = stats::Scope::new(
+        stats::Function::PolygonToCellsForEach,
+        geoPolygon.map_or(0, |polygon| polygon.geoloop.numVerts.into()),
+    );
+    let (Some(geoPolygon), Some(visitor)) = (geoPolygon, visitor) else {
+        return H3ErrorCodes::EFailed.into();
+    };
+    let mut visit = Visit::new(visitor, context);
+    if let Err(err) = inner(geoPolygon, res, flags, &mut visit) {
+        return err;
+    }
+    visit.finish();
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Same as maxPolygonToCellsSize, reusing the buffers of a workspace for the
+/// conversion of the polygon.
+///
+/// @param workspace Workspace created by createWorkspace
+/// @param geoPolygon A GeoJSON-like data structure indicating the poly to fill
+/// @param res Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param out number of cells to allocate for
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn maxPolygonToCellsSizeWs(
+    workspace: Option<&mut H3Workspace>,
+    geoPolygon: Option<&GeoPolygon>,
+    res: c_int,
+    flags: u32,
+    out: Option<&mut i64>,
+) -> H3Error {
+    fn inner(
+        workspace: &mut H3Workspace,
+        geoPolygon: &GeoPolygon,
+        res: c_int,
+        flags: u32,
+    ) -> Result<i64, H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
+        // Empty polygon contains no cell.
+        if geoPolygon.geoloop.numVerts == 0 {
+            return Ok(0);
+        }
+
+        let resolution = convert::h3res_to_resolution(res)?;
+        let polygon = workspace.polygon(*geoPolygon)?;
+        let polygon = h3oPolygon::from_radians(polygon)?;
+
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
+        let count = polygon.max_cells_count(config);
+        workspace.recycle(polygon.into());
+
+        Ok(count.try_into().expect("too many cells"))
+    }
+
+    match (workspace, geoPolygon) {
+        (Some(workspace), Some(geoPolygon)) => {
+            delegate_inner!(inner(workspace, geoPolygon, res, flags), out)
+        }
+        _ => H3ErrorCodes::EFailed.into(),
+    }
+}
+
+/// Same as polygonToCells, reusing the buffers of a workspace for the
+/// conversion of the polygon.
+///
+/// @param workspace Workspace created by createWorkspace
+/// @param geoPolygon The geoloop and holes defining the relevant area
+/// @param res The Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param out The slab of zeroed memory to write to. Assumed to be big enough.
+/// @return E_MEMORY_BOUNDS if the cells don't fit in maxPolygonToCellsSize
+/// elements, E_SUCCESS on success.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `maxPolygonToCellsSize` elements
+/// (or the size given by `maxPolygonToCellsSizeTight` or
+/// `polygonToCellsExactSize`).
+#[no_mangle]
+pub unsafe extern "C" fn polygonToCellsWs(
+    workspace: Option<&mut H3Workspace>,
+    geoPolygon: Option<&GeoPolygon>,
+    res: c_int,
+    flags: u32,
+    out: *mut H3Index,
+) -> H3Error {
+    unsafe fn inner(
+        workspace: &mut H3Workspace,
+        geoPolygon: &GeoPolygon,
+        res: c_int,
+        flags: u32,
+        out: *mut H3Index,
+    ) -> Result<(), H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
+        let resolution = convert::h3res_to_resolution(res)?;
+
+        // Empty polygon contains no cell.
+        if geoPolygon.geoloop.numVerts == 0 {
+            return Ok(());
+        }
+
+        let polygon = workspace.polygon(*geoPolygon)?;
+        let polygon = h3oPolygon::from_radians(polygon)?;
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
+        let len = polygon.max_cells_count(config);
+        let written = write_cells(out, len, polygon.to_cells(config));
+        workspace.recycle(polygon.into());
+        written.map(|_| ())
+    }
+
+    let _scope = stats::Scope::new(
+        stats::Function::PolygonToCellsWs,
+        geoPolygon.map_or(0, |polygon| polygon.geoloop.numVerts.into()),
+    );
+    match (workspace, geoPolygon) {
+        (Some(workspace), Some(geoPolygon)) => {
+            inner(workspace, geoPolygon, res, flags, out)
+                .err()
+                .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+        }
+        _ => H3ErrorCodes::EFailed.into(),
+    }
+}
+
+/// maxPolygonToCellsSizeTight returns a tighter upper bound than
+/// maxPolygonToCellsSize of the number of cells of a polygonToCells.
+///
+/// Instead of the bounding box of the polygon, the bound is derived from the
+/// cells covering the polygon a couple of resolutions coarser than `res`, so
+/// it stays close to the actual size for thin or diagonal polygons. The
+/// CONTAINMENT_OVERLAPPING mode falls back to maxPolygonToCellsSize.
+///
+/// The cells are classified with the same centroid test as polygonToCells,
+/// and every coarse cell still crossed by the boundary counts for all its
+/// descendants, so the bound holds: an array of this size is enough for the
+/// output of polygonToCells.
+///
+/// @param geoPolygon A GeoJSON-like data structure indicating the poly to fill
+/// @param res Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param out number of cells to allocate for
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn maxPolygonToCellsSizeTight(
+    geoPolygon: Option<&GeoPolygon>,
+    res: c_int,
+    flags: u32,
+    out: Option<&mut i64>,
+) -> H3Error {
+    fn inner(
+        geoPolygon: &GeoPolygon,
+        res: c_int,
+        flags: u32,
+    ) -> Result<i64, H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
+        let resolution = convert::h3res_to_resolution(res)?;
+        // Empty polygon contains no cell.
+        if geoPolygon.geoloop.numVerts == 0 {
+            return Ok(0);
+        }
+
+        let polygon = Polygon::try_from(*geoPolygon)?;
+        let planar = polyfill::PlanarPolygon::new(&polygon);
+        let polygon = h3oPolygon::from_radians(polygon)?;
+        // Fully contained cells are a subset of the centroid ones.
+        let count = if mode == h3oContainmentMode::IntersectsBoundary {
+            let config = PolyfillConfig::new(resolution).containment_mode(mode);
+            polygon
+                .max_cells_count(config)
+                .try_into()
+                .expect("too many cells")
+        } else {
+            let coarse = u8::from(resolution)
+                .saturating_sub(polyfill::ESTIMATE_RES_OFFSET)
+                .try_into()
+                .expect("valid resolution");
+            polyfill::cells_count(&planar, resolution, coarse)
+        };
+
+        Ok(count.try_into().expect("too many cells"))
+    }
+
+    geoPolygon.map_or_else(
+        || H3ErrorCodes::EFailed.into(),
+        |geoPolygon| delegate_inner!(inner(geoPolygon, res, flags), out),
+    )
+}
+
+/// polygonToCellsExactSize returns the exact number of cells of a
+/// polygonToCells, without producing them.
+///
+/// The fill is run and its cells counted, so the size is exact whatever the
+/// containment mode, and an array of this size is enough for polygonToCells.
+///
+/// @param geoPolygon A GeoJSON-like data structure indicating the poly to fill
+/// @param res Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param out number of cells of the fill
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn polygonToCellsExactSize(
+    geoPolygon: Option<&GeoPolygon>,
+    res: c_int,
+    flags: u32,
+    out: Option<&mut i64>,
+) -> H3Error {
+    fn inner(
+        geoPolygon: &GeoPolygon,
+        res: c_int,
+        flags: u32,
+    ) -> Result<i64, H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
+        let resolution = convert::h3res_to_resolution(res)?;
+        // Empty polygon contains no cell.
+        if geoPolygon.geoloop.numVerts == 0 {
+            return Ok(0);
+        }
+
+        let polygon = Polygon::try_from(*geoPolygon)?;
+        let polygon = h3oPolygon::from_radians(polygon)?;
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
+        let count = polygon.to_cells(config).count();
+
+        Ok(count.try_into().expect("too many cells"))
+    }
+
+    geoPolygon.map_or_else(
+        || H3ErrorCodes::EFailed.into(),
+        |geoPolygon| delegate_inner!(inner(geoPolygon, res, flags), out),
+    )
+}
+
+/// preparePolygon converts a polygon once, so that it can be filled any number
+/// of times (at any resolution) without paying for the conversion again.
+///
+/// It is the responsibility of the caller to call destroyPreparedPolygon on
+/// the prepared polygon, or its memory will not be freed.
+///
+/// @param geoPolygon The geoloop and holes defining the relevant area
+/// @param out The prepared polygon
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn preparePolygon(
+    geoPolygon: Option<&GeoPolygon>,
+    out: Option<&mut *mut H3PreparedPolygon>,
+) -> H3Error {
+    fn inner(
+        geoPolygon: &GeoPolygon,
+    ) -> Result<*mut H3PreparedPolygon, H3Error> {
+        let polygon = H3PreparedPolygon::try_from(*geoPolygon)?;
+        Ok(Box::into_raw(Box::new(polygon)))
+    }
+
+    geoPolygon.map_or_else(
+        || H3ErrorCodes::EFailed.into(),
+        |geoPolygon| delegate_inner!(inner(geoPolygon), out),
+    )
+}
+
+/// Same as maxPolygonToCellsSize, for a prepared polygon.
+///
+/// @param polygon The prepared polygon
+/// @param res Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param out number of cells to allocate for
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn maxPreparedPolygonToCellsSize(
+    polygon: Option<&H3PreparedPolygon>,
+    res: c_int,
+    flags: u32,
+    out: Option<&mut i64>,
+) -> H3Error {
+    fn inner(
+        polygon: &H3PreparedPolygon,
+        res: c_int,
+        flags: u32,
+    ) -> Result<i64, H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
+        let resolution = convert::h3res_to_resolution(res)?;
+
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
+
+        Ok(polygon
+            .max_cells_count(config)
+            .try_into()
+            .expect("too many cells"))
+    }
+
+    polygon.map_or_else(
+        || H3ErrorCodes::EFailed.into(),
+        |polygon| delegate_inner!(inner(polygon, res, flags), out),
+    )
+}
+
+/// Same as polygonToCells, for a prepared polygon.
+///
+/// @param polygon The prepared polygon
+/// @param res The Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param out The slab of zeroed memory to write to. Assumed to be big enough.
+/// @return E_MEMORY_BOUNDS if the cells don't fit in
+/// maxPreparedPolygonToCellsSize elements, E_SUCCESS on success.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `maxPreparedPolygonToCellsSize`
+/// elements.
+#[no_mangle]
+pub unsafe extern "C" fn preparedPolygonToCells(
+    polygon: Option<&H3PreparedPolygon>,
+    res: c_int,
+    flags: u32,
+    out: *mut H3Index,
+) -> H3Error {
+    unsafe fn inner(
+        polygon: &H3PreparedPolygon,
+        res: c_int,
+        flags: u32,
+        out: *mut H3Index,
+    ) -> Result<(), H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
+        let resolution = convert::h3res_to_resolution(res)?;
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
+        let len = polygon.max_cells_count(config);
+        write_cells(out, len, polygon.to_cells(config))?;
+        Ok(())
+    }
+
+    polygon.map_or_else(
+        || H3ErrorCodes::EFailed.into(),
+        |polygon| {
+            inner(polygon, res, flags, out)
+                .err()
+                .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+        },
+    )
+}
+
+/// preparedPolygonContains tests a batch of points against a prepared
+/// polygon.
+///
+/// The edges of the polygon are indexed by latitude bands when the polygon is
+/// prepared, so every point is only tested against the few edges overlapping
+/// its latitude. Points on the boundary are either inside or outside.
+///
+/// Invalid (non-finite) points are reported as outside, and
+/// E_LATLNG_DOMAIN is returned once every point has been processed.
+///
+/// @param polygon The prepared polygon
+/// @param points The points to test
+/// @param numPoints The number of points
+/// @param out Output mask, 1 for the points inside the polygon, 0 otherwise
+/// @return 0 (E_SUCCESS) on success.
+///
+/// # Safety
+///
+/// `points` and `out` must points to an array of at least `numPoints`
+/// elements.
+#[no_mangle]
+pub unsafe extern "C" fn preparedPolygonContains(
+    polygon: Option<&H3PreparedPolygon>,
+    points: *const LatLng,
+    numPoints: i64,
+    out: *mut u8,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numPoints) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
         return H3ErrorCodes::ESuccess.into();
     }
+    let polygon = polygon.expect("null pointer");
+    let points = std::slice::from_raw_parts(points, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
 
-    match inner(h3Set, numHexes) {
-        Ok(polygon) => {
-            *out.expect("null pointer") = polygon;
-            H3ErrorCodes::ESuccess.into()
+    let mut valid = true;
+    for (dst, point) in out.iter_mut().zip(points) {
+        if !(point.lat.is_finite() && point.lng.is_finite()) {
+            valid = false;
+            *dst = 0;
+            continue;
         }
-        Err(err) => err,
+        *dst = polygon.contains(point.lat, point.lng).into();
+    }
+
+    if valid {
+        H3ErrorCodes::ESuccess.into()
+    } else {
+        H3ErrorCodes::ELatlngDomain.into()
     }
 }
 
-/// Free all allocated memory for a linked geo structure. The caller is
-/// responsible for freeing memory allocated to input polygon struct.
+/// Free all allocated memory for a prepared polygon.
 ///
-/// @param polygon Pointer to the first polygon in the structure
+/// @param polygon The prepared polygon to free (can be NULL).
 ///
 /// # Safety
 ///
-/// The pointer must comes from [`cellsToLinkedMultiPolygon`]
+/// The pointer must comes from [`preparePolygon`]
 #[no_mangle]
-pub unsafe extern "C" fn destroyLinkedMultiPolygon(
-    polygon: Option<&mut LinkedGeoPolygon>,
+pub unsafe extern "C" fn destroyPreparedPolygon(
+    polygon: *mut H3PreparedPolygon,
 ) {
-    if let Some(polygon) = polygon {
-        let mut curr_polygon = *polygon;
-        // For each polygon.
-        loop {
-            // Free the rings.
-            let mut curr_ring = curr_polygon.first;
-            while !curr_ring.is_null() {
-                let next_ring = (*curr_ring).next;
-
-                // Free the coordinates.
-                let mut curr_coord = (*curr_ring).first;
-                while !curr_coord.is_null() {
-                    let next_coord = (*curr_coord).next;
-                    drop(Box::from_raw(curr_coord));
-                    curr_coord = next_coord;
-                }
-
-                drop(Box::from_raw(curr_ring));
-                curr_ring = next_ring;
-            }
-            // We're done?
-            if curr_polygon.next.is_null() {
-                break;
-            }
-            // Still here? On to the next!
-            curr_polygon = *Box::from_raw(curr_polygon.next);
-        }
+    if !polygon.is_null() {
+        drop(Box::from_raw(polygon));
     }
 }
 
-/// maxPolygonToCellsSize returns the number of cells to allocate space for
-/// when performing a polygonToCells on the given GeoJSON-like data structure.
+/// polygonToCellsInit creates a cursor over the cells of a polygon, which can
+/// then be drained by chunks of bounded size with polygonToCellsNext.
 ///
-/// The size is the maximum of either the number of points in the geoloop or the
-/// number of cells in the bounding box of the geoloop.
+/// This allows to fill a polygon without allocating a buffer of
+/// maxPolygonToCellsSize elements.
 ///
-/// @param geoPolygon A GeoJSON-like data structure indicating the poly to fill
-/// @param res Hexagon resolution (0-15)
-/// @param out number of cells to allocate for
+/// It is the responsibility of the caller to call destroyPolygonCursor on the
+/// cursor, or its memory will not be freed.
+///
+/// @param geoPolygon The geoloop and holes defining the relevant area
+/// @param res The Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param out The created cursor
 /// @return 0 (E_SUCCESS) on success.
 #[no_mangle]
-pub extern "C" fn maxPolygonToCellsSize(
+pub extern "C" fn polygonToCellsInit(
     geoPolygon: Option<&GeoPolygon>,
     res: c_int,
     flags: u32,
-    out: Option<&mut i64>,
+    out: Option<&mut *mut H3PolygonCursor>,
 ) -> H3Error {
     fn inner(
         geoPolygon: &GeoPolygon,
         res: c_int,
         flags: u32,
-    ) -> Result<i64, H3Error> {
-        if flags != 0 {
-            return Err(H3ErrorCodes::EOptionInvalid.into());
-        }
-        // Empty polygon contains no cell.
-        if geoPolygon.geoloop.numVerts == 0 {
-            return Ok(0);
-        }
-
+    ) -> Result<*mut H3PolygonCursor, H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
         let resolution = convert::h3res_to_resolution(res)?;
-        let polygon = Polygon::try_from(*geoPolygon)?;
-        let polygon = h3oPolygon::from_radians(polygon)?;
+        let polygon = H3PreparedPolygon::try_from(*geoPolygon)?;
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
 
-        Ok(polygon
-            .max_cells_count(PolyfillConfig::new(resolution))
-            .try_into()
-            .expect("too many cells"))
+        Ok(Box::into_raw(Box::new(H3PolygonCursor::new(
+            polygon, config,
+        ))))
     }
 
     geoPolygon.map_or_else(
@@ -142,24 +1081,72 @@ pub extern "C" fn maxPolygonToCellsSize(
     )
 }
 
-/// polygonToCells takes a given GeoJSON-like data structure and preallocated,
-/// zeroed memory, and fills it with the hexagons that are contained by
-/// the GeoJSON-like data structure.
+/// polygonToCellsNext writes the next cells of the polygon into `out`.
 ///
-/// This implementation traces the GeoJSON geoloop(s) in cartesian space with
-/// hexagons, tests them and their neighbors to be contained by the geoloop(s),
-/// and then any newly found hexagons are used to test again until no new
-/// hexagons are found.
+/// Once every cell has been produced, `written` is set to 0.
+///
+/// @param cursor The cursor created by polygonToCellsInit
+/// @param out The output buffer
+/// @param capacity The size of the output buffer
+/// @param written The number of cells written into `out`
+/// @return 0 (E_SUCCESS) on success.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `capacity` elements.
+#[no_mangle]
+pub unsafe extern "C" fn polygonToCellsNext(
+    cursor: Option<&mut H3PolygonCursor>,
+    out: *mut H3Index,
+    capacity: i64,
+    written: Option<&mut i64>,
+) -> H3Error {
+    let Ok(capacity) = usize::try_from(capacity) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let count = if capacity == 0 {
+        0
+    } else {
+        let out = std::slice::from_raw_parts_mut(out, capacity);
+        cursor.expect("null pointer").fill(out)
+    };
+    *written.expect("null pointer") = count.try_into().expect("overflow");
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Free all allocated memory for a polygon cursor.
+///
+/// @param cursor The cursor to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`polygonToCellsInit`]
+#[no_mangle]
+pub unsafe extern "C" fn destroyPolygonCursor(cursor: *mut H3PolygonCursor) {
+    if !cursor.is_null() {
+        drop(Box::from_raw(cursor));
+    }
+}
+
+/// polygonToCellsParallel is a multi-threaded version of polygonToCells, meant
+/// for very large polygons.
+///
+/// The extent of the polygon is split into tiles (cells three resolutions
+/// coarser than `res`) which are filled concurrently. Since every cell belongs
+/// to exactly one tile, the result contains no duplicate, and the cells are
+/// selected with the same centroid test, so they're those of polygonToCells
+/// (in another order).
 ///
 /// @param geoPolygon The geoloop and holes defining the relevant area
 /// @param res The Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
 /// @param out The slab of zeroed memory to write to. Assumed to be big enough.
 ///
 /// # Safety
 ///
 /// `out` must points to an array of at least `maxPolygonToCellsSize` elements.
 #[no_mangle]
-pub unsafe extern "C" fn polygonToCells(
+pub unsafe extern "C" fn polygonToCellsParallel(
     geoPolygon: Option<&GeoPolygon>,
     res: c_int,
     flags: u32,
@@ -171,9 +1158,7 @@ pub unsafe extern "C" fn polygonToCells(
         flags: u32,
         out: *mut H3Index,
     ) -> Result<(), H3Error> {
-        if flags != 0 {
-            return Err(H3ErrorCodes::EOptionInvalid.into());
-        }
+        let mode = convert::h3flags_to_containment_mode(flags)?;
         let resolution = convert::h3res_to_resolution(res)?;
 
         // Empty polygon contains no cell.
@@ -182,18 +1167,43 @@ pub unsafe extern "C" fn polygonToCells(
         }
 
         let polygon = Polygon::try_from(*geoPolygon)?;
+        let planar = polyfill::PlanarPolygon::new(&polygon);
         let polygon = h3oPolygon::from_radians(polygon)?;
-        let config = PolyfillConfig::new(resolution);
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
         let len = polygon.max_cells_count(config);
-        let cells = polygon.to_cells(config);
+        // The tiles are filled with the centroid test of the sequential fill,
+        // which handles the other modes.
+        let chunks = if mode == h3oContainmentMode::ContainsCentroid {
+            polyfill::parallel_fill(&polygon, &planar, resolution)
+        } else {
+            vec![polygon.to_cells(config).collect()]
+        };
+        let count = chunks.iter().map(Vec::len).sum::<usize>();
+        if count > len {
+            return Err(H3ErrorCodes::EMemoryBounds.into());
+        }
 
-        let out = std::slice::from_raw_parts_mut(out, len);
-        for (i, cell_index) in cells.enumerate() {
-            out[i] = cell_index.into();
+        // Every chunk is written by a worker, so that the pages of the output
+        // are first touched (and allocated) by the threads writing them.
+        let mut out = std::slice::from_raw_parts_mut(out, count);
+        let mut tasks = Vec::with_capacity(chunks.len());
+        for chunk in &chunks {
+            let (head, tail) = out.split_at_mut(chunk.len());
+            tasks.push((chunk, head));
+            out = tail;
         }
+        parallel::for_each(tasks, |(chunk, out)| {
+            for (dst, &cell_index) in out.iter_mut().zip(chunk) {
+                *dst = cell_index.into();
+            }
+        });
         Ok(())
     }
 
+    let _scope = stats::Scope::new(
+        stats::Function::PolygonToCellsParallel,
+        geoPolygon.map_or(0, |polygon| polygon.geoloop.numVerts.into()),
+    );
     geoPolygon.map_or_else(
         || H3ErrorCodes::EFailed.into(),
         |geoPolygon| {
@@ -268,11 +1278,35 @@ impl TryFrom<GeoPolygon> for Polygon<f64> {
 
 // -----------------------------------------------------------------------------
 
+/// Simplified core of GeoJSON MultiPolygon coordinates definition.
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
 pub struct GeoMultiPolygon {
-    pub num_polygons: c_int,
+    /// Number of elements in the array pointed to by polygons.
+    pub numPolygons: c_int,
+    /// Polygons of the multipolygon.
     pub polygons: *mut GeoPolygon,
 }
 
+impl GeoMultiPolygon {
+    /// Returns the member polygons, each one prepared for filling.
+    fn prepare(self) -> Result<Vec<H3PreparedPolygon>, H3Error> {
+        let len = usize::try_from(self.numPolygons)
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        if len == 0 {
+            return Ok(Vec::new());
+        }
+        // SAFETY: `polygons` must points to an array of at least
+        // `numPolygons` elements.
+        let polygons =
+            unsafe { std::slice::from_raw_parts(self.polygons, len) };
+        polygons
+            .iter()
+            .map(|&polygon| H3PreparedPolygon::try_from(polygon))
+            .collect()
+    }
+}
+
 // -----------------------------------------------------------------------------
 
 /// A coordinate node in a linked geo structure, part of a linked list
@@ -303,84 +1337,486 @@ pub struct LinkedGeoLoop {
     pub next: *mut Self,
 }
 
-impl From<LineString> for LinkedGeoLoop {
-    fn from(mut value: LineString) -> Self {
-        let mut ring = Self {
+// -----------------------------------------------------------------------------
+
+/// A polygon node in a linked geo structure, part of a linked list.
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct LinkedGeoPolygon {
+    pub first: *mut LinkedGeoLoop,
+    pub last: *mut LinkedGeoLoop,
+    pub next: *mut Self,
+}
+
+impl LinkedGeoPolygon {
+    /// Returns an empty polygon, describing an empty outline.
+    #[must_use]
+    pub const fn empty() -> Self {
+        Self {
             first: ptr::null_mut(),
             last: ptr::null_mut(),
             next: ptr::null_mut(),
-        };
+        }
+    }
+}
+
+impl From<MultiPolygon> for LinkedGeoPolygon {
+    fn from(value: MultiPolygon) -> Self {
+        /// Returns the coordinates of every ring of the polygon.
+        fn rings(polygon: &Polygon) -> impl Iterator<Item = &[Coord]> {
+            std::iter::once(polygon.exterior())
+                .chain(polygon.interiors())
+                .map(|ring| {
+                    let coords = ring.0.as_slice();
+                    // Our rings are closed (first point == last point) but
+                    // this isn't the case for H3. So skip the last point.
+                    &coords[..coords.len().saturating_sub(1)]
+                })
+        }
+
+        assert!(!value.0.is_empty(), "empty multipolygon");
+        let loop_count = value.0.iter().flat_map(rings).count();
+        let coord_count = value.0.iter().flat_map(rings).map(<[_]>::len).sum();
+        let arena =
+            LinkedArena::new(value.0.len() - 1, loop_count, coord_count);
 
-        // SAFETY: `last` is always set before being dereferenced.
+        let mut head = None;
+        let (mut loop_id, mut coord_id) = (0, 0);
+        // SAFETY: the arena has been sized for the whole multipolygon, so
+        // every node pointer stays in bounds.
         unsafe {
-            // Our rings are closed (first point == last point) but this isn't
-            // the case for H3. So remove the last point before the conversion.
-            value.0.pop();
-            for coord in value.into_inner() {
-                let node = Box::into_raw(Box::new(coord.into()));
-                if ring.last.is_null() {
-                    ring.first = node;
+            for (i, polygon) in value.0.iter().enumerate() {
+                let first_loop = arena.loops.add(loop_id);
+                let mut rings = rings(polygon).peekable();
+                while let Some(coords) = rings.next() {
+                    let first_coord = arena.coords.add(coord_id);
+                    for (j, &coord) in coords.iter().enumerate() {
+                        let mut node = LinkedLatLng::from(coord);
+                        if j + 1 != coords.len() {
+                            node.next = arena.coords.add(coord_id + 1);
+                        }
+                        arena.coords.add(coord_id).write(node);
+                        coord_id += 1;
+                    }
+                    arena.loops.add(loop_id).write(LinkedGeoLoop {
+                        first: if coords.is_empty() {
+                            ptr::null_mut()
+                        } else {
+                            first_coord
+                        },
+                        last: if coords.is_empty() {
+                            ptr::null_mut()
+                        } else {
+                            arena.coords.add(coord_id - 1)
+                        },
+                        next: if rings.peek().is_some() {
+                            arena.loops.add(loop_id + 1)
+                        } else {
+                            ptr::null_mut()
+                        },
+                    });
+                    loop_id += 1;
+                }
+
+                // The head polygon is owned by the caller, the next ones live
+                // in the arena.
+                let node = Self {
+                    first: first_loop,
+                    last: arena.loops.add(loop_id - 1),
+                    next: if i + 1 == value.0.len() {
+                        ptr::null_mut()
+                    } else {
+                        arena.polygons.add(i)
+                    },
+                };
+                if i == 0 {
+                    head = Some(node);
                 } else {
-                    (*ring.last).next = node;
+                    arena.polygons.add(i - 1).write(node);
                 }
-                ring.last = node;
             }
         }
 
-        ring
+        head.expect("non-empty multipolygon")
     }
 }
 
 // -----------------------------------------------------------------------------
 
-/// A polygon node in a linked geo structure, part of a linked list.
+/// A multipolygon stored in contiguous arrays (GeoArrow-style).
+///
+/// The vertices of the ring `i` are `verts[ringOffsets[i]..ringOffsets[i+1]]`
+/// and the rings of the polygon `j` are
+/// `ringOffsets[polygonOffsets[j]..polygonOffsets[j+1]]`, the outer loop
+/// coming first followed by any holes.
 #[repr(C)]
 #[derive(Debug, Copy, Clone)]
-pub struct LinkedGeoPolygon {
-    pub first: *mut LinkedGeoLoop,
-    pub last: *mut LinkedGeoLoop,
-    pub next: *mut Self,
+pub struct FlatMultiPolygon {
+    pub numVerts: i64,
+    pub verts: *mut LatLng,
+    /// Offsets of the rings into `verts` (`numRings + 1` elements).
+    pub numRings: i64,
+    pub ringOffsets: *mut i64,
+    /// Offsets of the polygons into `ringOffsets` (`numPolygons + 1`
+    /// elements).
+    pub numPolygons: i64,
+    pub polygonOffsets: *mut i64,
 }
 
-impl From<MultiPolygon> for LinkedGeoPolygon {
+impl From<MultiPolygon> for FlatMultiPolygon {
     fn from(value: MultiPolygon) -> Self {
-        let mut head = ptr::null_mut();
-        assert!(!value.0.is_empty(), "empty multipolygon");
-        // SAFETY: we should always have at least 1 polygon in the multipolygon.
-        unsafe {
-            for polygon in value.0.into_iter().rev() {
-                let mut node = Self::from(polygon);
-                node.next = head;
-                head = Box::into_raw(Box::new(node));
+        /// Converts a vector into a raw array, and returns its length.
+        fn into_raw<T>(values: Vec<T>) -> (*mut T, usize) {
+            let len = values.len();
+            (Box::into_raw(values.into_boxed_slice()).cast(), len)
+        }
+        let to_i64 = |len: usize| i64::try_from(len).expect("too many items");
+
+        let mut verts = Vec::new();
+        let mut ring_offsets = vec![0];
+        let mut polygon_offsets = vec![0];
+        for polygon in value {
+            let (exterior, interiors) = polygon.into_inner();
+            for ring in std::iter::once(exterior).chain(interiors) {
+                let mut coords = ring.into_inner();
+                // Our rings are closed (first point == last point) but this
+                // isn't the case for H3. So remove the last point.
+                coords.pop();
+                verts.extend(coords.into_iter().map(LatLng::from));
+                ring_offsets.push(to_i64(verts.len()));
             }
-            *head
+            polygon_offsets.push(to_i64(ring_offsets.len() - 1));
+        }
+
+        let (verts, vert_count) = into_raw(verts);
+        let (ringOffsets, ring_count) = into_raw(ring_offsets);
+        let (polygonOffsets, polygon_count) = into_raw(polygon_offsets);
+        Self {
+            numVerts: to_i64(vert_count),
+            verts,
+            numRings: to_i64(ring_count - 1),
+            ringOffsets,
+            numPolygons: to_i64(polygon_count - 1),
+            polygonOffsets,
         }
     }
 }
 
-impl From<Polygon> for LinkedGeoPolygon {
-    fn from(value: Polygon) -> Self {
-        let mut polygon = Self {
-            first: ptr::null_mut(),
-            last: ptr::null_mut(),
-            next: ptr::null_mut(),
-        };
-        let (exterior, interiors) = value.into_inner();
-        let rings = std::iter::once(exterior).chain(interiors);
+// -----------------------------------------------------------------------------
+
+/// Header of the single allocation backing a linked geo structure.
+///
+/// The arena is laid out as follow: header, loops, polygons (except the head
+/// one, owned by the caller) and coordinates. Since the loops come right after
+/// the header, the latter can be found back from the first loop of the head
+/// polygon.
+#[repr(C)]
+struct LinkedArenaHeader {
+    /// Size of the whole allocation, in bytes.
+    size: usize,
+}
+
+/// Typed views over the allocation backing a linked geo structure.
+struct LinkedArena {
+    loops: *mut LinkedGeoLoop,
+    polygons: *mut LinkedGeoPolygon,
+    coords: *mut LinkedLatLng,
+}
+
+impl LinkedArena {
+    /// Allocates an arena able to hold the given number of nodes.
+    fn new(
+        polygon_count: usize,
+        loop_count: usize,
+        coord_count: usize,
+    ) -> Self {
+        let (layout, loops_offset) = Layout::new::<LinkedArenaHeader>()
+            .extend(
+                Layout::array::<LinkedGeoLoop>(loop_count)
+                    .expect("too many loops"),
+            )
+            .expect("arena too large");
+        let (layout, polygons_offset) = layout
+            .extend(
+                Layout::array::<LinkedGeoPolygon>(polygon_count)
+                    .expect("too many polygons"),
+            )
+            .expect("arena too large");
+        let (layout, coords_offset) = layout
+            .extend(
+                Layout::array::<LinkedLatLng>(coord_count)
+                    .expect("too many coordinates"),
+            )
+            .expect("arena too large");
+        debug_assert_eq!(loops_offset, Self::loops_offset());
 
-        // SAFETY: `last` is always set before being dereferenced.
+        // SAFETY: layout has a non-zero size (it contains the header at
+        // least), offsets are in bounds and properly aligned per `extend`.
         unsafe {
-            for ring in rings {
-                let node = Box::into_raw(Box::new(ring.into()));
-                if polygon.last.is_null() {
-                    polygon.first = node;
-                } else {
-                    (*polygon.last).next = node;
-                }
-                polygon.last = node;
+            let base = alloc::alloc(layout);
+            if base.is_null() {
+                alloc::handle_alloc_error(layout);
             }
+            let header: *mut LinkedArenaHeader = base.cast();
+            header.write(LinkedArenaHeader {
+                size: layout.size(),
+            });
+            Self {
+                loops: base.add(loops_offset).cast(),
+                polygons: base.add(polygons_offset).cast(),
+                coords: base.add(coords_offset).cast(),
+            }
+        }
+    }
+
+    /// Releases the arena owning the given first loop.
+    ///
+    /// # Safety
+    ///
+    /// `first` must be the first loop of an arena allocated by `new`.
+    unsafe fn free(first: *mut LinkedGeoLoop) {
+        let header: *mut LinkedArenaHeader =
+            first.byte_sub(Self::loops_offset()).cast();
+        let size = (*header).size;
+        let layout = Layout::from_size_align(size, Self::align())
+            .expect("valid arena layout");
+        alloc::dealloc(header.cast(), layout);
+    }
+
+    /// Offset of the loops from the start of the arena.
+    fn loops_offset() -> usize {
+        Layout::new::<LinkedArenaHeader>()
+            .extend(Layout::new::<LinkedGeoLoop>())
+            .expect("valid arena layout")
+            .1
+    }
+
+    /// Alignment of the arena (the strictest one of its content).
+    fn align() -> usize {
+        [
+            align_of::<LinkedArenaHeader>(),
+            align_of::<LinkedGeoLoop>(),
+            align_of::<LinkedGeoPolygon>(),
+            align_of::<LinkedLatLng>(),
+        ]
+        .into_iter()
+        .max()
+        .expect("non-empty list")
+    }
+}
+
+/// maxMultiPolygonToCellsSize returns the number of cells to allocate space for
+/// when performing a multiPolygonToCells on the given multipolygon.
+///
+/// @param multiPolygon The polygons to fill
+/// @param res Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param out number of cells to allocate for
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn maxMultiPolygonToCellsSize(
+    multiPolygon: Option<&GeoMultiPolygon>,
+    res: c_int,
+    flags: u32,
+    out: Option<&mut i64>,
+) -> H3Error {
+    fn inner(
+        multiPolygon: &GeoMultiPolygon,
+        res: c_int,
+        flags: u32,
+    ) -> Result<i64, H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
+        let resolution = convert::h3res_to_resolution(res)?;
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
+
+        Ok(multiPolygon
+            .prepare()?
+            .iter()
+            .map(|polygon| polygon.max_cells_count(config))
+            .sum::<usize>()
+            .try_into()
+            .expect("too many cells"))
+    }
+
+    multiPolygon.map_or_else(
+        || H3ErrorCodes::EFailed.into(),
+        |multiPolygon| delegate_inner!(inner(multiPolygon, res, flags), out),
+    )
+}
+
+/// multiPolygonToCells fills every polygon of a multipolygon, sparing the
+/// caller a sizing, an allocation and a call per polygon.
+///
+/// The polygons are filled concurrently, and the cells shared by several of
+/// them (e.g. with the overlapping containment mode) are only written once.
+/// The cells are written sorted, the unused tail of `out` is left untouched.
+///
+/// @param multiPolygon The polygons to fill
+/// @param res The Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param out The slab of zeroed memory to write to. Assumed to be big enough.
+/// @return E_MEMORY_BOUNDS if the cells don't fit in maxMultiPolygonToCellsSize
+/// elements, E_SUCCESS on success.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `maxMultiPolygonToCellsSize`
+/// elements.
+#[no_mangle]
+pub unsafe extern "C" fn multiPolygonToCells(
+    multiPolygon: Option<&GeoMultiPolygon>,
+    res: c_int,
+    flags: u32,
+    out: *mut H3Index,
+) -> H3Error {
+    unsafe fn inner(
+        multiPolygon: &GeoMultiPolygon,
+        res: c_int,
+        flags: u32,
+        out: *mut H3Index,
+    ) -> Result<(), H3Error> {
+        let mode = convert::h3flags_to_containment_mode(flags)?;
+        let resolution = convert::h3res_to_resolution(res)?;
+        let config = PolyfillConfig::new(resolution).containment_mode(mode);
+        let polygons = multiPolygon.prepare()?;
+        let len = polygons
+            .iter()
+            .map(|polygon| polygon.max_cells_count(config))
+            .sum();
+
+        let mut cells = parallel::map_chunks(&polygons, |polygons| {
+            polygons
+                .iter()
+                .flat_map(|polygon| polygon.to_cells(config))
+                .collect::<Vec<_>>()
+        })
+        .concat();
+        cells.sort_unstable();
+        cells.dedup();
+
+        write_cells(out, len, cells)?;
+        Ok(())
+    }
+
+    let _scope = stats::Scope::new(
+        stats::Function::MultiPolygonToCells,
+        multiPolygon.map_or(0, |polygons| polygons.numPolygons.into()),
+    );
+    multiPolygon.map_or_else(
+        || H3ErrorCodes::EFailed.into(),
+        |multiPolygon| {
+            inner(multiPolygon, res, flags, out)
+                .err()
+                .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+        },
+    )
+}
+
+/// polygonToCompactCells fills a polygon directly into a compacted set of
+/// cells, i.e. the compaction of the output of polygonToCells.
+///
+/// With the CONTAINMENT_CENTER mode, only the cells along the boundary of the
+/// polygon are refined down to `res`: the work and the output size scale with
+/// the perimeter of the polygon rather than its area. Other modes fill the
+/// polygon at `res` before compacting it.
+///
+/// The cells are written in no particular order. If `out` is too small,
+/// E_MEMORY_BOUNDS is returned but `count` is still set, so that it gives the
+/// required size (bounded by maxPolygonToCellsSize).
+///
+/// @param geoPolygon The geoloop and holes defining the relevant area
+/// @param res The Hexagon resolution (0-15)
+/// @param flags Containment mode (see ContainmentMode)
+/// @param out Output array
+/// @param maxOut Size of the output array
+/// @param count Number of cells of the compacted set
+/// @return 0 (E_SUCCESS) on success.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `maxOut` elements.
+#[no_mangle]
+pub unsafe extern "C" fn polygonToCompactCells(
+    geoPolygon: Option<&GeoPolygon>,
+    res: c_int,
+    flags: u32,
+    out: *mut H3Index,
+    maxOut: i64,
+    count: Option<&mut i64>,
+) -> H3Error {
+    let Ok(capacity) = usize::try_from(maxOut) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let cells = match geoPolygon.map_or_else(
+        || Err(H3ErrorCodes::EFailed.into()),
+        |geoPolygon| compact_polygon_cells(geoPolygon, res, flags),
+    ) {
+        Ok(cells) => cells,
+        Err(err) => return err,
+    };
+
+    *count.expect("null pointer") =
+        i64::try_from(cells.len()).expect("too many cells");
+    if cells.len() > capacity {
+        return H3ErrorCodes::EMemoryBounds.into();
+    }
+    if !cells.is_empty() {
+        let out = std::slice::from_raw_parts_mut(out, cells.len());
+        for (dst, cell) in out.iter_mut().zip(cells) {
+            *dst = cell.into();
         }
+    }
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Fills a polygon into a compacted set of cells (see polygonToCompactCells).
+pub fn compact_polygon_cells(
+    geoPolygon: &GeoPolygon,
+    res: c_int,
+    flags: u32,
+) -> Result<Vec<CellIndex>, H3Error> {
+    let mode = convert::h3flags_to_containment_mode(flags)?;
+    let resolution = convert::h3res_to_resolution(res)?;
+
+    // Empty polygon contains no cell.
+    if geoPolygon.geoloop.numVerts == 0 {
+        return Ok(Vec::new());
+    }
+
+    let polygon = Polygon::try_from(*geoPolygon)?;
+    let planar = polyfill::PlanarPolygon::new(&polygon);
+    let polygon = h3oPolygon::from_radians(polygon)?;
+    if mode == h3oContainmentMode::ContainsCentroid {
+        return Ok(polyfill::compact_fill(&planar, resolution));
+    }
 
-        polygon
+    let config = PolyfillConfig::new(resolution).containment_mode(mode);
+    let cells = CellIndex::compact(polygon.to_cells(config))?.collect();
+    Ok(cells)
+}
+
+/// Writes the cells into `out`, holding at most `len` of them, and returns
+/// how many were written.
+///
+/// Fails with E_MEMORY_BOUNDS, instead of writing past the end of `out`, if
+/// there are more cells than that.
+///
+/// # Safety
+///
+/// `out` must points to an array large enough for every cell written, i.e.
+/// `len` elements or the actual number of cells if smaller.
+unsafe fn write_cells(
+    out: *mut H3Index,
+    len: usize,
+    cells: impl IntoIterator<Item = CellIndex>,
+) -> Result<usize, H3Error> {
+    let mut count = 0;
+    for cell_index in cells {
+        if count == len {
+            return Err(H3ErrorCodes::EMemoryBounds.into());
+        }
+        out.add(count).write(cell_index.into());
+        count += 1;
     }
+    Ok(count)
 }
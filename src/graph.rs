@@ -0,0 +1,152 @@
+//! Neighbor graphs of cell sets.
+
+use crate::{convert, parallel, H3Error, H3ErrorCodes, H3Index};
+use h3o::CellIndex;
+
+/// cellsToAdjacencyCSR builds the neighbor graph of a set of cells, restricted
+/// to the set, in compressed sparse row (CSR) format.
+///
+/// The neighbors of `cells[i]` are stored in
+/// `neighbors[offsets[i]..offsets[i + 1]]` as positions in `cells`, ordered by
+/// direction (as the edges of originToDirectedEdges). Two cells are neighbors
+/// if they share an edge (see areNeighborCells), so the graph is undirected:
+/// every edge appears in both directions.
+///
+/// @param cells     The cells of the graph, without duplicates
+/// @param numCells  The number of cells
+/// @param offsets   Output offsets, of size `numCells + 1`
+/// @param neighbors Output neighbor positions, of size `6 * numCells` (at
+///                  most `offsets[numCells]` are set)
+/// @return E_CELL_INVALID if any cell is invalid, E_DUPLICATE_INPUT if a cell
+/// appears twice, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements, `offsets`
+/// to an array of at least `numCells + 1` elements and `neighbors` to an array
+/// of at least `6 * numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToAdjacencyCSR(
+    cells: *const H3Index,
+    numCells: i64,
+    offsets: *mut i64,
+    neighbors: *mut i64,
+) -> H3Error {
+    adjacency(cells, numCells, offsets, neighbors, false)
+}
+
+/// Parallel version of cellsToAdjacencyCSR: the neighbors of chunks of cells
+/// are looked up on the thread pool.
+///
+/// @param cells     The cells of the graph, without duplicates
+/// @param numCells  The number of cells
+/// @param offsets   Output offsets, of size `numCells + 1`
+/// @param neighbors Output neighbor positions, of size `6 * numCells` (at
+///                  most `offsets[numCells]` are set)
+/// @return E_CELL_INVALID if any cell is invalid, E_DUPLICATE_INPUT if a cell
+/// appears twice, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements, `offsets`
+/// to an array of at least `numCells + 1` elements and `neighbors` to an array
+/// of at least `6 * numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToAdjacencyCSRParallel(
+    cells: *const H3Index,
+    numCells: i64,
+    offsets: *mut i64,
+    neighbors: *mut i64,
+) -> H3Error {
+    adjacency(cells, numCells, offsets, neighbors, true)
+}
+
+// -----------------------------------------------------------------------------
+
+/// Positions of the cells of a set, sorted by cell for lookups.
+pub struct Positions(Vec<(CellIndex, usize)>);
+
+impl Positions {
+    /// Indexes the cells of a set, which must not contain any duplicate.
+    pub fn new(cells: &[CellIndex]) -> Result<Self, H3Error> {
+        let mut positions = cells
+            .iter()
+            .copied()
+            .enumerate()
+            .map(|(i, cell)| (cell, i))
+            .collect::<Vec<_>>();
+        positions.sort_unstable();
+        if positions.windows(2).any(|pair| pair[0].0 == pair[1].0) {
+            return Err(H3ErrorCodes::EDuplicateInput.into());
+        }
+        Ok(Self(positions))
+    }
+
+    /// Returns the position of a cell in the set, if any.
+    pub fn get(&self, cell: CellIndex) -> Option<usize> {
+        let i = self.0.partition_point(|&(other, _)| other < cell);
+        self.0
+            .get(i)
+            .and_then(|&(other, position)| (other == cell).then_some(position))
+    }
+}
+
+/// Shared implementation of cellsToAdjacencyCSR and its parallel version.
+unsafe fn adjacency(
+    cells: *const H3Index,
+    numCells: i64,
+    offsets: *mut i64,
+    neighbors: *mut i64,
+    parallel: bool,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let offsets = std::slice::from_raw_parts_mut(offsets, len + 1);
+    offsets[0] = 0;
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let cells = match convert::h3ptr_to_h3oslice(cells, numCells) {
+        Ok(cells) => cells,
+        Err(err) => return err,
+    };
+    let positions = match Positions::new(cells) {
+        Ok(positions) => positions,
+        Err(err) => return err,
+    };
+
+    // Neighbor positions of a chunk, with the number of neighbors so far
+    // after every cell.
+    let rows = |cells: &[CellIndex]| {
+        let mut neighbors = Vec::with_capacity(6 * cells.len());
+        let mut ends = Vec::with_capacity(cells.len());
+        for cell in cells {
+            neighbors.extend(cell.edges().filter_map(|edge| {
+                positions.get(edge.destination()).map(|position| {
+                    i64::try_from(position).expect("too many cells")
+                })
+            }));
+            ends.push(neighbors.len());
+        }
+        (neighbors, ends)
+    };
+    let chunks = if parallel {
+        parallel::map_chunks(cells, rows)
+    } else {
+        vec![rows(cells)]
+    };
+
+    let out = std::slice::from_raw_parts_mut(neighbors, 6 * len);
+    let mut offset = 0;
+    let mut i = 1;
+    for (neighbors, ends) in chunks {
+        for end in ends {
+            offsets[i] = i64::try_from(offset + end).expect("too many edges");
+            i += 1;
+        }
+        out[offset..offset + neighbors.len()].copy_from_slice(&neighbors);
+        offset += neighbors.len();
+    }
+    H3ErrorCodes::ESuccess.into()
+}
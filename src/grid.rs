@@ -1,6 +1,14 @@
-use crate::{convert, delegate_inner, H3Error, H3ErrorCodes, H3Index, H3_NULL};
+use crate::{
+    convert, delegate_inner, parallel, stats,
+    visit::{H3CellVisitor, Visit},
+    H3Error, H3ErrorCodes, H3Index, H3_NULL,
+};
 use h3o::{error::LocalIjError, CellIndex};
-use std::ffi::c_int;
+use std::{
+    collections::HashSet,
+    ffi::{c_int, c_void},
+    ops::Range,
+};
 
 /// Produce cells within grid distance k of the origin cell.
 ///
@@ -37,6 +45,7 @@ pub unsafe extern "C" fn gridDisk(
                 out[count] = index.into();
                 count += 1;
             } else {
+                stats::record_fallback(stats::GridPath::Disk, count);
                 out[..count].fill(H3_NULL);
                 count = 0;
                 break;
@@ -49,11 +58,14 @@ pub unsafe extern "C" fn gridDisk(
                 out[count] = index.into();
                 count += 1;
             }
+        } else {
+            stats::record_fast_path(stats::GridPath::Disk);
         }
 
         Ok(())
     }
 
+    let _scope = stats::Scope::new(stats::Function::GridDisk, 1);
     // Get the expected size of the output variables.
     let Ok(k) = u32::try_from(k) else {
         return H3ErrorCodes::EDomain.into();
@@ -72,6 +84,425 @@ pub unsafe extern "C" fn gridDisk(
     H3ErrorCodes::ESuccess.into()
 }
 
+/// Visits the cells within grid distance k of the origin cell.
+///
+/// Same as gridDisk, except that the cells are handed over to `visitor` by
+/// batches (of at most H3_VISIT_BATCH_SIZE cells) instead of being written
+/// into an output array. Every cell is visited once, in no particular order.
+///
+/// @param  origin   origin cell
+/// @param  k        k >= 0
+/// @param  visitor  callback receiving the batches of cells
+/// @param  context  pointer passed to every call of `visitor`
+/// @return 0 (E_SUCCESS) on success, including when stopped by `visitor`.
+///
+/// # Safety
+///
+/// `visitor` must be callable with `context`.
+#[no_mangle]
+pub unsafe extern "C" fn gridDiskForEach(
+    origin: H3Index,
+    k: c_int,
+    visitor: Option<H3CellVisitor>,
+    context: *mut c_void,
+) -> H3Error {
+    fn inner(
+        origin: H3Index,
+        k: c_int,
+        visit: &mut Visit,
+    ) -> Result<(), H3Error> {
+        let origin = CellIndex::try_from(origin)?;
+        let k = u32::try_from(k).map_err(|_| H3ErrorCodes::EDomain)?;
+
+        // Try fast version first.
+        let mut complete = true;
+        for result in origin.grid_disk_fast(k) {
+            let Some(index) = result else {
+                complete = false;
+                break;
+            };
+            if !visit.push(index) {
+                return Ok(());
+            }
+        }
+        if complete {
+            return Ok(());
+        }
+
+        // Fast version failed, fallback on the safer approach, skipping the
+        // cells already handed over (the fast version always produces them in
+        // the same order).
+        visit.discard();
+        let visited = origin
+            .grid_disk_fast(k)
+            .take(visit.visited())
+            .flatten()
+            .collect::<HashSet<_>>();
+        visit.extend(
+            origin
+                .grid_disk_safe(k)
+                .filter(|index| !visited.contains(index)),
+        );
+        Ok(())
+    }
+
+    let _scope = stats::Scope::new(stats::Function::GridDiskForEach, 1);
+    let Some(visitor) = visitor else {
+        return H3ErrorCodes::EFailed.into();
+    };
+    let mut visit = Visit::new(visitor, context);
+    if let Err(err) = inner(origin, k, &mut visit) {
+        return err;
+    }
+    visit.finish();
+
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Cursor spiraling out of an origin cell, one ring at a time.
+pub struct H3SpiralCursor {
+    /// Origin of the spiral.
+    origin: CellIndex,
+    /// Distance of the last ring.
+    k: u32,
+    /// Distance of `ring`.
+    distance: u32,
+    /// Ring being handed over.
+    ring: Vec<CellIndex>,
+    /// Position of the next cell of `ring`.
+    position: usize,
+    /// Ring before `ring`, while on the fast path.
+    previous: Vec<CellIndex>,
+    /// Breadth-first traversal, once a ring hit a pentagon.
+    rings: Option<Rings>,
+}
+
+impl H3SpiralCursor {
+    /// Moves to the next ring, returning false past the last one.
+    fn next_ring(&mut self) -> bool {
+        if self.distance == self.k {
+            return false;
+        }
+        self.distance += 1;
+        self.position = 0;
+
+        // The distortion of a pentagon spreads to every ring past it: once the
+        // fast path failed, the remaining rings come from the traversal.
+        if self.rings.is_none() {
+            if let Some(ring) = self
+                .origin
+                .grid_ring_fast(self.distance)
+                .collect::<Option<Vec<_>>>()
+            {
+                self.previous = std::mem::replace(&mut self.ring, ring);
+                return true;
+            }
+            let previous = self.previous.drain(..).collect();
+            self.rings =
+                Some(Rings::new(previous, std::mem::take(&mut self.ring)));
+        }
+        let rings = self.rings.as_mut().expect("traversal");
+        self.ring = rings.advance().to_vec();
+        // Empty once the whole grid has been covered.
+        !self.ring.is_empty()
+    }
+}
+
+/// gridDiskSpiralInit creates a cursor over the cells within grid distance
+/// k of the origin cell, which can then be drained ring by ring (with their
+/// distance) by chunks of bounded size with gridDiskSpiralNext.
+///
+/// The rings are only computed as they are handed over: stopping early saves
+/// the remaining work, and no buffer of maxGridDiskSize(k) elements is ever
+/// allocated. Every ring is computed with the fast algorithm, until one hits a
+/// pentagon: from there, the rings come from a breadth-first search (which
+/// only keeps the last two rings in memory).
+///
+/// It is the responsibility of the caller to call destroySpiralCursor on the
+/// cursor, or its memory will not be freed.
+///
+/// @param origin Origin cell
+/// @param k      k >= 0
+/// @param out    The created cursor
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn gridDiskSpiralInit(
+    origin: H3Index,
+    k: c_int,
+    out: Option<&mut *mut H3SpiralCursor>,
+) -> H3Error {
+    fn inner(
+        origin: H3Index,
+        k: c_int,
+    ) -> Result<*mut H3SpiralCursor, H3Error> {
+        let origin = CellIndex::try_from(origin)?;
+        let k = u32::try_from(k).map_err(|_| H3ErrorCodes::EDomain)?;
+
+        Ok(Box::into_raw(Box::new(H3SpiralCursor {
+            origin,
+            k,
+            distance: 0,
+            ring: vec![origin],
+            position: 0,
+            previous: Vec::new(),
+            rings: None,
+        })))
+    }
+
+    delegate_inner!(inner(origin, k), out)
+}
+
+/// gridDiskSpiralNext writes the next cells of the spiral into `out`, by
+/// increasing distance from the origin.
+///
+/// Once every cell has been produced, `written` is set to 0.
+///
+/// @param cursor    The cursor created by gridDiskSpiralInit
+/// @param out       The output buffer
+/// @param distances NULL, or the output buffer of the distances
+/// @param capacity  The size of the output buffers
+/// @param written   The number of cells written into `out`
+/// @return 0 (E_SUCCESS) on success.
+///
+/// # Safety
+///
+/// `out` and `distances` (unless NULL) must points to an array of at least
+/// `capacity` elements.
+#[no_mangle]
+pub unsafe extern "C" fn gridDiskSpiralNext(
+    cursor: Option<&mut H3SpiralCursor>,
+    out: *mut H3Index,
+    distances: *mut c_int,
+    capacity: i64,
+    written: Option<&mut i64>,
+) -> H3Error {
+    let Ok(capacity) = usize::try_from(capacity) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let cursor = cursor.expect("null pointer");
+    let mut count = 0;
+    while count < capacity {
+        if cursor.position == cursor.ring.len() && !cursor.next_ring() {
+            break;
+        }
+        let chunk = &cursor.ring[cursor.position..];
+        let len = chunk.len().min(capacity - count);
+        let cells = std::slice::from_raw_parts_mut(out.add(count), len);
+        for (dst, &cell) in cells.iter_mut().zip(chunk) {
+            *dst = cell.into();
+        }
+        if !distances.is_null() {
+            let distance = c_int::try_from(cursor.distance).expect("k fits");
+            std::slice::from_raw_parts_mut(distances.add(count), len)
+                .fill(distance);
+        }
+        cursor.position += len;
+        count += len;
+    }
+    *written.expect("null pointer") =
+        i64::try_from(count).expect("written fits in capacity");
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Free all allocated memory for a spiral cursor.
+///
+/// @param cursor The cursor to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`gridDiskSpiralInit`]
+#[no_mangle]
+pub unsafe extern "C" fn destroySpiralCursor(cursor: *mut H3SpiralCursor) {
+    if !cursor.is_null() {
+        drop(Box::from_raw(cursor));
+    }
+}
+
+/// Produce cells within grid distance k of the origin cell, densely packed.
+///
+/// Same as gridDisk, except that the output contains no hole: the cells are
+/// stored contiguously at the beginning of the output array, and their number
+/// is returned.
+///
+/// @param  origin   origin cell
+/// @param  k        k >= 0
+/// @param  out      array which must be of size maxGridDiskSize(k)
+/// @param  count    number of cells written
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `maxGridDiskSize(k)` elements.
+#[no_mangle]
+pub unsafe extern "C" fn gridDiskCompact(
+    origin: H3Index,
+    k: c_int,
+    out: *mut H3Index,
+    count: Option<&mut i64>,
+) -> H3Error {
+    unsafe fn inner(
+        origin: H3Index,
+        k: c_int,
+        out: *mut H3Index,
+    ) -> Result<i64, H3Error> {
+        let k = u32::try_from(k).map_err(|_| H3ErrorCodes::EDomain)?;
+        let origin = CellIndex::try_from(origin)?;
+
+        let len =
+            usize::try_from(h3o::max_grid_disk_size(k)).expect("overflow");
+        let out = std::slice::from_raw_parts_mut(out, len);
+        let count =
+            grid_disk_dense(origin, k, out, stats::GridPath::DiskCompact);
+        Ok(i64::try_from(count).expect("too many cells"))
+    }
+
+    delegate_inner!(inner(origin, k, out), count)
+}
+
+/// Writes the cells within grid distance `k` of `origin` contiguously into
+/// `out`, returning their number.
+///
+/// The fast algorithm is tried first. When it hits a pentagon, the rings it
+/// completed are kept and the remaining rings are computed from the last
+/// complete one, instead of starting over. The path taken is recorded for
+/// `path`.
+fn grid_disk_dense(
+    origin: CellIndex,
+    k: u32,
+    out: &mut [H3Index],
+    path: stats::GridPath,
+) -> usize {
+    let mut count = 0;
+    for result in origin.grid_disk_fast(k) {
+        let Some(index) = result else {
+            break;
+        };
+        out[count] = index.into();
+        count += 1;
+    }
+    if count == out.len() {
+        stats::record_fast_path(path);
+        return count;
+    }
+
+    // The fast algorithm outputs the disk ring by ring, thus the ring `r`
+    // is stored in `out[disk_size(r - 1)..disk_size(r)]`.
+    let disk_size = |ring: u32| {
+        let ring = usize::try_from(ring).expect("overflow");
+        1 + 3 * ring * (ring + 1)
+    };
+    let ring_start = |ring: u32| ring.checked_sub(1).map_or(0, disk_size);
+    let Some(ring) = (0..k).take_while(|&ring| disk_size(ring) <= count).last()
+    else {
+        // The origin is a pentagon, nothing to salvage.
+        stats::record_fallback(path, count);
+        out[0] = origin.into();
+        return extend_disk(out, 0..0, 0..1, 0, k);
+    };
+    // The partial ring after the salvaged ones is recomputed.
+    stats::record_fallback(path, count - disk_size(ring));
+    let previous = ring
+        .checked_sub(1)
+        .map_or(0..0, |previous| ring_start(previous)..ring_start(ring));
+
+    extend_disk(out, previous, ring_start(ring)..disk_size(ring), ring, k)
+}
+
+/// Extends the disk stored in `out` (ending with the rings `previous` and
+/// `current`, the latter at distance `ring`) up to distance `k`.
+///
+/// Returns the size of the extended disk.
+fn extend_disk(
+    out: &mut [H3Index],
+    previous: Range<usize>,
+    current: Range<usize>,
+    ring: u32,
+    k: u32,
+) -> usize {
+    let to_cell =
+        |&index: &H3Index| CellIndex::try_from(index).expect("valid cell");
+    let mut count = current.end;
+    let previous = out[previous].iter().map(to_cell).collect();
+    let current = out[current].iter().map(to_cell).collect();
+
+    expand_rings(previous, current, k - ring, |cell| {
+        out[count] = cell.into();
+        count += 1;
+    });
+    count
+}
+
+/// Expands a set of cells by `rings` rings, using a breadth-first search.
+///
+/// `previous` and `current` are the last two rings of the set (i.e. the cells
+/// at distance `d-1` and `d` from its core), and `f` is called on every new
+/// cell, ring by ring.
+///
+/// Returns the last ring.
+fn expand_rings(
+    previous: HashSet<CellIndex>,
+    current: Vec<CellIndex>,
+    rings: u32,
+    mut f: impl FnMut(CellIndex),
+) -> Vec<CellIndex> {
+    let mut traversal = Rings::new(previous, current);
+    for _ in 0..rings {
+        for &cell in traversal.advance() {
+            f(cell);
+        }
+    }
+    traversal.into_ring()
+}
+
+/// Breadth-first traversal of the rings around a set of cells, one ring at a
+/// time.
+pub struct Rings {
+    /// Ring before the current one.
+    previous: HashSet<CellIndex>,
+    /// Last computed ring.
+    current: Vec<CellIndex>,
+    current_set: HashSet<CellIndex>,
+}
+
+impl Rings {
+    /// Starts a traversal from the last two rings of a set (i.e. the cells at
+    /// distance `d-1` and `d` from its core).
+    pub fn new(previous: HashSet<CellIndex>, current: Vec<CellIndex>) -> Self {
+        let current_set = current.iter().copied().collect();
+        Self {
+            previous,
+            current,
+            current_set,
+        }
+    }
+
+    /// Computes the next ring and returns it (empty once the whole grid has
+    /// been covered).
+    pub fn advance(&mut self) -> &[CellIndex] {
+        // Neighbors of a cell at distance `d` are at distance `d-1`, `d` or
+        // `d+1`, so only the last two rings have to be remembered.
+        let mut next = Vec::new();
+        let mut next_set = HashSet::new();
+        for cell in &self.current {
+            for neighbor in cell.grid_disk_safe(1) {
+                if !self.previous.contains(&neighbor)
+                    && !self.current_set.contains(&neighbor)
+                    && next_set.insert(neighbor)
+                {
+                    next.push(neighbor);
+                }
+            }
+        }
+        self.previous = std::mem::replace(&mut self.current_set, next_set);
+        self.current = next;
+        &self.current
+    }
+
+    /// Returns the last computed ring.
+    pub fn into_ring(self) -> Vec<CellIndex> {
+        self.current
+    }
+}
+
 /// Produce cells and their distances from the given origin cell, up to
 /// distance k.
 ///
@@ -105,34 +536,17 @@ pub unsafe extern "C" fn gridDiskDistances(
         dists: &mut [c_int],
     ) -> Result<(), H3Error> {
         let origin = CellIndex::try_from(origin)?;
-        let mut count = 0;
-
-        // Try fast version first.
-        for result in origin.grid_disk_distances_fast(k) {
-            if let Some((index, dist)) = result {
-                cells[count] = index.into();
-                dists[count] = dist.try_into().expect("distance overflow");
-                count += 1;
-            } else {
-                cells[..count].fill(H3_NULL);
-                dists[..count].fill(0);
-                count = 0;
-                break;
-            }
-        }
-
-        // Fast version failed, fallback on the slowert (but safer) approach.
-        if count == 0 {
-            for (index, dist) in origin.grid_disk_distances_safe(k) {
-                cells[count] = index.into();
-                dists[count] = dist.try_into().expect("distance overflow");
-                count += 1;
-            }
-        }
-
+        grid_disk_distances(
+            origin,
+            k,
+            cells,
+            dists,
+            stats::GridPath::DiskDistances,
+        );
         Ok(())
     }
 
+    let _scope = stats::Scope::new(stats::Function::GridDiskDistances, 1);
     // Get the expected size of the output variables.
     let Ok(k) = u32::try_from(k) else {
         return H3ErrorCodes::EDomain.into();
@@ -152,6 +566,45 @@ pub unsafe extern "C" fn gridDiskDistances(
     H3ErrorCodes::ESuccess.into()
 }
 
+/// Writes the cells within grid distance `k` of `origin` contiguously into
+/// `cells`, with their distances in `dists`, returning their number.
+///
+/// The fast algorithm is tried first, and the safe one takes over from
+/// scratch when it hits a pentagon. The path taken is recorded for `path`.
+fn grid_disk_distances(
+    origin: CellIndex,
+    k: u32,
+    cells: &mut [H3Index],
+    dists: &mut [c_int],
+    path: stats::GridPath,
+) -> usize {
+    let mut count = 0;
+    for result in origin.grid_disk_distances_fast(k) {
+        let Some((index, dist)) = result else {
+            stats::record_fallback(path, count);
+            cells[..count].fill(H3_NULL);
+            dists[..count].fill(0);
+            count = 0;
+            break;
+        };
+        cells[count] = index.into();
+        dists[count] = dist.try_into().expect("distance overflow");
+        count += 1;
+    }
+    if count != 0 {
+        stats::record_fast_path(path);
+        return count;
+    }
+
+    // Fast version failed, fallback on the slower (but safer) approach.
+    for (index, dist) in origin.grid_disk_distances_safe(k) {
+        cells[count] = index.into();
+        dists[count] = dist.try_into().expect("distance overflow");
+        count += 1;
+    }
+    count
+}
+
 /// Safe but slow version of gridDiskDistances (also called by it when needed).
 ///
 /// Adds the origin cell to the output set (treating it as a hash set)
@@ -254,9 +707,14 @@ pub unsafe extern "C" fn gridDiskDistancesUnsafe(
                     cells[i] = cell_index.into();
                     dists[i] = dist.try_into().expect("distance overflow");
                 } else {
+                    stats::record_pentagon(
+                        stats::GridPath::DiskDistancesUnsafe,
+                        i,
+                    );
                     return H3ErrorCodes::EPentagon.into();
                 }
             }
+            stats::record_fast_path(stats::GridPath::DiskDistancesUnsafe);
             H3ErrorCodes::ESuccess.into()
         }
         Err(err) => err,
@@ -304,9 +762,11 @@ pub unsafe extern "C" fn gridDiskUnsafe(
                 if let Some(cell_index) = item {
                     slice[i] = cell_index.into();
                 } else {
+                    stats::record_pentagon(stats::GridPath::DiskUnsafe, i);
                     return H3ErrorCodes::EPentagon.into();
                 }
             }
+            stats::record_fast_path(stats::GridPath::DiskUnsafe);
             H3ErrorCodes::ESuccess.into()
         }
         Err(err) => err,
@@ -341,7 +801,7 @@ pub unsafe extern "C" fn gridDisksUnsafe(
         length: c_int,
         k: c_int,
     ) -> Result<(u64, impl Iterator<Item = Option<CellIndex>>), H3Error> {
-        let indexes = convert::h3ptr_to_h3oslice_mut(h3Set, length)?;
+        let indexes = convert::h3ptr_to_h3oslice_mut(h3Set, length.into())?;
         let k = u32::try_from(k).map_err(|_| H3ErrorCodes::EDomain)?;
         let count = u64::try_from(indexes.len()).expect("index count overflow");
         Ok((
@@ -362,15 +822,237 @@ pub unsafe extern "C" fn gridDisksUnsafe(
                 if let Some(cell_index) = item {
                     slice[i] = cell_index.into();
                 } else {
+                    stats::record_pentagon(stats::GridPath::DisksUnsafe, i);
                     return H3ErrorCodes::EPentagon.into();
                 }
             }
+            stats::record_fast_path(stats::GridPath::DisksUnsafe);
             H3ErrorCodes::ESuccess.into()
         }
         Err(err) => err,
     }
 }
 
+/// gridDisksParallel is the same as gridDisksUnsafe, but the origins are
+/// spread over every available worker and origins near a pentagon are handled
+/// (with the slower algorithm) instead of failing the whole batch.
+///
+/// Each origin owns a slice of maxGridDiskSize(k) elements in the output,
+/// sorted by k-ring (0 to max). Since disks near a pentagon have fewer cells,
+/// the end of their slice is filled with H3_NULL.
+///
+/// @param h3Set A pointer to an array of H3Indexes
+/// @param length The total number of H3Indexes in h3Set
+/// @param k The number of rings to generate
+/// @param out A pointer to the output memory to dump the new set of H3Indexes to
+///            The memory block should be equal to maxGridDiskSize(k) * length
+///
+/// # Safety
+///
+/// - `h3Set` must points to an array of at least `length` elements.
+/// - `out` must points to an array of at least `length * maxGridDiskSize(k)`
+///   elements.
+#[no_mangle]
+pub unsafe extern "C" fn gridDisksParallel(
+    h3Set: *const H3Index,
+    length: i64,
+    k: c_int,
+    out: *mut H3Index,
+) -> H3Error {
+    unsafe fn inner(
+        h3Set: *const H3Index,
+        length: i64,
+        k: c_int,
+        out: *mut H3Index,
+    ) -> Result<(), H3Error> {
+        let k = u32::try_from(k).map_err(|_| H3ErrorCodes::EDomain)?;
+        let stride = usize::try_from(h3o::max_grid_disk_size(k))
+            .map_err(|_| H3ErrorCodes::EDomain)?;
+        // Checked before reading the origins, which may not even fit.
+        let len = usize::try_from(length)
+            .ok()
+            .and_then(|length| length.checked_mul(stride))
+            .ok_or(H3ErrorCodes::EDomain)?;
+        let indexes = convert::h3ptr_to_h3oslice(h3Set, length)?;
+        let out = std::slice::from_raw_parts_mut(out, len);
+
+        let chunk_size = indexes.len().div_ceil(parallel::task_count());
+        let tasks = indexes
+            .chunks(chunk_size)
+            .zip(out.chunks_mut(chunk_size * stride))
+            .collect::<Vec<_>>();
+        parallel::for_each(tasks, |(indexes, out)| {
+            for (&origin, out) in indexes.iter().zip(out.chunks_mut(stride)) {
+                let count = grid_disk_dense(
+                    origin,
+                    k,
+                    out,
+                    stats::GridPath::DisksParallel,
+                );
+                out[count..].fill(H3_NULL);
+            }
+        });
+        Ok(())
+    }
+
+    let _scope = stats::Scope::new(stats::Function::GridDisksParallel, length);
+    if length == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    inner(h3Set, length, k, out)
+        .err()
+        .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// gridDisksDistances is the multi-origin version of gridDiskDistances: it
+/// produces the cells within grid distance k of every origin, with their
+/// distances, spreading the origins over every available worker.
+///
+/// Each origin owns a slice of maxGridDiskSize(k) elements in both outputs,
+/// where its disk is stored contiguously (in no particular order). Origins
+/// near a pentagon fall back on the safe algorithm instead of failing the
+/// whole batch, and since their disks have fewer cells, the end of their
+/// slice is filled with H3_NULL (and distances of 0).
+///
+/// @param origins   The origins
+/// @param length    The number of origins
+/// @param k         k >= 0
+/// @param out       Output cells, of size `length * maxGridDiskSize(k)`
+/// @param distances Output distances, of size `length * maxGridDiskSize(k)`
+/// @return E_CELL_INVALID if an origin is invalid, E_DOMAIN if k is negative
+/// or the output size overflows, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// - `origins` must points to an array of at least `length` elements.
+/// - `out` and `distances` must points to an array of at least
+///   `length * maxGridDiskSize(k)` elements each.
+#[no_mangle]
+pub unsafe extern "C" fn gridDisksDistances(
+    origins: *const H3Index,
+    length: i64,
+    k: c_int,
+    out: *mut H3Index,
+    distances: *mut c_int,
+) -> H3Error {
+    unsafe fn inner(
+        origins: *const H3Index,
+        length: i64,
+        k: c_int,
+        out: *mut H3Index,
+        distances: *mut c_int,
+    ) -> Result<(), H3Error> {
+        let k = u32::try_from(k).map_err(|_| H3ErrorCodes::EDomain)?;
+        let stride = usize::try_from(h3o::max_grid_disk_size(k))
+            .map_err(|_| H3ErrorCodes::EDomain)?;
+        // Checked before reading the origins, which may not even fit.
+        let len = usize::try_from(length)
+            .ok()
+            .and_then(|length| length.checked_mul(stride))
+            .ok_or(H3ErrorCodes::EDomain)?;
+        let origins = convert::h3ptr_to_h3oslice(origins, length)?;
+        let cells = std::slice::from_raw_parts_mut(out, len);
+        let dists = std::slice::from_raw_parts_mut(distances, len);
+
+        let chunk_size = origins.len().div_ceil(parallel::task_count());
+        let tasks = origins
+            .chunks(chunk_size)
+            .zip(cells.chunks_mut(chunk_size * stride))
+            .zip(dists.chunks_mut(chunk_size * stride))
+            .collect::<Vec<_>>();
+        parallel::for_each(tasks, |((origins, cells), dists)| {
+            let outputs =
+                cells.chunks_mut(stride).zip(dists.chunks_mut(stride));
+            for (&origin, (cells, dists)) in origins.iter().zip(outputs) {
+                let count = grid_disk_distances(
+                    origin,
+                    k,
+                    cells,
+                    dists,
+                    stats::GridPath::DisksDistances,
+                );
+                cells[count..].fill(H3_NULL);
+                dists[count..].fill(0);
+            }
+        });
+        Ok(())
+    }
+
+    let _scope = stats::Scope::new(stats::Function::GridDisksDistances, length);
+    if length == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    inner(origins, length, k, out, distances)
+        .err()
+        .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// gridDisksUnion produces the cells within grid distance k of any of the
+/// input cells, without duplicates.
+///
+/// The cells are produced by a breadth-first search from every input cell at
+/// once, so the memory used is proportional to the output (instead of
+/// `length * maxGridDiskSize(k)`). Output is placed in no particular order.
+///
+/// @param h3Set  A pointer to an array of H3Indexes
+/// @param length The total number of H3Indexes in h3Set
+/// @param k      The number of rings to generate
+/// @param out    The output array
+/// @param maxOut The size of the output array
+/// @param count  The number of cells in the union (even when `out` is too
+///               small)
+/// @return E_MEMORY_BOUNDS if the output array is too small
+///
+/// # Safety
+///
+/// - `h3Set` must points to an array of at least `length` elements.
+/// - `out` must points to an array of at least `maxOut` elements.
+#[no_mangle]
+pub unsafe extern "C" fn gridDisksUnion(
+    h3Set: *const H3Index,
+    length: i64,
+    k: c_int,
+    out: *mut H3Index,
+    maxOut: i64,
+    count: Option<&mut i64>,
+) -> H3Error {
+    unsafe fn inner(
+        h3Set: *const H3Index,
+        length: i64,
+        k: c_int,
+    ) -> Result<Vec<CellIndex>, H3Error> {
+        let k = u32::try_from(k).map_err(|_| H3ErrorCodes::EDomain)?;
+        let indexes = convert::h3ptr_to_h3oslice(h3Set, length)?;
+
+        let mut cells = indexes.to_vec();
+        cells.sort_unstable();
+        cells.dedup();
+        let mut union = cells.clone();
+        expand_rings(HashSet::new(), cells, k, |cell| union.push(cell));
+        Ok(union)
+    }
+
+    let cells = match inner(h3Set, length, k) {
+        Ok(cells) => cells,
+        Err(err) => return err,
+    };
+    let size = i64::try_from(cells.len()).expect("too many cells");
+    *count.expect("null pointer") = size;
+    if size > maxOut {
+        return H3ErrorCodes::EMemoryBounds.into();
+    }
+
+    if !cells.is_empty() {
+        let out = std::slice::from_raw_parts_mut(out, cells.len());
+        for (dst, cell) in out.iter_mut().zip(cells) {
+            *dst = cell.into();
+        }
+    }
+    H3ErrorCodes::ESuccess.into()
+}
+
 /// Produces the grid distance between the two indexes.
 ///
 /// This function may fail to find the distance between two indexes, for
@@ -394,9 +1076,98 @@ pub extern "C" fn gridDistance(
         Ok(origin.grid_distance(h3)?.into())
     }
 
+    let _scope = stats::Scope::new(stats::Function::GridDistance, 1);
     delegate_inner!(inner(origin, h3), distance)
 }
 
+/// Produces the grid distance between an origin and many target indexes.
+///
+/// This is a batch convenience: the origin is validated and located in its own
+/// local IJ frame once, but every target is still projected into that frame
+/// on its own (h3o rebuilds the frame of the origin on each projection and
+/// doesn't expose it), so the cost per target is the one of gridDistance minus
+/// the per-call overhead.
+///
+/// A target that cannot be reached (e.g. too far or on the other side of a
+/// pentagon) doesn't stop the batch: its distance is set to -1, the error is
+/// reported at the same offset in `errs` and the first one is returned once
+/// every target has been processed.
+///
+/// @param origin     Origin index.
+/// @param targets    Target indexes.
+/// @param numTargets Number of targets.
+/// @param distances  The grid distances, one per target.
+/// @param errs       NULL or the per-target error codes.
+/// @returns E_SUCCESS (0) on success, the error of `origin` or of the first
+///          unreachable target otherwise.
+///
+/// # Safety
+///
+/// `targets`, `distances` and `errs` (if not NULL) must points to an array of
+/// at least `numTargets` elements each.
+#[no_mangle]
+pub unsafe extern "C" fn gridDistancesFromOrigin(
+    origin: H3Index,
+    targets: *const H3Index,
+    numTargets: i64,
+    distances: *mut i64,
+    errs: *mut H3Error,
+) -> H3Error {
+    fn distance(
+        origin: CellIndex,
+        anchor: (i32, i32),
+        target: H3Index,
+    ) -> Result<i64, H3Error> {
+        let target = CellIndex::try_from(target)?.to_local_ij(origin)?;
+        let (di, dj) = (target.i() - anchor.0, target.j() - anchor.1);
+        // Distance in the IJK space: normalizing (di, dj, 0) brings its lowest
+        // component to 0, the distance is then its highest component.
+        Ok(i64::from(di.max(dj).max(0) - di.min(dj).min(0)))
+    }
+
+    let origin = match CellIndex::try_from(origin) {
+        Ok(origin) => origin,
+        Err(err) => return err.into(),
+    };
+    let anchor = match origin.to_local_ij(origin) {
+        Ok(anchor) => (anchor.i(), anchor.j()),
+        Err(err) => return err.into(),
+    };
+    let Ok(len) = usize::try_from(numTargets) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    let targets = std::slice::from_raw_parts(targets, len);
+    let distances = std::slice::from_raw_parts_mut(distances, len);
+    let mut first_err = None;
+    if errs.is_null() {
+        for (dist, &target) in distances.iter_mut().zip(targets) {
+            *dist = distance(origin, anchor, target).unwrap_or_else(|e| {
+                first_err.get_or_insert(e);
+                -1
+            });
+        }
+    } else {
+        let errs = std::slice::from_raw_parts_mut(errs, len);
+        for ((dist, err), &target) in
+            distances.iter_mut().zip(errs).zip(targets)
+        {
+            (*dist, *err) = match distance(origin, anchor, target) {
+                Ok(value) => (value, H3ErrorCodes::ESuccess.into()),
+                Err(e) => {
+                    first_err.get_or_insert(e);
+                    (-1, e)
+                }
+            };
+        }
+    }
+
+    first_err.unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
 /// Given two H3 indexes, return the line of indexes between them (inclusive).
 ///
 /// This function may fail to find the line between two indexes, for
@@ -442,6 +1213,7 @@ pub unsafe extern "C" fn gridPathCells(
         ))
     }
 
+    let _scope = stats::Scope::new(stats::Function::GridPathCells, 1);
     match inner(start, end) {
         Ok((len, iter)) => {
             let len = usize::try_from(len).expect("overflow");
@@ -482,6 +1254,238 @@ pub extern "C" fn gridPathCellsSize(
     delegate_inner!(inner(start, end), size)
 }
 
+/// Batch version of gridPathCells, for many start/end pairs at once.
+///
+/// Every path is computed once and written in `out`, one after the other:
+/// the path of the i-th pair is stored in `out[offsets[i]..offsets[i + 1]]`.
+/// Pairs for which no path can be found get an empty range, and the error of
+/// the first of them is returned once every pair has been processed.
+///
+/// If `out` is too small, E_MEMORY_BOUNDS is returned but `offsets` is still
+/// filled, so that `offsets[numPairs]` gives the required size.
+///
+/// @param starts   Start indexes of the lines
+/// @param ends     End indexes of the lines
+/// @param numPairs Number of lines
+/// @param out      Output array
+/// @param maxOut   Size of the output array
+/// @param offsets  Output offsets, of size `numPairs + 1`
+/// @return 0 on success, or another value on failure.
+///
+/// # Safety
+///
+/// - `starts` and `ends` must points to an array of at least `numPairs`
+///   elements.
+/// - `out` must points to an array of at least `maxOut` elements.
+/// - `offsets` must points to an array of at least `numPairs + 1` elements.
+#[no_mangle]
+pub unsafe extern "C" fn gridPathsCells(
+    starts: *const H3Index,
+    ends: *const H3Index,
+    numPairs: i64,
+    out: *mut H3Index,
+    maxOut: i64,
+    offsets: *mut i64,
+) -> H3Error {
+    grid_paths_cells(starts, ends, numPairs, out, maxOut, offsets, false)
+}
+
+/// gridPathsCellsParallel is the same as gridPathsCells, but the pairs are
+/// spread over every available worker.
+///
+/// @param starts   Start indexes of the lines
+/// @param ends     End indexes of the lines
+/// @param numPairs Number of lines
+/// @param out      Output array
+/// @param maxOut   Size of the output array
+/// @param offsets  Output offsets, of size `numPairs + 1`
+/// @return 0 on success, or another value on failure.
+///
+/// # Safety
+///
+/// - `starts` and `ends` must points to an array of at least `numPairs`
+///   elements.
+/// - `out` must points to an array of at least `maxOut` elements.
+/// - `offsets` must points to an array of at least `numPairs + 1` elements.
+#[no_mangle]
+pub unsafe extern "C" fn gridPathsCellsParallel(
+    starts: *const H3Index,
+    ends: *const H3Index,
+    numPairs: i64,
+    out: *mut H3Index,
+    maxOut: i64,
+    offsets: *mut i64,
+) -> H3Error {
+    grid_paths_cells(starts, ends, numPairs, out, maxOut, offsets, true)
+}
+
+/// Implementation of gridPathsCells, optionally multi-threaded.
+unsafe fn grid_paths_cells(
+    starts: *const H3Index,
+    ends: *const H3Index,
+    numPairs: i64,
+    out: *mut H3Index,
+    maxOut: i64,
+    offsets: *mut i64,
+    parallel: bool,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numPairs) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let Ok(capacity) = usize::try_from(maxOut) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let offsets = std::slice::from_raw_parts_mut(offsets, len + 1);
+    offsets[0] = 0;
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let pairs = std::slice::from_raw_parts(starts, len)
+        .iter()
+        .copied()
+        .zip(std::slice::from_raw_parts(ends, len).iter().copied())
+        .collect::<Vec<_>>();
+
+    let chunks = if parallel {
+        parallel::map_chunks(&pairs, grid_paths)
+    } else {
+        vec![grid_paths(&pairs)]
+    };
+
+    // Merge the paths of every chunk.
+    let mut count = 0;
+    let mut error = None;
+    let mut i = 0;
+    for chunk in &chunks {
+        for length in &chunk.lengths {
+            count += length;
+            i += 1;
+            offsets[i] = i64::try_from(count).expect("too many cells");
+        }
+        error = error.or(chunk.error);
+    }
+    if count > capacity {
+        return H3ErrorCodes::EMemoryBounds.into();
+    }
+    if count != 0 {
+        let mut out = std::slice::from_raw_parts_mut(out, count);
+        for chunk in chunks {
+            let (head, tail) = out.split_at_mut(chunk.cells.len());
+            head.copy_from_slice(&chunk.cells);
+            out = tail;
+        }
+    }
+
+    error.unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// Paths computed for a range of start/end pairs.
+struct GridPaths {
+    /// Concatenated paths.
+    cells: Vec<H3Index>,
+    /// Length of each path.
+    lengths: Vec<usize>,
+    /// First error encountered, if any.
+    error: Option<H3Error>,
+}
+
+/// Computes the path of every pair.
+fn grid_paths(pairs: &[(H3Index, H3Index)]) -> GridPaths {
+    fn path(
+        start: H3Index,
+        end: H3Index,
+        cells: &mut Vec<H3Index>,
+    ) -> Result<(), H3Error> {
+        let start = CellIndex::try_from(start)?;
+        let end = CellIndex::try_from(end)?;
+        for cell_index in start.grid_path_cells(end)? {
+            cells.push(cell_index?.into());
+        }
+        Ok(())
+    }
+
+    let mut cells = Vec::new();
+    let mut lengths = Vec::with_capacity(pairs.len());
+    let mut error = None;
+    for &(start, end) in pairs {
+        let len = cells.len();
+        if let Err(err) = path(start, end, &mut cells) {
+            // Drop the partial path, if any.
+            cells.truncate(len);
+            error = error.or(Some(err));
+        }
+        lengths.push(cells.len() - len);
+    }
+
+    GridPaths {
+        cells,
+        lengths,
+        error,
+    }
+}
+
+/// Returns the "hollow" ring of cells at exactly grid distance k from the
+/// origin cell. In particular, k=0 returns just the origin cell.
+///
+/// Unlike gridRingUnsafe, pentagons are supported: the fast algorithm is used
+/// first, and the ring is computed with a breadth-first search (which only
+/// keeps the last two rings in memory) if a pentagon is encountered.
+///
+/// Output is placed in the provided array in no particular order. Elements of
+/// the output array may be left zero, as can happen when crossing a pentagon.
+///
+/// @param origin Origin location.
+/// @param k k >= 0
+/// @param out Array which must be of size maxGridRingSize(k).
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `maxGridRingSize(k)` elements.
+#[no_mangle]
+pub unsafe extern "C" fn gridRing(
+    origin: H3Index,
+    k: c_int,
+    out: *mut H3Index,
+) -> H3Error {
+    unsafe fn inner(
+        origin: H3Index,
+        k: c_int,
+        out: *mut H3Index,
+    ) -> Result<(), H3Error> {
+        let origin = CellIndex::try_from(origin)?;
+        let k = u32::try_from(k).map_err(|_| H3ErrorCodes::EDomain)?;
+        let len = usize::try_from(max_grid_ring_size(k)).expect("overflow");
+        let out = std::slice::from_raw_parts_mut(out, len);
+
+        let mut count = 0;
+        for result in origin.grid_ring_fast(k) {
+            let Some(cell_index) = result else {
+                stats::record_fallback(stats::GridPath::Ring, count);
+                count = 0;
+                break;
+            };
+            out[count] = cell_index.into();
+            count += 1;
+        }
+        if count == len {
+            stats::record_fast_path(stats::GridPath::Ring);
+            return Ok(());
+        }
+
+        // Fast version failed, fallback on the breadth-first search.
+        let ring = expand_rings(HashSet::new(), vec![origin], k, |_| ());
+        for (dst, cell_index) in out.iter_mut().zip(&ring) {
+            *dst = (*cell_index).into();
+        }
+        out[ring.len()..].fill(H3_NULL);
+        Ok(())
+    }
+
+    inner(origin, k, out)
+        .err()
+        .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
 /// Returns the "hollow" ring of hexagons at exactly grid distance k from
 /// the origin hexagon. In particular, k=0 returns just the origin hexagon.
 ///
@@ -522,15 +1526,44 @@ pub unsafe extern "C" fn gridRingUnsafe(
                 if let Some(cell_index) = item {
                     slice[i] = cell_index.into();
                 } else {
+                    stats::record_pentagon(stats::GridPath::RingUnsafe, i);
                     return H3ErrorCodes::EPentagon.into();
                 }
             }
+            stats::record_fast_path(stats::GridPath::RingUnsafe);
             H3ErrorCodes::ESuccess.into()
         }
         Err(err) => err,
     }
 }
 
+/// Maximum number of cells that result from the gridRing algorithm with the
+/// given k.
+///
+/// @param   k   k value, k >= 0.
+/// @param out   size in indexes
+#[no_mangle]
+pub extern "C" fn maxGridRingSize(k: c_int, out: Option<&mut i64>) -> H3Error {
+    fn inner(k: c_int) -> Result<i64, H3Error> {
+        Ok(u32::try_from(k)
+            .map_err(|_| H3ErrorCodes::EDomain)
+            .map(max_grid_ring_size)?
+            .try_into()
+            .expect("grid ring size overflow"))
+    }
+
+    delegate_inner!(inner(k), out)
+}
+
+/// Returns the number of cells in a hexagonal ring at distance `k`.
+fn max_grid_ring_size(k: u32) -> u64 {
+    if k == 0 {
+        1
+    } else {
+        6 * u64::from(k)
+    }
+}
+
 /// Maximum number of cells that result from the gridDisk algorithm with the
 /// given k. Formula source and proof: `<https://oeis.org/A003215>`
 ///
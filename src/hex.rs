@@ -0,0 +1,368 @@
+//! Batch conversions between indexes and their hexadecimal representation.
+//!
+//! Unlike `h3ToString` and `stringToH3`, which go through the string
+//! formatting and parsing machinery for every index, those conversions work on
+//! raw byte buffers and rely on lookup tables: a byte of the index is encoded
+//! in a single lookup, and every digit is decoded in one.
+
+use crate::{H3Error, H3ErrorCodes, H3Index, H3_NULL};
+use h3o::{CellIndex, DirectedEdgeIndex, VertexIndex};
+use std::ffi::{c_char, c_int};
+
+/// Number of hexadecimal digits of a 64-bit index.
+const MAX_DIGITS: usize = 16;
+
+/// Number of hexadecimal digits of a cell index (the highest digit is always
+/// zero).
+const CELL_DIGITS: usize = 15;
+
+/// Lowercase hexadecimal digits, indexed by nibble.
+const HEX_DIGITS: &[u8; 16] = b"0123456789abcdef";
+
+/// Marker of the non-hexadecimal characters in `HEX_VALUES`.
+///
+/// It has a bit set above the nibble, so that decoding errors can be
+/// accumulated by OR-ing the values and checked once at the end.
+const INVALID_DIGIT: u8 = 0xff;
+
+/// Pair of hexadecimal digits, indexed by byte.
+static HEX_PAIRS: [[u8; 2]; 256] = hex_pairs();
+
+/// Value of every hexadecimal digit (either case), indexed by ASCII code.
+static HEX_VALUES: [u8; 256] = hex_values();
+
+const fn hex_pairs() -> [[u8; 2]; 256] {
+    let mut table = [[0; 2]; 256];
+    let mut byte = 0;
+    while byte < table.len() {
+        table[byte] = [HEX_DIGITS[byte >> 4], HEX_DIGITS[byte & 0xf]];
+        byte += 1;
+    }
+    table
+}
+
+const fn hex_values() -> [u8; 256] {
+    let mut table = [INVALID_DIGIT; 256];
+    let (mut i, mut ascii) = (0, 0_u8);
+    while i < table.len() {
+        table[i] = match ascii {
+            b'0'..=b'9' => ascii - b'0',
+            b'a'..=b'f' => ascii - b'a' + 10,
+            b'A'..=b'F' => ascii - b'A' + 10,
+            _ => INVALID_DIGIT,
+        };
+        i += 1;
+        ascii = ascii.wrapping_add(1);
+    }
+    table
+}
+
+/// Returns the 16 hexadecimal digits (zero-padded) of the value.
+fn encode(value: u64) -> [u8; MAX_DIGITS] {
+    let mut digits = [0; MAX_DIGITS];
+    for (pair, byte) in digits.chunks_exact_mut(2).zip(value.to_be_bytes()) {
+        pair.copy_from_slice(&HEX_PAIRS[usize::from(byte)]);
+    }
+    digits
+}
+
+/// Parses the hexadecimal digits, up to the first NUL byte (if any).
+///
+/// Leading zeros are accepted, but the value must fit on 64 bits.
+fn decode(digits: &[u8]) -> Option<u64> {
+    let digits = digits.split(|&c| c == 0).next().unwrap_or_default();
+    if digits.is_empty() {
+        return None;
+    }
+
+    let (mut value, mut invalid, mut overflow) = (0_u64, 0, 0);
+    for &digit in digits {
+        let nibble = HEX_VALUES[usize::from(digit)];
+        invalid |= nibble;
+        overflow |= value >> 60;
+        value = (value << 4) | u64::from(nibble & 0xf);
+    }
+
+    (invalid <= 0xf && overflow == 0).then_some(value)
+}
+
+/// Returns true if the index is either a valid cell, directed edge or vertex,
+/// just like `stringToH3` requires.
+fn is_valid(index: H3Index) -> bool {
+    CellIndex::try_from(index).is_ok()
+        || DirectedEdgeIndex::try_from(index).is_ok()
+        || VertexIndex::try_from(index).is_ok()
+}
+
+/// Parses an index, validating it if requested.
+fn parse(digits: &[u8], validate: bool) -> Option<H3Index> {
+    decode(digits).filter(|&index| !validate || is_valid(index))
+}
+
+/// Splits the leading length-prefixed string from the buffer, if complete.
+fn split_prefixed(strings: &[u8]) -> Option<(&[u8], &[u8])> {
+    let (&length, tail) = strings.split_first()?;
+    let length = usize::from(length);
+    (length <= tail.len()).then(|| tail.split_at(length))
+}
+
+/// h3sToStrings converts a batch of indexes into their fixed-width
+/// hexadecimal representation.
+///
+/// Every index is written as exactly `width` lowercase digits (zero-padded),
+/// without any separator nor NUL terminator: index `i` starts at
+/// `out + i * width`.
+///
+/// A width of 15 digits fits every cell index, but not the directed edges and
+/// vertexes: those are written as zeros, and E_MEMORY_BOUNDS is returned once
+/// every index has been processed.
+///
+/// @param indexes Indexes to convert
+/// @param numIndexes Number of indexes
+/// @param width Number of digits per index, either 15 or 16
+/// @param out Output buffer, of `numIndexes * width` bytes
+/// @return E_DOMAIN if the width is not supported or the output size
+/// overflows.
+///
+/// # Safety
+///
+/// `indexes` must points to an array of at least `numIndexes` elements, and
+/// `out` to a buffer of at least `numIndexes * width` bytes.
+#[no_mangle]
+pub unsafe extern "C" fn h3sToStrings(
+    indexes: *const H3Index,
+    numIndexes: i64,
+    width: usize,
+    out: *mut c_char,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numIndexes) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if width != CELL_DIGITS && width != MAX_DIGITS {
+        return H3ErrorCodes::EDomain.into();
+    }
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let Some(size) = len.checked_mul(width) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let indexes = std::slice::from_raw_parts(indexes, len);
+    let out = std::slice::from_raw_parts_mut(out.cast::<u8>(), size);
+
+    let mut fit = true;
+    for (dst, &index) in out.chunks_exact_mut(width).zip(indexes) {
+        let digits = encode(index);
+        let (head, tail) = digits.split_at(MAX_DIGITS - width);
+        if head.iter().all(|&digit| digit == b'0') {
+            dst.copy_from_slice(tail);
+        } else {
+            fit = false;
+            dst.fill(b'0');
+        }
+    }
+
+    if fit {
+        H3ErrorCodes::ESuccess.into()
+    } else {
+        H3ErrorCodes::EMemoryBounds.into()
+    }
+}
+
+/// stringsToH3 converts a batch of fixed-width hexadecimal representations
+/// into indexes.
+///
+/// String `i` starts at `strings + i * width` and spans `width` bytes, unless
+/// it's terminated earlier by a NUL byte. Digits can be in either case, and
+/// leading zeros are accepted.
+///
+/// Strings that aren't hexadecimal numbers (or, when `validate` is non-zero,
+/// that don't represent a valid cell, directed edge or vertex, like
+/// `stringToH3`) are converted to H3_NULL, and E_FAILED is returned once
+/// every string has been processed.
+///
+/// @param strings Strings to convert
+/// @param numStrings Number of strings
+/// @param width Number of bytes per string
+/// @param validate Non-zero to validate the indexes, zero to only parse them
+/// @param out Output indexes
+/// @return E_DOMAIN if the width is zero or the input size overflows.
+///
+/// # Safety
+///
+/// `strings` must points to a buffer of at least `numStrings * width` bytes,
+/// and `out` to an array of at least `numStrings` elements.
+#[no_mangle]
+pub unsafe extern "C" fn stringsToH3(
+    strings: *const c_char,
+    numStrings: i64,
+    width: usize,
+    validate: c_int,
+    out: *mut H3Index,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numStrings) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if width == 0 {
+        return H3ErrorCodes::EDomain.into();
+    }
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let Some(size) = len.checked_mul(width) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let strings = std::slice::from_raw_parts(strings.cast::<u8>(), size);
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    let mut valid = true;
+    for (dst, digits) in out.iter_mut().zip(strings.chunks_exact(width)) {
+        *dst = parse(digits, validate != 0).unwrap_or_else(|| {
+            valid = false;
+            H3_NULL
+        });
+    }
+
+    if valid {
+        H3ErrorCodes::ESuccess.into()
+    } else {
+        H3ErrorCodes::EFailed.into()
+    }
+}
+
+/// h3sToLengthPrefixedStrings converts a batch of indexes into their
+/// length-prefixed hexadecimal representation.
+///
+/// Every index is written as a byte holding the number of digits, followed by
+/// the lowercase digits themselves (without leading zeros, like
+/// `h3ToString`). Each index takes at most 17 bytes.
+///
+/// If the buffer is too small, nothing is written and E_MEMORY_BOUNDS is
+/// returned, but `written` is still set to the required size.
+///
+/// @param indexes Indexes to convert
+/// @param numIndexes Number of indexes
+/// @param out Output buffer
+/// @param size Size of the output buffer, in bytes
+/// @param written Number of bytes written
+///
+/// # Safety
+///
+/// `indexes` must points to an array of at least `numIndexes` elements, and
+/// `out` to a buffer of at least `size` bytes.
+#[no_mangle]
+pub unsafe extern "C" fn h3sToLengthPrefixedStrings(
+    indexes: *const H3Index,
+    numIndexes: i64,
+    out: *mut u8,
+    size: usize,
+    written: Option<&mut usize>,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numIndexes) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let written = written.expect("null pointer");
+    *written = 0;
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let indexes = std::slice::from_raw_parts(indexes, len);
+
+    // Number of leading zeros to skip, keeping at least one digit.
+    let skipped = |index: H3Index| {
+        usize::try_from(index.leading_zeros() / 4)
+            .expect("at most 16")
+            .min(MAX_DIGITS - 1)
+    };
+    let required = indexes
+        .iter()
+        .map(|&index| 1 + MAX_DIGITS - skipped(index))
+        .sum::<usize>();
+    *written = required;
+    if required > size {
+        return H3ErrorCodes::EMemoryBounds.into();
+    }
+    let mut out = std::slice::from_raw_parts_mut(out, required);
+
+    for &index in indexes {
+        let digits = encode(index);
+        let digits = &digits[skipped(index)..];
+        let (dst, tail) = out.split_at_mut(1 + digits.len());
+        dst[0] = u8::try_from(digits.len()).expect("at most 16");
+        dst[1..].copy_from_slice(digits);
+        out = tail;
+    }
+
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// lengthPrefixedStringsToH3 converts a batch of length-prefixed hexadecimal
+/// representations into indexes.
+///
+/// Every string is made of a byte holding its length, followed by that many
+/// hexadecimal digits (in either case, leading zeros are accepted).
+///
+/// Strings that aren't hexadecimal numbers (or, when `validate` is non-zero,
+/// that don't represent a valid cell, directed edge or vertex, like
+/// `stringToH3`) are converted to H3_NULL, and E_FAILED is returned once
+/// every string has been processed. If the buffer ends before the last
+/// string, the missing indexes are set to H3_NULL and E_MEMORY_BOUNDS is
+/// returned.
+///
+/// @param strings Strings to convert
+/// @param size Size of the strings buffer, in bytes
+/// @param numStrings Number of strings
+/// @param validate Non-zero to validate the indexes, zero to only parse them
+/// @param out Output indexes
+///
+/// # Safety
+///
+/// `strings` must points to a buffer of at least `size` bytes, and `out` to
+/// an array of at least `numStrings` elements.
+#[no_mangle]
+pub unsafe extern "C" fn lengthPrefixedStringsToH3(
+    strings: *const u8,
+    size: usize,
+    numStrings: i64,
+    validate: c_int,
+    out: *mut H3Index,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numStrings) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let mut strings = if size == 0 {
+        &[]
+    } else {
+        std::slice::from_raw_parts(strings, size)
+    };
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    let (mut valid, mut done) = (true, 0);
+    for dst in out.iter_mut() {
+        let Some((digits, tail)) = split_prefixed(strings) else {
+            break;
+        };
+        strings = tail;
+        done += 1;
+        // Embedded NUL bytes are invalid here: the length is explicit.
+        *dst = parse(digits, validate != 0)
+            .filter(|_| !digits.contains(&0))
+            .unwrap_or_else(|| {
+                valid = false;
+                H3_NULL
+            });
+    }
+    if done < len {
+        out[done..].fill(H3_NULL);
+        return H3ErrorCodes::EMemoryBounds.into();
+    }
+
+    if valid {
+        H3ErrorCodes::ESuccess.into()
+    } else {
+        H3ErrorCodes::EFailed.into()
+    }
+}
@@ -0,0 +1,365 @@
+//! Spatial join of points against many polygons (zones), by cell lookup.
+//!
+//! Every zone is covered by cells settled once for all at index creation:
+//! the cells whose whole extent is inside the zone (compacted, at any
+//! resolution) and the cells crossed by its boundary (at the index
+//! resolution). Joining a point then takes one cell conversion, a lookup of
+//! its ancestors, and an exact point-in-polygon test against the zones whose
+//! boundary crosses its cell only.
+
+use crate::{
+    convert, delegate_inner, parallel, polyfill::PlanarPolygon, GeoPolygon,
+    H3Error, H3ErrorCodes, LatLng,
+};
+use geo_types::Polygon;
+use h3o::{CellIndex, Resolution};
+use std::{collections::HashMap, ffi::c_int, ops::Range};
+
+/// An index of zones (polygons), to find the zones containing points.
+pub struct H3ZoneIndex {
+    /// Zones, with their ID.
+    zones: Vec<(i64, PlanarPolygon)>,
+    /// Range of `entries` holding the zones covering every cell.
+    cells: HashMap<CellIndex, Range<usize>>,
+    /// Zones covering the cells (index in `zones`), grouped per cell, and
+    /// whether the point must be tested against the zone (boundary cell).
+    entries: Vec<(usize, bool)>,
+    /// Resolutions holding at least one cell, from the finest.
+    resolutions: Vec<Resolution>,
+}
+
+impl H3ZoneIndex {
+    /// Builds the index, the zones being covered on the thread pool.
+    fn new(zones: Vec<(i64, PlanarPolygon)>, resolution: Resolution) -> Self {
+        let ids = (0..zones.len()).collect::<Vec<_>>();
+        let mut covers = parallel::map_chunks(&ids, |ids| {
+            let mut cover = Vec::new();
+            for &zone in ids {
+                for cell in CellIndex::base_cells() {
+                    cover_cell(
+                        &zones[zone].1,
+                        zone,
+                        cell,
+                        resolution,
+                        &mut cover,
+                    );
+                }
+            }
+            cover
+        })
+        .concat();
+        covers.sort_unstable();
+
+        let mut cells = HashMap::<CellIndex, Range<usize>>::new();
+        let mut entries = Vec::with_capacity(covers.len());
+        let mut resolutions = Vec::new();
+        for (i, (cell, zone, exact)) in covers.into_iter().enumerate() {
+            // Covers are sorted, so the zones of a cell are contiguous.
+            cells.entry(cell).or_insert(i..i).end += 1;
+            entries.push((zone, exact));
+            resolutions.push(cell.resolution());
+        }
+        resolutions.sort_unstable_by(|a, b| b.cmp(a));
+        resolutions.dedup();
+
+        Self {
+            zones,
+            cells,
+            entries,
+            resolutions,
+        }
+    }
+
+    /// Appends the IDs of the zones containing the point to `out`, sorted and
+    /// without duplicates.
+    fn zones(&self, point: LatLng, out: &mut Vec<i64>) -> Result<(), H3Error> {
+        let ll = h3o::LatLng::try_from(point)?;
+        let Some(&finest) = self.resolutions.first() else {
+            return Ok(());
+        };
+        let cell = ll.to_cell(finest);
+        let start = out.len();
+        for &resolution in &self.resolutions {
+            let ancestor = cell.parent(resolution).expect("coarser resolution");
+            let Some(range) = self.cells.get(&ancestor) else {
+                continue;
+            };
+            for &(zone, exact) in &self.entries[range.clone()] {
+                let (id, ref polygon) = self.zones[zone];
+                if !exact || polygon.contains(point.lat, point.lng) {
+                    out.push(id);
+                }
+            }
+        }
+        // Several zones may share an ID.
+        out[start..].sort_unstable();
+        let mut len = start;
+        for i in start..out.len() {
+            if len == start || out[len - 1] != out[i] {
+                out[len] = out[i];
+                len += 1;
+            }
+        }
+        out.truncate(len);
+
+        Ok(())
+    }
+
+    /// Joins a batch of points, returning the IDs of the zones containing
+    /// them, the number of IDs after every point, and the first error.
+    fn join(
+        &self,
+        points: &[LatLng],
+    ) -> (Vec<i64>, Vec<usize>, Option<H3Error>) {
+        let mut ids = Vec::new();
+        let mut ends = Vec::with_capacity(points.len());
+        let mut error = None;
+        for &point in points {
+            if let Err(err) = self.zones(point, &mut ids) {
+                error = error.or(Some(err));
+            }
+            ends.push(ids.len());
+        }
+        (ids, ends, error)
+    }
+}
+
+/// Appends the cover of the zone within `cell` to `cover`.
+///
+/// Cells entirely inside the zone are settled at once, the cells crossed by
+/// the zone boundary are refined down to `resolution`, where the points must
+/// be tested.
+fn cover_cell(
+    polygon: &PlanarPolygon,
+    zone: usize,
+    cell: CellIndex,
+    resolution: Resolution,
+    cover: &mut Vec<(CellIndex, usize, bool)>,
+) {
+    match polygon.classify_descendants(cell) {
+        Some(true) => cover.push((cell, zone, false)),
+        Some(false) => (),
+        None if cell.resolution() == resolution => {
+            cover.push((cell, zone, true));
+        }
+        None => {
+            let next = cell.resolution().succ().expect("finer resolution");
+            let start = cover.len();
+            for child in cell.children(next) {
+                cover_cell(polygon, zone, child, resolution, cover);
+            }
+            // Every child is inside: the cell replaces them.
+            if cover.len() - start
+                == usize::try_from(cell.children_count(next)).expect("count")
+                && cover[start..].iter().all(|&(child, _, exact)| {
+                    !exact && child.resolution() == next
+                })
+            {
+                cover.truncate(start);
+                cover.push((cell, zone, false));
+            }
+        }
+    }
+}
+
+/// Writes the result of a join split into chunks, see `latLngsToZoneIds`.
+unsafe fn write_join(
+    chunks: Vec<(Vec<i64>, Vec<usize>, Option<H3Error>)>,
+    out: *mut i64,
+    capacity: usize,
+    offsets: &mut [i64],
+) -> H3Error {
+    let total = chunks.iter().map(|chunk| chunk.0.len()).sum::<usize>();
+    let mut error = None;
+    let mut offset = 0;
+    let mut point = 1;
+    for (ids, ends, chunk_error) in chunks {
+        for end in ends {
+            offsets[point] =
+                i64::try_from(offset + end).expect("too many zones");
+            point += 1;
+        }
+        if total <= capacity && !ids.is_empty() {
+            std::slice::from_raw_parts_mut(out.add(offset), ids.len())
+                .copy_from_slice(&ids);
+        }
+        offset += ids.len();
+        error = error.or(chunk_error);
+    }
+    if total > capacity {
+        return H3ErrorCodes::EMemoryBounds.into();
+    }
+
+    error.unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+// -----------------------------------------------------------------------------
+
+/// createZoneIndex builds an index of zones (polygons), to find the zones
+/// containing a batch of points with latLngsToZoneIds.
+///
+/// The zones are covered by cells on the thread pool (see h3SetThreadPool):
+/// the cells inside a zone are kept at the coarsest possible resolution, the
+/// cells crossed by its boundary at `res`. The finer `res`, the fewer points
+/// go through an exact point-in-polygon test, but the larger the index.
+///
+/// It is the responsibility of the caller to call destroyZoneIndex on the
+/// index, or its memory will not be freed.
+///
+/// @param zones    The polygons of the zones
+/// @param ids      The IDs of the zones
+/// @param numZones The number of zones
+/// @param res      The resolution of the cells crossed by the zone boundaries
+/// @param out      The created index
+/// @return E_RES_DOMAIN if the resolution is invalid, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `zones` and `ids` must points to arrays of at least `numZones` elements.
+#[no_mangle]
+pub unsafe extern "C" fn createZoneIndex(
+    zones: *const GeoPolygon,
+    ids: *const i64,
+    numZones: i64,
+    res: c_int,
+    out: Option<&mut *mut H3ZoneIndex>,
+) -> H3Error {
+    unsafe fn inner(
+        zones: *const GeoPolygon,
+        ids: *const i64,
+        numZones: i64,
+        res: c_int,
+    ) -> Result<*mut H3ZoneIndex, H3Error> {
+        let resolution = convert::h3res_to_resolution(res)?;
+        let len =
+            usize::try_from(numZones).map_err(|_| H3ErrorCodes::EDomain)?;
+        let mut planar = Vec::with_capacity(len);
+        if len != 0 {
+            let zones = std::slice::from_raw_parts(zones, len);
+            let ids = std::slice::from_raw_parts(ids, len);
+            for (&zone, &id) in zones.iter().zip(ids) {
+                // Empty polygons contain no point.
+                if zone.geoloop.numVerts == 0 {
+                    continue;
+                }
+                let polygon = Polygon::try_from(zone)?;
+                planar.push((id, PlanarPolygon::new(&polygon)));
+            }
+        }
+        Ok(Box::into_raw(Box::new(H3ZoneIndex::new(
+            planar, resolution,
+        ))))
+    }
+
+    delegate_inner!(inner(zones, ids, numZones, res), out)
+}
+
+/// latLngsToZoneIds finds the zones containing every point of a batch.
+///
+/// The IDs of the zones containing the i-th point (in radians) are stored,
+/// sorted and without duplicates, in `out[offsets[i]..offsets[i + 1]]`.
+/// Invalid points get an empty range, and the error of the first of them is
+/// returned once every point has been processed.
+///
+/// If `out` is too small, E_MEMORY_BOUNDS is returned but `offsets` is still
+/// filled, so that `offsets[numPoints]` gives the required size.
+///
+/// @param index     The index created by createZoneIndex
+/// @param points    The points to join
+/// @param numPoints The number of points
+/// @param out       Output array
+/// @param maxOut    Size of the output array
+/// @param offsets   Output offsets, of size `numPoints + 1`
+/// @return 0 on success, or another value on failure.
+///
+/// # Safety
+///
+/// - `points` must points to an array of at least `numPoints` elements.
+/// - `out` must points to an array of at least `maxOut` elements.
+/// - `offsets` must points to an array of at least `numPoints + 1` elements.
+#[no_mangle]
+pub unsafe extern "C" fn latLngsToZoneIds(
+    index: Option<&H3ZoneIndex>,
+    points: *const LatLng,
+    numPoints: i64,
+    out: *mut i64,
+    maxOut: i64,
+    offsets: *mut i64,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numPoints) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let Ok(capacity) = usize::try_from(maxOut) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let offsets = std::slice::from_raw_parts_mut(offsets, len + 1);
+    offsets[0] = 0;
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let Some(index) = index else {
+        return H3ErrorCodes::EFailed.into();
+    };
+    let points = std::slice::from_raw_parts(points, len);
+
+    write_join(vec![index.join(points)], out, capacity, offsets)
+}
+
+/// Parallel version of latLngsToZoneIds: the points are split into chunks,
+/// joined on the thread pool.
+///
+/// @param index     The index created by createZoneIndex
+/// @param points    The points to join
+/// @param numPoints The number of points
+/// @param out       Output array
+/// @param maxOut    Size of the output array
+/// @param offsets   Output offsets, of size `numPoints + 1`
+/// @return 0 on success, or another value on failure.
+///
+/// # Safety
+///
+/// - `points` must points to an array of at least `numPoints` elements.
+/// - `out` must points to an array of at least `maxOut` elements.
+/// - `offsets` must points to an array of at least `numPoints + 1` elements.
+#[no_mangle]
+pub unsafe extern "C" fn latLngsToZoneIdsParallel(
+    index: Option<&H3ZoneIndex>,
+    points: *const LatLng,
+    numPoints: i64,
+    out: *mut i64,
+    maxOut: i64,
+    offsets: *mut i64,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numPoints) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let Ok(capacity) = usize::try_from(maxOut) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let offsets = std::slice::from_raw_parts_mut(offsets, len + 1);
+    offsets[0] = 0;
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let Some(index) = index else {
+        return H3ErrorCodes::EFailed.into();
+    };
+    let points = std::slice::from_raw_parts(points, len);
+
+    let chunks = parallel::map_chunks(points, |points| index.join(points));
+    write_join(chunks, out, capacity, offsets)
+}
+
+/// Free all allocated memory for a zone index.
+///
+/// @param index The index to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`createZoneIndex`]
+#[no_mangle]
+pub unsafe extern "C" fn destroyZoneIndex(index: *mut H3ZoneIndex) {
+    if !index.is_null() {
+        drop(Box::from_raw(index));
+    }
+}
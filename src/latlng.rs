@@ -1,5 +1,10 @@
-use crate::{convert, delegate_inner, H3Error, H3ErrorCodes, H3Index};
-use std::ffi::c_int;
+use crate::{
+    convert, delegate_inner, stats, H3Error, H3ErrorCodes, H3Index, H3_NULL,
+};
+use std::{ffi::c_int, ptr};
+
+/// Earth radius in kilometers using WGS84 authalic radius.
+pub const EARTH_RADIUS_KM: f64 = 6371.007180918475;
 
 /// Latitude/longitude in radians.
 #[repr(C)]
@@ -109,6 +114,307 @@ pub extern "C" fn greatCircleDistanceRads(
         .unwrap_or(f64::NAN)
 }
 
+/// Great circle distances in kilometers between an origin and an array of
+/// points, given as separate latitude and longitude arrays.
+///
+/// Distances to invalid coordinates are set to NaN and the batch carries on.
+///
+/// @param origin    the origin lat/lng pair (in radians)
+/// @param lats      the latitudes of the points (in radians)
+/// @param lngs      the longitudes of the points (in radians)
+/// @param numPoints the number of points
+/// @param out       the distances, one per point
+/// @return E_SUCCESS on success, E_LATLNG_DOMAIN if at least one coordinate
+///         was invalid.
+///
+/// # Safety
+///
+/// `lats`, `lngs` and `out` must points to an array of at least `numPoints`
+/// elements each.
+#[no_mangle]
+pub unsafe extern "C" fn greatCircleDistancesKm(
+    origin: Option<&LatLng>,
+    lats: *const f64,
+    lngs: *const f64,
+    numPoints: i64,
+    out: *mut f64,
+) -> H3Error {
+    let origin = *origin.expect("null pointer");
+    distance_matrix(
+        (ptr::from_ref(&origin.lat), ptr::from_ref(&origin.lng), 1),
+        (lats, lngs, numPoints),
+        out,
+        EARTH_RADIUS_KM,
+    )
+}
+
+/// Great circle distances in meters between an origin and an array of
+/// points, given as separate latitude and longitude arrays.
+///
+/// Distances to invalid coordinates are set to NaN and the batch carries on.
+///
+/// @param origin    the origin lat/lng pair (in radians)
+/// @param lats      the latitudes of the points (in radians)
+/// @param lngs      the longitudes of the points (in radians)
+/// @param numPoints the number of points
+/// @param out       the distances, one per point
+/// @return E_SUCCESS on success, E_LATLNG_DOMAIN if at least one coordinate
+///         was invalid.
+///
+/// # Safety
+///
+/// `lats`, `lngs` and `out` must points to an array of at least `numPoints`
+/// elements each.
+#[no_mangle]
+pub unsafe extern "C" fn greatCircleDistancesM(
+    origin: Option<&LatLng>,
+    lats: *const f64,
+    lngs: *const f64,
+    numPoints: i64,
+    out: *mut f64,
+) -> H3Error {
+    let origin = *origin.expect("null pointer");
+    distance_matrix(
+        (ptr::from_ref(&origin.lat), ptr::from_ref(&origin.lng), 1),
+        (lats, lngs, numPoints),
+        out,
+        EARTH_RADIUS_KM * 1000.,
+    )
+}
+
+/// Great circle distances in radians between an origin and an array of
+/// points, given as separate latitude and longitude arrays.
+///
+/// Distances to invalid coordinates are set to NaN and the batch carries on.
+///
+/// @param origin    the origin lat/lng pair (in radians)
+/// @param lats      the latitudes of the points (in radians)
+/// @param lngs      the longitudes of the points (in radians)
+/// @param numPoints the number of points
+/// @param out       the distances, one per point
+/// @return E_SUCCESS on success, E_LATLNG_DOMAIN if at least one coordinate
+///         was invalid.
+///
+/// # Safety
+///
+/// `lats`, `lngs` and `out` must points to an array of at least `numPoints`
+/// elements each.
+#[no_mangle]
+pub unsafe extern "C" fn greatCircleDistancesRads(
+    origin: Option<&LatLng>,
+    lats: *const f64,
+    lngs: *const f64,
+    numPoints: i64,
+    out: *mut f64,
+) -> H3Error {
+    let origin = *origin.expect("null pointer");
+    distance_matrix(
+        (ptr::from_ref(&origin.lat), ptr::from_ref(&origin.lng), 1),
+        (lats, lngs, numPoints),
+        out,
+        1.,
+    )
+}
+
+/// Great circle distances in kilometers between every origin and every point,
+/// given as separate latitude and longitude arrays.
+///
+/// The distance between the i-th origin and the j-th point is stored in
+/// `out[i * numPoints + j]`. Distances involving invalid coordinates are set
+/// to NaN and the batch carries on.
+///
+/// @param originLats  the latitudes of the origins (in radians)
+/// @param originLngs  the longitudes of the origins (in radians)
+/// @param numOrigins  the number of origins
+/// @param lats        the latitudes of the points (in radians)
+/// @param lngs        the longitudes of the points (in radians)
+/// @param numPoints   the number of points
+/// @param out         the distances, `numOrigins * numPoints` elements
+/// @return E_SUCCESS on success, E_LATLNG_DOMAIN if at least one coordinate
+///         was invalid.
+///
+/// # Safety
+///
+/// - `originLats` and `originLngs` must points to an array of at least
+///   `numOrigins` elements each.
+/// - `lats` and `lngs` must points to an array of at least `numPoints`
+///   elements each.
+/// - `out` must points to an array of at least `numOrigins * numPoints`
+///   elements.
+#[no_mangle]
+pub unsafe extern "C" fn greatCircleDistanceMatrixKm(
+    originLats: *const f64,
+    originLngs: *const f64,
+    numOrigins: i64,
+    lats: *const f64,
+    lngs: *const f64,
+    numPoints: i64,
+    out: *mut f64,
+) -> H3Error {
+    distance_matrix(
+        (originLats, originLngs, numOrigins),
+        (lats, lngs, numPoints),
+        out,
+        EARTH_RADIUS_KM,
+    )
+}
+
+/// Great circle distances in meters between every origin and every point,
+/// given as separate latitude and longitude arrays.
+///
+/// The distance between the i-th origin and the j-th point is stored in
+/// `out[i * numPoints + j]`. Distances involving invalid coordinates are set
+/// to NaN and the batch carries on.
+///
+/// @param originLats  the latitudes of the origins (in radians)
+/// @param originLngs  the longitudes of the origins (in radians)
+/// @param numOrigins  the number of origins
+/// @param lats        the latitudes of the points (in radians)
+/// @param lngs        the longitudes of the points (in radians)
+/// @param numPoints   the number of points
+/// @param out         the distances, `numOrigins * numPoints` elements
+/// @return E_SUCCESS on success, E_LATLNG_DOMAIN if at least one coordinate
+///         was invalid.
+///
+/// # Safety
+///
+/// - `originLats` and `originLngs` must points to an array of at least
+///   `numOrigins` elements each.
+/// - `lats` and `lngs` must points to an array of at least `numPoints`
+///   elements each.
+/// - `out` must points to an array of at least `numOrigins * numPoints`
+///   elements.
+#[no_mangle]
+pub unsafe extern "C" fn greatCircleDistanceMatrixM(
+    originLats: *const f64,
+    originLngs: *const f64,
+    numOrigins: i64,
+    lats: *const f64,
+    lngs: *const f64,
+    numPoints: i64,
+    out: *mut f64,
+) -> H3Error {
+    distance_matrix(
+        (originLats, originLngs, numOrigins),
+        (lats, lngs, numPoints),
+        out,
+        EARTH_RADIUS_KM * 1000.,
+    )
+}
+
+/// Great circle distances in radians between every origin and every point,
+/// given as separate latitude and longitude arrays.
+///
+/// The distance between the i-th origin and the j-th point is stored in
+/// `out[i * numPoints + j]`. Distances involving invalid coordinates are set
+/// to NaN and the batch carries on.
+///
+/// @param originLats  the latitudes of the origins (in radians)
+/// @param originLngs  the longitudes of the origins (in radians)
+/// @param numOrigins  the number of origins
+/// @param lats        the latitudes of the points (in radians)
+/// @param lngs        the longitudes of the points (in radians)
+/// @param numPoints   the number of points
+/// @param out         the distances, `numOrigins * numPoints` elements
+/// @return E_SUCCESS on success, E_LATLNG_DOMAIN if at least one coordinate
+///         was invalid.
+///
+/// # Safety
+///
+/// - `originLats` and `originLngs` must points to an array of at least
+///   `numOrigins` elements each.
+/// - `lats` and `lngs` must points to an array of at least `numPoints`
+///   elements each.
+/// - `out` must points to an array of at least `numOrigins * numPoints`
+///   elements.
+#[no_mangle]
+pub unsafe extern "C" fn greatCircleDistanceMatrixRads(
+    originLats: *const f64,
+    originLngs: *const f64,
+    numOrigins: i64,
+    lats: *const f64,
+    lngs: *const f64,
+    numPoints: i64,
+    out: *mut f64,
+) -> H3Error {
+    distance_matrix(
+        (originLats, originLngs, numOrigins),
+        (lats, lngs, numPoints),
+        out,
+        1.,
+    )
+}
+
+/// Coordinates given as separate latitude and longitude arrays, with their
+/// length.
+type Coords = (*const f64, *const f64, i64);
+
+/// Computes the distance matrix between the origins and the points, scaled
+/// from radians by `scale`.
+///
+/// The validation is folded into the computation (non-finite coordinates
+/// yield NaN through the haversine formula), so that the inner loop over the
+/// points stays free of branches.
+unsafe fn distance_matrix(
+    origins: Coords,
+    points: Coords,
+    out: *mut f64,
+    scale: f64,
+) -> H3Error {
+    let (Ok(rows), Ok(cols)) =
+        (usize::try_from(origins.2), usize::try_from(points.2))
+    else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let Some(len) = rows.checked_mul(cols) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let origin_lats = std::slice::from_raw_parts(origins.0, rows);
+    let origin_lngs = std::slice::from_raw_parts(origins.1, rows);
+    let lats = std::slice::from_raw_parts(points.0, cols);
+    let lngs = std::slice::from_raw_parts(points.1, cols);
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    let is_valid = |lat: f64, lng: f64| lat.is_finite() && lng.is_finite();
+    let mut valid =
+        lats.iter().zip(lngs).all(|(&lat, &lng)| is_valid(lat, lng));
+    let origins = origin_lats.iter().copied().zip(origin_lngs.iter().copied());
+    for ((lat1, lng1), row) in origins.zip(out.chunks_exact_mut(cols)) {
+        valid &= is_valid(lat1, lng1);
+        // Hoisted out of the loop over the points.
+        let cos_lat1 = lat1.cos();
+        let points = lats.iter().copied().zip(lngs.iter().copied());
+        for (dst, (lat2, lng2)) in row.iter_mut().zip(points) {
+            *dst = haversine(lat1, lng1, cos_lat1, lat2, lng2) * scale;
+        }
+    }
+
+    if valid {
+        H3ErrorCodes::ESuccess.into()
+    } else {
+        H3ErrorCodes::ELatlngDomain.into()
+    }
+}
+
+/// Great circle distance (in radians) between two points, using the haversine
+/// formula, with the cosine of the first latitude precomputed.
+pub fn haversine(
+    lat1: f64,
+    lng1: f64,
+    cos_lat1: f64,
+    lat2: f64,
+    lng2: f64,
+) -> f64 {
+    let sin_lat = ((lat2 - lat1) / 2.).sin();
+    let sin_lng = ((lng2 - lng1) / 2.).sin();
+    let a =
+        (cos_lat1 * lat2.cos()).mul_add(sin_lng * sin_lng, sin_lat * sin_lat);
+    2. * a.sqrt().atan2((1. - a).sqrt())
+}
+
 /// Encodes a coordinate on the sphere to the H3 index of the containing cell at
 /// the specified resolution.
 ///
@@ -130,5 +436,325 @@ pub extern "C" fn latLngToCell(
         Ok(ll.to_cell(res).into())
     }
 
+    let _scope = stats::Scope::new(stats::Function::LatLngToCell, 1);
     delegate_inner!(inner(*g.expect("null pointer"), res), out)
 }
+
+/// Encodes an array of coordinates on the sphere to the H3 indexes of the
+/// containing cells at the specified resolution.
+///
+/// The resolution is validated once for the whole batch. An invalid coordinate
+/// doesn't stop the batch: its output is set to H3_NULL, the error is reported
+/// at the same offset in `errs` and the first one is returned once every
+/// coordinate has been encoded.
+///
+/// @param coords    The spherical coordinates to encode.
+/// @param numCoords Number of coordinates in `coords`.
+/// @param res       The desired H3 resolution for the encoding.
+/// @param out       The encoded H3Index, one per coordinate.
+/// @param errs      NULL or the per-coordinate error codes.
+/// @returns E_SUCCESS (0) on success, the error of `res` or of the first
+///          invalid coordinate otherwise.
+///
+/// # Safety
+///
+/// `coords`, `out` and `errs` (if not NULL) must points to an array of at
+/// least `numCoords` elements each.
+#[no_mangle]
+pub unsafe extern "C" fn latLngsToCells(
+    coords: *const LatLng,
+    numCoords: i64,
+    res: c_int,
+    out: *mut H3Index,
+    errs: *mut H3Error,
+) -> H3Error {
+    let _scope = stats::Scope::new(stats::Function::LatLngsToCells, numCoords);
+    encode_batch(numCoords, res, out, errs, |i| {
+        h3o::LatLng::try_from(*coords.add(i))
+    })
+}
+
+/// Single-precision version of latLngsToCells, with the coordinates in
+/// degrees given as separate latitude and longitude arrays.
+///
+/// The coordinates are widened while being encoded, without any temporary
+/// array, and the widening is exact: the cells are the ones latLngToCell
+/// returns for the same values in double precision. What's lost is upstream:
+/// a float resolves a longitude to about 1.7 m (its spacing around 180
+/// degrees), which is finer than the cells up to resolution 12 (~9 m edges),
+/// though points closer to a cell edge than that may end up in its neighbor
+/// instead of the cell of the original measurement. Beyond resolution 12, use
+/// the double-precision or microdegree versions.
+///
+/// @param lats      The latitudes of the coordinates, in degrees.
+/// @param lngs      The longitudes of the coordinates, in degrees.
+/// @param numCoords Number of coordinates.
+/// @param res       The desired H3 resolution for the encoding.
+/// @param out       The encoded H3Index, one per coordinate.
+/// @param errs      NULL or the per-coordinate error codes.
+/// @returns E_SUCCESS (0) on success, the error of `res` or of the first
+///          invalid coordinate otherwise.
+///
+/// # Safety
+///
+/// `lats`, `lngs`, `out` and `errs` (if not NULL) must points to an array of
+/// at least `numCoords` elements each.
+#[no_mangle]
+pub unsafe extern "C" fn latLngsToCellsDegreesF32(
+    lats: *const f32,
+    lngs: *const f32,
+    numCoords: i64,
+    res: c_int,
+    out: *mut H3Index,
+    errs: *mut H3Error,
+) -> H3Error {
+    let _scope =
+        stats::Scope::new(stats::Function::LatLngsToCellsDegreesF32, numCoords);
+    encode_batch(numCoords, res, out, errs, |i| {
+        let (lat, lng) = (f64::from(*lats.add(i)), f64::from(*lngs.add(i)));
+        Ok(h3o::LatLng::new(lat, lng)?)
+    })
+}
+
+/// Integer version of latLngsToCells, with the coordinates in microdegrees
+/// (millionths of degree) given as separate latitude and longitude arrays.
+///
+/// The coordinates are converted while being encoded, without any temporary
+/// array, within a rounding error (a few nanometers) of the conversion to
+/// double-precision degrees. A microdegree is about 0.11 m, finer than the
+/// cells of every resolution (~0.5 m edges at resolution 15), though points
+/// closer to a cell edge than that may end up in its neighbor instead of the
+/// cell of the original measurement.
+///
+/// @param lats      The latitudes of the coordinates, in microdegrees.
+/// @param lngs      The longitudes of the coordinates, in microdegrees.
+/// @param numCoords Number of coordinates.
+/// @param res       The desired H3 resolution for the encoding.
+/// @param out       The encoded H3Index, one per coordinate.
+/// @param errs      NULL or the per-coordinate error codes.
+/// @returns E_SUCCESS (0) on success, the error of `res` or of the first
+///          invalid coordinate otherwise.
+///
+/// # Safety
+///
+/// `lats`, `lngs`, `out` and `errs` (if not NULL) must points to an array of
+/// at least `numCoords` elements each.
+#[no_mangle]
+pub unsafe extern "C" fn latLngsToCellsMicrodegrees(
+    lats: *const i32,
+    lngs: *const i32,
+    numCoords: i64,
+    res: c_int,
+    out: *mut H3Index,
+    errs: *mut H3Error,
+) -> H3Error {
+    let _scope = stats::Scope::new(
+        stats::Function::LatLngsToCellsMicrodegrees,
+        numCoords,
+    );
+    encode_batch(numCoords, res, out, errs, |i| {
+        let lat = f64::from(*lats.add(i)) * MICRODEGREE;
+        let lng = f64::from(*lngs.add(i)) * MICRODEGREE;
+        Ok(h3o::LatLng::new(lat, lng)?)
+    })
+}
+
+/// Encodes a coordinate to the cells containing it at several resolutions.
+///
+/// The coordinate is projected once, at the finest requested resolution, and
+/// the coarser cells are its ancestors (as cellToParent), which only takes a
+/// few bit operations.
+///
+/// The coarser cells are therefore the hierarchy ancestors of the finest one,
+/// which can differ from latLngToCell near the cell edges: children don't
+/// exactly tile their parent, so a coordinate near the edge of a cell may be
+/// in a child of its neighbor.
+///
+/// @param g       The spherical coordinates to encode.
+/// @param resMask The requested resolutions, as a bit mask (bit `r` requests
+///                resolution `r`).
+/// @param out     The cells, one per requested resolution from the coarsest
+///                (as many as the bits set in `resMask`).
+/// @returns E_RES_DOMAIN if `resMask` has bits above resolution 15,
+/// E_LATLNG_DOMAIN if the coordinate is invalid, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `out` must points to an array with an element per bit set in `resMask`.
+#[no_mangle]
+pub unsafe extern "C" fn latLngToCellsMultiRes(
+    g: Option<&LatLng>,
+    resMask: u32,
+    out: *mut H3Index,
+) -> H3Error {
+    let resolutions = match mask_to_resolutions(resMask) {
+        Ok(resolutions) => resolutions,
+        Err(err) => return err,
+    };
+    let Some(&finest) = resolutions.last() else {
+        return H3ErrorCodes::ESuccess.into();
+    };
+    let out = std::slice::from_raw_parts_mut(out, resolutions.len());
+    match h3o::LatLng::try_from(*g.expect("null pointer")) {
+        Ok(ll) => {
+            encode_multi_res(ll, &resolutions, finest, out);
+            H3ErrorCodes::ESuccess.into()
+        }
+        Err(err) => err,
+    }
+}
+
+/// Batch version of latLngToCellsMultiRes.
+///
+/// An invalid coordinate doesn't stop the batch: its cells are set to H3_NULL,
+/// the error is reported at the same offset in `errs` and the first one is
+/// returned once every coordinate has been encoded.
+///
+/// @param coords    The spherical coordinates to encode.
+/// @param numCoords Number of coordinates in `coords`.
+/// @param resMask   The requested resolutions, as a bit mask (bit `r`
+///                  requests resolution `r`).
+/// @param out       The cells of every coordinate, one per requested
+///                  resolution from the coarsest: the cells of `coords[i]`
+///                  start at `out[i * n]`, `n` being the number of bits set in
+///                  `resMask`.
+/// @param errs      NULL or the per-coordinate error codes.
+/// @returns E_SUCCESS (0) on success, E_RES_DOMAIN if `resMask` has bits above
+/// resolution 15, the error of the first invalid coordinate otherwise.
+///
+/// # Safety
+///
+/// `coords` and `errs` (if not NULL) must points to an array of at least
+/// `numCoords` elements each, `out` to an array of at least `numCoords * n`
+/// elements.
+#[no_mangle]
+pub unsafe extern "C" fn latLngsToCellsMultiRes(
+    coords: *const LatLng,
+    numCoords: i64,
+    resMask: u32,
+    out: *mut H3Index,
+    errs: *mut H3Error,
+) -> H3Error {
+    let _scope =
+        stats::Scope::new(stats::Function::LatLngsToCellsMultiRes, numCoords);
+    let resolutions = match mask_to_resolutions(resMask) {
+        Ok(resolutions) => resolutions,
+        Err(err) => return err,
+    };
+    let Ok(len) = usize::try_from(numCoords) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let Some(&finest) = resolutions.last() else {
+        return H3ErrorCodes::ESuccess.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    let coords = std::slice::from_raw_parts(coords, len);
+    let rows = std::slice::from_raw_parts_mut(out, len * resolutions.len())
+        .chunks_exact_mut(resolutions.len());
+    let mut errs = (!errs.is_null())
+        .then(|| std::slice::from_raw_parts_mut(errs, len).iter_mut());
+    let mut first_err = None;
+    for (row, &coord) in rows.zip(coords) {
+        let err = match h3o::LatLng::try_from(coord) {
+            Ok(ll) => {
+                encode_multi_res(ll, &resolutions, finest, row);
+                H3ErrorCodes::ESuccess.into()
+            }
+            Err(err) => {
+                row.fill(H3_NULL);
+                first_err.get_or_insert(err);
+                err
+            }
+        };
+        if let Some(dst) = errs.as_mut().and_then(Iterator::next) {
+            *dst = err;
+        }
+    }
+
+    first_err.unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+// -----------------------------------------------------------------------------
+
+/// A microdegree, in degrees.
+const MICRODEGREE: f64 = 1e-6;
+
+/// Shared implementation of the batch encodings: `coord` reads and converts
+/// the coordinate at an offset.
+///
+/// # Safety
+///
+/// `coord` must be callable on every offset below `numCoords`, `out` and
+/// `errs` (if not NULL) must points to an array of at least `numCoords`
+/// elements each.
+unsafe fn encode_batch(
+    numCoords: i64,
+    res: c_int,
+    out: *mut H3Index,
+    errs: *mut H3Error,
+    coord: impl Fn(usize) -> Result<h3o::LatLng, H3Error>,
+) -> H3Error {
+    let res = match convert::h3res_to_resolution(res) {
+        Ok(res) => res,
+        Err(err) => return err.into(),
+    };
+    let Ok(len) = usize::try_from(numCoords) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    let encode = |i| coord(i).map(|ll| H3Index::from(ll.to_cell(res)));
+    let cells = std::slice::from_raw_parts_mut(out, len);
+    let mut first_err = None;
+    if errs.is_null() {
+        for (i, cell) in cells.iter_mut().enumerate() {
+            *cell = encode(i).unwrap_or_else(|e| {
+                first_err.get_or_insert(e);
+                H3_NULL
+            });
+        }
+    } else {
+        let errs = std::slice::from_raw_parts_mut(errs, len);
+        for (i, (cell, err)) in cells.iter_mut().zip(errs).enumerate() {
+            (*cell, *err) = match encode(i) {
+                Ok(index) => (index, H3ErrorCodes::ESuccess.into()),
+                Err(e) => {
+                    first_err.get_or_insert(e);
+                    (H3_NULL, e)
+                }
+            };
+        }
+    }
+
+    first_err.unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// Returns the resolutions of a bit mask, from the coarsest.
+fn mask_to_resolutions(mask: u32) -> Result<Vec<h3o::Resolution>, H3Error> {
+    if mask >> 16 != 0 {
+        return Err(H3ErrorCodes::EResDomain.into());
+    }
+    Ok((0..16_u8)
+        .filter(|&res| mask & (1 << res) != 0)
+        .map(|res| h3o::Resolution::try_from(res).expect("valid resolution"))
+        .collect())
+}
+
+/// Encodes a coordinate at `finest`, and derives its ancestors at the other
+/// resolutions.
+fn encode_multi_res(
+    ll: h3o::LatLng,
+    resolutions: &[h3o::Resolution],
+    finest: h3o::Resolution,
+    out: &mut [H3Index],
+) {
+    let cell = ll.to_cell(finest);
+    for (dst, &res) in out.iter_mut().zip(resolutions) {
+        *dst = cell.parent(res).expect("coarser resolution").into();
+    }
+}
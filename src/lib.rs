@@ -120,18 +120,45 @@
 use h3o::{CellIndex, DirectedEdgeIndex, VertexIndex};
 use std::ffi::{c_char, CStr};
 
+mod aggregate;
+mod alloc;
+mod area;
+mod bbox;
+mod binary;
+mod bitmap;
 mod boundary;
+mod cache;
+mod cancel;
 mod cell;
+mod cellset;
 mod compact;
+mod config;
 mod convert;
+mod cpu;
 mod directed_edge;
 mod error;
+mod fence;
 mod geom;
+mod graph;
 mod grid;
+mod hex;
+mod join;
 mod latlng;
 mod localij;
+mod nearest;
+mod outline;
+mod pages;
+mod parallel;
+mod polycache;
+mod polyfill;
 mod resolution;
+mod sort;
+mod stats;
+mod stream;
+mod swap;
 mod vertex;
+mod visit;
+mod workspace;
 
 // TODO: find why cbindgen can't generate #define for those...
 // pub const H3O_VERSION_MAJOR: u8 = h3o::VERSION_MAJOR;
@@ -142,42 +169,150 @@ pub const H3O_VERSION_MAJOR: u8 = 0;
 pub const H3O_VERSION_MINOR: u8 = 3;
 pub const H3O_VERSION_PATCH: u8 = 0;
 
+pub use aggregate::{aggregateCellsToParents, AggregateReducer};
+pub use alloc::{h3SetAllocator, H3Calloc, H3Free, H3Malloc, H3Realloc};
+pub use bbox::{cellsToBBox, cellsToBBoxes, BBox};
+pub use binary::{binaryToCells, binaryToCellsSize, cellsToBinary};
+pub use bitmap::{
+    cellBitmapContains, cellBitmapIntersection, cellBitmapSize,
+    cellBitmapToCells, cellBitmapUnion, createCellBitmap, destroyCellBitmap,
+    H3CellBitmap,
+};
 pub use boundary::{CellBoundary, MAX_CELL_BNDRY_VERTS};
+pub use cache::{h3GetCacheStats, h3ResetCacheStats};
+pub use cancel::{
+    createCancelToken, destroyCancelToken, triggerCancelToken, H3CancelToken,
+};
 pub use cell::{
-    cellAreaKm2, cellAreaM2, cellAreaRads2, cellToBoundary, cellToCenterChild,
-    cellToChildPos, cellToChildren, cellToChildrenSize, cellToLatLng,
-    cellToParent, childPosToCell, getBaseCellNumber, getIcosahedronFaces,
-    getResolution, isPentagon, isValidCell, maxFaceCount,
+    areValidCells, cellAreaKm2, cellAreaM2, cellAreaRads2, cellToBoundary,
+    cellToCenterChild, cellToChildPos, cellToChildren, cellToChildrenForEach,
+    cellToChildrenInit, cellToChildrenNext, cellToChildrenSize, cellToLatLng,
+    cellToParent, cellsAreaKm2, cellsAreaM2, cellsAreaRads2, cellsToBoundaries,
+    cellsToCenterChildren, cellsToChildPos, cellsToChildrenCSR,
+    cellsToChildrenSize, cellsToLatLngs, cellsToParents, childPosRangeToCells,
+    childPosToCell, destroyChildrenCursor, getBaseCellNumber,
+    getIcosahedronFaceMasks, getIcosahedronFaces, getResolution,
+    getResolutionCells, getResolutionPartitionStart, isPentagon, isValidCell,
+    maxFaceCount, H3ChildrenCursor,
+};
+pub use cellset::{
+    cellSetContains, cellSetContainsCells, createCellSet, destroyCellSet,
+    openMappedCellSet, writeCellSetFile, H3CellSet,
+};
+pub use compact::{
+    compactCells, compactCellsDifference, compactCellsInPlace,
+    compactCellsIntersection, compactCellsUnion, compactCellsWs,
+    compactSortedCells, compactorFinish, compactorPush, createCompactor,
+    destroyCompactor, uncompactCells, uncompactCellsParallel,
+    uncompactCellsSize, uncompactCellsSorted, H3Compactor,
+    H3_COMPACTOR_MAX_PENDING,
+};
+pub use config::{
+    h3SetCacheCapacity, h3SetCpuFeatures, h3SetExecutor, h3SetHugePages,
+    h3SetStatsEnabled, h3SetThreadPool, h3SetTrustedInput, H3Executor, H3Task,
 };
-pub use compact::{compactCells, uncompactCells, uncompactCellsSize};
+pub use cpu::{h3GetCpuFeatures, H3_CPU_AVX2, H3_CPU_AVX512};
 pub use directed_edge::{
-    areNeighborCells, cellsToDirectedEdge, directedEdgeToBoundary,
-    directedEdgeToCells, edgeLengthKm, edgeLengthM, edgeLengthRads,
+    areNeighborCellPairs, areNeighborCells, areValidDirectedEdges,
+    cellPairsToDirectedEdges, cellsToDirectedEdge, directedEdgeToBoundary,
+    directedEdgeToCells, directedEdgesToBoundaries, edgeLengthKm, edgeLengthM,
+    edgeLengthRads, edgesLengthKm, edgesLengthM, edgesLengthRads,
     getDirectedEdgeDestination, getDirectedEdgeOrigin, isValidDirectedEdge,
-    originToDirectedEdges,
+    originToDirectedEdges, originsToDirectedEdges,
 };
 pub use error::{H3Error, H3ErrorCodes};
+pub use fence::{
+    createFenceIndex, destroyFenceIndex, latLngsToFenceIds, H3FenceIndex,
+};
 pub use geom::{
-    cellsToLinkedMultiPolygon, destroyLinkedMultiPolygon,
-    maxPolygonToCellsSize, polygonToCells, GeoLoop, GeoMultiPolygon,
-    GeoPolygon, LinkedGeoLoop, LinkedGeoPolygon, LinkedLatLng,
+    cellsToFlatMultiPolygon, cellsToLinkedMultiPolygon,
+    cellsToLinkedMultiPolygonCancellable, cellsToLinkedMultiPolygonParallel,
+    compactedCellsToLinkedMultiPolygon, destroyFlatMultiPolygon,
+    destroyLinkedMultiPolygon, destroyPolygonCursor, destroyPreparedPolygon,
+    maxMultiPolygonToCellsSize, maxPolygonToCellsSize,
+    maxPolygonToCellsSizeTight, maxPolygonToCellsSizeWs,
+    maxPreparedPolygonToCellsSize, multiPolygonToCells, polygonToCells,
+    polygonToCellsCancellable, polygonToCellsExactSize, polygonToCellsForEach,
+    polygonToCellsInit, polygonToCellsNext, polygonToCellsParallel,
+    polygonToCellsSorted, polygonToCellsWs, polygonToCompactCells,
+    preparePolygon, preparedPolygonContains, preparedPolygonToCells,
+    ContainmentMode, FlatMultiPolygon, GeoLoop, GeoMultiPolygon, GeoPolygon,
+    LinkedGeoLoop, LinkedGeoPolygon, LinkedLatLng,
 };
+pub use graph::{cellsToAdjacencyCSR, cellsToAdjacencyCSRParallel};
 pub use grid::{
-    gridDisk, gridDiskDistances, gridDiskDistancesSafe,
-    gridDiskDistancesUnsafe, gridDiskUnsafe, gridDisksUnsafe, gridDistance,
-    gridPathCells, gridPathCellsSize, gridRingUnsafe, maxGridDiskSize,
+    destroySpiralCursor, gridDisk, gridDiskCompact, gridDiskDistances,
+    gridDiskDistancesSafe, gridDiskDistancesUnsafe, gridDiskForEach,
+    gridDiskSpiralInit, gridDiskSpiralNext, gridDiskUnsafe, gridDisksDistances,
+    gridDisksParallel, gridDisksUnion, gridDisksUnsafe, gridDistance,
+    gridDistancesFromOrigin, gridPathCells, gridPathCellsSize, gridPathsCells,
+    gridPathsCellsParallel, gridRing, gridRingUnsafe, maxGridDiskSize,
+    maxGridRingSize, H3SpiralCursor,
+};
+pub use hex::{
+    h3sToLengthPrefixedStrings, h3sToStrings, lengthPrefixedStringsToH3,
+    stringsToH3,
+};
+pub use join::{
+    createZoneIndex, destroyZoneIndex, latLngsToZoneIds,
+    latLngsToZoneIdsParallel, H3ZoneIndex,
 };
 pub use latlng::{
-    greatCircleDistanceKm, greatCircleDistanceM, greatCircleDistanceRads,
-    latLngToCell, LatLng,
+    greatCircleDistanceKm, greatCircleDistanceM, greatCircleDistanceMatrixKm,
+    greatCircleDistanceMatrixM, greatCircleDistanceMatrixRads,
+    greatCircleDistanceRads, greatCircleDistancesKm, greatCircleDistancesM,
+    greatCircleDistancesRads, latLngToCell, latLngToCellsMultiRes,
+    latLngsToCells, latLngsToCellsDegreesF32, latLngsToCellsMicrodegrees,
+    latLngsToCellsMultiRes, LatLng,
+};
+pub use localij::{
+    cellToLocalIj, cellsToLocalIj, cellsToLocalIjRaster, localIjRasterToCells,
+    localIjToCell, localIjsToCells, CoordIJ, LocalIjExtent,
 };
-pub use localij::{cellToLocalIj, localIjToCell, CoordIJ};
+pub use nearest::latLngToNearestCells;
+pub use outline::{
+    cellsToVertexGraph, createOutline, destroyOutline, outlineAddCells,
+    outlineRemoveCells, outlineToLinkedMultiPolygon, H3Outline,
+};
+pub use pages::{
+    cellBufferCells, createCellBuffer, destroyCellBuffer, H3CellBuffer,
+};
+pub use polycache::{
+    createPolygonCache, destroyPolygonCache, polygonCacheStats,
+    polygonToCellsCached, polygonToCompactCellsCached, H3PolygonCache,
+};
+pub use polyfill::{H3PolygonCursor, H3PreparedPolygon};
 pub use resolution::{
     getHexagonAreaAvgKm2, getHexagonAreaAvgM2, getHexagonEdgeLengthAvgKm,
     getHexagonEdgeLengthAvgM, getNumCells, getPentagons, getRes0Cells,
-    isResClassIII, pentagonCount, res0CellCount,
+    getResolutionStats, isPentagonNeighbor, isResClassIII, pentagonCount,
+    res0CellCount, H3ResolutionStats, H3_NUM_CELLS, H3_PENTAGONS,
+    H3_PENTAGON_COUNT, H3_RES0_CELLS, H3_RES0_CELL_COUNT, H3_RES_COUNT,
+};
+pub use sort::{h3SortCells, h3SortCellsByLocality, h3SortCellsParallel};
+pub use stats::{
+    h3GetStats, h3ResetStats, H3FunctionStats, H3PathStats, H3Stats,
+    H3_STATS_BUCKETS, H3_STATS_FUNCTIONS, H3_STATS_PATHS,
 };
-pub use vertex::{cellToVertex, cellToVertexes, isValidVertex, vertexToLatLng};
+pub use stream::{
+    cellReaderNext, cellReaderRewind, cellWriterWrite, closeCellWriter,
+    createCellWriter, destroyCellReader, openCellReader, H3CellReader,
+    H3CellWriter,
+};
+pub use swap::{
+    createIndexHandle, destroyIndexHandle, h3IndexAcquire, h3IndexRelease,
+    h3IndexSwap, H3IndexGuard, H3IndexHandle, IndexKind,
+};
+pub use vertex::{
+    areValidVertexes, cellToVertex, cellToVertexes, cellsToUniqueVertexes,
+    isValidVertex, vertexToLatLng, vertexesToLatLngs,
+};
+pub use visit::{H3CellVisitor, H3_VISIT_BATCH_SIZE};
+pub use workspace::{createWorkspace, destroyWorkspace, H3Workspace};
+
+/// Every allocation goes through the hooks set with `h3SetAllocator`.
+#[global_allocator]
+static ALLOCATOR: alloc::Allocator = alloc::Allocator;
 
 // -----------------------------------------------------------------------------
 
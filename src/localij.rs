@@ -1,4 +1,4 @@
-use crate::{delegate_inner, H3Error, H3ErrorCodes, H3Index};
+use crate::{delegate_inner, H3Error, H3ErrorCodes, H3Index, H3_NULL};
 use h3o::CellIndex;
 use std::ffi::c_int;
 
@@ -98,3 +98,355 @@ pub extern "C" fn localIjToCell(
 
     delegate_inner!(inner(origin, *ij.expect("null pointer"), mode), out)
 }
+
+/// Batch version of cellToLocalIj, for many indexes anchored by the same
+/// origin.
+///
+/// The origin and the mode are validated once for the whole batch. An index
+/// that cannot be converted doesn't stop the batch: its coordinates are set
+/// to (0, 0) and its error is reported at the same offset in `errs`.
+///
+/// @param origin   An anchoring index for the ij coordinate system.
+/// @param cells    Indexes to find the coordinates of.
+/// @param numCells Number of indexes.
+/// @param mode     Mode, must be 0
+/// @param out      ij coordinates of the indexes, one per index.
+/// @param errs     NULL or the per-index error codes.
+/// @return 0 on success, or the error of the first index that failed.
+///
+/// # Safety
+///
+/// `cells`, `out` and `errs` (if not NULL) must points to an array of at least
+/// `numCells` elements each.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToLocalIj(
+    origin: H3Index,
+    cells: *const H3Index,
+    numCells: i64,
+    mode: u32,
+    out: *mut CoordIJ,
+    errs: *mut H3Error,
+) -> H3Error {
+    fn convert(origin: CellIndex, h3: H3Index) -> Result<CoordIJ, H3Error> {
+        let localij = CellIndex::try_from(h3)?.to_local_ij(origin)?;
+        Ok(CoordIJ {
+            i: localij.i(),
+            j: localij.j(),
+        })
+    }
+
+    let origin = match validate_origin(origin, mode) {
+        Ok(origin) => origin,
+        Err(err) => return err,
+    };
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    let cells = std::slice::from_raw_parts(cells, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
+    let mut errs =
+        (!errs.is_null()).then(|| std::slice::from_raw_parts_mut(errs, len));
+    let mut first_error = None;
+    for (i, (dst, &cell)) in out.iter_mut().zip(cells).enumerate() {
+        let err = match convert(origin, cell) {
+            Ok(coord) => {
+                *dst = coord;
+                H3ErrorCodes::ESuccess.into()
+            }
+            Err(err) => {
+                *dst = CoordIJ { i: 0, j: 0 };
+                first_error = first_error.or(Some(err));
+                err
+            }
+        };
+        if let Some(errs) = errs.as_mut() {
+            errs[i] = err;
+        }
+    }
+
+    first_error.unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// Batch version of localIjToCell, for many coordinates anchored by the same
+/// origin.
+///
+/// The origin and the mode are validated once for the whole batch. A
+/// coordinate that cannot be converted doesn't stop the batch: its index is
+/// set to H3_NULL and its error is reported at the same offset in `errs`.
+///
+/// @param origin    An anchoring index for the ij coordinate system.
+/// @param coords    ij coordinates to index.
+/// @param numCoords Number of coordinates.
+/// @param mode      Mode, must be 0
+/// @param out       Indexes of the coordinates, one per coordinate.
+/// @param errs      NULL or the per-coordinate error codes.
+/// @return 0 on success, or the error of the first coordinate that failed.
+///
+/// # Safety
+///
+/// `coords`, `out` and `errs` (if not NULL) must points to an array of at
+/// least `numCoords` elements each.
+#[no_mangle]
+pub unsafe extern "C" fn localIjsToCells(
+    origin: H3Index,
+    coords: *const CoordIJ,
+    numCoords: i64,
+    mode: u32,
+    out: *mut H3Index,
+    errs: *mut H3Error,
+) -> H3Error {
+    let origin = match validate_origin(origin, mode) {
+        Ok(origin) => origin,
+        Err(err) => return err,
+    };
+    let Ok(len) = usize::try_from(numCoords) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+
+    let coords = std::slice::from_raw_parts(coords, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
+    let mut errs =
+        (!errs.is_null()).then(|| std::slice::from_raw_parts_mut(errs, len));
+    let mut first_error = None;
+    for (i, (dst, ij)) in out.iter_mut().zip(coords).enumerate() {
+        let localij = h3o::LocalIJ::new_unchecked(origin, ij.i, ij.j);
+        let err = match CellIndex::try_from(localij) {
+            Ok(cell) => {
+                *dst = cell.into();
+                H3ErrorCodes::ESuccess.into()
+            }
+            Err(err) => {
+                let err = H3Error::from(err);
+                *dst = H3_NULL;
+                first_error = first_error.or(Some(err));
+                err
+            }
+        };
+        if let Some(errs) = errs.as_mut() {
+            errs[i] = err;
+        }
+    }
+
+    first_error.unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// Extent of a dense local IJ raster.
+///
+/// The pixel of the coordinates `(i, j)` is at
+/// `(j - jMin) * width + (i - iMin)` in the (row-major) raster.
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct LocalIjExtent {
+    /// Lowest i coordinate (first column).
+    pub iMin: c_int,
+    /// Lowest j coordinate (first row).
+    pub jMin: c_int,
+    /// Number of columns.
+    pub width: i64,
+    /// Number of rows.
+    pub height: i64,
+}
+
+impl LocalIjExtent {
+    /// Returns the number of pixels of the raster.
+    fn size(&self) -> Option<usize> {
+        let width = usize::try_from(self.width).ok()?;
+        let height = usize::try_from(self.height).ok()?;
+        width.checked_mul(height)
+    }
+}
+
+/// cellsToLocalIjRaster lays the values of cells out as a dense row-major
+/// raster, in the local IJ coordinates of an origin (see cellToLocalIj).
+///
+/// The raster covers the extent of the cells, which is returned in `extent`:
+/// pixels without a cell are set to `noData`, and a duplicated cell keeps its
+/// last value. If `raster` is too small, E_MEMORY_BOUNDS is returned but
+/// `extent` is still set, so that it gives the required size.
+///
+/// The origin and the mode are validated once for the whole raster. A cell
+/// that cannot be converted doesn't stop it: it's left out of the raster, and
+/// its error is returned once every cell has been placed.
+///
+/// @param origin    An anchoring index for the ij coordinate system.
+/// @param cells     The cells
+/// @param values    The value of every cell
+/// @param numCells  The number of cells
+/// @param mode      Mode, must be 0
+/// @param noData    The value of the pixels without a cell
+/// @param raster    Output raster
+/// @param maxRaster Size of the raster, to bound check against
+/// @param extent    Extent of the raster
+/// @return E_MEMORY_BOUNDS if the raster is too small, the error of the first
+/// cell that failed if any, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// - `cells` and `values` must points to an array of at least `numCells`
+///   elements each.
+/// - `raster` must points to an array of at least `maxRaster` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToLocalIjRaster(
+    origin: H3Index,
+    cells: *const H3Index,
+    values: *const f64,
+    numCells: i64,
+    mode: u32,
+    noData: f64,
+    raster: *mut f64,
+    maxRaster: i64,
+    extent: Option<&mut LocalIjExtent>,
+) -> H3Error {
+    let origin = match validate_origin(origin, mode) {
+        Ok(origin) => origin,
+        Err(err) => return err,
+    };
+    let (Ok(len), Ok(capacity)) =
+        (usize::try_from(numCells), usize::try_from(maxRaster))
+    else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let (cells, values) = if len == 0 {
+        (&[][..], &[][..])
+    } else {
+        (
+            std::slice::from_raw_parts(cells, len),
+            std::slice::from_raw_parts(values, len),
+        )
+    };
+
+    let mut first_error = None;
+    let mut pixels = Vec::with_capacity(len);
+    for (&cell, &value) in cells.iter().zip(values) {
+        match CellIndex::try_from(cell)
+            .map_err(H3Error::from)
+            .and_then(|cell| Ok(cell.to_local_ij(origin)?))
+        {
+            Ok(localij) => pixels.push((localij.i(), localij.j(), value)),
+            Err(err) => first_error = first_error.or(Some(err)),
+        }
+    }
+
+    let bounds = pixels.iter().fold(None, |bounds, &(i, j, _)| {
+        Some(bounds.map_or(
+            (i, i, j, j),
+            |(i_min, i_max, j_min, j_max): (c_int, c_int, c_int, c_int)| {
+                (i_min.min(i), i_max.max(i), j_min.min(j), j_max.max(j))
+            },
+        ))
+    });
+    let bounds = bounds.map_or(
+        LocalIjExtent {
+            iMin: 0,
+            jMin: 0,
+            width: 0,
+            height: 0,
+        },
+        |(i_min, i_max, j_min, j_max)| LocalIjExtent {
+            iMin: i_min,
+            jMin: j_min,
+            width: i64::from(i_max) - i64::from(i_min) + 1,
+            height: i64::from(j_max) - i64::from(j_min) + 1,
+        },
+    );
+    *extent.expect("null pointer") = bounds;
+    let Some(size) = bounds.size().filter(|&size| size <= capacity) else {
+        return H3ErrorCodes::EMemoryBounds.into();
+    };
+
+    if size != 0 {
+        let raster = std::slice::from_raw_parts_mut(raster, size);
+        raster.fill(noData);
+        let width = usize::try_from(bounds.width).expect("raster width");
+        let offset = |coord: c_int, min: c_int| {
+            usize::try_from(i64::from(coord) - i64::from(min))
+                .expect("coordinate in extent")
+        };
+        for (i, j, value) in pixels {
+            raster[offset(j, bounds.jMin) * width + offset(i, bounds.iMin)] =
+                value;
+        }
+    }
+    first_error.unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// localIjRasterToCells produces the cell of every pixel of a dense local IJ
+/// raster (see cellsToLocalIjRaster), in the same row-major order.
+///
+/// The origin and the mode are validated once for the whole raster. A pixel
+/// without a cell (too far from the origin, or in a region deleted by a
+/// pentagon) doesn't stop the raster: its cell is set to H3_NULL, and its
+/// error is returned once every pixel has been processed.
+///
+/// @param origin An anchoring index for the ij coordinate system.
+/// @param extent Extent of the raster
+/// @param mode   Mode, must be 0
+/// @param out    The cell of every pixel, `width * height` elements
+/// @return 0 on success, or the error of the first pixel that failed.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `width * height` elements.
+#[no_mangle]
+pub unsafe extern "C" fn localIjRasterToCells(
+    origin: H3Index,
+    extent: Option<&LocalIjExtent>,
+    mode: u32,
+    out: *mut H3Index,
+) -> H3Error {
+    let origin = match validate_origin(origin, mode) {
+        Ok(origin) => origin,
+        Err(err) => return err,
+    };
+    let extent = extent.expect("null pointer");
+    let Some(size) = extent.size() else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if size == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let (Ok(width), Ok(height)) = (
+        c_int::try_from(extent.width),
+        c_int::try_from(extent.height),
+    ) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    let (Some(i_end), Some(j_end)) = (
+        extent.iMin.checked_add(width),
+        extent.jMin.checked_add(height),
+    ) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+
+    let out = std::slice::from_raw_parts_mut(out, size);
+    let coords = (extent.jMin..j_end)
+        .flat_map(|j| (extent.iMin..i_end).map(move |i| (i, j)));
+    let mut first_error = None;
+    for (dst, (i, j)) in out.iter_mut().zip(coords) {
+        let localij = h3o::LocalIJ::new_unchecked(origin, i, j);
+        *dst = match CellIndex::try_from(localij) {
+            Ok(cell) => cell.into(),
+            Err(err) => {
+                let err = H3Error::from(err);
+                first_error = first_error.or(Some(err));
+                H3_NULL
+            }
+        };
+    }
+    first_error.unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// Validates the origin and the mode shared by a batch of conversions.
+fn validate_origin(origin: H3Index, mode: u32) -> Result<CellIndex, H3Error> {
+    if mode != 0 {
+        return Err(H3ErrorCodes::EDomain.into());
+    }
+    Ok(CellIndex::try_from(origin)?)
+}
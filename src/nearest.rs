@@ -0,0 +1,190 @@
+//! Nearest cells search, by great-circle distance.
+
+use crate::{
+    convert, delegate_inner, grid::Rings, latlng, H3CellSet, H3Error,
+    H3ErrorCodes, H3Index, LatLng,
+};
+use h3o::{CellIndex, Resolution};
+use std::{
+    cmp::Ordering,
+    collections::{BinaryHeap, HashSet},
+    ffi::c_int,
+};
+
+/// Safety margin applied on the radius of the origin cell, to account for the
+/// size variations of the cells around it.
+const RADIUS_MARGIN: f64 = 1.5;
+
+/// A candidate cell, ordered by distance (then by index, for determinism).
+struct Candidate {
+    distance: f64,
+    cell: CellIndex,
+}
+
+impl PartialEq for Candidate {
+    fn eq(&self, other: &Self) -> bool {
+        self.cmp(other) == Ordering::Equal
+    }
+}
+
+impl Eq for Candidate {}
+
+impl PartialOrd for Candidate {
+    fn partial_cmp(&self, other: &Self) -> Option<Ordering> {
+        Some(self.cmp(other))
+    }
+}
+
+impl Ord for Candidate {
+    fn cmp(&self, other: &Self) -> Ordering {
+        self.distance
+            .total_cmp(&other.distance)
+            .then(self.cell.cmp(&other.cell))
+    }
+}
+
+/// Finds the `k` cells (among those of `set`, if any) at `resolution` whose
+/// centers are the nearest to `point`, sorted by distance.
+///
+/// Rings are explored outward from the cell containing the point, each cell
+/// being measured once. Any cell beyond a ring is farther than the nearest
+/// cell of that ring, minus the radius of a cell, so the search stops as soon
+/// as this bound exceeds the distance of the k-th best candidate (or after
+/// `max_ring` rings).
+fn nearest_cells(
+    point: h3o::LatLng,
+    resolution: Resolution,
+    set: Option<&H3CellSet>,
+    k: usize,
+    max_ring: u32,
+) -> Vec<Candidate> {
+    let (lat, lng) = (point.lat_radians(), point.lng_radians());
+    let cos_lat = lat.cos();
+    let distance = |cell: CellIndex| {
+        let center = h3o::LatLng::from(cell);
+        latlng::haversine(
+            lat,
+            lng,
+            cos_lat,
+            center.lat_radians(),
+            center.lng_radians(),
+        )
+    };
+
+    let origin = point.to_cell(resolution);
+    let center = h3o::LatLng::from(origin);
+    let radius = origin
+        .boundary()
+        .iter()
+        .map(|vertex| center.distance_rads(*vertex))
+        .fold(0., f64::max)
+        * RADIUS_MARGIN;
+
+    // Measures the cell, keeping it if it's one of the best candidates.
+    let visit = |cell: CellIndex, best: &mut BinaryHeap<Candidate>| {
+        let distance = distance(cell);
+        if set.is_none_or(|set| set.contains(cell.into())) {
+            best.push(Candidate { distance, cell });
+            if best.len() > k {
+                best.pop();
+            }
+        }
+        distance
+    };
+
+    // Max-heap of the best candidates, the k-th best on top.
+    let mut best = BinaryHeap::with_capacity(k + 1);
+    let mut ring_min = visit(origin, &mut best);
+    let mut rings = Rings::new(HashSet::new(), vec![origin]);
+    for _ in 0..max_ring {
+        let worst = (best.len() == k)
+            .then(|| best.peek().map(|worst| worst.distance))
+            .flatten();
+        if worst.is_some_and(|worst| ring_min - radius > worst) {
+            break;
+        }
+        let ring = rings.advance();
+        if ring.is_empty() {
+            break;
+        }
+        ring_min = ring
+            .iter()
+            .map(|&cell| visit(cell, &mut best))
+            .fold(f64::INFINITY, f64::min);
+    }
+
+    best.into_sorted_vec()
+}
+
+// -----------------------------------------------------------------------------
+
+/// latLngToNearestCells finds the `k` cells at resolution `res` whose centers
+/// are the nearest (by great-circle distance) to a point.
+///
+/// If a set is given, only the cells it contains (i.e. the cells of the set
+/// and their descendants) are considered. The search explores the grid ring
+/// by ring around the point, and stops once no farther cell can beat the
+/// current best ones, or after `maxRing` rings.
+///
+/// @param point     The point to search around
+/// @param res       The resolution of the cells
+/// @param set       NULL, or the set of the candidate cells
+/// @param k         The number of cells to find
+/// @param maxRing   The maximum number of rings to explore
+/// @param out       The nearest cells, sorted by distance
+/// @param distances NULL, or the distances (in radians) of the cells
+/// @param count     The number of cells found (less than `k` if the explored
+///                  area doesn't contain enough candidates)
+/// @return 0 (E_SUCCESS) on success.
+///
+/// # Safety
+///
+/// `out` and `distances` (if not NULL) must points to an array of at least
+/// `k` elements each.
+#[no_mangle]
+pub unsafe extern "C" fn latLngToNearestCells(
+    point: Option<&LatLng>,
+    res: c_int,
+    set: Option<&H3CellSet>,
+    k: i64,
+    maxRing: c_int,
+    out: *mut H3Index,
+    distances: *mut f64,
+    count: Option<&mut i64>,
+) -> H3Error {
+    unsafe fn inner(
+        point: LatLng,
+        res: c_int,
+        set: Option<&H3CellSet>,
+        k: i64,
+        maxRing: c_int,
+        out: *mut H3Index,
+        distances: *mut f64,
+    ) -> Result<i64, H3Error> {
+        let resolution = convert::h3res_to_resolution(res)?;
+        let point = h3o::LatLng::try_from(point)?;
+        let k = usize::try_from(k).map_err(|_| H3ErrorCodes::EDomain)?;
+        let max_ring =
+            u32::try_from(maxRing).map_err(|_| H3ErrorCodes::EDomain)?;
+        if k == 0 {
+            return Ok(0);
+        }
+
+        let nearest = nearest_cells(point, resolution, set, k, max_ring);
+        let out = std::slice::from_raw_parts_mut(out, nearest.len());
+        for (dst, candidate) in out.iter_mut().zip(&nearest) {
+            *dst = candidate.cell.into();
+        }
+        if !distances.is_null() {
+            let distances =
+                std::slice::from_raw_parts_mut(distances, nearest.len());
+            for (dst, candidate) in distances.iter_mut().zip(&nearest) {
+                *dst = candidate.distance;
+            }
+        }
+        Ok(i64::try_from(nearest.len()).expect("too many cells"))
+    }
+
+    let point = *point.expect("null pointer");
+    delegate_inner!(inner(point, res, set, k, maxRing, out, distances), count)
+}
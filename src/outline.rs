@@ -0,0 +1,721 @@
+//! Outlining of cell sets, driven by the topology of the cell vertexes.
+//!
+//! The outline of a set is made of the edges between a cell of the set and a
+//! cell outside of it. Since exactly three cells meet at every vertex, a
+//! vertex starts at most one outline edge: keyed by their start vertex, the
+//! edges chain into rings without any geometric lookup. The edges of disjoint
+//! parts of a set are therefore independent, and stitch together exactly along
+//! the seams.
+
+use crate::{
+    cancel::Checkpoint, convert, delegate_inner, parallel, H3CancelToken,
+    H3Error, H3ErrorCodes, H3Index, LinkedGeoPolygon,
+};
+use geo_types::{Coord, LineString, MultiPolygon, Polygon};
+use h3o::{CellIndex, DirectedEdgeIndex, Resolution, VertexIndex};
+use std::{
+    collections::{HashMap, HashSet},
+    f64::consts::{PI, TAU},
+};
+
+/// An outline edge, between a cell of the set and a cell outside of it.
+#[derive(Debug, Clone, Copy)]
+struct Edge {
+    /// End vertex, where the next edge of the ring starts.
+    end: VertexIndex,
+    /// Coordinates of the start vertex, in radians.
+    start: Coord,
+    /// Distortion vertex, for the edges crossing an icosahedron edge.
+    distortion: Option<Coord>,
+}
+
+/// Outline of a cell set.
+#[derive(Debug, Default)]
+pub struct Outline {
+    /// Outline edges, keyed by start vertex.
+    edges: HashMap<VertexIndex, Edge>,
+}
+
+impl Outline {
+    /// Computes the outline of a set of cells, using every available worker,
+    /// unless stopped by `cancel`.
+    ///
+    /// `cells` must be the (deduplicated) content of `set`.
+    pub fn new(
+        cells: &[CellIndex],
+        set: &HashSet<CellIndex>,
+        cancel: Option<&H3CancelToken>,
+    ) -> Result<Self, H3Error> {
+        let chunks = parallel::map_chunks(cells, |cells| {
+            let mut checkpoint = Checkpoint::new(cancel);
+            let mut edges = Vec::new();
+            for &cell in cells {
+                checkpoint.step()?;
+                cell_edges(
+                    cell,
+                    |neighbor| set.contains(&neighbor),
+                    &mut edges,
+                );
+            }
+            Ok::<_, H3Error>(edges)
+        });
+
+        let mut edges = HashMap::new();
+        for chunk in chunks {
+            edges.extend(chunk?);
+        }
+        Ok(Self { edges })
+    }
+
+    /// Returns the outline as a linked multipolygon.
+    ///
+    /// Rings are listed from their smallest vertex, so the result doesn't
+    /// depend on how the outline was built.
+    #[must_use]
+    pub fn to_linked_polygon(&self) -> LinkedGeoPolygon {
+        self.to_linked_polygon_until(None).expect("not cancellable")
+    }
+
+    /// Returns the outline as a linked multipolygon, unless stopped by
+    /// `cancel`.
+    pub fn to_linked_polygon_until(
+        &self,
+        cancel: Option<&H3CancelToken>,
+    ) -> Result<LinkedGeoPolygon, H3Error> {
+        let polygon = assemble(self.rings(), &mut Checkpoint::new(cancel))?;
+        // Empty sets, and sets covering the whole globe, have no outline.
+        if polygon.0.is_empty() {
+            return Ok(LinkedGeoPolygon::empty());
+        }
+        Ok(polygon.into())
+    }
+
+    /// Chains the edges into closed rings, as the start vertexes of their
+    /// edges.
+    ///
+    /// Rings are listed from their smallest vertex, so the result doesn't
+    /// depend on how the outline was built.
+    fn vertex_rings(&self) -> Vec<Vec<VertexIndex>> {
+        let mut starts = self.edges.keys().copied().collect::<Vec<_>>();
+        starts.sort_unstable();
+
+        let mut visited = HashSet::with_capacity(starts.len());
+        let mut rings = Vec::new();
+        for first in starts {
+            if visited.contains(&first) {
+                continue;
+            }
+            let mut ring = Vec::new();
+            let mut vertex = first;
+            while visited.insert(vertex) {
+                let Some(edge) = self.edges.get(&vertex) else {
+                    break;
+                };
+                ring.push(vertex);
+                vertex = edge.end;
+            }
+            rings.push(ring);
+        }
+        rings
+    }
+
+    /// Chains the edges into closed rings of coordinates.
+    fn rings(&self) -> Vec<Vec<Coord>> {
+        self.vertex_rings()
+            .into_iter()
+            .map(|vertexes| {
+                let mut ring = Vec::with_capacity(vertexes.len() + 1);
+                for vertex in vertexes {
+                    let edge = self.edges[&vertex];
+                    ring.push(edge.start);
+                    ring.extend(edge.distortion);
+                }
+                if let Some(&start) = ring.first() {
+                    ring.push(start);
+                }
+                ring
+            })
+            .collect()
+    }
+}
+
+/// cellsToVertexGraph builds the vertex graph of a set of cells: the edges
+/// between a cell of the set and a cell outside of it, as pairs of vertex
+/// indexes (no coordinates involved).
+///
+/// The edge `i` goes from `from[i]` to `to[i]`, counter-clockwise around the
+/// cells of the set. Edges are grouped by ring: within a ring, every edge
+/// starts where the previous one ends, and the ring ends with the edge going
+/// back to the start of its first one. Rings are listed from their smallest
+/// vertex, so the output doesn't depend on the order of the cells.
+///
+/// Duplicated cells are ignored. The vertex coordinates can be computed at the
+/// end with vertexesToLatLngs (the edges crossing an icosahedron edge also
+/// have a distortion vertex, see directedEdgeToBoundary).
+///
+/// @param cells    The cells, all at the same resolution
+/// @param numCells The number of cells
+/// @param from     Output start vertexes
+/// @param to       Output end vertexes
+/// @param numEdges Number of edges written
+/// @return E_CELL_INVALID if a cell is invalid, E_RES_MISMATCH if the cells
+/// don't have the same resolution, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements, `from` and
+/// `to` to arrays of at least `6 * numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToVertexGraph(
+    cells: *const H3Index,
+    numCells: i64,
+    from: *mut H3Index,
+    to: *mut H3Index,
+    numEdges: Option<&mut i64>,
+) -> H3Error {
+    unsafe fn inner(
+        cells: *const H3Index,
+        numCells: i64,
+        from: *mut H3Index,
+        to: *mut H3Index,
+    ) -> Result<i64, H3Error> {
+        let len =
+            usize::try_from(numCells).map_err(|_| H3ErrorCodes::EDomain)?;
+        if len == 0 {
+            return Ok(0);
+        }
+        let cells = convert::h3ptr_to_h3oslice(cells, numCells)?;
+        let outline = from_cells(cells, None)?;
+
+        let from = std::slice::from_raw_parts_mut(from, 6 * len);
+        let to = std::slice::from_raw_parts_mut(to, 6 * len);
+        let mut count = 0;
+        for ring in outline.vertex_rings() {
+            for vertex in ring {
+                from[count] = vertex.into();
+                to[count] = outline.edges[&vertex].end.into();
+                count += 1;
+            }
+        }
+        Ok(i64::try_from(count).expect("too many edges"))
+    }
+
+    delegate_inner!(inner(cells, numCells, from, to), numEdges)
+}
+
+/// An outline kept up to date as cells are added to or removed from the set.
+///
+/// Only the edges of the updated cells are touched, since an edge between two
+/// cells of the set cancels out: an update costs in proportion to the number
+/// of updated cells, not to the size of the set.
+pub struct H3Outline {
+    /// Cells of the set.
+    cells: HashSet<CellIndex>,
+    /// Outline of the set.
+    outline: Outline,
+}
+
+impl H3Outline {
+    /// Builds the outline of a set of cells, all at the same resolution.
+    fn new(cells: &[CellIndex]) -> Result<Self, H3Error> {
+        let outline = from_cells(cells, None)?;
+        Ok(Self {
+            cells: cells.iter().copied().collect(),
+            outline,
+        })
+    }
+
+    /// Adds the cells (of the same resolution as the set) to the set,
+    /// ignoring those already present.
+    fn add(&mut self, cells: &[CellIndex]) -> Result<(), H3Error> {
+        if let Some(resolution) = self
+            .cells
+            .iter()
+            .next()
+            .or_else(|| cells.first())
+            .map(|cell| cell.resolution())
+        {
+            if cells.iter().any(|cell| cell.resolution() != resolution) {
+                return Err(H3ErrorCodes::EResMismatch.into());
+            }
+        }
+
+        for &cell in cells {
+            if !self.cells.insert(cell) {
+                continue;
+            }
+            let vertexes = cell.vertexes().collect::<Vec<_>>();
+            // Every cancellation is applied before any insertion: an edge
+            // of the cell may start where the edge of a neighbor did.
+            let mut inserted = Vec::with_capacity(vertexes.len());
+            for edge in cell.edges() {
+                let Some((start, new)) = outline_edge(edge, &vertexes) else {
+                    continue;
+                };
+                if self.cells.contains(&edge.destination()) {
+                    // Cancels out with the edge of the neighbor, going the
+                    // other way.
+                    self.remove_edge(new.end, start);
+                } else {
+                    inserted.push((start, new));
+                }
+            }
+            self.outline.edges.extend(inserted);
+        }
+        Ok(())
+    }
+
+    /// Removes the cells from the set, ignoring those not present.
+    fn remove(&mut self, cells: &[CellIndex]) {
+        for &cell in cells {
+            if !self.cells.remove(&cell) {
+                continue;
+            }
+            let vertexes = cell.vertexes().collect::<Vec<_>>();
+            // Every removal is applied before any insertion: an edge of a
+            // neighbor may start where an edge of the cell did.
+            let mut inserted = Vec::with_capacity(vertexes.len());
+            for edge in cell.edges() {
+                let neighbor = edge.destination();
+                if !self.cells.contains(&neighbor) {
+                    if let Some((start, old)) = outline_edge(edge, &vertexes) {
+                        self.remove_edge(start, old.end);
+                    }
+                    continue;
+                }
+                // The edge of the neighbor, going the other way, is now part
+                // of the outline.
+                let theirs = neighbor.vertexes().collect::<Vec<_>>();
+                inserted.extend(
+                    neighbor
+                        .edge(cell)
+                        .and_then(|reverse| outline_edge(reverse, &theirs)),
+                );
+            }
+            self.outline.edges.extend(inserted);
+        }
+    }
+
+    /// Removes the outline edge going from `start` to `end`, if any.
+    fn remove_edge(&mut self, start: VertexIndex, end: VertexIndex) {
+        if self
+            .outline
+            .edges
+            .get(&start)
+            .is_some_and(|edge| edge.end == end)
+        {
+            self.outline.edges.remove(&start);
+        }
+    }
+}
+
+/// Builds the outline of a set of cells, all at the same resolution, unless
+/// stopped by `cancel`.
+///
+/// Duplicated cells are ignored.
+pub fn from_cells(
+    cells: &[CellIndex],
+    cancel: Option<&H3CancelToken>,
+) -> Result<Outline, H3Error> {
+    if let Some(&first) = cells.first() {
+        let resolution = first.resolution();
+        if cells.iter().any(|cell| cell.resolution() != resolution) {
+            return Err(H3ErrorCodes::EResMismatch.into());
+        }
+    }
+
+    let set = cells.iter().copied().collect::<HashSet<_>>();
+    if set.len() == cells.len() {
+        return Outline::new(cells, &set, cancel);
+    }
+    let unique = set.iter().copied().collect::<Vec<_>>();
+    Outline::new(&unique, &set, cancel)
+}
+
+/// Builds the outline of a compacted set of cells, as if it was uncompacted at
+/// the finest resolution of the set.
+///
+/// Only the descendants close to the boundary of the set are generated: a
+/// cell whose neighborhood (two rings, to account for the descendants sticking
+/// out of their ancestor) is covered by the set has no descendant with an
+/// outline edge. The cost therefore scales with the perimeter of the set, not
+/// with its uncompacted size.
+///
+/// Duplicated and overlapping cells are ignored.
+pub fn from_compacted(cells: &[CellIndex]) -> Outline {
+    let Some(resolution) = cells.iter().map(|cell| cell.resolution()).max()
+    else {
+        return Outline::default();
+    };
+    let set = cells.iter().copied().collect::<HashSet<_>>();
+    let mut resolutions =
+        set.iter().map(|cell| cell.resolution()).collect::<Vec<_>>();
+    resolutions.sort_unstable();
+    resolutions.dedup();
+    // A cell is covered when it, or one of its ancestors, is in the set.
+    let is_covered = |cell: CellIndex| {
+        resolutions
+            .iter()
+            .take_while(|&&res| res <= cell.resolution())
+            .any(|&res| cell.parent(res).is_some_and(|p| set.contains(&p)))
+    };
+
+    let unique = set.iter().copied().collect::<Vec<_>>();
+    let edges = parallel::map_chunks(&unique, |cells| {
+        let (mut fringe, mut edges) = (Vec::new(), Vec::new());
+        for &cell in cells {
+            fringe_cells(cell, resolution, &is_covered, &mut fringe);
+            for &cell in &fringe {
+                cell_edges(cell, is_covered, &mut edges);
+            }
+            fringe.clear();
+        }
+        edges
+    });
+
+    Outline {
+        edges: edges.into_iter().flatten().collect(),
+    }
+}
+
+/// Appends the descendants of the cell, at `resolution`, that may be on the
+/// boundary of the set.
+fn fringe_cells(
+    cell: CellIndex,
+    resolution: Resolution,
+    is_covered: &impl Fn(CellIndex) -> bool,
+    out: &mut Vec<CellIndex>,
+) {
+    if cell.resolution() == resolution {
+        out.push(cell);
+        return;
+    }
+    if cell.grid_disk::<Vec<_>>(2).into_iter().all(is_covered) {
+        return;
+    }
+    let next = cell.resolution().succ().expect("finer resolution");
+    for child in cell.children(next) {
+        fringe_cells(child, resolution, is_covered, out);
+    }
+}
+
+/// Appends the outline edges of the cell, keyed by their start vertex.
+///
+/// `is_inside` tells if a cell is part of the set.
+fn cell_edges(
+    cell: CellIndex,
+    is_inside: impl Fn(CellIndex) -> bool,
+    out: &mut Vec<(VertexIndex, Edge)>,
+) {
+    let mut vertexes = None;
+    for edge in cell.edges() {
+        if is_inside(edge.destination()) {
+            continue;
+        }
+        let ours =
+            vertexes.get_or_insert_with(|| cell.vertexes().collect::<Vec<_>>());
+        out.extend(outline_edge(edge, ours));
+    }
+}
+
+/// Returns the outline edge (keyed by its start vertex) matching the directed
+/// edge, given the vertexes of its origin.
+fn outline_edge(
+    edge: DirectedEdgeIndex,
+    vertexes: &[VertexIndex],
+) -> Option<(VertexIndex, Edge)> {
+    // Vertexes are listed counter-clockwise: the edge goes from the first
+    // vertex shared with the neighbor to the second one.
+    let theirs = edge.destination().vertexes().collect::<Vec<_>>();
+    let (start, end) = (0..vertexes.len())
+        .map(|i| (vertexes[i], vertexes[(i + 1) % vertexes.len()]))
+        .find(|&(start, end)| {
+            theirs.contains(&start) && theirs.contains(&end)
+        })?;
+
+    // The last point is the end vertex, emitted by the next edge.
+    let boundary = edge.boundary();
+    let mut points = boundary.iter().map(|ll| Coord {
+        x: ll.lng_radians(),
+        y: ll.lat_radians(),
+    });
+    let first = points.next()?;
+    let distortion = if boundary.len() > 2 {
+        points.next()
+    } else {
+        None
+    };
+    Some((
+        start,
+        Edge {
+            end,
+            start: first,
+            distortion,
+        },
+    ))
+}
+
+// -----------------------------------------------------------------------------
+
+/// A closed ring, with its longitudes unwrapped across the antimeridian.
+struct Ring {
+    /// Coordinates, as traced.
+    coords: Vec<Coord>,
+    /// Coordinates with continuous longitudes.
+    unwrapped: Vec<Coord>,
+    /// Signed area, positive for counter-clockwise (i.e. outer) rings.
+    area: f64,
+    /// Whether the ring goes around a pole.
+    polar: bool,
+}
+
+impl Ring {
+    fn new(coords: Vec<Coord>) -> Self {
+        let mut unwrapped = Vec::with_capacity(coords.len());
+        // Previous longitude, as traced and unwrapped.
+        let mut previous: Option<(f64, f64)> = None;
+        for &coord in &coords {
+            let x = previous.map_or(coord.x, |(raw, x)| {
+                let mut delta = coord.x - raw;
+                if delta > PI {
+                    delta -= TAU;
+                } else if delta < -PI {
+                    delta += TAU;
+                }
+                x + delta
+            });
+            previous = Some((coord.x, x));
+            unwrapped.push(Coord { x, y: coord.y });
+        }
+
+        let polar = match (unwrapped.first(), unwrapped.last()) {
+            (Some(first), Some(last)) => (last.x - first.x).abs() > PI,
+            _ => false,
+        };
+        let area = unwrapped
+            .windows(2)
+            .map(|pair| pair[0].x.mul_add(pair[1].y, -(pair[1].x * pair[0].y)))
+            .sum::<f64>()
+            / 2.;
+
+        Self {
+            coords,
+            unwrapped,
+            area,
+            polar,
+        }
+    }
+
+    /// Tests if the point (unwrapped) is inside the ring.
+    fn contains(&self, point: Coord) -> bool {
+        let Some(first) = self.unwrapped.first() else {
+            return false;
+        };
+        // Bring the point in the longitude range of the ring.
+        let x = ((first.x - point.x) / TAU).round().mul_add(TAU, point.x);
+        let y = point.y;
+
+        let mut inside = false;
+        for pair in self.unwrapped.windows(2) {
+            let (a, b) = (pair[0], pair[1]);
+            if (a.y > y) != (b.y > y)
+                && x < (b.x - a.x).mul_add((y - a.y) / (b.y - a.y), a.x)
+            {
+                inside = !inside;
+            }
+        }
+        inside
+    }
+}
+
+/// Assembles the rings of an outline into polygons, taking a `checkpoint`
+/// step per containment test.
+///
+/// Counter-clockwise rings are outer rings, and every clockwise ring is a hole
+/// of the smallest outer ring containing it. Rings going around a pole can't
+/// be oriented in the plane, and are considered outer rings.
+fn assemble(
+    rings: Vec<Vec<Coord>>,
+    checkpoint: &mut Checkpoint<'_>,
+) -> Result<MultiPolygon, H3Error> {
+    let (outers, holes): (Vec<_>, Vec<_>) = rings
+        .into_iter()
+        .map(Ring::new)
+        .partition(|ring| ring.polar || ring.area > 0.);
+
+    let mut interiors = vec![Vec::new(); outers.len()];
+    let mut orphans = Vec::new();
+    for hole in holes {
+        let point = hole.unwrapped[0];
+        let mut parent = None;
+        for (i, outer) in outers.iter().enumerate() {
+            checkpoint.step()?;
+            if outer.contains(point)
+                && parent.is_none_or(|j: usize| outer.area < outers[j].area)
+            {
+                parent = Some(i);
+            }
+        }
+        let ring = LineString::new(hole.coords);
+        match parent {
+            Some(i) => interiors[i].push(ring),
+            // Shouldn't happen, but better keep the ring than lose it.
+            None => orphans.push(Polygon::new(ring, Vec::new())),
+        }
+    }
+
+    let mut polygons = outers
+        .into_iter()
+        .zip(interiors)
+        .map(|(outer, holes)| {
+            Polygon::new(LineString::new(outer.coords), holes)
+        })
+        .collect::<Vec<_>>();
+    polygons.extend(orphans);
+    Ok(MultiPolygon::new(polygons))
+}
+
+// -----------------------------------------------------------------------------
+
+/// createOutline builds an outline that can then be updated incrementally, as
+/// cells are added to or removed from the set.
+///
+/// All the cells must have the same resolution, duplicates are ignored.
+///
+/// It is the responsibility of the caller to call destroyOutline on the
+/// outline, or its memory will not be freed.
+///
+/// @param cells     The initial set of cells
+/// @param numCells  The number of cells
+/// @param out       The created outline
+/// @return 0 (E_SUCCESS) on success.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn createOutline(
+    cells: *const H3Index,
+    numCells: i64,
+    out: Option<&mut *mut H3Outline>,
+) -> H3Error {
+    unsafe fn inner(
+        cells: *const H3Index,
+        numCells: i64,
+    ) -> Result<*mut H3Outline, H3Error> {
+        if numCells < 0 {
+            return Err(H3ErrorCodes::EDomain.into());
+        }
+        let cells = if numCells == 0 {
+            &[]
+        } else {
+            convert::h3ptr_to_h3oslice(cells, numCells)?
+        };
+        Ok(Box::into_raw(Box::new(H3Outline::new(cells)?)))
+    }
+
+    delegate_inner!(inner(cells, numCells), out)
+}
+
+/// outlineAddCells adds cells to the set of an outline, updating only the
+/// edges of the added cells.
+///
+/// The cells must have the same resolution as the ones in the set, those
+/// already present are ignored. On error, the outline is left untouched.
+///
+/// @param outline   The outline created by createOutline
+/// @param cells     The cells to add
+/// @param numCells  The number of cells
+/// @return 0 (E_SUCCESS) on success.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn outlineAddCells(
+    outline: Option<&mut H3Outline>,
+    cells: *const H3Index,
+    numCells: i64,
+) -> H3Error {
+    if numCells < 0 {
+        return H3ErrorCodes::EDomain.into();
+    }
+    if numCells == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let outline = outline.expect("null pointer");
+    convert::h3ptr_to_h3oslice(cells, numCells)
+        .and_then(|cells| outline.add(cells))
+        .err()
+        .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// outlineRemoveCells removes cells from the set of an outline, updating only
+/// the edges of the removed cells.
+///
+/// The cells not present in the set are ignored. On error, the outline is
+/// left untouched.
+///
+/// @param outline   The outline created by createOutline
+/// @param cells     The cells to remove
+/// @param numCells  The number of cells
+/// @return 0 (E_SUCCESS) on success.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn outlineRemoveCells(
+    outline: Option<&mut H3Outline>,
+    cells: *const H3Index,
+    numCells: i64,
+) -> H3Error {
+    if numCells < 0 {
+        return H3ErrorCodes::EDomain.into();
+    }
+    if numCells == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let outline = outline.expect("null pointer");
+    match convert::h3ptr_to_h3oslice(cells, numCells) {
+        Ok(cells) => {
+            outline.remove(cells);
+            H3ErrorCodes::ESuccess.into()
+        }
+        Err(err) => err,
+    }
+}
+
+/// outlineToLinkedMultiPolygon creates a LinkedGeoPolygon describing the
+/// current outline, in the same format as cellsToLinkedMultiPolygon.
+///
+/// It is the responsibility of the caller to call destroyLinkedMultiPolygon on
+/// the populated linked geo structure, or the memory for that structure will
+/// not be freed.
+///
+/// @param outline   The outline created by createOutline
+/// @param out       Output polygon
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn outlineToLinkedMultiPolygon(
+    outline: Option<&H3Outline>,
+    out: Option<&mut LinkedGeoPolygon>,
+) -> H3Error {
+    *out.expect("null pointer") =
+        outline.expect("null pointer").outline.to_linked_polygon();
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Free all allocated memory for an outline.
+///
+/// @param outline The outline to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`createOutline`]
+#[no_mangle]
+pub unsafe extern "C" fn destroyOutline(outline: *mut H3Outline) {
+    if !outline.is_null() {
+        drop(Box::from_raw(outline));
+    }
+}
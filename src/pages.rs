@@ -0,0 +1,183 @@
+//! Large buffers backed by anonymous mappings.
+//!
+//! Multi-gigabyte buffers suffer from TLB misses with regular pages, and from
+//! remote memory accesses on multi-socket machines when they're touched by a
+//! single thread. Anonymous mappings address both: they can be backed by
+//! transparent huge pages (on Linux), and their pages are only allocated when
+//! first written, on the NUMA node of the writing thread. The parallel
+//! functions write every partition of their outputs from the worker that
+//! computes it, so each worker gets local pages.
+
+use crate::{config, delegate_inner, H3Error, H3ErrorCodes, H3Index};
+use memmap2::{Advice, Mmap, MmapMut};
+use std::ops::{Deref, DerefMut};
+
+/// Size of a (transparent) huge page, below which a buffer isn't worth
+/// mapping.
+const HUGE_PAGE_SIZE: usize = 2 << 20;
+
+/// Number of bytes of a word.
+const WORD_BYTES: usize = 8;
+
+/// Advice asking for transparent huge pages, where supported.
+#[cfg(target_os = "linux")]
+const HUGE_PAGES: Option<Advice> = Some(Advice::HugePage);
+#[cfg(not(target_os = "linux"))]
+const HUGE_PAGES: Option<Advice> = None;
+
+/// A buffer of 64-bit words, on the heap or in an anonymous mapping.
+pub enum Words {
+    /// Words allocated on the heap.
+    Heap(Vec<u64>),
+    /// Words stored at the start of an anonymous mapping.
+    Mapped {
+        /// The mapping, of `8 * len` bytes.
+        map: MmapMut,
+        /// Number of words.
+        len: usize,
+    },
+}
+
+impl Words {
+    /// Moves words into a huge-page mapping if they're large enough and huge
+    /// pages are enabled (see h3SetHugePages), keeps them on the heap
+    /// otherwise.
+    pub fn from_vec(words: Vec<u64>) -> Self {
+        if !config::huge_pages() || words.len() * WORD_BYTES < HUGE_PAGE_SIZE {
+            return Self::Heap(words);
+        }
+        let Some(mut mapped) = Self::mapped(words.len()) else {
+            return Self::Heap(words);
+        };
+        mapped.copy_from_slice(&words);
+        mapped
+    }
+
+    /// Maps `len` zeroed words, advised for huge pages.
+    ///
+    /// The pages are only allocated when first written.
+    fn mapped(len: usize) -> Option<Self> {
+        let map = MmapMut::map_anon(len.checked_mul(WORD_BYTES)?).ok()?;
+        advise_huge_pages(&map);
+        // Mappings are page-aligned, which suits any word.
+        debug_assert_eq!(map.as_ptr().align_offset(8), 0, "misaligned map");
+        Some(Self::Mapped { map, len })
+    }
+}
+
+impl Deref for Words {
+    type Target = [u64];
+
+    fn deref(&self) -> &[u64] {
+        match *self {
+            Self::Heap(ref words) => words,
+            // SAFETY: the mapping is page-aligned and holds `len` words, for
+            // which any bit pattern is valid.
+            Self::Mapped { ref map, len } => unsafe {
+                std::slice::from_raw_parts(map.as_ptr().cast(), len)
+            },
+        }
+    }
+}
+
+impl DerefMut for Words {
+    fn deref_mut(&mut self) -> &mut [u64] {
+        match *self {
+            Self::Heap(ref mut words) => words,
+            // SAFETY: the mapping is page-aligned and holds `len` words, for
+            // which any bit pattern is valid.
+            Self::Mapped { ref mut map, len } => unsafe {
+                std::slice::from_raw_parts_mut(map.as_mut_ptr().cast(), len)
+            },
+        }
+    }
+}
+
+/// Asks for a mapping to be backed by transparent huge pages, where
+/// supported.
+///
+/// This is only a hint: failures (e.g. huge pages disabled system-wide) are
+/// ignored.
+fn advise_huge_pages(map: &MmapMut) {
+    if let Some(advice) = HUGE_PAGES {
+        map.advise(advice).unwrap_or(());
+    }
+}
+
+/// Asks for a read-only file mapping to be backed by huge pages, if enabled
+/// (see h3SetHugePages) and large enough.
+pub fn advise_file_mapping(map: &Mmap) {
+    if !config::huge_pages() || map.len() < HUGE_PAGE_SIZE {
+        return;
+    }
+    if let Some(advice) = HUGE_PAGES {
+        map.advise(advice).unwrap_or(());
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/// A large output buffer of cells.
+pub struct H3CellBuffer(Words);
+
+/// createCellBuffer allocates an output buffer of cells, for the large
+/// outputs of the parallel functions (uncompactCellsParallel,
+/// gridDisksParallel, cellsToChildrenCSR, ...).
+///
+/// Buffers of a few megabytes or more are backed by an anonymous mapping:
+/// it's advised for transparent huge pages (on Linux), and zeroed lazily, its
+/// pages being allocated when first written. As the parallel functions write
+/// every partition of their output from the worker computing it, the pages
+/// of each partition end up on the NUMA node of their worker.
+///
+/// It is the responsibility of the caller to call destroyCellBuffer on the
+/// buffer, or its memory will not be freed.
+///
+/// @param numCells The number of cells of the buffer
+/// @param out      The created buffer, zeroed
+/// @return E_DOMAIN if the number of cells is negative, E_MEMORY_ALLOC if the
+/// buffer cannot be allocated, E_SUCCESS otherwise.
+#[no_mangle]
+pub extern "C" fn createCellBuffer(
+    numCells: i64,
+    out: Option<&mut *mut H3CellBuffer>,
+) -> H3Error {
+    fn inner(numCells: i64) -> Result<*mut H3CellBuffer, H3Error> {
+        let len =
+            usize::try_from(numCells).map_err(|_| H3ErrorCodes::EDomain)?;
+        let words = if len.saturating_mul(WORD_BYTES) < HUGE_PAGE_SIZE {
+            Words::Heap(vec![0; len])
+        } else {
+            Words::mapped(len).ok_or(H3ErrorCodes::EMemoryAlloc)?
+        };
+        Ok(Box::into_raw(Box::new(H3CellBuffer(words))))
+    }
+
+    delegate_inner!(inner(numCells), out)
+}
+
+/// cellBufferCells returns the cells of a buffer created by createCellBuffer,
+/// valid until the buffer is destroyed.
+///
+/// @param buffer The buffer
+/// @return The first cell of the buffer.
+#[no_mangle]
+pub extern "C" fn cellBufferCells(
+    buffer: Option<&mut H3CellBuffer>,
+) -> *mut H3Index {
+    buffer.expect("null pointer").0.as_mut_ptr()
+}
+
+/// Free all allocated memory for a cell buffer.
+///
+/// @param buffer The buffer to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`createCellBuffer`].
+#[no_mangle]
+pub unsafe extern "C" fn destroyCellBuffer(buffer: *mut H3CellBuffer) {
+    if !buffer.is_null() {
+        drop(Box::from_raw(buffer));
+    }
+}
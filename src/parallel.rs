@@ -0,0 +1,365 @@
+//! Fork-join helpers backing the multi-threaded entry points.
+//!
+//! Parallel jobs run on the executor provided by the user if any (see
+//! `h3SetExecutor`), on a library-owned pool of threads otherwise. In both
+//! cases, the workers of a job pull chunks of work from a shared counter until
+//! there is nothing left, which balances the load between them.
+
+use crate::config::{self, Executor};
+use std::{
+    any::Any,
+    collections::VecDeque,
+    ffi::c_void,
+    num::NonZeroUsize,
+    panic::{self, AssertUnwindSafe},
+    sync::{
+        atomic::{AtomicUsize, Ordering},
+        Arc, Condvar, Mutex,
+    },
+    thread,
+};
+
+/// Number of chunks per worker, allowing some load balancing between workers
+/// when the cost per item isn't uniform.
+const CHUNKS_PER_WORKER: usize = 4;
+
+/// Library-owned thread pool, created on first use.
+static POOL: Mutex<Option<Arc<Pool>>> = Mutex::new(None);
+
+/// Returns the number of workers to use for a parallel job.
+pub fn worker_count() -> usize {
+    match config::thread_count() {
+        0 => thread::available_parallelism().map_or(1, NonZeroUsize::get),
+        count => count,
+    }
+}
+
+/// Returns the number of tasks a parallel job should be split into.
+pub fn task_count() -> usize {
+    worker_count() * CHUNKS_PER_WORKER
+}
+
+/// Runs `f` on every task, spreading the tasks over the available workers.
+///
+/// Unlike `map_chunks`, tasks are moved into `f` and may therefore hold
+/// mutable borrows (e.g. disjoint parts of an output buffer).
+pub fn for_each<T, F>(tasks: Vec<T>, f: F)
+where
+    T: Send,
+    F: Fn(T) + Sync,
+{
+    let tasks = tasks
+        .into_iter()
+        .map(|task| Mutex::new(Some(task)))
+        .collect::<Vec<_>>();
+    map_chunks(&tasks, |tasks| {
+        for task in tasks {
+            // Each task is taken exactly once, so the lock is never contended.
+            let task = task.lock().expect("poisoned task").take();
+            if let Some(task) = task {
+                f(task);
+            }
+        }
+    });
+}
+
+/// Splits `items` and their output into tasks of (roughly) the same output
+/// size, for `for_each`.
+///
+/// The output of `items[i]` is `out[offsets[i]..offsets[i + 1]]`: `offsets`
+/// has one more element than `items`, and the last one is the size of `out`.
+pub fn split_by_output<'a, T, O>(
+    items: &'a [T],
+    offsets: &[u64],
+    mut out: &'a mut [O],
+) -> Vec<(&'a [T], &'a mut [O])> {
+    let total = offsets[items.len()];
+    let step = total
+        .div_ceil(u64::try_from(task_count()).expect("overflow"))
+        .max(1);
+    let mut tasks = Vec::new();
+    let mut start = 0;
+    while start < items.len() {
+        let target = offsets[start] + step;
+        let end = (start
+            + 1
+            + offsets[start + 1..].partition_point(|&offset| offset < target))
+        .min(items.len());
+        let size = usize::try_from(offsets[end] - offsets[start])
+            .expect("output too large");
+        let (head, tail) = out.split_at_mut(size);
+        tasks.push((&items[start..end], head));
+        out = tail;
+        start = end;
+    }
+    tasks
+}
+
+/// Splits `items` into contiguous chunks and applies `f` on each of them,
+/// spreading the chunks over the available workers.
+///
+/// Results are returned in the order of the chunks.
+pub fn map_chunks<T, R, F>(items: &[T], f: F) -> Vec<R>
+where
+    T: Sync,
+    R: Send,
+    F: Fn(&[T]) -> R + Sync,
+{
+    let workers = worker_count().min(items.len());
+    if workers <= 1 {
+        return vec![f(items)];
+    }
+
+    let chunk_size = items.len().div_ceil(workers * CHUNKS_PER_WORKER);
+    let chunks = items.chunks(chunk_size).collect::<Vec<_>>();
+    let results = chunks.iter().map(|_| Mutex::new(None)).collect::<Vec<_>>();
+    let next = AtomicUsize::new(0);
+
+    run(workers, &|| {
+        // Workers pull chunks until there is nothing left.
+        loop {
+            let id = next.fetch_add(1, Ordering::Relaxed);
+            let Some(chunk) = chunks.get(id) else {
+                break;
+            };
+            let result = f(chunk);
+            *results[id].lock().expect("poisoned result") = Some(result);
+        }
+    });
+
+    results
+        .into_iter()
+        .map(|result| {
+            result
+                .into_inner()
+                .expect("poisoned result")
+                .expect("processed chunk")
+        })
+        .collect()
+}
+
+/// Runs `worker` `count` times concurrently, returning once every run has
+/// completed.
+///
+/// A panic in any run is propagated to the caller.
+fn run(count: usize, worker: &(dyn Fn() + Sync)) {
+    if let Some(executor) = config::executor() {
+        run_on_executor(executor, count, worker);
+        return;
+    }
+
+    let pool = {
+        let threads = worker_count() - 1;
+        let mut pool = POOL.lock().expect("poisoned pool");
+        // Replace the pool if the number of threads changed (its threads
+        // exit once they're done with the queued jobs).
+        if pool.as_ref().is_none_or(|pool| pool.threads != threads) {
+            *pool = Some(Arc::new(Pool::new(threads)));
+        }
+        Arc::clone(pool.as_ref().expect("pool"))
+    };
+    pool.run(count, worker);
+}
+
+// -----------------------------------------------------------------------------
+
+/// A worker handed over to an executor.
+struct ExecutorTask<'a> {
+    /// The worker to run.
+    worker: &'a (dyn Fn() + Sync),
+    /// Payload of the first panic among the runs, if any.
+    panic: Mutex<Option<Box<dyn Any + Send>>>,
+}
+
+/// Runs the worker of an `ExecutorTask`, capturing any panic (it can't unwind
+/// through the executor).
+unsafe extern "C" fn run_executor_task(arg: *mut c_void) {
+    // SAFETY: `arg` is the task given to the executor by `run_on_executor`,
+    // which outlives the executor call.
+    let task = unsafe { &*arg.cast::<ExecutorTask<'_>>() };
+    if let Err(payload) = panic::catch_unwind(AssertUnwindSafe(task.worker)) {
+        task.panic
+            .lock()
+            .expect("poisoned panic")
+            .get_or_insert(payload);
+    }
+}
+
+/// Runs `worker` `count` times on the user-provided executor.
+fn run_on_executor(
+    executor: Executor,
+    count: usize,
+    worker: &(dyn Fn() + Sync),
+) {
+    let task = ExecutorTask {
+        worker,
+        panic: Mutex::new(None),
+    };
+    let arg = std::ptr::from_ref(&task).cast_mut().cast::<c_void>();
+    let count = i64::try_from(count).expect("too many workers");
+    // SAFETY: the executor only returns once every run has completed (as
+    // documented by `h3SetExecutor`), hence `task` outlives them.
+    unsafe {
+        (executor.function)(run_executor_task, arg, count, executor.context);
+    }
+
+    if let Some(payload) = task.panic.into_inner().expect("poisoned panic") {
+        panic::resume_unwind(payload);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/// Library-owned pool of threads.
+struct Pool {
+    /// State shared with the threads.
+    shared: Arc<Shared>,
+    /// Number of threads.
+    threads: usize,
+}
+
+/// State shared between a pool and its threads.
+#[derive(Default)]
+struct Shared {
+    /// Pending jobs, and whether the pool has been dropped.
+    state: Mutex<(VecDeque<Job>, bool)>,
+    /// Signaled when a job is queued, or the pool is dropped.
+    available: Condvar,
+}
+
+/// A run of a worker.
+struct Job {
+    /// The worker to run.
+    ///
+    /// It isn't actually `'static`: `Pool::run` waits for every job of its
+    /// batch before returning, so the worker outlives the job.
+    worker: &'static (dyn Fn() + Sync),
+    /// Batch of the job.
+    batch: Arc<Batch>,
+}
+
+/// Completion tracking of the jobs queued by a `Pool::run` call.
+struct Batch {
+    /// Number of jobs not completed yet.
+    remaining: AtomicUsize,
+    /// Lock paired with `done`.
+    lock: Mutex<()>,
+    /// Signaled when every job has completed.
+    done: Condvar,
+    /// Payload of the first panic among the jobs, if any.
+    panic: Mutex<Option<Box<dyn Any + Send>>>,
+}
+
+impl Pool {
+    /// Spawns a pool of `threads` threads.
+    fn new(threads: usize) -> Self {
+        let shared = Arc::new(Shared::default());
+        for _ in 0..threads {
+            let shared = Arc::clone(&shared);
+            thread::spawn(move || shared.work());
+        }
+        Self { shared, threads }
+    }
+
+    /// Runs `worker` `count` times, on the pool threads and the calling
+    /// thread, returning once every run has completed.
+    fn run(&self, count: usize, worker: &(dyn Fn() + Sync)) {
+        // SAFETY: every job of the batch completes before this function
+        // returns (jobs can't unwind), so the worker outlives them.
+        let worker = unsafe {
+            std::mem::transmute::<&(dyn Fn() + Sync), &'static (dyn Fn() + Sync)>(
+                worker,
+            )
+        };
+        let batch = Arc::new(Batch {
+            remaining: AtomicUsize::new(count),
+            lock: Mutex::new(()),
+            done: Condvar::new(),
+            panic: Mutex::new(None),
+        });
+        self.shared.lock().0.extend((0..count).map(|_| Job {
+            worker,
+            batch: Arc::clone(&batch),
+        }));
+        self.shared.available.notify_all();
+
+        // Help with the queued jobs (ours or not) rather than just waiting,
+        // so that nested jobs can't starve when every thread is busy.
+        while let Some(job) = self.shared.pop() {
+            job.run();
+        }
+        // Our remaining jobs are running elsewhere at this point.
+        let lock = batch.lock.lock().expect("poisoned batch");
+        drop(
+            batch
+                .done
+                .wait_while(lock, |&mut ()| {
+                    batch.remaining.load(Ordering::Acquire) != 0
+                })
+                .expect("poisoned batch"),
+        );
+
+        let panic = batch.panic.lock().expect("poisoned panic").take();
+        if let Some(payload) = panic {
+            panic::resume_unwind(payload);
+        }
+    }
+}
+
+impl Drop for Pool {
+    fn drop(&mut self) {
+        self.shared.lock().1 = true;
+        self.shared.available.notify_all();
+    }
+}
+
+impl Shared {
+    /// Locks the state.
+    fn lock(&self) -> std::sync::MutexGuard<'_, (VecDeque<Job>, bool)> {
+        self.state.lock().expect("poisoned pool")
+    }
+
+    /// Pops a pending job, if any.
+    fn pop(&self) -> Option<Job> {
+        self.lock().0.pop_front()
+    }
+
+    /// Runs the queued jobs until the pool is dropped.
+    fn work(&self) {
+        loop {
+            let job = {
+                let mut state = self.lock();
+                loop {
+                    if let Some(job) = state.0.pop_front() {
+                        break job;
+                    }
+                    if state.1 {
+                        return;
+                    }
+                    state = self.available.wait(state).expect("poisoned pool");
+                }
+            };
+            job.run();
+        }
+    }
+}
+
+impl Job {
+    /// Runs the worker, capturing any panic for the batch owner.
+    fn run(self) {
+        if let Err(payload) = panic::catch_unwind(AssertUnwindSafe(self.worker))
+        {
+            self.batch
+                .panic
+                .lock()
+                .expect("poisoned panic")
+                .get_or_insert(payload);
+        }
+        if self.batch.remaining.fetch_sub(1, Ordering::AcqRel) == 1 {
+            // Taking the lock ensures the waiter is either waiting or yet to
+            // check the counter, so that the notification is never lost.
+            drop(self.batch.lock.lock().expect("poisoned batch"));
+            self.batch.done.notify_all();
+        }
+    }
+}
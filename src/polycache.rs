@@ -0,0 +1,371 @@
+//! Opt-in caches of polygon fills.
+//!
+//! Applications tend to fill the same polygons (saved zones, geofences) over
+//! and over, at a handful of resolutions. A cache keeps the compacted fills of
+//! the most recently used ones, keyed by their vertices, resolution and
+//! containment mode, so that a repeated fill only costs a lookup (and an
+//! uncompaction, for the full set of cells).
+//!
+//! Keys hold the vertices themselves, not only their hash: polygons are
+//! compared exactly, and a collision can never return the cells of another
+//! polygon.
+
+use crate::{
+    convert, delegate_inner, geom, GeoLoop, GeoPolygon, H3Error, H3ErrorCodes,
+    H3Index, LatLng,
+};
+use h3o::CellIndex;
+use std::{
+    collections::{BTreeMap, HashMap},
+    ffi::c_int,
+    sync::{Arc, Mutex},
+};
+
+/// Estimated memory used by an entry, besides its vertices and cells.
+const ENTRY_OVERHEAD: usize = 128;
+
+/// Identity of a fill.
+#[derive(Debug, Clone, PartialEq, Eq, Hash)]
+struct Key {
+    res: c_int,
+    flags: u32,
+    /// Number of vertices of every loop, followed by the bits of their
+    /// coordinates (shared by the copy of the key in `Cache::recency`).
+    vertices: Arc<[u64]>,
+}
+
+impl Key {
+    /// Builds the key of a fill.
+    fn new(
+        geoPolygon: &GeoPolygon,
+        res: c_int,
+        flags: u32,
+    ) -> Result<Self, H3Error> {
+        let holes = usize::try_from(geoPolygon.numHoles)
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        let holes = if holes == 0 {
+            &[]
+        } else {
+            // SAFETY: `holes` must points to an array of at least `numHoles`
+            // elements.
+            unsafe { std::slice::from_raw_parts(geoPolygon.holes, holes) }
+        };
+
+        let mut vertices = Vec::new();
+        for geoloop in std::iter::once(&geoPolygon.geoloop).chain(holes) {
+            let verts = loop_vertices(geoloop)?;
+            vertices.push(u64::try_from(verts.len()).expect("too many verts"));
+            for vertex in verts {
+                vertices.push(vertex.lat.to_bits());
+                vertices.push(vertex.lng.to_bits());
+            }
+        }
+        Ok(Self {
+            res,
+            flags,
+            vertices: vertices.into(),
+        })
+    }
+}
+
+/// Returns the vertices of a loop.
+fn loop_vertices(geoloop: &GeoLoop) -> Result<&[LatLng], H3Error> {
+    let len =
+        usize::try_from(geoloop.numVerts).map_err(|_| H3ErrorCodes::EFailed)?;
+    if len == 0 {
+        return Ok(&[]);
+    }
+    // SAFETY: `verts` must points to an array of at least `numVerts` elements.
+    Ok(unsafe { std::slice::from_raw_parts(geoloop.verts, len) })
+}
+
+/// A cached fill.
+struct Entry {
+    /// The compacted cells of the fill.
+    cells: Arc<[CellIndex]>,
+    /// Last use of the entry (its key in `Cache::recency`).
+    tick: u64,
+    /// Estimated memory used by the entry.
+    bytes: usize,
+}
+
+/// Contents of a cache.
+#[derive(Default)]
+struct Cache {
+    entries: HashMap<Key, Entry>,
+    /// Keys of the entries, from the least recently used one.
+    recency: BTreeMap<u64, Key>,
+    /// Use counter, ordering the entries.
+    tick: u64,
+    /// Estimated memory used by the entries.
+    bytes: usize,
+    hits: u64,
+    misses: u64,
+}
+
+impl Cache {
+    /// Returns the cells of a fill, if cached, marking it as the most recently
+    /// used.
+    fn get(&mut self, key: &Key) -> Option<Arc<[CellIndex]>> {
+        self.tick += 1;
+        let Some(entry) = self.entries.get_mut(key) else {
+            self.misses += 1;
+            return None;
+        };
+        let key = self.recency.remove(&entry.tick).expect("recency entry");
+        entry.tick = self.tick;
+        self.recency.insert(self.tick, key);
+        self.hits += 1;
+        Some(Arc::clone(&entry.cells))
+    }
+
+    /// Caches the cells of a fill, evicting the least recently used entries
+    /// until it fits in `capacity` (an entry too large on its own isn't
+    /// cached).
+    fn insert(&mut self, key: Key, cells: Arc<[CellIndex]>, capacity: usize) {
+        // The vertices are counted once: both copies of the key share them.
+        let bytes =
+            ENTRY_OVERHEAD + 8 * key.vertices.len() + size_of_val(&*cells);
+        // Another thread may have filled the same polygon meanwhile.
+        if bytes > capacity || self.entries.contains_key(&key) {
+            return;
+        }
+        while self.bytes + bytes > capacity {
+            let (_, oldest) = self.recency.pop_first().expect("cached entry");
+            let entry = self.entries.remove(&oldest).expect("cached entry");
+            self.bytes -= entry.bytes;
+        }
+
+        self.tick += 1;
+        self.recency.insert(self.tick, key.clone());
+        self.entries.insert(
+            key,
+            Entry {
+                cells,
+                tick: self.tick,
+                bytes,
+            },
+        );
+        self.bytes += bytes;
+    }
+}
+
+/// A polygon fill cache.
+pub struct H3PolygonCache {
+    /// Memory cap of the entries, in bytes.
+    capacity: usize,
+    cache: Mutex<Cache>,
+}
+
+impl H3PolygonCache {
+    /// Returns the compacted fill of a polygon, from the cache if possible.
+    ///
+    /// The lock isn't held while filling, so that lookups don't wait for the
+    /// fills of other threads. Errors are never cached.
+    fn fill(
+        &self,
+        geoPolygon: &GeoPolygon,
+        res: c_int,
+        flags: u32,
+    ) -> Result<Arc<[CellIndex]>, H3Error> {
+        let key = Key::new(geoPolygon, res, flags)?;
+        let cached = self.cache.lock().expect("poisoned cache").get(&key);
+        if let Some(cells) = cached {
+            return Ok(cells);
+        }
+        let cells = Arc::<[CellIndex]>::from(geom::compact_polygon_cells(
+            geoPolygon, res, flags,
+        )?);
+        self.cache.lock().expect("poisoned cache").insert(
+            key,
+            Arc::clone(&cells),
+            self.capacity,
+        );
+        Ok(cells)
+    }
+}
+
+/// Writes `len` cells to an output array, failing with E_MEMORY_BOUNDS if
+/// it's too small (`count` is still set).
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `maxOut` elements.
+unsafe fn write_cells(
+    cells: impl Iterator<Item = CellIndex>,
+    len: usize,
+    out: *mut H3Index,
+    maxOut: i64,
+    count: Option<&mut i64>,
+) -> H3Error {
+    let Ok(capacity) = usize::try_from(maxOut) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    *count.expect("null pointer") = i64::try_from(len).expect("too many cells");
+    if len > capacity {
+        return H3ErrorCodes::EMemoryBounds.into();
+    }
+    if len != 0 {
+        let out = std::slice::from_raw_parts_mut(out, len);
+        for (dst, cell) in out.iter_mut().zip(cells) {
+            *dst = cell.into();
+        }
+    }
+    H3ErrorCodes::ESuccess.into()
+}
+
+// -----------------------------------------------------------------------------
+
+/// createPolygonCache creates a cache of polygon fills, for
+/// polygonToCellsCached and polygonToCompactCellsCached.
+///
+/// The fills are stored compacted, and the least recently used ones are
+/// evicted once their estimated memory use goes past `maxBytes`. A cache can
+/// be shared by any number of threads.
+///
+/// It is the responsibility of the caller to call destroyPolygonCache on the
+/// cache, or its memory will not be freed.
+///
+/// @param maxBytes The memory cap of the cached fills, in bytes
+/// @param out      The created cache
+/// @return E_DOMAIN if the cap is negative, E_SUCCESS otherwise.
+#[no_mangle]
+pub extern "C" fn createPolygonCache(
+    maxBytes: i64,
+    out: Option<&mut *mut H3PolygonCache>,
+) -> H3Error {
+    fn inner(maxBytes: i64) -> Result<*mut H3PolygonCache, H3Error> {
+        let capacity =
+            usize::try_from(maxBytes).map_err(|_| H3ErrorCodes::EDomain)?;
+        let cache = H3PolygonCache {
+            capacity,
+            cache: Mutex::new(Cache::default()),
+        };
+        Ok(Box::into_raw(Box::new(cache)))
+    }
+
+    delegate_inner!(inner(maxBytes), out)
+}
+
+/// polygonToCellsCached is polygonToCells, with the fills cached.
+///
+/// Polygons are identified by the exact values of their vertices (and holes),
+/// with the resolution and the containment mode: a hit only uncompacts the
+/// cached fill. The cells are written in no particular order. If `out` is too
+/// small, E_MEMORY_BOUNDS is returned but `count` is still set, so that it
+/// gives the required size.
+///
+/// @param cache      The cache created by createPolygonCache
+/// @param geoPolygon The geoloop and holes defining the relevant area
+/// @param res        The Hexagon resolution (0-15)
+/// @param flags      Containment mode (see ContainmentMode)
+/// @param out        Output array
+/// @param maxOut     Size of the output array
+/// @param count      Number of cells of the fill
+/// @return 0 (E_SUCCESS) on success.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `maxOut` elements.
+#[no_mangle]
+pub unsafe extern "C" fn polygonToCellsCached(
+    cache: Option<&H3PolygonCache>,
+    geoPolygon: Option<&GeoPolygon>,
+    res: c_int,
+    flags: u32,
+    out: *mut H3Index,
+    maxOut: i64,
+    count: Option<&mut i64>,
+) -> H3Error {
+    let Some(geoPolygon) = geoPolygon else {
+        return H3ErrorCodes::EFailed.into();
+    };
+    let cells = match cache.expect("null pointer").fill(geoPolygon, res, flags)
+    {
+        Ok(cells) => cells,
+        Err(err) => return err,
+    };
+    // The resolution is valid, since the fill succeeded.
+    let resolution = convert::h3res_to_resolution(res).expect("resolution");
+    let len = usize::try_from(CellIndex::uncompact_size(
+        cells.iter().copied(),
+        resolution,
+    ))
+    .expect("too many cells");
+    let children = CellIndex::uncompact(cells.iter().copied(), resolution);
+    write_cells(children, len, out, maxOut, count)
+}
+
+/// polygonToCompactCellsCached is polygonToCompactCells, with the fills
+/// cached (see polygonToCellsCached).
+///
+/// @param cache      The cache created by createPolygonCache
+/// @param geoPolygon The geoloop and holes defining the relevant area
+/// @param res        The Hexagon resolution (0-15)
+/// @param flags      Containment mode (see ContainmentMode)
+/// @param out        Output array
+/// @param maxOut     Size of the output array
+/// @param count      Number of cells of the compacted set
+/// @return 0 (E_SUCCESS) on success.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `maxOut` elements.
+#[no_mangle]
+pub unsafe extern "C" fn polygonToCompactCellsCached(
+    cache: Option<&H3PolygonCache>,
+    geoPolygon: Option<&GeoPolygon>,
+    res: c_int,
+    flags: u32,
+    out: *mut H3Index,
+    maxOut: i64,
+    count: Option<&mut i64>,
+) -> H3Error {
+    let Some(geoPolygon) = geoPolygon else {
+        return H3ErrorCodes::EFailed.into();
+    };
+    match cache.expect("null pointer").fill(geoPolygon, res, flags) {
+        Ok(cells) => {
+            write_cells(cells.iter().copied(), cells.len(), out, maxOut, count)
+        }
+        Err(err) => err,
+    }
+}
+
+/// polygonCacheStats returns the activity and the memory use of a polygon
+/// cache.
+///
+/// @param cache  The cache created by createPolygonCache
+/// @param hits   Number of fills served from the cache
+/// @param misses Number of fills that were computed
+/// @param bytes  Estimated memory used by the cached fills
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn polygonCacheStats(
+    cache: Option<&H3PolygonCache>,
+    hits: Option<&mut i64>,
+    misses: Option<&mut i64>,
+    bytes: Option<&mut i64>,
+) -> H3Error {
+    let cache = cache.expect("null pointer").cache.lock().expect("poisoned");
+    let load = |value: u64| i64::try_from(value).unwrap_or(i64::MAX);
+    *hits.expect("null pointer") = load(cache.hits);
+    *misses.expect("null pointer") = load(cache.misses);
+    *bytes.expect("null pointer") =
+        i64::try_from(cache.bytes).unwrap_or(i64::MAX);
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Free all allocated memory for a polygon cache.
+///
+/// @param cache The cache to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`createPolygonCache`].
+#[no_mangle]
+pub unsafe extern "C" fn destroyPolygonCache(cache: *mut H3PolygonCache) {
+    if !cache.is_null() {
+        drop(Box::from_raw(cache));
+    }
+}
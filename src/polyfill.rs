@@ -0,0 +1,627 @@
+//! Polygon filling building blocks shared by the polyfill entry points.
+
+use crate::{parallel, GeoPolygon, H3Error, H3Index};
+use geo_types::{Coord, LineString, Polygon};
+use h3o::{
+    geom::{ContainmentMode, PolyfillConfig, Polygon as h3oPolygon, ToCells},
+    CellIndex, Resolution,
+};
+use std::f64::consts::{FRAC_PI_2, PI, TAU};
+
+/// Resolution difference between the tiles and the cells of a parallel fill.
+///
+/// Every tile yields 7^3 (343) candidate cells.
+const TILE_RES_OFFSET: u8 = 3;
+
+/// Average number of edges per latitude band of a `PlanarPolygon`.
+const EDGES_PER_BAND: usize = 4;
+
+/// Maximum number of latitude bands of a `PlanarPolygon`.
+const MAX_BANDS: usize = 4096;
+
+/// Resolution difference between the filled cells and the cells where a fill
+/// size estimation stops refining the polygon boundary.
+///
+/// Every cell still crossed by the boundary counts for its 7^2 (49)
+/// descendants.
+pub const ESTIMATE_RES_OFFSET: u8 = 2;
+
+/// Slack added to the radius of the caps enclosing the descendants of a cell,
+/// to absorb the rounding errors of the projections.
+const DESCENDANTS_CAP_SLACK: f64 = 1e-9;
+
+/// A polygon (in radians) indexed for fast point-in-polygon tests.
+///
+/// Points are tested exactly as h3o's polyfill tests the cell centroids (the
+/// ray casting of H3's `pointInsideGeoLoop`, tie-breaking included): a point
+/// is inside the polygon when it's inside the exterior ring and outside every
+/// hole. The fills built on top of it therefore select the same cells as
+/// `polygonToCells`.
+pub struct PlanarPolygon {
+    /// Exterior ring.
+    exterior: PlanarRing,
+    /// Holes.
+    interiors: Vec<PlanarRing>,
+}
+
+impl PlanarPolygon {
+    pub fn new(polygon: &Polygon) -> Self {
+        Self {
+            exterior: PlanarRing::new(polygon.exterior()),
+            interiors: polygon
+                .interiors()
+                .iter()
+                .map(PlanarRing::new)
+                .collect(),
+        }
+    }
+
+    /// Tests if the point (in radians) is inside the polygon.
+    pub fn contains(&self, lat: f64, lng: f64) -> bool {
+        self.exterior.contains(lat, lng)
+            && !self.interiors.iter().any(|ring| ring.contains(lat, lng))
+    }
+
+    /// Tests if the centroid of the cell is inside the polygon.
+    pub fn contains_centroid(&self, cell: CellIndex) -> bool {
+        let ll = h3o::LatLng::from(cell);
+        self.contains(ll.lat_radians(), ll.lng_radians())
+    }
+
+    /// Tests if every descendant of the cell (centroid and boundary) is inside
+    /// (or outside) the polygon.
+    ///
+    /// Children are not exactly contained in their parent, but the overhang
+    /// is bounded: in the plane of the icosahedron face, a child centroid is
+    /// `√3·R/√7` away from the centroid of its parent of circumradius `R`, so
+    /// the descendants of a cell, at any resolution, stay within
+    /// `√3·R/(√7 - 1) + R/√7 ≈ 1.43·R` of its centroid. The cell and its
+    /// neighbors cover a disk of radius `2·R` (the nearest point out of them
+    /// is a vertex of the second ring), so every descendant lies within the
+    /// one-ring of the cell. The one-ring lies within the spherical cap
+    /// reaching its farthest vertex, whose latitude/longitude box is exact.
+    /// The margin (`2·R` versus `1.43·R`) absorbs the distortion of the
+    /// projection across the ring, including around pentagons.
+    ///
+    /// Returns `None` when the boundary of the polygon may cross the
+    /// descendants, or when the cap contains a pole.
+    pub fn classify_descendants(&self, cell: CellIndex) -> Option<bool> {
+        let center = h3o::LatLng::from(cell);
+        let mut radius = 0_f64;
+        for neighbor in cell.grid_disk::<Vec<_>>(1) {
+            for vertex in neighbor.boundary().iter() {
+                radius = radius.max(center.distance_rads(*vertex));
+            }
+        }
+        radius += DESCENDANTS_CAP_SLACK;
+
+        let (lat, lng) = (center.lat_radians(), center.lng_radians());
+        if lat.abs() + radius >= FRAC_PI_2 {
+            return None;
+        }
+        // Half-width of the cap: the longitude of the meridian tangent to it.
+        let half_width = (radius.sin() / lat.cos()).asin();
+        let min = Coord {
+            x: lng - half_width,
+            y: lat - radius,
+        };
+        let max = Coord {
+            x: lng + half_width,
+            y: lat + radius,
+        };
+
+        // Outside of the exterior ring is outside of the polygon, whatever
+        // the holes.
+        let mut inside = self.exterior.classify_box(min, max)?;
+        for ring in &self.interiors {
+            if !inside {
+                break;
+            }
+            inside = !ring.classify_box(min, max)?;
+        }
+        Some(inside)
+    }
+}
+
+/// A ring of a `PlanarPolygon`.
+///
+/// Edges are bucketed per latitude band, so that the ray casting only has to
+/// consider the edges overlapping the latitude of the tested point instead of
+/// every edge of the ring.
+struct PlanarRing {
+    /// Edges, in the longitude range of the ring.
+    edges: Vec<(Coord, Coord)>,
+    /// Upper latitude bounds of the bands (except the last one).
+    bounds: Vec<f64>,
+    /// IDs of the edges overlapping each latitude band.
+    bands: Vec<Vec<usize>>,
+    /// Bounding box, used to reject points early.
+    min: Coord,
+    max: Coord,
+    /// Whether the ring crosses the antimeridian (in which case negative
+    /// longitudes are shifted by 2π).
+    transmeridian: bool,
+}
+
+impl PlanarRing {
+    fn new(ring: &LineString) -> Self {
+        let transmeridian = ring
+            .lines()
+            .any(|line| (line.start.x - line.end.x).abs() > PI);
+        let shift = |coord: Coord| Coord {
+            x: normalize_lng(coord.x, transmeridian),
+            y: coord.y,
+        };
+
+        let mut min = Coord {
+            x: f64::INFINITY,
+            y: f64::INFINITY,
+        };
+        let mut max = Coord {
+            x: f64::NEG_INFINITY,
+            y: f64::NEG_INFINITY,
+        };
+        let edges = ring
+            .lines()
+            .map(|line| {
+                let (start, end) = (shift(line.start), shift(line.end));
+                min.x = min.x.min(start.x);
+                min.y = min.y.min(start.y);
+                max.x = max.x.max(start.x);
+                max.y = max.y.max(start.y);
+                (start, end)
+            })
+            .collect::<Vec<_>>();
+
+        let band_count = (edges.len() / EDGES_PER_BAND).clamp(1, MAX_BANDS);
+        let height = (max.y - min.y)
+            / f64::from(u32::try_from(band_count).expect("too many bands"));
+        let bounds = (1..band_count)
+            .map(|i| {
+                let i = u32::try_from(i).expect("too many bands");
+                height.mul_add(f64::from(i), min.y)
+            })
+            .collect::<Vec<_>>();
+
+        let mut ring = Self {
+            edges,
+            bounds,
+            bands: vec![Vec::new(); band_count],
+            min,
+            max,
+            transmeridian,
+        };
+        for (id, &(start, end)) in ring.edges.iter().enumerate() {
+            let lo = ring.band(start.y.min(end.y));
+            let hi = ring.band(start.y.max(end.y));
+            for band in &mut ring.bands[lo..=hi] {
+                band.push(id);
+            }
+        }
+
+        ring
+    }
+
+    /// Tests if the point (in radians) is inside the ring.
+    fn contains(&self, lat: f64, lng: f64) -> bool {
+        let lng = normalize_lng(lng, self.transmeridian);
+        if lat < self.min.y
+            || lat > self.max.y
+            || lng < self.min.x
+            || lng > self.max.x
+        {
+            return false;
+        }
+
+        // The edges of the band are enough, unless the point is moved off a
+        // vertex latitude (then every edge is checked, in order, as h3o does).
+        let band = self.bands[self.band(lat)].iter().copied();
+        self.cast(band, lat, lng, false).unwrap_or_else(|| {
+            self.cast(0..self.edges.len(), lat, lng, true)
+                .expect("exhaustive ray casting")
+        })
+    }
+
+    /// Casts a ray east of the point across the given edges (even-odd rule),
+    /// breaking the ties like h3o: points on a vertex latitude are moved north
+    /// and points on a vertex longitude are moved west.
+    ///
+    /// Returns `None` if the point has to be moved north and `exhaustive` is
+    /// false, since the moved point may then cross other edges than the given
+    /// ones.
+    #[allow(clippy::float_cmp, reason = "exact ties, as in h3o")]
+    fn cast(
+        &self,
+        ids: impl Iterator<Item = usize>,
+        mut lat: f64,
+        mut lng: f64,
+        exhaustive: bool,
+    ) -> Option<bool> {
+        let mut inside = false;
+        for id in ids {
+            let (mut a, mut b) = self.edges[id];
+            if a.y > b.y {
+                std::mem::swap(&mut a, &mut b);
+            }
+            if lat == a.y || lat == b.y {
+                if !exhaustive {
+                    return None;
+                }
+                lat += f64::EPSILON;
+            }
+            if lat < a.y || lat > b.y {
+                continue;
+            }
+            if a.x == lng || b.x == lng {
+                lng -= f64::EPSILON;
+            }
+            let ratio = (lat - a.y) / (b.y - a.y);
+            if (b.x - a.x).mul_add(ratio, a.x) > lng {
+                inside = !inside;
+            }
+        }
+        Some(inside)
+    }
+
+    /// Tests if the box (in radians) is inside or outside the ring, `None` if
+    /// an edge crosses it.
+    fn classify_box(&self, mut min: Coord, mut max: Coord) -> Option<bool> {
+        // Move the box in the longitude range of the ring, splitting it when
+        // it straddles the end of the range.
+        let cut = if self.transmeridian { 0. } else { -PI };
+        let shift = ((min.x - cut) / TAU).floor() * TAU;
+        min.x -= shift;
+        max.x -= shift;
+        if max.x < cut + TAU {
+            return self.classify_range(min, max);
+        }
+        let head = self.classify_range(
+            min,
+            Coord {
+                x: cut + TAU,
+                y: max.y,
+            },
+        )?;
+        let tail = self.classify_range(
+            Coord { x: cut, y: min.y },
+            Coord {
+                x: max.x - TAU,
+                y: max.y,
+            },
+        )?;
+        (head == tail).then_some(head)
+    }
+
+    /// Tests if the box (in the longitude range of the ring) is inside or
+    /// outside the ring, `None` if an edge crosses it.
+    fn classify_range(&self, min: Coord, max: Coord) -> Option<bool> {
+        if max.y < self.min.y
+            || min.y > self.max.y
+            || max.x < self.min.x
+            || min.x > self.max.x
+        {
+            return Some(false);
+        }
+
+        for band in &self.bands[self.band(min.y)..=self.band(max.y)] {
+            for &id in band {
+                let (start, end) = self.edges[id];
+                if segment_intersects_box(start, end, min, max) {
+                    return None;
+                }
+            }
+        }
+
+        // No edge crosses the box: every point shares the side of its center.
+        Some(
+            self.contains(
+                f64::midpoint(min.y, max.y),
+                f64::midpoint(min.x, max.x),
+            ),
+        )
+    }
+
+    /// Returns the latitude band containing the given latitude.
+    fn band(&self, lat: f64) -> usize {
+        self.bounds.partition_point(|&bound| bound <= lat)
+    }
+}
+
+/// Shifts negative longitudes by 2π for rings crossing the antimeridian.
+fn normalize_lng(lng: f64, transmeridian: bool) -> f64 {
+    if transmeridian && lng < 0. {
+        lng + TAU
+    } else {
+        lng
+    }
+}
+
+/// Tests if the segment intersects the box, using Liang-Barsky clipping.
+fn segment_intersects_box(
+    start: Coord,
+    end: Coord,
+    min: Coord,
+    max: Coord,
+) -> bool {
+    let delta = end - start;
+    let (mut enter, mut exit) = (0_f64, 1_f64);
+    for (p, q) in [
+        (-delta.x, start.x - min.x),
+        (delta.x, max.x - start.x),
+        (-delta.y, start.y - min.y),
+        (delta.y, max.y - start.y),
+    ] {
+        if p < 0. {
+            enter = enter.max(q / p);
+        } else if p > 0. {
+            exit = exit.min(q / p);
+        } else if q < 0. {
+            // Parallel to this side of the box, and outside.
+            return false;
+        }
+        if enter > exit {
+            return false;
+        }
+    }
+    true
+}
+
+/// Fills the polygon (centroid containment) into a compacted set of cells.
+///
+/// Cells whose descendants are all inside (or all outside) the polygon are
+/// settled at once, starting from the base cells, and only the cells crossed
+/// by the polygon boundary are refined down to `resolution`. The work and the
+/// output therefore scale with the perimeter of the polygon, not its area.
+pub fn compact_fill(
+    planar: &PlanarPolygon,
+    resolution: Resolution,
+) -> Vec<CellIndex> {
+    let mut cells = Vec::new();
+    for cell in CellIndex::base_cells() {
+        if refine(planar, cell, resolution, &mut cells) {
+            cells.push(cell);
+        }
+    }
+    cells
+}
+
+/// Appends the compacted fill of the cell to `out`, unless the cell is full in
+/// which case nothing is appended and `true` is returned.
+fn refine(
+    planar: &PlanarPolygon,
+    cell: CellIndex,
+    resolution: Resolution,
+    out: &mut Vec<CellIndex>,
+) -> bool {
+    if cell.resolution() == resolution {
+        return planar.contains_centroid(cell);
+    }
+    if let Some(inside) = planar.classify_descendants(cell) {
+        return inside;
+    }
+    let next = cell.resolution().succ().expect("finer resolution");
+
+    let start = out.len();
+    let mut full = true;
+    for child in cell.children(next) {
+        if refine(planar, child, resolution, out) {
+            out.push(child);
+        } else {
+            full = false;
+        }
+    }
+    // Every child is full: the cell replaces them.
+    if full {
+        out.truncate(start);
+    }
+    full
+}
+
+/// Counts the cells of a centroid fill, without producing them.
+///
+/// The cells are refined as in `compact_fill`, except that the cells still
+/// crossed by the polygon boundary at `coarse` are counted with all their
+/// descendants. Since the centroids are tested like in h3o's fill, this gives
+/// an upper bound of its size, cheaper the coarser `coarse` is, and the exact
+/// count when `coarse` is `resolution`.
+pub fn cells_count(
+    planar: &PlanarPolygon,
+    resolution: Resolution,
+    coarse: Resolution,
+) -> u64 {
+    CellIndex::base_cells()
+        .map(|cell| count(planar, cell, resolution, coarse))
+        .sum()
+}
+
+/// Counts the descendants of the cell in the fill, see `cells_count`.
+fn count(
+    planar: &PlanarPolygon,
+    cell: CellIndex,
+    resolution: Resolution,
+    coarse: Resolution,
+) -> u64 {
+    if cell.resolution() == resolution {
+        return planar.contains_centroid(cell).into();
+    }
+    match planar.classify_descendants(cell) {
+        Some(true) => cell.children_count(resolution),
+        Some(false) => 0,
+        None if cell.resolution() >= coarse => cell.children_count(resolution),
+        None => {
+            let next = cell.resolution().succ().expect("finer resolution");
+            cell.children(next)
+                .map(|child| count(planar, child, resolution, coarse))
+                .sum()
+        }
+    }
+}
+
+/// Fills the polygon (centroid containment) using every available worker.
+///
+/// The polygon extent is covered by coarser tiles (with a one-ring buffer,
+/// since children may stick out of their parent but not out of its one-ring,
+/// see `classify_descendants`), and the tiles are processed concurrently:
+/// tiles away from the polygon boundary are kept or dropped whole, and the
+/// children of the others are tested with the centroid test of h3o's fill, so
+/// the result has the same cells as the sequential fill. Every cell has
+/// exactly one parent tile, so the result contains no duplicate.
+///
+/// The cells are returned by chunks, so that the workers can also write them
+/// to the output.
+pub fn parallel_fill(
+    polygon: &h3oPolygon,
+    planar: &PlanarPolygon,
+    resolution: Resolution,
+) -> Vec<Vec<CellIndex>> {
+    let config = PolyfillConfig::new(resolution);
+    let Some(tile_res) = u8::from(resolution)
+        .checked_sub(TILE_RES_OFFSET)
+        .and_then(|res| Resolution::try_from(res).ok())
+    else {
+        // Coarse resolutions have too few cells to make splitting worth it.
+        return vec![polygon.to_cells(config).collect()];
+    };
+
+    let tile_config = PolyfillConfig::new(tile_res)
+        .containment_mode(ContainmentMode::IntersectsBoundary);
+    let mut tiles = polygon
+        .to_cells(tile_config)
+        .flat_map(|tile| tile.grid_disk::<Vec<_>>(1))
+        .collect::<Vec<_>>();
+    tiles.sort_unstable();
+    tiles.dedup();
+
+    parallel::map_chunks(&tiles, |tiles| {
+        let mut cells = Vec::new();
+        for &tile in tiles {
+            match planar.classify_descendants(tile) {
+                Some(true) => cells.extend(tile.children(resolution)),
+                Some(false) => {}
+                None => cells.extend(
+                    tile.children(resolution)
+                        .filter(|&cell| planar.contains_centroid(cell)),
+                ),
+            }
+        }
+        cells
+    })
+}
+
+/// A polygon converted once, reusable across resolutions and calls.
+pub struct H3PreparedPolygon {
+    /// Converted polygon, `None` for empty polygons (which contain no cell).
+    polygon: Option<h3oPolygon>,
+    /// Edge index for point-in-polygon tests, `None` for empty polygons.
+    planar: Option<PlanarPolygon>,
+}
+
+impl H3PreparedPolygon {
+    /// Tests if the point (in radians) is inside the polygon.
+    #[must_use]
+    pub fn contains(&self, lat: f64, lng: f64) -> bool {
+        self.planar
+            .as_ref()
+            .is_some_and(|planar| planar.contains(lat, lng))
+    }
+
+    /// Returns an upper bound of the number of cells of a fill.
+    #[must_use]
+    pub fn max_cells_count(&self, config: PolyfillConfig) -> usize {
+        self.polygon
+            .as_ref()
+            .map_or(0, |polygon| polygon.max_cells_count(config))
+    }
+
+    /// Returns the cells of a fill.
+    #[must_use]
+    pub fn to_cells(
+        &self,
+        config: PolyfillConfig,
+    ) -> Box<dyn Iterator<Item = CellIndex> + '_> {
+        self.polygon.as_ref().map_or_else(
+            || Box::new(std::iter::empty()) as Box<dyn Iterator<Item = _>>,
+            |polygon| polygon.to_cells(config),
+        )
+    }
+}
+
+impl TryFrom<GeoPolygon> for H3PreparedPolygon {
+    type Error = H3Error;
+
+    fn try_from(value: GeoPolygon) -> Result<Self, Self::Error> {
+        // Empty polygon contains no cell.
+        if value.geoloop.numVerts == 0 {
+            return Ok(Self {
+                polygon: None,
+                planar: None,
+            });
+        }
+
+        let polygon = Polygon::try_from(value)?;
+        let planar = PlanarPolygon::new(&polygon);
+        Ok(Self {
+            polygon: Some(h3oPolygon::from_radians(polygon)?),
+            planar: Some(planar),
+        })
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/// Cursor over the cells of a polygon, to fill it by bounded chunks.
+pub struct H3PolygonCursor {
+    /// Remaining cells, borrowing from `polygon`.
+    cells: Option<Box<dyn Iterator<Item = CellIndex>>>,
+    /// Polygon being filled.
+    polygon: *mut H3PreparedPolygon,
+}
+
+impl H3PolygonCursor {
+    /// Initializes a cursor over the cells of the polygon.
+    #[must_use]
+    pub fn new(polygon: H3PreparedPolygon, config: PolyfillConfig) -> Self {
+        let polygon = Box::into_raw(Box::new(polygon));
+        // SAFETY: the polygon is heap-allocated (stable address), never
+        // mutated nor moved and only freed after the iterator borrowing it
+        // (see `Drop`), so the borrow outlives the iterator.
+        let cells = unsafe {
+            let cells = (*polygon).to_cells(config);
+            std::mem::transmute::<
+                Box<dyn Iterator<Item = CellIndex> + '_>,
+                Box<dyn Iterator<Item = CellIndex>>,
+            >(cells)
+        };
+
+        Self {
+            cells: Some(cells),
+            polygon,
+        }
+    }
+
+    /// Writes the next cells into `out`, returning how many were written.
+    ///
+    /// Returns 0 once every cell has been produced.
+    pub fn fill(&mut self, out: &mut [H3Index]) -> usize {
+        let Some(cells) = self.cells.as_mut() else {
+            return 0;
+        };
+        let mut count = 0;
+        // `out` comes first to avoid consuming a cell that wouldn't fit.
+        for (dst, cell) in out.iter_mut().zip(cells) {
+            *dst = cell.into();
+            count += 1;
+        }
+        count
+    }
+}
+
+impl Drop for H3PolygonCursor {
+    fn drop(&mut self) {
+        // Release the iterator before the polygon it borrows from.
+        self.cells = None;
+        // SAFETY: allocated by `Box::into_raw` in `new`, and no longer
+        // borrowed.
+        drop(unsafe { Box::from_raw(self.polygon) });
+    }
+}
@@ -1,6 +1,49 @@
 use crate::{convert, delegate_inner, H3Error, H3ErrorCodes, H3Index};
 use h3o::{BaseCell, CellIndex, Resolution};
-use std::ffi::c_int;
+use std::{ffi::c_int, sync::OnceLock};
+
+/// Number of resolutions.
+pub const H3_RES_COUNT: usize = 16;
+
+/// Number of resolution 0 cells (see res0CellCount).
+pub const H3_RES0_CELL_COUNT: usize = 122;
+
+/// Number of pentagons at every resolution (see pentagonCount).
+pub const H3_PENTAGON_COUNT: usize = 12;
+
+/// Every resolution 0 cell, in the order of getRes0Cells.
+///
+/// Constant data: no call needed to read it.
+#[no_mangle]
+pub static H3_RES0_CELLS: [H3Index; H3_RES0_CELL_COUNT] = res0_cells();
+
+/// Every pentagon, by resolution, in the order of getPentagons.
+///
+/// Constant data: no call needed to read it.
+#[no_mangle]
+pub static H3_PENTAGONS: [[H3Index; H3_PENTAGON_COUNT]; H3_RES_COUNT] =
+    pentagons();
+
+/// Number of cells at every resolution, as returned by getNumCells.
+///
+/// Constant data: no call needed to read it.
+#[no_mangle]
+pub static H3_NUM_CELLS: [i64; H3_RES_COUNT] = num_cells();
+
+/// Average hexagon sizes of every resolution, as returned by
+/// getHexagonAreaAvgKm2 and friends (see getResolutionStats).
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct H3ResolutionStats {
+    /// Average hexagon area, in square kilometers.
+    pub hexagonAreaAvgKm2: [f64; H3_RES_COUNT],
+    /// Average hexagon area, in square meters.
+    pub hexagonAreaAvgM2: [f64; H3_RES_COUNT],
+    /// Average hexagon edge length, in kilometers.
+    pub hexagonEdgeLengthAvgKm: [f64; H3_RES_COUNT],
+    /// Average hexagon edge length, in meters.
+    pub hexagonEdgeLengthAvgM: [f64; H3_RES_COUNT],
+}
 
 /// Average hexagon area in square kilometers (excludes pentagons).
 #[no_mangle]
@@ -73,6 +116,31 @@ pub extern "C" fn getNumCells(res: c_int, out: Option<&mut i64>) -> H3Error {
     delegate_inner!(inner(res), out)
 }
 
+/// getResolutionStats returns the average hexagon sizes of every resolution
+/// at once, for lookups in hot loops instead of calls per resolution.
+///
+/// @param out The statistics of every resolution
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn getResolutionStats(
+    out: Option<&mut H3ResolutionStats>,
+) -> H3Error {
+    let stat = |f: fn(Resolution) -> f64| {
+        std::array::from_fn(|res| {
+            f(Resolution::try_from(u8::try_from(res).expect("resolution"))
+                .expect("resolution"))
+        })
+    };
+
+    *out.expect("null pointer") = H3ResolutionStats {
+        hexagonAreaAvgKm2: stat(Resolution::area_km2),
+        hexagonAreaAvgM2: stat(Resolution::area_m2),
+        hexagonEdgeLengthAvgKm: stat(Resolution::edge_length_km),
+        hexagonEdgeLengthAvgM: stat(Resolution::edge_length_m),
+    };
+    H3ErrorCodes::ESuccess.into()
+}
+
 /// Generates all pentagons at the specified resolution
 ///
 /// @param res The resolution to produce pentagons at.
@@ -154,3 +222,103 @@ pub extern "C" fn pentagonCount() -> c_int {
 pub extern "C" fn res0CellCount() -> c_int {
     BaseCell::count().into()
 }
+
+/// isPentagonNeighbor tells if a cell shares an edge with a pentagon (of the
+/// same resolution), i.e. is in the distorted first ring of a pentagon.
+///
+/// The neighbors of every pentagon are computed on the first call, the next
+/// ones are a lookup in a table of 960 cells.
+///
+/// @param h   The H3 cell
+/// @param out Set to 1 if the cell is a neighbor of a pentagon, 0 otherwise
+///            (including for pentagons).
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn isPentagonNeighbor(
+    h: H3Index,
+    out: Option<&mut c_int>,
+) -> H3Error {
+    fn inner(h: H3Index) -> Result<c_int, H3Error> {
+        CellIndex::try_from(h)?;
+        Ok(pentagon_neighbors().binary_search(&h).is_ok().into())
+    }
+
+    delegate_inner!(inner(h), out)
+}
+
+// -----------------------------------------------------------------------------
+
+/// Base cells of the pentagons.
+const PENTAGON_BASE_CELLS: [u64; H3_PENTAGON_COUNT] =
+    [4, 14, 24, 38, 49, 58, 63, 72, 83, 97, 107, 117];
+
+/// Header of a cell index (cell mode, no reserved bits).
+const CELL_HEADER: u64 = 1 << 59;
+
+/// Returns the index of the center descendant of a base cell, at `res`.
+const fn base_cell_center(base_cell: u64, res: u64) -> H3Index {
+    // Digits up to `res` are 0 (center), the next ones are 7 (unused).
+    CELL_HEADER
+        | (res << 52)
+        | (base_cell << 45)
+        | ((1 << (3 * (15 - res))) - 1)
+}
+
+const fn res0_cells() -> [H3Index; H3_RES0_CELL_COUNT] {
+    let mut table = [0; H3_RES0_CELL_COUNT];
+    let (mut i, mut base_cell) = (0, 0);
+    while i < table.len() {
+        table[i] = base_cell_center(base_cell, 0);
+        i += 1;
+        base_cell += 1;
+    }
+    table
+}
+
+const fn pentagons() -> [[H3Index; H3_PENTAGON_COUNT]; H3_RES_COUNT] {
+    let mut table = [[0; H3_PENTAGON_COUNT]; H3_RES_COUNT];
+    let (mut i, mut res) = (0, 0);
+    while i < table.len() {
+        let mut j = 0;
+        while j < H3_PENTAGON_COUNT {
+            table[i][j] = base_cell_center(PENTAGON_BASE_CELLS[j], res);
+            j += 1;
+        }
+        i += 1;
+        res += 1;
+    }
+    table
+}
+
+const fn num_cells() -> [i64; H3_RES_COUNT] {
+    // 2 + 120 * 7^res (12 pentagons with 6 children, 110 hexagons with 7).
+    let mut table = [0; H3_RES_COUNT];
+    let (mut i, mut pow) = (0, 1);
+    while i < table.len() {
+        table[i] = 2 + 120 * pow;
+        i += 1;
+        pow *= 7;
+    }
+    table
+}
+
+/// Returns the neighbors of every pentagon, at every resolution, sorted.
+fn pentagon_neighbors() -> &'static [H3Index] {
+    static NEIGHBORS: OnceLock<Vec<H3Index>> = OnceLock::new();
+    NEIGHBORS.get_or_init(|| {
+        let mut neighbors = H3_PENTAGONS
+            .iter()
+            .flatten()
+            .flat_map(|&pentagon| {
+                let pentagon = CellIndex::try_from(pentagon).expect("pentagon");
+                pentagon
+                    .grid_disk::<Vec<_>>(1)
+                    .into_iter()
+                    .filter(move |&cell| cell != pentagon)
+                    .map(H3Index::from)
+            })
+            .collect::<Vec<_>>();
+        neighbors.sort_unstable();
+        neighbors
+    })
+}
@@ -0,0 +1,306 @@
+//! Sorting of large index arrays.
+//!
+//! Indexes are sorted with an LSD radix sort, one byte at a time. The passes
+//! over the bytes every index has in common are skipped: for cells, that's at
+//! least the high byte (mode and reserved bits), and usually the low bytes as
+//! well (unused digits of a single-resolution set) and the base cell bits of a
+//! regional set. What's left is bucketing by resolution, base cell and
+//! leading digits.
+
+use crate::{cell, parallel, H3Error, H3ErrorCodes, H3Index};
+use std::cmp::Ordering;
+
+/// Arrays up to this size are sorted with a comparison sort, cheaper than
+/// computing the radix histograms.
+const SMALL_SORT_SIZE: usize = 256;
+
+/// Arrays below this size are sorted on the calling thread only.
+const PARALLEL_SORT_SIZE: usize = 1 << 16;
+
+/// Number of bytes of an index.
+const INDEX_BYTES: usize = 8;
+
+/// Number of buckets of a radix pass.
+const RADIX: usize = 256;
+
+/// Bits of an index below the resolution (base cell and digits).
+const CELL_BITS_MASK: u64 = (1 << 52) - 1;
+
+/// Header of a cell index (cell mode, no reserved bits), as the high byte.
+const CELL_HEADER: u64 = 0b0000_1000 << 56;
+
+/// Sorts an array of indexes in ascending order.
+///
+/// The order is the one of `qsort` with an integer comparison: cells are
+/// grouped by resolution, then by base cell, and sorted by digits (i.e. the
+/// children of a cell are contiguous).
+///
+/// @param cells    The indexes to sort, in place.
+/// @param numCells The number of indexes.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn h3SortCells(
+    cells: *mut H3Index,
+    numCells: i64,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let cells = std::slice::from_raw_parts_mut(cells, len);
+
+    sort(cells, false);
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Parallel version of h3SortCells: the indexes are bucketed on their leading
+/// bits on the calling thread, and the buckets are sorted on the library
+/// thread pool.
+///
+/// @param cells    The indexes to sort, in place.
+/// @param numCells The number of indexes.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn h3SortCellsParallel(
+    cells: *mut H3Index,
+    numCells: i64,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let cells = std::slice::from_raw_parts_mut(cells, len);
+
+    sort(cells, true);
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Sorts an array of cells, at any resolution, in hierarchical order: every
+/// cell is directly followed by its descendants, and the descendants of a
+/// cell are ordered by digits (a space-filling curve, so that neighboring
+/// cells mostly end up close in the array).
+///
+/// Unlike the ascending order, a mixed-resolution set isn't grouped by
+/// resolution, which keeps the iterations over the neighbors of the cells
+/// (e.g. of a compacted set) cache-friendly.
+///
+/// @param cells    The cells to sort, in place.
+/// @param numCells The number of cells.
+/// @return E_CELL_INVALID (and the array is left untouched) if an index isn't a
+/// valid cell.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn h3SortCellsByLocality(
+    cells: *mut H3Index,
+    numCells: i64,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numCells) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let cells = std::slice::from_raw_parts_mut(cells, len);
+    if !cells.iter().all(|&index| cell::is_valid_cell_bits(index)) {
+        return H3ErrorCodes::ECellInvalid.into();
+    }
+
+    sort_by_locality(cells);
+    H3ErrorCodes::ESuccess.into()
+}
+
+// -----------------------------------------------------------------------------
+
+/// Sorts valid cells in hierarchical order (see `h3SortCellsByLocality`).
+pub fn sort_by_locality(cells: &mut [u64]) {
+    for index in cells.iter_mut() {
+        *index = locality_key(*index);
+    }
+    sort(cells, false);
+    for index in cells.iter_mut() {
+        *index = from_locality_key(*index);
+    }
+}
+
+/// Compares two valid cells in hierarchical order.
+pub fn locality_cmp(a: u64, b: u64) -> Ordering {
+    locality_key(a).cmp(&locality_key(b))
+}
+
+/// Returns the bit mask of the unused digits of a cell at `resolution`.
+const fn unused_digits_mask(resolution: u64) -> u64 {
+    (1 << (3 * (15 - resolution))) - 1
+}
+
+/// Maps a cell to an integer ordering the cells hierarchically.
+///
+/// The unused digits are cleared, so that a cell compares lower than its
+/// descendants, and the resolution moves to the low bits, where it only breaks
+/// the tie between a cell and its center children.
+const fn locality_key(index: u64) -> u64 {
+    let resolution = (index >> 52) & 0xf;
+    let bits = index & CELL_BITS_MASK & !unused_digits_mask(resolution);
+    (bits << 4) | resolution
+}
+
+/// Inverse of `locality_key`.
+const fn from_locality_key(key: u64) -> u64 {
+    let resolution = key & 0xf;
+    CELL_HEADER
+        | (resolution << 52)
+        | (key >> 4)
+        | unused_digits_mask(resolution)
+}
+
+/// Sorts indexes in ascending order (unless they already are), on the thread
+/// pool if `parallel`, and removes the duplicates.
+///
+/// Returns the number of distinct indexes, moved to the front of `values`.
+pub fn sort_dedup(values: &mut [u64], parallel: bool) -> usize {
+    if !values.is_sorted() {
+        sort(values, parallel);
+    }
+    let mut len = 0;
+    for i in 0..values.len() {
+        if len == 0 || values[i] != values[len - 1] {
+            values[len] = values[i];
+            len += 1;
+        }
+    }
+    len
+}
+
+/// Sorts indexes in ascending order, on the thread pool if `parallel`.
+fn sort(values: &mut [u64], parallel: bool) {
+    if values.len() <= SMALL_SORT_SIZE {
+        values.sort_unstable();
+        return;
+    }
+    let mut scratch = vec![0; values.len()];
+    if parallel && values.len() >= PARALLEL_SORT_SIZE {
+        parallel_radix_sort(values, &mut scratch);
+    } else {
+        radix_sort(values, &mut scratch);
+    }
+}
+
+/// Counts the occurrences of every value of every byte.
+fn histograms(values: &[u64]) -> [[usize; RADIX]; INDEX_BYTES] {
+    let mut counts = [[0; RADIX]; INDEX_BYTES];
+    for value in values {
+        for (counts, byte) in counts.iter_mut().zip(value.to_le_bytes()) {
+            counts[usize::from(byte)] += 1;
+        }
+    }
+    counts
+}
+
+/// Returns the start offset of every bucket, given their sizes.
+fn bucket_offsets(counts: &[usize; RADIX]) -> [usize; RADIX] {
+    let mut offsets = [0; RADIX];
+    let mut offset = 0;
+    for (start, count) in offsets.iter_mut().zip(counts) {
+        *start = offset;
+        offset += count;
+    }
+    offsets
+}
+
+/// LSD radix sort of `values`, using `scratch` (of the same size) as the
+/// buffer of the odd passes.
+fn radix_sort(values: &mut [u64], scratch: &mut [u64]) {
+    if values.len() <= SMALL_SORT_SIZE {
+        values.sort_unstable();
+        return;
+    }
+
+    let counts = histograms(values);
+    let len = values.len();
+    let mut src: &mut [u64] = values;
+    let mut dst: &mut [u64] = scratch;
+    let mut swapped = false;
+    for (byte, counts) in counts.iter().enumerate() {
+        // Every value has the same byte: the pass wouldn't move anything.
+        if counts.contains(&len) {
+            continue;
+        }
+        let mut offsets = bucket_offsets(counts);
+        for &value in src.iter() {
+            let digit = usize::from(value.to_le_bytes()[byte]);
+            dst[offsets[digit]] = value;
+            offsets[digit] += 1;
+        }
+        std::mem::swap(&mut src, &mut dst);
+        swapped = !swapped;
+    }
+    if swapped {
+        // The sorted values are in the scratch buffer.
+        dst.copy_from_slice(src);
+    }
+}
+
+/// Parallel radix sort: a first (MSD) pass buckets the values on the 8 most
+/// significant bits that aren't common to every value, then the buckets are
+/// sorted independently.
+fn parallel_radix_sort(values: &mut [u64], scratch: &mut [u64]) {
+    let first = values[0];
+    let differences = parallel::map_chunks(values, |chunk| {
+        chunk.iter().fold(0, |acc, &value| acc | (value ^ first))
+    })
+    .into_iter()
+    .fold(0, |acc, differences| acc | differences);
+    if differences == 0 {
+        // Every value is the same.
+        return;
+    }
+    let shift = (u64::BITS - differences.leading_zeros()).saturating_sub(8);
+    let digit = |value: u64| usize::from((value >> shift).to_le_bytes()[0]);
+
+    let mut counts = [0; RADIX];
+    for chunk_counts in parallel::map_chunks(values, |chunk| {
+        let mut counts = [0; RADIX];
+        for &value in chunk {
+            counts[digit(value)] += 1;
+        }
+        counts
+    }) {
+        for (count, chunk_count) in counts.iter_mut().zip(chunk_counts) {
+            *count += chunk_count;
+        }
+    }
+    let mut offsets = bucket_offsets(&counts);
+    for &value in values.iter() {
+        let digit = digit(value);
+        scratch[offsets[digit]] = value;
+        offsets[digit] += 1;
+    }
+
+    // The values of a bucket are sorted in the scratch buffer, using the
+    // matching part of the output as their own scratch, and copied back.
+    let mut tasks = Vec::with_capacity(RADIX);
+    let (mut out, mut buckets) = (values, scratch);
+    for &count in counts.iter().filter(|&&count| count != 0) {
+        let (out_head, out_tail) = out.split_at_mut(count);
+        let (bucket, buckets_tail) = buckets.split_at_mut(count);
+        tasks.push((out_head, bucket));
+        out = out_tail;
+        buckets = buckets_tail;
+    }
+    parallel::for_each(tasks, |(out, bucket)| {
+        radix_sort(bucket, out);
+        out.copy_from_slice(bucket);
+    });
+}
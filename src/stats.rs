@@ -0,0 +1,372 @@
+//! Opt-in call statistics of the main entry points.
+//!
+//! Every instrumented function starts a `Scope`, which records the call when
+//! dropped: number of calls, number of processed elements and latency
+//! histogram. The grid traversals also record which path they took: the fast
+//! algorithm, or the fallback (or error) caused by a pentagon. When the
+//! recording is disabled (see `h3SetStatsEnabled`), it only costs a relaxed
+//! load of the flag.
+
+use crate::{config, H3Error, H3ErrorCodes};
+use std::{
+    ffi::{c_char, c_int, CStr},
+    sync::atomic::{AtomicU64, Ordering},
+    time::Instant,
+};
+
+/// Number of buckets of the latency histograms.
+///
+/// Bucket `i` counts the calls that took between 2^i and 2^(i+1) nanoseconds
+/// (the first one starting at 0), the last one gathering every call longer
+/// than ~2 seconds.
+pub const H3_STATS_BUCKETS: usize = 32;
+
+/// Number of instrumented functions.
+pub const H3_STATS_FUNCTIONS: usize = 32;
+
+/// Number of grid traversals reporting their paths.
+pub const H3_STATS_PATHS: usize = 10;
+
+/// Instrumented functions.
+#[derive(Debug, Clone, Copy)]
+pub enum Function {
+    LatLngToCell,
+    LatLngsToCells,
+    LatLngsToCellsDegreesF32,
+    LatLngsToCellsMicrodegrees,
+    LatLngsToCellsMultiRes,
+    CellToLatLng,
+    CellsToLatLngs,
+    CellToBoundary,
+    CellsToBoundaries,
+    CellToParent,
+    CellToChildren,
+    CellsToChildrenCsr,
+    CellToChildrenForEach,
+    GridDisk,
+    GridDiskForEach,
+    GridDisksParallel,
+    GridDiskDistances,
+    GridDisksDistances,
+    GridDistance,
+    GridPathCells,
+    CompactCells,
+    UncompactCells,
+    PolygonToCells,
+    PolygonToCellsForEach,
+    PolygonToCellsSorted,
+    PolygonToCellsWs,
+    PolygonToCellsParallel,
+    PolygonToCellsCancellable,
+    MultiPolygonToCells,
+    CellsToLinkedMultiPolygon,
+    CellsToLinkedMultiPolygonParallel,
+    CellsToLinkedMultiPolygonCancellable,
+}
+
+/// Names of the instrumented functions, in the order of `Function`.
+const NAMES: [&CStr; H3_STATS_FUNCTIONS] = [
+    c"latLngToCell",
+    c"latLngsToCells",
+    c"latLngsToCellsDegreesF32",
+    c"latLngsToCellsMicrodegrees",
+    c"latLngsToCellsMultiRes",
+    c"cellToLatLng",
+    c"cellsToLatLngs",
+    c"cellToBoundary",
+    c"cellsToBoundaries",
+    c"cellToParent",
+    c"cellToChildren",
+    c"cellsToChildrenCSR",
+    c"cellToChildrenForEach",
+    c"gridDisk",
+    c"gridDiskForEach",
+    c"gridDisksParallel",
+    c"gridDiskDistances",
+    c"gridDisksDistances",
+    c"gridDistance",
+    c"gridPathCells",
+    c"compactCells",
+    c"uncompactCells",
+    c"polygonToCells",
+    c"polygonToCellsForEach",
+    c"polygonToCellsSorted",
+    c"polygonToCellsWs",
+    c"polygonToCellsParallel",
+    c"polygonToCellsCancellable",
+    c"multiPolygonToCells",
+    c"cellsToLinkedMultiPolygon",
+    c"cellsToLinkedMultiPolygonParallel",
+    c"cellsToLinkedMultiPolygonCancellable",
+];
+
+/// Grid traversals reporting their paths.
+#[derive(Debug, Clone, Copy)]
+pub enum GridPath {
+    Disk,
+    DiskDistances,
+    DiskCompact,
+    DisksParallel,
+    DisksDistances,
+    Ring,
+    DiskUnsafe,
+    DiskDistancesUnsafe,
+    DisksUnsafe,
+    RingUnsafe,
+}
+
+/// Names of the grid traversals, in the order of `GridPath`.
+const PATH_NAMES: [&CStr; H3_STATS_PATHS] = [
+    c"gridDisk",
+    c"gridDiskDistances",
+    c"gridDiskCompact",
+    c"gridDisksParallel",
+    c"gridDisksDistances",
+    c"gridRing",
+    c"gridDiskUnsafe",
+    c"gridDiskDistancesUnsafe",
+    c"gridDisksUnsafe",
+    c"gridRingUnsafe",
+];
+
+/// Counters of a function.
+struct Counters {
+    calls: AtomicU64,
+    elements: AtomicU64,
+    nanos: AtomicU64,
+    latencies: [AtomicU64; H3_STATS_BUCKETS],
+}
+
+impl Counters {
+    const fn new() -> Self {
+        Self {
+            calls: AtomicU64::new(0),
+            elements: AtomicU64::new(0),
+            nanos: AtomicU64::new(0),
+            latencies: [const { AtomicU64::new(0) }; H3_STATS_BUCKETS],
+        }
+    }
+}
+
+/// Counters of every instrumented function, shared by every thread.
+static COUNTERS: [Counters; H3_STATS_FUNCTIONS] =
+    [const { Counters::new() }; H3_STATS_FUNCTIONS];
+
+/// Path counters of a grid traversal.
+struct PathCounters {
+    fast: AtomicU64,
+    fallbacks: AtomicU64,
+    pentagons: AtomicU64,
+    wasted: AtomicU64,
+}
+
+impl PathCounters {
+    const fn new() -> Self {
+        Self {
+            fast: AtomicU64::new(0),
+            fallbacks: AtomicU64::new(0),
+            pentagons: AtomicU64::new(0),
+            wasted: AtomicU64::new(0),
+        }
+    }
+
+    /// Records work thrown away by a fallback or an error.
+    fn waste(&self, elements: usize) {
+        let elements = u64::try_from(elements).unwrap_or(u64::MAX);
+        self.wasted.fetch_add(elements, Ordering::Relaxed);
+    }
+}
+
+/// Path counters of every grid traversal, shared by every thread.
+static PATHS: [PathCounters; H3_STATS_PATHS] =
+    [const { PathCounters::new() }; H3_STATS_PATHS];
+
+/// Records a traversal completed by the fast algorithm.
+pub fn record_fast_path(path: GridPath) {
+    if config::stats_enabled() {
+        PATHS[path as usize].fast.fetch_add(1, Ordering::Relaxed);
+    }
+}
+
+/// Records a traversal that fell back on the slower algorithm, after writing
+/// `wasted` elements that had to be discarded.
+pub fn record_fallback(path: GridPath, wasted: usize) {
+    if config::stats_enabled() {
+        let counters = &PATHS[path as usize];
+        counters.fallbacks.fetch_add(1, Ordering::Relaxed);
+        counters.waste(wasted);
+    }
+}
+
+/// Records a traversal that failed with E_PENTAGON, after writing `wasted`
+/// elements.
+pub fn record_pentagon(path: GridPath, wasted: usize) {
+    if config::stats_enabled() {
+        let counters = &PATHS[path as usize];
+        counters.pentagons.fetch_add(1, Ordering::Relaxed);
+        counters.waste(wasted);
+    }
+}
+
+/// Records a call of an instrumented function when dropped.
+pub struct Scope {
+    function: Function,
+    /// Number of elements processed by the call.
+    elements: u64,
+    /// Start of the call, `None` when the recording is disabled.
+    start: Option<Instant>,
+}
+
+impl Scope {
+    /// Starts recording a call processing `elements` elements (negative
+    /// counts, which the call rejects, are recorded as zero).
+    #[must_use]
+    pub fn new(function: Function, elements: i64) -> Self {
+        Self {
+            function,
+            elements: u64::try_from(elements).unwrap_or(0),
+            start: config::stats_enabled().then(Instant::now),
+        }
+    }
+}
+
+impl Drop for Scope {
+    fn drop(&mut self) {
+        let Some(start) = self.start else {
+            return;
+        };
+        let nanos =
+            u64::try_from(start.elapsed().as_nanos()).unwrap_or(u64::MAX);
+        let bucket = usize::try_from(u64::BITS - nanos.leading_zeros())
+            .expect("bit count")
+            .saturating_sub(1)
+            .min(H3_STATS_BUCKETS - 1);
+
+        let counters = &COUNTERS[self.function as usize];
+        counters.calls.fetch_add(1, Ordering::Relaxed);
+        counters
+            .elements
+            .fetch_add(self.elements, Ordering::Relaxed);
+        counters.nanos.fetch_add(nanos, Ordering::Relaxed);
+        counters.latencies[bucket].fetch_add(1, Ordering::Relaxed);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/// Call statistics of a function.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct H3FunctionStats {
+    /// Name of the function (static string).
+    pub name: *const c_char,
+    /// Number of calls.
+    pub calls: i64,
+    /// Number of elements (cells, coordinates, vertexes, ...) given to the
+    /// calls, 1 per call for the single-element functions.
+    pub elements: i64,
+    /// Total time spent in the calls, in nanoseconds.
+    pub totalNanos: i64,
+    /// Latency histogram (see H3_STATS_BUCKETS).
+    pub latencies: [i64; H3_STATS_BUCKETS],
+}
+
+/// Paths taken by a grid traversal.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct H3PathStats {
+    /// Name of the function (static string).
+    pub name: *const c_char,
+    /// Number of calls completed by the fast algorithm.
+    pub fastPath: i64,
+    /// Number of calls that fell back on the slower algorithm because of a
+    /// pentagon.
+    pub fallbacks: i64,
+    /// Number of calls that failed with E_PENTAGON.
+    pub pentagonErrors: i64,
+    /// Number of elements written before a fallback or an error, then
+    /// discarded.
+    pub wastedElements: i64,
+}
+
+/// Call statistics of the instrumented functions.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct H3Stats {
+    /// Number of instrumented functions.
+    pub numFunctions: c_int,
+    /// Statistics of every instrumented function.
+    pub functions: [H3FunctionStats; H3_STATS_FUNCTIONS],
+    /// Number of grid traversals reporting their paths.
+    pub numPaths: c_int,
+    /// Paths taken by every grid traversal.
+    pub paths: [H3PathStats; H3_STATS_PATHS],
+}
+
+/// h3GetStats returns the call statistics of the main entry points, and the
+/// paths taken by the grid traversals (fast algorithm, or fallback near a
+/// pentagon), over every thread, recorded while h3SetStatsEnabled was
+/// enabled.
+///
+/// @param out The statistics
+/// @return 0 (E_SUCCESS) on success.
+#[no_mangle]
+pub extern "C" fn h3GetStats(out: Option<&mut H3Stats>) -> H3Error {
+    let load = |counter: &AtomicU64| {
+        i64::try_from(counter.load(Ordering::Relaxed)).unwrap_or(i64::MAX)
+    };
+    let functions = std::array::from_fn(|i| {
+        let counters = &COUNTERS[i];
+        H3FunctionStats {
+            name: NAMES[i].as_ptr(),
+            calls: load(&counters.calls),
+            elements: load(&counters.elements),
+            totalNanos: load(&counters.nanos),
+            latencies: std::array::from_fn(|bucket| {
+                load(&counters.latencies[bucket])
+            }),
+        }
+    });
+
+    let paths = std::array::from_fn(|i| {
+        let counters = &PATHS[i];
+        H3PathStats {
+            name: PATH_NAMES[i].as_ptr(),
+            fastPath: load(&counters.fast),
+            fallbacks: load(&counters.fallbacks),
+            pentagonErrors: load(&counters.pentagons),
+            wastedElements: load(&counters.wasted),
+        }
+    });
+
+    *out.expect("null pointer") = H3Stats {
+        numFunctions: c_int::try_from(H3_STATS_FUNCTIONS)
+            .expect("function count"),
+        functions,
+        numPaths: c_int::try_from(H3_STATS_PATHS).expect("path count"),
+        paths,
+    };
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// h3ResetStats resets the call statistics and the path counters of every
+/// function.
+///
+/// Calls running concurrently may be recorded before or after the reset.
+#[no_mangle]
+pub extern "C" fn h3ResetStats() {
+    for counters in &COUNTERS {
+        counters.calls.store(0, Ordering::Relaxed);
+        counters.elements.store(0, Ordering::Relaxed);
+        counters.nanos.store(0, Ordering::Relaxed);
+        for bucket in &counters.latencies {
+            bucket.store(0, Ordering::Relaxed);
+        }
+    }
+    for counters in &PATHS {
+        counters.fast.store(0, Ordering::Relaxed);
+        counters.fallbacks.store(0, Ordering::Relaxed);
+        counters.pentagons.store(0, Ordering::Relaxed);
+        counters.wasted.store(0, Ordering::Relaxed);
+    }
+}
@@ -0,0 +1,467 @@
+//! Streaming serialization of cells, with bounded memory.
+//!
+//! Cells are written by blocks of bounded size, every block being serialized
+//! with the compact binary format of `cellsToBinary`. Each block is preceded
+//! by a small header giving its size and the range of base cells it holds, so
+//! that readers can skip the blocks they aren't interested in without decoding
+//! them.
+//!
+//! Layout:
+//! - magic number `H3S` followed by the format version (4 bytes);
+//! - for every block: the size of its payload (4 bytes, little-endian), the
+//!   lowest and highest base cell of its cells (1 byte each), then the
+//!   payload.
+
+use crate::{
+    binary, cellset, delegate_inner, H3Error, H3ErrorCodes, H3Index, H3_NULL,
+};
+use h3o::CellIndex;
+use std::{
+    ffi::{c_char, c_int, CStr},
+    fs::File,
+    io::{self, BufRead, BufReader, BufWriter, Read, Seek, Write},
+    path::Path,
+};
+
+/// Magic number and format version.
+const MAGIC: &[u8; 4] = b"H3S\x01";
+
+/// Size of a block header, in bytes.
+const BLOCK_HEADER_SIZE: usize = 6;
+
+/// Default number of cells per block.
+const DEFAULT_BLOCK_SIZE: usize = 1 << 16;
+
+/// Max number of cells per block.
+const MAX_BLOCK_SIZE: usize = 1 << 24;
+
+/// Max size of a block payload, in bytes: at most 8 bytes per cell (keys have
+/// up to 52 bits) and the group headers.
+const MAX_PAYLOAD_SIZE: usize = 8 * MAX_BLOCK_SIZE + 256;
+
+/// Writer of a stream of cells.
+pub struct H3CellWriter {
+    /// Output file.
+    file: BufWriter<File>,
+    /// Cells of the current block.
+    block: Vec<CellIndex>,
+    /// Max number of cells per block.
+    block_size: usize,
+}
+
+impl H3CellWriter {
+    /// Creates the file and writes the stream header.
+    fn create(path: &Path, block_size: usize) -> io::Result<Self> {
+        let mut file = BufWriter::new(File::create(path)?);
+        file.write_all(MAGIC)?;
+        Ok(Self {
+            file,
+            // Grown as cells come, a block may never be filled.
+            block: Vec::new(),
+            block_size,
+        })
+    }
+
+    /// Appends the cells, writing every block as soon as it's full.
+    fn write(&mut self, cells: &[CellIndex]) -> io::Result<()> {
+        let mut cells = cells;
+        while !cells.is_empty() {
+            let count = (self.block_size - self.block.len()).min(cells.len());
+            let (head, tail) = cells.split_at(count);
+            self.block.extend_from_slice(head);
+            cells = tail;
+            if self.block.len() == self.block_size {
+                self.flush_block()?;
+            }
+        }
+        Ok(())
+    }
+
+    /// Writes the current block, if any.
+    fn flush_block(&mut self) -> io::Result<()> {
+        let base_cells =
+            || self.block.iter().map(|cell| u8::from(cell.base_cell()));
+        let (Some(lowest), Some(highest)) =
+            (base_cells().min(), base_cells().max())
+        else {
+            return Ok(());
+        };
+        let payload = binary::encode(self.block.drain(..));
+        let size = u32::try_from(payload.len())
+            .map_err(|_| io::Error::from(io::ErrorKind::InvalidInput))?;
+
+        self.file.write_all(&size.to_le_bytes())?;
+        self.file.write_all(&[lowest, highest])?;
+        self.file.write_all(&payload)
+    }
+
+    /// Writes the last block and flushes the file.
+    fn finish(mut self) -> io::Result<()> {
+        self.flush_block()?;
+        self.file.flush()
+    }
+}
+
+/// Reader of a stream of cells.
+pub struct H3CellReader {
+    /// Input file.
+    file: BufReader<File>,
+    /// Base cell to restrict the reading to, if any.
+    base_cell: Option<u8>,
+    /// Payload of the current block.
+    payload: Vec<u8>,
+    /// Cells of the current block.
+    block: Vec<H3Index>,
+    /// Number of cells of the current block already read.
+    position: usize,
+}
+
+impl H3CellReader {
+    /// Opens the file and checks the stream header.
+    fn open(path: &Path) -> Result<Self, H3Error> {
+        let mut file = File::open(path)
+            .map(BufReader::new)
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        let mut magic = [0; MAGIC.len()];
+        file.read_exact(&mut magic)
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        if &magic != MAGIC {
+            return Err(H3ErrorCodes::EFailed.into());
+        }
+        Ok(Self {
+            file,
+            base_cell: None,
+            payload: Vec::new(),
+            block: Vec::new(),
+            position: 0,
+        })
+    }
+
+    /// Restarts from the first block, only reading the cells of the base cell
+    /// (if any).
+    fn rewind(&mut self, base_cell: Option<u8>) -> Result<(), H3Error> {
+        self.file
+            .seek(io::SeekFrom::Start(u64::try_from(MAGIC.len()).expect("4")))
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        self.base_cell = base_cell;
+        self.block.clear();
+        self.position = 0;
+        Ok(())
+    }
+
+    /// Reads the next cells into `out`, returning how many have been read (0
+    /// once the stream is exhausted).
+    fn read(&mut self, out: &mut [H3Index]) -> Result<usize, H3Error> {
+        let mut count = 0;
+        while count < out.len() {
+            if self.position == self.block.len() && !self.read_block()? {
+                break;
+            }
+            let remaining = &self.block[self.position..];
+            let size = remaining.len().min(out.len() - count);
+            out[count..count + size].copy_from_slice(&remaining[..size]);
+            count += size;
+            self.position += size;
+        }
+        Ok(count)
+    }
+
+    /// Decodes the next block holding cells of the selected base cell.
+    ///
+    /// Returns false at the end of the stream.
+    fn read_block(&mut self) -> Result<bool, H3Error> {
+        // Nothing is left to read from a block that fails to decode.
+        self.block.clear();
+        self.position = 0;
+        loop {
+            let end = self
+                .file
+                .fill_buf()
+                .map_err(|_| H3ErrorCodes::EFailed)?
+                .is_empty();
+            if end {
+                return Ok(false);
+            }
+
+            let mut header = [0; BLOCK_HEADER_SIZE];
+            self.file
+                .read_exact(&mut header)
+                .map_err(|_| H3ErrorCodes::EFailed)?;
+            let (size, base_cells) = header.split_at(4);
+            let size = u32::from_le_bytes(size.try_into().expect("4 bytes"));
+            let (lowest, highest) = (base_cells[0], base_cells[1]);
+
+            // Skip the blocks without any cell of the selected base cell.
+            if self.base_cell.is_some_and(|base_cell| {
+                base_cell < lowest || base_cell > highest
+            }) {
+                self.file
+                    .seek_relative(i64::from(size))
+                    .map_err(|_| H3ErrorCodes::EFailed)?;
+                continue;
+            }
+
+            // The size comes from the file: reject the ones no writer
+            // produces, and only allocate for the bytes actually read, so
+            // that a corrupted or truncated file can't blow the memory up.
+            let limit = u64::from(size);
+            let size = usize::try_from(size)
+                .ok()
+                .filter(|&size| size <= MAX_PAYLOAD_SIZE)
+                .ok_or(H3ErrorCodes::EFailed)?;
+            self.payload.clear();
+            let read = (&mut self.file)
+                .take(limit)
+                .read_to_end(&mut self.payload)
+                .map_err(|_| H3ErrorCodes::EFailed)?;
+            if read != size {
+                return Err(H3ErrorCodes::EFailed.into());
+            }
+            self.block
+                .resize(binary::cell_count(&self.payload)?, H3_NULL);
+            binary::decode(&self.payload, &mut self.block)?;
+            if let Some(base_cell) = self.base_cell {
+                self.block.retain(|&cell| {
+                    cellset::base_cell(cell) == usize::from(base_cell)
+                });
+            }
+            return Ok(true);
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/// createCellWriter creates a file to stream cells into, by blocks.
+///
+/// Cells are buffered until a block is full, then the block is compressed and
+/// written: memory usage is bounded by the block size, whatever the number of
+/// cells written. The order of the cells is only preserved across blocks:
+/// within a block, cells are sorted by resolution then by index.
+///
+/// The writer must be closed with closeCellWriter, which writes the last
+/// block.
+///
+/// @param path      The path of the file, overwritten if it exists
+/// @param blockSize Max number of cells per block, up to 16777216 (0 for the
+///                  default, 65536)
+/// @param out       The created writer
+/// @return E_DOMAIN if the block size is negative or too large, E_FAILED if
+///         the file can't be created, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `path` must point to a null-terminated string.
+#[no_mangle]
+pub unsafe extern "C" fn createCellWriter(
+    path: *const c_char,
+    blockSize: i64,
+    out: Option<&mut *mut H3CellWriter>,
+) -> H3Error {
+    unsafe fn inner(
+        path: *const c_char,
+        blockSize: i64,
+    ) -> Result<*mut H3CellWriter, H3Error> {
+        let block_size = match usize::try_from(blockSize) {
+            Ok(0) => DEFAULT_BLOCK_SIZE,
+            Ok(size) if size <= MAX_BLOCK_SIZE => size,
+            _ => return Err(H3ErrorCodes::EDomain.into()),
+        };
+        let path = CStr::from_ptr(path)
+            .to_str()
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        let writer = H3CellWriter::create(Path::new(path), block_size)
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        Ok(Box::into_raw(Box::new(writer)))
+    }
+
+    delegate_inner!(inner(path, blockSize), out)
+}
+
+/// cellWriterWrite appends cells to the stream.
+///
+/// H3_NULL entries are skipped, so the output of polygonToCells can be
+/// written as-is.
+///
+/// @param writer   The writer created by createCellWriter
+/// @param cells    The cells to write, at any resolution
+/// @param numCells The number of cells
+/// @return E_CELL_INVALID if any cell is invalid (nothing is written then),
+///         E_FAILED if the file can't be written, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellWriterWrite(
+    writer: Option<&mut H3CellWriter>,
+    cells: *const H3Index,
+    numCells: i64,
+) -> H3Error {
+    unsafe fn inner(
+        writer: &mut H3CellWriter,
+        cells: *const H3Index,
+        numCells: i64,
+    ) -> Result<(), H3Error> {
+        let len =
+            usize::try_from(numCells).map_err(|_| H3ErrorCodes::EDomain)?;
+        if len == 0 {
+            return Ok(());
+        }
+        let cells = std::slice::from_raw_parts(cells, len)
+            .iter()
+            .filter(|&&index| index != H3_NULL)
+            .map(|&index| CellIndex::try_from(index))
+            .collect::<Result<Vec<_>, _>>()?;
+        writer
+            .write(&cells)
+            .map_err(|_| H3ErrorCodes::EFailed.into())
+    }
+
+    inner(writer.expect("null pointer"), cells, numCells)
+        .err()
+        .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// closeCellWriter writes the last block, flushes the file and frees the
+/// writer (even on failure).
+///
+/// @param writer The writer to close (can be NULL).
+/// @return E_FAILED if the file can't be written, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// The pointer must comes from [`createCellWriter`]
+#[no_mangle]
+pub unsafe extern "C" fn closeCellWriter(writer: *mut H3CellWriter) -> H3Error {
+    if writer.is_null() {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    match Box::from_raw(writer).finish() {
+        Ok(()) => H3ErrorCodes::ESuccess.into(),
+        Err(_) => H3ErrorCodes::EFailed.into(),
+    }
+}
+
+/// openCellReader opens a stream of cells written by a H3CellWriter.
+///
+/// Cells are decoded one block at a time: memory usage is bounded by the block
+/// size, whatever the number of cells in the stream.
+///
+/// It is the responsibility of the caller to call destroyCellReader on the
+/// reader, or its memory will not be freed.
+///
+/// @param path The path of the file
+/// @param out  The opened reader
+/// @return E_FAILED if the file can't be read or isn't a stream of cells,
+///         E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `path` must point to a null-terminated string.
+#[no_mangle]
+pub unsafe extern "C" fn openCellReader(
+    path: *const c_char,
+    out: Option<&mut *mut H3CellReader>,
+) -> H3Error {
+    unsafe fn inner(path: *const c_char) -> Result<*mut H3CellReader, H3Error> {
+        let path = CStr::from_ptr(path)
+            .to_str()
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        let reader = H3CellReader::open(Path::new(path))?;
+        Ok(Box::into_raw(Box::new(reader)))
+    }
+
+    delegate_inner!(inner(path), out)
+}
+
+/// cellReaderNext reads the next cells of the stream into `out`.
+///
+/// Once every cell has been read, `written` is set to 0.
+///
+/// @param reader   The reader created by openCellReader
+/// @param out      The output buffer
+/// @param capacity The size of the output buffer
+/// @param written  The number of cells written into `out`
+/// @return E_FAILED if the stream is truncated or corrupted, E_SUCCESS
+///         otherwise.
+///
+/// # Safety
+///
+/// `out` must points to an array of at least `capacity` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellReaderNext(
+    reader: Option<&mut H3CellReader>,
+    out: *mut H3Index,
+    capacity: i64,
+    written: Option<&mut i64>,
+) -> H3Error {
+    unsafe fn inner(
+        reader: &mut H3CellReader,
+        out: *mut H3Index,
+        capacity: i64,
+    ) -> Result<i64, H3Error> {
+        let capacity =
+            usize::try_from(capacity).map_err(|_| H3ErrorCodes::EDomain)?;
+        if capacity == 0 {
+            return Ok(0);
+        }
+        let out = std::slice::from_raw_parts_mut(out, capacity);
+        let count = reader.read(out)?;
+        Ok(i64::try_from(count).expect("bounded by capacity"))
+    }
+
+    delegate_inner!(
+        inner(reader.expect("null pointer"), out, capacity),
+        written
+    )
+}
+
+/// cellReaderRewind restarts the reading from the beginning of the stream.
+///
+/// When a base cell is given, only the cells of that base cell are read: the
+/// blocks without any of them are skipped without being decoded, which pays
+/// off when the stream was written in (even roughly) sorted order.
+///
+/// @param reader   The reader created by openCellReader
+/// @param baseCell The base cell to restrict the reading to, or -1 to read
+///                 every cell
+/// @return E_DOMAIN if the base cell is invalid, E_FAILED if the file can't
+///         be read, E_SUCCESS otherwise.
+#[no_mangle]
+pub extern "C" fn cellReaderRewind(
+    reader: Option<&mut H3CellReader>,
+    baseCell: c_int,
+) -> H3Error {
+    fn inner(
+        reader: &mut H3CellReader,
+        baseCell: c_int,
+    ) -> Result<(), H3Error> {
+        let base_cell = match baseCell {
+            -1 => None,
+            0..=121 => {
+                Some(u8::try_from(baseCell).expect("base cell on 7 bits"))
+            }
+            _ => return Err(H3ErrorCodes::EDomain.into()),
+        };
+        reader.rewind(base_cell)
+    }
+
+    inner(reader.expect("null pointer"), baseCell)
+        .err()
+        .unwrap_or_else(|| H3ErrorCodes::ESuccess.into())
+}
+
+/// Free all allocated memory for a cell reader, and close its file.
+///
+/// @param reader The reader to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`openCellReader`]
+#[no_mangle]
+pub unsafe extern "C" fn destroyCellReader(reader: *mut H3CellReader) {
+    if !reader.is_null() {
+        drop(Box::from_raw(reader));
+    }
+}
@@ -0,0 +1,290 @@
+//! Shared indexes, swapped atomically under concurrent readers.
+//!
+//! The indexes (cell sets, cell bitmaps and fence indexes) are immutable once
+//! built, so that any number of threads can query the same one. A handle adds
+//! RCU-style updates on top: readers pin the current version lock-free, and a
+//! swap publishes the new version right away, then waits for the readers of
+//! the old one to release it before destroying it. Readers never wait, only
+//! the (rare) writers do.
+//!
+//! Readers register in one of two generations, flipped by the writers, so that
+//! the new readers don't hold back a writer waiting for the old ones to leave.
+//! Each generation counts its readers over several cache lines, picked per
+//! thread, so that the reader threads don't contend on a single counter.
+
+use crate::{
+    delegate_inner, H3CellBitmap, H3CellSet, H3Error, H3ErrorCodes,
+    H3FenceIndex,
+};
+use std::{
+    ffi::c_void,
+    sync::{
+        atomic::{AtomicPtr, AtomicUsize, Ordering},
+        Mutex,
+    },
+    thread,
+};
+
+/// Kinds of shareable indexes, passed as `kind`.
+///
+/// cbindgen:rename-all=ScreamingSnakeCase
+#[repr(u32)]
+#[derive(Debug, Copy, Clone)]
+#[non_exhaustive]
+pub enum IndexKind {
+    /// A set created by createCellSet or openMappedCellSet.
+    IndexCellSet = 0,
+    /// A set created by createCellBitmap (or its unions and intersections).
+    IndexCellBitmap = 1,
+    /// An index created by createFenceIndex.
+    IndexFence = 2,
+}
+
+/// Number of reader counters per generation.
+const READER_SHARDS: usize = 16;
+
+/// Shard of the reader counters used by every new thread, in turn.
+static NEXT_SHARD: AtomicUsize = AtomicUsize::new(0);
+
+thread_local! {
+    static SHARD: usize =
+        NEXT_SHARD.fetch_add(1, Ordering::Relaxed) % READER_SHARDS;
+}
+
+/// A reader counter, alone on its cache line.
+#[repr(align(64))]
+#[derive(Default)]
+struct Counter(AtomicUsize);
+
+/// A handle on the current version of an index.
+pub struct H3IndexHandle {
+    /// Kind of the index.
+    kind: IndexKind,
+    /// Current version of the index.
+    current: AtomicPtr<c_void>,
+    /// Generation new readers register in (its parity).
+    generation: AtomicUsize,
+    /// Readers of both generations, `READER_SHARDS` counters each.
+    readers: [Counter; 2 * READER_SHARDS],
+    /// Serializes the writers.
+    writer: Mutex<()>,
+}
+
+impl H3IndexHandle {
+    /// Pins the current version, returning it with the counter to release.
+    fn acquire(&self) -> (*const c_void, usize) {
+        let parity = self.generation.load(Ordering::SeqCst) & 1;
+        let slot = parity * READER_SHARDS + SHARD.with(|&shard| shard);
+        self.readers[slot].0.fetch_add(1, Ordering::SeqCst);
+        // Registered before loading: a writer swapping after this point waits
+        // for the release, one swapping before is seen.
+        (self.current.load(Ordering::SeqCst), slot)
+    }
+
+    /// Releases a version pinned by `acquire`.
+    fn release(&self, slot: usize) {
+        self.readers[slot].0.fetch_sub(1, Ordering::SeqCst);
+    }
+
+    /// Publishes a new version, and returns the previous one once no reader
+    /// can hold it anymore.
+    fn swap(&self, index: *mut c_void) -> *mut c_void {
+        let _writer = self.writer.lock().expect("poisoned index handle");
+        let old = self.current.swap(index, Ordering::SeqCst);
+        // The readers of the old version registered before the swap, in either
+        // generation: each one is drained after sending the new readers to the
+        // other.
+        for _ in 0..2 {
+            let parity = self.generation.fetch_add(1, Ordering::SeqCst) & 1;
+            let shards =
+                &self.readers[parity * READER_SHARDS..][..READER_SHARDS];
+            while shards
+                .iter()
+                .any(|counter| counter.0.load(Ordering::SeqCst) != 0)
+            {
+                thread::yield_now();
+            }
+        }
+        old
+    }
+}
+
+impl Drop for H3IndexHandle {
+    fn drop(&mut self) {
+        // SAFETY: the handle owns its index, which has the handle's kind.
+        unsafe { destroy(self.kind, *self.current.get_mut()) };
+    }
+}
+
+/// Frees an index of the given kind (NULL is ignored).
+///
+/// # Safety
+///
+/// `index` must be NULL or an index of that kind that hasn't been freed yet.
+unsafe fn destroy(kind: IndexKind, index: *mut c_void) {
+    if index.is_null() {
+        return;
+    }
+    match kind {
+        IndexKind::IndexCellSet => {
+            drop(Box::from_raw(index.cast::<H3CellSet>()));
+        }
+        IndexKind::IndexCellBitmap => {
+            drop(Box::from_raw(index.cast::<H3CellBitmap>()));
+        }
+        IndexKind::IndexFence => {
+            drop(Box::from_raw(index.cast::<H3FenceIndex>()));
+        }
+    }
+}
+
+/// A version of an index pinned by h3IndexAcquire.
+#[repr(C)]
+#[derive(Debug, Copy, Clone)]
+pub struct H3IndexGuard {
+    /// The index to query (an `H3CellSet`, `H3CellBitmap` or `H3FenceIndex`,
+    /// as given by the kind of the handle).
+    pub index: *const c_void,
+    /// Reader counter to release (internal).
+    pub slot: u32,
+}
+
+// -----------------------------------------------------------------------------
+
+/// createIndexHandle shares an index across threads, for lock-free queries
+/// and atomic replacements (see h3IndexSwap).
+///
+/// The handle takes ownership of the index: it's freed by h3IndexSwap or
+/// destroyIndexHandle, never by the caller. It is the responsibility of the
+/// caller to call destroyIndexHandle on the handle, or its memory will not be
+/// freed.
+///
+/// @param kind  The kind of the index (see IndexKind)
+/// @param index The initial version of the index
+/// @param out   The created handle
+/// @return E_OPTION_INVALID if the kind is unknown, E_FAILED if the index is
+/// NULL, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `index` must be an index of that kind, not owned by another handle.
+#[no_mangle]
+pub unsafe extern "C" fn createIndexHandle(
+    kind: u32,
+    index: *mut c_void,
+    out: Option<&mut *mut H3IndexHandle>,
+) -> H3Error {
+    fn inner(
+        kind: u32,
+        index: *mut c_void,
+    ) -> Result<*mut H3IndexHandle, H3Error> {
+        let kind = match kind {
+            0 => IndexKind::IndexCellSet,
+            1 => IndexKind::IndexCellBitmap,
+            2 => IndexKind::IndexFence,
+            _ => return Err(H3ErrorCodes::EOptionInvalid.into()),
+        };
+        if index.is_null() {
+            return Err(H3ErrorCodes::EFailed.into());
+        }
+        let handle = H3IndexHandle {
+            kind,
+            current: AtomicPtr::new(index),
+            generation: AtomicUsize::new(0),
+            readers: Default::default(),
+            writer: Mutex::new(()),
+        };
+        Ok(Box::into_raw(Box::new(handle)))
+    }
+
+    delegate_inner!(inner(kind, index), out)
+}
+
+/// h3IndexAcquire pins the current version of a shared index, which stays
+/// valid until released with h3IndexRelease, even if it's swapped meanwhile.
+///
+/// Acquiring never blocks: a reader should release its guard once done with a
+/// batch of queries, as the writers wait for the readers of the old version.
+///
+/// @param handle The handle created by createIndexHandle
+/// @param out    The pinned version
+#[no_mangle]
+pub extern "C" fn h3IndexAcquire(
+    handle: Option<&H3IndexHandle>,
+    out: Option<&mut H3IndexGuard>,
+) -> H3Error {
+    let (index, slot) = handle.expect("null pointer").acquire();
+    *out.expect("null pointer") = H3IndexGuard {
+        index,
+        slot: u32::try_from(slot).expect("reader slot"),
+    };
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// h3IndexRelease releases a version pinned by h3IndexAcquire, which mustn't
+/// be used anymore.
+///
+/// @param handle The handle the guard comes from
+/// @param guard  The guard to release
+/// @return E_FAILED if the guard doesn't come from h3IndexAcquire, E_SUCCESS
+/// otherwise.
+#[no_mangle]
+pub extern "C" fn h3IndexRelease(
+    handle: Option<&H3IndexHandle>,
+    guard: H3IndexGuard,
+) -> H3Error {
+    let handle = handle.expect("null pointer");
+    let Some(slot) = usize::try_from(guard.slot)
+        .ok()
+        .filter(|&slot| slot < handle.readers.len())
+    else {
+        return H3ErrorCodes::EFailed.into();
+    };
+    handle.release(slot);
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// h3IndexSwap replaces the version of a shared index.
+///
+/// The new version is visible to the next h3IndexAcquire right away. The call
+/// then waits for the readers that may still hold the old version to release
+/// it, and frees it: the readers are never blocked, and must not hold a guard
+/// while swapping themselves.
+///
+/// @param handle   The handle created by createIndexHandle
+/// @param newIndex The new version, of the kind of the handle (the handle
+///                 takes ownership of it)
+/// @return E_FAILED if the new version is NULL, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `newIndex` must be an index of the kind of the handle, not owned by another
+/// handle.
+#[no_mangle]
+pub unsafe extern "C" fn h3IndexSwap(
+    handle: Option<&H3IndexHandle>,
+    newIndex: *mut c_void,
+) -> H3Error {
+    let handle = handle.expect("null pointer");
+    if newIndex.is_null() {
+        return H3ErrorCodes::EFailed.into();
+    }
+    let old = handle.swap(newIndex);
+    destroy(handle.kind, old);
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Free all allocated memory for a shared index, and its current version.
+///
+/// @param handle The handle to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`createIndexHandle`], and no guard on it may
+/// still be held.
+#[no_mangle]
+pub unsafe extern "C" fn destroyIndexHandle(handle: *mut H3IndexHandle) {
+    if !handle.is_null() {
+        drop(Box::from_raw(handle));
+    }
+}
@@ -1,6 +1,6 @@
-use crate::{delegate_inner, H3Error, H3ErrorCodes, H3Index, LatLng};
+use crate::{cell, delegate_inner, H3Error, H3ErrorCodes, H3Index, LatLng};
 use h3o::{CellIndex, VertexIndex};
-use std::ffi::c_int;
+use std::{collections::HashSet, ffi::c_int};
 
 /// Get a single vertex for a given cell, as an H3 index, or
 /// H3_NULL if the vertex is invalid
@@ -57,6 +57,72 @@ pub unsafe extern "C" fn cellToVertexes(
     }
 }
 
+/// Get the vertexes of a set of cells, each shared vertex being emitted once.
+///
+/// A vertex is emitted by its owner (the cell its index is derived from) when
+/// the owner is part of the set, so the interior vertexes are deduplicated
+/// without any lookup on the vertexes themselves. Only the vertexes on the
+/// border of the set, whose owner is outside, need to be tracked.
+///
+/// Duplicated cells are ignored.
+///
+/// @param cells    Cells to get the vertexes for
+/// @param numCells Number of cells
+/// @param out      Array to hold vertex output, densely packed
+/// @param count    Number of vertexes written
+///
+/// # Safety
+///
+/// `cells` must points to an array of at least `numCells` elements, and `out`
+/// to an array of at least `6 * numCells` elements.
+#[no_mangle]
+pub unsafe extern "C" fn cellsToUniqueVertexes(
+    cells: *const H3Index,
+    numCells: i64,
+    out: *mut H3Index,
+    count: Option<&mut i64>,
+) -> H3Error {
+    unsafe fn inner(
+        cells: *const H3Index,
+        numCells: i64,
+        out: *mut H3Index,
+    ) -> Result<i64, H3Error> {
+        let len =
+            usize::try_from(numCells).map_err(|_| H3ErrorCodes::EDomain)?;
+        if len == 0 {
+            return Ok(0);
+        }
+        let mut set = HashSet::with_capacity(len);
+        let mut unique = Vec::with_capacity(len);
+        for &cell in std::slice::from_raw_parts(cells, len) {
+            let index = CellIndex::try_from(cell)?;
+            if set.insert(cell) {
+                unique.push(index);
+            }
+        }
+
+        let out = std::slice::from_raw_parts_mut(out, 6 * len);
+        let mut border = HashSet::new();
+        let mut count = 0;
+        for cell in unique {
+            for vertex in cell.vertexes() {
+                let vertex = H3Index::from(vertex);
+                // The owner is the same index, in cell mode.
+                let owner = (vertex & !(0xff << 56)) | (1 << 59);
+                let is_owner = owner == H3Index::from(cell);
+                if is_owner || (!set.contains(&owner) && border.insert(vertex))
+                {
+                    out[count] = vertex;
+                    count += 1;
+                }
+            }
+        }
+        Ok(i64::try_from(count).expect("too many vertexes"))
+    }
+
+    delegate_inner!(inner(cells, numCells, out), count)
+}
+
 /// Whether the input is a valid H3 vertex
 ///
 /// @param  vertex H3 index possibly describing a vertex
@@ -66,6 +132,55 @@ pub extern "C" fn isValidVertex(vertex: H3Index) -> c_int {
     VertexIndex::try_from(vertex).is_ok().into()
 }
 
+/// Batch version of isValidVertex.
+///
+/// @param vertexes    The H3 indexes to validate.
+/// @param numVertexes The number of indexes.
+/// @param out         Set to 1 for every valid vertex, 0 otherwise.
+///
+/// # Safety
+///
+/// `vertexes` and `out` must points to an array of at least `numVertexes`
+/// elements.
+#[no_mangle]
+pub unsafe extern "C" fn areValidVertexes(
+    vertexes: *const H3Index,
+    numVertexes: i64,
+    out: *mut u8,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numVertexes) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let vertexes = std::slice::from_raw_parts(vertexes, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    for (dst, &vertex) in out.iter_mut().zip(vertexes) {
+        // The ownership of the vertex requires a topological check, only run
+        // it when the bit layout is valid.
+        *dst = (is_valid_vertex_bits(vertex)
+            && VertexIndex::try_from(vertex).is_ok())
+        .into();
+    }
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// Bitwise part of the validation of a vertex index.
+///
+/// Necessary but not sufficient: the owner of the vertex isn't checked.
+const fn is_valid_vertex_bits(index: u64) -> bool {
+    // Vertex mode (4) and a vertex number between 0 and 5 (4 for pentagons).
+    let mode = (index >> 59) & 0xf == 4;
+    let vertex = (index >> 56) & 0b111;
+    // The owner is the same index, in cell mode and without vertex number.
+    let owner = (index & !(0xff << 56)) | (1 << 59);
+    let max_vertex = if cell::is_pentagon_bits(owner) { 4 } else { 5 };
+
+    mode && vertex <= max_vertex && cell::is_valid_cell_bits(owner)
+}
+
 /// Get the geocoordinates of an H3 vertex
 ///
 /// @param vertex H3 index describing a vertex
@@ -81,3 +196,48 @@ pub extern "C" fn vertexToLatLng(
 
     delegate_inner!(inner(vertex), point)
 }
+
+/// Batch version of vertexToLatLng.
+///
+/// An invalid vertex doesn't stop the batch: its coordinates are left
+/// untouched and an error is returned once every vertex has been processed.
+///
+/// @param vertexes    The H3 indexes describing vertexes.
+/// @param numVertexes The number of indexes.
+/// @param out         Output geo coordinates, one per vertex.
+/// @return E_VERTEX_INVALID if any vertex is invalid, E_SUCCESS otherwise.
+///
+/// # Safety
+///
+/// `vertexes` and `out` must points to an array of at least `numVertexes`
+/// elements.
+#[no_mangle]
+pub unsafe extern "C" fn vertexesToLatLngs(
+    vertexes: *const H3Index,
+    numVertexes: i64,
+    out: *mut LatLng,
+) -> H3Error {
+    let Ok(len) = usize::try_from(numVertexes) else {
+        return H3ErrorCodes::EDomain.into();
+    };
+    if len == 0 {
+        return H3ErrorCodes::ESuccess.into();
+    }
+    let vertexes = std::slice::from_raw_parts(vertexes, len);
+    let out = std::slice::from_raw_parts_mut(out, len);
+
+    let mut valid = true;
+    for (dst, &vertex) in out.iter_mut().zip(vertexes) {
+        if let Ok(vertex) = VertexIndex::try_from(vertex) {
+            *dst = h3o::LatLng::from(vertex).into();
+        } else {
+            valid = false;
+        }
+    }
+
+    if valid {
+        H3ErrorCodes::ESuccess.into()
+    } else {
+        H3ErrorCodes::EVertexInvalid.into()
+    }
+}
@@ -0,0 +1,104 @@
+//! Visitors of the cells produced by an enumeration.
+//!
+//! Instead of filling a caller-allocated output array, the `*ForEach` entry
+//! points hand the cells over to a callback, by batches written into a small
+//! fixed buffer: the caller doesn't have to size nor allocate anything, and
+//! the batches stay in cache while they are aggregated.
+
+use crate::{H3Index, H3_NULL};
+use h3o::CellIndex;
+use std::ffi::{c_int, c_void};
+
+/// Maximum number of cells handed over to a visitor at once.
+pub const H3_VISIT_BATCH_SIZE: usize = 256;
+
+/// A visitor, called with every batch of `count` cells produced by an
+/// enumeration.
+///
+/// `context` is the pointer given to the enumeration. The cells are only valid
+/// during the call. Returning a non-zero value stops the enumeration.
+pub type H3CellVisitor = unsafe extern "C" fn(
+    cells: *const H3Index,
+    count: i64,
+    context: *mut c_void,
+) -> c_int;
+
+/// Batches cells into a fixed buffer and hands them over to a visitor.
+pub struct Visit {
+    visitor: H3CellVisitor,
+    context: *mut c_void,
+    batch: [H3Index; H3_VISIT_BATCH_SIZE],
+    len: usize,
+    /// Number of cells handed over so far.
+    visited: usize,
+    stopped: bool,
+}
+
+impl Visit {
+    /// Initializes a visit.
+    pub const fn new(visitor: H3CellVisitor, context: *mut c_void) -> Self {
+        Self {
+            visitor,
+            context,
+            batch: [H3_NULL; H3_VISIT_BATCH_SIZE],
+            len: 0,
+            visited: 0,
+            stopped: false,
+        }
+    }
+
+    /// Adds a cell to the current batch, handing over the batch if full.
+    ///
+    /// Returns false once the visitor has stopped the enumeration.
+    pub fn push(&mut self, cell: CellIndex) -> bool {
+        if self.stopped {
+            return false;
+        }
+        self.batch[self.len] = cell.into();
+        self.len += 1;
+        if self.len == H3_VISIT_BATCH_SIZE {
+            self.flush();
+        }
+        !self.stopped
+    }
+
+    /// Adds every cell of an iterator, until the visitor stops the
+    /// enumeration.
+    pub fn extend(&mut self, cells: impl IntoIterator<Item = CellIndex>) {
+        for cell in cells {
+            if !self.push(cell) {
+                break;
+            }
+        }
+    }
+
+    /// Drops the cells not handed over yet.
+    pub const fn discard(&mut self) {
+        self.len = 0;
+    }
+
+    /// Returns the number of cells handed over to the visitor so far.
+    pub const fn visited(&self) -> usize {
+        self.visited
+    }
+
+    /// Hands over the pending cells.
+    pub fn finish(mut self) {
+        self.flush();
+    }
+
+    /// Hands over the current batch, if any.
+    fn flush(&mut self) {
+        if self.len == 0 || self.stopped {
+            return;
+        }
+        let count = i64::try_from(self.len).expect("batch size");
+        // SAFETY: the batch holds `count` cells, and the visitor is a valid
+        // callback (as required by the callers of the enumeration).
+        let stop =
+            unsafe { (self.visitor)(self.batch.as_ptr(), count, self.context) };
+        self.visited += self.len;
+        self.len = 0;
+        self.stopped = stop != 0;
+    }
+}
@@ -0,0 +1,115 @@
+//! Reusable scratch buffers for the conversion-heavy entry points.
+//!
+//! A workspace keeps the buffers of the temporaries built by a call (the rings
+//! of the converted polygons, the sorted copy of a compacted set) once the
+//! call is done, so that the next calls using the same workspace can reuse
+//! them instead of allocating new ones.
+
+use crate::{GeoLoop, GeoPolygon, H3Error, H3ErrorCodes};
+use geo_types::{Coord, LineString, Polygon};
+use h3o::CellIndex;
+
+/// Scratch buffers reused across calls.
+#[derive(Debug, Default)]
+pub struct H3Workspace {
+    /// Spare coordinate buffers, for the rings of the converted polygons.
+    rings: Vec<Vec<Coord>>,
+    /// Spare buffer for the holes of the converted polygons.
+    holes: Vec<LineString>,
+    /// Buffer for the cells of a call.
+    cells: Vec<CellIndex>,
+}
+
+impl H3Workspace {
+    /// Converts a polygon, reusing the buffers of the previous conversions.
+    ///
+    /// The polygon should be given back with `recycle` once done.
+    ///
+    /// # Errors
+    ///
+    /// `EFailed` if the numbers of vertexes or holes are negative.
+    pub fn polygon(&mut self, value: GeoPolygon) -> Result<Polygon, H3Error> {
+        let len = usize::try_from(value.numHoles)
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        let exterior = self.ring(value.geoloop)?;
+        let mut holes = std::mem::take(&mut self.holes);
+        holes.clear();
+        if len != 0 {
+            // SAFETY: `holes` must points to an array of at least `numHoles`
+            // elements.
+            let loops = unsafe { std::slice::from_raw_parts(value.holes, len) };
+            for &hole in loops {
+                holes.push(self.ring(hole)?);
+            }
+        }
+        Ok(Polygon::new(exterior, holes))
+    }
+
+    /// Takes back the buffers of a polygon built by `polygon`.
+    pub fn recycle(&mut self, polygon: Polygon) {
+        let (exterior, mut holes) = polygon.into_inner();
+        self.rings.push(exterior.into_inner());
+        while let Some(hole) = holes.pop() {
+            self.rings.push(hole.into_inner());
+        }
+        self.holes = holes;
+    }
+
+    /// Returns the (empty) cell buffer.
+    pub fn cells(&mut self) -> &mut Vec<CellIndex> {
+        self.cells.clear();
+        &mut self.cells
+    }
+
+    /// Converts a ring into a spare coordinate buffer.
+    fn ring(&mut self, value: GeoLoop) -> Result<LineString, H3Error> {
+        let len = usize::try_from(value.numVerts)
+            .map_err(|_| H3ErrorCodes::EFailed)?;
+        let mut coords = self.rings.pop().unwrap_or_default();
+        coords.clear();
+        if len != 0 {
+            // SAFETY: `verts` must points to an array of at least `numVerts`
+            // elements.
+            let verts = unsafe { std::slice::from_raw_parts(value.verts, len) };
+            coords.extend(verts.iter().map(|&ll| Coord::from(ll)));
+        }
+        Ok(LineString::new(coords))
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+/// createWorkspace creates a workspace, to pass to the `*Ws` variants of the
+/// conversion-heavy functions (e.g. polygonToCellsWs).
+///
+/// The workspace keeps the internal buffers of a call for the next ones, so
+/// that repeated calls stop allocating them once the buffers are large
+/// enough. A workspace must not be used by several threads at the same time:
+/// create one per thread instead.
+///
+/// It is the responsibility of the caller to call destroyWorkspace on the
+/// workspace, or its memory will not be freed.
+///
+/// @param out The workspace
+#[no_mangle]
+pub extern "C" fn createWorkspace(
+    out: Option<&mut *mut H3Workspace>,
+) -> H3Error {
+    *out.expect("null pointer") =
+        Box::into_raw(Box::new(H3Workspace::default()));
+    H3ErrorCodes::ESuccess.into()
+}
+
+/// destroyWorkspace frees a workspace and its buffers.
+///
+/// @param workspace The workspace to free (can be NULL).
+///
+/// # Safety
+///
+/// The pointer must comes from [`createWorkspace`]
+#[no_mangle]
+pub unsafe extern "C" fn destroyWorkspace(workspace: *mut H3Workspace) {
+    if !workspace.is_null() {
+        drop(Box::from_raw(workspace));
+    }
+}